@@ -32,6 +32,8 @@
 
 #define __CEF_NETD_SOURECE__
 
+#define _GNU_SOURCE
+
 // #define	DEB_CCNINFO
 /****************************************************************************************
  Include Files
@@ -47,6 +49,12 @@
 #endif //__APPLE
 
 #include <sys/ioctl.h>
+#include <sched.h>
+#ifndef CefC_MACOS
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#endif // CefC_MACOS
 
 #ifndef CefC_ContentStore
 #define CefC_NDEF_ContentStore
@@ -96,6 +104,12 @@ typedef	enum	{
 	CefC_Connection_Type_Local = 99,
 }	CefC_Connection_Type;
 
+/* Face-ID field of the epoll event data of the sockets which are not Faces. 	*/
+/* The lower bits hold CefC_Connection_Type, or one of the values below. 		*/
+#define CefC_Netd_Event_Ctrl		0x10000
+#define CefC_Netd_Event_Tick		CefC_Connection_Type_Num		/* timerfd 		*/
+#define CefC_Netd_Event_Wake		(CefC_Connection_Type_Num + 1)	/* eventfd 		*/
+
 
 #define CefC_App_MatchType_Exact		0
 #define CefC_App_MatchType_Prefix		1
@@ -105,6 +119,16 @@ typedef	enum	{
  Structures Declaration
  ****************************************************************************************/
 
+/***** Buffers for receiving UDP messages with recvmmsg 	*****/
+typedef struct CefT_Udp_Batch {
+#ifndef CefC_MACOS
+	struct mmsghdr 			msgs[CefC_Udp_Batch_Max];
+	struct iovec 			iovs[CefC_Udp_Batch_Max];
+	struct sockaddr_storage addrs[CefC_Udp_Batch_Max];
+#endif // CefC_MACOS
+	unsigned char* 			buff;
+} CefT_Udp_Batch;
+
 struct cef_hdr {
 	uint8_t 	version;
 	uint8_t 	type;
@@ -128,11 +152,6 @@ typedef struct {
 
 /* The flag which shows cefnetd is running. 	*/
 static uint8_t cefnetd_running_f = 0;
-static uint64_t stat_nopit_frames = 0;
-static uint64_t stat_rcv_size_cnt = 0;
-static uint64_t stat_rcv_size_sum = 0;
-static uint64_t stat_rcv_size_min = 65536;
-static uint64_t stat_rcv_size_max = 0;
 
 static char root_user_name[CefC_Ctrl_User_Len] = {"root"};
 
@@ -141,8 +160,12 @@ static char root_user_name[CefC_Ctrl_User_Len] = {"root"};
 static uint64_t ccninfo_push_time = 0;
 #endif // CefC_ContentStore
 
+#ifdef CefC_Ccore
+static uint64_t ccore_retry_cnt = 5;
+#endif // CefC_Ccore
+
 #ifdef CefC_Debug
-static char cnd_dbg_msg[2048];
+static __thread char cnd_dbg_msg[2048];
 static int cef_dbg_loglv_finest = 0;
 #endif // CefC_Debug
 
@@ -151,6 +174,14 @@ static int cef_dbg_loglv_finest = 0;
  ****************************************************************************************/
 static	pthread_t cefnetd_cefstatus_th;
 
+/* The flag which shows the running thread is a forwarding worker 	*/
+static __thread int cefnetd_fwd_worker_f = 0;
+/* Statistics counters of the running forwarding worker (NULL: main thread) 	*/
+static __thread CefT_Netd_Stat* cefnetd_fwd_worker_stat = NULL;
+/* The flag which shows the message being handled has been verified by the 	*/
+/* verification worker														*/
+static __thread int cefnetd_msg_verified_f = 0;
+
 /*--------------------------------------------------------------------------------------
 	Reads the config file
 ----------------------------------------------------------------------------------------*/
@@ -236,6 +267,96 @@ cefnetd_udp_input_process (
 	int fd, 								/* FD which is polled POLLIN				*/
 	int faceid								/* Face-ID that message arrived 			*/
 );
+/*--------------------------------------------------------------------------------------
+	Prepares the batched UDP input/output
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+cefnetd_udp_batch_init (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+);
+/*--------------------------------------------------------------------------------------
+	Runs the timed housekeeping of the main loop (ccored, PIT and FIB cleanup)
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_housekeeping (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+);
+/*--------------------------------------------------------------------------------------
+	Runs the housekeeping of the main loop after the sockets are handled
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_post_process (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+);
+/*--------------------------------------------------------------------------------------
+	Handles the readiness of the socket
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_input (
+	CefT_Netd_Handle* hdl,						/* cefnetd handle						*/
+	int fd, 									/* FD which is ready 					*/
+	CefC_Connection_Type fd_type,
+	int faceid,									/* Face-ID of the FD 					*/
+	int in_f,									/* 1 if the FD is readable 				*/
+	int err_f									/* 1 if an error or hang-up occurred 	*/
+);
+/*--------------------------------------------------------------------------------------
+	Wakes up the main loop waiting in epoll_wait (called by the workers)
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_wake (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+);
+/*--------------------------------------------------------------------------------------
+	Closes the epoll instance, the timerfd and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_epoll_destroy (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+);
+#ifndef CefC_MACOS
+/*--------------------------------------------------------------------------------------
+	Creates the epoll instance, the timerfd and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+cefnetd_event_epoll_init (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+);
+/*--------------------------------------------------------------------------------------
+	Arms the timerfd for the next deadline of the housekeeping
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_timer_arm (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+);
+/*--------------------------------------------------------------------------------------
+	Main loop with epoll
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_epoll_dispatch (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+);
+#endif // CefC_MACOS
+/*--------------------------------------------------------------------------------------
+	Releases the buffers of the batched UDP input/output
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_udp_batch_destroy (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+);
+/*--------------------------------------------------------------------------------------
+	Handles a datagram received from the UDP listen socket
+----------------------------------------------------------------------------------------*/
+static int
+cefnetd_udp_datagram_process (
+	CefT_Netd_Handle* hdl,						/* cefnetd handle						*/
+	int fd, 									/* FD which received the datagram		*/
+	int faceid,									/* Face-ID that message arrived 		*/
+	unsigned char* buff,						/* received datagram					*/
+	size_t recv_len,							/* length of the datagram				*/
+	struct addrinfo* sas_p,						/* source address						*/
+	socklen_t sas_len							/* length of the source address			*/
+);
 /*--------------------------------------------------------------------------------------
 	Handles the input message from the TCP listen socket
 ----------------------------------------------------------------------------------------*/
@@ -709,6 +830,15 @@ cefnetd_pit_cleanup (
 	CefT_Netd_Handle* hdl, 						/* cefnetd handle						*/
 	uint64_t nowt								/* current time (usec) 					*/
 );
+/*--------------------------------------------------------------------------------------
+	Clean entries of the PIT shard
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_pit_shard_cleanup (
+	CefT_Netd_Handle* hdl, 						/* cefnetd handle						*/
+	CefT_Hash_Handle pit, 						/* PIT shard to clean 					*/
+	uint64_t nowt								/* current time (usec) 					*/
+);
 /*--------------------------------------------------------------------------------------
 	Clean FIB entries
 ----------------------------------------------------------------------------------------*/
@@ -789,6 +919,68 @@ static int									/* No care now								*/
 cefnetd_input_from_local_process (
 	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
 );
+/*--------------------------------------------------------------------------------------
+	Handles the local socket, the listen socket or the local face which is ready
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_input_from_local_event (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	int fd, 								/* FD which is ready 						*/
+	int faceid								/* Face-ID of the FD 						*/
+);
+/*--------------------------------------------------------------------------------------
+	Accepts the TCP connection from the listen socket
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_tcp_accept (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Accepts the connection from local process
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_local_accept (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Closes the local face of the application
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_local_app_remove (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	int idx									/* index of the application 				*/
+);
+/*--------------------------------------------------------------------------------------
+	Sends the response of the control message to the local process
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_local_rsp_send (
+	int fd, 								/* socket of the local process 				*/
+	unsigned char* rsp_msg,
+	int rsp_len
+);
+/*--------------------------------------------------------------------------------------
+	Receives the frame from the local face of the application
+----------------------------------------------------------------------------------------*/
+static int									/* -1 if the application was removed 		*/
+cefnetd_local_app_input (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	int idx									/* index of the application 				*/
+);
+/*--------------------------------------------------------------------------------------
+	Accepts the connection from babeld
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_babel_accept (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Receives the frame from babeld
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_babel_input (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
 
 /*--------------------------------------------------------------------------------------
 	Handles the elements of TX queue
@@ -916,6 +1108,147 @@ cef_pthread_create (
 	void* (*start_routine) (void*),
 	void* arg
 );
+/*--------------------------------------------------------------------------------------
+	Adds the received ContentObject to the statistics of the calling thread
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_stat_recv_frame_add (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	uint64_t size							/* size of the received ContentObject 		*/
+);
+/*--------------------------------------------------------------------------------------
+	Adds the counters of one thread to the total
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_stat_accumulate (
+	CefT_Netd_Stat* sum,					/* the total of counters 					*/
+	CefT_Netd_Stat* stat					/* counters of one thread 					*/
+);
+/*--------------------------------------------------------------------------------------
+	Creates the forwarding workers
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+cefnetd_fwd_workers_init (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Stops the forwarding workers
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_fwd_workers_destroy (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Main loop of the forwarding worker
+----------------------------------------------------------------------------------------*/
+static void*
+cefnetd_fwd_worker_thread (
+	void* arg								/* CefT_Fwd_Worker							*/
+);
+/*--------------------------------------------------------------------------------------
+	Hands over the received message to the forwarding worker
+----------------------------------------------------------------------------------------*/
+static int									/* Returns 1 if the worker took it over 	*/
+cefnetd_fwd_worker_push (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	int faceid, 							/* Face-ID where messages arrived at		*/
+	int peer_faceid, 						/* Face-ID to reply to the origin of 		*/
+											/* transmission of the message(s)			*/
+	unsigned char* msg, 					/* received message to handle				*/
+	uint16_t payload_len, 					/* Payload Length of this message			*/
+	uint16_t header_len,					/* Header Length of this message			*/
+	char*	user_id
+);
+/*--------------------------------------------------------------------------------------
+	Hands back the message which updates the shared tables to the main thread
+----------------------------------------------------------------------------------------*/
+static int									/* No care now								*/
+cefnetd_fwd_defer (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	int faceid, 							/* Face-ID where messages arrived at		*/
+	int peer_faceid, 						/* Face-ID to reply to the origin of 		*/
+											/* transmission of the message(s)			*/
+	unsigned char* msg, 					/* received message to handle				*/
+	uint16_t payload_len, 					/* Payload Length of this message			*/
+	uint16_t header_len,					/* Header Length of this message			*/
+	char*	user_id
+);
+/*--------------------------------------------------------------------------------------
+	Handles the messages handed back by the forwarding workers
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_fwd_deferred_process (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Locks/Unlocks the tables shared with the forwarding workers (main thread only)
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_fwd_lock (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+static void
+cefnetd_fwd_unlock (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Creates the verification workers
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+cefnetd_verify_workers_init (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Stops the verification workers
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_verify_workers_destroy (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Main loop of the verification worker
+----------------------------------------------------------------------------------------*/
+static void*
+cefnetd_verify_worker_thread (
+	void* arg								/* CefT_Verify_Worker						*/
+);
+/*--------------------------------------------------------------------------------------
+	Hands over the signed message to the verification worker
+----------------------------------------------------------------------------------------*/
+static int									/* Returns 1 if the worker took it over 	*/
+cefnetd_verify_worker_push (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	int faceid, 							/* Face-ID where messages arrived at		*/
+	int peer_faceid, 						/* Face-ID to reply to the origin of 		*/
+											/* transmission of the message(s)			*/
+	unsigned char* msg, 					/* received message to handle				*/
+	uint16_t payload_len, 					/* Payload Length of this message			*/
+	uint16_t header_len,					/* Header Length of this message			*/
+	char*	user_id
+);
+/*--------------------------------------------------------------------------------------
+	Handles the messages verified by the verification workers
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_verify_done_process (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the PIT shard which holds the specified name
+----------------------------------------------------------------------------------------*/
+static CefT_Hash_Handle						/* PIT shard 								*/
+cefnetd_pit_shard_get (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	CefT_CcnMsg_MsgBdy* pm					/* Structure to set parsed CEFORE message	*/
+);
+/*--------------------------------------------------------------------------------------
+	Checks whether the name is a command or not
+----------------------------------------------------------------------------------------*/
+static int									/* index of the command filter, or -1 		*/
+cefnetd_command_check (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	CefT_CcnMsg_MsgBdy* pm					/* Structure to set parsed CEFORE message	*/
+);
 
 /****************************************************************************************
  ****************************************************************************************/
@@ -991,19 +1324,17 @@ cefnetd_handle_create (
 	hdl->IR_Option				= 0;	//Not
 	memset (hdl->IR_enable, 0, sizeof (hdl->IR_enable));
 
-	hdl->stat_recv_frames							 = 0;
-	hdl->stat_send_frames							 = 0;
-	hdl->stat_recv_interest							 = 0;
-	hdl->stat_recv_interest_types[CefC_PIT_TYPE_Rgl] = 0;
-	hdl->stat_recv_interest_types[CefC_PIT_TYPE_Sym] = 0;
-	hdl->stat_recv_interest_types[CefC_PIT_TYPE_Sel] = 0;
-	hdl->stat_send_interest							 = 0;
-	hdl->stat_send_interest_types[CefC_PIT_TYPE_Rgl] = 0;
-	hdl->stat_send_interest_types[CefC_PIT_TYPE_Sym] = 0;
-	hdl->stat_send_interest_types[CefC_PIT_TYPE_Sel] = 0;
+	memset (&hdl->stat, 0, sizeof (CefT_Netd_Stat));
+	hdl->stat.rcv_size_min = 65536;
 
 	//20220311
 	hdl->Selective_max_range = CefC_Default_SELECTIVE_MAX;
+	hdl->fwd_worker_num = CefC_Default_FwdWorkerNum;
+	hdl->verify_worker_num = CefC_Default_VerifyWorkerNum;
+	hdl->udp_batch_num = CefC_Default_UdpBatchNum;
+	hdl->epfd 	 = -1;
+	hdl->tick_fd = -1;
+	hdl->wake_fd = -1;
 
 	/* Initialize the frame module 						*/
 	cef_client_config_dir_get (conf_path);
@@ -1072,6 +1403,8 @@ cefnetd_handle_create (
 
 	/* Creates and initialize FIB			*/
 	hdl->fib = cef_hash_tbl_create_ext ((uint16_t) hdl->fib_max_size, CefC_Hash_Coef_FIB);
+	/* FIB entries are not referred to by the slot index, so the table may grow 	*/
+	cef_hash_tbl_resize_enable (hdl->fib);
 	cef_fib_init (hdl->fib,
 				  hdl->nodeid4_num,
 				  hdl->nodeid16_num,
@@ -1090,8 +1423,39 @@ cefnetd_handle_create (
 
 	/* Creates PIT 							*/
 	cef_pit_init (hdl->ccninfo_reply_timeout, hdl->Symbolic_max_lifetime, hdl->Regular_max_lifetime); //0.8.3
-	hdl->pit = cef_lhash_tbl_create_ext (hdl->pit_max_size, CefC_Hash_Coef_PIT);
-	hdl->pit_clean_t = cef_client_present_timeus_calc () + CefC_Pit_CleaningTime;
+	if (hdl->fwd_worker_num > 1) {
+		/* The PIT is split by the name so that each worker owns a shard 	*/
+		for (res = 0 ; res < hdl->fwd_worker_num ; res++) {
+			hdl->pit_shards[res] = cef_lhash_tbl_create_ext (
+				(hdl->pit_max_size + hdl->fwd_worker_num - 1) / hdl->fwd_worker_num,
+				CefC_Hash_Coef_PIT);
+		}
+		hdl->pit = hdl->pit_shards[0];
+#ifdef __linux__
+		{
+			/* Workers re-take the read lock per batch, so let the main 	*/
+			/* thread's write lock go first 								*/
+			pthread_rwlockattr_t attr;
+			pthread_rwlockattr_init (&attr);
+			pthread_rwlockattr_setkind_np (
+				&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+			pthread_rwlock_init (&hdl->fwd_rwlock, &attr);
+			pthread_rwlockattr_destroy (&attr);
+		}
+#else // __linux__
+		pthread_rwlock_init (&hdl->fwd_rwlock, NULL);
+#endif // __linux__
+	} else {
+		hdl->pit = cef_lhash_tbl_create_ext (hdl->pit_max_size, CefC_Hash_Coef_PIT);
+		hdl->pit_shards[0] = hdl->pit;
+	}
+	for (res = 0 ; res < hdl->fwd_worker_num ; res++) {
+		if (cef_pit_wheel_create (hdl->pit_shards[res]) < 0) {
+			cef_log_write (CefC_Log_Error, "Failed to create the PIT expiry wheel\n");
+			return (NULL);
+		}
+	}
+	hdl->pit_clean_t = cef_client_present_timeus_calc () + CefC_Pit_Wheel_Tick;
 	cef_log_write (CefC_Log_Info, "Creation PIT ... OK\n");
 
 	/* Prepares sockets for applications 	*/
@@ -1293,6 +1657,27 @@ cefnetd_handle_create (
 
 	/*#####*/
 
+	/* Prepares the batched UDP input/output 	*/
+	if (cefnetd_udp_batch_init (hdl) < 0) {
+		cefnetd_handle_destroy (hdl);
+		cef_log_write (CefC_Log_Error, "Failed to allocate the UDP batch buffers\n");
+		return (NULL);
+	}
+
+	/* Starts the forwarding workers 		*/
+	if (cefnetd_fwd_workers_init (hdl) < 0) {
+		cefnetd_handle_destroy (hdl);
+		cef_log_write (CefC_Log_Error, "Failed to start the forwarding workers\n");
+		return (NULL);
+	}
+
+	/* Starts the verification workers 		*/
+	if (cefnetd_verify_workers_init (hdl) < 0) {
+		cefnetd_handle_destroy (hdl);
+		cef_log_write (CefC_Log_Error, "Failed to start the verification workers\n");
+		return (NULL);
+	}
+
 	return (hdl);
 }
 /*--------------------------------------------------------------------------------------
@@ -1303,6 +1688,15 @@ cefnetd_handle_destroy (
 	CefT_Netd_Handle* hdl						/* cefnetd handle to destroy			*/
 ) {
 	char sock_path[1024];
+#ifdef CefC_Debug
+	CefT_Netd_Stat stat;
+#endif // CefC_Debug
+
+	/* Stops the verification and forwarding workers 		*/
+	cefnetd_verify_workers_destroy (hdl);
+	cefnetd_fwd_workers_destroy (hdl);
+	cefnetd_udp_batch_destroy (hdl);
+	cefnetd_event_epoll_destroy (hdl);
 
 	/* destroy plugins 		*/
 	cef_tp_plugin_destroy (hdl->plugin_hdl.tp);
@@ -1317,37 +1711,38 @@ cefnetd_handle_destroy (
 		hdl->fwd_strtgy_hdl->destroy();
 	}
 #ifdef CefC_Debug
+	cefnetd_stat_sum (hdl, &stat);
 	cef_dbg_write (CefC_Dbg_Fine,
-		"<STAT> Rx ContentObject = "FMTU64"\n", hdl->stat_recv_frames);
+		"<STAT> Rx ContentObject = "FMTU64"\n", stat.recv_frames);
 	cef_dbg_write (CefC_Dbg_Fine,
-		"<STAT> Tx ContentObject = "FMTU64"\n", hdl->stat_send_frames);
+		"<STAT> Tx ContentObject = "FMTU64"\n", stat.send_frames);
 	cef_dbg_write (CefC_Dbg_Fine,
-		"<STAT> Rx Interest      = "FMTU64"\n", hdl->stat_recv_interest);
+		"<STAT> Rx Interest      = "FMTU64"\n", stat.recv_interest);
 	cef_dbg_write (CefC_Dbg_Fine,
 		"                        = RGL("FMTU64"), SYM("FMTU64"), SEL("FMTU64")\n",
-									hdl->stat_recv_interest_types[0],
-									hdl->stat_recv_interest_types[1],
-									hdl->stat_recv_interest_types[2]);
+									stat.recv_interest_types[0],
+									stat.recv_interest_types[1],
+									stat.recv_interest_types[2]);
 	cef_dbg_write (CefC_Dbg_Fine,
-		"<STAT> Tx Interest      = "FMTU64"\n", hdl->stat_send_interest);
+		"<STAT> Tx Interest      = "FMTU64"\n", stat.send_interest);
 	cef_dbg_write (CefC_Dbg_Fine,
 		"                        = RGL("FMTU64"), SYM("FMTU64"), SEL("FMTU64")\n",
-									hdl->stat_send_interest_types[0],
-									hdl->stat_send_interest_types[1],
-									hdl->stat_send_interest_types[2]);
+									stat.send_interest_types[0],
+									stat.send_interest_types[1],
+									stat.send_interest_types[2]);
 	cef_dbg_write (CefC_Dbg_Fine,
-		"<STAT> No PIT Frames    = "FMTU64"\n", stat_nopit_frames);
+		"<STAT> No PIT Frames    = "FMTU64"\n", stat.nopit_frames);
 	cef_dbg_write (CefC_Dbg_Fine,
-		"<STAT> Frame Size Cnt   = "FMTU64"\n", stat_rcv_size_cnt);
+		"<STAT> Frame Size Cnt   = "FMTU64"\n", stat.rcv_size_cnt);
 	cef_dbg_write (CefC_Dbg_Fine,
-		"<STAT> Frame Size Sum   = "FMTU64"\n", stat_rcv_size_sum);
-	if (stat_rcv_size_min > 65535) {
-		stat_rcv_size_min = 0;
+		"<STAT> Frame Size Sum   = "FMTU64"\n", stat.rcv_size_sum);
+	if (stat.rcv_size_min > 65535) {
+		stat.rcv_size_min = 0;
 	}
 	cef_dbg_write (CefC_Dbg_Fine,
-		"<STAT> Frame Size Min   = "FMTU64"\n", stat_rcv_size_min);
+		"<STAT> Frame Size Min   = "FMTU64"\n", stat.rcv_size_min);
 	cef_dbg_write (CefC_Dbg_Fine,
-		"<STAT> Frame Size Max   = "FMTU64"\n", stat_rcv_size_max);
+		"<STAT> Frame Size Max   = "FMTU64"\n", stat.rcv_size_max);
 #endif // CefC_Debug
 
 	cefnetd_faces_destroy (hdl);
@@ -1380,8 +1775,6 @@ cefnetd_event_dispatch (
 	int i;
 	int res;
 
-	uint64_t nowt = cef_client_present_timeus_calc ();
-
 	cef_log_write (CefC_Log_Info, "Running\n");
 	cefnetd_running_f = 1;
 
@@ -1390,113 +1783,53 @@ cefnetd_event_dispatch (
 	int faceids[CefC_Listen_Face_Max * 2];
 	int fdnum;
 
-#ifdef CefC_Ccore
-	uint64_t ret_cnt = 5;
-#endif
+#ifndef CefC_MACOS
+	if (cefnetd_event_epoll_init (hdl) == 0) {
+		cefnetd_event_epoll_dispatch (hdl);
+		return;
+	}
+	cef_log_write (CefC_Log_Warn,
+		"Failed to prepare epoll (%s), so poll is used\n", strerror (errno));
+#endif // CefC_MACOS
+
 	while (cefnetd_running_f) {
 
 		/* Calculates the present time 						*/
-		nowt = cef_client_present_timeus_calc ();
-		hdl->nowtus = nowt;
-
-#ifdef CefC_Ccore
-		if (hdl->rt_hdl) {
-			/* Re-connect to ccored 		*/
-			if ((hdl->rt_hdl->sock == -1) &&
-				(hdl->nowtus > hdl->rt_hdl->reconnect_time)) {
-				cef_log_write (CefC_Log_Info,
-						"cefnetd is trying to connect with ccored ...\n");
-				hdl->rt_hdl->sock =
-					ccore_connect_tcp_to_ccored (
-							hdl->rt_hdl->controller_id, hdl->rt_hdl->port_str);
-				if (hdl->rt_hdl->sock != -1) {
-					cef_log_write (CefC_Log_Info,
-						"cefnetd connects to that ccored\n");
-					hdl->rt_hdl->reconnect_time = 0;
-					ret_cnt = 3;
-				} else {
-					cef_log_write (CefC_Log_Info,
-						"cefnetd failed to connect with ccored\n");
-					nowt = cef_client_present_timeus_calc ();
-					hdl->nowtus = nowt;
-					hdl->rt_hdl->reconnect_time = hdl->nowtus + 1000000 * ret_cnt;
-
-					if (ret_cnt < 60) {
-						ret_cnt += 5;
-					}
-				}
-			}
-		}
-#endif // CefC_Ccore
+		hdl->nowtus = cef_client_present_timeus_calc ();
 
-		/* Cleans PIT entries 		*/
-		cefnetd_pit_cleanup (hdl, nowt);
+		/* The tables shared with the forwarding workers are updated below 	*/
+		cefnetd_fwd_lock (hdl);
+		cefnetd_event_housekeeping (hdl);
 
-		/* Cleans FIB entries 		*/
-		cefnetd_fib_cleanup (hdl, nowt);
 		/* Accepts the TCP socket 	*/
-		res = cef_face_accept_connect ();
-
-		if ((res > 0) && (hdl->intcpfdc < CefC_Listen_Face_Max)) {
-			hdl->intcpfaces[hdl->intcpfdc] = (uint16_t) res;
-			hdl->intcpfds[hdl->intcpfdc].fd
-				= cef_face_get_fd_from_faceid ((uint16_t) res);
-			hdl->intcpfds[hdl->intcpfdc].events = POLLIN | POLLERR;
-			hdl->intcpfdc++;
-		}
+		cefnetd_tcp_accept (hdl);
 
 		/* Receives the frame(s) from local process 		*/
 		cefnetd_input_from_local_process (hdl);
 		cef_face_update_listen_faces (
 				hdl->inudpfds, hdl->inudpfaces, &hdl->inudpfdc,
 				hdl->intcpfds, hdl->intcpfaces, &hdl->intcpfdc);
+
 		/* Receives the frame(s) from the listen port 		*/
 		fdnum = cefnetd_poll_socket_prepare (hdl, fds, fd_type, faceids);
+		cefnetd_fwd_unlock (hdl);
 		res = poll (fds, fdnum, 1);
 
 		for (i = 0 ; res > 0 && i < fdnum ; i++) {
 
 			if (fds[i].revents != 0) {
 				res--;
-				if (fds[i].revents & POLLIN) {
-					if (fd_type[i] == CefC_Connection_Type_Local) {
-						continue;
-					}
-					(*cefnetd_input_process[fd_type[i]]) (
-										hdl, fds[i].fd, faceids[i]);
-				}
+				cefnetd_event_input (hdl, fds[i].fd, fd_type[i], faceids[i],
+					(fds[i].revents & POLLIN) ? 1 : 0,
 #ifdef __APPLE__
-				if (fds[i].revents & (POLLERR | POLLNVAL)) {
+					(fds[i].revents & (POLLERR | POLLNVAL)) ? 1 : 0);
 #else // __APPLE__
-				if (fds[i].revents & (POLLERR | POLLNVAL | POLLHUP)) {
+					(fds[i].revents & (POLLERR | POLLNVAL | POLLHUP)) ? 1 : 0);
 #endif // __APPLE__
-					if (fd_type[i] < CefC_Connection_Type_Csm) {
-						cef_face_close (faceids[i]);
-						cef_fib_faceid_cleanup (hdl->fib);
-					}
-				}
-
-			}
-		}
-
-		cefnetd_input_from_txque_process (hdl);
-
-#ifdef CefC_ContentStore
-		if ((hdl->cs_stat->cache_type != CefC_Cache_Type_None) &&
-			(nowt > ccninfo_push_time)) {
-			if (hdl->cs_stat->cache_type == CefC_Cache_Type_Excache) {
-				cef_csmgr_excache_item_push (hdl->cs_stat);
-				ccninfo_push_time = nowt + 500000;
 			}
-#ifdef	CefC_CefnetdCache
-			else
-			if (hdl->cs_stat->cache_type == CefC_Cache_Type_Localcache) {
-				; /* NOP */
-			}
-#endif	//CefC_CefnetdCache
 		}
-#endif // CefC_ContentStore
 
+		cefnetd_event_post_process (hdl);
 	}
 
 }
@@ -1639,6 +1972,126 @@ static int										/* No care now							*/
 	return (0);
 }
 
+/*--------------------------------------------------------------------------------------
+	Runs the timed housekeeping of the main loop (ccored, PIT and FIB cleanup)
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_housekeeping (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	uint64_t nowt = hdl->nowtus;
+
+#ifdef CefC_Ccore
+	if (hdl->rt_hdl) {
+		/* Re-connect to ccored 		*/
+		if ((hdl->rt_hdl->sock == -1) &&
+			(hdl->nowtus > hdl->rt_hdl->reconnect_time)) {
+			cef_log_write (CefC_Log_Info,
+					"cefnetd is trying to connect with ccored ...\n");
+			hdl->rt_hdl->sock =
+				ccore_connect_tcp_to_ccored (
+						hdl->rt_hdl->controller_id, hdl->rt_hdl->port_str);
+			if (hdl->rt_hdl->sock != -1) {
+				cef_log_write (CefC_Log_Info,
+					"cefnetd connects to that ccored\n");
+				hdl->rt_hdl->reconnect_time = 0;
+				ccore_retry_cnt = 3;
+			} else {
+				cef_log_write (CefC_Log_Info,
+					"cefnetd failed to connect with ccored\n");
+				nowt = cef_client_present_timeus_calc ();
+				hdl->nowtus = nowt;
+				hdl->rt_hdl->reconnect_time = hdl->nowtus + 1000000 * ccore_retry_cnt;
+
+				if (ccore_retry_cnt < 60) {
+					ccore_retry_cnt += 5;
+				}
+			}
+		}
+	}
+#endif // CefC_Ccore
+
+	/* Cleans PIT entries 		*/
+	cefnetd_pit_cleanup (hdl, nowt);
+
+	/* Cleans FIB entries 		*/
+	cefnetd_fib_cleanup (hdl, nowt);
+}
+/*--------------------------------------------------------------------------------------
+	Runs the housekeeping of the main loop after the sockets are handled
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_post_process (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	/* The messages handed back by the workers update the shared tables 	*/
+	if (((hdl->verify_worker_num > 0) &&
+		 (cef_rngque_read (hdl->verify_done_que) != NULL)) ||
+		((hdl->fwd_worker_num > 1) &&
+		 (cef_rngque_read (hdl->fwd_defer_que) != NULL))) {
+		cefnetd_fwd_lock (hdl);
+		cefnetd_verify_done_process (hdl);
+		cefnetd_fwd_deferred_process (hdl);
+		cefnetd_fwd_unlock (hdl);
+	}
+
+	/* Sending and the cache of csmgrd are not shared with the workers 	*/
+	cefnetd_input_from_txque_process (hdl);
+
+#ifdef CefC_ContentStore
+	/* The lookups of this round are sent to csmgrd at once 	*/
+	if (hdl->cs_stat->cache_type == CefC_Cache_Type_Excache) {
+		cef_csmgr_excache_lookup_push (hdl->cs_stat);
+	}
+	if ((hdl->cs_stat->cache_type != CefC_Cache_Type_None) &&
+		(hdl->nowtus > ccninfo_push_time)) {
+		if (hdl->cs_stat->cache_type == CefC_Cache_Type_Excache) {
+			cef_csmgr_excache_item_push (hdl->cs_stat);
+			ccninfo_push_time = hdl->nowtus + 500000;
+		}
+#ifdef	CefC_CefnetdCache
+		else
+		if (hdl->cs_stat->cache_type == CefC_Cache_Type_Localcache) {
+			; /* NOP */
+		}
+#endif	//CefC_CefnetdCache
+	}
+#endif // CefC_ContentStore
+}
+/*--------------------------------------------------------------------------------------
+	Handles the readiness of the socket
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_input (
+	CefT_Netd_Handle* hdl,						/* cefnetd handle						*/
+	int fd, 									/* FD which is ready 					*/
+	CefC_Connection_Type fd_type,
+	int faceid,									/* Face-ID of the FD 					*/
+	int in_f,									/* 1 if the FD is readable 				*/
+	int err_f									/* 1 if an error or hang-up occurred 	*/
+) {
+	/* Local faces are handled by cefnetd_input_from_local_process 	*/
+	if (fd_type == CefC_Connection_Type_Local) {
+		return;
+	}
+	if (in_f) {
+		/* UDP/TCP frames are locked per message since they	*/
+		/* may be handed over to the forwarding workers 	*/
+		if (fd_type >= CefC_Connection_Type_Csm) {
+			cefnetd_fwd_lock (hdl);
+		}
+		(*cefnetd_input_process[fd_type]) (hdl, fd, faceid);
+		if (fd_type >= CefC_Connection_Type_Csm) {
+			cefnetd_fwd_unlock (hdl);
+		}
+	}
+	if ((err_f) && (fd_type < CefC_Connection_Type_Csm)) {
+		cefnetd_fwd_lock (hdl);
+		cef_face_close (faceid);
+		cef_fib_faceid_cleanup (hdl->fib);
+		cefnetd_fwd_unlock (hdl);
+	}
+}
 /*--------------------------------------------------------------------------------------
 	Prepares the UDP and TCP sockets to be polled
 ----------------------------------------------------------------------------------------*/
@@ -1779,9 +2232,9 @@ cefnetd_input_from_txque_process (
 						new_buff_len =
 							cef_frame_seqence_update (tx_elem->msg, seqnum);
 					}
-					cef_face_frame_send_forced (
+					cef_face_frame_send_batch (
 						tx_elem->faceids[i], tx_elem->msg, new_buff_len);
-					hdl->stat_send_frames++;
+					CefC_Netd_Stat_Add (hdl->stat.send_frames, 1);
 				}
 			}
 
@@ -1793,6 +2246,7 @@ FREE_POOLED_BK:
 			break;
 		}
 	}
+	cef_face_frame_send_flush ();
 
 #ifdef CefC_ContentStore
 	if ((hdl->cs_stat->cache_type != CefC_Default_Cache_Type) &&
@@ -1817,7 +2271,7 @@ FREE_POOLED_BK:
 				cef_mpool_free (cs_stat->tx_cob_mp, cob_temp);
 				cef_mpool_free (cs_stat->tx_que_mp, cs_tx_elem);
 				send_cnt++;
-				hdl->stat_send_frames++;
+				CefC_Netd_Stat_Add (hdl->stat.send_frames, 1);
 			} else {
 #ifdef CefC_Debug
 				cef_dbg_write (CefC_Dbg_Fine,
@@ -1845,192 +2299,292 @@ FREE_POOLED_BK:
 static int										/* No care now							*/
 cefnetd_input_from_local_process (
 	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	int i;
+
+	/* The local sockets are not polled, so all of them are read every round 	*/
+	cefnetd_local_accept (hdl);
+
+	for (i = 0 ; i < hdl->app_fds_num ; i++) {
+		if (cefnetd_local_app_input (hdl, i) < 0) {
+			i--;
+		}
+	}
+
+	if (!hdl->babel_use_f) {
+		return (1);
+	}
+	cefnetd_babel_accept (hdl);
+
+	if (hdl->babel_sock < 0) {
+		return (1);
+	}
+	cefnetd_babel_input (hdl);
+
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Handles the local socket, the listen socket or the local face which is ready
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_input_from_local_event (
+	CefT_Netd_Handle* hdl,						/* cefnetd handle						*/
+	int fd, 									/* FD which is ready 					*/
+	int faceid									/* Face-ID of the FD 					*/
+) {
+	int i;
+
+	if (faceid == CefC_Faceid_Local) {
+		cefnetd_local_accept (hdl);
+		return;
+	}
+	if ((faceid == CefC_Faceid_ListenTcpv4) || (faceid == CefC_Faceid_ListenTcpv6)) {
+		cefnetd_tcp_accept (hdl);
+		return;
+	}
+	if (faceid == CefC_Faceid_ListenBabel) {
+		if (hdl->babel_use_f) {
+			cefnetd_babel_accept (hdl);
+		}
+		return;
+	}
+	if ((hdl->babel_sock >= 0) && (fd == hdl->babel_sock)) {
+		cefnetd_babel_input (hdl);
+		return;
+	}
+	for (i = 0 ; i < hdl->app_fds_num ; i++) {
+		if (hdl->app_fds[i] == fd) {
+			cefnetd_local_app_input (hdl, i);
+			return;
+		}
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Accepts the TCP connection from the listen socket
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_tcp_accept (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	int res;
+
+	res = cef_face_accept_connect ();
+
+	if ((res > 0) && (hdl->intcpfdc < CefC_Listen_Face_Max)) {
+		hdl->intcpfaces[hdl->intcpfdc] = (uint16_t) res;
+		hdl->intcpfds[hdl->intcpfdc].fd
+			= cef_face_get_fd_from_faceid ((uint16_t) res);
+		hdl->intcpfds[hdl->intcpfdc].events = POLLIN | POLLERR;
+		hdl->intcpfdc++;
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Accepts the connection from local process
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_local_accept (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
 ) {
 	int sock;
 	int work_peer_sock;
 	struct sockaddr_un peeraddr;
 	socklen_t addrlen = (socklen_t) sizeof (peeraddr);
-	int len;
 	int flag;
-	int i;
 	int peer_faceid;
-	unsigned char buff[CefC_Max_Length];
-	unsigned char* rsp_msg;
-	struct pollfd send_fds[1];
-	char	user_id[512];
-	rsp_msg = calloc(1, CefC_Max_Length*10);
 
 	/* Obtains the FD for local face 	*/
 	sock = cef_face_get_fd_from_faceid (CefC_Faceid_Local);
 
 	/* Accepts the interrupt from local process */
 	if ((work_peer_sock = accept (sock, (struct sockaddr*)&peeraddr, &addrlen)) < 0) {
-		/* NOP */;
-	} else {
-		if (hdl->app_fds_num < CefC_App_Conn_Num) {
-			hdl->app_fds[hdl->app_fds_num] = work_peer_sock;
+		return;
+	}
+	if (hdl->app_fds_num >= CefC_App_Conn_Num) {
+		close (work_peer_sock);
+		return;
+	}
 
-			flag = fcntl (hdl->app_fds[hdl->app_fds_num], F_GETFL, 0);
-			if (flag < 0) {
-				cef_log_write (CefC_Log_Info,
-					"<Fail> cefnetd_input_from_local_process (fcntl)\n");
-				work_peer_sock = -1;
-			} else {
-				if (fcntl (hdl->app_fds[hdl->app_fds_num]
-									, F_SETFL, flag | O_NONBLOCK) < 0) {
-					cef_log_write (CefC_Log_Info,
-						"<Fail> cefnetd_input_from_local_process (fcntl)\n");
-					work_peer_sock = -1;
-				}
-			}
-			if (work_peer_sock != -1) {
-				peer_faceid = cef_face_lookup_local_faceid (work_peer_sock);
+	flag = fcntl (work_peer_sock, F_GETFL, 0);
+	if ((flag < 0) ||
+		(fcntl (work_peer_sock, F_SETFL, flag | O_NONBLOCK) < 0)) {
+		cef_log_write (CefC_Log_Info,
+			"<Fail> cefnetd_input_from_local_process (fcntl)\n");
+		close (work_peer_sock);
+		return;
+	}
+	peer_faceid = cef_face_lookup_local_faceid (work_peer_sock);
 
-				if (peer_faceid < 0) {
-					close (hdl->app_steps[hdl->app_fds_num]);
-					hdl->app_fds[hdl->app_fds_num] = -1;
-				} else {
-					hdl->app_faces[hdl->app_fds_num] = peer_faceid;
-					hdl->app_steps[hdl->app_fds_num] = 0;
-					hdl->app_fds_num++;
-				}
-			} else {
-				close (hdl->app_steps[hdl->app_fds_num]);
-				hdl->app_fds[hdl->app_fds_num] = -1;
-			}
-		} else {
-			close (work_peer_sock);
-		}
+	if (peer_faceid < 0) {
+		close (work_peer_sock);
+		return;
 	}
+	hdl->app_fds[hdl->app_fds_num] 	 = work_peer_sock;
+	hdl->app_faces[hdl->app_fds_num] = peer_faceid;
+	hdl->app_steps[hdl->app_fds_num] = 0;
+	hdl->app_fds_num++;
+}
+/*--------------------------------------------------------------------------------------
+	Closes the local face of the application
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_local_app_remove (
+	CefT_Netd_Handle* hdl,						/* cefnetd handle						*/
+	int idx										/* index of the application 			*/
+) {
+	int i;
 
-	/* Checks whether frame(s) arrivals from the active local faces */
-	for (i = 0 ; i < hdl->app_fds_num ; i++) {
-		len = recv (hdl->app_fds[i], buff, CefC_Max_Length, 0);
+	cef_face_close (hdl->app_faces[idx]);
+	hdl->app_fds[idx] = -1;
+	hdl->app_fds_num--;
 
-		if (len > 0) {
-			hdl->app_steps[i] = 0;
+	for (i = idx ; i < hdl->app_fds_num ; i++) {
+		hdl->app_fds[i] 	= hdl->app_fds[i + 1];
+		hdl->app_faces[i] 	= hdl->app_faces[i + 1];
+		hdl->app_steps[i] 	= hdl->app_steps[i + 1];
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Sends the response of the control message to the local process
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_local_rsp_send (
+	int fd, 									/* socket of the local process 			*/
+	unsigned char* rsp_msg,
+	int rsp_len
+) {
+	int	fblocks;
+	int rem_size;
+	int counter;
+	int fcntlfl;
+
+	fcntlfl = fcntl (fd, F_GETFL, 0);
+	fcntl (fd, F_SETFL, fcntlfl & ~O_NONBLOCK);
+	fblocks = rsp_len / 65535;
+	rem_size = rsp_len % 65535;
+	for (counter=0; counter<fblocks; counter++){
+		send (fd, &rsp_msg[counter*65535], 65535, 0);
+	}
+	if (rem_size != 0){
+		send (fd, &rsp_msg[fblocks*65535], rem_size, 0);
+	}
+	fcntl (fd, F_SETFL, fcntlfl | O_NONBLOCK);
+}
+/*--------------------------------------------------------------------------------------
+	Receives the frame from the local face of the application
+----------------------------------------------------------------------------------------*/
+static int										/* -1 if the application was removed 	*/
+cefnetd_local_app_input (
+	CefT_Netd_Handle* hdl,						/* cefnetd handle						*/
+	int idx										/* index of the application 			*/
+) {
+	int len;
+	int flag;
+	unsigned char buff[CefC_Max_Length];
+	unsigned char* rsp_msg;
+	struct pollfd send_fds[1];
+	char	user_id[512];
 
-			if (memcmp (buff, CefC_Ctrl, CefC_Ctrl_Len) == 0) {
-				flag = cefnetd_input_control_message (
-						hdl, buff, len, &rsp_msg, hdl->app_fds[i]);
-				if (flag > 0) {
-					send_fds[0].fd = hdl->app_fds[i];
-					send_fds[0].events = POLLOUT | POLLERR;
-					if (poll (send_fds, 1, 0) > 0) {
-						if (send_fds[0].revents & (POLLERR | POLLNVAL | POLLHUP)) {
-							cef_log_write (CefC_Log_Warn,
-								"Failed to send to Local peer (%d)\n", send_fds[0].fd);
-						} else {
-							{
-								int	fblocks;
-								int rem_size;
-								int counter;
-								int fcntlfl;
-								fcntlfl = fcntl (hdl->app_fds[i], F_GETFL, 0);
-								fcntl (hdl->app_fds[i], F_SETFL, fcntlfl & ~O_NONBLOCK);
-								fblocks = flag / 65535;
-								rem_size = flag % 65535;
-								for (counter=0; counter<fblocks; counter++){
-									send (hdl->app_fds[i], &rsp_msg[counter*65535], 65535, 0);
-								}
-								if (rem_size != 0){
-									send (hdl->app_fds[i], &rsp_msg[fblocks*65535], rem_size, 0);
-								}
-								fcntl (hdl->app_fds[i], F_SETFL, fcntlfl | O_NONBLOCK);
-							}
-						}
-					}
-				}
-			} else if (memcmp (buff, CefC_Face_Close, len) == 0) {
+	len = recv (hdl->app_fds[idx], buff, CefC_Max_Length, 0);
 
-				cef_face_close (hdl->app_faces[i]);
-				hdl->app_fds[i] = -1;
-				hdl->app_fds_num--;
+	if (len > 0) {
+		hdl->app_steps[idx] = 0;
 
-				for (flag = i ; flag < hdl->app_fds_num ; flag++) {
-					hdl->app_fds[flag] = hdl->app_fds[flag + 1];
-					hdl->app_faces[flag] = hdl->app_faces[flag + 1];
-					hdl->app_steps[flag] = hdl->app_steps[flag + 1];
-				}
-				i--;
-			} else {
-				cefnetd_input_message_process (
-						hdl, CefC_Faceid_Local, hdl->app_faces[i], buff, len, user_id);
+		if (memcmp (buff, CefC_Ctrl, CefC_Ctrl_Len) == 0) {
+			/* The buffer of the response is allocated only for the control 	*/
+			rsp_msg = calloc (1, CefC_Max_Length*10);
+			if (rsp_msg == NULL) {
+				return (1);
 			}
-		}
-		else {
-			struct pollfd fds[1];
-			fds[0].fd = hdl->app_fds[i];
-			fds[0].events = POLLIN | POLLERR;
-			poll (fds, 1, 0);
-			if ((fds[0].revents & POLLIN) && (fds[0].revents & POLLHUP)) {
-				cef_face_close (hdl->app_faces[i]);
-				hdl->app_fds[i] = -1;
-				hdl->app_fds_num--;
-
-				for (flag = i ; flag < hdl->app_fds_num ; flag++) {
-					hdl->app_fds[flag] = hdl->app_fds[flag + 1];
-					hdl->app_faces[flag] = hdl->app_faces[flag + 1];
-					hdl->app_steps[flag] = hdl->app_steps[flag + 1];
+			flag = cefnetd_input_control_message (
+					hdl, buff, len, &rsp_msg, hdl->app_fds[idx]);
+			if (flag > 0) {
+				send_fds[0].fd = hdl->app_fds[idx];
+				send_fds[0].events = POLLOUT | POLLERR;
+				if (poll (send_fds, 1, 0) > 0) {
+					if (send_fds[0].revents & (POLLERR | POLLNVAL | POLLHUP)) {
+						cef_log_write (CefC_Log_Warn,
+							"Failed to send to Local peer (%d)\n", send_fds[0].fd);
+					} else {
+						cefnetd_local_rsp_send (hdl->app_fds[idx], rsp_msg, flag);
+					}
 				}
-				i--;
 			}
+			free (rsp_msg);
+		} else if (memcmp (buff, CefC_Face_Close, len) == 0) {
+			cefnetd_local_app_remove (hdl, idx);
+			return (-1);
+		} else {
+			cefnetd_input_message_process (
+					hdl, CefC_Faceid_Local, hdl->app_faces[idx], buff, len, user_id);
 		}
 	}
-
-	if (!hdl->babel_use_f) {
-		if (rsp_msg != NULL){
-			free(rsp_msg);
-			rsp_msg = NULL;
+	else {
+		struct pollfd fds[1];
+		fds[0].fd = hdl->app_fds[idx];
+		fds[0].events = POLLIN | POLLERR;
+		poll (fds, 1, 0);
+		if ((fds[0].revents & POLLIN) && (fds[0].revents & POLLHUP)) {
+			cefnetd_local_app_remove (hdl, idx);
+			return (-1);
 		}
-		return (1);
 	}
 
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Accepts the connection from babeld
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_babel_accept (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	int sock;
+	int work_peer_sock;
+	struct sockaddr_un peeraddr;
+	socklen_t addrlen = (socklen_t) sizeof (peeraddr);
+	int flag;
+	int peer_faceid;
+
 	/* Obtains the FD for local face 	*/
 	sock = cef_face_get_fd_from_faceid (CefC_Faceid_ListenBabel);
 
 	/* Accepts the interrupt from local process */
 	if ((work_peer_sock = accept (sock, (struct sockaddr*)&peeraddr, &addrlen)) < 0) {
-		/* NOP */;
-	} else {
-		if (hdl->babel_sock > 0) {
-			cef_face_close (hdl->babel_face);
-			hdl->babel_sock = -1;
-			hdl->babel_face = -1;
-		}
-		flag = fcntl (work_peer_sock, F_GETFL, 0);
-		if (flag < 0) {
-			cef_log_write (CefC_Log_Info,
-				"<Fail> cefnetd_input_from_local_process (fcntl)\n");
-			work_peer_sock = -1;
-		} else {
-			if (fcntl (work_peer_sock, F_SETFL, flag | O_NONBLOCK) < 0) {
-				cef_log_write (CefC_Log_Info,
-					"<Fail> cefnetd_input_from_local_process (fcntl)\n");
-				work_peer_sock = -1;
-			}
-		}
-		if (work_peer_sock != -1) {
-			peer_faceid = cef_face_lookup_local_faceid (work_peer_sock);
-
-			if (peer_faceid < 0) {
-				close (work_peer_sock);
-			} else {
-				hdl->babel_sock = work_peer_sock;
-				hdl->babel_face = peer_faceid;
-			}
-		} else {
-			close (work_peer_sock);
-		}
+		return;
+	}
+	if (hdl->babel_sock > 0) {
+		cef_face_close (hdl->babel_face);
+		hdl->babel_sock = -1;
+		hdl->babel_face = -1;
+	}
+	flag = fcntl (work_peer_sock, F_GETFL, 0);
+	if ((flag < 0) ||
+		(fcntl (work_peer_sock, F_SETFL, flag | O_NONBLOCK) < 0)) {
+		cef_log_write (CefC_Log_Info,
+			"<Fail> cefnetd_input_from_local_process (fcntl)\n");
+		close (work_peer_sock);
+		return;
 	}
+	peer_faceid = cef_face_lookup_local_faceid (work_peer_sock);
 
-	if (hdl->babel_sock < 0) {
-		if (rsp_msg != NULL){
-			free(rsp_msg);
-			rsp_msg = NULL;
-		}
-		return (1);
+	if (peer_faceid < 0) {
+		close (work_peer_sock);
+	} else {
+		hdl->babel_sock = work_peer_sock;
+		hdl->babel_face = peer_faceid;
 	}
+}
+/*--------------------------------------------------------------------------------------
+	Receives the frame from babeld
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_babel_input (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	int len;
+	int flag;
+	unsigned char buff[CefC_Max_Length];
+	unsigned char* rsp_msg;
 
 	/* Checks whether frame(s) arrivals from the active local faces */
 	len = recv (hdl->babel_sock, buff, CefC_Max_Length, 0);
@@ -2038,28 +2592,16 @@ cefnetd_input_from_local_process (
 	if (len > 0) {
 
 		if (memcmp (buff, CefC_Ctrl, CefC_Ctrl_Len) == 0) {
-			memset (rsp_msg, 0, CefC_Max_Length);
+			rsp_msg = calloc (1, CefC_Max_Length*10);
+			if (rsp_msg == NULL) {
+				return;
+			}
 			flag = cefnetd_input_control_message (
 					hdl, buff, len, &rsp_msg, hdl->babel_sock);
 			if (flag > 0) {
-				{
-					int	fblocks;
-					int rem_size;
-					int counter;
-					int fcntlfl;
-					fcntlfl = fcntl (hdl->babel_sock, F_GETFL, 0);
-					fcntl (hdl->babel_sock, F_SETFL, fcntlfl & ~O_NONBLOCK);
-					fblocks = flag / 65535;
-					rem_size = flag % 65535;
-					for (counter=0; counter<fblocks; counter++){
-						send (hdl->babel_sock, &rsp_msg[counter*65535], 65535, 0);
-					}
-					if (rem_size != 0){
-						send (hdl->babel_sock, &rsp_msg[fblocks*65535], rem_size, 0);
-					}
-					fcntl (hdl->babel_sock, F_SETFL, fcntlfl | O_NONBLOCK);
-				}
+				cefnetd_local_rsp_send (hdl->babel_sock, rsp_msg, flag);
 			}
+			free (rsp_msg);
 		} else if (memcmp (buff, CefC_Face_Close, len) == 0) {
 			cef_face_close (hdl->babel_face);
 			hdl->babel_sock = -1;
@@ -2085,12 +2627,6 @@ cefnetd_input_from_local_process (
 			}
 		}
 	}
-
-	if (rsp_msg != NULL){
-		free(rsp_msg);
-		rsp_msg = NULL;
-	}
-	return (1);
 }
 /*--------------------------------------------------------------------------------------
 	Handles the message to reg/dereg application name
@@ -2143,9 +2679,9 @@ cefnetd_input_app_reg_command (
 		}
 	}
 	if (poh->app_reg_f == CefC_Dev_RegPit) {
-		if (cef_lhash_tbl_item_num_get(hdl->pit) == cef_lhash_tbl_def_max_get(hdl->pit)) {
+		if (cef_lhash_tbl_item_num_get(cefnetd_pit_shard_get (hdl, pm)) == cef_lhash_tbl_def_max_get(cefnetd_pit_shard_get (hdl, pm))) {
 			cef_log_write (CefC_Log_Warn,
-				"PIT table is full(PIT_SIZE = %d)\n", cef_lhash_tbl_def_max_get(hdl->pit));
+				"PIT table is full(PIT_SIZE = %d)\n", cef_lhash_tbl_def_max_get(cefnetd_pit_shard_get (hdl, pm)));
 			return (0);
 		}
 	}
@@ -2204,11 +2740,11 @@ cefnetd_input_app_reg_command (
 		unsigned char tmp_msg[1024];
 		int pit_max, pit_num;
 
-		pit_num = cef_lhash_tbl_item_num_get(hdl->pit);
-		pit_max = cef_lhash_tbl_def_max_get(hdl->pit);
+		pit_num = cef_lhash_tbl_item_num_get(cefnetd_pit_shard_get (hdl, pm));
+		pit_max = cef_lhash_tbl_def_max_get(cefnetd_pit_shard_get (hdl, pm));
 
 		if ( pm->InterestType == CefC_PIT_TYPE_Sym ) {
-			pe = cef_pit_entry_lookup_and_down_face_update (hdl->pit, pm, poh, NULL, 0,
+			pe = cef_pit_entry_lookup_and_down_face_update (cefnetd_pit_shard_get (hdl, pm), pm, poh, NULL, 0,
 						faceid, tmp_msg, CefC_IntRetrans_Type_SUP, NULL);
 			if (pe) {
 				/* Restore the length of the name */
@@ -2233,7 +2769,7 @@ cefnetd_input_app_reg_command (
 					memcpy (&(pm->name[pm->name_len+idx]), &chunk_num_wk, CefC_S_ChunkNum);
 					pm->name_len += (CefC_S_Type + CefC_S_Length + CefC_S_ChunkNum);
 
-					pe = cef_pit_entry_lookup_and_down_face_update (hdl->pit, pm, poh, NULL, 0,
+					pe = cef_pit_entry_lookup_and_down_face_update (cefnetd_pit_shard_get (hdl, pm), pm, poh, NULL, 0,
 								faceid, tmp_msg, CefC_IntRetrans_Type_SUP, NULL);
 					if (pe) {
 						/* Restore the length of the name */
@@ -2699,21 +3235,56 @@ cefnetd_udp_input_process (
 	int fd, 									/* FD which is polled POLLIN			*/
 	int faceid									/* Face-ID that message arrived 		*/
 ) {
-	int protocol;
 	size_t recv_len;
-	int peer_faceid;
 	struct addrinfo sas;
-	struct addrinfo *sas_p;
 	socklen_t sas_len = (socklen_t) sizeof (struct addrinfo);
 	unsigned char buff[CefC_Max_Length];
+#ifndef CefC_MACOS
+	int i, num;
 
-	sas_p = &sas;
-	char user_id[512];	//0.8.3
+	CefT_Udp_Batch* bt = hdl->udp_batch;
+
+	if (bt) {
+		/* Receives the messages which have arrived with one system call 	*/
+		for (i = 0 ; i < hdl->udp_batch_num ; i++) {
+			bt->msgs[i].msg_hdr.msg_namelen = (socklen_t) sizeof (struct sockaddr_storage);
+		}
+		num = recvmmsg (fd, bt->msgs, (unsigned int) hdl->udp_batch_num, MSG_DONTWAIT, NULL);
+		for (i = 0 ; i < num ; i++) {
+			if (bt->msgs[i].msg_len < 1) {
+				continue;
+			}
+			cefnetd_udp_datagram_process (hdl, fd, faceid,
+				(unsigned char*) bt->iovs[i].iov_base, (size_t) bt->msgs[i].msg_len,
+				(struct addrinfo*) &bt->addrs[i], bt->msgs[i].msg_hdr.msg_namelen);
+		}
+		return (1);
+	}
+#endif // CefC_MACOS
 
 	/* Receives the message(s) from the specified FD */
 	recv_len
 		= recvfrom (fd, buff, CefC_Max_Length, 0, (struct sockaddr*) &sas, &sas_len);
 
+	return (cefnetd_udp_datagram_process (hdl, fd, faceid, buff, recv_len, &sas, sas_len));
+}
+/*--------------------------------------------------------------------------------------
+	Handles a datagram received from the UDP listen socket
+----------------------------------------------------------------------------------------*/
+static int
+cefnetd_udp_datagram_process (
+	CefT_Netd_Handle* hdl,						/* cefnetd handle						*/
+	int fd, 									/* FD which received the datagram		*/
+	int faceid,									/* Face-ID that message arrived 		*/
+	unsigned char* buff,						/* received datagram					*/
+	size_t recv_len,							/* length of the datagram				*/
+	struct addrinfo* sas_p,						/* source address						*/
+	socklen_t sas_len							/* length of the source address			*/
+) {
+	int protocol;
+	int peer_faceid;
+	char user_id[512];	//0.8.3
+
 	// TBD: process for the special message
 
 	/* Looks up the peer Face-ID 		*/
@@ -2843,8 +3414,10 @@ cefnetd_tcp_input_process (
 		cef_log_write (CefC_Log_Warn, "Detected Face#%d (TCP) is down\n", faceid);
 //		cef_fib_faceid_cleanup (hdl->fib, faceid);
 //		cef_face_close (faceid);
+		cefnetd_fwd_lock (hdl);
 		cef_face_close_for_down (faceid);
 		cef_face_down (faceid);
+		cefnetd_fwd_unlock (hdl);
 		return (1);
 	}
 	// TBD: process for the special message
@@ -4170,10 +4743,15 @@ cefnetd_input_message_process (
 			if (face->rcv_buff[1] > CefC_PT_MAX) {
 				cef_log_write (CefC_Log_Warn,
 					"Detects the unknown PT_XXX=%d\n", face->rcv_buff[1]);
-			} else {
+			} else if ((cefnetd_verify_worker_push (hdl, faceid, peer_faceid,
+							face->rcv_buff, fdv_payload_len, fdv_header_len, user_id) < 1) &&
+					   (cefnetd_fwd_worker_push (hdl, faceid, peer_faceid,
+							face->rcv_buff, fdv_payload_len, fdv_header_len, user_id) < 1)) {
+				cefnetd_fwd_lock (hdl);
 				(*cefnetd_incoming_msg_process[face->rcv_buff[1]])
 					(hdl, faceid, peer_faceid,
 							face->rcv_buff, fdv_payload_len, fdv_header_len, user_id);
+				cefnetd_fwd_unlock (hdl);
 			}
 
 			/* Updates the receive buffer 		*/
@@ -4433,7 +5011,7 @@ cefnetd_incoming_interest_process (
 	uint16_t header_len,					/* Header Length of this message			*/
 	char*	user_id
 ) {
-	CefT_CcnMsg_MsgBdy pm = { 0 };
+	CefT_CcnMsg_MsgBdy pm;
 	CefT_CcnMsg_OptHdr poh = { 0 };
 
 	int res;
@@ -4479,7 +5057,8 @@ cefnetd_incoming_interest_process (
 	}
 
 	/* Checks the Validation 			*/
-	res = cef_valid_msg_verify (msg, payload_len + header_len);
+	res = (cefnetd_msg_verified_f) ? 0 :
+			cef_valid_msg_verify (msg, payload_len + header_len);
 	if (res != 0) {
 		return (-1);
 	}
@@ -4617,6 +5196,15 @@ SKIP_BW_STAT_CHECK:;
 									(unsigned char*)" ]\n", strlen(" ]\n"));
 #endif // CefC_Debug
 
+	/* Commands and registrations update the tables shared by the forwarding 	*/
+	/* workers, so they are handed back to the main thread 						*/
+	if ((cefnetd_fwd_worker_f) &&
+		((cefnetd_command_check (hdl, &pm) >= 0) ||
+		 (poh.app_reg_f > 0) || (pm.org.putverify_f))) {
+		return (cefnetd_fwd_defer (hdl, faceid, peer_faceid,
+									msg, payload_len, header_len, user_id));
+	}
+
 	/* Checks whether this interest is the command or not */
 	res = cefnetd_incoming_command_process (hdl, faceid, peer_faceid, &pm);
 	if (res > 0) {
@@ -4630,7 +5218,7 @@ SKIP_BW_STAT_CHECK:;
 
 	//0.8.3	Symbolic/Osymbilic Check PIT
 	if ( pm.InterestType == CefC_PIT_TYPE_Sym ) {
-		res = cef_pit_symbolic_pit_check( hdl->pit, &pm, &poh );
+		res = cef_pit_symbolic_pit_check( cefnetd_pit_shard_get (hdl, &pm), &pm, &poh );
 		if ( res < 0 ) {
 			return (-1);
 		}
@@ -4655,7 +5243,7 @@ SKIP_BW_STAT_CHECK:;
 
 
 	/* Searches a PIT entry matching this Interest with lock	*/
-	pe = cef_pit_entry_lookup_with_lock (hdl->pit, &pm, &poh, pm.name, pm.name_len, CefC_Pit_WithLOCK);
+	pe = cef_pit_entry_lookup_with_lock (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh, pm.name, pm.name_len, CefC_Pit_WithLOCK);
 
 	if (pe == NULL) {
 		return (-1);
@@ -4676,9 +5264,9 @@ SKIP_BW_STAT_CHECK:;
 		if (pm.org.version_f == 1 && pm.org.version_len == 0) {
 			fprintf(stderr,"> VerReq\n");
 		} else {
-			fprintf(stderr,"> %d, ver=%s(%d)\n", pm.org.version_f, pm.org.version_val, pm.org.version_len);
+			fprintf(stderr,"> %d, ver=%.*s(%d)\n", pm.org.version_f, (int) pm.org.version_len, pm.org.version_val, pm.org.version_len);
 		}
-		cef_pit_entry_print (hdl->pit);
+		cef_pit_entry_print (cefnetd_pit_shard_get (hdl, &pm));
 	}
 #endif
 #endif
@@ -4712,19 +5300,20 @@ SKIP_BW_STAT_CHECK:;
 
 	if (pit_res != 0) {
 		/* Searches a FIB entry matching this Interest 		*/
-		fe = cef_fib_entry_search (hdl->fib, pm.name, name_len);
+		fe = cef_fib_entry_search_with_desc (hdl->fib, &pm, name_len);
 
 		/* Count of Received Interest */
-		hdl->stat_recv_interest++;
+		CefC_Netd_Stat_Add (cefnetd_stat_local_get (hdl)->recv_interest, 1);
 		/* Count of Received Interest by type */
-		hdl->stat_recv_interest_types[pm.InterestType]++;
+		CefC_Netd_Stat_Add (
+			cefnetd_stat_local_get (hdl)->recv_interest_types[pm.InterestType], 1);
 
 		/* Obtains Face-ID(s) to forward the Interest */
 		if (fe) {
-			/* Count of Received Interest at FIB */
-			fe->rx_int++;
+			/* Count of Received Interest at FIB (shared by the workers) */
+			__atomic_fetch_add (&fe->rx_int, 1, __ATOMIC_RELAXED);
 			/* Count of Received Interest by type at FIB */
-			fe->rx_int_types[pm.InterestType]++;
+			__atomic_fetch_add (&fe->rx_int_types[pm.InterestType], 1, __ATOMIC_RELAXED);
 			face_num = cef_fib_forward_faceid_select (fe, peer_faceid, faceids);
 		}
 
@@ -4745,7 +5334,7 @@ SKIP_BW_STAT_CHECK:;
 	}
 
 	// cefore-0.10.0
-	{	CefT_Pit_Entry* tmpe = cef_pit_entry_search_without_chunk (hdl->pit, &pm, &poh);
+	{	CefT_Pit_Entry* tmpe = cef_pit_entry_search_without_chunk (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh);
 		if ( tmpe ){
 			contents_hashv = tmpe->hashv;	/* Hash value of this contents */
 		} else {
@@ -4991,7 +5580,7 @@ cefnetd_incoming_object_process (
 	uint16_t header_len,					/* Header Length of this message			*/
 	char*	user_id
 ) {
-	CefT_CcnMsg_MsgBdy pm = { 0 };
+	CefT_CcnMsg_MsgBdy pm;
 	CefT_CcnMsg_OptHdr poh = { 0 };
 	CefT_Pit_Entry* pe = NULL;
 	int res;
@@ -5025,7 +5614,8 @@ cefnetd_incoming_object_process (
 	pkt_len = payload_len + header_len;	//0.8.3
 
 	/* Checks the Validation 			*/
-	res = cef_valid_msg_verify (msg, payload_len + header_len);
+	res = (cefnetd_msg_verified_f) ? 0 :
+			cef_valid_msg_verify (msg, payload_len + header_len);
 	if (res != 0) {
 #ifdef	__VALID_NG__
 		fprintf( stderr, "[%s] Validation NG\n", __func__ );
@@ -5049,21 +5639,17 @@ cefnetd_incoming_object_process (
 								(unsigned char*)" ]\n", strlen(" ]\n"));
 #endif // CefC_Debug
 
+	if ((cefnetd_fwd_worker_f) && (cefnetd_command_check (hdl, &pm) >= 0)) {
+		return (cefnetd_fwd_defer (hdl, faceid, peer_faceid,
+									msg, payload_len, header_len, user_id));
+	}
+
 	/* Checks whether this Object is the command or not */
 	res = cefnetd_incoming_command_process (hdl, faceid, peer_faceid, &pm);
 	if (res > 0) {
 		return (1);
 	}
-	hdl->stat_recv_frames++;
-
-	stat_rcv_size_cnt++;
-	stat_rcv_size_sum += (payload_len + header_len);
-	if ((payload_len + header_len) < stat_rcv_size_min) {
-		stat_rcv_size_min = payload_len + header_len;
-	}
-	if ((payload_len + header_len) > stat_rcv_size_max) {
-		stat_rcv_size_max = payload_len + header_len;
-	}
+	cefnetd_stat_recv_frame_add (hdl, payload_len + header_len);
 
 #ifdef CefC_ContentStore
 	/*--------------------------------------------------------------------
@@ -5085,10 +5671,10 @@ cefnetd_incoming_object_process (
 	pe = cef_pit_entry_search_with_chunk (hdl->app_pit, &pm, &poh);
 	if ( pe == NULL ){
 		/**** 2nd. reguler pit ****/
-		pe = cef_pit_entry_search_with_chunk (hdl->pit, &pm, &poh);
+		pe = cef_pit_entry_search_with_chunk (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh);
 		if ( pe == NULL ){
 			/**** 3rd. symbolic pit ****/
-			pe = cef_pit_entry_search_without_chunk (hdl->pit, &pm, &poh);
+			pe = cef_pit_entry_search_without_chunk (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh);
 			if ( pe && pm.chunk_num_f ){
 				if ( pm.chunk_num < (pe->Last_chunk_num - hdl->SymbolicBack) ) {
 					cef_dbg_write (CefC_Dbg_Fine, "SymbolicBack drop, chunk_num=%u\n", pm.chunk_num);
@@ -5115,9 +5701,9 @@ cefnetd_incoming_object_process (
 			if (pm.org.version_f == 1 && pm.org.version_len == 0) {
 				fprintf(stderr,"> VerReq(resp)\n");
 			} else {
-				fprintf (stderr, "> %d, ver=%s(%d)\n", pm.org.version_f, pm.org.version_val, pm.org.version_len);
+				fprintf (stderr, "> %d, ver=%.*s(%d)\n", pm.org.version_f, (int) pm.org.version_len, pm.org.version_val, pm.org.version_len);
 			}
-			cef_pit_entry_print (hdl->pit);
+			cef_pit_entry_print (cefnetd_pit_shard_get (hdl, &pm));
 		}
 #endif //__T_VERSION__
 #endif
@@ -5186,17 +5772,18 @@ cefnetd_incoming_object_process (
 			faceids[face_num] = face->faceid;
 		}
 	} else {
-		stat_nopit_frames++;
+		CefC_Netd_Stat_Add (cefnetd_stat_local_get (hdl)->nopit_frames, 1);
 #ifdef CefC_Debug
 {		char uri[CefC_Max_Length];
 		cef_frame_conversion_name_to_uri (pm.name, pm.name_len, uri);
-		cef_dbg_write (CefC_Dbg_Finer, "NOPIT:stat_nopit_frames=%u, %s\n", stat_nopit_frames, uri);
+		cef_dbg_write (CefC_Dbg_Finer, "NOPIT:stat_nopit_frames=%llu, %s\n",
+			(unsigned long long) cefnetd_stat_local_get (hdl)->nopit_frames, uri);
 }
 #endif // CefC_Debug
 	}
 
 	// cefore-0.10.0
-	{	CefT_Pit_Entry* tmpe = cef_pit_entry_search_without_chunk (hdl->pit, &pm, &poh);
+	{	CefT_Pit_Entry* tmpe = cef_pit_entry_search_without_chunk (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh);
 		if ( tmpe ){
 			contents_hashv = tmpe->hashv;	/* Hash value of this contents */
 		} else {
@@ -5286,7 +5873,7 @@ cefnetd_incoming_object_process (
 #endif //__T_VERSION__
 #endif // CefC_Debug
 				if (cef_pit_entry_lock(pe))					// 2023/04/19 by iD
-					cef_pit_entry_free (hdl->pit, pe);
+					cef_pit_entry_free (cefnetd_pit_shard_get (hdl, &pm), pe);
 			}
 		}
 	}
@@ -5295,7 +5882,7 @@ cefnetd_incoming_object_process (
 #ifdef __T_VERSION__
 	if (cef_dbg_loglv_finest) {
 		fprintf (stderr, "*** after Forward the Content Object to cefnetd(s)\n");
-		cef_pit_entry_print (hdl->pit);
+		cef_pit_entry_print (cefnetd_pit_shard_get (hdl, &pm));
 	}
 #endif //__T_VERSION__
 #endif // CefC_Debug
@@ -5316,7 +5903,7 @@ cefnetd_incoming_intreturn_process (
 	char*	user_id
 ) {
 	//0.8.3
-	CefT_CcnMsg_MsgBdy pm = { 0 };
+	CefT_CcnMsg_MsgBdy pm;
 	CefT_CcnMsg_OptHdr poh = { 0 };
 	CefT_Pit_Entry* pe = NULL;
 	int loop_max = 2;						/* For App(0), Trans(1)						*/
@@ -5347,7 +5934,8 @@ cefnetd_incoming_intreturn_process (
 	}
 
 	/* Checks the Validation 			*/
-	res = cef_valid_msg_verify (msg, payload_len + header_len);
+	res = (cefnetd_msg_verified_f) ? 0 :
+			cef_valid_msg_verify (msg, payload_len + header_len);
 	if (res != 0) {
 		return (-1);
 	}
@@ -5377,7 +5965,7 @@ cefnetd_incoming_intreturn_process (
 			pe = cef_pit_entry_search (hdl->app_pit, &pm, &poh, NULL, 0);
 		} else {
 			if (pit_idx == 1) {
-				pe = cef_pit_entry_search (hdl->pit, &pm, &poh, NULL, 0);
+				pe = cef_pit_entry_search (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh, NULL, 0);
 			}
 		}
 		if (pe == NULL) {
@@ -5408,7 +5996,7 @@ cefnetd_incoming_intreturn_process (
 					payload_len, header_len, &pm, &poh, pe);
 
 				if (pe->stole_f) {
-					cef_pit_entry_free (hdl->pit, pe);
+					cef_pit_entry_free (cefnetd_pit_shard_get (hdl, &pm), pe);
 				}
 
 				if(pit_idx == 0) {
@@ -5439,7 +6027,7 @@ cefnetd_incoming_piggyback_process (
 	uint16_t msg_len, 						/* length of ccn message 					*/
 	uint16_t header_len						/* length of fixed and option header 		*/
 ) {
-	CefT_CcnMsg_MsgBdy pm = { 0 };
+	CefT_CcnMsg_MsgBdy pm;
 	CefT_CcnMsg_OptHdr poh = { 0 };
 	CefT_Pit_Entry* pe;
 	int res;
@@ -5490,7 +6078,7 @@ cefnetd_incoming_piggyback_process (
 		pm.name_len -= (CefC_S_Type + CefC_S_Length + CefC_S_ChunkNum);
 	}
 
-	pe = cef_pit_entry_search (hdl->pit, &pm, &poh, NULL, 0);
+	pe = cef_pit_entry_search (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh, NULL, 0);
 
 	if (pe) {
 		face = &(pe->dnfaces);
@@ -5528,7 +6116,7 @@ cefnetd_incoming_ccninforeq_process (
 	uint16_t header_len,					/* Header Length of this message			*/
 	char*	user_id
 ) {
-	CefT_CcnMsg_MsgBdy pm = { 0 };
+	CefT_CcnMsg_MsgBdy pm;
 	CefT_CcnMsg_OptHdr poh = { 0 };
 	int res;
 	int forward_req_f = 0;
@@ -5828,7 +6416,7 @@ cefnetd_incoming_ccninforeq_process (
 		}
 
 		/* Searches a FIB entry matching this request 	*/
-		fe = cef_fib_entry_search (hdl->fib, pm.name, name_len);
+		fe = cef_fib_entry_search_with_desc (hdl->fib, &pm, name_len);
 
 		/* Obtains Face-ID(s) to forward the request 	*/
 		if (fe) {
@@ -5841,7 +6429,7 @@ cefnetd_incoming_ccninforeq_process (
 			/* Create PIT for ccninfo ccninfo-03 */
 			memset( ccninfo_pit, 0x00, 1024 );
 			ccninfo_pit_len = cefnetd_ccninfo_pit_create( hdl, pci, ccninfo_pit, CCNINFO_REQ, 0 );
-			pe = cef_pit_entry_search (hdl->pit, &pm, &poh, ccninfo_pit, ccninfo_pit_len);
+			pe = cef_pit_entry_search (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh, ccninfo_pit, ccninfo_pit_len);
 			if ( pe != NULL ) {
 				/* Alredy passed request */
 				cef_frame_ccninfo_parsed_free (pci);
@@ -5849,7 +6437,7 @@ cefnetd_incoming_ccninforeq_process (
 			}
 
 			/* Updates the information of down face that this request arrived 	*/
-			pe = cef_pit_entry_lookup_and_down_face_update (hdl->pit, &pm, &poh, ccninfo_pit, ccninfo_pit_len,
+			pe = cef_pit_entry_lookup_and_down_face_update (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh, ccninfo_pit, ccninfo_pit_len,
 						faceid, msg, CefC_IntRetrans_Type_SUP, &pit_res);
 
 			if (pe == NULL) {
@@ -6404,7 +6992,7 @@ cefnetd_incoming_ccninforep_process (
 	char*	user_id
 ) {
 
-	CefT_CcnMsg_MsgBdy pm = { 0 };
+	CefT_CcnMsg_MsgBdy pm;
 	CefT_CcnMsg_OptHdr poh = { 0 };
 	CefT_Pit_Entry* pe;
 	int res, i;
@@ -6486,11 +7074,11 @@ cefnetd_incoming_ccninforep_process (
 	ccninfo_pit_len = cefnetd_ccninfo_pit_create( hdl, pci, ccninfo_pit, CCNINFO_REP, 1 );
 
 	/* Searches a PIT entry matching this replay 	*/
-	pe = cef_pit_entry_search (hdl->pit, &pm, &poh, ccninfo_pit, ccninfo_pit_len);
+	pe = cef_pit_entry_search (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh, ccninfo_pit, ccninfo_pit_len);
 	if ( pe == NULL ) {
 		memset( ccninfo_pit, 0x00, 1024 );
 		ccninfo_pit_len = cefnetd_ccninfo_pit_create( hdl, pci, ccninfo_pit, CCNINFO_REP, 0 );
-		pe = cef_pit_entry_search (hdl->pit, &pm, &poh, ccninfo_pit, ccninfo_pit_len);
+		pe = cef_pit_entry_search (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh, ccninfo_pit, ccninfo_pit_len);
 	}
 
 	if (pe) {
@@ -6517,7 +7105,7 @@ cefnetd_incoming_ccninforep_process (
 	}
 	/* Not full discovery */
 	if (pe->stole_f) {
-		cef_pit_entry_free (hdl->pit, pe);
+		cef_pit_entry_free (cefnetd_pit_shard_get (hdl, &pm), pe);
 	}
 	cef_frame_ccninfo_parsed_free (pci);
 
@@ -6555,7 +7143,7 @@ cefnetd_incoming_csmgr_object_process (
 	uint16_t header_len,					/* Header Length of this message			*/
 	char*	user_id
 ) {
-	CefT_CcnMsg_MsgBdy pm = { 0 };
+	CefT_CcnMsg_MsgBdy pm;
 	CefT_CcnMsg_OptHdr poh = { 0 };
 	CefT_Pit_Entry* pe;
 	int loop_max = 2;						/* For App(0), Trans(1)						*/
@@ -6629,16 +7217,7 @@ cefnetd_incoming_csmgr_object_process (
 	/*--------------------------------------------------------------------
 		Updates the statistics
 	----------------------------------------------------------------------*/
-	hdl->stat_recv_frames++;
-
-	stat_rcv_size_cnt++;
-	stat_rcv_size_sum += (payload_len + header_len);
-	if ((payload_len + header_len) < stat_rcv_size_min) {
-		stat_rcv_size_min = payload_len + header_len;
-	}
-	if ((payload_len + header_len) > stat_rcv_size_max) {
-		stat_rcv_size_max = payload_len + header_len;
-	}
+	cefnetd_stat_recv_frame_add (hdl, payload_len + header_len);
 
 	/*--------------------------------------------------------------------
 		Searches a PIT entry matching this Object
@@ -6652,7 +7231,7 @@ cefnetd_incoming_csmgr_object_process (
 				continue;
 
 		} else {
-			pe = cef_pit_entry_search_with_chunk (hdl->pit, &pm, &poh);	//0.8.3
+			pe = cef_pit_entry_search_with_chunk (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh);	//0.8.3
 			if ( pe != NULL ){
 				/*JK*///20210824 Cob without chunk number
 				if ( pm.chunk_num_f == 0 ) {	//Cob without chunk number
@@ -6762,7 +7341,7 @@ cefnetd_incoming_csmgr_object_process (
 				payload_len, header_len, &pm, &poh, pe);
 
 			if (pe->stole_f) {
-				cef_pit_entry_free (hdl->pit, pe);
+				cef_pit_entry_free (cefnetd_pit_shard_get (hdl, &pm), pe);
 			}
 
 			if(j == 0) {
@@ -6780,7 +7359,7 @@ cefnetd_incoming_csmgr_object_process (
 			if ( pm.chunk_num_f == 0 ) {	//Cob without chunk number
 				return (1);
 			}
-			pe = cef_pit_entry_search_without_chunk (hdl->pit, &pm, &poh);
+			pe = cef_pit_entry_search_without_chunk (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh);
 			if ( pe == NULL ) {
 				/* NOP */
 			} else {
@@ -7086,6 +7665,33 @@ cefnetd_config_read (
 			}
 			hdl->Selective_max_range = res;
 		}
+		else if (strcasecmp (pname, CefC_ParamName_FwdWorkerNum) == 0) {
+			res = atoi (ws);
+			if ((res < 1) || (res > CefC_Fwd_Worker_Max)) {
+				cef_log_write (CefC_Log_Error,
+					"FWD_WORKER_NUM must be higher than 0 and lower than 9.\n");
+				return (-1);
+			}
+			hdl->fwd_worker_num = res;
+		}
+		else if (strcasecmp (pname, CefC_ParamName_VerifyWorkerNum) == 0) {
+			res = atoi (ws);
+			if ((res < 0) || (res > CefC_Verify_Worker_Max)) {
+				cef_log_write (CefC_Log_Error,
+					"VERIFY_WORKER_NUM must be higher than or equal to 0 and lower than 9.\n");
+				return (-1);
+			}
+			hdl->verify_worker_num = res;
+		}
+		else if (strcasecmp (pname, CefC_ParamName_UdpBatchNum) == 0) {
+			res = atoi (ws);
+			if ((res < 1) || (res > CefC_Udp_Batch_Max)) {
+				cef_log_write (CefC_Log_Error,
+					"UDP_BATCH_NUM must be higher than 0 and lower than 65.\n");
+				return (-1);
+			}
+			hdl->udp_batch_num = res;
+		}
 
 		else if ( strcasecmp (pname, CefC_ParamName_InterestRetrans) == 0 ) {
 			if ( strcasecmp( ws, CefC_Default_InterestRetrans ) == 0 ) {
@@ -7244,6 +7850,18 @@ cefnetd_config_read (
 	}
 	fclose (fp);
 
+	if ((hdl->fwd_worker_num > 1) &&
+		(hdl->cs_mode != CefC_Cache_Type_None) &&
+		(hdl->cs_mode != CefC_Cache_Type_Localcache)) {
+		/* Only the local cache is shared among the workers. Logged as an 	*/
+		/* error since the warnings are hidden with the default log level 	*/
+		cef_log_write (CefC_Log_Error,
+			"FWD_WORKER_NUM=%d is ignored since CS_MODE=%d, so cefnetd forwards "
+			"all messages by itself (the workers need CS_MODE=0 or 1).\n",
+			hdl->fwd_worker_num, hdl->cs_mode);
+		hdl->fwd_worker_num = 1;
+	}
+
 	//202108
 	if ( hdl->IR_Option == 0 ) {
 		strcpy( hdl->bw_stat_pin_name, "None" );
@@ -7288,6 +7906,9 @@ cefnetd_config_read (
 																						   hdl->IR_enable[8],
 																						   hdl->IR_enable[9] );
 	cef_dbg_write (CefC_Dbg_Fine, "SELECTIVE_INTEREST_MAX_RANGE = %d\n", hdl->Selective_max_range);	//20220311
+	cef_dbg_write (CefC_Dbg_Fine, "FWD_WORKER_NUM = %d\n", hdl->fwd_worker_num);
+	cef_dbg_write (CefC_Dbg_Fine, "VERIFY_WORKER_NUM = %d\n", hdl->verify_worker_num);
+	cef_dbg_write (CefC_Dbg_Fine, "UDP_BATCH_NUM = %d\n", hdl->udp_batch_num);
 
 	cef_dbg_write (CefC_Dbg_Fine, "CCNINFO_ACCESS_POLICY = %d\n"
 								, hdl->ccninfo_access_policy);
@@ -7401,27 +8022,44 @@ cefnetd_incoming_command_process (
 	CefT_CcnMsg_MsgBdy* pm					/* Structure to set parsed CEFORE message	*/
 ) {
 
+	int hash;
+
+	hash = cefnetd_command_check (hdl, pm);
+	if (hash < 0) {
+		return (0);
+	}
+
+	/* Calls the function corresponding to the type of the command 	*/
+	(*cefnetd_command_process[hdl->cmd_filter[hash]])(hdl, faceid, peer_faceid, pm);
+
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Checks whether the name is a command or not
+----------------------------------------------------------------------------------------*/
+static int									/* index of the command filter, or -1 		*/
+cefnetd_command_check (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	CefT_CcnMsg_MsgBdy* pm					/* Structure to set parsed CEFORE message	*/
+) {
 	uint8_t hash = hdl->cefrt_seed;
 
 	CEFRTHASH8(pm->name, hash, pm->name_len);
 
 	if ((hdl->cmd_filter[hash] < CefC_Cmd_Link_Req) ||
 		(hdl->cmd_filter[hash] > CefC_Cmd_Link_Res)) {
-		return (0);
+		return (-1);
 	}
 
 	if (hdl->cmd_len[hash] != pm->name_len) {
-		return (0);
+		return (-1);
 	} else {
 		if (memcmp (&hdl->cmd[hash][0], pm->name, pm->name_len)) {
-			return (0);
+			return (-1);
 		}
 	}
 
-	/* Calls the function corresponding to the type of the command 	*/
-	(*cefnetd_command_process[hdl->cmd_filter[hash]])(hdl, faceid, peer_faceid, pm);
-
-	return (1);
+	return ((int) hash);
 }
 /*--------------------------------------------------------------------------------------
 	Handles the Invalid command
@@ -7571,99 +8209,76 @@ static void
 cefnetd_pit_cleanup (
 	CefT_Netd_Handle* hdl, 						/* cefnetd handle						*/
 	uint64_t nowt								/* current time (usec) 					*/
+) {
+	int i;
+
+	if (nowt > hdl->pit_clean_t) {
+		for (i = 0 ; i < hdl->fwd_worker_num ; i++) {
+			cefnetd_pit_shard_cleanup (hdl, hdl->pit_shards[i], nowt);
+		}
+		hdl->pit_clean_t = nowt + CefC_Pit_Wheel_Tick;
+	}
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Clean entries of the PIT shard
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_pit_shard_cleanup (
+	CefT_Netd_Handle* hdl, 						/* cefnetd handle						*/
+	CefT_Hash_Handle pit, 						/* PIT shard to clean 					*/
+	uint64_t nowt								/* current time (usec) 					*/
 ) {
 	CefT_Pit_Entry* pe;
 	CefT_Down_Faces* face;
 	int idx;
 	CefT_Rx_Elem_Sig_DelPit sig_delpit;
-	int clean_num = 0;
-	int rec_index = 0;
-	int end_index;
-	int end_flag = 0;
-	uint32_t elem_num, elem_index, eidx;
 
-	if (nowt > hdl->pit_clean_t) {
-		int pit_num = cef_lhash_tbl_item_num_get(hdl->pit);
-		end_index = hdl->pit_clean_i;
+	/* Only the entries which may have expired are visited 	*/
+	while ((pe = cef_pit_expired_entry_get (pit, nowt)) != NULL) {
 
+		if (!cef_pit_entry_lock (pe)) {
+			cef_pit_entry_expiry_update (pe);
+			continue;
+		}
 #ifdef	__PIT_CLEAN__
-	if (pit_num > 0) {
-		fprintf(stderr, "[%s] pit_num=%d\n", __func__, pit_num);
-	}
+fprintf( stderr, "[%s] cef_pit_clean(), pe=%p\n", __func__, (void*)pe );
 #endif
+		cef_pit_clean (pit, pe);
 
-		while (clean_num < pit_num) {
-			pe = (CefT_Pit_Entry*) cef_lhash_tbl_elem_get (hdl->pit, &(hdl->pit_clean_i), &elem_num);
+		/* Indicates that a PIT entry was deleted to Transport  	*/
+		if (hdl->plugin_hdl.tp[pe->tp_variant].pit) {
 
-			if (hdl->pit_clean_i == end_index) {
-				end_flag++;
-				if (end_flag > 1) {
-					break;
-				}
-			}
-			rec_index = hdl->pit_clean_i;
-			hdl->pit_clean_i++;
+			/* Records PIT entries ware deleted  	*/
+			face = &(pe->clean_dnfaces);
+			idx = 0;
 
-			if (pe == NULL) {
-				break;
+			while (face->next) {
+				face = face->next;
+				sig_delpit.faceids[idx] = face->faceid;
+				idx++;
 			}
-#ifdef	__PIT_CLEAN__
-	fprintf( stderr, "[%s] elem_get rec_index=%d, elm_num=%d\n", __func__, rec_index, elem_num);
-#endif
-
-			for (eidx = 0, elem_index = 0; elem_index < elem_num; elem_index++) {
-				pe = (CefT_Pit_Entry*)
-						cef_lhash_tbl_item_get_from_index (hdl->pit, rec_index, eidx);
-
-				if (!pe || !cef_pit_entry_lock(pe) ){
-					eidx++;
-					continue;
-				}
 
-				clean_num++;
-#ifdef	__PIT_CLEAN__
-fprintf( stderr, "[%s] cef_pit_clean(), elem_index=%d, eidx=%d\n", __func__, elem_index, eidx );
-#endif
-				cef_pit_clean (hdl->pit, pe);
-
-				/* Indicates that a PIT entry was deleted to Transport  	*/
-				if (hdl->plugin_hdl.tp[pe->tp_variant].pit) {
-
-					/* Records PIT entries ware deleted  	*/
-					face = &(pe->clean_dnfaces);
-					idx = 0;
-
-					while (face->next) {
-						face = face->next;
-						sig_delpit.faceids[idx] = face->faceid;
-						idx++;
-					}
-
-					if (idx > 0) {
+			if (idx > 0) {
 
-						sig_delpit.faceid_num = idx;
-						sig_delpit.hashv = pe->hashv;
+				sig_delpit.faceid_num = idx;
+				sig_delpit.hashv = pe->hashv;
 
-						(*(hdl->plugin_hdl.tp)[pe->tp_variant].pit)(
-							&(hdl->plugin_hdl.tp[pe->tp_variant]), &sig_delpit);
-					}
-				}
+				(*(hdl->plugin_hdl.tp)[pe->tp_variant].pit)(
+					&(hdl->plugin_hdl.tp[pe->tp_variant]), &sig_delpit);
+			}
+		}
 
-//				if (pe->dnfacenum < 1) {
-				if (pe->drp_lifetime_us < nowt) {	// 2023/04/05 by iD
+		if (pe->drp_lifetime_us < nowt) {	// 2023/04/05 by iD
 #ifdef	__PIT_CLEAN__
 fprintf( stderr, "[%s] cef_pit_entry_free()\n", __func__ );
 #endif
-
-					cef_pit_entry_free (hdl->pit, pe);
-
-				} else {
-					cef_pit_entry_unlock(pe);
-					eidx++;
-				}
-			}
+			cef_pit_entry_free (pit, pe);
+		} else {
+			cef_pit_entry_expiry_update (pe);
+			cef_pit_entry_unlock(pe);
 		}
-		hdl->pit_clean_t = nowt + CefC_Pit_CleaningTime;
 	}
 
 	return;
@@ -7916,7 +8531,7 @@ cefnetd_cefcache_object_process (
 	uint16_t hdr_len;
 	uint16_t payload_len;
 	uint16_t header_len;
-	CefT_CcnMsg_MsgBdy pm = { 0 };
+	CefT_CcnMsg_MsgBdy pm;
 	CefT_CcnMsg_OptHdr poh = { 0 };
 	CefT_Pit_Entry* pe;
 
@@ -7967,7 +8582,7 @@ cefnetd_cefcache_object_process (
 				continue;
 
 		} else {
-			pe = cef_pit_entry_search_with_chunk (hdl->pit, &pm, &poh);	//0.8.3
+			pe = cef_pit_entry_search_with_chunk (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh);	//0.8.3
 			if ( pe != NULL ){
 				/*JK*///20210824 Cob without chunk number
 				if ( pm.chunk_num_f == 0 ) {	//Cob without chunk number
@@ -8081,7 +8696,7 @@ printf( "%s KeyIdRest NG\n", __func__ );
 				payload_len, header_len, &pm, &poh, pe);
 
 			if (pe->stole_f) {
-				cef_pit_entry_free (hdl->pit, pe);
+				cef_pit_entry_free (cefnetd_pit_shard_get (hdl, &pm), pe);
 			}
 
 			if(j == 0) {
@@ -8101,7 +8716,7 @@ printf( "%s KeyIdRest NG\n", __func__ );
 			if ( pm.chunk_num_f == 0 ) {	//Cob without chunk number
 				return (1);
 			}
-			pe = cef_pit_entry_search_without_chunk (hdl->pit, &pm, &poh);
+			pe = cef_pit_entry_search_without_chunk (cefnetd_pit_shard_get (hdl, &pm), &pm, &poh);
 			if ( pe == NULL ) {
 				/* NOP */
 #ifdef	__SYMBOLIC__
@@ -8591,7 +9206,7 @@ SELECT_OK:;
 
 		/* Searches a PIT entry matching this Interest 	*/
 		/* Updates the information of down face that this Interest arrived 	*/
-		pe = cef_pit_entry_lookup_and_down_face_update (hdl->pit, pm, poh,  NULL, 0,
+		pe = cef_pit_entry_lookup_and_down_face_update (cefnetd_pit_shard_get (hdl, pm), pm, poh,  NULL, 0,
 					faceid, msg, hdl->InterestRetrans, &pit_res);
 		if (pe == NULL) {
 #ifdef	__SELECTIVE__
@@ -8685,15 +9300,16 @@ SKIP_INTEREST:;
 	/* Reset InterestType to the original type */
 	pm->InterestType = CefC_PIT_TYPE_Sel;
 	/* Count of Received Interest */
-	hdl->stat_recv_interest++;
+	CefC_Netd_Stat_Add (cefnetd_stat_local_get (hdl)->recv_interest, 1);
 	/* Count of Received Interest by type */
-	hdl->stat_recv_interest_types[pm->InterestType]++;
-	fe = cef_fib_entry_search (hdl->fib, pm->name, pm->name_len);
+	CefC_Netd_Stat_Add (
+		cefnetd_stat_local_get (hdl)->recv_interest_types[pm->InterestType], 1);
+	fe = cef_fib_entry_search_with_desc (hdl->fib, pm, pm->name_len);
 	if (fe) {
-		/* Count of Received Interest at FIB */
-		fe->rx_int++;
+		/* Count of Received Interest at FIB (shared by the workers) */
+		__atomic_fetch_add (&fe->rx_int, 1, __ATOMIC_RELAXED);
 		/* Count of Received Interest by type at FIB */
-		fe->rx_int_types[pm->InterestType]++;
+		__atomic_fetch_add (&fe->rx_int_types[pm->InterestType], 1, __ATOMIC_RELAXED);
 		fe = NULL;
 	}
 
@@ -8701,7 +9317,7 @@ SKIP_INTEREST:;
 	if ( pit_res_first != 0 ) {
 		if ( hdl->Selective_fwd == CefC_Selet_FWD_ON ) {
 			/* Searches a FIB entry matching this Interest 		*/
-			fe = cef_fib_entry_search (hdl->fib, pm->name, pm->name_len);
+			fe = cef_fib_entry_search_with_desc (hdl->fib, pm, pm->name_len);
 			/* Obtains Face-ID(s) to forward the Interest */
 			if (fe) {
 				face_num = cef_fib_forward_faceid_select (fe, peer_faceid, faceids);
@@ -9463,3 +10079,1071 @@ cef_pthread_create (
 	return rc;
 }
 
+/*--------------------------------------------------------------------------------------
+	Locks the tables shared with the forwarding workers (main thread only)
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_fwd_lock (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+) {
+	if (hdl->fwd_worker_num < 2) {
+		return;
+	}
+	if (hdl->fwd_lock_depth == 0) {
+		pthread_rwlock_wrlock (&hdl->fwd_rwlock);
+	}
+	hdl->fwd_lock_depth++;
+}
+/*--------------------------------------------------------------------------------------
+	Unlocks the tables shared with the forwarding workers (main thread only)
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_fwd_unlock (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+) {
+	int i;
+
+	if (hdl->fwd_worker_num < 2) {
+		return;
+	}
+	hdl->fwd_lock_depth--;
+	if (hdl->fwd_lock_depth == 0) {
+		/* The main thread may have changed any PIT shard, so the deadlines 	*/
+		/* are published again before the workers take the shards back 			*/
+		for (i = 0 ; i < hdl->fwd_worker_num ; i++) {
+			__atomic_store_n (&hdl->fwd_workers[i].pit_next,
+				cef_pit_wheel_next_get (hdl->pit_shards[i]), __ATOMIC_SEQ_CST);
+		}
+		pthread_rwlock_unlock (&hdl->fwd_rwlock);
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the index of the PIT shard from the name (without the chunk number)
+----------------------------------------------------------------------------------------*/
+static int									/* index of the PIT shard 					*/
+cefnetd_name_shard_index (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	const unsigned char* name,				/* Name (Value of T_NAME)					*/
+	uint16_t name_len						/* Length of the name						*/
+) {
+	struct tlv_hdr* thdr;
+	uint16_t sub_type;
+	uint16_t sub_length;
+	uint16_t index = 0;
+	uint32_t hashv;
+
+	/* The chunk number is excluded so that all the chunks of the content 	*/
+	/* and the Symbolic Interest for it are handled by the same worker 		*/
+	while (index + CefC_S_TLF <= name_len) {
+		thdr = (struct tlv_hdr*) &name[index];
+		sub_type 	= ntohs (thdr->type);
+		sub_length  = ntohs (thdr->length);
+
+		if ((sub_type == CefC_T_CHUNK) ||
+			(index + CefC_S_TLF + sub_length > name_len)) {
+			break;
+		}
+		index += CefC_S_TLF + sub_length;
+	}
+	hashv = cef_lhash_tbl_hashv_get (hdl->pit, name, index);
+
+	return ((int)(hashv % hdl->fwd_worker_num));
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the PIT shard which holds the specified name
+----------------------------------------------------------------------------------------*/
+static CefT_Hash_Handle						/* PIT shard 								*/
+cefnetd_pit_shard_get (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	CefT_CcnMsg_MsgBdy* pm					/* Structure to set parsed CEFORE message	*/
+) {
+	if (hdl->fwd_worker_num < 2) {
+		return (hdl->pit);
+	}
+	return (hdl->pit_shards[cefnetd_name_shard_index (hdl, pm->name, pm->name_len)]);
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the statistics counters of the calling thread
+----------------------------------------------------------------------------------------*/
+CefT_Netd_Stat*
+cefnetd_stat_local_get (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+) {
+	if (cefnetd_fwd_worker_stat) {
+		return (cefnetd_fwd_worker_stat);
+	}
+	return (&hdl->stat);
+}
+/*--------------------------------------------------------------------------------------
+	Adds the received ContentObject to the statistics of the calling thread
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_stat_recv_frame_add (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	uint64_t size							/* size of the received ContentObject 		*/
+) {
+	CefT_Netd_Stat* stat = cefnetd_stat_local_get (hdl);
+
+	CefC_Netd_Stat_Add (stat->recv_frames, 1);
+	CefC_Netd_Stat_Add (stat->rcv_size_cnt, 1);
+	CefC_Netd_Stat_Add (stat->rcv_size_sum, size);
+	if (size < stat->rcv_size_min) {
+		__atomic_store_n (&stat->rcv_size_min, size, __ATOMIC_RELAXED);
+	}
+	if (size > stat->rcv_size_max) {
+		__atomic_store_n (&stat->rcv_size_max, size, __ATOMIC_RELAXED);
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Adds the counters of one thread to the total
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_stat_accumulate (
+	CefT_Netd_Stat* sum,					/* the total of counters 					*/
+	CefT_Netd_Stat* stat					/* counters of one thread 					*/
+) {
+	uint64_t value;
+	int i;
+
+	sum->recv_frames 	+= CefC_Netd_Stat_Get (stat->recv_frames);
+	sum->send_frames 	+= CefC_Netd_Stat_Get (stat->send_frames);
+	sum->recv_interest 	+= CefC_Netd_Stat_Get (stat->recv_interest);
+	sum->send_interest 	+= CefC_Netd_Stat_Get (stat->send_interest);
+	for (i = 0 ; i < 3 ; i++) {
+		sum->recv_interest_types[i] += CefC_Netd_Stat_Get (stat->recv_interest_types[i]);
+		sum->send_interest_types[i] += CefC_Netd_Stat_Get (stat->send_interest_types[i]);
+	}
+	sum->nopit_frames 	+= CefC_Netd_Stat_Get (stat->nopit_frames);
+	sum->rcv_size_cnt 	+= CefC_Netd_Stat_Get (stat->rcv_size_cnt);
+	sum->rcv_size_sum 	+= CefC_Netd_Stat_Get (stat->rcv_size_sum);
+	value = CefC_Netd_Stat_Get (stat->rcv_size_min);
+	if (value < sum->rcv_size_min) {
+		sum->rcv_size_min = value;
+	}
+	value = CefC_Netd_Stat_Get (stat->rcv_size_max);
+	if (value > sum->rcv_size_max) {
+		sum->rcv_size_max = value;
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Sums the statistics counters of the main thread and the forwarding workers
+----------------------------------------------------------------------------------------*/
+void
+cefnetd_stat_sum (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	CefT_Netd_Stat* sum						/* the total of counters 					*/
+) {
+	int i;
+
+	memset (sum, 0, sizeof (CefT_Netd_Stat));
+	sum->rcv_size_min = 65536;
+	cefnetd_stat_accumulate (sum, &hdl->stat);
+	if (hdl->fwd_worker_num > 1) {
+		for (i = 0 ; i < hdl->fwd_worker_num ; i++) {
+			cefnetd_stat_accumulate (sum, &hdl->fwd_workers[i].stat);
+		}
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Creates the forwarding workers
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+cefnetd_fwd_workers_init (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+) {
+	CefT_Fwd_Worker* wk;
+	pthread_attr_t tattr;
+	int i;
+
+	if (hdl->fwd_worker_num < 2) {
+		return (0);
+	}
+
+	hdl->fwd_defer_que = cef_rngque_create (CefC_Fwd_Worker_Que_Size);
+	hdl->fwd_defer_que_mp = cef_mpool_init ("CefFwdDefer",
+		sizeof (CefT_Fwd_Worker_Elem), CefC_Fwd_Worker_Batch);
+	if ((hdl->fwd_defer_que == NULL) || (hdl->fwd_defer_que_mp == 0)) {
+		return (-1);
+	}
+	hdl->fwd_running_f = 1;
+
+	for (i = 0 ; i < hdl->fwd_worker_num ; i++) {
+		wk = &hdl->fwd_workers[i];
+		wk->index = i;
+		wk->hdl = (void*) hdl;
+		memset (&wk->stat, 0, sizeof (CefT_Netd_Stat));
+		wk->stat.rcv_size_min = 65536;
+		wk->pit_next = UINT64_MAX;
+		/* Only the main thread pushes to the worker 	*/
+		wk->rx_que = cef_rngque_create_spsc (CefC_Fwd_Worker_Que_Size);
+		wk->rx_que_mp = cef_mpool_init ("CefFwdWorker",
+			sizeof (CefT_Fwd_Worker_Elem), CefC_Fwd_Worker_Batch);
+		if ((wk->rx_que == NULL) || (wk->rx_que_mp == 0)) {
+			return (-1);
+		}
+		pthread_mutex_init (&wk->mutex, NULL);
+		pthread_cond_init (&wk->cond, NULL);
+
+		if (cef_pthread_create (&wk->th, &tattr, &cefnetd_fwd_worker_thread, wk) != 0) {
+			cef_log_write (CefC_Log_Error,
+				"%s Failed to create the new thread(cefnetd_fwd_worker_thread)\n", __func__);
+			wk->rx_que = NULL;
+			return (-1);
+		}
+	}
+	cef_log_write (CefC_Log_Info,
+		"Forwarding workers ... %d threads\n", hdl->fwd_worker_num);
+
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Stops the forwarding workers
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_fwd_workers_destroy (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+) {
+	CefT_Fwd_Worker* wk;
+	void* elem;
+	int i;
+
+	if (hdl->fwd_running_f == 0) {
+		return;
+	}
+	__atomic_store_n (&hdl->fwd_running_f, 0, __ATOMIC_RELEASE);
+
+	for (i = 0 ; i < hdl->fwd_worker_num ; i++) {
+		wk = &hdl->fwd_workers[i];
+		if (wk->rx_que == NULL) {
+			continue;
+		}
+		pthread_mutex_lock (&wk->mutex);
+		pthread_cond_signal (&wk->cond);
+		pthread_mutex_unlock (&wk->mutex);
+		pthread_join (wk->th, NULL);
+
+		while ((elem = cef_rngque_pop (wk->rx_que)) != NULL) {
+			cef_mpool_free (wk->rx_que_mp, elem);
+		}
+		cef_rngque_destroy (wk->rx_que);
+		cef_mpool_destroy (wk->rx_que_mp);
+		pthread_mutex_destroy (&wk->mutex);
+		pthread_cond_destroy (&wk->cond);
+		wk->rx_que = NULL;
+	}
+
+	while ((elem = cef_rngque_pop (hdl->fwd_defer_que)) != NULL) {
+		cef_mpool_free (hdl->fwd_defer_que_mp, elem);
+	}
+	cef_rngque_destroy (hdl->fwd_defer_que);
+	cef_mpool_destroy (hdl->fwd_defer_que_mp);
+	hdl->fwd_defer_que = NULL;
+}
+/*--------------------------------------------------------------------------------------
+	Main loop of the forwarding worker
+----------------------------------------------------------------------------------------*/
+static void*
+cefnetd_fwd_worker_thread (
+	void* arg								/* CefT_Fwd_Worker							*/
+) {
+	CefT_Fwd_Worker* wk = (CefT_Fwd_Worker*) arg;
+	CefT_Netd_Handle* hdl = (CefT_Netd_Handle*) wk->hdl;
+	CefT_Fwd_Worker_Elem* elems[CefC_Fwd_Worker_Batch];
+	struct timespec ts;
+	uint64_t next;
+	int num;
+	int i;
+
+	cefnetd_fwd_worker_f = 1;
+	cefnetd_fwd_worker_stat = &wk->stat;
+
+	while (__atomic_load_n (&hdl->fwd_running_f, __ATOMIC_ACQUIRE)) {
+		num = cef_rngque_pop_bulk (wk->rx_que, (void**) elems, CefC_Fwd_Worker_Batch);
+
+		if (num == 0) {
+			/* The main thread signals the condition after it pushed 		*/
+			pthread_mutex_lock (&wk->mutex);
+			num = cef_rngque_pop_bulk (
+					wk->rx_que, (void**) elems, CefC_Fwd_Worker_Batch);
+			if ((num == 0) && (__atomic_load_n (&hdl->fwd_running_f, __ATOMIC_ACQUIRE))) {
+				clock_gettime (CLOCK_REALTIME, &ts);
+				ts.tv_nsec += CefC_Fwd_Worker_Wait * 1000;
+				if (ts.tv_nsec >= 1000000000) {
+					ts.tv_sec++;
+					ts.tv_nsec -= 1000000000;
+				}
+				pthread_cond_timedwait (&wk->cond, &wk->mutex, &ts);
+			}
+			pthread_mutex_unlock (&wk->mutex);
+
+			if (num == 0) {
+				continue;
+			}
+		}
+
+		/* Handles the messages in a batch while holding the read lock 	*/
+		pthread_rwlock_rdlock (&hdl->fwd_rwlock);
+		for (i = 0 ; i < num ; i++) {
+			cefnetd_msg_verified_f = elems[i]->verified_f;
+			(*cefnetd_incoming_msg_process[elems[i]->msg[1]])
+				(hdl, elems[i]->faceid, elems[i]->peer_faceid,
+					elems[i]->msg, elems[i]->payload_len,
+					elems[i]->header_len, elems[i]->user_id);
+			cefnetd_msg_verified_f = 0;
+			cef_mpool_free (wk->rx_que_mp, elems[i]);
+		}
+		/* Publishes the deadline of the shard in the same way as 			*/
+		/* cefnetd_event_timer_arm, since the main loop does not read it 	*/
+		next = cef_pit_wheel_next_get (hdl->pit_shards[wk->index]);
+		__atomic_store_n (&wk->pit_next, next, __ATOMIC_SEQ_CST);
+		if ((next != UINT64_MAX) && (next <= hdl->pit_clean_t)) {
+			next = hdl->pit_clean_t + 1;
+		}
+		pthread_rwlock_unlock (&hdl->fwd_rwlock);
+
+		/* The main loop is woken only if it has messages to handle or 	*/
+		/* the timer has to be armed earlier 							*/
+		if ((next < __atomic_load_n (&hdl->tick_next, __ATOMIC_SEQ_CST)) ||
+			(cef_rngque_read (hdl->fwd_defer_que) != NULL) ||
+			(cef_rngque_read (hdl->plugin_hdl.tx_que) != NULL)) {
+			cefnetd_event_wake (hdl);
+		}
+	}
+
+	pthread_exit (NULL);
+	return ((void*) NULL);
+}
+/*--------------------------------------------------------------------------------------
+	Hands over the received message to the forwarding worker
+----------------------------------------------------------------------------------------*/
+static int									/* Returns 1 if the worker took it over 	*/
+cefnetd_fwd_worker_push (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	int faceid, 							/* Face-ID where messages arrived at		*/
+	int peer_faceid, 						/* Face-ID to reply to the origin of 		*/
+											/* transmission of the message(s)			*/
+	unsigned char* msg, 					/* received message to handle				*/
+	uint16_t payload_len, 					/* Payload Length of this message			*/
+	uint16_t header_len,					/* Header Length of this message			*/
+	char*	user_id
+) {
+	CefT_Fwd_Worker* wk;
+	CefT_Fwd_Worker_Elem* elem;
+	struct tlv_hdr* thdr;
+	uint16_t index;
+	uint16_t length;
+
+	if (hdl->fwd_worker_num < 2) {
+		return (0);
+	}
+
+	/* Only Interests and Content Objects from the network are handed over 	*/
+	if (((msg[1] != CefC_PT_INTEREST) && (msg[1] != CefC_PT_OBJECT)) ||
+		(cef_face_is_local_face (peer_faceid)) ||
+		(payload_len + header_len > CefC_Max_Msg_Size) ||
+		(payload_len < CefC_S_TLF * 2)) {
+		return (0);
+	}
+
+	/* Selects the worker from the Name which follows the message type TLV 	*/
+	index = header_len + CefC_S_TLF;
+	thdr = (struct tlv_hdr*) &msg[index];
+	if (ntohs (thdr->type) != CefC_T_NAME) {
+		return (0);
+	}
+	length = ntohs (thdr->length);
+	index += CefC_S_TLF;
+	if (index + length > header_len + payload_len) {
+		return (0);
+	}
+	wk = &hdl->fwd_workers[cefnetd_name_shard_index (hdl, &msg[index], length)];
+
+	elem = (CefT_Fwd_Worker_Elem*) cef_mpool_alloc (wk->rx_que_mp);
+	if (elem == NULL) {
+		return (0);
+	}
+	elem->faceid 		= faceid;
+	elem->peer_faceid 	= peer_faceid;
+	elem->payload_len 	= payload_len;
+	elem->header_len 	= header_len;
+	elem->verified_f 	= cefnetd_msg_verified_f;
+	strcpy (elem->user_id, user_id);
+	memcpy (elem->msg, msg, payload_len + header_len);
+
+	if (cef_rngque_push (wk->rx_que, elem) < 1) {
+		/* The queue is full, so the main thread handles it by itself 	*/
+		cef_mpool_free (wk->rx_que_mp, elem);
+		return (0);
+	}
+	pthread_mutex_lock (&wk->mutex);
+	pthread_cond_signal (&wk->cond);
+	pthread_mutex_unlock (&wk->mutex);
+
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Hands back the message which updates the shared tables to the main thread
+----------------------------------------------------------------------------------------*/
+static int									/* No care now								*/
+cefnetd_fwd_defer (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	int faceid, 							/* Face-ID where messages arrived at		*/
+	int peer_faceid, 						/* Face-ID to reply to the origin of 		*/
+											/* transmission of the message(s)			*/
+	unsigned char* msg, 					/* received message to handle				*/
+	uint16_t payload_len, 					/* Payload Length of this message			*/
+	uint16_t header_len,					/* Header Length of this message			*/
+	char*	user_id
+) {
+	CefT_Fwd_Worker_Elem* elem;
+
+	elem = (CefT_Fwd_Worker_Elem*) cef_mpool_alloc (hdl->fwd_defer_que_mp);
+	if (elem == NULL) {
+		return (-1);
+	}
+	elem->faceid 		= faceid;
+	elem->peer_faceid 	= peer_faceid;
+	elem->payload_len 	= payload_len;
+	elem->header_len 	= header_len;
+	elem->verified_f 	= cefnetd_msg_verified_f;
+	strcpy (elem->user_id, user_id);
+	memcpy (elem->msg, msg, payload_len + header_len);
+
+	if (cef_rngque_push (hdl->fwd_defer_que, elem) < 1) {
+		cef_mpool_free (hdl->fwd_defer_que_mp, elem);
+		return (-1);
+	}
+
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Handles the messages handed back by the forwarding workers
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_fwd_deferred_process (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+) {
+	CefT_Fwd_Worker_Elem* elem;
+
+	if (hdl->fwd_worker_num < 2) {
+		return;
+	}
+
+	while ((elem = (CefT_Fwd_Worker_Elem*) cef_rngque_pop (hdl->fwd_defer_que)) != NULL) {
+		cefnetd_msg_verified_f = elem->verified_f;
+		(*cefnetd_incoming_msg_process[elem->msg[1]])
+			(hdl, elem->faceid, elem->peer_faceid,
+				elem->msg, elem->payload_len, elem->header_len, elem->user_id);
+		cefnetd_msg_verified_f = 0;
+		cef_mpool_free (hdl->fwd_defer_que_mp, elem);
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Creates the verification workers
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+cefnetd_verify_workers_init (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+) {
+	CefT_Verify_Worker* wk;
+	pthread_attr_t tattr;
+	int i;
+
+	if (hdl->verify_worker_num < 1) {
+		return (0);
+	}
+
+	hdl->verify_done_que =
+		cef_rngque_create (CefC_Verify_Que_Size * CefC_Verify_Worker_Max);
+	hdl->verify_que_mp = cef_mpool_init ("CefVerifyWorker",
+		sizeof (CefT_Fwd_Worker_Elem), CefC_Fwd_Worker_Batch);
+	if ((hdl->verify_done_que == NULL) || (hdl->verify_que_mp == 0)) {
+		return (-1);
+	}
+	hdl->verify_running_f = 1;
+
+	for (i = 0 ; i < hdl->verify_worker_num ; i++) {
+		wk = &hdl->verify_workers[i];
+		wk->index = i;
+		wk->hdl = (void*) hdl;
+		/* Only the main thread pushes to the worker 	*/
+		wk->rx_que = cef_rngque_create_spsc (CefC_Verify_Que_Size);
+		if (wk->rx_que == NULL) {
+			return (-1);
+		}
+		pthread_mutex_init (&wk->mutex, NULL);
+		pthread_cond_init (&wk->cond, NULL);
+
+		if (cef_pthread_create (&wk->th, &tattr, &cefnetd_verify_worker_thread, wk) != 0) {
+			cef_log_write (CefC_Log_Error,
+				"%s Failed to create the new thread(cefnetd_verify_worker_thread)\n",
+				__func__);
+			cef_rngque_destroy (wk->rx_que);
+			wk->rx_que = NULL;
+			return (-1);
+		}
+	}
+	cef_log_write (CefC_Log_Info,
+		"Verification workers ... %d threads\n", hdl->verify_worker_num);
+
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Stops the verification workers
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_verify_workers_destroy (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+) {
+	CefT_Verify_Worker* wk;
+	void* elem;
+	int i;
+
+	if (hdl->verify_running_f == 0) {
+		return;
+	}
+	__atomic_store_n (&hdl->verify_running_f, 0, __ATOMIC_RELEASE);
+
+	for (i = 0 ; i < hdl->verify_worker_num ; i++) {
+		wk = &hdl->verify_workers[i];
+		if (wk->rx_que == NULL) {
+			continue;
+		}
+		pthread_mutex_lock (&wk->mutex);
+		pthread_cond_signal (&wk->cond);
+		pthread_mutex_unlock (&wk->mutex);
+		pthread_join (wk->th, NULL);
+
+		while ((elem = cef_rngque_pop (wk->rx_que)) != NULL) {
+			cef_mpool_free (hdl->verify_que_mp, elem);
+		}
+		cef_rngque_destroy (wk->rx_que);
+		pthread_mutex_destroy (&wk->mutex);
+		pthread_cond_destroy (&wk->cond);
+		wk->rx_que = NULL;
+	}
+
+	while ((elem = cef_rngque_pop (hdl->verify_done_que)) != NULL) {
+		cef_mpool_free (hdl->verify_que_mp, elem);
+	}
+	cef_rngque_destroy (hdl->verify_done_que);
+	cef_mpool_destroy (hdl->verify_que_mp);
+	hdl->verify_done_que = NULL;
+}
+/*--------------------------------------------------------------------------------------
+	Main loop of the verification worker
+----------------------------------------------------------------------------------------*/
+static void*
+cefnetd_verify_worker_thread (
+	void* arg								/* CefT_Verify_Worker						*/
+) {
+	CefT_Verify_Worker* wk = (CefT_Verify_Worker*) arg;
+	CefT_Netd_Handle* hdl = (CefT_Netd_Handle*) wk->hdl;
+	CefT_Fwd_Worker_Elem* elems[CefC_Fwd_Worker_Batch];
+	struct timespec ts;
+	int num;
+	int i;
+
+	while (__atomic_load_n (&hdl->verify_running_f, __ATOMIC_ACQUIRE)) {
+		num = cef_rngque_pop_bulk (wk->rx_que, (void**) elems, CefC_Fwd_Worker_Batch);
+
+		if (num == 0) {
+			/* The main thread signals the condition after it pushed 		*/
+			pthread_mutex_lock (&wk->mutex);
+			num = cef_rngque_pop_bulk (
+					wk->rx_que, (void**) elems, CefC_Fwd_Worker_Batch);
+			if ((num == 0) && (__atomic_load_n (&hdl->verify_running_f, __ATOMIC_ACQUIRE))) {
+				clock_gettime (CLOCK_REALTIME, &ts);
+				ts.tv_nsec += CefC_Fwd_Worker_Wait * 1000;
+				if (ts.tv_nsec >= 1000000000) {
+					ts.tv_sec++;
+					ts.tv_nsec -= 1000000000;
+				}
+				pthread_cond_timedwait (&wk->cond, &wk->mutex, &ts);
+			}
+			pthread_mutex_unlock (&wk->mutex);
+
+			if (num == 0) {
+				continue;
+			}
+		}
+
+		/* The tables of cefnetd are not touched here, so no lock is taken 	*/
+		for (i = 0 ; i < num ; i++) {
+			elems[i]->verified_f = (cef_valid_msg_verify (elems[i]->msg,
+				elems[i]->payload_len + elems[i]->header_len) == 0) ? 1 : 0;
+		}
+
+		/* The main thread takes them out after it is woken up 	*/
+		i = 0;
+		while (i < num) {
+			i += cef_rngque_push_bulk (hdl->verify_done_que, (void**) &elems[i], num - i);
+			cefnetd_event_wake (hdl);
+			if ((i < num) && (__atomic_load_n (&hdl->verify_running_f, __ATOMIC_ACQUIRE) == 0)) {
+				/* The main thread has stopped, so they are released here 	*/
+				for ( ; i < num ; i++) {
+					cef_mpool_free (hdl->verify_que_mp, elems[i]);
+				}
+				break;
+			}
+			if (i < num) {
+				sched_yield ();
+			}
+		}
+	}
+
+	pthread_exit (NULL);
+	return ((void*) NULL);
+}
+/*--------------------------------------------------------------------------------------
+	Hands over the signed message to the verification worker
+----------------------------------------------------------------------------------------*/
+static int									/* Returns 1 if the worker took it over 	*/
+cefnetd_verify_worker_push (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	int faceid, 							/* Face-ID where messages arrived at		*/
+	int peer_faceid, 						/* Face-ID to reply to the origin of 		*/
+											/* transmission of the message(s)			*/
+	unsigned char* msg, 					/* received message to handle				*/
+	uint16_t payload_len, 					/* Payload Length of this message			*/
+	uint16_t header_len,					/* Header Length of this message			*/
+	char*	user_id
+) {
+	CefT_Verify_Worker* wk;
+	CefT_Fwd_Worker_Elem* elem;
+
+	if (hdl->verify_worker_num < 1) {
+		return (0);
+	}
+
+	/* Only the messages signed with RSA-SHA256 are handed over, the CRC32 	*/
+	/* is checked inline														*/
+	if (((msg[1] != CefC_PT_INTEREST) && (msg[1] != CefC_PT_OBJECT) &&
+		 (msg[1] != CefC_PT_INTRETURN)) ||
+		(payload_len + header_len > CefC_Max_Msg_Size) ||
+		(cef_valid_msg_alg_get (msg, payload_len + header_len) != CefC_T_RSA_SHA256)) {
+		return (0);
+	}
+
+	wk = &hdl->verify_workers[hdl->verify_next];
+	hdl->verify_next = (hdl->verify_next + 1) % hdl->verify_worker_num;
+
+	elem = (CefT_Fwd_Worker_Elem*) cef_mpool_alloc (hdl->verify_que_mp);
+	if (elem == NULL) {
+		return (0);
+	}
+	elem->faceid 		= faceid;
+	elem->peer_faceid 	= peer_faceid;
+	elem->payload_len 	= payload_len;
+	elem->header_len 	= header_len;
+	elem->verified_f 	= 0;
+	strcpy (elem->user_id, user_id);
+	memcpy (elem->msg, msg, payload_len + header_len);
+
+	if (cef_rngque_push (wk->rx_que, elem) < 1) {
+		/* The queue is full, so the main thread handles it by itself 	*/
+		cef_mpool_free (hdl->verify_que_mp, elem);
+		return (0);
+	}
+	pthread_mutex_lock (&wk->mutex);
+	pthread_cond_signal (&wk->cond);
+	pthread_mutex_unlock (&wk->mutex);
+
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Handles the messages verified by the verification workers
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_verify_done_process (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+) {
+	CefT_Fwd_Worker_Elem* elem;
+
+	if (hdl->verify_worker_num < 1) {
+		return;
+	}
+
+	while ((elem = (CefT_Fwd_Worker_Elem*) cef_rngque_pop (hdl->verify_done_que)) != NULL) {
+		/* The messages which failed the verification are discarded 	*/
+		if (elem->verified_f) {
+			cefnetd_msg_verified_f = 1;
+			if (cefnetd_fwd_worker_push (hdl, elem->faceid, elem->peer_faceid,
+					elem->msg, elem->payload_len, elem->header_len, elem->user_id) < 1) {
+				(*cefnetd_incoming_msg_process[elem->msg[1]])
+					(hdl, elem->faceid, elem->peer_faceid,
+						elem->msg, elem->payload_len, elem->header_len, elem->user_id);
+			}
+			cefnetd_msg_verified_f = 0;
+		}
+		cef_mpool_free (hdl->verify_que_mp, elem);
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Prepares the batched UDP input/output
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+cefnetd_udp_batch_init (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+#ifndef CefC_MACOS
+	CefT_Udp_Batch* bt;
+	int i;
+
+	if (hdl->udp_batch_num > 1) {
+		bt = (CefT_Udp_Batch*) calloc (1, sizeof (CefT_Udp_Batch));
+		if (bt == NULL) {
+			return (-1);
+		}
+		bt->buff = (unsigned char*) malloc ((size_t) hdl->udp_batch_num * CefC_Max_Length);
+		if (bt->buff == NULL) {
+			free (bt);
+			return (-1);
+		}
+		for (i = 0 ; i < hdl->udp_batch_num ; i++) {
+			bt->iovs[i].iov_base = &bt->buff[(size_t) i * CefC_Max_Length];
+			bt->iovs[i].iov_len  = CefC_Max_Length;
+			bt->msgs[i].msg_hdr.msg_name 	= &bt->addrs[i];
+			bt->msgs[i].msg_hdr.msg_iov 	= &bt->iovs[i];
+			bt->msgs[i].msg_hdr.msg_iovlen 	= 1;
+		}
+		hdl->udp_batch = bt;
+	}
+#else // CefC_MACOS
+	hdl->udp_batch_num = 1;
+#endif // CefC_MACOS
+
+	return (cef_face_udp_batch_init (hdl->udp_batch_num));
+}
+/*--------------------------------------------------------------------------------------
+	Releases the buffers of the batched UDP input/output
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_udp_batch_destroy (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	if (hdl->udp_batch) {
+		free (hdl->udp_batch->buff);
+		free (hdl->udp_batch);
+		hdl->udp_batch = NULL;
+	}
+	cef_face_udp_batch_init (1);
+}
+/*--------------------------------------------------------------------------------------
+	Wakes up the main loop waiting in epoll_wait (called by the workers)
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_wake (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	uint64_t val = 1;
+
+	if (hdl->wake_fd == -1) {
+		return;
+	}
+	/* The eventfd is written only once until the main loop reads it 	*/
+	if (__atomic_exchange_n (&hdl->wake_f, 1, __ATOMIC_SEQ_CST) == 0) {
+		if (write (hdl->wake_fd, &val, sizeof (val)) < 0) {
+			/* NOP */;
+		}
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Closes the epoll instance, the timerfd and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_epoll_destroy (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	if (hdl->epfd != -1) {
+		cef_face_event_fd_set (-1);
+		close (hdl->epfd);
+		hdl->epfd = -1;
+	}
+	if (hdl->tick_fd != -1) {
+		close (hdl->tick_fd);
+		hdl->tick_fd = -1;
+	}
+	if (hdl->wake_fd != -1) {
+		close (hdl->wake_fd);
+		hdl->wake_fd = -1;
+	}
+}
+#ifndef CefC_MACOS
+/*--------------------------------------------------------------------------------------
+	Creates the epoll instance, the timerfd and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+cefnetd_event_epoll_init (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	struct epoll_event ev;
+	int i;
+
+	hdl->epfd = epoll_create1 (EPOLL_CLOEXEC);
+	if (hdl->epfd < 0) {
+		hdl->epfd = -1;
+		return (-1);
+	}
+	hdl->tick_fd = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (hdl->tick_fd < 0) {
+		hdl->tick_fd = -1;
+		cefnetd_event_epoll_destroy (hdl);
+		return (-1);
+	}
+
+	hdl->wake_fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (hdl->wake_fd < 0) {
+		hdl->wake_fd = -1;
+		cefnetd_event_epoll_destroy (hdl);
+		return (-1);
+	}
+
+	/* The timerfd is armed for the next deadline of the housekeeping (PIT/FIB 	*/
+	/* cleanup, excache push) by cefnetd_event_timer_arm 						*/
+	hdl->tick_next = 0;
+	memset (&ev, 0, sizeof (ev));
+	ev.events 	= EPOLLIN;
+	ev.data.u64 = CefC_Face_Event_Data (
+					hdl->tick_fd, CefC_Netd_Event_Ctrl | CefC_Netd_Event_Tick);
+	if (epoll_ctl (hdl->epfd, EPOLL_CTL_ADD, hdl->tick_fd, &ev) < 0) {
+		cefnetd_event_epoll_destroy (hdl);
+		return (-1);
+	}
+
+	/* The workers write the eventfd when they have left work to the main loop 	*/
+	hdl->wake_f = 0;
+	ev.data.u64 = CefC_Face_Event_Data (
+					hdl->wake_fd, CefC_Netd_Event_Ctrl | CefC_Netd_Event_Wake);
+	if (epoll_ctl (hdl->epfd, EPOLL_CTL_ADD, hdl->wake_fd, &ev) < 0) {
+		cefnetd_event_epoll_destroy (hdl);
+		return (-1);
+	}
+	for (i = 0 ; i < CefC_Netd_Event_Ctrl_Num ; i++) {
+		hdl->ev_ctrl_fds[i] = -1;
+	}
+
+	/* The sockets of Faces are registered when the Faces are created 	*/
+	cef_face_event_fd_set (hdl->epfd);
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Arms the timerfd for the next deadline of the housekeeping
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_timer_arm (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	struct itimerspec its;
+	uint64_t next;
+	uint64_t t;
+	int i;
+
+	next = hdl->fib_clean_t + 1;
+
+	/* The timer is not armed for the PIT shards which have no entries. The 	*/
+	/* shards owned by the workers are read from their published deadlines 		*/
+	for (i = 0 ; i < hdl->fwd_worker_num ; i++) {
+		if (hdl->fwd_worker_num < 2) {
+			t = cef_pit_wheel_next_get (hdl->pit_shards[i]);
+		} else {
+			t = __atomic_load_n (&hdl->fwd_workers[i].pit_next, __ATOMIC_SEQ_CST);
+		}
+		if (t == UINT64_MAX) {
+			continue;
+		}
+		if (t <= hdl->pit_clean_t) {
+			t = hdl->pit_clean_t + 1;
+		}
+		if (t < next) {
+			next = t;
+		}
+	}
+#ifdef CefC_ContentStore
+	if ((hdl->cs_stat->cache_type == CefC_Cache_Type_Excache) &&
+		(ccninfo_push_time + 1 < next)) {
+		next = ccninfo_push_time + 1;
+	}
+#endif // CefC_ContentStore
+#ifdef CefC_Ccore
+	if ((hdl->rt_hdl) && (hdl->rt_hdl->sock == -1) &&
+		(hdl->rt_hdl->reconnect_time + 1 < next)) {
+		next = hdl->rt_hdl->reconnect_time + 1;
+	}
+#endif // CefC_Ccore
+
+	if (next == hdl->tick_next) {
+		return;
+	}
+	/* The workers read it to decide whether the main loop is woken 	*/
+	__atomic_store_n (&hdl->tick_next, next, __ATOMIC_SEQ_CST);
+
+	/* The present time is not monotonic, so the timer is relative 	*/
+	t = (next > hdl->nowtus) ? next - hdl->nowtus : 1;
+	memset (&its, 0, sizeof (its));
+	its.it_value.tv_sec  = t / 1000000;
+	its.it_value.tv_nsec = (t % 1000000) * 1000;
+	if (timerfd_settime (hdl->tick_fd, 0, &its, NULL) < 0) {
+		cef_log_write (CefC_Log_Warn,
+			"Failed to arm the timer (%s)\n", strerror (errno));
+		__atomic_store_n (&hdl->tick_next, 0, __ATOMIC_SEQ_CST);
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Registers the sockets connected to csmgrd and ccored which have changed
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_ctrl_update (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	int fds[CefC_Netd_Event_Ctrl_Num] = { -1, -1, -1 };
+	CefC_Connection_Type types[CefC_Netd_Event_Ctrl_Num] = {
+		CefC_Connection_Type_Csm, CefC_Connection_Type_Csm, CefC_Connection_Type_Ccr };
+	struct epoll_event ev;
+	int i;
+
+#ifdef CefC_ContentStore
+	fds[0] = hdl->cs_stat->local_sock;
+	fds[1] = hdl->cs_stat->tcp_sock;
+#endif // CefC_ContentStore
+#ifdef CefC_Ccore
+	if (hdl->rt_hdl) {
+		fds[2] = hdl->rt_hdl->sock;
+	}
+#endif // CefC_Ccore
+
+	for (i = 0 ; i < CefC_Netd_Event_Ctrl_Num ; i++) {
+		if (fds[i] == hdl->ev_ctrl_fds[i]) {
+			continue;
+		}
+		if (hdl->ev_ctrl_fds[i] != -1) {
+			/* Fails if the socket has been closed, which is fine 	*/
+			epoll_ctl (hdl->epfd, EPOLL_CTL_DEL, hdl->ev_ctrl_fds[i], NULL);
+		}
+		hdl->ev_ctrl_fds[i] = fds[i];
+		if (fds[i] == -1) {
+			continue;
+		}
+		memset (&ev, 0, sizeof (ev));
+		ev.events 	= EPOLLIN;
+		ev.data.u64 = CefC_Face_Event_Data (fds[i], CefC_Netd_Event_Ctrl | types[i]);
+		if (epoll_ctl (hdl->epfd, EPOLL_CTL_ADD, fds[i], &ev) < 0) {
+			cef_log_write (CefC_Log_Warn,
+				"Failed to watch the FD#%d (%s)\n", fds[i], strerror (errno));
+			hdl->ev_ctrl_fds[i] = -1;
+		}
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the type of the Face from the epoll event data
+----------------------------------------------------------------------------------------*/
+static int									/* CefC_Connection_Type, or -1 if the Face 	*/
+											/* has been closed after the event 			*/
+cefnetd_event_face_type_get (
+	int fd, 									/* FD in the event data 				*/
+	int faceid									/* Face-ID in the event data 			*/
+) {
+	CefT_Face* face;
+
+	if (cef_face_get_fd_from_faceid ((uint16_t) faceid) != fd) {
+		return (-1);
+	}
+	/* Listen sockets and local faces are handled on the main thread 	*/
+	if ((faceid == CefC_Faceid_Local) ||
+		(faceid == CefC_Faceid_ListenTcpv4) ||
+		(faceid == CefC_Faceid_ListenTcpv6) ||
+		(faceid == CefC_Faceid_ListenBabel)) {
+		return (CefC_Connection_Type_Local);
+	}
+	face = cef_face_get_face_from_faceid ((uint16_t) faceid);
+	if (face->local_f) {
+		return (CefC_Connection_Type_Local);
+	}
+	if (face->protocol == CefC_Face_Type_Udp) {
+		return (CefC_Connection_Type_Udp);
+	}
+	if (face->protocol == CefC_Face_Type_Tcp) {
+		return (CefC_Connection_Type_Tcp);
+	}
+	return (CefC_Connection_Type_Local);
+}
+/*--------------------------------------------------------------------------------------
+	Main loop with epoll
+----------------------------------------------------------------------------------------*/
+static void
+cefnetd_event_epoll_dispatch (
+	CefT_Netd_Handle* hdl						/* cefnetd handle						*/
+) {
+	struct epoll_event evs[CefC_Netd_Event_Max];
+	uint64_t expired;
+	int res;
+	int i;
+	int fd;
+	int id;
+	int type;
+
+	cef_log_write (CefC_Log_Info, "Uses epoll for the main loop\n");
+
+	while (cefnetd_running_f) {
+
+		/* Calculates the present time 						*/
+		hdl->nowtus = cef_client_present_timeus_calc ();
+
+		/* The workers are stopped only when the housekeeping is due 	*/
+		if (hdl->nowtus >= hdl->tick_next) {
+			cefnetd_fwd_lock (hdl);
+			cefnetd_event_housekeeping (hdl);
+			cefnetd_fwd_unlock (hdl);
+		}
+		cefnetd_event_ctrl_update (hdl);
+		cefnetd_event_timer_arm (hdl);
+
+		/* Waits for the sockets, the workers or the next deadline 	*/
+		res = epoll_wait (hdl->epfd, evs, CefC_Netd_Event_Max, -1);
+
+		for (i = 0 ; i < res ; i++) {
+			fd = CefC_Face_Event_Fd (evs[i].data.u64);
+			id = CefC_Face_Event_Faceid (evs[i].data.u64);
+
+			if (id & CefC_Netd_Event_Ctrl) {
+				type = id & ~CefC_Netd_Event_Ctrl;
+				id 	 = 0;
+				if (type == CefC_Netd_Event_Tick) {
+					if (read (fd, &expired, sizeof (expired)) < 0) {
+						/* NOP */;
+					}
+					__atomic_store_n (&hdl->tick_next, 0, __ATOMIC_SEQ_CST);
+					continue;
+				}
+				if (type == CefC_Netd_Event_Wake) {
+					/* Cleared first so that a later push writes the eventfd again 	*/
+					__atomic_store_n (&hdl->wake_f, 0, __ATOMIC_SEQ_CST);
+					if (read (fd, &expired, sizeof (expired)) < 0) {
+						/* NOP */;
+					}
+					continue;
+				}
+			} else {
+				type = cefnetd_event_face_type_get (fd, id);
+				if (type < 0) {
+					continue;
+				}
+				/* The listen sockets and the local faces are handled as they 	*/
+				/* become ready instead of in every round 						*/
+				if (type == CefC_Connection_Type_Local) {
+					cefnetd_fwd_lock (hdl);
+					cefnetd_input_from_local_event (hdl, fd, id);
+					cefnetd_fwd_unlock (hdl);
+					continue;
+				}
+			}
+			cefnetd_event_input (hdl, fd, (CefC_Connection_Type) type, id,
+				(evs[i].events & EPOLLIN) ? 1 : 0,
+				(evs[i].events & (EPOLLERR | EPOLLHUP)) ? 1 : 0);
+		}
+
+		cefnetd_event_post_process (hdl);
+	}
+}
+#endif // CefC_MACOS
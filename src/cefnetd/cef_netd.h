@@ -43,6 +43,7 @@
 #include <signal.h>
 #include <poll.h>
 #include <limits.h>
+#include <pthread.h>
 #include <openssl/md5.h>
 #include <dlfcn.h>
 
@@ -122,6 +123,19 @@
 
 #define CefC_Listen_Face_Max		CefC_Face_Router_Max
 
+/* Forwarding workers */
+#define CefC_Fwd_Worker_Max			8			/* Maximum number of workers 			*/
+#define CefC_Fwd_Worker_Que_Size	256			/* Rx queue size of each worker 		*/
+#define CefC_Fwd_Worker_Batch		32			/* Messages handled per read lock 		*/
+#define CefC_Fwd_Worker_Wait		1000		/* Idle wait of the worker (us) 		*/
+#define CefC_Verify_Worker_Max		8			/* Maximum number of verifiers 			*/
+#define CefC_Verify_Que_Size		256			/* Queue size of each verifier 			*/
+#define CefC_Udp_Batch_Max			64			/* Maximum of UDP_BATCH_NUM 			*/
+
+/* Event loop (epoll) */
+#define CefC_Netd_Event_Max			256			/* Events returned by one epoll_wait 	*/
+#define CefC_Netd_Event_Ctrl_Num	3			/* csmgrd (local/tcp) and ccored socket */
+
 /* cefstatus output option */
 #define CefC_Ctrl_StatusOpt_Stat	0x0001
 #define CefC_Ctrl_StatusOpt_Metric	0x0002
@@ -172,6 +186,74 @@ typedef struct {
 
 } CefT_Nbrs;
 
+/********** Statistics 			***********/
+typedef struct {
+
+	uint64_t 			recv_frames;			/* Count of Received ContentObject 		*/
+	uint64_t 			send_frames;			/* Count of Send ContentObject 			*/
+	uint64_t			recv_interest;			/* Count of Received Interest 			*/
+	uint64_t			recv_interest_types[3];	/* Count of Received Interest by type 	*/
+												/* 0:Regular, 1:Symbolic, 2:Selective 	*/
+	uint64_t			send_interest;			/* Count of Send Interest 				*/
+	uint64_t			send_interest_types[3];	/* Count of Send Interest by type 		*/
+												/* 0:Regular, 1:Symbolic, 2:Selective 	*/
+	uint64_t 			nopit_frames;			/* ContentObjects without PIT entry 	*/
+	uint64_t 			rcv_size_cnt;			/* Size of received ContentObjects 		*/
+	uint64_t 			rcv_size_sum;
+	uint64_t 			rcv_size_min;
+	uint64_t 			rcv_size_max;
+
+} CefT_Netd_Stat;
+
+/* Each CefT_Netd_Stat is written only by the thread which owns it (the main 	*/
+/* thread or one forwarding worker), so a relaxed load and store is enough 		*/
+/* for the status thread to read the counters without a data race 				*/
+#define CefC_Netd_Stat_Add(var, n) \
+	__atomic_store_n (&(var), __atomic_load_n (&(var), __ATOMIC_RELAXED) + (n), \
+		__ATOMIC_RELAXED)
+#define CefC_Netd_Stat_Get(var) \
+	__atomic_load_n (&(var), __ATOMIC_RELAXED)
+
+/********** Forwarding Workers 	***********/
+typedef struct {
+
+	int 				faceid;					/* Face-ID that message arrived 		*/
+	int 				peer_faceid;			/* Face-ID to reply to the origin 		*/
+	uint16_t 			payload_len;			/* Payload length of the message 		*/
+	uint16_t 			header_len;				/* Header length of the message 		*/
+	char 				user_id[512];			/* Peer address string 					*/
+	int 				verified_f;				/* 1 if the signature has been verified */
+	unsigned char 		msg[CefC_Max_Msg_Size];	/* Received message 					*/
+
+} CefT_Fwd_Worker_Elem;
+
+typedef struct {
+
+	int 				index;					/* Index of the worker (= PIT shard) 	*/
+	pthread_t 			th;
+	CefT_Rngque* 		rx_que;					/* Messages steered to this worker 		*/
+	CefT_Mp_Handle 		rx_que_mp;				/* Memory Pool for CefT_Fwd_Worker_Elem */
+	pthread_mutex_t 	mutex;
+	pthread_cond_t 		cond;
+	void* 				hdl;					/* cefnetd handle 						*/
+	CefT_Netd_Stat 		stat;					/* Counters of this worker 				*/
+	uint64_t 			pit_next;				/* Next deadline of the PIT shard, 		*/
+												/* published for the main loop 			*/
+
+} CefT_Fwd_Worker;
+
+/********** Verification Workers 	***********/
+typedef struct {
+
+	int 				index;					/* Index of the worker 					*/
+	pthread_t 			th;
+	CefT_Rngque* 		rx_que;					/* Messages to verify 					*/
+	pthread_mutex_t 	mutex;
+	pthread_cond_t 		cond;
+	void* 				hdl;					/* cefnetd handle 						*/
+
+} CefT_Verify_Worker;
+
 /********** cefned main handle  	***********/
 typedef struct {
 
@@ -299,19 +381,47 @@ typedef struct {
 
 	/********** Timers				***********/
 	uint64_t			pit_clean_t;
-	uint32_t 			pit_clean_i;
 	uint64_t			fib_clean_t;
 	uint32_t 			fib_clean_i;
 
+	/********** Forwarding Workers	***********/
+	int 				fwd_worker_num;			/* Number of workers (1: not used) 		*/
+	CefT_Hash_Handle	pit_shards[CefC_Fwd_Worker_Max];
+												/* PIT shards (pit_shards[0] == pit) 	*/
+	CefT_Fwd_Worker 	fwd_workers[CefC_Fwd_Worker_Max];
+	pthread_rwlock_t 	fwd_rwlock;				/* Workers hold it for read, the main 	*/
+												/* thread for write 					*/
+	int 				fwd_lock_depth;			/* Write lock depth of the main thread 	*/
+	int 				fwd_running_f;
+	CefT_Rngque* 		fwd_defer_que;			/* Messages handed back to the main 	*/
+	CefT_Mp_Handle 		fwd_defer_que_mp;		/* thread by the workers 				*/
+
+	/********** Verification Workers	***********/
+	int 				verify_worker_num;		/* Number of workers (0: not used) 		*/
+	CefT_Verify_Worker 	verify_workers[CefC_Verify_Worker_Max];
+	int 				verify_next;			/* Worker which takes the next message 	*/
+	int 				verify_running_f;
+	CefT_Mp_Handle 		verify_que_mp;			/* Memory Pool for CefT_Fwd_Worker_Elem */
+	CefT_Rngque* 		verify_done_que;		/* Verified messages handed back to the */
+												/* main thread 							*/
+
+	/********** UDP Batch I/O	***********/
+	int 				udp_batch_num;			/* Messages per system call (1: off) 	*/
+	struct CefT_Udp_Batch* udp_batch;			/* Buffers for recvmmsg 				*/
+
+	/********** Event Loop		***********/
+	int 				epfd;					/* epoll instance (-1: poll is used) 	*/
+	int 				tick_fd;				/* timerfd driving the housekeeping 	*/
+	uint64_t			tick_next;				/* time the timerfd is armed for 		*/
+	int 				wake_fd;				/* eventfd the workers wake the main 	*/
+												/* loop with 							*/
+	int 				wake_f;					/* 1 if wake_fd has been written 		*/
+	int 				ev_ctrl_fds[CefC_Netd_Event_Ctrl_Num];
+												/* csmgrd/ccored sockets in epfd 		*/
+
 	/********** Statistics 			***********/
-	uint64_t 			stat_recv_frames;				/* Count of Received ContentObject */
-	uint64_t 			stat_send_frames;				/* Count of Send ContentObject	*/
-	uint64_t			stat_recv_interest;				/* Count of Received Interest	*/
-	uint64_t			stat_recv_interest_types[3];	/* Count of Received Interest by type */
-														/* 0:Regular, 1:Symbolic, 2:Selective */
-	uint64_t			stat_send_interest;				/* Count of Send Interest		*/
-	uint64_t			stat_send_interest_types[3];	/* Count of Send Interest by type */
-														/* 0:Regular, 1:Symbolic, 2:Selective */
+	CefT_Netd_Stat 		stat;					/* Counters of the main thread. Use 	*/
+												/* cefnetd_stat_sum to read the total 	*/
 
 	/********** Content Store		***********/
 	CefT_Cs_Stat*		cs_stat;				/* Status of Content Store				*/
@@ -543,4 +653,19 @@ void *
 cefnetd_cefstatus_thread (
 	void *p
 );
+/*--------------------------------------------------------------------------------------
+	Obtains the statistics counters of the calling thread
+----------------------------------------------------------------------------------------*/
+CefT_Netd_Stat*
+cefnetd_stat_local_get (
+	CefT_Netd_Handle* hdl					/* cefnetd handle							*/
+);
+/*--------------------------------------------------------------------------------------
+	Sums the statistics counters of the main thread and the forwarding workers
+----------------------------------------------------------------------------------------*/
+void
+cefnetd_stat_sum (
+	CefT_Netd_Handle* hdl,					/* cefnetd handle							*/
+	CefT_Netd_Stat* sum						/* the total of counters 					*/
+);
 #endif // __CEF_NETD_HEADER__
@@ -117,8 +117,8 @@ cefnetd_interest_forward (
 		fwdstr.poh             = poh;
 		fwdstr.pe              = pe;
 		fwdstr.fe              = fe;
-		fwdstr.cnt_send_frames = &(hdl->stat_send_interest);
-		fwdstr.cnt_send_types  = hdl->stat_send_interest_types;
+		fwdstr.cnt_send_frames = &(cefnetd_stat_local_get (hdl)->send_interest);
+		fwdstr.cnt_send_types  = cefnetd_stat_local_get (hdl)->send_interest_types;
 
 		/* Forwards the Interest according to Forwarding Strategy. */
 		hdl->fwd_strtgy_hdl->fwd_int(&fwdstr);
@@ -271,7 +271,7 @@ cefnetd_object_forward (
 		fwdstr.pm              = pm;
 		fwdstr.poh             = poh;
 		fwdstr.pe              = pe;
-		fwdstr.cnt_send_frames = &(hdl->stat_send_frames);
+		fwdstr.cnt_send_frames = &(cefnetd_stat_local_get (hdl)->send_frames);
 
 		/* Searches a FIB entry matching the Interest requested this ContentObject */
 		if (pm->chunk_num_f) {
@@ -281,7 +281,7 @@ cefnetd_object_forward (
 			name_len = pm->name_len;
 		}
 
-		fwdstr.fe = cef_fib_entry_search (hdl->fib, pm->name, name_len);
+		fwdstr.fe = cef_fib_entry_search_with_desc (hdl->fib, pm, name_len);
 
 		/* Forwards the ContentObject according to Forwarding Strategy. */
 		hdl->fwd_strtgy_hdl->fwd_cob(&fwdstr);
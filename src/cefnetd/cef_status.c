@@ -123,6 +123,13 @@ static int
 cef_status_add_output_to_rsp_buf(
 	char* buff
 );
+/*--------------------------------------------------------------------------------------
+	Output Memory Pool status
+----------------------------------------------------------------------------------------*/
+static int
+cef_status_mpool_output (
+	void
+);
 #if ((defined CefC_CefnetdCache) && (defined CefC_Develop))
 /*--------------------------------------------------------------------------------------
 	Output LocalCache status
@@ -151,10 +158,15 @@ cef_status_stats_output (
 	char cache_type[32] = {0};
 	char work_str[CefC_Max_Length];
 	int  fret = 0;
+	int  i;
+	CefT_Netd_Stat stat;
 	(*rspp)[0] = 0;
 	rsp_bufp = (char*) *rspp;
 	rsp_buf_size = CefC_Max_Length*10;
 
+	/* Forwarding workers have their own counters 	*/
+	cefnetd_stat_sum (hdl, &stat);
+
 	switch (hdl->node_type) {
 		case CefC_Node_Type_Receiver: {
 			sprintf (node_type, "Receiver");
@@ -211,16 +223,16 @@ cef_status_stats_output (
 			"FWD Strategy     : %s\n",
 			CefC_Version,
 			hdl->port_num,
-			(unsigned long long)hdl->stat_recv_interest,
-			(unsigned long long)hdl->stat_recv_interest_types[0],
-			(unsigned long long)hdl->stat_recv_interest_types[1],
-			(unsigned long long)hdl->stat_recv_interest_types[2],
-			(unsigned long long)hdl->stat_send_interest,
-			(unsigned long long)hdl->stat_send_interest_types[0],
-			(unsigned long long)hdl->stat_send_interest_types[1],
-			(unsigned long long)hdl->stat_send_interest_types[2],
-			(unsigned long long)hdl->stat_recv_frames,
-			(unsigned long long)hdl->stat_send_frames,
+			(unsigned long long)stat.recv_interest,
+			(unsigned long long)stat.recv_interest_types[0],
+			(unsigned long long)stat.recv_interest_types[1],
+			(unsigned long long)stat.recv_interest_types[2],
+			(unsigned long long)stat.send_interest,
+			(unsigned long long)stat.send_interest_types[0],
+			(unsigned long long)stat.send_interest_types[1],
+			(unsigned long long)stat.send_interest_types[2],
+			(unsigned long long)stat.recv_frames,
+			(unsigned long long)stat.send_frames,
 			cache_type,
 			hdl->forwarding_strategy);
 #ifdef CefC_INTEREST_RETURN
@@ -278,12 +290,29 @@ cef_status_stats_output (
 	if ((fret=cef_status_pit_output (&hdl->app_pit, output_opt_f, numofpit)) != 0){
 		goto endfunc;
 	}
-	sprintf (work_str, "PIT :");
-	if ((fret=cef_status_add_output_to_rsp_buf(work_str)) != 0){
-		goto endfunc;
+	for (i = 0 ; i < hdl->fwd_worker_num ; i++) {
+		if (hdl->fwd_worker_num > 1) {
+			sprintf (work_str, "PIT[%d] :", i);
+		} else {
+			sprintf (work_str, "PIT :");
+		}
+		if ((fret=cef_status_add_output_to_rsp_buf(work_str)) != 0){
+			goto endfunc;
+		}
+		if ((fret=cef_status_pit_output (&hdl->pit_shards[i], output_opt_f, numofpit)) != 0){
+			goto endfunc;
+		}
 	}
-	if ((fret=cef_status_pit_output (&hdl->pit, output_opt_f, numofpit)) != 0){
-		goto endfunc;
+
+	/* output Memory Pools	*/
+	if (output_opt_f & CefC_Ctrl_StatusOpt_Stat) {
+		sprintf (work_str, "Memory Pools :");
+		if ((fret=cef_status_add_output_to_rsp_buf(work_str)) != 0){
+			goto endfunc;
+		}
+		if ((fret=cef_status_mpool_output ()) != 0){
+			goto endfunc;
+		}
 	}
 
 #if ((defined CefC_CefnetdCache) && (defined CefC_Develop))
@@ -527,20 +556,20 @@ cef_status_forward_output (
 			if (output_opt_f & CefC_Ctrl_StatusOpt_Stat) {
 				face_info_index +=
 					sprintf (face_info + face_info_index, "                     TxInt=%llu (RGL[%llu], SYM[%llu], SEL[%llu])\n"
-						, (unsigned long long)faces->tx_int
-						, (unsigned long long)faces->tx_int_types[CefC_PIT_TYPE_Rgl]
-						, (unsigned long long)faces->tx_int_types[CefC_PIT_TYPE_Sym]
-						, (unsigned long long)faces->tx_int_types[CefC_PIT_TYPE_Sel]);
+						, (unsigned long long)CefC_Netd_Stat_Get (faces->tx_int)
+						, (unsigned long long)CefC_Netd_Stat_Get (faces->tx_int_types[CefC_PIT_TYPE_Rgl])
+						, (unsigned long long)CefC_Netd_Stat_Get (faces->tx_int_types[CefC_PIT_TYPE_Sym])
+						, (unsigned long long)CefC_Netd_Stat_Get (faces->tx_int_types[CefC_PIT_TYPE_Sel]));
 			}
 			faces = faces->next;
 		}
 		if (output_opt_f & CefC_Ctrl_StatusOpt_Stat) {
 			face_info_index +=
 				sprintf (face_info + face_info_index, "    RxInt : %llu (RGL[%llu], SYM[%llu], SEL[%llu])\n"
-					, (unsigned long long)entry->rx_int
-					, (unsigned long long)entry->rx_int_types[CefC_PIT_TYPE_Rgl]
-					, (unsigned long long)entry->rx_int_types[CefC_PIT_TYPE_Sym]
-					, (unsigned long long)entry->rx_int_types[CefC_PIT_TYPE_Sel]);
+					, (unsigned long long)CefC_Netd_Stat_Get (entry->rx_int)
+					, (unsigned long long)CefC_Netd_Stat_Get (entry->rx_int_types[CefC_PIT_TYPE_Rgl])
+					, (unsigned long long)CefC_Netd_Stat_Get (entry->rx_int_types[CefC_PIT_TYPE_Sym])
+					, (unsigned long long)CefC_Netd_Stat_Get (entry->rx_int_types[CefC_PIT_TYPE_Sel]));
 		}
 		sprintf (work_str, "%s", face_info);
 		if ((fret=cef_status_add_output_to_rsp_buf(work_str)) != 0){
@@ -829,13 +858,17 @@ cef_status_stats_output_pit (
 		return (1);
 	}
 
-	for (int pit_cnt = 0; pit_cnt < 2; pit_cnt++) {
+	for (int pit_cnt = 0; pit_cnt <= hdl->fwd_worker_num; pit_cnt++) {
 		if (pit_cnt == 0) {
 			handle = &hdl->app_pit;
 			fprintf (fp, "PIT(App) :");
 		} else {
-			handle = &hdl->pit;
-			fprintf (fp, "PIT :");
+			handle = &hdl->pit_shards[pit_cnt - 1];
+			if (hdl->fwd_worker_num > 1) {
+				fprintf (fp, "PIT[%d] :", pit_cnt - 1);
+			} else {
+				fprintf (fp, "PIT :");
+			}
 		}
 
 		/* get table num		*/
@@ -935,6 +968,40 @@ cef_status_stats_output_pit (
 	fclose (fp);
 	return (1);
 }
+/*--------------------------------------------------------------------------------------
+	Output Memory Pool status
+----------------------------------------------------------------------------------------*/
+static int
+cef_status_mpool_output (
+	void
+) {
+	CefT_Mp_Stat stats[CefC_Mp_Pool_Max];
+	char work_str[CefC_Max_Length];
+	int num;
+	int i;
+
+	num = cef_mpool_stat_get (stats, CefC_Mp_Pool_Max);
+	if (num == 0) {
+		sprintf (work_str, "\n  Entry is empty\n");
+		return (cef_status_add_output_to_rsp_buf (work_str));
+	}
+	sprintf (work_str, " %d\n", num);
+	if (cef_status_add_output_to_rsp_buf (work_str) != 0) {
+		return (-1);
+	}
+
+	for (i = 0 ; i < num ; i++) {
+		sprintf (work_str,
+			"  %-16s : size=%zu, blocks=%zu, used=%zu, free=%zu, peak=%zu\n",
+			stats[i].key, stats[i].size, stats[i].block_num, stats[i].used_num,
+			stats[i].block_num - stats[i].used_num, stats[i].peak_num);
+		if (cef_status_add_output_to_rsp_buf (work_str) != 0) {
+			return (-1);
+		}
+	}
+
+	return (0);
+}
 /*--------------------------------------------------------------------------------------
 	Add output to response buffer
 ----------------------------------------------------------------------------------------*/
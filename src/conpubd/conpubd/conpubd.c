@@ -57,6 +57,11 @@
 #include <openssl/sha.h>
 #include <sys/wait.h>
 #include <sys/statvfs.h>
+#ifndef CefC_MACOS
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif // CefC_MACOS
 
 #include <conpubd.h>
 #include <conpubd/conpubd_plugin.h>
@@ -67,6 +72,7 @@
 #include <cefore/cef_log.h>
 #include <cefore/cef_define.h>
 #include <cefore/cef_valid.h>
+#include <cefore/cef_publish.h>
 
 /****************************************************************************************
  Macros
@@ -82,6 +88,18 @@
 #define CefC_Cpub_InconsistentVersion			-1000
 #define CefC_Pthread_StackSize					(8*1024*1024)	/* Ubuntu-default:8MB */
 
+/* Index field of the epoll event data of the sockets which are not peers 	*/
+#define ConpubdC_Event_Local_Listen		ConpubdC_Max_Sock_Num			/* local listen	*/
+#define ConpubdC_Event_Tcp_Listen		(ConpubdC_Max_Sock_Num + 1)		/* TCP listen	*/
+#define ConpubdC_Event_Tick				(ConpubdC_Max_Sock_Num + 2)		/* timerfd		*/
+#define ConpubdC_Event_Wake				(ConpubdC_Max_Sock_Num + 3)		/* eventfd		*/
+#define ConpubdC_Event_Max				(ConpubdC_Max_Sock_Num + 4)		/* Events 		*/
+																		/* returned by	*/
+																		/* epoll_wait	*/
+#define ConpubdC_Event_Data(fd, idx)	(((uint64_t)(fd) << 32) | (uint32_t)(idx))
+#define ConpubdC_Event_Fd(data)			((int)((data) >> 32))
+#define ConpubdC_Event_Index(data)		((int)((data) & 0xFFFFFFFF))
+
 
 /****************************************************************************************
  Structures Declaration
@@ -129,6 +147,11 @@ static CsmgrT_Stat_Handle 	stat_hdl = CsmgrC_Invalid;	/* CS stat handle			*/
 static int					conpubd_cntent_load_stat = 0;
 														/* content load stat			*/
 static int 					conpubd_running_f 	= 1;
+static int 					conpubd_epfd 		= -1;	/* epoll instance of the main loop	*/
+static int 					conpubd_tick_fd 	= -1;	/* timerfd to reconnect to cefnetd	*/
+static int 					conpubd_wake_fd 	= -1;	/* eventfd the signal handler writes*/
+static int 					conpubd_ev_fds[ConpubdC_Max_Sock_Num];
+														/* sockets of the peers watched		*/
 static char 				conpub_conf_dir[PATH_MAX] = {"/usr/local/cefore"};
 static char 				conpub_contdef_dir[PATH_MAX] = {"/usr/local/cefore"};
 static char 				root_user_name[CefC_Csmgr_User_Len] = {"root"};
@@ -245,6 +268,61 @@ static void
 conpubd_event_dispatch (
 	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
 );
+/*--------------------------------------------------------------------------------------
+	Main loop with poll
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_event_poll_dispatch (
+	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
+);
+/*--------------------------------------------------------------------------------------
+	Reads the socket of the peer which is ready or has an error
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_peer_input_process (
+	CefT_Conpubd_Handle* hdl,					/* conpub daemon handle					*/
+	int fd,										/* socket of the peer					*/
+	int peer_idx,								/* index of the peer					*/
+	int in_f,									/* 1 if the socket is readable			*/
+	int err_f									/* 1 if an error occurs on the socket	*/
+);
+/*--------------------------------------------------------------------------------------
+	Closes the epoll instance, the timerfd and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_event_epoll_destroy (
+	void
+);
+#ifndef CefC_MACOS
+/*--------------------------------------------------------------------------------------
+	Creates the epoll instance, the timerfd and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+conpubd_event_epoll_init (
+	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
+);
+/*--------------------------------------------------------------------------------------
+	Registers the sockets of the peers which have changed
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_event_peer_update (
+	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
+);
+/*--------------------------------------------------------------------------------------
+	Arms the timerfd to reconnect to cefnetd
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_event_timer_arm (
+	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
+);
+/*--------------------------------------------------------------------------------------
+	Main loop with epoll
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_event_epoll_dispatch (
+	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
+);
+#endif // CefC_MACOS
 /*--------------------------------------------------------------------------------------
 	Prepares the Control sockets to be polled
 ----------------------------------------------------------------------------------------*/
@@ -801,6 +879,7 @@ conpubd_handle_create (
 	hdl->cache_default_rct = conf_param.cache_default_rct;
 	hdl->valid_type = (uint16_t)cef_valid_type_get (conf_param.Valid_Alg);
 	hdl->block_size = conf_param.block_size;
+	hdl->publish_workers = conf_param.publish_workers;
 
 	/********** Published info.  ***********/
 	hdl->published_contents_num = 0;
@@ -907,12 +986,6 @@ static void
 conpubd_event_dispatch (
 	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
 ) {
-	struct pollfd fds[ConpubdC_Max_Sock_Num];
-	int fdnum;
-	int fds_index[ConpubdC_Max_Sock_Num];
-	int len;
-	int res;
-	int i;
 	pthread_t		conpubd_expire_check_th;
 	void*			status;
 
@@ -926,6 +999,41 @@ conpubd_event_dispatch (
 	/* Main loop */
 	cef_client_init (0, "");
 
+#ifndef CefC_MACOS
+	if (conpubd_event_epoll_init (hdl) == 0) {
+		conpubd_event_epoll_dispatch (hdl);
+	} else {
+		cef_log_write (CefC_Log_Warn,
+			"Failed to prepare epoll (%s), so poll is used\n", strerror (errno));
+		conpubd_event_poll_dispatch (hdl);
+	}
+#else // CefC_MACOS
+	conpubd_event_poll_dispatch (hdl);
+#endif // CefC_MACOS
+	conpubd_event_epoll_destroy ();
+
+	pthread_join (conpubd_expire_check_th, &status);
+
+	/* post process */
+	conpubd_post_process (hdl);
+	cef_log_write (CefC_Log_Info, "Stop\n");
+
+	return;
+}
+
+/*--------------------------------------------------------------------------------------
+	Main loop with poll
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_event_poll_dispatch (
+	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
+) {
+	struct pollfd fds[ConpubdC_Max_Sock_Num];
+	int fdnum;
+	int fds_index[ConpubdC_Max_Sock_Num];
+	int res;
+	int i;
+
 	while (conpubd_running_f) {
 
 		/* connect to cefnetd */
@@ -950,181 +1058,404 @@ conpubd_event_dispatch (
 			continue;
 		}
 		/* Checks whether frame(s) arrivals from the active local faces */
-		for (i = 0 ; res > 0 && i < ConpubdC_Max_Sock_Num - 1 ; i++) {
-			if (fds[i].revents & (POLLERR | POLLNVAL | POLLHUP)) {
-				/* Error occurs, so close this socket 	*/
+		for (i = 0 ; res > 0 && i < fdnum ; i++) {
+			if (fds[i].revents == 0) {
+				continue;
+			}
+			res--;
 #ifdef CefC_Debug
-				if (fds[i].revents & POLLERR) {
-					cef_dbg_write (CefC_Dbg_Fine, "poll events POLLERR\n");
-				} else if (fds[i].revents & POLLNVAL) {
-					cef_dbg_write (CefC_Dbg_Fine, "poll events POLLNVAL\n");
-				} else {
-					cef_dbg_write (CefC_Dbg_Fine, "poll events POLLHUP\n");
-				}
+			if (fds[i].revents & POLLERR) {
+				cef_dbg_write (CefC_Dbg_Fine, "poll events POLLERR\n");
+			} else if (fds[i].revents & POLLNVAL) {
+				cef_dbg_write (CefC_Dbg_Fine, "poll events POLLNVAL\n");
+			} else if (fds[i].revents & POLLHUP) {
+				cef_dbg_write (CefC_Dbg_Fine, "poll events POLLHUP\n");
+			}
 #endif // CefC_Debug
-				if ((hdl->local_peer_sock != -1) && (fds[i].fd == hdl->local_peer_sock)) {
-					/* Close Local socket */
-					close (hdl->local_peer_sock);
-					hdl->local_peer_sock = -1;
-					cef_log_write (CefC_Log_Info, "Close Local peer\n");
-				} else {
-					/* Close TCP socket */
-					if (hdl->tcp_fds[fds_index[i]] != -1) {
-						/* CONtoCEFNETD */
-						if (hdl->tcp_fds[fds_index[i]] == hdl->cefnetd_sock) {
-							hdl->cefnetd_sock = -1;
-						}
-						close (hdl->tcp_fds[fds_index[i]]);
-						hdl->tcp_fds[fds_index[i]] = -1;
-						cef_log_write (CefC_Log_Info, "Close TCP peer: %s:%s\n",
-							hdl->peer_id_str[fds_index[i]],
-							hdl->peer_sv_str[fds_index[i]]);
-						hdl->peer_num--;
-					}
-					/* Reset buffer */
-					hdl->tcp_index[fds_index[i]] = 0;
+			conpubd_peer_input_process (hdl, fds[i].fd, fds_index[i],
+				(fds[i].revents & POLLIN) ? 1 : 0,
+				(fds[i].revents & (POLLERR | POLLNVAL | POLLHUP)) ? 1 : 0);
+		}
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Reads the socket of the peer which is ready or has an error
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_peer_input_process (
+	CefT_Conpubd_Handle* hdl,					/* conpub daemon handle					*/
+	int fd,										/* socket of the peer					*/
+	int peer_idx,								/* index of the peer					*/
+	int in_f,									/* 1 if the socket is readable			*/
+	int err_f									/* 1 if an error occurs on the socket	*/
+) {
+	int len;
+
+	if (err_f) {
+		/* Error occurs, so close this socket 	*/
+		if ((hdl->local_peer_sock != -1) && (fd == hdl->local_peer_sock)) {
+			/* Close Local socket */
+			close (hdl->local_peer_sock);
+			hdl->local_peer_sock = -1;
+			cef_log_write (CefC_Log_Info, "Close Local peer\n");
+		} else {
+			/* Close TCP socket */
+			if (hdl->tcp_fds[peer_idx] != -1) {
+				/* CONtoCEFNETD */
+				if (hdl->tcp_fds[peer_idx] == hdl->cefnetd_sock) {
+					hdl->cefnetd_sock = -1;
 				}
-				res--;
-				continue;
+				close (hdl->tcp_fds[peer_idx]);
+				hdl->tcp_fds[peer_idx] = -1;
+				cef_log_write (CefC_Log_Info, "Close TCP peer: %s:%s\n",
+					hdl->peer_id_str[peer_idx],
+					hdl->peer_sv_str[peer_idx]);
+				hdl->peer_num--;
 			}
-			if (fds[i].revents & POLLIN) {
-				res--;
-				len = recv (fds[i].fd,
-					&hdl->tcp_buff[fds_index[i]][hdl->tcp_index[fds_index[i]]],
-					CefC_Cefnetd_Buff_Max - hdl->tcp_index[fds_index[i]], 0);
-				if (len > 0) {
-					/* receive message */
-					len += hdl->tcp_index[fds_index[i]];
-					if (fds[i].fd != hdl->cefnetd_sock) {
-						len = conpub_input_bytes_process (
-								hdl, fds[i].fd,
-								&hdl->tcp_buff[fds_index[i]][0], len);
-						/* set index */
-						if (len > 0) {
-							hdl->tcp_index[fds_index[i]] = len;
-						} else {
-							hdl->tcp_index[fds_index[i]] = 0;
-						}
-					}
-					else {
-						struct cef_app_request app_request;
-						do {
-							len = cef_client_request_get_with_info (hdl->tcp_buff[fds_index[i]], len, &app_request);
-							if (app_request.version == CefC_App_Version) {
+			/* Reset buffer */
+			hdl->tcp_index[peer_idx] = 0;
+		}
+		return;
+	}
+	if (in_f == 0) {
+		return;
+	}
+
+	len = recv (fd,
+		&hdl->tcp_buff[peer_idx][hdl->tcp_index[peer_idx]],
+		CefC_Cefnetd_Buff_Max - hdl->tcp_index[peer_idx], 0);
+	if (len > 0) {
+		/* receive message */
+		len += hdl->tcp_index[peer_idx];
+		if (fd != hdl->cefnetd_sock) {
+			len = conpub_input_bytes_process (
+					hdl, fd, &hdl->tcp_buff[peer_idx][0], len);
+			/* set index */
+			if (len > 0) {
+				hdl->tcp_index[peer_idx] = len;
+			} else {
+				hdl->tcp_index[peer_idx] = 0;
+			}
+		}
+		else {
+			struct cef_app_request app_request;
+			do {
+				len = cef_client_request_get_with_info (hdl->tcp_buff[peer_idx], len, &app_request);
+				if (app_request.version == CefC_App_Version) {
 #ifdef CefC_Debug
-								cef_dbg_write (CefC_Dbg_Finest, "Receive the Interest Message\n");
+					cef_dbg_write (CefC_Dbg_Finest, "Receive the Interest Message\n");
 #endif // CefC_Debug
-								/* Version Request: Version response necessity check for management content */
-								if (app_request.version_f == 1 && app_request.ver_len == 0) {
-									CefT_Cpubcnt_Hdl* exist;
+					/* Version Request: Version response necessity check for management content */
+					if (app_request.version_f == 1 && app_request.ver_len == 0) {
+						CefT_Cpubcnt_Hdl* exist;
 #ifdef CefC_Debug
-									cef_dbg_write (CefC_Dbg_Finest, "    (Version Request)\n");
+						cef_dbg_write (CefC_Dbg_Finest, "    (Version Request)\n");
 #endif // CefC_Debug
-									if ((exist=conpubd_content_reg_check (hdl, app_request.name, app_request.total_segs_len)) != NULL) {
-										/* Respond with version */
-										conpubd_version_respond (hdl, exist, fds[i].fd);
-										break;
-									}
-								}
-
-								{
-									CefT_Cpubcnt_Hdl* exist;
-									if ((exist=conpubd_content_reg_check (hdl, app_request.name, app_request.total_segs_len)) != NULL) {
-										if (app_request.version_f == 0 ||
-											(app_request.ver_len == exist->version_len &&
-											memcmp(app_request.ver_value, exist->version, app_request.ver_len) == 0)) {
-											;/* exist */
-										} else {
-											/* Don't have requested version */
-											break;
-										}
-									} else {
-										break;
-									}
-								}
-
-								/* Searches and sends a Cob */
-								hdl->cs_mod_int->cache_item_get
-													(app_request.name, app_request.total_segs_len, app_request.chunk_num, fds[i].fd, app_request.ver_value, app_request.ver_len);
-							}
-							else {
-								break;
-							}
-						} while (len > 0);
-						/* set index */
-						if (len > 0) {
-							hdl->tcp_index[fds_index[i]] = len;
-						} else {
-							hdl->tcp_index[fds_index[i]] = 0;
+						if ((exist=conpubd_content_reg_check (hdl, app_request.name, app_request.total_segs_len)) != NULL) {
+							/* Respond with version */
+							conpubd_version_respond (hdl, exist, fd);
+							break;
 						}
 					}
-				} else if (len == 0) {
-					if ((hdl->local_peer_sock != -1) &&
-						(fds[i].fd == hdl->local_peer_sock)) {
-						/* Close Local socket */
-						close (hdl->local_peer_sock);
-						hdl->local_peer_sock = -1;
-						cef_log_write (CefC_Log_Info, "Close Local peer\n");
-					} else {
-						/* Close TCP socket */
-						if (hdl->tcp_fds[fds_index[i]] != -1) {
-							if (hdl->tcp_fds[fds_index[i]] == hdl->cefnetd_sock) {
-								hdl->cefnetd_sock = -1;
+
+					{
+						CefT_Cpubcnt_Hdl* exist;
+						if ((exist=conpubd_content_reg_check (hdl, app_request.name, app_request.total_segs_len)) != NULL) {
+							if (app_request.version_f == 0 ||
+								(app_request.ver_len == exist->version_len &&
+								memcmp(app_request.ver_value, exist->version, app_request.ver_len) == 0)) {
+								;/* exist */
+							} else {
+								/* Don't have requested version */
+								break;
 							}
-							close (hdl->tcp_fds[fds_index[i]]);
-							hdl->tcp_fds[fds_index[i]] = -1;
-							cef_log_write (CefC_Log_Info, "Close TCP peer: %s:%s\n",
-								hdl->peer_id_str[fds_index[i]],
-								hdl->peer_sv_str[fds_index[i]]);
-							hdl->peer_num--;
-						}
-						/* Reset buffer */
-						hdl->tcp_index[fds_index[i]] = 0;
-					}
-				} else {
-					if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
-						/* Error occurs, so close this socket 	*/
-						if ((hdl->local_peer_sock != -1) &&
-							(fds[i].fd == hdl->local_peer_sock)) {
-							/* Close Local socket */
-							cef_log_write (CefC_Log_Warn,
-								"Receive error (%d) . Close Local socket\n", errno);
-							close (hdl->local_peer_sock);
-							hdl->local_peer_sock = -1;
-							cef_log_write (CefC_Log_Info, "Close Local peer\n");
 						} else {
-							/* Close TCP socket */
-							cef_log_write (CefC_Log_Warn,
-								"Receive error (%d) . Close tcp socket\n", errno);
-							cef_log_write (CefC_Log_Warn, "%s\n", strerror (errno));
-							if (hdl->tcp_fds[fds_index[i]] != -1) {
-								if (hdl->tcp_fds[fds_index[i]] == hdl->cefnetd_sock) {
-									hdl->cefnetd_sock = -1;
-								}
-								cef_log_write (CefC_Log_Warn, "Close TCP peer: %s:%s\n",
-									hdl->peer_id_str[fds_index[i]],
-									hdl->peer_sv_str[fds_index[i]]);
-								close (hdl->tcp_fds[fds_index[i]]);
-								hdl->tcp_fds[fds_index[i]] = -1;
-								hdl->peer_num--;
-							}
-							/* Reset buffer */
-							hdl->tcp_index[fds_index[i]] = 0;
+							break;
 						}
 					}
+
+					/* Searches and sends a Cob */
+					hdl->cs_mod_int->cache_item_get
+										(app_request.name, app_request.total_segs_len, app_request.chunk_num, fd, app_request.ver_value, app_request.ver_len);
+				}
+				else {
+					break;
+				}
+			} while (len > 0);
+			/* set index */
+			if (len > 0) {
+				hdl->tcp_index[peer_idx] = len;
+			} else {
+				hdl->tcp_index[peer_idx] = 0;
+			}
+		}
+	} else if (len == 0) {
+		if ((hdl->local_peer_sock != -1) && (fd == hdl->local_peer_sock)) {
+			/* Close Local socket */
+			close (hdl->local_peer_sock);
+			hdl->local_peer_sock = -1;
+			cef_log_write (CefC_Log_Info, "Close Local peer\n");
+		} else {
+			/* Close TCP socket */
+			if (hdl->tcp_fds[peer_idx] != -1) {
+				if (hdl->tcp_fds[peer_idx] == hdl->cefnetd_sock) {
+					hdl->cefnetd_sock = -1;
+				}
+				close (hdl->tcp_fds[peer_idx]);
+				hdl->tcp_fds[peer_idx] = -1;
+				cef_log_write (CefC_Log_Info, "Close TCP peer: %s:%s\n",
+					hdl->peer_id_str[peer_idx],
+					hdl->peer_sv_str[peer_idx]);
+				hdl->peer_num--;
+			}
+			/* Reset buffer */
+			hdl->tcp_index[peer_idx] = 0;
+		}
+	} else {
+		if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+			/* Error occurs, so close this socket 	*/
+			if ((hdl->local_peer_sock != -1) && (fd == hdl->local_peer_sock)) {
+				/* Close Local socket */
+				cef_log_write (CefC_Log_Warn,
+					"Receive error (%d) . Close Local socket\n", errno);
+				close (hdl->local_peer_sock);
+				hdl->local_peer_sock = -1;
+				cef_log_write (CefC_Log_Info, "Close Local peer\n");
+			} else {
+				/* Close TCP socket */
+				cef_log_write (CefC_Log_Warn,
+					"Receive error (%d) . Close tcp socket\n", errno);
+				cef_log_write (CefC_Log_Warn, "%s\n", strerror (errno));
+				if (hdl->tcp_fds[peer_idx] != -1) {
+					if (hdl->tcp_fds[peer_idx] == hdl->cefnetd_sock) {
+						hdl->cefnetd_sock = -1;
+					}
+					cef_log_write (CefC_Log_Warn, "Close TCP peer: %s:%s\n",
+						hdl->peer_id_str[peer_idx],
+						hdl->peer_sv_str[peer_idx]);
+					close (hdl->tcp_fds[peer_idx]);
+					hdl->tcp_fds[peer_idx] = -1;
+					hdl->peer_num--;
 				}
+				/* Reset buffer */
+				hdl->tcp_index[peer_idx] = 0;
 			}
 		}
 	}
-	pthread_join (conpubd_expire_check_th, &status);
+}
+/*--------------------------------------------------------------------------------------
+	Closes the epoll instance, the timerfd and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_event_epoll_destroy (
+	void
+) {
+	int fd;
 
-	/* post process */
-	conpubd_post_process (hdl);
-	cef_log_write (CefC_Log_Info, "Stop\n");
+	if (conpubd_epfd != -1) {
+		close (conpubd_epfd);
+		conpubd_epfd = -1;
+	}
+	if (conpubd_tick_fd != -1) {
+		close (conpubd_tick_fd);
+		conpubd_tick_fd = -1;
+	}
+	if (conpubd_wake_fd != -1) {
+		/* The signal handler does not write the closed eventfd 	*/
+		fd = conpubd_wake_fd;
+		conpubd_wake_fd = -1;
+		close (fd);
+	}
+}
+#ifndef CefC_MACOS
+/*--------------------------------------------------------------------------------------
+	Creates the epoll instance, the timerfd and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+conpubd_event_epoll_init (
+	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
+) {
+	struct epoll_event ev;
+	int fd;
+	int i;
 
-	return;
+	conpubd_epfd = epoll_create1 (EPOLL_CLOEXEC);
+	if (conpubd_epfd < 0) {
+		conpubd_epfd = -1;
+		return (-1);
+	}
+	conpubd_tick_fd = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (conpubd_tick_fd < 0) {
+		conpubd_tick_fd = -1;
+		conpubd_event_epoll_destroy ();
+		return (-1);
+	}
+	fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (fd < 0) {
+		conpubd_event_epoll_destroy ();
+		return (-1);
+	}
+
+	/* The signal handler writes the eventfd to stop the loop 	*/
+	memset (&ev, 0, sizeof (ev));
+	ev.events 	= EPOLLIN;
+	ev.data.u64 = ConpubdC_Event_Data (fd, ConpubdC_Event_Wake);
+	if (epoll_ctl (conpubd_epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		close (fd);
+		conpubd_event_epoll_destroy ();
+		return (-1);
+	}
+	conpubd_wake_fd = fd;
+
+	/* The timerfd is armed while conpubd waits to reconnect to cefnetd 	*/
+	ev.data.u64 = ConpubdC_Event_Data (conpubd_tick_fd, ConpubdC_Event_Tick);
+	if (epoll_ctl (conpubd_epfd, EPOLL_CTL_ADD, conpubd_tick_fd, &ev) < 0) {
+		conpubd_event_epoll_destroy ();
+		return (-1);
+	}
+
+	/* The listen sockets are accepted as they become ready 	*/
+	ev.data.u64 = ConpubdC_Event_Data (hdl->local_listen_fd, ConpubdC_Event_Local_Listen);
+	if (epoll_ctl (conpubd_epfd, EPOLL_CTL_ADD, hdl->local_listen_fd, &ev) < 0) {
+		conpubd_event_epoll_destroy ();
+		return (-1);
+	}
+	ev.data.u64 = ConpubdC_Event_Data (hdl->tcp_listen_fd, ConpubdC_Event_Tcp_Listen);
+	if (epoll_ctl (conpubd_epfd, EPOLL_CTL_ADD, hdl->tcp_listen_fd, &ev) < 0) {
+		conpubd_event_epoll_destroy ();
+		return (-1);
+	}
+
+	/* The sockets of the peers are registered by conpubd_event_peer_update 	*/
+	for (i = 0 ; i < ConpubdC_Max_Sock_Num ; i++) {
+		conpubd_ev_fds[i] = -1;
+	}
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Registers the sockets of the peers which have changed
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_event_peer_update (
+	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
+) {
+	struct epoll_event ev;
+	int fd;
+	int i;
+
+	for (i = 0 ; i < ConpubdC_Max_Sock_Num ; i++) {
+		fd = (i == 0) ? hdl->local_peer_sock : hdl->tcp_fds[i];
+		if (fd == -1) {
+			/* The closed socket has left the epoll instance 	*/
+			conpubd_ev_fds[i] = -1;
+			continue;
+		}
+		if (fd == conpubd_ev_fds[i]) {
+			continue;
+		}
+		memset (&ev, 0, sizeof (ev));
+		ev.events 	= EPOLLIN;
+		ev.data.u64 = ConpubdC_Event_Data (fd, i);
+		if (epoll_ctl (conpubd_epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+			cef_log_write (CefC_Log_Warn,
+				"Failed to watch the FD#%d (%s)\n", fd, strerror (errno));
+			continue;
+		}
+		conpubd_ev_fds[i] = fd;
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Arms the timerfd to reconnect to cefnetd
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_event_timer_arm (
+	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
+) {
+	struct itimerspec its;
+	uint64_t nowt;
+	uint64_t t;
+
+	/* The timer stays disarmed once it expired while conpubd is connected 	*/
+	if (hdl->cefnetd_sock != -1) {
+		return;
+	}
+
+	/* The present time is not monotonic, so the timer is relative 	*/
+	nowt = cef_client_present_timeus_calc ();
+	t = (hdl->cefnetd_reconnect_time >= nowt) ?
+			hdl->cefnetd_reconnect_time - nowt + 1 : 1;
+	memset (&its, 0, sizeof (its));
+	its.it_value.tv_sec  = t / 1000000;
+	its.it_value.tv_nsec = (t % 1000000) * 1000;
+	if (timerfd_settime (conpubd_tick_fd, 0, &its, NULL) < 0) {
+		cef_log_write (CefC_Log_Warn,
+			"Failed to arm the timer (%s)\n", strerror (errno));
+	}
 }
+/*--------------------------------------------------------------------------------------
+	Main loop with epoll
+----------------------------------------------------------------------------------------*/
+static void
+conpubd_event_epoll_dispatch (
+	CefT_Conpubd_Handle* hdl					/* conpub daemon handle					*/
+) {
+	struct epoll_event evs[ConpubdC_Event_Max];
+	uint64_t val;
+	int res;
+	int i;
+	int fd;
+	int idx;
 
+	cef_log_write (CefC_Log_Info, "Uses epoll for the main loop\n");
+
+	while (conpubd_running_f) {
+
+		/* connect to cefnetd */
+		conpubd_connect_conpubd_and_regApp (hdl);
+		conpubd_event_timer_arm (hdl);
+
+		/* Watches the peers which have been accepted or connected 	*/
+		conpubd_event_peer_update (hdl);
+
+		/* Waits for the sockets, the reconnection time or a signal 	*/
+		res = epoll_wait (conpubd_epfd, evs, ConpubdC_Event_Max, -1);
+
+		for (i = 0 ; i < res ; i++) {
+			fd  = ConpubdC_Event_Fd (evs[i].data.u64);
+			idx = ConpubdC_Event_Index (evs[i].data.u64);
+
+			if ((idx == ConpubdC_Event_Tick) || (idx == ConpubdC_Event_Wake)) {
+				if (read (fd, &val, sizeof (val)) < 0) {
+					/* NOP */;
+				}
+				continue;
+			}
+			if (idx == ConpubdC_Event_Local_Listen) {
+				conpubd_local_sock_check (hdl);
+				continue;
+			}
+			if (idx == ConpubdC_Event_Tcp_Listen) {
+				conpubd_tcp_connect_accept (hdl);
+				continue;
+			}
+
+			/* The peer may have been closed by the earlier event 	*/
+			if (fd != ((idx == 0) ? hdl->local_peer_sock : hdl->tcp_fds[idx])) {
+				continue;
+			}
+			conpubd_peer_input_process (hdl, fd, idx,
+				(evs[i].events & EPOLLIN) ? 1 : 0,
+				(evs[i].events & (EPOLLERR | EPOLLHUP)) ? 1 : 0);
+
+			/* A socket accepted later in this round may reuse the number 	*/
+			if (fd != ((idx == 0) ? hdl->local_peer_sock : hdl->tcp_fds[idx])) {
+				conpubd_ev_fds[idx] = -1;
+			}
+		}
+	}
+}
+#endif // CefC_MACOS
 /*--------------------------------------------------------------------------------------
 	function for processing the expire check
 ----------------------------------------------------------------------------------------*/
@@ -1547,6 +1878,7 @@ conpubd_config_read (
 	conf_param->contents_num			= CefC_CnpbDefault_Contents_num;
 	conf_param->contents_capacity	= CefC_CnpbDefault_Contents_Capacity;
 	conf_param->block_size			= CefC_CnpbDefault_Block_Size;
+	conf_param->publish_workers		= CefC_CnpbDefault_Publish_Workers;
 	strcpy(conf_param->cefnetd_node,  CefC_CnpbDefault_Node_Path);
 	conf_param->cefnetd_port		= CefC_CnpbDefault_Cefnetd_Port;
 
@@ -1700,6 +2032,17 @@ conpubd_config_read (
 			}
 			conf_param->block_size = res;
 		} else
+		if (strcmp (option, "PUBLISH_WORKERS") == 0) {
+			res = conpubd_config_value_get (option, value);
+			if (!(1 <= res && res <= CefC_Publish_Worker_Max)) {
+				cef_log_write (CefC_Log_Error,
+				"PUBLISH_WORKERS value must be greater than or equal to 1 "
+				"and less than or equal to %d.\n", CefC_Publish_Worker_Max);
+				fclose (fp);
+				return (-1);
+			}
+			conf_param->publish_workers = res;
+		} else
 		if (strcmp (option, "CEFNETD_NODE") == 0) {
 			if (strlen (value) > sizeof (conf_param->cefnetd_node)-1) {
 				cef_log_write (CefC_Log_Error,
@@ -1784,6 +2127,7 @@ conpubd_config_read (
 	cef_dbg_write (CefC_Dbg_Fine, "conf_param->contents_num=%d\n", conf_param->contents_num);
 	cef_dbg_write (CefC_Dbg_Fine, "conf_param->contents_capacity="FMTU64"\n", conf_param->contents_capacity);
 	cef_dbg_write (CefC_Dbg_Fine, "conf_param->block_size=%d\n", conf_param->block_size);
+	cef_dbg_write (CefC_Dbg_Fine, "conf_param->publish_workers=%d\n", conf_param->publish_workers);
 	cef_dbg_write (CefC_Dbg_Fine, "conf_param->cefnetd_node=%s\n", conf_param->cefnetd_node);
 	cef_dbg_write (CefC_Dbg_Fine, "conf_param->cefnetd_port=%d\n", conf_param->cefnetd_port);
 #ifdef	CefC_Db
@@ -3211,8 +3555,16 @@ static void
 conpubd_sigcatch (
 	int sig										/* caught signal						*/
 ) {
+	uint64_t val = 1;
+
 	if ((sig == SIGINT) || (sig == SIGTERM)) {
 		conpubd_running_f = 0;
+		/* The signal may be caught by a thread other than the main loop 	*/
+		if (conpubd_wake_fd != -1) {
+			if (write (conpubd_wake_fd, &val, sizeof (val)) < 0) {
+				/* NOP */;
+			}
+		}
 	}
 	return;
 }
@@ -3741,7 +4093,11 @@ conpubd_publish_content_create (
 	uint32_t seqnum = 0;
 	int res;
 	unsigned char buff[CefC_Max_Length];
-	unsigned char cobbuff[CefC_Max_Length];
+	unsigned char* cobbuff;
+	CefT_Publish* pp;
+	int read_end_f = 0;
+	uint16_t pay_len;
+	uint32_t chunk_num;
 
 	int len;
 	int rtc = 0;
@@ -3826,19 +4182,38 @@ conpubd_publish_content_create (
 	/* Sets Version */
 	if (entry->version_len) {
 		Cob_prames_p->org.version_f = 1;
-		memcpy (Cob_prames_p->org.version_val, entry->version, entry->version_len);
+		Cob_prames_p->org.version_val = entry->version;
 	}
 	Cob_prames_p->org.version_len = (uint16_t)entry->version_len;
 
 	cef_frame_conversion_name_to_string (entry->name, entry->name_len, Uri_buff_p, "ccn");
+	/* The chunks are framed and signed by the workers while the file is read 	*/
+	pp = cef_publish_create (&opt, Cob_prames_p, hdl->publish_workers, 0);
+	if (pp == NULL) {
+		cef_log_write (CefC_Log_Critical, "Failed to alloc memory\n");
+		fclose (fp);
+		return (-1);
+	}
 	while (conpubd_running_f) {
-		res = fread (buff, sizeof (unsigned char), hdl->block_size, fp);
-		if (res > 0) {
-			memcpy (Cob_prames_p->payload, buff, res);
-			Cob_prames_p->payload_len = (uint16_t) res;
-			Cob_prames_p->chunk_num = seqnum;
-
-			len = cef_frame_object_create (cobbuff, &opt, Cob_prames_p);
+		while ((read_end_f == 0) && (cef_publish_space_get (pp) > 0)) {
+			res = fread (buff, sizeof (unsigned char), hdl->block_size, fp);
+			if (res <= 0) {
+				if (feof (fp) == 0 || ferror (fp) != 0) {
+					cef_log_write (CefC_Log_Critical, "Failed to publish %s (Read Error)\n", Uri_buff_p);
+					conpubd_running_f = 0;
+					cef_publish_destroy (pp);
+					fclose (fp);
+					hdl->cs_mod_int->cache_item_puts (NULL, 0, NULL);
+					return (-1);
+				}
+				read_end_f = 1;
+				break;
+			}
+			cef_publish_block_put (pp, buff, (uint16_t) res, seqnum, 0);
+			seqnum++;
+		}
+		len = cef_publish_cob_get (pp, &cobbuff, &pay_len, &chunk_num);
+		if (len != 0) {
 			if (first_cob_f == 0) {
 				if (strcmp(hdl->cache_type, CefC_Cnpb_memory_Cache_Type) == 0) {
 					/* Get free mem size */
@@ -3855,6 +4230,7 @@ conpubd_publish_content_create (
 							"Skipping content(%s) registration due to lack of memory.\n"
 							"	free memory="FMTU64"(MB), estimated memory usage="FMTU64"(MB)\n",
 							Uri_buff_p, free_mem_mega, estimated_mem_mega);
+						cef_publish_destroy (pp);
 						fclose (fp);
 						return (-99);
 					} else {
@@ -3874,6 +4250,7 @@ conpubd_publish_content_create (
 							"	(Use %dMB as free reserve)\n",
 							Uri_buff_p, free_file_mega, estimated_file_mega,
 							CefC_Cpub_Reserved_Disk_Mega);
+						cef_publish_destroy (pp);
 						fclose (fp);
 						return (-99);
 					} else {
@@ -3898,6 +4275,7 @@ conpubd_publish_content_create (
 				if ((cont_entry.msg = calloc (1, len)) == NULL) {
 					cef_log_write (CefC_Log_Critical, "Failed to alloc memory\n");
 					conpubd_running_f = 0;
+					cef_publish_destroy (pp);
 					fclose (fp);
 					return (-1);
 				}
@@ -3906,13 +4284,14 @@ conpubd_publish_content_create (
 				if ((cont_entry.name = calloc (1, Cob_prames_p->name_len)) == NULL) {
 					cef_log_write (CefC_Log_Critical, "Failed to alloc memory\n");
 					conpubd_running_f = 0;
+					cef_publish_destroy (pp);
 					fclose (fp);
 					return (-1);
 				}
 				memcpy (cont_entry.name, Cob_prames_p->name, Cob_prames_p->name_len);
 				cont_entry.name_len = Cob_prames_p->name_len;
-				cont_entry.pay_len = Cob_prames_p->payload_len;
-				cont_entry.chunk_num = Cob_prames_p->chunk_num;
+				cont_entry.pay_len = pay_len;
+				cont_entry.chunk_num = chunk_num;
 				cont_entry.expiry = Cob_prames_p->expiry * 1000;
 				cont_entry.rct = (uint64_t)hdl->cache_default_rct;
 				/* cont_entry.node does not care */
@@ -3920,23 +4299,18 @@ conpubd_publish_content_create (
 				if (rtc < 0) {
 					cef_log_write (CefC_Log_Critical, "Failed to publish %s (cache_item_puts)\n", Uri_buff_p);
 					conpubd_running_f = 0;
+					cef_publish_destroy (pp);
 					fclose (fp);
 					hdl->cs_mod_int->cache_item_puts (NULL, 0, NULL);
 					return (-1);
 				}
 			}
-			seqnum++;
+			cef_publish_cob_release (pp);
 		} else {
-			if (feof (fp) == 0 || ferror (fp) != 0) {
-				cef_log_write (CefC_Log_Critical, "Failed to publish %s (Read Error)\n", Uri_buff_p);
-				conpubd_running_f = 0;
-				fclose (fp);
-				hdl->cs_mod_int->cache_item_puts (NULL, 0, NULL);
-				return (-1);
-			}
 			break;
 		}
 	}
+	cef_publish_destroy (pp);
 
 	hdl->cs_mod_int->cache_item_puts (NULL, 0, NULL);
 	fclose (fp);
@@ -4102,7 +4476,7 @@ conpubd_version_respond (
 	Cob_prames.org.version_f = 1;
 	Cob_prames.org.version_len = 0;
 	/* Sets Version at payload */
-	memcpy (Cob_prames.payload, entry->version, entry->version_len);
+	Cob_prames.payload = entry->version;
 	Cob_prames.payload_len = (uint16_t) entry->version_len;
 	/* Sets Varidation */
 	Cob_prames.alg.valid_type = hdl->valid_type;
@@ -77,6 +77,7 @@ typedef struct {
 	int				contents_num;
 	uint64_t		contents_capacity;
 	int				block_size;
+	int				publish_workers;
 	char			cefnetd_node[128]; 
 	int				cefnetd_port;
 	char			restore_path[PATH_MAX];
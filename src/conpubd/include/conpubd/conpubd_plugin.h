@@ -131,6 +131,7 @@ typedef struct {
 	int				block_size;
 	uint32_t		cache_default_rct;
 	uint16_t 		valid_type;
+	int				publish_workers;			/* Threads to create the Cobs			*/
 
 	/********** APP FIB registration info. ***********/
 	char 		cefnetd_id[128];
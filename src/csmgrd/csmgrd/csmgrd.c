@@ -58,6 +58,10 @@
 #include <net/if.h>		///
 #include <sys/ioctl.h>	///
 #include <ifaddrs.h>	///
+#ifndef CefC_MACOS
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif // CefC_MACOS
 
 #include "csmgrd.h"
 #include <csmgrd/csmgrd_plugin.h>
@@ -111,21 +115,14 @@ static int xpthread_mutex_lock (const char* pname, int pline, pthread_mutex_t *m
  ****************************************************************************************/
 
 static uint8_t 				csmgrd_running_f = 0;
+static int 					csmgrd_wake_fd = -1;		/* eventfd waking the main loop	*/
+static int 					csmgrd_wake_f = 0;			/* 1 if the eventfd is written	*/
 static char 				csmgr_conf_dir[PATH_MAX] = {"/usr/local/cefore"};
 static char 				root_user_name[CefC_Csmgr_User_Len] = {"root"};
 static char 				csmgr_local_sock_name[PATH_MAX] = {0};
 
-static pthread_mutex_t 		csmgr_comn_buff_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t 		csmgr_main_cob_buff_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t		csmgr_comn_buff_cond = PTHREAD_COND_INITIALIZER;
-
-static unsigned char* 		csmgr_main_cob_buff 		= NULL;
-static int 					csmgr_main_cob_buff_idx 	= 0;
-static unsigned char* 		csmgr_comn_cob_buff 		= NULL;
-static int 					csmgr_comn_cob_buff_idx 	= 0;
-static unsigned char* 		csmgr_proc_cob_buff 		= NULL;
-static int 					csmgr_proc_cob_buff_idx 	= 0;
-static uint64_t				csmgr_wait_time 			= 2000000;
+static pthread_mutex_t 		csmgr_cob_ring_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t		csmgr_cob_ring_cond = PTHREAD_COND_INITIALIZER;
 static CsmgrT_Stat_Handle 	stat_hdl = CsmgrC_Invalid;
 
 static int	Lack_of_M_resources = 1;
@@ -219,6 +216,61 @@ static void
 csmgrd_event_dispatch (
 	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
 );
+/*--------------------------------------------------------------------------------------
+	Main loop with poll
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_event_poll_dispatch (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+);
+/*--------------------------------------------------------------------------------------
+	Reads the socket of the peer which is ready or has an error
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_peer_input_process (
+	CefT_Csmgrd_Handle* hdl,					/* csmgr daemon handle					*/
+	int fd,										/* socket of the peer					*/
+	int peer_idx,								/* index of the peer					*/
+	int in_f,									/* 1 if the socket is readable			*/
+	int err_f									/* 1 if an error occurs on the socket	*/
+);
+/*--------------------------------------------------------------------------------------
+	Wakes up the main loop waiting in epoll_wait
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_event_wake (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Closes the epoll instance and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_event_epoll_destroy (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+);
+#ifndef CefC_MACOS
+/*--------------------------------------------------------------------------------------
+	Creates the epoll instance and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+csmgrd_event_epoll_init (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+);
+/*--------------------------------------------------------------------------------------
+	Registers the sockets of the peers which have changed
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_event_peer_update (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+);
+/*--------------------------------------------------------------------------------------
+	Main loop with epoll
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_event_epoll_dispatch (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+);
+#endif // CefC_MACOS
 /*--------------------------------------------------------------------------------------
 	Prepares the Control sockets to be polled
 ----------------------------------------------------------------------------------------*/
@@ -228,6 +280,14 @@ csmgrd_poll_socket_prepare (
 	struct pollfd fds[],
 	int fds_index[]
 );
+/*--------------------------------------------------------------------------------------
+	Checks whether the receive buffer of the peer has room to receive
+----------------------------------------------------------------------------------------*/
+static int
+csmgrd_peer_recv_ready (
+	CefT_Csmgrd_Handle* hdl,					/* csmgr daemon handle					*/
+	int peer_idx								/* index of the peer					*/
+);
 /*--------------------------------------------------------------------------------------
 	Handles the received message(s)
 ----------------------------------------------------------------------------------------*/
@@ -266,6 +326,31 @@ cef_csmgr_interest_msg_parse (
 	unsigned char ver[],						/* Content Version						*/
 	uint16_t* ver_len							/* Length of content version			*/
 );
+/*--------------------------------------------------------------------------------------
+	Incoming Bulk Interest Message
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_incoming_bulk_interest (
+	CefT_Csmgrd_Handle* hdl,					/* csmgr daemon handle					*/
+	int sock,									/* recv socket							*/
+	unsigned char* buff,						/* receive message						*/
+	int buff_len								/* receive message length				*/
+);
+/*--------------------------------------------------------------------------------------
+	Parse Bulk Interest message
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+cef_csmgr_bulk_interest_msg_parse (
+	unsigned char buff[],						/* receive message						*/
+	int buff_len,								/* receive message length				*/
+	uint8_t* int_type,							/* Interest type						*/
+	unsigned char name[],						/* Content Name							*/
+	uint16_t* name_len,							/* Length of content name				*/
+	uint32_t* first_chunk,						/* Chunk number of bit 0 of chunk_map	*/
+	uint64_t* chunk_map,						/* Bitmap of the requested chunks		*/
+	unsigned char ver[],						/* Content Version						*/
+	uint16_t* ver_len							/* Length of content version			*/
+);
 /*--------------------------------------------------------------------------------------
 	Incoming Get Status Message
 ----------------------------------------------------------------------------------------*/
@@ -527,29 +612,33 @@ static void*
 csmgrd_expire_check_thread (
 	void* arg
 );
-/*--------------------------------------------------------------------------------------
-	function for processing buffering messages
-----------------------------------------------------------------------------------------*/
-static void*
-push_bytes_process_thread (
-	void* arg
-);
 /*--------------------------------------------------------------------------------------
 	Get frame from received message
 ----------------------------------------------------------------------------------------*/
 static int							/* The return value is negative if an error occurs	*/
 csmgr_input_bytes_process (
 	CefT_Csmgrd_Handle* hdl,				/* CS Manager Handle						*/
+	int peer_idx,							/* index of the peer						*/
 	int peer_fd,
 	unsigned char* buff,					/* receive message							*/
 	int buff_len							/* message length							*/
 );
 /*--------------------------------------------------------------------------------------
-	Push the buffered messages to proc thread buffer
+	Appends the Upload Request message to the ring of the peer
+----------------------------------------------------------------------------------------*/
+static int							/* -1 if the ring has no room						*/
+csmgrd_cob_ring_put (
+	CsmgrdT_Cob_Ring* ring,					/* ring of the peer							*/
+	unsigned char* msg,						/* Upload Request message					*/
+	int msg_len								/* message length							*/
+);
+/*--------------------------------------------------------------------------------------
+	Retries the Upload Requests held in the receive buffer of the peers which
+	waited for the room of the ring
 ----------------------------------------------------------------------------------------*/
 static void
-csmgr_push_bytes_process (
-	void
+csmgrd_cob_ring_resume (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
 );
 
 /***** 0.8.3c S *****/
@@ -715,6 +804,7 @@ csmgrd_handle_create (
 	hdl->tcp_listen_fd 		= -1;
 	hdl->local_listen_fd 	= -1;
 	hdl->local_peer_sock 	= -1;
+	hdl->epfd 				= -1;
 
 	/* Records the user which launched cefnetd 		*/
 	envp = getenv ("USER");
@@ -885,33 +975,6 @@ csmgrd_handle_create (
 	}
 	cef_log_write (CefC_Log_Info, "Loading %s ... OK\n", CefC_Csmgrd_Conf_Name);
 
-	csmgr_main_cob_buff =
-		(unsigned char*) malloc (sizeof (unsigned char) * CsmgrC_Buff_Size);
-	if (csmgr_main_cob_buff == NULL) {
-		cef_log_write (CefC_Log_Error, "Failed to allocation cob buffer\n");
-		csmgrd_handle_destroy (&hdl);
-		return (NULL);
-	}
-	csmgr_main_cob_buff_idx = 0;
-
-	csmgr_comn_cob_buff =
-		(unsigned char*) malloc (sizeof (unsigned char) * CsmgrC_Buff_Size);
-	if (csmgr_comn_cob_buff == NULL) {
-		cef_log_write (CefC_Log_Error, "Failed to allocation common cob buffer\n");
-		csmgrd_handle_destroy (&hdl);
-		return (NULL);
-	}
-	csmgr_comn_cob_buff_idx = 0;
-
-	csmgr_proc_cob_buff =
-		(unsigned char*) malloc (sizeof (unsigned char) * CsmgrC_Buff_Max);
-	if (csmgr_proc_cob_buff == NULL) {
-		cef_log_write (CefC_Log_Error, "Failed to allocation process cob buffer\n");
-		csmgrd_handle_destroy (&hdl);
-		return (NULL);
-	}
-	csmgr_proc_cob_buff_idx = 0;
-
 #ifdef CefC_Debug
 	/* Show config value */
 	cef_dbg_write (CefC_Dbg_Fine, "CACHE_INTERVAL = %lu\n", hdl->interval);
@@ -940,16 +1003,8 @@ static void
 csmgrd_event_dispatch (
 	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
 ) {
-	struct pollfd fds[CsmgrdC_Max_Sock_Num];
-	int fdnum;
-	int fds_index[CsmgrdC_Max_Sock_Num];
-	int len;
-	int res;
-	int i;
-
 	pthread_t		csmgrd_msg_process_th;
 	pthread_t		csmgrd_expire_check_th;
-	pthread_t		push_bytes_process_th;
 	pthread_t		csmgrd_resource_mon_th;
 	void*			status;
 
@@ -982,11 +1037,6 @@ csmgrd_event_dispatch (
 		csmgrd_running_f = 0;
 	}
 
-		if (pthread_create (&push_bytes_process_th, NULL, push_bytes_process_thread, hdl) == -1) {
-		cef_log_write (CefC_Log_Error,
-						"Failed to create the new thread(push_bytes_process_thread)\n");
-		csmgrd_running_f = 0;
-	}
 	if (pthread_create (&csmgrd_resource_mon_th, NULL, csmgrd_resource_mon_thread, hdl) == -1) {
 		cef_log_write (CefC_Log_Error,
 						"Failed to create the new thread\n");
@@ -994,6 +1044,47 @@ csmgrd_event_dispatch (
 	}
 
 	/* Main loop */
+#ifndef CefC_MACOS
+	if (csmgrd_event_epoll_init (hdl) == 0) {
+		csmgrd_event_epoll_dispatch (hdl);
+	} else {
+		cef_log_write (CefC_Log_Warn,
+			"Failed to prepare epoll (%s), so poll is used\n", strerror (errno));
+		csmgrd_event_poll_dispatch (hdl);
+	}
+#else // CefC_MACOS
+	csmgrd_event_poll_dispatch (hdl);
+#endif // CefC_MACOS
+
+	pthread_mutex_lock (&csmgr_cob_ring_mutex);
+	pthread_cond_signal (&csmgr_cob_ring_cond);			/* To avoid deadlock */
+	pthread_mutex_unlock (&csmgr_cob_ring_mutex);
+	pthread_join (csmgrd_msg_process_th, &status);
+	pthread_join (csmgrd_expire_check_th, &status);
+	pthread_cond_destroy (&csmgr_cob_ring_cond);
+
+	/* post process */
+	csmgrd_post_process (hdl);
+	cef_log_write (CefC_Log_Info, "Stop\n");
+
+
+
+	return;
+}
+
+/*--------------------------------------------------------------------------------------
+	Main loop with poll
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_event_poll_dispatch (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+) {
+	struct pollfd fds[CsmgrdC_Max_Sock_Num];
+	int fdnum;
+	int fds_index[CsmgrdC_Max_Sock_Num];
+	int res;
+	int i;
+
 	while (csmgrd_running_f) {
 
 		/* check accept */
@@ -1002,6 +1093,9 @@ csmgrd_event_dispatch (
 		/* Checks socket accept 			*/
 		csmgrd_tcp_connect_accept (hdl);
 
+		/* Resumes the peers which waited for the room of the ring 	*/
+		csmgrd_cob_ring_resume (hdl);
+
 		/* Sets fds to be polled 			*/
 		fdnum = csmgrd_poll_socket_prepare (hdl, fds, fds_index);
 		res = poll (fds, fdnum, 1);
@@ -1018,126 +1112,331 @@ csmgrd_event_dispatch (
 		}
 
 		/* Checks whether frame(s) arrivals from the active local faces */
-		for (i = 0 ; res > 0 && i < CsmgrdC_Max_Sock_Num - 1 ; i++) {
-			if (fds[i].revents & (POLLERR | POLLNVAL | POLLHUP)) {
-				/* Error occurs, so close this socket 	*/
-#ifdef CefC_Debug
-				if (fds[i].revents & POLLERR) {
-					cef_dbg_write (CefC_Dbg_Fine, "poll events POLLERR\n");
-				} else if (fds[i].revents & POLLNVAL) {
-					cef_dbg_write (CefC_Dbg_Fine, "poll events POLLNVAL\n");
-				} else {
-					cef_dbg_write (CefC_Dbg_Fine, "poll events POLLHUP\n");
-				}
-#endif // CefC_Debug
-				if ((hdl->local_peer_sock != -1) && (fds[i].fd == hdl->local_peer_sock)) {
-					/* Close Local socket */
-					close (hdl->local_peer_sock);
-					hdl->local_peer_sock = -1;
-					cef_log_write (CefC_Log_Info, "Close Local peer\n");
-				} else {
-					/* Close TCP socket */
-					if (hdl->tcp_fds[fds_index[i]] != -1) {
-						close (hdl->tcp_fds[fds_index[i]]);
-						hdl->tcp_fds[fds_index[i]] = -1;
-						cef_log_write (CefC_Log_Info, "Close TCP peer: %s:%s\n",
-							hdl->peer_id_str[fds_index[i]],
-							hdl->peer_sv_str[fds_index[i]]);
-						hdl->peer_num--;
-					}
-					/* Reset buffer */
-					hdl->tcp_index[fds_index[i]] = 0;
-				}
-				res--;
+		for (i = 0 ; res > 0 && i < fdnum ; i++) {
+			if (fds[i].revents == 0) {
 				continue;
 			}
+			res--;
+#ifdef CefC_Debug
+			if (fds[i].revents & POLLERR) {
+				cef_dbg_write (CefC_Dbg_Fine, "poll events POLLERR\n");
+			} else if (fds[i].revents & POLLNVAL) {
+				cef_dbg_write (CefC_Dbg_Fine, "poll events POLLNVAL\n");
+			} else if (fds[i].revents & POLLHUP) {
+				cef_dbg_write (CefC_Dbg_Fine, "poll events POLLHUP\n");
+			}
+#endif // CefC_Debug
+			csmgrd_peer_input_process (hdl, fds[i].fd, fds_index[i],
+				(fds[i].revents & POLLIN) ? 1 : 0,
+				(fds[i].revents & (POLLERR | POLLNVAL | POLLHUP)) ? 1 : 0);
+		}
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Reads the socket of the peer which is ready or has an error
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_peer_input_process (
+	CefT_Csmgrd_Handle* hdl,					/* csmgr daemon handle					*/
+	int fd,										/* socket of the peer					*/
+	int peer_idx,								/* index of the peer					*/
+	int in_f,									/* 1 if the socket is readable			*/
+	int err_f									/* 1 if an error occurs on the socket	*/
+) {
+	int len;
 
-			if (fds[i].revents & POLLIN) {
-				res--;
-				len = recv (fds[i].fd,
-					&hdl->tcp_buff[fds_index[i]][hdl->tcp_index[fds_index[i]]],
-					CefC_Cefnetd_Buff_Max - hdl->tcp_index[fds_index[i]], 0);
-				if (len > 0) {
-					/* receive message */
-					len += hdl->tcp_index[fds_index[i]];
-
-					len = csmgr_input_bytes_process (
-							hdl, fds[i].fd,
-							&hdl->tcp_buff[fds_index[i]][0], len);
-
-					/* set index */
-					if (len > 0) {
-						hdl->tcp_index[fds_index[i]] = len;
-					} else {
-						hdl->tcp_index[fds_index[i]] = 0;
-					}
-				} else if (len == 0) {
-					if ((hdl->local_peer_sock != -1) &&
-						(fds[i].fd == hdl->local_peer_sock)) {
-						/* Close Local socket */
-						close (hdl->local_peer_sock);
-						hdl->local_peer_sock = -1;
-						cef_log_write (CefC_Log_Info, "Close Local peer\n");
-					} else {
-						/* Close TCP socket */
-						if (hdl->tcp_fds[fds_index[i]] != -1) {
-							close (hdl->tcp_fds[fds_index[i]]);
-							hdl->tcp_fds[fds_index[i]] = -1;
-							cef_log_write (CefC_Log_Info, "Close TCP peer: %s:%s\n",
-								hdl->peer_id_str[fds_index[i]],
-								hdl->peer_sv_str[fds_index[i]]);
-							hdl->peer_num--;
-						}
-						/* Reset buffer */
-						hdl->tcp_index[fds_index[i]] = 0;
-					}
-				} else {
-					if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
-						/* Error occurs, so close this socket 	*/
-						if ((hdl->local_peer_sock != -1) &&
-							(fds[i].fd == hdl->local_peer_sock)) {
-							/* Close Local socket */
-							cef_log_write (CefC_Log_Warn,
-								"Receive error (%d) . Close Local socket\n", errno);
-							close (hdl->local_peer_sock);
-							hdl->local_peer_sock = -1;
-							cef_log_write (CefC_Log_Info, "Close Local peer\n");
-						} else {
-							/* Close TCP socket */
-							cef_log_write (CefC_Log_Warn,
-								"Receive error (%d) . Close tcp socket\n", errno);
-							cef_log_write (CefC_Log_Warn, "%s\n", strerror (errno));
-							if (hdl->tcp_fds[fds_index[i]] != -1) {
-								cef_log_write (CefC_Log_Warn, "Close TCP peer: %s:%s\n",
-									hdl->peer_id_str[fds_index[i]],
-									hdl->peer_sv_str[fds_index[i]]);
-								close (hdl->tcp_fds[fds_index[i]]);
-								hdl->tcp_fds[fds_index[i]] = -1;
-								hdl->peer_num--;
-							}
-							/* Reset buffer */
-							hdl->tcp_index[fds_index[i]] = 0;
-						}
-					}
+	if (err_f) {
+		/* Error occurs, so close this socket 	*/
+		if ((hdl->local_peer_sock != -1) && (fd == hdl->local_peer_sock)) {
+			/* Close Local socket */
+			close (hdl->local_peer_sock);
+			hdl->local_peer_sock = -1;
+			cef_log_write (CefC_Log_Info, "Close Local peer\n");
+		} else {
+			/* Close TCP socket */
+			if (hdl->tcp_fds[peer_idx] != -1) {
+				close (hdl->tcp_fds[peer_idx]);
+				hdl->tcp_fds[peer_idx] = -1;
+				cef_log_write (CefC_Log_Info, "Close TCP peer: %s:%s\n",
+					hdl->peer_id_str[peer_idx],
+					hdl->peer_sv_str[peer_idx]);
+				hdl->peer_num--;
+			}
+			/* Reset buffer */
+			hdl->tcp_index[peer_idx] = 0;
+		}
+		return;
+	}
+	if (in_f == 0) {
+		return;
+	}
+
+	len = recv (fd,
+		&hdl->tcp_buff[peer_idx][hdl->tcp_index[peer_idx]],
+		CefC_Cefnetd_Buff_Max - hdl->tcp_index[peer_idx], 0);
+	if (len > 0) {
+		/* receive message */
+		len += hdl->tcp_index[peer_idx];
+
+		len = csmgr_input_bytes_process (
+				hdl, peer_idx, fd, &hdl->tcp_buff[peer_idx][0], len);
+
+		/* set index */
+		if (len > 0) {
+			hdl->tcp_index[peer_idx] = len;
+		} else {
+			hdl->tcp_index[peer_idx] = 0;
+		}
+	} else if (len == 0) {
+		if ((hdl->local_peer_sock != -1) && (fd == hdl->local_peer_sock)) {
+			/* Close Local socket */
+			close (hdl->local_peer_sock);
+			hdl->local_peer_sock = -1;
+			cef_log_write (CefC_Log_Info, "Close Local peer\n");
+		} else {
+			/* Close TCP socket */
+			if (hdl->tcp_fds[peer_idx] != -1) {
+				close (hdl->tcp_fds[peer_idx]);
+				hdl->tcp_fds[peer_idx] = -1;
+				cef_log_write (CefC_Log_Info, "Close TCP peer: %s:%s\n",
+					hdl->peer_id_str[peer_idx],
+					hdl->peer_sv_str[peer_idx]);
+				hdl->peer_num--;
+			}
+			/* Reset buffer */
+			hdl->tcp_index[peer_idx] = 0;
+		}
+	} else {
+		if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+			/* Error occurs, so close this socket 	*/
+			if ((hdl->local_peer_sock != -1) && (fd == hdl->local_peer_sock)) {
+				/* Close Local socket */
+				cef_log_write (CefC_Log_Warn,
+					"Receive error (%d) . Close Local socket\n", errno);
+				close (hdl->local_peer_sock);
+				hdl->local_peer_sock = -1;
+				cef_log_write (CefC_Log_Info, "Close Local peer\n");
+			} else {
+				/* Close TCP socket */
+				cef_log_write (CefC_Log_Warn,
+					"Receive error (%d) . Close tcp socket\n", errno);
+				cef_log_write (CefC_Log_Warn, "%s\n", strerror (errno));
+				if (hdl->tcp_fds[peer_idx] != -1) {
+					cef_log_write (CefC_Log_Warn, "Close TCP peer: %s:%s\n",
+						hdl->peer_id_str[peer_idx],
+						hdl->peer_sv_str[peer_idx]);
+					close (hdl->tcp_fds[peer_idx]);
+					hdl->tcp_fds[peer_idx] = -1;
+					hdl->peer_num--;
 				}
+				/* Reset buffer */
+				hdl->tcp_index[peer_idx] = 0;
 			}
 		}
 	}
-	pthread_cond_signal (&csmgr_comn_buff_cond);		/* To avoid deadlock */
-	pthread_join (csmgrd_msg_process_th, &status);
-	pthread_join (csmgrd_expire_check_th, &status);
-	pthread_join (push_bytes_process_th, &status);
-	pthread_cond_destroy (&csmgr_comn_buff_cond);
+}
+/*--------------------------------------------------------------------------------------
+	Wakes up the main loop waiting in epoll_wait
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_event_wake (
+	void
+) {
+	uint64_t val = 1;
 
-	/* post process */
-	csmgrd_post_process (hdl);
-	cef_log_write (CefC_Log_Info, "Stop\n");
+	if (csmgrd_wake_fd == -1) {
+		return;
+	}
+	/* The eventfd is written only once until the main loop reads it 	*/
+	if (__atomic_exchange_n (&csmgrd_wake_f, 1, __ATOMIC_SEQ_CST) == 0) {
+		if (write (csmgrd_wake_fd, &val, sizeof (val)) < 0) {
+			/* NOP */;
+		}
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Closes the epoll instance and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_event_epoll_destroy (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+) {
+	int fd;
 
+	if (hdl->epfd != -1) {
+		close (hdl->epfd);
+		hdl->epfd = -1;
+	}
+	if (csmgrd_wake_fd != -1) {
+		/* The signal handler does not write the closed eventfd 	*/
+		fd = csmgrd_wake_fd;
+		csmgrd_wake_fd = -1;
+		close (fd);
+	}
+}
+#ifndef CefC_MACOS
+/*--------------------------------------------------------------------------------------
+	Creates the epoll instance and the eventfd of the main loop
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+csmgrd_event_epoll_init (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+) {
+	struct epoll_event ev;
+	int fd;
+	int i;
 
+	hdl->epfd = epoll_create1 (EPOLL_CLOEXEC);
+	if (hdl->epfd < 0) {
+		hdl->epfd = -1;
+		return (-1);
+	}
+	fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (fd < 0) {
+		csmgrd_event_epoll_destroy (hdl);
+		return (-1);
+	}
 
-	return;
+	/* The message process thread writes the eventfd when it makes room in the 	*/
+	/* ring of a held peer, and the signal handler writes it to stop the loop 	*/
+	csmgrd_wake_f = 0;
+	memset (&ev, 0, sizeof (ev));
+	ev.events 	= EPOLLIN;
+	ev.data.u64 = CsmgrdC_Event_Data (fd, CsmgrdC_Event_Wake);
+	if (epoll_ctl (hdl->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		close (fd);
+		csmgrd_event_epoll_destroy (hdl);
+		return (-1);
+	}
+	csmgrd_wake_fd = fd;
+
+	/* The listen sockets are accepted as they become ready 	*/
+	ev.data.u64 = CsmgrdC_Event_Data (hdl->local_listen_fd, CsmgrdC_Event_Local_Listen);
+	if (epoll_ctl (hdl->epfd, EPOLL_CTL_ADD, hdl->local_listen_fd, &ev) < 0) {
+		csmgrd_event_epoll_destroy (hdl);
+		return (-1);
+	}
+	ev.data.u64 = CsmgrdC_Event_Data (hdl->tcp_listen_fd, CsmgrdC_Event_Tcp_Listen);
+	if (epoll_ctl (hdl->epfd, EPOLL_CTL_ADD, hdl->tcp_listen_fd, &ev) < 0) {
+		csmgrd_event_epoll_destroy (hdl);
+		return (-1);
+	}
+
+	/* The sockets of the peers are registered by csmgrd_event_peer_update 	*/
+	for (i = 0 ; i < CsmgrdC_Max_Sock_Num ; i++) {
+		hdl->ev_fds[i] 	  = -1;
+		hdl->ev_events[i] = 0;
+	}
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Registers the sockets of the peers which have changed
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_event_peer_update (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+) {
+	struct epoll_event ev;
+	uint32_t events;
+	int fd;
+	int op;
+	int i;
+
+	for (i = 0 ; i < CsmgrdC_Max_Sock_Num ; i++) {
+		fd = (i == 0) ? hdl->local_peer_sock : hdl->tcp_fds[i];
+		if (fd == -1) {
+			/* The closed socket has left the epoll instance 	*/
+			hdl->ev_fds[i] = -1;
+			continue;
+		}
+		/* A peer whose Upload Requests wait for the room of the ring is read	*/
+		/* while its receive buffer has room for a message. Otherwise the 		*/
+		/* socket buffer fills and cefnetd holds the messages back.				*/
+		events = (csmgrd_peer_recv_ready (hdl, i)) ? EPOLLIN : 0;
+		if (fd != hdl->ev_fds[i]) {
+			op = EPOLL_CTL_ADD;
+		} else if (events != hdl->ev_events[i]) {
+			op = EPOLL_CTL_MOD;
+		} else {
+			continue;
+		}
+		memset (&ev, 0, sizeof (ev));
+		ev.events 	= events;
+		ev.data.u64 = CsmgrdC_Event_Data (fd, i);
+		if (epoll_ctl (hdl->epfd, op, fd, &ev) < 0) {
+			cef_log_write (CefC_Log_Warn,
+				"Failed to watch the FD#%d (%s)\n", fd, strerror (errno));
+			continue;
+		}
+		hdl->ev_fds[i] 	  = fd;
+		hdl->ev_events[i] = events;
+	}
 }
+/*--------------------------------------------------------------------------------------
+	Main loop with epoll
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_event_epoll_dispatch (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+) {
+	struct epoll_event evs[CsmgrdC_Event_Max];
+	uint64_t val;
+	int res;
+	int i;
+	int fd;
+	int idx;
+
+	cef_log_write (CefC_Log_Info, "Uses epoll for the main loop\n");
+
+	while (csmgrd_running_f) {
+
+		/* Resumes the peers which waited for the room of the ring 	*/
+		csmgrd_cob_ring_resume (hdl);
 
+		/* Watches the peers which have been accepted or changed their room 	*/
+		csmgrd_event_peer_update (hdl);
+
+		/* Waits for the sockets, the message process thread or a signal 	*/
+		res = epoll_wait (hdl->epfd, evs, CsmgrdC_Event_Max, -1);
+
+		for (i = 0 ; i < res ; i++) {
+			fd  = CsmgrdC_Event_Fd (evs[i].data.u64);
+			idx = CsmgrdC_Event_Index (evs[i].data.u64);
+
+			if (idx == CsmgrdC_Event_Wake) {
+				/* Cleared first so that a later wake writes the eventfd again 	*/
+				__atomic_store_n (&csmgrd_wake_f, 0, __ATOMIC_SEQ_CST);
+				if (read (fd, &val, sizeof (val)) < 0) {
+					/* NOP */;
+				}
+				continue;
+			}
+			if (idx == CsmgrdC_Event_Local_Listen) {
+				csmgrd_local_sock_check (hdl);
+				continue;
+			}
+			if (idx == CsmgrdC_Event_Tcp_Listen) {
+				csmgrd_tcp_connect_accept (hdl);
+				continue;
+			}
+
+			/* The peer may have been closed by the earlier event 	*/
+			if (fd != ((idx == 0) ? hdl->local_peer_sock : hdl->tcp_fds[idx])) {
+				continue;
+			}
+			csmgrd_peer_input_process (hdl, fd, idx,
+				(evs[i].events & EPOLLIN) ? 1 : 0,
+				(evs[i].events & (EPOLLERR | EPOLLHUP)) ? 1 : 0);
+
+			/* A socket accepted later in this round may reuse the number 	*/
+			if (fd != ((idx == 0) ? hdl->local_peer_sock : hdl->tcp_fds[idx])) {
+				hdl->ev_fds[idx] = -1;
+			}
+		}
+	}
+}
+#endif // CefC_MACOS
 /*--------------------------------------------------------------------------------------
 	function for processing the received message
 ----------------------------------------------------------------------------------------*/
@@ -1146,31 +1445,48 @@ csmgrd_msg_process_thread (
 	void* arg
 ) {
 	CefT_Csmgrd_Handle* hdl = (CefT_Csmgrd_Handle*) arg;
+	CsmgrdT_Cob_Ring* ring;
+	uint32_t pos;
+	uint32_t len;
+	int next = 0;
+	int i;
 
+	pthread_mutex_lock (&csmgr_cob_ring_mutex);
 	while (csmgrd_running_f) {
-		pthread_mutex_lock (&csmgr_comn_buff_mutex);
-		pthread_cond_wait (&csmgr_comn_buff_cond, &csmgr_comn_buff_mutex);
-
-		if (csmgr_comn_cob_buff_idx > 0) {
-			if (CsmgrC_Buff_Max - csmgr_proc_cob_buff_idx >
-				csmgr_comn_cob_buff_idx) {
-
-				memcpy (
-					&csmgr_proc_cob_buff[csmgr_proc_cob_buff_idx],
-					&csmgr_comn_cob_buff[0],
-					csmgr_comn_cob_buff_idx);
-				csmgr_proc_cob_buff_idx += csmgr_comn_cob_buff_idx;
+		/* Selects the rings in turn not to starve the other peers 	*/
+		ring = NULL;
+		for (i = 0 ; i < CsmgrdC_Max_Sock_Num ; i++) {
+			if (hdl->cob_ring[next].head != hdl->cob_ring[next].tail) {
+				ring = &hdl->cob_ring[next];
 			}
-			csmgr_comn_cob_buff_idx = 0;
+			next = (next + 1) % CsmgrdC_Max_Sock_Num;
+			if (ring) {
+				break;
+			}
+		}
+		if (ring == NULL) {
+			pthread_cond_wait (&csmgr_cob_ring_cond, &csmgr_cob_ring_mutex);
+			continue;
+		}
+		if ((ring->head < ring->tail) && (ring->tail == ring->wrap)) {
+			ring->tail = 0;
 		}
-		pthread_mutex_unlock (&csmgr_comn_buff_mutex);
+		pos = ring->tail;
+		len = (ring->head >= ring->tail) ? ring->head - pos : ring->wrap - pos;
+		pthread_mutex_unlock (&csmgr_cob_ring_mutex);
+
+		/* The receiving thread does not write to [tail, head) 	*/
+		hdl->cs_mod_int->cache_item_puts (&ring->buff[pos], (int) len);
+
+		pthread_mutex_lock (&csmgr_cob_ring_mutex);
+		ring->tail = pos + len;
 
-		if (csmgr_proc_cob_buff_idx > 0) {
-			hdl->cs_mod_int->cache_item_puts (
-							csmgr_proc_cob_buff, csmgr_proc_cob_buff_idx);
-			csmgr_proc_cob_buff_idx = 0;
+		/* The main loop reads the peer held for the room of the ring again 	*/
+		if (ring->wait_f) {
+			csmgrd_event_wake ();
 		}
 	}
+	pthread_mutex_unlock (&csmgr_cob_ring_mutex);
 
 	pthread_exit (NULL);
 
@@ -1207,29 +1523,13 @@ csmgrd_expire_check_thread (
 
 	return ((void*) NULL);
 }
-/*--------------------------------------------------------------------------------------
-	function for processing buffering messages
-----------------------------------------------------------------------------------------*/
-static void*
-push_bytes_process_thread (
-	void* arg
-) {
-
-	while (csmgrd_running_f) {
-		usleep (csmgr_wait_time);
-		csmgr_push_bytes_process ();
-	}
-
-	pthread_exit (NULL);
-
-	return ((void*) NULL);
-}
 /*--------------------------------------------------------------------------------------
 	Get frame from received message
 ----------------------------------------------------------------------------------------*/
 static int							/* The return value is negative if an error occurs	*/
 csmgr_input_bytes_process (
 	CefT_Csmgrd_Handle* hdl,				/* CS Manager Handle						*/
+	int peer_idx,							/* index of the peer						*/
 	int peer_fd,
 	unsigned char* buff,					/* receive message							*/
 	int buff_len							/* message length							*/
@@ -1237,7 +1537,7 @@ csmgr_input_bytes_process (
 	int index = 0;
 	uint16_t len;
 	uint16_t value16;
-	int rec_buff_len = buff_len;
+	int held = 0;							/* Upload Requests kept at the top			*/
 	int res;
 
 	while (buff_len > CefC_Csmgr_Msg_HeaderLen) {
@@ -1299,28 +1599,17 @@ csmgr_input_bytes_process (
 				goto SKIP;
 			}
 			pthread_mutex_unlock (&csmgr_Lack_of_resources_mutex);
-			if (pthread_mutex_trylock (&csmgr_main_cob_buff_mutex) != 0) {
-				goto SKIP;
-			}
-			if (csmgr_main_cob_buff_idx + len > CsmgrC_Buff_Size) {
-				pthread_mutex_lock (&csmgr_comn_buff_mutex);
-
-				memcpy (
-					csmgr_comn_cob_buff,
-					csmgr_main_cob_buff,
-					csmgr_main_cob_buff_idx);
-				csmgr_comn_cob_buff_idx = csmgr_main_cob_buff_idx;
-				csmgr_main_cob_buff_idx = 0;
-
-				pthread_cond_signal (&csmgr_comn_buff_cond);
-				pthread_mutex_unlock (&csmgr_comn_buff_mutex);
+			/* Once an Upload Request is held, the later ones are held too so 	*/
+			/* that the Cobs are cached in the order of arrival. The other 		*/
+			/* messages are still processed.									*/
+			if ((held > 0) ||
+				(csmgrd_cob_ring_put (&hdl->cob_ring[peer_idx], &buff[index], len) < 0)) {
+				hdl->cob_ring[peer_idx].wait_f = 1;
+				if (index != held) {
+					memmove (&buff[held], &buff[index], len);
+				}
+				held += len;
 			}
-			memcpy (
-				&csmgr_main_cob_buff[csmgr_main_cob_buff_idx],
-				&buff[index], len);
-
-			csmgr_main_cob_buff_idx += len;
-			pthread_mutex_unlock (&csmgr_main_cob_buff_mutex);
 		}
 
 SKIP:;
@@ -1328,38 +1617,96 @@ SKIP:;
 		index += len;
 	}
 
-	if (index < rec_buff_len) {
-		memmove (&buff[0], &buff[index], buff_len);
+	if ((buff_len > 0) && (index != held)) {
+		memmove (&buff[held], &buff[index], buff_len);
 	}
-	return (buff_len);
+	return (held + buff_len);
 }
 /*--------------------------------------------------------------------------------------
-	Push the buffered messages to proc thread buffer
+	Appends the Upload Request message to the ring of the peer
 ----------------------------------------------------------------------------------------*/
-static void
-csmgr_push_bytes_process (
-	void
+static int							/* -1 if the ring has no room						*/
+csmgrd_cob_ring_put (
+	CsmgrdT_Cob_Ring* ring,					/* ring of the peer							*/
+	unsigned char* msg,						/* Upload Request message					*/
+	int msg_len								/* message length							*/
 ) {
-	pthread_mutex_lock (&csmgr_main_cob_buff_mutex);
+	uint32_t len = (uint32_t) msg_len;
+	uint32_t pos;
 
-	if (csmgr_main_cob_buff_idx > 0) {
+	if (ring->buff == NULL) {
+		ring->buff = (unsigned char*) malloc (sizeof (unsigned char) * CsmgrdC_Cob_Ring_Size);
+		if (ring->buff == NULL) {
+			cef_log_write (CefC_Log_Error, "Failed to allocation cob ring\n");
+			return (-1);
+		}
+	}
 
-		pthread_mutex_lock (&csmgr_comn_buff_mutex);
+	pthread_mutex_lock (&csmgr_cob_ring_mutex);
+	if (ring->head == ring->tail) {
+		/* The message process thread does not hold the empty ring 	*/
+		ring->head = 0;
+		ring->tail = 0;
+	}
+	/* head never reaches tail so that head == tail means empty 	*/
+	if (ring->head >= ring->tail) {
+		if (CsmgrdC_Cob_Ring_Size - ring->head >= len) {
+			pos = ring->head;
+		} else if (ring->tail > len) {
+			ring->wrap = ring->head;
+			pos = 0;
+		} else {
+			ring->wait_f = 1;
+			pthread_mutex_unlock (&csmgr_cob_ring_mutex);
+			return (-1);
+		}
+	} else {
+		if (ring->tail - ring->head > len) {
+			pos = ring->head;
+		} else {
+			ring->wait_f = 1;
+			pthread_mutex_unlock (&csmgr_cob_ring_mutex);
+			return (-1);
+		}
+	}
+	memcpy (&ring->buff[pos], msg, len);
+	ring->head = pos + len;
 
-		if (csmgr_main_cob_buff_idx  > 0) {
-			memcpy (
-				csmgr_comn_cob_buff,
-				csmgr_main_cob_buff,
-				csmgr_main_cob_buff_idx);
+	pthread_cond_signal (&csmgr_cob_ring_cond);
+	pthread_mutex_unlock (&csmgr_cob_ring_mutex);
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Processes the messages left in the receive buffer of the peers which waited
+	for the room of the ring
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_cob_ring_resume (
+	CefT_Csmgrd_Handle* hdl						/* csmgr daemon handle					*/
+) {
+	int fd;
+	int len;
+	int i;
 
-			csmgr_comn_cob_buff_idx = csmgr_main_cob_buff_idx;
-			csmgr_main_cob_buff_idx = 0;
+	for (i = 0 ; i < CsmgrdC_Max_Sock_Num ; i++) {
+		if (hdl->cob_ring[i].wait_f == 0) {
+			continue;
 		}
+		/* Cleared under the lock which the message process thread reads it in 	*/
+		pthread_mutex_lock (&csmgr_cob_ring_mutex);
+		hdl->cob_ring[i].wait_f = 0;
+		pthread_mutex_unlock (&csmgr_cob_ring_mutex);
 
-		pthread_cond_signal (&csmgr_comn_buff_cond);
-		pthread_mutex_unlock (&csmgr_comn_buff_mutex);
+		fd = (i == 0) ? hdl->local_peer_sock : hdl->tcp_fds[i];
+		if ((fd == -1) || (hdl->tcp_index[i] == 0)) {
+			continue;
+		}
+		/* wait_f is set again if the ring is still full 	*/
+		len = csmgr_input_bytes_process (
+				hdl, i, fd, &hdl->tcp_buff[i][0], hdl->tcp_index[i]);
+		hdl->tcp_index[i] = (len > 0) ? len : 0;
 	}
-	pthread_mutex_unlock (&csmgr_main_cob_buff_mutex);
 
 	return;
 }
@@ -1477,6 +1824,9 @@ csmgrd_handle_destroy (
 		}
 		return;
 	}
+	/* Close the epoll instance of the main loop */
+	csmgrd_event_epoll_destroy (hdl);
+
 	/* Close local listen socket */
 	if (hdl->local_listen_fd != -1) {
 		close (hdl->local_listen_fd);
@@ -1562,11 +1912,10 @@ csmgrd_handle_destroy (
 	if (strlen (csmgr_local_sock_name) != 0) {
 		unlink (csmgr_local_sock_name);
 	}
-	if (csmgr_main_cob_buff) {
-		free (csmgr_main_cob_buff);
-	}
-	if (csmgr_comn_cob_buff) {
-		free (csmgr_comn_cob_buff);
+	for (i = 0 ; i < CsmgrdC_Max_Sock_Num ; i++) {
+		if (hdl->cob_ring[i].buff) {
+			free (hdl->cob_ring[i].buff);
+		}
 	}
 	free (hdl);
 	*csmgrd_hdl = NULL;
@@ -1678,6 +2027,8 @@ csmgrd_config_read (
 			if (!(strcmp (conf_param->cs_mod_name, "filesystem") == 0
 				    ||
 				  strcmp (conf_param->cs_mod_name, "memory") == 0
+				    ||
+				  strcmp (conf_param->cs_mod_name, "segment") == 0
 #ifdef CefC_Db
 				    ||
 				  strcmp (conf_param->cs_mod_name, "db") == 0
@@ -1719,7 +2070,8 @@ csmgrd_config_read (
 		}
 	}
 
-	if (strcmp (conf_param->cs_mod_name, "filesystem") == 0) {
+	if ((strcmp (conf_param->cs_mod_name, "filesystem") == 0) ||
+		(strcmp (conf_param->cs_mod_name, "segment") == 0)) {
 		if (!(    access (conf_param->fsc_cache_path, F_OK) == 0
 			   && access (conf_param->fsc_cache_path, R_OK) == 0
 	   		   && access (conf_param->fsc_cache_path, W_OK) == 0
@@ -2117,9 +2469,13 @@ csmgrd_poll_socket_prepare (
 	int set_num = 0;
 	int i;
 
+	/* A peer whose Upload Requests wait for the room of the ring is read while	*/
+	/* its receive buffer has room for a message. Otherwise the socket buffer	*/
+	/* fills and cefnetd holds the messages back.								*/
 	if (hdl->local_peer_sock != -1) {
 		fds[set_num].fd     = hdl->local_peer_sock;
-		fds[set_num].events = POLLIN | POLLERR;
+		fds[set_num].events = (csmgrd_peer_recv_ready (hdl, 0)) ?
+										POLLIN | POLLERR : POLLERR;
 		fds_index[set_num]  = 0;
 		set_num++;
 	}
@@ -2127,7 +2483,8 @@ csmgrd_poll_socket_prepare (
 	for (i = 1 ; i < CsmgrdC_Max_Sock_Num ; i++) {
 		if (hdl->tcp_fds[i] != -1) {
 			fds[set_num].fd     = hdl->tcp_fds[i];
-			fds[set_num].events = POLLIN | POLLERR;
+			fds[set_num].events = (csmgrd_peer_recv_ready (hdl, i)) ?
+										POLLIN | POLLERR : POLLERR;
 			fds_index[set_num]  = i;
 			set_num++;
 		}
@@ -2135,6 +2492,21 @@ csmgrd_poll_socket_prepare (
 
 	return (set_num);
 }
+/*--------------------------------------------------------------------------------------
+	Checks whether the receive buffer of the peer has room to receive
+----------------------------------------------------------------------------------------*/
+static int									/* 1 if the peer can be read				*/
+csmgrd_peer_recv_ready (
+	CefT_Csmgrd_Handle* hdl,					/* csmgr daemon handle					*/
+	int peer_idx								/* index of the peer					*/
+) {
+	int room = CefC_Cefnetd_Buff_Max - hdl->tcp_index[peer_idx];
+
+	if (hdl->cob_ring[peer_idx].wait_f) {
+		return ((room >= CefC_Max_Length) ? 1 : 0);
+	}
+	return ((room > 0) ? 1 : 0);
+}
 /*--------------------------------------------------------------------------------------
 	Handles the received message(s)
 ----------------------------------------------------------------------------------------*/
@@ -2154,6 +2526,13 @@ csmgrd_input_message_process (
 			csmgrd_incoming_interest (hdl, sock, msg, msg_len, type);
 			break;
 		}
+		case CefC_Csmgr_Msg_Type_Bulk_Interest: {
+#ifdef CefC_Debug
+			cef_dbg_write (CefC_Dbg_Finest, "Receive the Bulk Interest Message\n");
+#endif // CefC_Debug
+			csmgrd_incoming_bulk_interest (hdl, sock, msg, msg_len);
+			break;
+		}
 
 		case CefC_Csmgr_Msg_Type_Ccninfo: {
 #ifdef CefC_Debug
@@ -2397,6 +2776,124 @@ cef_csmgr_interest_msg_parse (
 	return (0);
 }
 
+/*--------------------------------------------------------------------------------------
+	Incoming Bulk Interest Message
+----------------------------------------------------------------------------------------*/
+static void
+csmgrd_incoming_bulk_interest (
+	CefT_Csmgrd_Handle* hdl,					/* csmgr daemon handle					*/
+	int sock,									/* recv socket							*/
+	unsigned char* buff,						/* receive message						*/
+	int buff_len								/* receive message length				*/
+) {
+	int res;
+	unsigned char name[CefC_Max_Msg_Size] = {0};
+	uint16_t name_len;
+	uint32_t first_chunk;
+	uint64_t chunk_map;
+	uint8_t int_type;
+	unsigned char ver[CefC_Max_Msg_Size] = {0};
+	uint16_t ver_len = 0;
+	uint32_t i;
+
+	/* Parses the csmgr Bulk Interest message */
+	res = cef_csmgr_bulk_interest_msg_parse (
+			buff, buff_len, &int_type, name, &name_len,
+			&first_chunk, &chunk_map, ver, &ver_len);
+	if (res < 0) {
+#ifdef CefC_Debug
+		cef_dbg_write (CefC_Dbg_Fine, "Parse message error (bulk interest)\n");
+#endif // CefC_Debug
+		return;
+	}
+	if (int_type != CefC_Csmgr_Interest_Type_Normal) {
+		return;
+	}
+
+	/* The Cobs found by the plugin are returned to cefnetd by one write 	*/
+	csmgrd_plugin_cob_batch_begin (sock);
+	for (i = 0 ; i < CefC_Csmgr_Bulk_Interest_Map_Bits ; i++) {
+		if ((chunk_map & (1ULL << i)) == 0) {
+			continue;
+		}
+		if (first_chunk + i < first_chunk) {
+			break;
+		}
+		csmgrd_stat_request_count_update (stat_hdl, name, name_len);
+		hdl->cs_mod_int->cache_item_get (
+				name, name_len, first_chunk + i, sock, ver, ver_len);
+	}
+	csmgrd_plugin_cob_batch_end (sock);
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Parse Bulk Interest message
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+cef_csmgr_bulk_interest_msg_parse (
+	unsigned char buff[],						/* receive message						*/
+	int buff_len,								/* receive message length				*/
+	uint8_t* int_type,							/* Interest type						*/
+	unsigned char name[],						/* Content Name							*/
+	uint16_t* name_len,							/* Length of content name				*/
+	uint32_t* first_chunk,						/* Chunk number of bit 0 of chunk_map	*/
+	uint64_t* chunk_map,						/* Bitmap of the requested chunks		*/
+	unsigned char ver[],						/* Content Version						*/
+	uint16_t* ver_len							/* Length of content version			*/
+) {
+	int res;
+	uint16_t index = 0;
+	uint32_t value32;
+	uint64_t value64;
+	uint16_t value16;
+
+	/* get Interest Type */
+	if (buff_len < sizeof (uint8_t)) {
+		return (-1);
+	}
+	*int_type = buff[index];
+	index += sizeof (uint8_t);
+
+	/* get cob name */
+	res = cef_csmgr_cob_name_parse (buff, buff_len, &index, name, name_len);
+	if ((res < 0) || (*name_len == 0)) {
+#ifdef CefC_Debug
+		cef_dbg_write (CefC_Dbg_Fine, "Cob name parse error\n");
+#endif // CefC_Debug
+		return (-1);
+	}
+
+	/* get the first chunk number and the bitmap of the chunks */
+	if ((buff_len - index - CefC_S_ChunkNum - (int) sizeof (uint64_t)
+			- CefC_S_Length) < 0) {
+#ifdef CefC_Debug
+		cef_dbg_write (CefC_Dbg_Fine, "Chunk map parse error\n");
+#endif // CefC_Debug
+		return (-1);
+	}
+	memcpy (&value32, buff + index, CefC_S_ChunkNum);
+	*first_chunk = ntohl (value32);
+	index += CefC_S_ChunkNum;
+	memcpy (&value64, buff + index, sizeof (uint64_t));
+	*chunk_map = cef_client_ntohb (value64);
+	index += sizeof (uint64_t);
+
+	/* get version */
+	memcpy (&value16, buff + index, sizeof (uint16_t));
+	*ver_len = ntohs (value16);
+	index += sizeof (uint16_t);
+	if ((buff_len - index - *ver_len) < 0) {
+		return (-1);
+	}
+	if (*ver_len) {
+		memcpy (ver, buff + index, *ver_len);
+		index += *ver_len;
+	}
+
+	return (0);
+}
+
 /*--------------------------------------------------------------------------------------
 	Incoming Get Status Message
 ----------------------------------------------------------------------------------------*/
@@ -4248,6 +4745,7 @@ csmgrd_incoming_rcch_msg (
 				return;
 			}
 			rcd->cob_map = (uint64_t *)ptr;
+			rcd->sum_map = NULL;
 			for ( map_idx = 0; map_idx < rcd->map_num; map_idx++ ) {
 				memcpy (ptr, cob_map[map_idx].cob_map, sizeof (uint64_t) * CsmgrT_Add_Maps);
 				ptr += (sizeof (uint64_t) * CsmgrT_Add_Maps);
@@ -4332,9 +4830,8 @@ OUT_COBMAP_LOOP:
 	uint16_t name_len;
 	unsigned char range[1024] = {0};
 	uint16_t range_len;
-	int s_val, e_val, val, sidx, eidx, i, n, st, ed;
-	uint64_t mask;
-	int find_f = 0;
+	int s_val, e_val, val, st, ed;
+	uint32_t seq;
 	char info[CefC_Max_Length] = {0};
 	int info_rem_size = sizeof (info) - 1; /* -1 for EOS */
 	char tmp_str[32] = {0};
@@ -4404,9 +4901,7 @@ OUT_COBMAP_LOOP:
 			} else if (s_val < rcd->min_seq) {
 				s_val = rcd->min_seq;
 			}
-			sidx = s_val / 64;
 		} else {
-			sidx = rcd->min_seq / 64;
 			s_val = rcd->min_seq;
 		}
 		if (e_val != -1) {
@@ -4418,67 +4913,41 @@ OUT_COBMAP_LOOP:
 				csmgrd_rcch_response_send (sock, CcoreC_Failed, (unsigned char*)info);
 				return;
 			} else if (e_val > rcd->max_seq) {
-				eidx = rcd->max_seq;
+				e_val = rcd->max_seq;
 			}
-			eidx = (e_val / 64) + 1;
 		} else {
-			eidx = (rcd->max_seq / 64) + 1;
 			e_val = rcd->max_seq;
 		}
-		st = ed = s_val;
-		for (i = sidx; i < eidx; i++) {
-			if ((rcd->map_max-1) >= i /*&& rcd->cob_map[i]*/) {
-				mask = 0x0000000000000001;
-				for (n = 0 ; n < 64 ; n++) {
-					val = i * 64 + n;
-					if (rcd->cob_map[i] & mask &&
-						(s_val <= val && val <= e_val)) {
-						if (find_f == 0) {
-							find_f = 1;
-							st = val;
-							sprintf (tmp_str, "%d", st);
-							len = strlen ((char*)tmp_str);
-							info_rem_size -= (int)len;
-							if (info_rem_size < 0) {
-								goto OUT_COBMAP_LOOP;
-							}
-							memcpy (wp, tmp_str, len);
-							wp = wp + len;
-						}
-					} else {
-						if (find_f == 1) {
-							find_f = 0;
-							ed = val - 1;
-							if (st < ed)
-								sprintf (tmp_str, ":%d,", ed);
-							else
-								sprintf (tmp_str, ",");
-							len = strlen ((char*)tmp_str);
-							info_rem_size -= (int)len;
-							if (info_rem_size < 0) {
-								goto OUT_COBMAP_LOOP;
-							}
-							memcpy (wp, tmp_str, len);
-							wp = wp + len;
-						}
-						if (val > e_val)
-							goto OUT_COBMAP_LOOP;
-					}
-					mask <<= 1;
-				}
+		/* Walk the cached runs in [s_val, e_val] as "st:ed," entries	*/
+		val = s_val;
+		while (val <= e_val) {
+			if (csmgr_stat_cob_next_cached_get (rcd, (uint32_t) val, &seq) < 0 ||
+				seq > (uint32_t) e_val) {
+				break;
+			}
+			st = (int) seq;
+			if (csmgr_stat_cob_next_missing_get (rcd, seq, &seq) < 0 ||
+				seq > (uint32_t) e_val) {
+				ed = e_val;
+			} else {
+				ed = (int) seq - 1;
+			}
+			if (st < ed) {
+				sprintf (tmp_str, "%d:%d,", st, ed);
+			} else {
+				sprintf (tmp_str, "%d,", st);
 			}
-		}
-OUT_COBMAP_LOOP:
-		if (find_f == 1) {
-			if (st < e_val)
-				sprintf (tmp_str, ":%d,", e_val);
-			else
-				sprintf (tmp_str, ",");
 			len = strlen ((char*)tmp_str);
 			info_rem_size -= (int)len;
-			if (info_rem_size >= 0) {
-				memcpy (wp, tmp_str, len);
+			if (info_rem_size < 0) {
+				break;
+			}
+			memcpy (wp, tmp_str, len);
+			wp = wp + len;
+			if (ed == e_val) {
+				break;
 			}
+			val = ed + 1;
 		}
 #ifdef CefC_Debug
 		cef_dbg_write (CefC_Dbg_Fine, "Retrieve Cache Chunk.\n");
@@ -4961,6 +5430,8 @@ csmgrd_sigcatch (
 ) {
 	if ((sig == SIGINT) || (sig == SIGTERM)) {
 		csmgrd_running_f = 0;
+		/* The signal may be caught by a thread other than the main loop 	*/
+		csmgrd_event_wake ();
 	}
 	return;
 }
@@ -5083,7 +5554,8 @@ csmgrd_resource_mon_thread (
 				}
 			}
 		}
-		else if (strcmp (hdl->cs_mod_name, "filesystem") == 0) {
+		else if ((strcmp (hdl->cs_mod_name, "filesystem") == 0) ||
+				 (strcmp (hdl->cs_mod_name, "segment") == 0)) {
 			if (max_cob_limit == 0) {
 				if (m_used > CSMGR_MAXIMUM_MEM_USAGE_FOR_FILE) {
 					Lack_of_M_resources = 1;
@@ -5103,7 +5575,9 @@ csmgrd_resource_mon_thread (
 				}
 			}
 
-			if (f_used > CSMGR_MAXIMUM_FILE_USAGE_FOR_FILE) {
+			/* The segment cache allocates its files when it starts 	*/
+			if ((strcmp (hdl->cs_mod_name, "filesystem") == 0) &&
+				(f_used > CSMGR_MAXIMUM_FILE_USAGE_FOR_FILE)) {
 				Lack_of_F_resources = 1;
 				file_out = 1;
 			} else {
@@ -5592,6 +6066,7 @@ if (!rcd) {
 			return;
 		}
 		rcd->cob_map = (uint64_t *)ptr;
+		rcd->sum_map = NULL;
 		for ( map_idx = 0; map_idx < rcd->map_num; map_idx++ ) {
 			memcpy (ptr, cob_map[map_idx].cob_map, sizeof (uint64_t) * CsmgrT_Add_Maps);
 			ptr += (sizeof (uint64_t) * CsmgrT_Add_Maps);
@@ -54,6 +54,18 @@
 /* Macros for csmgrd status										*/
 /*------------------------------------------------------------------*/
 #define CsmgrdC_Max_Sock_Num		32					/* Max number of TCP peer		*/
+#define CsmgrdC_Cob_Ring_Size		CsmgrC_Buff_Size	/* Size of the ring of the		*/
+														/* Cobs from a peer				*/
+
+/* Index field of the epoll event data of the sockets which are not peers 	*/
+#define CsmgrdC_Event_Local_Listen	CsmgrdC_Max_Sock_Num		/* local listen	*/
+#define CsmgrdC_Event_Tcp_Listen	(CsmgrdC_Max_Sock_Num + 1)	/* TCP listen	*/
+#define CsmgrdC_Event_Wake			(CsmgrdC_Max_Sock_Num + 2)	/* eventfd		*/
+#define CsmgrdC_Event_Max			(CsmgrdC_Max_Sock_Num + 3)	/* Events returned	*/
+																/* by epoll_wait	*/
+#define CsmgrdC_Event_Data(fd, idx)	(((uint64_t)(fd) << 32) | (uint32_t)(idx))
+#define CsmgrdC_Event_Fd(data)		((int)((data) >> 32))
+#define CsmgrdC_Event_Index(data)	((int)((data) & 0xFFFFFFFF))
 
 /* Library name				*/
 #ifdef __APPLE__
@@ -88,6 +100,22 @@ typedef struct CsmgrT_White_List {
 } CsmgrT_White_List;
 
 
+/***** Ring of the Cobs received from a peer 		*****/
+/* The receiving thread appends the framed Upload Request messages to [tail, head)	*/
+/* and the message process thread passes the messages to the plugin in place. 		*/
+/* The messages are never split at the end of the buffer. When head wraps, the 	*/
+/* data behind head ends at wrap.													*/
+typedef struct {
+
+	unsigned char* 		buff;
+	uint32_t 			head;				/* next position to write 					*/
+	uint32_t 			tail;				/* next position to pass to the plugin 		*/
+	uint32_t 			wrap;				/* end of the data when head < tail 		*/
+	int 				wait_f;				/* 1 if Upload Requests of the peer are held*/
+											/* until the ring has room 					*/
+
+} CsmgrdT_Cob_Ring;
+
 typedef struct {
 	
 	char 				launched_user_name[CefC_Csmgr_User_Len];
@@ -107,12 +135,20 @@ typedef struct {
 	char				peer_id_str[CsmgrdC_Max_Sock_Num][NI_MAXHOST];
 	char				peer_sv_str[CsmgrdC_Max_Sock_Num][NI_MAXSERV];
 	int 				peer_num;
+	CsmgrdT_Cob_Ring 	cob_ring[CsmgrdC_Max_Sock_Num];
 	
 	/********** Local listen socket 	***********/
 	int 				local_listen_fd;
 	char 				local_sock_name[1024];
 	int					local_peer_sock;
 	
+	/********** Event loop (epoll) 		***********/
+	int 				epfd;					/* epoll instance (-1: poll is used) 	*/
+	int 				ev_fds[CsmgrdC_Max_Sock_Num];
+												/* sockets of the peers being watched	*/
+	uint32_t 			ev_events[CsmgrdC_Max_Sock_Num];
+												/* events watched for the peers			*/
+	
 	/********** load functions			***********/
 	CsmgrdT_Plugin_Interface* cs_mod_int;		/* plugin interface						*/
 	char			cs_mod_name[CsmgrdC_Max_Plugin_Name_Len];
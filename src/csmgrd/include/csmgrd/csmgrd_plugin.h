@@ -194,6 +194,20 @@ csmgrd_plugin_cob_msg_send (
 	unsigned char* msg,						/* send message								*/
 	uint16_t msg_len						/* message length							*/
 );
+/*--------------------------------------------------------------------------------------
+	Starts queuing the Cobs sent to the socket by csmgrd_plugin_cob_msg_send
+----------------------------------------------------------------------------------------*/
+int									/* The return value is negative if an error occurs	*/
+csmgrd_plugin_cob_batch_begin (
+	int fd									/* socket fd								*/
+);
+/*--------------------------------------------------------------------------------------
+	Sends the queued Cobs with one write and stops queuing
+----------------------------------------------------------------------------------------*/
+void
+csmgrd_plugin_cob_batch_end (
+	int fd									/* socket fd								*/
+);
 /*--------------------------------------------------------------------------------------
 	Sets APIs for cache algorithm library
 ----------------------------------------------------------------------------------------*/
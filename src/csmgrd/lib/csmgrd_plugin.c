@@ -59,6 +59,8 @@
 
 #define	DEMO_RETRY_NUM	10
 
+#define	CSMGRD_PLUGIN_BATCH_SIZE		(CefC_Max_Length * 2)
+
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
@@ -70,6 +72,11 @@ static char log_proc[256] = {0};
 static int 	log_lv = 0;
 static char log_lv_str[4][16] = {"INFO", "WARNING", "ERROR", "CRITICAL"};
 
+/* Cobs queued by csmgrd_plugin_cob_batch_begin (per thread) 	*/
+static __thread unsigned char* cob_batch_buff = NULL;
+static __thread int 	cob_batch_fd 	= -1;
+static __thread int 	cob_batch_len 	= 0;
+
 #ifdef CefC_Debug
 static char dbg_proc[256] = {0};
 static int 	dbg_lv = CefC_Dbg_None;
@@ -79,6 +86,13 @@ static int 	dbg_lv = CefC_Dbg_None;
  Static Function Declaration
  ****************************************************************************************/
 
+static int
+csmgrd_plugin_msg_write (
+	int fd,									/* socket fd								*/
+	unsigned char* msg,						/* send message								*/
+	int msg_len								/* message length							*/
+);
+
 static int
 csmgrd_log_trim_line_string (
 	const char* p1, 							/* target string for trimming 			*/
@@ -107,6 +121,65 @@ csmgrd_plugin_cob_msg_send (
 	unsigned char* msg,						/* send message								*/
 	uint16_t msg_len						/* message length							*/
 ) {
+	/* While a batch is open for the socket, the Cob is queued and sent with 	*/
+	/* the other Cobs of the batch in csmgrd_plugin_cob_batch_end.				*/
+	if ((cob_batch_fd >= 0) && (cob_batch_fd == fd)) {
+		if (cob_batch_len + msg_len > CSMGRD_PLUGIN_BATCH_SIZE) {
+			csmgrd_plugin_msg_write (fd, cob_batch_buff, cob_batch_len);
+			cob_batch_len = 0;
+		}
+		memcpy (&cob_batch_buff[cob_batch_len], msg, msg_len);
+		cob_batch_len += msg_len;
+		return (0);
+	}
+
+	return (csmgrd_plugin_msg_write (fd, msg, msg_len));
+}
+/*--------------------------------------------------------------------------------------
+	Starts queuing the Cobs sent to the socket
+----------------------------------------------------------------------------------------*/
+int									/* The return value is negative if an error occurs	*/
+csmgrd_plugin_cob_batch_begin (
+	int fd									/* socket fd								*/
+) {
+	if (cob_batch_buff == NULL) {
+		cob_batch_buff = (unsigned char*) malloc (CSMGRD_PLUGIN_BATCH_SIZE);
+		if (cob_batch_buff == NULL) {
+			return (-1);
+		}
+	}
+	cob_batch_fd  = fd;
+	cob_batch_len = 0;
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Sends the queued Cobs with one write and stops queuing
+----------------------------------------------------------------------------------------*/
+void
+csmgrd_plugin_cob_batch_end (
+	int fd									/* socket fd								*/
+) {
+	if ((cob_batch_fd < 0) || (cob_batch_fd != fd)) {
+		return;
+	}
+	if (cob_batch_len > 0) {
+		csmgrd_plugin_msg_write (fd, cob_batch_buff, cob_batch_len);
+	}
+	cob_batch_fd  = -1;
+	cob_batch_len = 0;
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Writes the message to the socket
+----------------------------------------------------------------------------------------*/
+static int
+csmgrd_plugin_msg_write (
+	int fd,									/* socket fd								*/
+	unsigned char* msg,						/* send message								*/
+	int msg_len								/* message length							*/
+) {
 
    	unsigned char* p = msg;
    	int len = msg_len;
@@ -122,7 +195,13 @@ csmgrd_plugin_cob_msg_send (
 #ifdef	__CSMGRD_PLUGIN_SEND_ERROR__
 		fprintf(stderr, "[%s](res <=0): ########### ERROR=%s send_count:%d\n", __FUNCTION__, strerror (errno), send_count);
 #endif
-		return( 0 );
+		/* A full socket buffer is waited for below rather than dropping the 	*/
+		/* message, which may hold a batch of Cobs 								*/
+		if ((res < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+			res = 0;
+		} else {
+			return( 0 );
+		}
 	}
 	len -= res;  
 	p += res;
@@ -313,7 +392,7 @@ cef_csmgr_con_entry_create (
 	unsigned char* ucp;
 	uint16_t pkt_len = 0;
 	uint16_t hdr_len = 0;
-	CefT_CcnMsg_MsgBdy 	pm = { 0 };
+	CefT_CcnMsg_MsgBdy 	pm;
 	CefT_CcnMsg_OptHdr 	poh = { 0 };
 	int res;
 	
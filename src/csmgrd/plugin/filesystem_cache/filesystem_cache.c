@@ -96,10 +96,20 @@
 
 #define FSC_RECORD_CORRECT_SIZE		CefC_Max_Header_Size
 
+#define FscC_Fd_Cache_Num		64				/* Page files kept open				*/
+
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
 
+/* Open page file. The cache is used under fsc_cs_mutex. 	*/
+typedef struct {
+	int 			con_index;					/* Index of the content (rcd->index)	*/
+	int 			page_index;					/* Index of the page file				*/
+	int 			fd;							/* Descriptor of the page file			*/
+	uint64_t 		used;						/* Stamp of the last use, 0 if free		*/
+} FscT_Page_Fd;
+
 /****************************************************************************************
  State Variables
  ****************************************************************************************/
@@ -117,6 +127,8 @@ static CsmgrdT_Content_Entry* 	fsc_proc_cob_buff[FscC_Max_Buff]		= {0};
 static int 						fsc_proc_cob_buff_idx[FscC_Max_Buff] 	= {0};
 static CsmgrT_Stat_Handle 		csmgr_stat_hdl;
 static pthread_mutex_t 			fsc_cs_mutex = PTHREAD_MUTEX_INITIALIZER;
+static FscT_Page_Fd 			fsc_page_fds[FscC_Fd_Cache_Num];
+static uint64_t 				fsc_page_fd_stamp = 0;
 
 /****************************************************************************************
  Static Function Declaration
@@ -288,6 +300,22 @@ static int							/* The return value is negative if an error occurs	*/
 fsc_recursive_dir_clear (
 	char* filepath								/* file path							*/
 );
+/*--------------------------------------------------------------------------------------
+	Obtains the descriptor of the page file from the fd cache
+----------------------------------------------------------------------------------------*/
+static int							/* File descriptor, or -1 if an error occurs		*/
+fsc_page_fd_get (
+	int con_index,								/* Index of the content					*/
+	int page_index,								/* Index of the page file				*/
+	int create_f								/* 1 to create the file if not exist	*/
+);
+/*--------------------------------------------------------------------------------------
+	Closes the page files of the content kept in the fd cache
+----------------------------------------------------------------------------------------*/
+static void
+fsc_page_fd_release (
+	int con_index								/* Index of the content, or -1 for all	*/
+);
 
 /****************************************************************************************
  ****************************************************************************************/
@@ -577,6 +605,7 @@ fsc_cs_remove (
 					if (rcd->cob_num == 1) {
 						char file_path[PATH_MAX];
 						sprintf (file_path, "%s/%d", hdl->fsc_cache_path, (int) rcd->index);
+						fsc_page_fd_release ((int) rcd->index);
 						fsc_recursive_dir_clear (file_path);
 					}
 					csmgrd_stat_cob_remove (
@@ -625,6 +654,7 @@ fsc_cs_destroy (
 		return;
 	}
 	
+	fsc_page_fd_release (-1);
 	if (hdl->fsc_cache_path[0] != 0x00) {
 		fsc_recursive_dir_clear (hdl->fsc_cache_path);
 	}
@@ -655,8 +685,7 @@ fsc_cs_expire_check (
 	int 			index = 0;
 	CsmgrT_Stat* 	rcd = NULL;
 	char			file_path[PATH_MAX];
-	uint32_t 		i, n;
-	uint64_t 		mask;
+	uint32_t 		seq;
 	uint32_t 		chunk_num, net_chunk_num;
 	unsigned char 	trg_key[65535];
 	int 			trg_key_len = 0;
@@ -674,50 +703,38 @@ fsc_cs_expire_check (
 		}
 		
 		sprintf (file_path, "%s/%d", hdl->fsc_cache_path, (int) rcd->index);
+		fsc_page_fd_release ((int) rcd->index);
 		fsc_recursive_dir_clear (file_path);
 
 		cob_cnt = rcd->cob_num;
 		if (hdl->algo_apis.erase) {
-			for (i = 0 ; i < rcd->map_max ; i++) {
-				if (cob_cnt == 0) {
-					goto LOOP_END;
-				}
-				if (rcd->cob_map[i]) {
-					mask = 0x0000000000000001;
-					for (n = 0 ; n < 64 ; n++) {
-						if (cob_cnt == 0) {
-							goto LOOP_END;
-						}
-						if (rcd->cob_map[i] & mask) {
-							name_len = rcd->name_len;
-							memcpy (&trg_key[0], rcd->name, name_len);
-							trg_key[name_len] 		= 0x00;
-							trg_key[name_len + 1] 	= 0x10;
-							trg_key[name_len + 2] 	= 0x00;
-							trg_key[name_len + 3] 	= 0x04;
-							chunk_num = (i * 64 + n);
-							net_chunk_num = htonl (chunk_num);
-							memcpy (&trg_key[name_len + 4], &net_chunk_num, sizeof (uint32_t));
-							trg_key_len = name_len + 4 + sizeof (uint32_t);
-
-							(*(hdl->algo_apis.erase))(trg_key, trg_key_len);
-
-							csmgrd_stat_cob_remove (
-								csmgr_stat_hdl, rcd->name, name_len, chunk_num, 0);
-							
-							hdl->cache_cobs--;
-							cob_cnt--;
-						}
-						mask <<= 1;
-					}
-				}
+			seq = 0;
+			while ((cob_cnt > 0) &&
+				   (csmgr_stat_cob_next_cached_get (rcd, seq, &chunk_num) == 0)) {
+				name_len = rcd->name_len;
+				memcpy (&trg_key[0], rcd->name, name_len);
+				trg_key[name_len] 		= 0x00;
+				trg_key[name_len + 1] 	= 0x10;
+				trg_key[name_len + 2] 	= 0x00;
+				trg_key[name_len + 3] 	= 0x04;
+				net_chunk_num = htonl (chunk_num);
+				memcpy (&trg_key[name_len + 4], &net_chunk_num, sizeof (uint32_t));
+				trg_key_len = name_len + 4 + sizeof (uint32_t);
+
+				(*(hdl->algo_apis.erase))(trg_key, trg_key_len);
+
+				/* the record is released together with its last Cob		*/
+				csmgrd_stat_cob_remove (
+					csmgr_stat_hdl, rcd->name, name_len, chunk_num, 0);
+				
+				hdl->cache_cobs--;
+				cob_cnt--;
+				seq = chunk_num + 1;
 			}
 		} else {
 			csmgrd_stat_content_info_delete (csmgr_stat_hdl, rcd->name, rcd->name_len);
 			hdl->cache_cobs -= cob_cnt;
 		}
-LOOP_END:;
-		
 	}
 	pthread_mutex_unlock (&fsc_cs_mutex);
 	
@@ -748,7 +765,9 @@ fsc_cache_item_get (
 	int			rtc;
 	int 		page_index;
 	int 		pos_index;
-	FILE*		fp = NULL;
+	int 		fd;
+	ssize_t 	rd_len;
+	size_t 		blk_len;
 	int 		i;
 	int 		tx_cnt = 0;
 	int			resend_1cob_f = 0;
@@ -783,6 +802,7 @@ fsc_cache_item_get (
 #ifdef CefC_Debug
 		csmgrd_dbg_write (CefC_Dbg_Fine, "Delete the expired content = %s\n", file_path);
 #endif // CefC_Debug
+		fsc_page_fd_release ((int) rcd->index);
 		fsc_recursive_dir_clear (file_path);
 		csmgrd_stat_content_info_delete (csmgr_stat_hdl, key, key_size);
 		hdl->cache_cobs -= rcd->cob_num;
@@ -890,21 +910,37 @@ fsc_cache_item_get (
 			page_cob_buf = NULL;
 		}
 
-		fp = fopen (file_path, "rb");
-		if (fp == NULL) {
+		red_file_path[0] = 0x00;
+		fd = fsc_page_fd_get ((int) rcd->index, page_index, 0);
+		if (fd < 0) {
 			csmgrd_log_write (CefC_Log_Error, "Failed to open the cache file (%s)\n", file_path);
 			goto ItemGetPost;
 		}
-		strcpy (red_file_path, file_path);
-		red_cob_block_index = cob_block_index;
 		page_cob_buf = calloc (FscC_Page_Cob_Num, rcdsize);
-		fseek (fp, (int64_t)cob_block_index * (int64_t)rcdsize * FscC_Page_Cob_Num, SEEK_SET);
-		for (int i=0; i<FscC_Page_Cob_Num; i++) {
-			rtc = fread (&page_cob_buf[i*rcdsize], rcdsize, 1, fp);
-			if (rtc != 1) {
-				break;
-			}
+		if (page_cob_buf == NULL) {
+			goto ItemGetPost;
+		}
+		/* The block of the page is read at once. The file stays open, so the	*/
+		/* kernel readahead follows the sequential blocks of the content.		*/
+		blk_len = (size_t) rcdsize * FscC_Page_Cob_Num;
+		do {
+			rd_len = pread (fd, page_cob_buf, blk_len,
+					(off_t)((int64_t)cob_block_index * (int64_t)blk_len));
+		} while ((rd_len < 0) && (errno == EINTR));
+		if (rd_len < 0) {
+			csmgrd_log_write (CefC_Log_Error,
+				"Failed to read the cache file (%s)\n", file_path);
+			free (page_cob_buf);
+			page_cob_buf = NULL;
+			goto ItemGetPost;
+		}
+		/* A record cut at the end of the file is not used 	*/
+		rtc = (int)(rd_len % rcdsize);
+		if (rtc) {
+			memset (&page_cob_buf[rd_len - rtc], 0, rtc);
 		}
+		strcpy (red_file_path, file_path);
+		red_cob_block_index = cob_block_index;
 		if (red_ver_len) {
 			memset (red_version, 0, PATH_MAX);
 		}
@@ -912,8 +948,6 @@ fsc_cache_item_get (
 		if (ver_len) {
 			memcpy (red_version, version, ver_len);
 		}
-	} else {
-		fp = NULL;
 	}
 	
 	/* Send the cobs 		*/
@@ -934,9 +968,6 @@ fsc_cache_item_get (
 	csmgrd_plugin_cob_msg_send (
 						sock, &page_cob_buf[pos_index*rcdsize+sizeof (uint16_t)], mlen);
 	if (resend_1cob_f == 1) {
-		if (fp != NULL) {
-			fclose (fp);
-		}
 		pthread_mutex_unlock (&fsc_cs_mutex);
 		return (CefC_Csmgr_Cob_Exist);
 	}
@@ -974,9 +1005,6 @@ fsc_cache_item_get (
 	}
 	
 ItemGetPost:
-	if (fp != NULL) {
-		fclose (fp);
-	}
 	pthread_mutex_unlock (&fsc_cs_mutex);
 	return (CefC_Csmgr_Cob_Exist);
 }
@@ -1077,19 +1105,16 @@ fsc_cache_cob_write (
 	unsigned char 	name[CsmgrT_Name_Max];
 	uint16_t 		name_len = 0;
 	int				work_con_index = -1;
-	int 			prev_page_index = -1;
 	int 			work_page_index;
-	char			file_path[PATH_MAX];
 	int  			cob_block_index;
 	int 			rcdsize;
 	char			cont_path[PATH_MAX];
-	FILE*			fp = NULL;
+	int 			fd;
+	ssize_t 		wr_len;
 	uint64_t 		mask;
 	uint32_t 		x;
 	int*			indxs = NULL;
 	int				cnt = 0;
-	int				rbpflag = 0;
-	int				swindx[FscC_Page_Cob_Num];
 	uint32_t		file_msglen;
 	unsigned char 	del_name[CsmgrT_Name_Max];
 	uint16_t 		del_name_len = 0;
@@ -1183,6 +1208,7 @@ fsc_cache_cob_write (
 						char file_path[PATH_MAX];
 						/* Delete old files */
 						sprintf (file_path, "%s/%d", hdl->fsc_cache_path, (int) rcd->index);
+						fsc_page_fd_release ((int) rcd->index);
 						fsc_recursive_dir_clear (file_path);
 						
 						/* Old Stat */
@@ -1223,7 +1249,6 @@ fsc_cache_cob_write (
 				}
 			}
 			work_con_index = (int) rcd->index;
-			prev_page_index = -1;
 			sprintf (cont_path, "%s/%d", hdl->fsc_cache_path, work_con_index);
 			memcpy (name, cobs[index].name, cobs[index].name_len);
 			name_len = cobs[index].name_len;
@@ -1281,43 +1306,13 @@ fsc_cache_cob_write (
 		/* Update the page to write the received cob 		*/
 		work_page_index = chunk_num / FscC_Page_Cob_Num / FscC_File_Page_Num;
 		cob_block_index = (chunk_num / FscC_Page_Cob_Num) % FscC_File_Page_Num;
-		if (work_page_index != prev_page_index) {
-			if (fp != NULL) {
-#ifdef CefC_Debug
-				csmgrd_dbg_write (CefC_Dbg_Finer, 
-					"cob put thread writes the page: %s\n", cont_path);
-#endif // CefC_Debug
-				if (rbpflag == 1) {
-					fflush (fp);
-					fclose (fp);
-					fp = NULL;
-					rbpflag = 0;
-				} else {
-					fflush (fp);
-					fclose (fp);
-					fp = NULL;	
-				}
-			}
-			
-			prev_page_index = work_page_index;
-			struct stat st;
-			sprintf (file_path, 
-				"%s/%d/%d", hdl->fsc_cache_path, work_con_index, work_page_index);
-            if (stat (file_path, &st) != 0) {
-				fp = fopen (file_path, "w");
-            	fclose (fp);
-            	fp = fopen (file_path, "rb+");
-			}
-			else {
-				fp = fopen (file_path, "rb+");
-				if (!fp) {
-					csmgrd_log_write (CefC_Log_Error, 
-						"Failed to open the cache file (%s)\n", file_path);
-					goto NEXTCOB;
-				}
-				memset (swindx, 0 , sizeof (swindx));
-				rbpflag = 1;
-			}
+		/* The descriptor is obtained for each Cob, since the fd cache may close	*/
+		/* it while fsc_cs_mutex is released										*/
+		fd = fsc_page_fd_get (work_con_index, work_page_index, 1);
+		if (fd < 0) {
+			csmgrd_log_write (CefC_Log_Error, 
+				"Failed to open the cache file (%s/%d)\n", cont_path, work_page_index);
+			goto NEXTCOB;
 		}
 		
 		/* Updates the content information 			*/
@@ -1347,12 +1342,19 @@ fsc_cache_cob_write (
 		/* Set to write buffer 							*/
 		unsigned char wbuff[sizeof (uint16_t) + UINT16_MAX];
 		int write_index = chunk_num % FscC_Page_Cob_Num;
-		fseek (fp, (int64_t)cob_block_index * FscC_Page_Cob_Num * (int64_t)rcdsize
-					+ (int64_t)write_index * (int64_t)rcdsize, SEEK_SET);
 		memcpy (wbuff, &cobs[index].msg_len, sizeof (uint16_t));
 		memcpy (&wbuff[sizeof (uint16_t)], cobs[index].msg, cobs[index].msg_len);
-		fwrite (wbuff, sizeof (uint16_t) + file_msglen, 1, fp);
-		fflush (fp);
+		memset (&wbuff[sizeof (uint16_t) + cobs[index].msg_len], 0,
+				file_msglen - cobs[index].msg_len);
+		do {
+			wr_len = pwrite (fd, wbuff, rcdsize,
+						(off_t)((int64_t)cob_block_index * FscC_Page_Cob_Num * (int64_t)rcdsize
+							+ (int64_t)write_index * (int64_t)rcdsize));
+		} while ((wr_len < 0) && (errno == EINTR));
+		if (wr_len != rcdsize) {
+			csmgrd_log_write (CefC_Log_Error, 
+				"Failed to write the cache file (%s/%d)\n", cont_path, work_page_index);
+		}
 
 		if (!(hdl->algo_apis.insert)) {
 			hdl->cache_cobs++;
@@ -1372,10 +1374,6 @@ NEXTCOB:
 		pthread_mutex_unlock (&fsc_cs_mutex);
 	}
 	
-	if (fp) {
-		fflush (fp);
-		fclose (fp);
-	}
 #ifdef COBS_SORT
 	free (indxs);
 #endif
@@ -1705,6 +1703,7 @@ fsc_cache_del (
 			if (rcd->cob_num == 1) {
 				char file_path[PATH_MAX];
 				sprintf (file_path, "%s/%d", hdl->fsc_cache_path, (int) rcd->index);
+				fsc_page_fd_release ((int) rcd->index);
 				fsc_recursive_dir_clear (file_path);
 			}
 			csmgrd_stat_cob_remove (csmgr_stat_hdl, rcd->name, name_len, chunk_num, 0);
@@ -1936,3 +1935,74 @@ fsc_recursive_dir_clear (
 
 	return (0);
 }
+/*--------------------------------------------------------------------------------------
+	Obtains the descriptor of the page file from the fd cache
+----------------------------------------------------------------------------------------*/
+static int							/* File descriptor, or -1 if an error occurs		*/
+fsc_page_fd_get (
+	int con_index,								/* Index of the content					*/
+	int page_index,								/* Index of the page file				*/
+	int create_f								/* 1 to create the file if not exist	*/
+) {
+	char file_path[PATH_MAX];
+	FscT_Page_Fd* pfd;
+	FscT_Page_Fd* victim = NULL;
+	int fd;
+	int i;
+
+	fsc_page_fd_stamp++;
+	for (i = 0 ; i < FscC_Fd_Cache_Num ; i++) {
+		pfd = &fsc_page_fds[i];
+		if (pfd->used == 0) {
+			/* not used yet */
+			if (victim == NULL) {
+				victim = pfd;
+			}
+			continue;
+		}
+		if ((pfd->con_index == con_index) && (pfd->page_index == page_index)) {
+			pfd->used = fsc_page_fd_stamp;
+			return (pfd->fd);
+		}
+		if ((victim == NULL) || ((victim->used != 0) && (pfd->used < victim->used))) {
+			victim = pfd;
+		}
+	}
+
+	sprintf (file_path, "%s/%d/%d", hdl->fsc_cache_path, con_index, page_index);
+	fd = open (file_path, (create_f) ? (O_RDWR | O_CREAT) : O_RDWR, 0666);
+	if (fd < 0) {
+		return (-1);
+	}
+
+	/* Closes the least recently used file 	*/
+	if (victim->used != 0) {
+		close (victim->fd);
+	}
+	victim->con_index 	= con_index;
+	victim->page_index 	= page_index;
+	victim->fd 			= fd;
+	victim->used 		= fsc_page_fd_stamp;
+
+	return (fd);
+}
+/*--------------------------------------------------------------------------------------
+	Closes the page files of the content kept in the fd cache
+----------------------------------------------------------------------------------------*/
+static void
+fsc_page_fd_release (
+	int con_index								/* Index of the content, or -1 for all	*/
+) {
+	FscT_Page_Fd* pfd;
+	int i;
+
+	for (i = 0 ; i < FscC_Fd_Cache_Num ; i++) {
+		pfd = &fsc_page_fds[i];
+		if ((pfd->used != 0) &&
+			((con_index < 0) || (pfd->con_index == con_index))) {
+			close (pfd->fd);
+			memset (pfd, 0, sizeof (FscT_Page_Fd));
+		}
+	}
+	return;
+}
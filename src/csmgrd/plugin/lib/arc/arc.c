@@ -0,0 +1,459 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * arc.c
+ */
+
+/*
+	arc.c is an ARC (Adaptive Replacement Cache) implementation.
+	
+	Cached entries are kept in T1 (seen once recently) and T2 (seen at least
+	twice). The keys of entries evicted from T1 and T2 are remembered in the
+	ghost lists B1 and B2. A new entry that hits a ghost list moves the target
+	size of T1 (p) towards the list it came from, so the cache adapts between
+	recency and frequency. Entries accessed only once (e.g., a bulk download)
+	stay in T1 and do not push the frequently used entries out of T2.
+*/
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+
+#include <csmgrd/csmgrd_plugin.h>
+#include "cache_replace_lib.h"
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define ArcC_List_T1				0		/* cached, seen once 						*/
+#define ArcC_List_T2				1		/* cached, seen at least twice 				*/
+#define ArcC_List_B1				2		/* ghost of T1 								*/
+#define ArcC_List_B2				3		/* ghost of T2 								*/
+#define ArcC_List_Num				4
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+/***** structure for listing content entries *****/
+typedef struct _ArcT_Entry {
+	unsigned char 	*key;					/* key of content entry 					*/
+
+	int 			key_len;				/* length of key 							*/
+    int             list;                   /* list which the entry belongs to          */
+    int             next;
+    int             prev;
+} ArcT_Entry;
+
+/***** LRU list of entries (indexes of cache_entry_list) *****/
+typedef struct {
+    int             mru;
+    int             lru;
+    int             count;
+} ArcT_List;
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+static int cache_cap = 0;					/* Maximum number of entries that can be 	*/
+											/* listed (it is the same value as the 		*/
+											/* maximum value of the cache table) 		*/
+
+/* pointers of functions which stores and removes the content entry into/from the cache */
+/* table (implementation of the functions are in a plugin which uses this library) 		*/
+static int (*store_api)(CsmgrdT_Content_Entry*);
+static void (*remove_api)(unsigned char*, int);
+
+static int              entry_cap;          /* cached and ghost entries (2 x capacity)  */
+static int              entry_count;        /* number of cached and ghost entries       */
+static ArcT_Entry*      cache_entry_list;   /* list for cache and ghost entry           */
+static int*             empty_entry_list;   /* list for empty entry                     */
+static ArcT_List        lists[ArcC_List_Num];
+static int              target_t1;          /* target size of T1 (p)                    */
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+
+static int  arc_store_entry(const unsigned char* key, int key_len);
+static void arc_remove_entry(int index, int is_removed);
+static void arc_replace(int in_b2);
+static void arc_ghost_drop(int list);
+static void arc_list_push_mru(int list, int index);
+static void arc_list_unlink(int index);
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+/*--------------------------------------------------------------------------------------
+	Init API
+----------------------------------------------------------------------------------------*/
+int 							/* If the error occurs, this value is a negative value	*/
+init (
+	int capacity, 							/* Maximum number of entries that can be 	*/
+											/* listed (it is the same value as the 		*/
+											/* maximum value of the cache table) 		*/
+	int (*store)(CsmgrdT_Content_Entry*), 	/* store a content entry API 				*/
+	void (*remove)(unsigned char*, int)		/* remove a content entry API 				*/
+) {
+    int i;
+    entry_count = 0;
+    target_t1 = 0;
+    
+	/* Records the capacity of cache		*/
+	if ((capacity < 1) || (capacity > INT_MAX / 2)) {
+		fprintf (stderr, "[ARC LIB] Invalid Cacacity\n");
+		return (-1);
+	}
+	cache_cap = capacity;
+	entry_cap = capacity * 2;
+
+	/* Records store and remove APIs 		*/
+	if ((store == NULL) || (remove == NULL)) {
+		fprintf (stderr, "[ARC LIB] Not specified store or remove API\n");
+		return (-1);
+	}
+	store_api 	= store;
+	remove_api 	= remove;
+    
+	/* Creates the memory pool 				*/
+    cache_entry_list = (ArcT_Entry*) calloc(entry_cap, sizeof(ArcT_Entry));
+    empty_entry_list = (int*) calloc(entry_cap, sizeof(int));
+    if ((cache_entry_list == NULL) || (empty_entry_list == NULL)) {
+		fprintf (stderr, "[ARC LIB] Failed to allocate the entry list\n");
+		free(cache_entry_list);
+		free(empty_entry_list);
+		cache_entry_list = NULL;
+		empty_entry_list = NULL;
+		return (-1);
+    }
+    for (i = 0; i < entry_cap; i++) {
+        empty_entry_list[i] = i;
+        cache_entry_list[i].list = -1;
+        cache_entry_list[i].next = -1;
+        cache_entry_list[i].prev = -1;
+    }
+    for (i = 0; i < ArcC_List_Num; i++) {
+        lists[i].mru = -1;
+        lists[i].lru = -1;
+        lists[i].count = 0;
+    }
+    
+    /* Creates lookup table (ghost entries are looked up as well) */
+    crlib_lookup_table_init(entry_cap);
+    
+	return (0);
+}
+
+/*--------------------------------------------------------------------------------------
+	Destroy API
+----------------------------------------------------------------------------------------*/
+void
+destroy (
+	void
+) {
+	int i;
+	
+	if (cache_entry_list) {
+		for (i = 0; i < entry_cap; i++) {
+			if (cache_entry_list[i].key != NULL) {
+				free(cache_entry_list[i].key);
+			}
+		}
+	}
+    entry_count = 0;
+    entry_cap = 0;
+	cache_cap 		= 0;
+	store_api 		= NULL;
+	remove_api 		= NULL;
+
+    free(cache_entry_list);
+    free(empty_entry_list);
+    cache_entry_list = NULL;
+    empty_entry_list = NULL;
+    crlib_lookup_table_destroy();
+}
+
+/*--------------------------------------------------------------------------------------
+	Insert API
+----------------------------------------------------------------------------------------*/
+void
+insert (
+	CsmgrdT_Content_Entry* entry			/* content entry 							*/
+) {
+    unsigned char 	key[CsmgrdC_Key_Max];
+    int 			key_len;
+    int             index;
+    int             cached;
+    int             delta;
+    
+    key_len = csmgrd_name_chunknum_concatenate (
+                    entry->name, entry->name_len, entry->chunk_num, key);
+    index = crlib_lookup_table_search(key, key_len);
+    cached = lists[ArcC_List_T1].count + lists[ArcC_List_T2].count;
+    
+    if (index < 0) {
+        /* Not in any list */
+        if (lists[ArcC_List_T1].count + lists[ArcC_List_B1].count >= cache_cap) {
+            if (lists[ArcC_List_T1].count < cache_cap) {
+                arc_ghost_drop(ArcC_List_B1);
+                if (cached >= cache_cap) {
+                    arc_replace(0);
+                }
+            } else {
+                /* T1 fills the whole cache; its LRU entry is dropped without a ghost */
+                arc_remove_entry(lists[ArcC_List_T1].lru, 0);
+            }
+        } else if (cached + lists[ArcC_List_B1].count + lists[ArcC_List_B2].count
+                        >= cache_cap) {
+            if (entry_count >= entry_cap) {
+                arc_ghost_drop(ArcC_List_B2);
+            }
+            if (cached >= cache_cap) {
+                arc_replace(0);
+            }
+        }
+        index = arc_store_entry(key, key_len);
+        arc_list_push_mru(ArcC_List_T1, index);
+        (*store_api)(entry);
+        return;
+    }
+    
+    switch (cache_entry_list[index].list) {
+        case ArcC_List_B1: {
+            /* recently evicted from T1: favors recency */
+            delta = (lists[ArcC_List_B1].count >= lists[ArcC_List_B2].count) ?
+                    1 : lists[ArcC_List_B2].count / lists[ArcC_List_B1].count;
+            target_t1 = (target_t1 + delta > cache_cap) ? cache_cap : target_t1 + delta;
+            if (cached >= cache_cap) {
+                arc_replace(0);
+            }
+            break;
+        }
+        case ArcC_List_B2: {
+            /* recently evicted from T2: favors frequency */
+            delta = (lists[ArcC_List_B2].count >= lists[ArcC_List_B1].count) ?
+                    1 : lists[ArcC_List_B1].count / lists[ArcC_List_B2].count;
+            target_t1 = (target_t1 - delta < 0) ? 0 : target_t1 - delta;
+            if (cached >= cache_cap) {
+                arc_replace(1);
+            }
+            break;
+        }
+        default: {
+            fprintf(stderr, "[ARC LIB] insert: ERROR: specified entry is already cached.\n");
+            return;
+        }
+    }
+    arc_list_unlink(index);
+    arc_list_push_mru(ArcC_List_T2, index);
+    (*store_api)(entry);
+}
+
+/*--------------------------------------------------------------------------------------
+	Erase API
+----------------------------------------------------------------------------------------*/
+void
+erase (
+	unsigned char* key, 					/* key of content entry removed from cache 	*/
+											/* table									*/
+	int key_len								/* length of the key 						*/
+) {
+    int index = crlib_lookup_table_search(key, key_len);
+    if ((index < 0) ||
+        (cache_entry_list[index].list == ArcC_List_B1) ||
+        (cache_entry_list[index].list == ArcC_List_B2)) {
+        fprintf(stderr, "[ARC LIB] failed to erace\n");
+        return;
+    }
+    arc_remove_entry(index, 1);
+}
+
+/*--------------------------------------------------------------------------------------
+	Hit API
+----------------------------------------------------------------------------------------*/
+void
+hit (
+	unsigned char* key, 					/* key of the content entry hits in the 	*/
+											/* cache table 								*/
+	int key_len								/* length of the key 						*/
+) {
+    int index = crlib_lookup_table_search(key, key_len);
+    if ((index < 0) ||
+        (cache_entry_list[index].list == ArcC_List_B1) ||
+        (cache_entry_list[index].list == ArcC_List_B2)) {
+        fprintf(stderr, "[ARC LIB] invalid hit\n");
+        return;
+    }
+    arc_list_unlink(index);
+    arc_list_push_mru(ArcC_List_T2, index);
+}
+
+/*--------------------------------------------------------------------------------------
+	Miss API
+----------------------------------------------------------------------------------------*/
+void
+miss (
+	unsigned char* key, 					/* key of the content entry fails to hit 	*/
+											/* in the cache table						*/
+	int key_len								/* length of the key 						*/
+) {
+    // NOTHING TO DO (ghost lists are checked when the entry is inserted)
+	return;
+}
+
+/*--------------------------------------------------------------------------------------
+	Status API
+----------------------------------------------------------------------------------------*/
+void
+status (
+	void* arg								/* state information						*/
+) {
+	return;
+}
+
+
+/*--------------------------------------------------------------------------------------
+	Static Functions
+----------------------------------------------------------------------------------------*/
+static int arc_store_entry(
+	const unsigned char* key,
+    int key_len
+) {
+    ArcT_Entry*     rsentry;
+	unsigned char* q;
+    int             index;
+    
+    index = empty_entry_list[entry_count];
+    rsentry = &cache_entry_list[index];
+    rsentry->key_len = key_len;
+  	q = calloc(1, key_len);
+    memcpy(q, key, key_len);
+	rsentry->key = q;
+    crlib_lookup_table_add(rsentry->key, rsentry->key_len, index);
+    entry_count++;
+    return index;
+}
+
+static void arc_remove_entry(
+    int index,
+    int is_removed
+) {
+    ArcT_Entry* rsentry;
+    int list = cache_entry_list[index].list;
+    arc_list_unlink(index);
+    rsentry = &cache_entry_list[index];
+    crlib_lookup_table_remove(rsentry->key, rsentry->key_len);
+    if (!is_removed && (list == ArcC_List_T1 || list == ArcC_List_T2)) {
+        (*remove_api)(rsentry->key, rsentry->key_len);
+    }
+
+	free(rsentry->key);
+    memset(rsentry, 0, sizeof(ArcT_Entry));
+    rsentry->list = -1;
+    rsentry->next = -1;
+    rsentry->prev = -1;
+    entry_count--;
+    empty_entry_list[entry_count] = index;
+}
+
+/* Evicts the LRU entry of T1 or T2 from the cache and keeps its key as a ghost */
+static void arc_replace(int in_b2) {
+    int t1 = lists[ArcC_List_T1].count;
+    int index;
+    
+    if ((t1 > 0) &&
+        ((t1 > target_t1) || (in_b2 && t1 == target_t1) ||
+         (lists[ArcC_List_T2].count == 0))) {
+        index = lists[ArcC_List_T1].lru;
+        arc_list_unlink(index);
+        arc_list_push_mru(ArcC_List_B1, index);
+    } else {
+        index = lists[ArcC_List_T2].lru;
+        if (index < 0) {
+            return;
+        }
+        arc_list_unlink(index);
+        arc_list_push_mru(ArcC_List_B2, index);
+    }
+    (*remove_api)(cache_entry_list[index].key, cache_entry_list[index].key_len);
+}
+
+/* Forgets the LRU ghost of B1 or B2 (the other one if the list is empty) */
+static void arc_ghost_drop(int list) {
+    int index = lists[list].lru;
+    if (index < 0) {
+        list = (list == ArcC_List_B1) ? ArcC_List_B2 : ArcC_List_B1;
+        index = lists[list].lru;
+    }
+    if (index >= 0) {
+        arc_remove_entry(index, 1);
+    }
+}
+
+static void arc_list_push_mru(int list, int index) {
+    ArcT_List* lp = &lists[list];
+    cache_entry_list[index].list = list;
+    cache_entry_list[index].prev = -1;
+    cache_entry_list[index].next = lp->mru;
+    if (lp->mru >= 0) {
+        cache_entry_list[lp->mru].prev = index;
+    } else { // add as the first entry
+        lp->lru = index;
+    }
+    lp->mru = index;
+    lp->count++;
+}
+
+static void arc_list_unlink(int index) {
+    ArcT_List* lp = &lists[cache_entry_list[index].list];
+    int prev_idx = cache_entry_list[index].prev;
+    int next_idx = cache_entry_list[index].next;
+    if (prev_idx >= 0) {
+        cache_entry_list[prev_idx].next = next_idx;
+    } else {
+        lp->mru = next_idx;
+    }
+    if (next_idx >= 0) {
+        cache_entry_list[next_idx].prev = prev_idx;
+    } else {
+        lp->lru = prev_idx;
+    }
+    lp->count--;
+    cache_entry_list[index].prev = -1;
+    cache_entry_list[index].next = -1;
+}
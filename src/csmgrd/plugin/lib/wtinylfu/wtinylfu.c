@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * wtinylfu.c
+ */
+
+/*
+	wtinylfu.c is a W-TinyLFU implementation.
+	
+	New entries go into a small LRU window. An entry pushed out of the window
+	has to win against the LRU entry of the main area to stay cached; the
+	winner is the one with the higher access frequency estimated by a
+	count-min sketch. The main area is a segmented LRU (probation and
+	protected). The sketch counters are halved periodically so that old
+	popularity fades out. A one-off bulk download only passes through the
+	window and does not wash out popular content in the main area.
+*/
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <cefore/cef_hash.h>
+#include <csmgrd/csmgrd_plugin.h>
+#include "cache_replace_lib.h"
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define WtlfuC_Window_Percent		1		/* size of the window in the capacity (%)	*/
+#define WtlfuC_Protected_Percent	80		/* size of the protected segment in the 	*/
+											/* main area (%)							*/
+
+#define WtlfuC_Sketch_Depth			4		/* number of rows of the sketch 			*/
+#define WtlfuC_Sketch_Width_Min		64		/* number of counters in a row 				*/
+#define WtlfuC_Sketch_Width_Max		(1 << 24)
+#define WtlfuC_Sample_Factor		10		/* counters are halved after				*/
+											/* (width * factor) increments				*/
+#define WtlfuC_Counter_Max			15		/* counters are 4-bit wide 					*/
+
+#define WtlfuC_List_Window			0
+#define WtlfuC_List_Probation		1
+#define WtlfuC_List_Protected		2
+#define WtlfuC_List_Num				3
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+/***** structure for listing content entries *****/
+typedef struct _WtlfuT_Entry {
+	unsigned char 	*key;					/* key of content entry 					*/
+
+	int 			key_len;				/* length of key 							*/
+    int             list;                   /* list which the entry belongs to          */
+    int             next;
+    int             prev;
+} WtlfuT_Entry;
+
+/***** LRU list of entries (indexes of cache_entry_list) *****/
+typedef struct {
+    int             mru;
+    int             lru;
+    int             count;
+} WtlfuT_List;
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+static int cache_cap = 0;					/* Maximum number of entries that can be 	*/
+											/* listed (it is the same value as the 		*/
+											/* maximum value of the cache table) 		*/
+
+/* pointers of functions which stores and removes the content entry into/from the cache */
+/* table (implementation of the functions are in a plugin which uses this library) 		*/
+static int (*store_api)(CsmgrdT_Content_Entry*);
+static void (*remove_api)(unsigned char*, int);
+
+static int              cache_count;        /* number of cache entries                  */
+static WtlfuT_Entry*    cache_entry_list;   /* list for cache entry                     */
+static int*             empty_entry_list;   /* list for empty cache entry               */
+static WtlfuT_List      lists[WtlfuC_List_Num];
+static int              window_cap;         /* maximum number of entries in the window  */
+static int              protected_cap;      /* maximum number of protected entries      */
+
+static uint64_t*        sketch;             /* 4-bit counters, 16 counters per word     */
+static uint32_t         sketch_mask;        /* number of counters in a row - 1          */
+static uint64_t         sketch_samples;     /* increments before the counters are aged  */
+static uint64_t         sketch_additions;   /* increments since the last aging          */
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+
+static void wtlfu_store_entry(CsmgrdT_Content_Entry* entry, int index);
+static void wtlfu_remove_entry(int index, int is_removed);
+static void wtlfu_evict(int candidate);
+static void wtlfu_list_push_mru(int list, int index);
+static void wtlfu_list_unlink(int index);
+static void wtlfu_sketch_index(const unsigned char* key, int key_len, uint32_t* idx);
+static void wtlfu_sketch_increment(const unsigned char* key, int key_len);
+static int  wtlfu_sketch_min(const uint32_t* idx);
+static int  wtlfu_sketch_frequency(const unsigned char* key, int key_len);
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+/*--------------------------------------------------------------------------------------
+	Init API
+----------------------------------------------------------------------------------------*/
+int 							/* If the error occurs, this value is a negative value	*/
+init (
+	int capacity, 							/* Maximum number of entries that can be 	*/
+											/* listed (it is the same value as the 		*/
+											/* maximum value of the cache table) 		*/
+	int (*store)(CsmgrdT_Content_Entry*), 	/* store a content entry API 				*/
+	void (*remove)(unsigned char*, int)		/* remove a content entry API 				*/
+) {
+    int i;
+    uint32_t width;
+    cache_count = 0;
+    
+	/* Records the capacity of cache		*/
+	if (capacity < 1) {
+		fprintf (stderr, "[W-TinyLFU LIB] Invalid Cacacity\n");
+		return (-1);
+	}
+	cache_cap = capacity;
+
+	/* Records store and remove APIs 		*/
+	if ((store == NULL) || (remove == NULL)) {
+		fprintf (stderr, "[W-TinyLFU LIB] Not specified store or remove API\n");
+		return (-1);
+	}
+	store_api 	= store;
+	remove_api 	= remove;
+    
+	/* Creates the memory pool 				*/
+    cache_entry_list = (WtlfuT_Entry*) calloc(cache_cap, sizeof(WtlfuT_Entry));
+    empty_entry_list = (int*) calloc(cache_cap, sizeof(int));
+    if ((cache_entry_list == NULL) || (empty_entry_list == NULL)) {
+		fprintf (stderr, "[W-TinyLFU LIB] Failed to allocate the entry list\n");
+		free(cache_entry_list);
+		free(empty_entry_list);
+		cache_entry_list = NULL;
+		empty_entry_list = NULL;
+		return (-1);
+    }
+    for (i = 0; i < cache_cap; i++) {
+        empty_entry_list[i] = i;
+        cache_entry_list[i].list = -1;
+        cache_entry_list[i].next = -1;
+        cache_entry_list[i].prev = -1;
+    }
+    for (i = 0; i < WtlfuC_List_Num; i++) {
+        lists[i].mru = -1;
+        lists[i].lru = -1;
+        lists[i].count = 0;
+    }
+    window_cap = (int)((int64_t) cache_cap * WtlfuC_Window_Percent / 100);
+    if (window_cap < 1) {
+        window_cap = 1;
+    }
+    protected_cap =
+        (int)((int64_t)(cache_cap - window_cap) * WtlfuC_Protected_Percent / 100);
+    
+    /* Creates the frequency sketch (one counter per entry in a row) */
+    width = WtlfuC_Sketch_Width_Min;
+    while ((width < (uint32_t) cache_cap) && (width < WtlfuC_Sketch_Width_Max)) {
+        width <<= 1;
+    }
+    sketch = (uint64_t*) calloc(WtlfuC_Sketch_Depth * (width / 16), sizeof(uint64_t));
+    if (sketch == NULL) {
+		fprintf (stderr, "[W-TinyLFU LIB] Failed to allocate the sketch\n");
+		free(cache_entry_list);
+		free(empty_entry_list);
+		cache_entry_list = NULL;
+		empty_entry_list = NULL;
+		return (-1);
+    }
+    sketch_mask = width - 1;
+    sketch_samples = (uint64_t) width * WtlfuC_Sample_Factor;
+    sketch_additions = 0;
+    
+    /* Creates lookup table */
+    crlib_lookup_table_init(capacity);
+    
+	return (0);
+}
+
+/*--------------------------------------------------------------------------------------
+	Destroy API
+----------------------------------------------------------------------------------------*/
+void
+destroy (
+	void
+) {
+	int i;
+	
+	if (cache_entry_list) {
+		for (i = 0; i < cache_cap; i++) {
+			if (cache_entry_list[i].key != NULL) {
+				free(cache_entry_list[i].key);
+			}
+		}
+	}
+    cache_count = 0;
+	cache_cap 		= 0;
+	store_api 		= NULL;
+	remove_api 		= NULL;
+
+    free(cache_entry_list);
+    free(empty_entry_list);
+    free(sketch);
+    cache_entry_list = NULL;
+    empty_entry_list = NULL;
+    sketch = NULL;
+    crlib_lookup_table_destroy();
+}
+
+/*--------------------------------------------------------------------------------------
+	Insert API
+----------------------------------------------------------------------------------------*/
+void
+insert (
+	CsmgrdT_Content_Entry* entry			/* content entry 							*/
+) {
+    unsigned char 	key[CsmgrdC_Key_Max];
+    int 			key_len;
+    int             candidate;
+    
+    key_len = csmgrd_name_chunknum_concatenate (
+                    entry->name, entry->name_len, entry->chunk_num, key);
+    if (crlib_lookup_table_search(key, key_len) >= 0) {
+        fprintf(stderr, "[W-TinyLFU LIB] insert: ERROR: specified entry is already cached.\n");
+        return;
+    }
+	/* The new entry goes into the window. When the window is full, its LRU	*/
+	/* entry moves to the main area and, if the cache is full, competes with	*/
+	/* the LRU entry of the main area.											*/
+    if ((lists[WtlfuC_List_Window].count >= window_cap) &&
+        (lists[WtlfuC_List_Window].lru >= 0)) {
+        candidate = lists[WtlfuC_List_Window].lru;
+        wtlfu_list_unlink(candidate);
+        wtlfu_list_push_mru(WtlfuC_List_Probation, candidate);
+        if (cache_count >= cache_cap) {
+            wtlfu_evict(candidate);
+        }
+    } else if (cache_count >= cache_cap) {
+        wtlfu_evict(-1);
+    }
+	wtlfu_store_entry(entry, empty_entry_list[cache_count]);
+}
+
+/*--------------------------------------------------------------------------------------
+	Erase API
+----------------------------------------------------------------------------------------*/
+void
+erase (
+	unsigned char* key, 					/* key of content entry removed from cache 	*/
+											/* table									*/
+	int key_len								/* length of the key 						*/
+) {
+    int index = crlib_lookup_table_search(key, key_len);
+    if (index < 0) {
+        fprintf(stderr, "[W-TinyLFU LIB] failed to erace\n");
+        return;
+    }
+    wtlfu_remove_entry(index, 1);
+}
+
+/*--------------------------------------------------------------------------------------
+	Hit API
+----------------------------------------------------------------------------------------*/
+void
+hit (
+	unsigned char* key, 					/* key of the content entry hits in the 	*/
+											/* cache table 								*/
+	int key_len								/* length of the key 						*/
+) {
+    int index;
+    int demoted;
+    
+    wtlfu_sketch_increment(key, key_len);
+    index = crlib_lookup_table_search(key, key_len);
+    if (index < 0) {
+        fprintf(stderr, "[W-TinyLFU LIB] invalid hit\n");
+        return;
+    }
+    switch (cache_entry_list[index].list) {
+        case WtlfuC_List_Window: {
+            wtlfu_list_unlink(index);
+            wtlfu_list_push_mru(WtlfuC_List_Window, index);
+            break;
+        }
+        case WtlfuC_List_Probation: {
+            /* promotes to the protected segment */
+            wtlfu_list_unlink(index);
+            wtlfu_list_push_mru(WtlfuC_List_Protected, index);
+            if (lists[WtlfuC_List_Protected].count > protected_cap) {
+                demoted = lists[WtlfuC_List_Protected].lru;
+                wtlfu_list_unlink(demoted);
+                wtlfu_list_push_mru(WtlfuC_List_Probation, demoted);
+            }
+            break;
+        }
+        default: {
+            wtlfu_list_unlink(index);
+            wtlfu_list_push_mru(WtlfuC_List_Protected, index);
+            break;
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------------------
+	Miss API
+----------------------------------------------------------------------------------------*/
+void
+miss (
+	unsigned char* key, 					/* key of the content entry fails to hit 	*/
+											/* in the cache table						*/
+	int key_len								/* length of the key 						*/
+) {
+    /* the request counts even though the entry is not cached (yet) */
+    wtlfu_sketch_increment(key, key_len);
+}
+
+/*--------------------------------------------------------------------------------------
+	Status API
+----------------------------------------------------------------------------------------*/
+void
+status (
+	void* arg								/* state information						*/
+) {
+	return;
+}
+
+
+/*--------------------------------------------------------------------------------------
+	Static Functions
+----------------------------------------------------------------------------------------*/
+static void wtlfu_store_entry(
+	CsmgrdT_Content_Entry* entry,
+    int index
+) {
+    unsigned char 	key[CsmgrdC_Key_Max];
+    int 			key_len;
+    WtlfuT_Entry*   rsentry;
+	unsigned char* q;
+    
+    key_len = csmgrd_name_chunknum_concatenate (
+                    entry->name, entry->name_len, entry->chunk_num, key);
+    rsentry = &cache_entry_list[index];
+    rsentry->key_len = key_len;
+  	q = calloc(1, key_len);
+    memcpy(q, key, key_len);
+	rsentry->key = q;
+    wtlfu_list_push_mru(WtlfuC_List_Window, index);
+    crlib_lookup_table_add(rsentry->key, rsentry->key_len, index);
+    (*store_api)(entry);
+    cache_count++;
+}
+
+static void wtlfu_remove_entry(
+    int index,
+    int is_removed
+) {
+    WtlfuT_Entry* rsentry;
+    wtlfu_list_unlink(index);
+    rsentry = &cache_entry_list[index];
+    crlib_lookup_table_remove(rsentry->key, rsentry->key_len);
+    if (!is_removed) (*remove_api)(rsentry->key, rsentry->key_len);
+
+	free(rsentry->key);
+    memset(rsentry, 0, sizeof(WtlfuT_Entry));
+    rsentry->list = -1;
+    rsentry->next = -1;
+    rsentry->prev = -1;
+    cache_count--;
+    empty_entry_list[cache_count] = index;
+}
+
+/* Evicts either the candidate pushed out of the window or the LRU entry of the	*/
+/* main area, whichever is accessed less often. With no candidate, the LRU		*/
+/* entry of the main area is evicted.											*/
+static void wtlfu_evict(int candidate) {
+    int victim = lists[WtlfuC_List_Probation].lru;
+    if ((victim < 0) || (victim == candidate)) {
+        victim = lists[WtlfuC_List_Protected].lru;
+    }
+    if (candidate < 0) {
+        if (victim < 0) {
+            victim = lists[WtlfuC_List_Window].lru;
+        }
+        wtlfu_remove_entry(victim, 0);
+        return;
+    }
+    if (victim < 0) {
+        wtlfu_remove_entry(candidate, 0);
+        return;
+    }
+    if (wtlfu_sketch_frequency(cache_entry_list[candidate].key,
+                               cache_entry_list[candidate].key_len) >
+        wtlfu_sketch_frequency(cache_entry_list[victim].key,
+                               cache_entry_list[victim].key_len)) {
+        wtlfu_remove_entry(victim, 0);
+    } else {
+        wtlfu_remove_entry(candidate, 0);
+    }
+}
+
+static void wtlfu_list_push_mru(int list, int index) {
+    WtlfuT_List* lp = &lists[list];
+    cache_entry_list[index].list = list;
+    cache_entry_list[index].prev = -1;
+    cache_entry_list[index].next = lp->mru;
+    if (lp->mru >= 0) {
+        cache_entry_list[lp->mru].prev = index;
+    } else { // add as the first entry
+        lp->lru = index;
+    }
+    lp->mru = index;
+    lp->count++;
+}
+
+static void wtlfu_list_unlink(int index) {
+    WtlfuT_List* lp = &lists[cache_entry_list[index].list];
+    int prev_idx = cache_entry_list[index].prev;
+    int next_idx = cache_entry_list[index].next;
+    if (prev_idx >= 0) {
+        cache_entry_list[prev_idx].next = next_idx;
+    } else {
+        lp->mru = next_idx;
+    }
+    if (next_idx >= 0) {
+        cache_entry_list[next_idx].prev = prev_idx;
+    } else {
+        lp->lru = prev_idx;
+    }
+    lp->count--;
+    cache_entry_list[index].prev = -1;
+    cache_entry_list[index].next = -1;
+}
+
+/*--------------------------------------------------------------------------------------
+	Count-min sketch
+----------------------------------------------------------------------------------------*/
+static void wtlfu_sketch_index(const unsigned char* key, int key_len, uint32_t* idx) {
+    int i;
+    uint32_t h1 = cef_hash_number_calc(CefC_Hash_Seed_Default, key, key_len);
+    uint32_t h2 = crlib_xhash_get(h1, 0x9e3779b9) | 1;
+    for (i = 0; i < WtlfuC_Sketch_Depth; i++) {
+        idx[i] = (h1 + i * h2) & sketch_mask;
+    }
+}
+
+static int wtlfu_sketch_min(const uint32_t* idx) {
+    uint64_t* row;
+    int i, cnt;
+    int freq = WtlfuC_Counter_Max;
+    for (i = 0; i < WtlfuC_Sketch_Depth; i++) {
+        row = &sketch[(uint64_t) i * ((sketch_mask + 1) / 16)];
+        cnt = (int)((row[idx[i] >> 4] >> ((idx[i] & 15) * 4)) & 0xF);
+        if (cnt < freq) {
+            freq = cnt;
+        }
+    }
+    return freq;
+}
+
+static int wtlfu_sketch_frequency(const unsigned char* key, int key_len) {
+    uint32_t idx[WtlfuC_Sketch_Depth];
+    wtlfu_sketch_index(key, key_len, idx);
+    return wtlfu_sketch_min(idx);
+}
+
+static void wtlfu_sketch_increment(const unsigned char* key, int key_len) {
+    uint32_t idx[WtlfuC_Sketch_Depth];
+    uint64_t* row;
+    uint64_t i, words;
+    int cnt;
+    int freq;
+    
+    /* conservative update: only the smallest counters are incremented */
+    wtlfu_sketch_index(key, key_len, idx);
+    freq = wtlfu_sketch_min(idx);
+    if (freq >= WtlfuC_Counter_Max) {
+        return;
+    }
+    for (i = 0; i < WtlfuC_Sketch_Depth; i++) {
+        row = &sketch[i * ((sketch_mask + 1) / 16)];
+        cnt = (int)((row[idx[i] >> 4] >> ((idx[i] & 15) * 4)) & 0xF);
+        if (cnt == freq) {
+            row[idx[i] >> 4] += 1ULL << ((idx[i] & 15) * 4);
+        }
+    }
+    
+    /* ages the counters by halving them */
+    if (++sketch_additions >= sketch_samples) {
+        words = (uint64_t) WtlfuC_Sketch_Depth * ((sketch_mask + 1) / 16);
+        for (i = 0; i < words; i++) {
+            sketch[i] = (sketch[i] >> 1) & 0x7777777777777777ULL;
+        }
+        sketch_additions /= 2;
+    }
+}
@@ -1917,13 +1917,7 @@ cef_mem_hash_number_create (
 	const unsigned char* key,
 	uint32_t klen
 ) {
-	uint32_t hash;
-	unsigned char out[MD5_DIGEST_LENGTH];
-
-	MD5 (key, klen, out);
-	memcpy (&hash, &out[12], sizeof (uint32_t));
-
-	return (hash);
+	return (cef_hash_number_calc (CefC_Hash_Seed_Default, key, klen));
 }
 
 int												/* length of the created key 			*/
@@ -2006,7 +2000,8 @@ mem_cache_delete_thread (
 	fds[0].events = POLLIN | POLLERR;
 
 	while (1){
-		poll (fds, 1, 1);
+		/* Blocks until the main thread passes the Cobs to delete 	*/
+		poll (fds, 1, -1);
 		if (fds[0].revents & POLLIN) {
 			unsigned char		del_name[CefC_Max_Length] = {0};
 			uint16_t			del_name_len;
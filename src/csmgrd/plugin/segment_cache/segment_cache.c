@@ -0,0 +1,1422 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * segment_cache.c
+ */
+#define __CSMGRD_SEGMENT_CACHE_SOURCE__
+
+/*
+	segment_cache.c is a log-structured cache which appends Cobs to preallocated
+	segment files mapped into memory. The index (name + chunk -> segment, offset)
+	is an open addressing hash table kept in a mapped file as well, so that the
+	cached Cobs are served again right after csmgrd restarts without reading the
+	segments. When the segment being appended to is full, the next segment is
+	reused and the Cobs in it are evicted (FIFO by segment).
+*/
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "segment_cache.h"
+#include <cefore/cef_client.h>
+#include <cefore/cef_csmgr.h>
+#include <cefore/cef_frame.h>
+#include <cefore/cef_hash.h>
+#include <cefore/cef_valid.h>
+#include <csmgrd/csmgrd_plugin.h>
+
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define SgcC_Rec_Len(k, v, m) \
+	(((sizeof (SgcT_Record_Header) + (k) + (v) + (m)) + (SgcC_Record_Align - 1)) \
+		& ~(SgcC_Record_Align - 1))
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+static SgcT_Cache_Handle* 		hdl = NULL;
+static char 					csmgr_conf_dir[PATH_MAX] = {"/usr/local/cefore"};
+static CsmgrT_Stat_Handle 		csmgr_stat_hdl;
+static pthread_mutex_t 			sgc_cs_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+
+/*--------------------------------------------------------------------------------------
+	Init content store
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+sgc_cs_create (
+	CsmgrT_Stat_Handle stat_hdl,
+	int first_node_f
+);
+/*--------------------------------------------------------------------------------------
+	Destroy content store
+----------------------------------------------------------------------------------------*/
+static void
+sgc_cs_destroy (
+	int		Last_Node_f
+);
+/*--------------------------------------------------------------------------------------
+	Check content expire
+----------------------------------------------------------------------------------------*/
+static void
+sgc_cs_expire_check (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Function to read a ContentObject from the segment cache
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+sgc_cache_item_get (
+	unsigned char* key,							/* content name							*/
+	uint16_t key_size,							/* content name Length					*/
+	uint32_t seqno,								/* chunk num							*/
+	int sock,									/* received socket						*/
+	unsigned char* version,						/* version								*/
+	uint16_t ver_len							/* length of version					*/
+);
+/*--------------------------------------------------------------------------------------
+	Upload content byte steream
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+sgc_cache_item_puts (
+	unsigned char* msg,
+	int msg_len
+);
+/*--------------------------------------------------------------------------------------
+	Function to increment access count
+----------------------------------------------------------------------------------------*/
+static void
+sgc_cs_ac_cnt_inc (
+	unsigned char* key,							/* content name							*/
+	uint16_t key_size,							/* content name Length					*/
+	uint32_t seq_num							/* sequence number						*/
+);
+/*--------------------------------------------------------------------------------------
+	get lifetime for ccninfo
+----------------------------------------------------------------------------------------*/
+static int										/* This value MAY be -1 if the router does not know or cannot report. */
+sgc_cache_lifetime_get (
+	unsigned char* name,						/* content name							*/
+	uint16_t name_len,							/* content name Length					*/
+	uint32_t* cache_time,						/* The elapsed time (seconds) after the oldest	*/
+												/* content object of the content is cached.		*/
+	uint32_t* lifetime,							/* The lifetime (seconds) of a content object, 	*/
+												/* which is removed first among the cached content objects.*/
+	uint8_t partial_f							/* when flag is 0, exact match			*/
+												/* when flag is 1, partial match		*/
+);
+/*--------------------------------------------------------------------------------------
+	Read config file
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+sgc_config_read (
+	SgcT_Config_Param* params					/* record parameters					*/
+);
+/*--------------------------------------------------------------------------------------
+	Opens the index and segment files. The files are created if they do not exist
+	or were created with other parameters.
+----------------------------------------------------------------------------------------*/
+static int							/* 1 if the store was reused, 0 if it was created,	*/
+									/* negative if an error occurs						*/
+sgc_store_open (
+	SgcT_Config_Param* params
+);
+/*--------------------------------------------------------------------------------------
+	Syncs and unmaps the index and segment files
+----------------------------------------------------------------------------------------*/
+static void
+sgc_store_close (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Opens the file and maps it. The file is extended to len if it is shorter.
+----------------------------------------------------------------------------------------*/
+static unsigned char*				/* mapped address, NULL if an error occurs			*/
+sgc_file_map (
+	const char* path,
+	size_t len,
+	int* fd,
+	int* created_f								/* set to 1 if the file was extended	*/
+);
+/*--------------------------------------------------------------------------------------
+	Registers the Cobs of the index to the statistics. Only the record headers and
+	the keys are read.
+----------------------------------------------------------------------------------------*/
+static void
+sgc_index_load (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Checks the lengths in the record header
+----------------------------------------------------------------------------------------*/
+static int							/* 1 if the header is consistent					*/
+sgc_record_head_check (
+	SgcT_Record_Header* rh,
+	uint64_t room								/* bytes from the record to the end of	*/
+												/* the used area of the segment			*/
+);
+/*--------------------------------------------------------------------------------------
+	Calculates the CRC of the record
+----------------------------------------------------------------------------------------*/
+static uint32_t
+sgc_record_crc_calc (
+	SgcT_Record_Header* rh
+);
+/*--------------------------------------------------------------------------------------
+	Searches the slot which refers to the record
+----------------------------------------------------------------------------------------*/
+static int							/* Index of the slot, or -1 if not found			*/
+sgc_record_slot_find (
+	uint32_t seg_idx,
+	uint64_t offset,
+	SgcT_Record_Header* rh
+);
+/*--------------------------------------------------------------------------------------
+	Returns the record of the slot, NULL if the slot is stale or the record header
+	is broken. The CRC is not checked.
+----------------------------------------------------------------------------------------*/
+static SgcT_Record_Header*
+sgc_slot_record_head_get (
+	SgcT_Index_Slot* slot
+);
+/*--------------------------------------------------------------------------------------
+	Returns the record of the slot, NULL if the slot is stale or the record is
+	broken
+----------------------------------------------------------------------------------------*/
+static SgcT_Record_Header*
+sgc_slot_record_get (
+	SgcT_Index_Slot* slot
+);
+/*--------------------------------------------------------------------------------------
+	Searches the slot of the key
+----------------------------------------------------------------------------------------*/
+static int							/* Index of the slot, or -1 if not found			*/
+sgc_slot_find (
+	const unsigned char* key,
+	uint16_t klen,
+	uint32_t hash
+);
+/*--------------------------------------------------------------------------------------
+	Empties the slot and moves back the following slots of the cluster
+----------------------------------------------------------------------------------------*/
+static void
+sgc_slot_remove (
+	uint32_t index
+);
+/*--------------------------------------------------------------------------------------
+	Removes the Cob of the slot from the index and the statistics
+----------------------------------------------------------------------------------------*/
+static void
+sgc_entry_remove (
+	uint32_t index
+);
+/*--------------------------------------------------------------------------------------
+	Appends the Cob to the current segment and registers it to the index
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+sgc_cob_write (
+	CsmgrdT_Content_Entry* entry
+);
+/*--------------------------------------------------------------------------------------
+	Moves to the next segment and evicts the Cobs in it
+----------------------------------------------------------------------------------------*/
+static void
+sgc_segment_advance (
+	void
+);
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+/*--------------------------------------------------------------------------------------
+	Road the cache plugin
+----------------------------------------------------------------------------------------*/
+int
+csmgrd_segment_plugin_load (
+	CsmgrdT_Plugin_Interface* cs_in,
+	const char* config_dir
+) {
+	CSMGRD_SET_CALLBACKS (
+		sgc_cs_create, sgc_cs_destroy, sgc_cs_expire_check, sgc_cache_item_get,
+		sgc_cache_item_puts, sgc_cs_ac_cnt_inc, sgc_cache_lifetime_get);
+
+	if (config_dir) {
+		strcpy (csmgr_conf_dir, config_dir);
+	}
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Init API
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+sgc_cs_create (
+	CsmgrT_Stat_Handle stat_hdl,
+	int first_node_f
+) {
+	SgcT_Config_Param conf_param;
+	int res;
+
+	/* create handle 		*/
+	if (hdl != NULL) {
+		free (hdl);
+		hdl = NULL;
+	}
+
+	/* Init logging 	*/
+	csmgrd_log_init ("segcache", 1);
+	csmgrd_log_init2 (csmgr_conf_dir);
+#ifdef CefC_Debug
+	csmgrd_dbg_init ("segcache", csmgr_conf_dir);
+#endif // CefC_Debug
+
+	hdl = (SgcT_Cache_Handle*) calloc (1, sizeof (SgcT_Cache_Handle));
+	if (hdl == NULL) {
+		csmgrd_log_write (CefC_Log_Error, "malloc error\n");
+		return (-1);
+	}
+	hdl->index_fd = -1;
+	csmgr_stat_hdl = stat_hdl;
+
+	/* Reads config 		*/
+	if (sgc_config_read (&conf_param) < 0) {
+		csmgrd_log_write (CefC_Log_Error, "[%s] read config\n", __func__);
+		return (-1);
+	}
+	hdl->cache_capacity = conf_param.cache_capacity;
+	cef_valid_crc_init ();
+
+	/* Opens the store 		*/
+	res = sgc_store_open (&conf_param);
+	if (res < 0) {
+		csmgrd_log_write (CefC_Log_Error, "Unable to open the segment store\n");
+		return (-1);
+	}
+	if (res > 0) {
+		sgc_index_load ();
+	}
+
+	csmgrd_log_write (CefC_Log_Info, "Start\n");
+	csmgrd_log_write (CefC_Log_Info, "Store    : %s (%u x %u MB)\n",
+		hdl->store_path, hdl->seg_num, (uint32_t)(hdl->seg_size / (1024 * 1024)));
+	csmgrd_log_write (CefC_Log_Info, "Cache Capacity : "FMTU64"\n", hdl->cache_capacity);
+	if (res > 0) {
+		csmgrd_log_write (CefC_Log_Info, "Reused the index ("FMTU64" Cobs)\n", hdl->cache_cobs);
+	}
+
+	csmgrd_stat_cache_capacity_update (csmgr_stat_hdl, hdl->cache_capacity);
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Destroy content store
+----------------------------------------------------------------------------------------*/
+static void
+sgc_cs_destroy (
+	int		Last_Node_f
+) {
+	if (hdl == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock (&sgc_cs_mutex);
+	sgc_store_close ();
+	free (hdl);
+	hdl = NULL;
+	pthread_mutex_unlock (&sgc_cs_mutex);
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Check content expire
+----------------------------------------------------------------------------------------*/
+static void
+sgc_cs_expire_check (
+	void
+) {
+	SgcT_Record_Header* rh;
+	uint64_t 	nowt;
+	struct timeval tv;
+	uint32_t n;
+	uint32_t cnt;
+
+	if (pthread_mutex_trylock (&sgc_cs_mutex) != 0) {
+		return;
+	}
+	if (hdl == NULL) {
+		pthread_mutex_unlock (&sgc_cs_mutex);
+		return;
+	}
+
+	gettimeofday (&tv, NULL);
+	nowt = tv.tv_sec * 1000000llu + tv.tv_usec;
+
+	/* Checks SgcC_Expire_Check_Slots slots from where the last check stopped, 	*/
+	/* so that the mutex is not held for the whole index. Expired Cobs which 	*/
+	/* are requested before the check reaches them are removed by the lookup. 	*/
+	/* A removal may move the next slot back to n, so n is advanced only		*/
+	/* when the slot is kept.													*/
+	n = hdl->expire_pos & hdl->slot_mask;
+	for (cnt = 0 ; (cnt < SgcC_Expire_Check_Slots) && (cnt <= hdl->slot_mask) ; cnt++) {
+		if (hdl->slots[n].rec_len != 0) {
+			rh = sgc_slot_record_head_get (&hdl->slots[n]);
+			if ((rh == NULL) ||
+				(rh->cache_time < nowt) ||
+				((rh->expiry != 0) && (rh->expiry < nowt))) {
+				sgc_entry_remove (n);
+				continue;
+			}
+		}
+		n = (n + 1) & hdl->slot_mask;
+	}
+	hdl->expire_pos = n;
+
+	/* Starts writing back the index so that a crash loses less 	*/
+	msync (hdl->index_map, hdl->index_map_len, MS_ASYNC);
+
+	pthread_mutex_unlock (&sgc_cs_mutex);
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Function to read a ContentObject from the segment cache
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+sgc_cache_item_get (
+	unsigned char* key,							/* content name							*/
+	uint16_t key_size,							/* content name Length					*/
+	uint32_t seqno,								/* chunk num							*/
+	int sock,									/* received socket						*/
+	unsigned char* version,						/* version								*/
+	uint16_t ver_len							/* length of version					*/
+) {
+	SgcT_Record_Header* rh;
+	unsigned char 	trg_key[CsmgrdC_Key_Max];
+	int 			trg_key_len;
+	unsigned char	msg[CefC_Max_Length];
+	uint16_t 		msg_len = 0;
+	unsigned char*	rp;
+	uint64_t 		nowt;
+	struct timeval 	tv;
+	int 			index;
+	int				rc;
+	int 			exist_f = CefC_Csmgr_Cob_NotExist;
+
+	/* Creates the key 		*/
+	trg_key_len = csmgrd_name_chunknum_concatenate (key, key_size, seqno, trg_key);
+
+	pthread_mutex_lock (&sgc_cs_mutex);
+	if (hdl == NULL) {
+		pthread_mutex_unlock (&sgc_cs_mutex);
+		return (exist_f);
+	}
+	index = sgc_slot_find (trg_key, trg_key_len,
+				cef_hash_number_calc (CefC_Hash_Seed_Default, trg_key, trg_key_len));
+	if (index < 0) {
+		pthread_mutex_unlock (&sgc_cs_mutex);
+		return (exist_f);
+	}
+	rh = sgc_slot_record_get (&hdl->slots[index]);
+	if (rh == NULL) {
+		/* Removes the broken cache entry 		*/
+		sgc_entry_remove (index);
+		pthread_mutex_unlock (&sgc_cs_mutex);
+		return (exist_f);
+	}
+	rp = (unsigned char*) rh + sizeof (SgcT_Record_Header);
+
+	gettimeofday (&tv, NULL);
+	nowt = tv.tv_sec * 1000000llu + tv.tv_usec;
+
+	if (((rh->expiry != 0) && (nowt >= rh->expiry)) ||
+		(nowt >= rh->cache_time)) {
+		/* Removes the expiry cache entry 		*/
+		sgc_entry_remove (index);
+		pthread_mutex_unlock (&sgc_cs_mutex);
+		return (exist_f);
+	}
+
+	rc = cef_csmgr_cache_version_compare (
+			version, ver_len, rp + rh->key_len, rh->ver_len);
+	if ((rc == CefC_CV_Same) ||
+		((rc == CefC_CV_Inconsistent) && (ver_len == 0) && (rh->ver_len != 0))) {
+		/* Request is "None", so any version is OK 	*/
+		csmgrd_stat_access_count_update (csmgr_stat_hdl, rp, rh->name_len);
+
+		/* The segment may be reused once the lock is released, so the Cob 	*/
+		/* is copied out and sent after the lock is released 				*/
+		msg_len = rh->msg_len;
+		memcpy (msg, rp + rh->key_len + rh->ver_len, msg_len);
+		exist_f = CefC_Csmgr_Cob_Exist;
+	}
+	pthread_mutex_unlock (&sgc_cs_mutex);
+
+	if (exist_f == CefC_Csmgr_Cob_Exist) {
+		csmgrd_plugin_cob_msg_send (sock, msg, msg_len);
+	}
+
+	return (exist_f);
+}
+/*--------------------------------------------------------------------------------------
+	Upload content byte steream
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+sgc_cache_item_puts (
+	unsigned char* msg,
+	int msg_len
+) {
+	CsmgrdT_Content_Entry entry;
+	uint64_t nowt;
+	struct timeval tv;
+	int index = 0;
+	int res;
+
+#ifdef CefC_Debug
+	csmgrd_dbg_write (CefC_Dbg_Fine, "cob rcv thread receives %d bytes\n", msg_len);
+#endif // CefC_Debug
+
+	gettimeofday (&tv, NULL);
+	nowt = tv.tv_sec * 1000000llu + tv.tv_usec;
+
+	pthread_mutex_lock (&sgc_cs_mutex);
+	while (index < msg_len) {
+		memset (&entry, 0, sizeof (CsmgrdT_Content_Entry));
+		res = cef_csmgr_con_entry_create (&msg[index], msg_len - index, &entry);
+		if (res < 0) {
+			break;
+		}
+		index += res;
+
+		if ((hdl != NULL) && (entry.expiry >= nowt)) {
+			sgc_cob_write (&entry);
+		}
+		free (entry.msg);
+		free (entry.name);
+		if (entry.ver_len) {
+			free (entry.version);
+		}
+	}
+	pthread_mutex_unlock (&sgc_cs_mutex);
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Function to increment access count
+----------------------------------------------------------------------------------------*/
+static void
+sgc_cs_ac_cnt_inc (
+	unsigned char* key,							/* content name							*/
+	uint16_t key_size,							/* content name Length					*/
+	uint32_t seq_num							/* sequence number						*/
+) {
+	SgcT_Record_Header* rh;
+	int index;
+
+	pthread_mutex_lock (&sgc_cs_mutex);
+	if (hdl == NULL) {
+		pthread_mutex_unlock (&sgc_cs_mutex);
+		return;
+	}
+	index = sgc_slot_find (key, key_size,
+				cef_hash_number_calc (CefC_Hash_Seed_Default, key, key_size));
+	if (index >= 0) {
+		rh = sgc_slot_record_head_get (&hdl->slots[index]);
+		csmgrd_stat_access_count_update (csmgr_stat_hdl,
+			(unsigned char*) rh + sizeof (SgcT_Record_Header), rh->name_len);
+	}
+	pthread_mutex_unlock (&sgc_cs_mutex);
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	get lifetime for ccninfo
+----------------------------------------------------------------------------------------*/
+static int										/* This value MAY be -1 if the router does not know or cannot report. */
+sgc_cache_lifetime_get (
+	unsigned char* name,						/* content name							*/
+	uint16_t name_len,							/* content name Length					*/
+	uint32_t* cache_time,						/* The elapsed time (seconds) after the oldest	*/
+												/* content object of the content is cached.		*/
+	uint32_t* lifetime,							/* The lifetime (seconds) of a content object, 	*/
+												/* which is removed first among the cached content objects.*/
+	uint8_t partial_f							/* when flag is 0, exact match			*/
+												/* when flag is 1, partial match		*/
+) {
+	CsmgrT_Stat* rcd = NULL;
+	SgcT_Record_Header* rh;
+	unsigned char trg_key[CsmgrdC_Key_Max];
+	int trg_key_len;
+	uint64_t oldest_ins_time;
+	uint64_t first_expire;
+	uint64_t nowt;
+	struct timeval tv;
+	uint64_t idx;
+	int index;
+	int rc = -1;
+
+	gettimeofday (&tv, NULL);
+	nowt = tv.tv_sec * 1000000llu + tv.tv_usec;
+
+	pthread_mutex_lock (&sgc_cs_mutex);
+	if (hdl == NULL) {
+		pthread_mutex_unlock (&sgc_cs_mutex);
+		return (-1);
+	}
+
+	if (partial_f != 0) {
+		rcd = csmgrd_stat_content_info_get (csmgr_stat_hdl, name, name_len);
+		if (rcd && !rcd->expire_f) {
+			oldest_ins_time = nowt;
+			first_expire = UINT64_MAX;
+
+			for (idx = rcd->min_seq ; idx <= rcd->max_seq ; idx++) {
+				trg_key_len =
+					csmgrd_name_chunknum_concatenate (name, name_len, idx, trg_key);
+				index = sgc_slot_find (trg_key, trg_key_len,
+					cef_hash_number_calc (CefC_Hash_Seed_Default, trg_key, trg_key_len));
+				if (index < 0) {
+					continue;
+				}
+				rh = sgc_slot_record_head_get (&hdl->slots[index]);
+				if (oldest_ins_time > rh->ins_time) {
+					oldest_ins_time = rh->ins_time;
+				}
+				if (first_expire > rh->expiry) {
+					first_expire = rh->expiry;
+				}
+			}
+			*cache_time = (uint32_t)((nowt - oldest_ins_time) / 1000000);
+			if (first_expire < nowt) {
+				*lifetime = 0;
+			} else {
+				*lifetime = (uint32_t)((first_expire - nowt) / 1000000);
+			}
+			rc = 1;
+		}
+	} else {
+		index = sgc_slot_find (name, name_len,
+					cef_hash_number_calc (CefC_Hash_Seed_Default, name, name_len));
+		if (index >= 0) {
+			rh = sgc_slot_record_head_get (&hdl->slots[index]);
+			if (nowt <= rh->expiry) {
+				*cache_time = (uint32_t)((nowt - rh->ins_time) / 1000000);
+				*lifetime   = (uint32_t)((rh->expiry - nowt) / 1000000);
+				rc = 1;
+			}
+		}
+	}
+	pthread_mutex_unlock (&sgc_cs_mutex);
+
+	return (rc);
+}
+/*--------------------------------------------------------------------------------------
+	Read config file
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+sgc_config_read (
+	SgcT_Config_Param* params						/* record parameters				*/
+) {
+	FILE*	fp = NULL;								/* file pointer						*/
+	char	file_name[PATH_MAX];					/* file name						*/
+
+	char	param[4096] = {0};						/* parameter						*/
+	char	param_buff[4096] = {0};					/* param buff						*/
+	int		len;									/* read length						*/
+
+	char*	option;									/* deny option						*/
+	char*	value;									/* parameter						*/
+	char*	endptr;
+	uint64_t res;
+
+	int		i, n;
+
+	/* Inits parameters		*/
+	memset (params, 0, sizeof (SgcT_Config_Param));
+	strcpy (params->cache_path, csmgr_conf_dir);
+	params->cache_capacity = 819200;
+	params->seg_size = SgcC_Segment_Size_Default;
+	params->seg_num = SgcC_Segment_Num_Default;
+
+	/* Obtains the directory path where the csmgrd's config file is located. */
+	int sn = snprintf (file_name, sizeof(file_name), "%s/csmgrd.conf", csmgr_conf_dir);
+	if (sn < 0) {
+		csmgrd_log_write (CefC_Log_Error, "[%s] Config file dir path too long(%s)\n", __func__, csmgr_conf_dir);
+		return (-1);
+	}
+
+	/* Opens the config file. */
+	fp = fopen (file_name, "r");
+	if (fp == NULL) {
+		csmgrd_log_write (CefC_Log_Error, "[%s] open %s\n", __func__, file_name);
+		return (-1);
+	}
+
+	/* get parameter	*/
+	while (fgets (param_buff, sizeof (param_buff), fp) != NULL) {
+
+		/* Trims a read line 		*/
+		len = strlen (param_buff);
+		if ((param_buff[0] == '#') || (param_buff[0] == '\n') || (len == 0)) {
+			continue;
+		}
+		if (param_buff[len - 1] == '\n') {
+			param_buff[len - 1] = '\0';
+		}
+		for (i = 0, n = 0 ; i < len ; i++) {
+			if (param_buff[i] != ' ') {
+				param[n] = param_buff[i];
+				n++;
+			}
+		}
+
+		/* Gets option */
+		value 	= param;
+		option 	= strsep (&value, "=");
+
+		if (value == NULL) {
+			continue;
+		}
+
+		/* Records a parameter 			*/
+		if (strcmp (option, "CACHE_PATH") == 0) {
+			if (strlen (value) > CefC_Csmgr_File_Path_Length - 64) {
+				csmgrd_log_write (
+					CefC_Log_Error, "[%s] Invalid value %s=%s\n", __func__, option, value);
+				fclose (fp);
+				return (-1);
+			}
+			strcpy (params->cache_path, value);
+		} else if (strcmp (option, "CACHE_CAPACITY") == 0) {
+			endptr = "";
+			params->cache_capacity = strtoul (value, &endptr, 0);
+			if (strcmp (endptr, "") != 0) {
+				csmgrd_log_write (
+					CefC_Log_Error, "[%s] Invalid value %s=%s\n", __func__, option, value);
+				fclose (fp);
+				return (-1);
+			}
+			if ((params->cache_capacity < 1) || (params->cache_capacity > 0x40000000)) {
+				csmgrd_log_write (CefC_Log_Error,
+				"CACHE_CAPACITY must be between 1 and 1,073,741,824 inclusive "
+				"when CACHE_TYPE=segment.\n");
+				fclose (fp);
+				return (-1);
+			}
+		} else if (strcmp (option, "SEGMENT_SIZE") == 0) {
+			endptr = "";
+			res = strtoul (value, &endptr, 0);
+			if ((strcmp (endptr, "") != 0) ||
+				(res < 1) || (res > SgcC_Segment_Size_Max)) {
+				csmgrd_log_write (CefC_Log_Error,
+					"SEGMENT_SIZE must be between 1 and %d inclusive.\n",
+					SgcC_Segment_Size_Max);
+				fclose (fp);
+				return (-1);
+			}
+			params->seg_size = (uint32_t) res;
+		} else if (strcmp (option, "SEGMENT_NUM") == 0) {
+			endptr = "";
+			res = strtoul (value, &endptr, 0);
+			if ((strcmp (endptr, "") != 0) ||
+				(res < 1) || (res > SgcC_Segment_Num_Max)) {
+				csmgrd_log_write (CefC_Log_Error,
+					"SEGMENT_NUM must be between 1 and %d inclusive.\n",
+					SgcC_Segment_Num_Max);
+				fclose (fp);
+				return (-1);
+			}
+			params->seg_num = (uint32_t) res;
+		} else {
+			/* NOP */;
+		}
+	}
+	fclose (fp);
+
+	if (!(    access (params->cache_path, F_OK) == 0
+		   && access (params->cache_path, R_OK) == 0
+   		   && access (params->cache_path, W_OK) == 0
+   		   && access (params->cache_path, X_OK) == 0)) {
+		csmgrd_log_write (CefC_Log_Error,
+			"Invalid value CACHE_PATH=%s - %s\n", params->cache_path, strerror (errno));
+		return (-1);
+	}
+#ifdef CefC_Debug
+	csmgrd_dbg_write (CefC_Dbg_Fine, "params->cache_capacity="FMTU64"\n",
+						params->cache_capacity);
+	csmgrd_dbg_write (CefC_Dbg_Fine, "params->seg_size=%u\n", params->seg_size);
+	csmgrd_dbg_write (CefC_Dbg_Fine, "params->seg_num=%u\n", params->seg_num);
+#endif // CefC_Debug
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Opens the index and segment files. The files are created if they do not exist
+	or were created with other parameters.
+----------------------------------------------------------------------------------------*/
+static int							/* 1 if the store was reused, 0 if it was created,	*/
+									/* negative if an error occurs						*/
+sgc_store_open (
+	SgcT_Config_Param* params
+) {
+	char path[PATH_MAX];
+	SgcT_Index_Header* ih;
+	SgcT_Segment_Header* sh;
+	uint64_t slot_num;
+	int created_f = 0;
+	int reuse_f = 1;
+	uint32_t i;
+	int rc;
+
+	rc = snprintf (hdl->store_path, sizeof (hdl->store_path),
+			"%s/%s", params->cache_path, SgcC_Dir_Name);
+	if ((rc < 0) || (rc >= sizeof (hdl->store_path))) {
+		csmgrd_log_write (CefC_Log_Error,
+			"[%s] Cache path too long(%s)\n", __func__, params->cache_path);
+		return (-1);
+	}
+	if ((mkdir (hdl->store_path, 0755) != 0) && (errno != EEXIST)) {
+		csmgrd_log_write (CefC_Log_Error,
+			"[%s] mkdir %s - %s\n", __func__, hdl->store_path, strerror (errno));
+		return (-1);
+	}
+	hdl->seg_num  = params->seg_num;
+	hdl->seg_size = (uint64_t) params->seg_size * 1024 * 1024;
+
+	/* The index has twice as many slots as the capacity so that the probes 	*/
+	/* stay short.																*/
+	slot_num = 1;
+	while (slot_num < hdl->cache_capacity * 2) {
+		slot_num <<= 1;
+	}
+	hdl->slot_mask = (uint32_t)(slot_num - 1);
+
+	/* Maps the index 		*/
+	snprintf (path, sizeof (path), "%s/%s", hdl->store_path, SgcC_Index_File_Name);
+	hdl->index_map_len = SgcC_Index_Header_Size + slot_num * sizeof (SgcT_Index_Slot);
+	hdl->index_map = sgc_file_map (path, hdl->index_map_len, &hdl->index_fd, &created_f);
+	if (hdl->index_map == NULL) {
+		return (-1);
+	}
+	ih = (SgcT_Index_Header*) hdl->index_map;
+	hdl->index_hdr = ih;
+	hdl->slots = (SgcT_Index_Slot*)(hdl->index_map + SgcC_Index_Header_Size);
+
+	if ((created_f) ||
+		(memcmp (ih->magic, SgcC_Index_Magic, sizeof (ih->magic)) != 0) ||
+		(ih->version != SgcC_Index_Version) ||
+		(ih->slot_num != (uint32_t) slot_num) ||
+		(ih->seg_size != hdl->seg_size) ||
+		(ih->seg_num != hdl->seg_num) ||
+		(ih->cur_seg >= hdl->seg_num)) {
+		reuse_f = 0;
+	} else if (ih->clean_f == 0) {
+		/* A Cob torn by the crash fails the CRC check when it is requested 	*/
+		csmgrd_log_write (CefC_Log_Warn,
+			"The segment store was not closed cleanly, broken Cobs are dropped "
+			"when they are requested\n");
+	}
+
+	/* Maps the segments 		*/
+	hdl->seg_fds  = (int*) malloc (sizeof (int) * hdl->seg_num);
+	hdl->seg_maps = (unsigned char**) calloc (hdl->seg_num, sizeof (unsigned char*));
+	if ((hdl->seg_fds == NULL) || (hdl->seg_maps == NULL)) {
+		csmgrd_log_write (CefC_Log_Error, "malloc error\n");
+		return (-1);
+	}
+	for (i = 0 ; i < hdl->seg_num ; i++) {
+		hdl->seg_fds[i] = -1;
+	}
+	for (i = 0 ; i < hdl->seg_num ; i++) {
+		snprintf (path, sizeof (path), "%s/%s%05u",
+			hdl->store_path, SgcC_Segment_File_Prefix, i);
+		created_f = 0;
+		hdl->seg_maps[i] = sgc_file_map (path, hdl->seg_size, &hdl->seg_fds[i], &created_f);
+		if (hdl->seg_maps[i] == NULL) {
+			return (-1);
+		}
+		sh = (SgcT_Segment_Header*) hdl->seg_maps[i];
+		if ((created_f) ||
+			(memcmp (sh->magic, SgcC_Segment_Magic, sizeof (sh->magic)) != 0) ||
+			(sh->seg_idx != i) ||
+			(sh->used < SgcC_Segment_Header_Size) ||
+			(sh->used > hdl->seg_size)) {
+			/* The generation of a new segment starts again, so the slots 	*/
+			/* can not tell whether they refer to it.						*/
+			memcpy (sh->magic, SgcC_Segment_Magic, sizeof (sh->magic));
+			sh->seg_idx = i;
+			sh->gen++;
+			sh->used = SgcC_Segment_Header_Size;
+			reuse_f = 0;
+		}
+	}
+
+	if (reuse_f == 0) {
+		memset (hdl->slots, 0, slot_num * sizeof (SgcT_Index_Slot));
+		memset (ih, 0, sizeof (SgcT_Index_Header));
+		ih->version  = SgcC_Index_Version;
+		ih->slot_num = (uint32_t) slot_num;
+		ih->seg_size = hdl->seg_size;
+		ih->seg_num  = hdl->seg_num;
+		ih->cur_seg  = 0;
+		memcpy (ih->magic, SgcC_Index_Magic, sizeof (ih->magic));
+
+		/* Empties the segments since no slot refers to them anymore 	*/
+		for (i = 0 ; i < hdl->seg_num ; i++) {
+			sh = (SgcT_Segment_Header*) hdl->seg_maps[i];
+			sh->gen++;
+			sh->used = SgcC_Segment_Header_Size;
+		}
+	}
+	ih->clean_f = 0;
+	msync (hdl->index_map, SgcC_Index_Header_Size, MS_SYNC);
+
+	return (reuse_f);
+}
+/*--------------------------------------------------------------------------------------
+	Syncs and unmaps the index and segment files
+----------------------------------------------------------------------------------------*/
+static void
+sgc_store_close (
+	void
+) {
+	uint32_t i;
+
+	if (hdl->seg_maps) {
+		for (i = 0 ; i < hdl->seg_num ; i++) {
+			if (hdl->seg_maps[i]) {
+				msync (hdl->seg_maps[i], hdl->seg_size, MS_SYNC);
+				munmap (hdl->seg_maps[i], hdl->seg_size);
+			}
+			if (hdl->seg_fds[i] != -1) {
+				close (hdl->seg_fds[i]);
+			}
+		}
+		free (hdl->seg_maps);
+		hdl->seg_maps = NULL;
+	}
+	free (hdl->seg_fds);
+	hdl->seg_fds = NULL;
+
+	/* The index is marked clean only after the segments are on the disk 	*/
+	if (hdl->index_map) {
+		msync (hdl->index_map, hdl->index_map_len, MS_SYNC);
+		hdl->index_hdr->clean_f = 1;
+		msync (hdl->index_map, SgcC_Index_Header_Size, MS_SYNC);
+		munmap (hdl->index_map, hdl->index_map_len);
+		hdl->index_map = NULL;
+	}
+	if (hdl->index_fd != -1) {
+		close (hdl->index_fd);
+		hdl->index_fd = -1;
+	}
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Opens the file and maps it. The file is extended to len if it is shorter.
+----------------------------------------------------------------------------------------*/
+static unsigned char*				/* mapped address, NULL if an error occurs			*/
+sgc_file_map (
+	const char* path,
+	size_t len,
+	int* fd,
+	int* created_f								/* set to 1 if the file was extended	*/
+) {
+	struct stat st;
+	void* map;
+	int res;
+
+	*fd = open (path, O_RDWR | O_CREAT, 0644);
+	if (*fd < 0) {
+		csmgrd_log_write (CefC_Log_Error,
+			"[%s] open %s - %s\n", __func__, path, strerror (errno));
+		return (NULL);
+	}
+	if (fstat (*fd, &st) < 0) {
+		csmgrd_log_write (CefC_Log_Error,
+			"[%s] stat %s - %s\n", __func__, path, strerror (errno));
+		return (NULL);
+	}
+	if ((size_t) st.st_size != len) {
+		/* A file of another size was created with other parameters 	*/
+		if ((ftruncate (*fd, 0) < 0) || (ftruncate (*fd, len) < 0)) {
+			csmgrd_log_write (CefC_Log_Error,
+				"[%s] truncate %s - %s\n", __func__, path, strerror (errno));
+			return (NULL);
+		}
+		/* Allocates the blocks now so that a full disk is found here 	*/
+		/* rather than by SIGBUS while writing to the mapping.			*/
+		res = posix_fallocate (*fd, 0, len);
+		if ((res != 0) && (res != EOPNOTSUPP) && (res != EINVAL)) {
+			csmgrd_log_write (CefC_Log_Error,
+				"[%s] allocate %s - %s\n", __func__, path, strerror (res));
+			return (NULL);
+		}
+		*created_f = 1;
+	}
+
+	map = mmap (NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
+	if (map == MAP_FAILED) {
+		csmgrd_log_write (CefC_Log_Error,
+			"[%s] mmap %s - %s\n", __func__, path, strerror (errno));
+		return (NULL);
+	}
+
+	return ((unsigned char*) map);
+}
+/*--------------------------------------------------------------------------------------
+	Registers the Cobs of the index to the statistics. Only the record headers and
+	the keys are read.
+----------------------------------------------------------------------------------------*/
+static void
+sgc_index_load (
+	void
+) {
+	SgcT_Record_Header* rh;
+	unsigned char* rp;
+	uint32_t i;
+
+	hdl->cache_cobs = 0;
+
+	/* The headers are read in the order of the slots, so the read ahead of 	*/
+	/* the segments is disabled not to read the messages.						*/
+	for (i = 0 ; i < hdl->seg_num ; i++) {
+		madvise (hdl->seg_maps[i], hdl->seg_size, MADV_RANDOM);
+	}
+
+	/* Stale slots are not counted, and are dropped later by the expiry check. */
+	/* The CRC is checked when the Cob is requested.							*/
+	for (i = 0 ; i <= hdl->slot_mask ; i++) {
+		if (hdl->slots[i].rec_len == 0) {
+			continue;
+		}
+		rh = sgc_slot_record_head_get (&hdl->slots[i]);
+		if (rh == NULL) {
+			continue;
+		}
+		rp = (unsigned char*) rh + sizeof (SgcT_Record_Header);
+		csmgrd_stat_cob_update (csmgr_stat_hdl, rp, rh->name_len,
+			rh->chunk_num, rh->pay_len, rh->expiry, rh->ins_time, rh->node);
+		if (rh->ver_len) {
+			CsmgrT_Stat* rcd;
+			rcd = csmgrd_stat_content_info_get (csmgr_stat_hdl, rp, rh->name_len);
+			if (rcd && !rcd->ver_len) {
+				csmgrd_stat_content_info_version_init (
+					csmgr_stat_hdl, rcd, rp + rh->key_len, rh->ver_len);
+			}
+		}
+		hdl->cache_cobs++;
+	}
+
+	for (i = 0 ; i < hdl->seg_num ; i++) {
+		madvise (hdl->seg_maps[i], hdl->seg_size, MADV_NORMAL);
+	}
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Checks the lengths in the record header
+----------------------------------------------------------------------------------------*/
+static int							/* 1 if the header is consistent					*/
+sgc_record_head_check (
+	SgcT_Record_Header* rh,
+	uint64_t room								/* bytes from the record to the end of	*/
+												/* the used area of the segment			*/
+) {
+	if ((rh->rec_len < sizeof (SgcT_Record_Header)) ||
+		(rh->rec_len > room) ||
+		(SgcC_Rec_Len (rh->key_len, rh->ver_len, rh->msg_len) != rh->rec_len) ||
+		(rh->name_len > rh->key_len)) {
+		return (0);
+	}
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Calculates the CRC of the record
+----------------------------------------------------------------------------------------*/
+static uint32_t
+sgc_record_crc_calc (
+	SgcT_Record_Header* rh
+) {
+	/* covers the header after the crc field, key, version and message 	*/
+	return (cef_valid_crc32_calc (
+		(unsigned char*) rh + sizeof (rh->crc),
+		sizeof (SgcT_Record_Header) - sizeof (rh->crc)
+			+ rh->key_len + rh->ver_len + rh->msg_len));
+}
+/*--------------------------------------------------------------------------------------
+	Searches the slot which refers to the record
+----------------------------------------------------------------------------------------*/
+static int							/* Index of the slot, or -1 if not found			*/
+sgc_record_slot_find (
+	uint32_t seg_idx,
+	uint64_t offset,
+	SgcT_Record_Header* rh
+) {
+	int index;
+
+	/* The slot of the key may refer to a newer version in another record 	*/
+	index = sgc_slot_find ((unsigned char*) rh + sizeof (SgcT_Record_Header),
+				rh->key_len, rh->hash);
+	if ((index < 0) ||
+		(hdl->slots[index].seg_idx != seg_idx) ||
+		(hdl->slots[index].offset != offset)) {
+		return (-1);
+	}
+	return (index);
+}
+/*--------------------------------------------------------------------------------------
+	Returns the record of the slot, NULL if the slot is stale or the record header
+	is broken. The CRC is not checked.
+----------------------------------------------------------------------------------------*/
+static SgcT_Record_Header*
+sgc_slot_record_head_get (
+	SgcT_Index_Slot* slot
+) {
+	SgcT_Segment_Header* sh;
+	SgcT_Record_Header* rh;
+
+	if (slot->seg_idx >= hdl->seg_num) {
+		return (NULL);
+	}
+	sh = (SgcT_Segment_Header*) hdl->seg_maps[slot->seg_idx];
+	if ((slot->gen != sh->gen) ||
+		(slot->offset < SgcC_Segment_Header_Size) ||
+		(slot->rec_len < sizeof (SgcT_Record_Header)) ||
+		((uint64_t) slot->offset + slot->rec_len > sh->used)) {
+		return (NULL);
+	}
+	rh = (SgcT_Record_Header*)(hdl->seg_maps[slot->seg_idx] + slot->offset);
+	if ((rh->rec_len != slot->rec_len) ||
+		(rh->hash != slot->hash) ||
+		(!sgc_record_head_check (rh, sh->used - slot->offset))) {
+		return (NULL);
+	}
+
+	return (rh);
+}
+/*--------------------------------------------------------------------------------------
+	Returns the record of the slot, NULL if the slot is stale or the record is
+	broken
+----------------------------------------------------------------------------------------*/
+static SgcT_Record_Header*
+sgc_slot_record_get (
+	SgcT_Index_Slot* slot
+) {
+	SgcT_Record_Header* rh;
+
+	rh = sgc_slot_record_head_get (slot);
+	if ((rh == NULL) || (rh->crc != sgc_record_crc_calc (rh))) {
+		return (NULL);
+	}
+
+	return (rh);
+}
+/*--------------------------------------------------------------------------------------
+	Searches the slot of the key
+----------------------------------------------------------------------------------------*/
+static int							/* Index of the slot, or -1 if not found			*/
+sgc_slot_find (
+	const unsigned char* key,
+	uint16_t klen,
+	uint32_t hash
+) {
+	SgcT_Record_Header* rh;
+	uint32_t index = hash & hdl->slot_mask;
+	uint32_t n;
+
+	for (n = 0 ; n <= hdl->slot_mask ; n++) {
+		if (hdl->slots[index].rec_len == 0) {
+			return (-1);
+		}
+		if (hdl->slots[index].hash == hash) {
+			rh = sgc_slot_record_head_get (&hdl->slots[index]);
+			if ((rh) && (rh->key_len == klen) &&
+				(memcmp ((unsigned char*) rh + sizeof (SgcT_Record_Header),
+							key, klen) == 0)) {
+				return ((int) index);
+			}
+		}
+		index = (index + 1) & hdl->slot_mask;
+	}
+
+	return (-1);
+}
+/*--------------------------------------------------------------------------------------
+	Empties the slot and moves back the following slots of the cluster
+----------------------------------------------------------------------------------------*/
+static void
+sgc_slot_remove (
+	uint32_t index
+) {
+	uint32_t next = index;
+	uint32_t home;
+
+	while (1) {
+		next = (next + 1) & hdl->slot_mask;
+		if (hdl->slots[next].rec_len == 0) {
+			break;
+		}
+		home = hdl->slots[next].hash & hdl->slot_mask;
+
+		/* The slot stays if its home is cyclically in (index, next] 	*/
+		if (index <= next) {
+			if ((index < home) && (home <= next)) {
+				continue;
+			}
+		} else {
+			if ((index < home) || (home <= next)) {
+				continue;
+			}
+		}
+		hdl->slots[index] = hdl->slots[next];
+		index = next;
+	}
+	memset (&hdl->slots[index], 0, sizeof (SgcT_Index_Slot));
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Removes the Cob of the slot from the index and the statistics
+----------------------------------------------------------------------------------------*/
+static void
+sgc_entry_remove (
+	uint32_t index
+) {
+	SgcT_Record_Header* rh;
+
+	/* A stale slot was not counted as a cached Cob 	*/
+	rh = sgc_slot_record_head_get (&hdl->slots[index]);
+	if (rh) {
+		csmgrd_stat_cob_remove (csmgr_stat_hdl,
+			(unsigned char*) rh + sizeof (SgcT_Record_Header), rh->name_len,
+			rh->chunk_num, rh->pay_len);
+		if (hdl->cache_cobs > 0) {
+			hdl->cache_cobs--;
+		}
+	}
+	sgc_slot_remove (index);
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Appends the Cob to the current segment and registers it to the index
+----------------------------------------------------------------------------------------*/
+static int							/* The return value is negative if an error occurs	*/
+sgc_cob_write (
+	CsmgrdT_Content_Entry* entry
+) {
+	SgcT_Segment_Header* sh;
+	SgcT_Record_Header* rh;
+	SgcT_Record_Header* old_rh;
+	SgcT_Index_Slot* slot;
+	CsmgrT_Stat* rcd;
+	unsigned char key[CsmgrdC_Key_Max];
+	unsigned char* wp;
+	uint32_t key_len;
+	uint32_t rec_len;
+	uint32_t hash;
+	uint64_t nowt;
+	struct timeval tv;
+	uint32_t n;
+	int index;
+	int rc;
+
+	if ((entry->name_len + 8 > CsmgrdC_Key_Max) || (entry->msg_len == 0)) {
+		return (-1);
+	}
+	key_len = csmgrd_key_create (entry, key);
+	hash = cef_hash_number_calc (CefC_Hash_Seed_Default, key, key_len);
+	rec_len = SgcC_Rec_Len (key_len, entry->ver_len, entry->msg_len);
+	if (rec_len > hdl->seg_size - SgcC_Segment_Header_Size) {
+		return (-1);
+	}
+
+	/* Checks the version of the cached Cob 		*/
+	index = sgc_slot_find (key, key_len, hash);
+	if (index >= 0) {
+		old_rh = sgc_slot_record_head_get (&hdl->slots[index]);
+		rc = cef_csmgr_cache_version_compare (
+				entry->version, entry->ver_len,
+				(unsigned char*) old_rh + sizeof (SgcT_Record_Header) + old_rh->key_len,
+				old_rh->ver_len);
+		if (rc != CefC_CV_Newest_1stArg) {
+			return (0);
+		}
+		/* The content information of the old version is deleted when the	*/
+		/* first Cob of the new version arrives.							*/
+		rcd = csmgrd_stat_content_info_get (
+				csmgr_stat_hdl, entry->name, entry->name_len);
+		if ((rcd) &&
+			(cef_csmgr_cache_version_compare (entry->version, entry->ver_len,
+				rcd->version, rcd->ver_len) == CefC_CV_Newest_1stArg)) {
+			csmgrd_stat_content_info_delete (
+				csmgr_stat_hdl, entry->name, entry->name_len);
+		}
+		sgc_entry_remove (index);
+	}
+
+	/* Makes room 		*/
+	for (n = 0 ; (n < hdl->seg_num) && (hdl->cache_cobs >= hdl->cache_capacity) ; n++) {
+		sgc_segment_advance ();
+	}
+	if (hdl->cache_cobs >= hdl->cache_capacity) {
+		return (-1);
+	}
+	sh = (SgcT_Segment_Header*) hdl->seg_maps[hdl->index_hdr->cur_seg];
+	if (sh->used + rec_len > hdl->seg_size) {
+		sgc_segment_advance ();
+		sh = (SgcT_Segment_Header*) hdl->seg_maps[hdl->index_hdr->cur_seg];
+	}
+
+	/* Appends the record 		*/
+	rh = (SgcT_Record_Header*)(hdl->seg_maps[hdl->index_hdr->cur_seg] + sh->used);
+	memset (rh, 0, sizeof (SgcT_Record_Header));
+	rh->rec_len 	= rec_len;
+	rh->hash 		= hash;
+	rh->cache_time 	= entry->cache_time;
+	rh->expiry 		= entry->expiry;
+	rh->ins_time 	= entry->ins_time;
+	rh->chunk_num 	= entry->chunk_num;
+	rh->node 		= entry->node;
+	rh->key_len 	= (uint16_t) key_len;
+	rh->name_len 	= entry->name_len;
+	rh->ver_len 	= entry->ver_len;
+	rh->msg_len 	= entry->msg_len;
+	rh->pay_len 	= entry->pay_len;
+	wp = (unsigned char*) rh + sizeof (SgcT_Record_Header);
+	memcpy (wp, key, key_len);
+	wp += key_len;
+	if (entry->ver_len) {
+		memcpy (wp, entry->version, entry->ver_len);
+		wp += entry->ver_len;
+	}
+	memcpy (wp, entry->msg, entry->msg_len);
+	rh->crc 		= sgc_record_crc_calc (rh);
+
+	/* Registers the record to the index after the record is written 	*/
+	index = hash & hdl->slot_mask;
+	while (hdl->slots[index].rec_len != 0) {
+		index = (index + 1) & hdl->slot_mask;
+	}
+	slot = &hdl->slots[index];
+	slot->hash 		= hash;
+	slot->gen 		= sh->gen;
+	slot->offset 	= (uint32_t) sh->used;
+	slot->seg_idx 	= hdl->index_hdr->cur_seg;
+	slot->rec_len 	= rec_len;
+	sh->used += rec_len;
+	hdl->cache_cobs++;
+
+	/* Updates the content information 			*/
+	gettimeofday (&tv, NULL);
+	nowt = tv.tv_sec * 1000000llu + tv.tv_usec;
+	csmgrd_stat_cob_update (csmgr_stat_hdl, entry->name, entry->name_len,
+		entry->chunk_num, entry->pay_len, entry->expiry, nowt, entry->node);
+	if (entry->ver_len) {
+		rcd = csmgrd_stat_content_info_get (csmgr_stat_hdl, entry->name, entry->name_len);
+		if (rcd && !rcd->ver_len) {
+			csmgrd_stat_content_info_version_init (
+				csmgr_stat_hdl, rcd, entry->version, entry->ver_len);
+		}
+	}
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Moves to the next segment and evicts the Cobs in it
+----------------------------------------------------------------------------------------*/
+static void
+sgc_segment_advance (
+	void
+) {
+	SgcT_Segment_Header* sh;
+	SgcT_Record_Header* rh;
+	uint64_t offset;
+	uint32_t next;
+	int index;
+
+	next = (hdl->index_hdr->cur_seg + 1) % hdl->seg_num;
+	sh = (SgcT_Segment_Header*) hdl->seg_maps[next];
+
+	/* Walks the records of the segment and removes the slots which refer to 	*/
+	/* them, rather than scanning the whole index.								*/
+	offset = SgcC_Segment_Header_Size;
+	while (offset + sizeof (SgcT_Record_Header) <= sh->used) {
+		rh = (SgcT_Record_Header*)(hdl->seg_maps[next] + offset);
+		if (!sgc_record_head_check (rh, sh->used - offset)) {
+			break;
+		}
+		index = sgc_record_slot_find (next, offset, rh);
+		if (index >= 0) {
+			sgc_entry_remove ((uint32_t) index);
+		}
+		offset += rh->rec_len;
+	}
+
+	/* Slots left with the old generation are ignored, and are dropped by the 	*/
+	/* expiry check.															*/
+	sh->gen++;
+	sh->used = SgcC_Segment_Header_Size;
+	hdl->index_hdr->cur_seg = next;
+
+#ifdef CefC_Debug
+	csmgrd_dbg_write (CefC_Dbg_Fine, "moved to segment#%u (gen=%u)\n", next, sh->gen);
+#endif // CefC_Debug
+
+	return;
+}
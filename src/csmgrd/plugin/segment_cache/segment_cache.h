@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * segment_cache.h
+ */
+#ifndef __CSMGRD_SEGMENT_CACHE_HEADER__
+#define __CSMGRD_SEGMENT_CACHE_HEADER__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+#include <netinet/in.h>
+#include <stdint.h>
+
+#include <cefore/cef_define.h>
+#include <cefore/cef_csmgr.h>
+#include <csmgrd/csmgrd_plugin.h>
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define SgcC_Dir_Name					"csmgrd_segment"	/* Store directory name		*/
+#define SgcC_Index_File_Name			"index"				/* Index file name			*/
+#define SgcC_Segment_File_Prefix		"segment."			/* Segment file name prefix	*/
+
+#define SgcC_Index_Magic				"CEFSGIX1"
+#define SgcC_Segment_Magic				"CEFSGSG1"
+#define SgcC_Index_Version				2
+
+#define SgcC_Index_Header_Size			4096		/* Slots start at this offset		*/
+#define SgcC_Segment_Header_Size		4096		/* Records start at this offset		*/
+#define SgcC_Record_Align				8
+#define SgcC_Expire_Check_Slots			65536		/* Slots checked by an expiry check	*/
+
+/*------------------------------------------------------------------
+	Limitation
+--------------------------------------------------------------------*/
+
+#define SgcC_Segment_Size_Default		256			/* SEGMENT_SIZE in MB				*/
+#define SgcC_Segment_Size_Max			4095
+#define SgcC_Segment_Num_Default		4			/* SEGMENT_NUM						*/
+#define SgcC_Segment_Num_Max			65535
+
+/****************************************************************************************
+ Structure Declarations
+ ****************************************************************************************/
+
+typedef struct {
+
+	char			cache_path[CefC_Csmgr_File_Path_Length];
+												/* Directory which has the store		*/
+	uint64_t 		cache_capacity;				/* Max number of cached Cobs			*/
+	uint32_t		seg_size;					/* Size of a segment file in MB			*/
+	uint32_t		seg_num;					/* Number of segment files				*/
+
+} SgcT_Config_Param;
+
+/*------------------------------------------------------------------
+	On-disk formats. The index file is the header followed by the
+	slots, and a segment file is the header followed by the records.
+--------------------------------------------------------------------*/
+typedef struct {
+
+	char			magic[8];					/* SgcC_Index_Magic						*/
+	uint32_t		version;					/* SgcC_Index_Version					*/
+	uint32_t		slot_num;					/* Number of slots (power of 2)			*/
+	uint64_t		seg_size;					/* Size of a segment file in bytes		*/
+	uint32_t		seg_num;					/* Number of segment files				*/
+	uint32_t		cur_seg;					/* Segment which records are appended to*/
+	uint32_t		clean_f;					/* 1 if the store was closed cleanly	*/
+	uint32_t		reserved;
+
+} SgcT_Index_Header;
+
+typedef struct {
+
+	uint32_t		hash;						/* Hash of the key						*/
+	uint32_t		gen;						/* Generation of the segment			*/
+	uint32_t		offset;						/* Offset of the record in the segment	*/
+	uint32_t		rec_len;					/* Length of the record, 0 if empty		*/
+	uint32_t		seg_idx;					/* Segment which has the record			*/
+	uint32_t		reserved;
+
+} SgcT_Index_Slot;
+
+typedef struct {
+
+	char			magic[8];					/* SgcC_Segment_Magic					*/
+	uint32_t		gen;						/* Incremented when the segment is reused*/
+	uint32_t		seg_idx;					/* Index of the segment					*/
+	uint64_t		used;						/* Bytes used including this header		*/
+
+} SgcT_Segment_Header;
+
+typedef struct {
+
+	uint32_t		crc;						/* CRC32 of the rest of the record		*/
+	uint32_t		rec_len;					/* Length of the record					*/
+	uint32_t		hash;						/* Hash of the key						*/
+	uint32_t		chunk_num;					/* Chunk num							*/
+	uint64_t		cache_time;					/* Cache time							*/
+	uint64_t		expiry;						/* Expiry								*/
+	uint64_t		ins_time;					/* Insert time							*/
+	struct in_addr	node;						/* Node address							*/
+	uint16_t		key_len;					/* Length of the key (name + chunk)		*/
+	uint16_t		name_len;					/* Content name length					*/
+	uint16_t		ver_len;					/* Length of version					*/
+	uint16_t		msg_len;					/* Message length						*/
+	uint16_t		pay_len;					/* Payload length						*/
+	uint16_t		reserved;
+	/* followed by key, version and message 	*/
+
+} SgcT_Record_Header;
+
+typedef struct {
+
+	char			store_path[CefC_Csmgr_File_Path_Length];
+												/* Directory of the store files			*/
+	uint64_t 		cache_capacity;				/* Max number of cached Cobs			*/
+	uint64_t 		cache_cobs;					/* Number of cached Cobs				*/
+
+	/********** index 		***********/
+	int				index_fd;
+	unsigned char*	index_map;
+	size_t			index_map_len;
+	SgcT_Index_Header*	index_hdr;
+	SgcT_Index_Slot*	slots;
+	uint32_t		slot_mask;
+	uint32_t		expire_pos;					/* Slot the next expiry check starts at	*/
+
+	/********** segments 	***********/
+	uint32_t		seg_num;
+	uint64_t		seg_size;
+	int*			seg_fds;
+	unsigned char**	seg_maps;
+
+} SgcT_Cache_Handle;
+
+#endif // __CSMGRD_SEGMENT_CACHE_HEADER__
@@ -122,10 +122,10 @@ fwd_default_forward_interest (
 #endif // CefC_Debug
 
 				/* Count send Interest */
-				(*(fwdstr->cnt_send_frames))++;
-				fwdstr->cnt_send_types[fwdstr->pm->InterestType]++;
-				face->tx_int_types[fwdstr->pm->InterestType]++;
-				face->tx_int++;
+				__atomic_fetch_add (fwdstr->cnt_send_frames, 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add (&fwdstr->cnt_send_types[fwdstr->pm->InterestType], 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add (&face->tx_int_types[fwdstr->pm->InterestType], 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add (&face->tx_int, 1, __ATOMIC_RELAXED);
 
 				return;
 			}
@@ -150,10 +150,10 @@ fwd_default_forward_interest (
 #endif // CefC_Debug
 
 			/* Count send Interest */
-			(*(fwdstr->cnt_send_frames))++;
-			fwdstr->cnt_send_types[fwdstr->pm->InterestType]++;
-			face->tx_int_types[fwdstr->pm->InterestType]++;
-			face->tx_int++;
+			__atomic_fetch_add (fwdstr->cnt_send_frames, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add (&fwdstr->cnt_send_types[fwdstr->pm->InterestType], 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add (&face->tx_int_types[fwdstr->pm->InterestType], 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add (&face->tx_int, 1, __ATOMIC_RELAXED);
 
 			break;
 		}
@@ -217,7 +217,7 @@ fwd_default_forward_object (
 #endif // CefC_Debug
 
 			/* Count send ContentObject */
-			(*(fwdstr->cnt_send_frames))++;
+			__atomic_fetch_add (fwdstr->cnt_send_frames, 1, __ATOMIC_RELAXED);
 
 			cef_pit_entry_down_face_ver_remove (fwdstr->pe, face, fwdstr->pm);
 		} else {
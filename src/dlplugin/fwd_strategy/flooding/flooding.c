@@ -124,10 +124,10 @@ fwd_flooding_forward_interest (
 #endif // CefC_Debug
 
 				/* Count send Interest */
-				(*(fwdstr->cnt_send_frames))++;
-				fwdstr->cnt_send_types[fwdstr->pm->InterestType]++;
-				face->tx_int_types[fwdstr->pm->InterestType]++;
-				face->tx_int++;
+				__atomic_fetch_add (fwdstr->cnt_send_frames, 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add (&fwdstr->cnt_send_types[fwdstr->pm->InterestType], 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add (&face->tx_int_types[fwdstr->pm->InterestType], 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add (&face->tx_int, 1, __ATOMIC_RELAXED);
 
 				/* Count number of send face */
 				send_num++;
@@ -154,10 +154,10 @@ fwd_flooding_forward_interest (
 #endif // CefC_Debug
 
 				/* Count send Interest */
-				(*(fwdstr->cnt_send_frames))++;
-				fwdstr->cnt_send_types[fwdstr->pm->InterestType]++;
-				face->tx_int_types[fwdstr->pm->InterestType]++;
-				face->tx_int++;
+				__atomic_fetch_add (fwdstr->cnt_send_frames, 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add (&fwdstr->cnt_send_types[fwdstr->pm->InterestType], 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add (&face->tx_int_types[fwdstr->pm->InterestType], 1, __ATOMIC_RELAXED);
+				__atomic_fetch_add (&face->tx_int, 1, __ATOMIC_RELAXED);
 			}
 		}
 	}
@@ -219,7 +219,7 @@ fwd_flooding_forward_object (
 #endif // CefC_Debug
 
 			/* Count send ContentObject */
-			(*(fwdstr->cnt_send_frames))++;
+			__atomic_fetch_add (fwdstr->cnt_send_frames, 1, __ATOMIC_RELAXED);
 		} else {
 
 			cef_pit_down_faceid_remove (fwdstr->pe, face->faceid);
@@ -77,6 +77,8 @@
 													/* Total content capacity 			*/
 #define CefC_CnpbDefault_Block_Size			1024	/* Specify the maximum payload 		*/
 													/* length (bytes) of Content Object	*/
+#define CefC_CnpbDefault_Publish_Workers	1		/* Number of the threads to create 	*/
+													/* Content Objects					*/
 #define CefC_CnpbDefault_Node_Path			"127.0.0.1"
 #define CefC_CnpbDefault_Cefnetd_Port		CefC_Default_PortNum
 
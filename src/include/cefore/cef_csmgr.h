@@ -63,6 +63,7 @@
 /*------------------------------------------------------------------*/
 #define CefC_Default_Cache_Type			0			/* Default None						*/
 #define CefC_Default_Cache_Capacity		30000		/* Default 30000 entries			*/
+#define CefC_Default_Local_Cache_Memory	256			/* Default 256 MB of local cache	*/
 #define CefC_Default_Int_Check_Cache	10000		/* Default 10 secs					*/
 #define CefC_Default_Def_Rct			600000000	/* Default 10 minits				*/
 #define CefC_Default_Tcp_Prot			9799		/* port num between cefnetd and 	*/
@@ -121,7 +122,8 @@
 #define CefC_Csmgr_Msg_Type_SCDL		0x13		/* Type Delete cache				*/
 #define CefC_Csmgr_Msg_Type_PreCcninfo	0x14		/* Type Prepare Ccninfo message		*/
 #define CefC_Csmgr_Msg_Type_ContInfo	0x15		/* Type Get Contents Information	*/
-#define CefC_Csmgr_Msg_Type_Num			0x16
+#define CefC_Csmgr_Msg_Type_Bulk_Interest	0x16	/* Type Interest (Bulk)				*/
+#define CefC_Csmgr_Msg_Type_Num			0x17
 //#define CefC_Csmgr_Msg_Type_Num			0x15
 
 #define CefC_Csmgr_Cob_Exist			0x00		/* Type Content is exist			*/
@@ -144,6 +146,12 @@
 #define CefC_Csmgr_Interest_ChunkNum_NotExist	0	/* Chunk Num Flag off				*/
 #define CefC_Csmgr_Interest_ChunkNum_Exist		1	/* Chunk Num Flag on				*/
 
+/*------------------------------------------------------------------*/
+/* CefC_Csmgr_Msg_Type_Bulk_Interest carries the chunks from the	*/
+/* first chunk number as a bitmap of the following size (bits)		*/
+/*------------------------------------------------------------------*/
+#define CefC_Csmgr_Bulk_Interest_Map_Bits		64
+
 /*------------------------------------------------------------------*/
 /* Macros for get csmgr status										*/
 /*------------------------------------------------------------------*/
@@ -240,6 +248,7 @@ typedef struct {
 
 	/********** local Cache Information ***********/
 	uint32_t		local_cache_capacity;			/* Cache Capacity						*/
+	uint32_t		local_cache_memory;				/* Memory for the Cobs (MB)				*/
 	uint32_t		local_cache_interval;			/* Expired check cycle (sec)			*/
 	int 			pipe_fd[2];						/* socket of cefnetd->Local cache		*/
 													/*  0: for cefnetd						*/
@@ -411,6 +420,13 @@ void
 cef_csmgr_excache_item_push (
 	CefT_Cs_Stat* cs_stat					/* Content Store status						*/
 );
+/*--------------------------------------------------------------------------------------
+	Sends the lookups queued by cef_csmgr_excache_lookup to csmgr
+----------------------------------------------------------------------------------------*/
+void
+cef_csmgr_excache_lookup_push (
+	CefT_Cs_Stat* cs_stat					/* Content Store status						*/
+);
 /*--------------------------------------------------------------------------------------
 	Search and queue entry
 ----------------------------------------------------------------------------------------*/
@@ -68,6 +68,8 @@
 #define CsmgrT_Add_Maps					1000
 
 #define	CsmgrT_MAP_BASE					(64 * CsmgrT_Add_Maps)
+/* Number of summary words covering a cob_map of n words (1 bit per word)	*/
+#define CsmgrT_Sum_Words(n)				(((n) + 63) / 64)
 #define CsmgrT_NODE_MAX					100
 /****************************************************************************************
  Structure Declarations
@@ -100,6 +102,9 @@ typedef struct CsmgrT_Stat {
 
 	uint64_t 			*cob_map;
 	uint32_t			map_max;
+	uint64_t 			*sum_map;		/* bit i is set if cob_map[i] is non-zero. 	*/
+										/* shares the cob_map allocation, NULL if 	*/
+										/* the record has no summary				*/
 
 	uint32_t			map_num;		//0.8.3c
 
@@ -624,6 +629,63 @@ csmgr_stat_my_node_id_get_db(
 
 #endif
 
+/*--------------------------------------------------------------------------------------
+	Cob map queries
+	  These read cob_map a word at a time and skip empty words with sum_map when
+	  the record has one. The caller must keep the record alive while querying.
+----------------------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------------------
+	Checks whether the specified chunk is cached (1) or not (0)
+----------------------------------------------------------------------------------------*/
+int
+csmgr_stat_cob_is_cached (
+	const CsmgrT_Stat* rcd,
+	uint32_t seq
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the lowest cached chunk number (-1 if the map is empty)
+----------------------------------------------------------------------------------------*/
+int
+csmgr_stat_cob_min_get (
+	const CsmgrT_Stat* rcd,
+	uint32_t* seq
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the highest cached chunk number (-1 if the map is empty)
+----------------------------------------------------------------------------------------*/
+int
+csmgr_stat_cob_max_get (
+	const CsmgrT_Stat* rcd,
+	uint32_t* seq
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the first cached chunk number at or after from (-1 if none)
+----------------------------------------------------------------------------------------*/
+int
+csmgr_stat_cob_next_cached_get (
+	const CsmgrT_Stat* rcd,
+	uint32_t from,
+	uint32_t* seq
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the first missing chunk number at or after from (-1 if none)
+----------------------------------------------------------------------------------------*/
+int
+csmgr_stat_cob_next_missing_get (
+	const CsmgrT_Stat* rcd,
+	uint32_t from,
+	uint32_t* seq
+);
+/*--------------------------------------------------------------------------------------
+	Counts the cached chunks in [st, ed]
+----------------------------------------------------------------------------------------*/
+uint32_t
+csmgr_stat_cob_range_count (
+	const CsmgrT_Stat* rcd,
+	uint32_t st,
+	uint32_t ed
+);
+
 /****************************************************************************************
  Function Alias Declarations
  ****************************************************************************************/
@@ -136,6 +136,9 @@
 #define CefC_ParamName_CcninfoValidAlg		"CCNINFO_VALID_ALG"
 #define CefC_ParamName_CcninfoSha256KeyPrfx	"CCNINFO_SHA256_KEY_PRFX"
 #define CefC_ParamName_CcninfoReplyTimeout	"CCNINFO_REPLY_TIMEOUT"
+#define CefC_ParamName_FwdWorkerNum		"FWD_WORKER_NUM"
+#define CefC_ParamName_VerifyWorkerNum	"VERIFY_WORKER_NUM"
+#define CefC_ParamName_UdpBatchNum		"UDP_BATCH_NUM"
 
 /*************** Default Values ***************/
 #define CefC_Default_PortNum			9896
@@ -170,6 +173,9 @@
 #define CefC_Default_CcninfoValidAlg		"crc32"		/* ccninfo-05 */
 #define CefC_Default_CcninfoSha256KeyPrfx	"cefore"
 #define CefC_Default_CcninfoReplyTimeout	4
+#define CefC_Default_FwdWorkerNum		1
+#define CefC_Default_VerifyWorkerNum	0
+#define CefC_Default_UdpBatchNum		16
 
 /*************** Applications   ***************/
 #define CefC_App_Version				0xCEF00101
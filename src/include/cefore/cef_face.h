@@ -50,6 +50,7 @@
 #include <sys/fcntl.h>
 #include <unistd.h>
 #include <sys/un.h>
+#include <pthread.h>
 
 #include <cefore/cef_hash.h>
 #include <cefore/cef_define.h>
@@ -95,6 +96,7 @@ typedef struct {
 	uint32_t 		seqnum;
 	int 			ifindex;
 	int				bw_stat_i;	//0.8.3
+	pthread_mutex_t	tx_mutex;	/* serializes sending to the stream socket	*/
 } CefT_Face;
 
 /********** Neighbor Management				**********/
@@ -128,6 +130,10 @@ typedef struct {
 #define CefC_Face_Type_Udp			0x02
 #define CefC_Face_Type_Local		0x03
 
+/* Data of the epoll event of the Face, and the FD and Face-ID in it 	*/
+#define CefC_Face_Event_Data(fd, faceid)	(((uint64_t)(fd) << 32) | (uint32_t)(faceid))
+#define CefC_Face_Event_Fd(data)			((int)((data) >> 32))
+#define CefC_Face_Event_Faceid(data)		((int)((data) & 0xFFFFFFFF))
 
 /****************************************************************************************
  Function Declarations
@@ -208,9 +214,10 @@ cef_face_get_seqnum_from_faceid (
 	uint16_t 	faceid						/* Face-ID									*/
 );
 /*--------------------------------------------------------------------------------------
-	Updates the listen faces with TCP
+	Updates the listen faces with TCP. The lists are left as they are if no Face
+	has been created or closed since the last update.
 ----------------------------------------------------------------------------------------*/
-int											/* number of the listen face with TCP 		*/
+int											/* Returns 1 if the lists are rebuilt 		*/
 cef_face_update_listen_faces (
 	struct pollfd* inudpfds,
 	uint16_t* inudpfaces,
@@ -219,6 +226,15 @@ cef_face_update_listen_faces (
 	uint16_t* intcpfaces,
 	uint16_t* intcpfdc
 );
+/*--------------------------------------------------------------------------------------
+	Sets the epoll instance where the sockets of the Faces are registered. The
+	sockets are registered when the Faces are created with the data of
+	CefC_Face_Event_Data, and removed when the Faces are closed.
+----------------------------------------------------------------------------------------*/
+int											/* Returns a negative value if it fails 	*/
+cef_face_event_fd_set (
+	int epfd								/* epoll instance, or -1 to stop 			*/
+);
 /*--------------------------------------------------------------------------------------
 	Converts the specified Face-ID into the corresponding file descriptor
 ----------------------------------------------------------------------------------------*/
@@ -261,6 +277,30 @@ cef_face_frame_send_forced (
 	unsigned char* 	msg, 					/* a message to send						*/
 	size_t			msg_len					/* length of the message to send 			*/
 );
+/*--------------------------------------------------------------------------------------
+	Sets the maximum number of UDP messages sent with one system call
+----------------------------------------------------------------------------------------*/
+int											/* Returns a negative value if it fails 	*/
+cef_face_udp_batch_init (
+	int 			batch_num				/* 1 sends each message immediately 		*/
+);
+/*--------------------------------------------------------------------------------------
+	Sends a message via the specified Face. Messages to UDP Faces are held until
+	cef_face_frame_send_flush is called or the batch is full.
+----------------------------------------------------------------------------------------*/
+void
+cef_face_frame_send_batch (
+	uint16_t 		faceid, 				/* Face-ID indicating the destination 		*/
+	unsigned char* 	msg, 					/* a message to send						*/
+	size_t			msg_len					/* length of the message to send 			*/
+);
+/*--------------------------------------------------------------------------------------
+	Sends the messages held by cef_face_frame_send_batch
+----------------------------------------------------------------------------------------*/
+void
+cef_face_frame_send_flush (
+	void
+);
 /*--------------------------------------------------------------------------------------
 	Obtains the Face structure from the specified Face-ID
 ----------------------------------------------------------------------------------------*/
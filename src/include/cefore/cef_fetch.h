@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cef_fetch.h
+ */
+
+#ifndef __CEF_FETCH_HEADER__
+#define __CEF_FETCH_HEADER__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include <cefore/cef_client.h>
+#include <cefore/cef_frame.h>
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+/***** Congestion control algorithms 	*****/
+#define CefC_Fetch_Cc_Aimd			0x01	/* Additive increase/multiplicative decrease	*/
+#define CefC_Fetch_Cc_Cubic			0x02	/* CUBIC (RFC 8312)								*/
+
+/***** Window (number of chunks) 		*****/
+#define CefC_Fetch_Wnd_Init			8		/* Initial congestion window 				*/
+#define CefC_Fetch_Wnd_Min			2		/* Min congestion window 					*/
+#define CefC_Fetch_Wnd_Def			64		/* Default max window 						*/
+#define CefC_Fetch_Wnd_Max			4096	/* Max window (size of the reorder buffer) 	*/
+
+/***** Retransmission timeout (us) 		*****/
+#define CefC_Fetch_Rto_Init			200000	/* 200 ms 									*/
+#define CefC_Fetch_Rto_Min			200000	/* 200 ms 									*/
+#define CefC_Fetch_Retry_Max		6		/* Max number of retransmissions of a chunk	*/
+
+/****************************************************************************************
+ Structure Declarations
+ ****************************************************************************************/
+
+/***** Slot of the reorder buffer 		*****/
+typedef struct {
+
+	unsigned char* 	buff;					/* payload of the chunk 					*/
+	int 			buff_size;				/* size of buff 							*/
+	int 			frame_size;				/* length of the payload 					*/
+	uint64_t 		send_t;					/* time the Interest was last sent (us)		*/
+	uint8_t 		retry;					/* number of retransmissions 				*/
+
+} CefT_Fetch_Slot;
+
+/***** Fetch engine 					*****/
+/* Chunks are requested from the first chunk number of the Interest parameters in 	*/
+/* order. The chunks in [head, next_seq) have a slot in the reorder buffer, and the	*/
+/* two bitmaps tell which of them have been received and which are still pending. 	*/
+typedef struct {
+
+	CefT_Client_Handle 	fhdl;				/* client handle 							*/
+	CefT_CcnMsg_OptHdr 	opt;				/* Option Header of the Interests 			*/
+	CefT_CcnMsg_MsgBdy 	params;				/* Interest parameters 						*/
+	int 				cc_type;			/* CefC_Fetch_Cc_Xxx 						*/
+
+	/* reorder buffer 		*/
+	uint32_t 			wnd_max;			/* number of the slots (power of 2) 		*/
+	uint32_t 			mask;				/* wnd_max - 1 								*/
+	CefT_Fetch_Slot* 	slots;
+	uint64_t* 			rcv_map;			/* received and not delivered 				*/
+	uint64_t* 			req_map;			/* requested and not received 				*/
+	uint64_t 			head;				/* next chunk to deliver 					*/
+	uint64_t 			next_seq;			/* next chunk to request 					*/
+	uint64_t 			last_seq;			/* last chunk to request 					*/
+	uint32_t 			inflight;			/* number of the pending Interests 			*/
+
+	/* congestion control 	*/
+	double 				cwnd;				/* congestion window 						*/
+	double 				cwnd_max;			/* max window 								*/
+	double 				ssthresh;			/* slow start threshold 					*/
+	uint64_t 			recover_seq;		/* losses of the chunks before this chunk 	*/
+											/* do not reduce the window again 			*/
+	double 				w_max;				/* CUBIC: window before the last reduction 	*/
+	double 				cubic_k;			/* CUBIC: time to reach w_max (sec) 		*/
+	uint64_t 			epoch_t;			/* CUBIC: start of the current epoch (us) 	*/
+
+	/* RTT estimation (RFC 6298) 	*/
+	uint64_t 			srtt;				/* smoothed RTT (us) 						*/
+	uint64_t 			rttvar;				/* RTT variation (us) 						*/
+	uint64_t 			rto;				/* retransmission timeout (us) 				*/
+	uint64_t 			rto_max;			/* max timeout (us) 						*/
+	uint64_t 			next_check_t;		/* earliest timeout of the pending chunks 	*/
+	int 				retry_max;
+
+} CefT_Fetch;
+
+/****************************************************************************************
+ Global Variables
+ ****************************************************************************************/
+
+
+
+/****************************************************************************************
+ Function Declarations
+ ****************************************************************************************/
+
+/*--------------------------------------------------------------------------------------
+	Creates the fetch engine. The chunks from params->chunk_num to last_chunk are
+	requested with the Interests created from opt and params.
+----------------------------------------------------------------------------------------*/
+CefT_Fetch* 								/* Created fetch engine 					*/
+cef_fetch_create (
+	CefT_Client_Handle fhdl,				/* client handle 							*/
+	CefT_CcnMsg_OptHdr* opt,				/* parameters to Option Header(s)			*/
+	CefT_CcnMsg_MsgBdy* params,				/* parameters to create the Interests 		*/
+	int cc_type,							/* CefC_Fetch_Cc_Xxx 						*/
+	uint32_t wnd_max,						/* max window (chunks) 						*/
+	uint32_t last_chunk						/* last chunk number to request 			*/
+);
+/*--------------------------------------------------------------------------------------
+	Destroys the fetch engine
+----------------------------------------------------------------------------------------*/
+void
+cef_fetch_destroy (
+	CefT_Fetch* fp							/* fetch engine 							*/
+);
+/*--------------------------------------------------------------------------------------
+	Returns the congestion control algorithm of the specified name
+----------------------------------------------------------------------------------------*/
+int											/* CefC_Fetch_Cc_Xxx, or -1 if invalid 		*/
+cef_fetch_cc_type_get (
+	const char* name						/* "aimd" or "cubic" 						*/
+);
+/*--------------------------------------------------------------------------------------
+	Sends the Interests of the initial window
+----------------------------------------------------------------------------------------*/
+void
+cef_fetch_start (
+	CefT_Fetch* fp							/* fetch engine 							*/
+);
+/*--------------------------------------------------------------------------------------
+	Reads the message from cefnetd. Waits until the message arrives or the next
+	retransmission timeout.
+----------------------------------------------------------------------------------------*/
+int 										/* length of read buffer 					*/
+cef_fetch_read (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	unsigned char* buff, 					/* buffer to write the message 				*/
+	int len 								/* length of buffer 						*/
+);
+/*--------------------------------------------------------------------------------------
+	Stores the received chunk in the reorder buffer
+----------------------------------------------------------------------------------------*/
+int											/* 1 if stored, 0 if not requested or 		*/
+											/* already received 						*/
+cef_fetch_frame_input (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	struct cef_app_frame* app_frame			/* received frame 							*/
+);
+/*--------------------------------------------------------------------------------------
+	Removes the next chunk in order from the reorder buffer. The payload is valid
+	until the next call of the fetch APIs.
+----------------------------------------------------------------------------------------*/
+int											/* 1 if the chunk is returned 				*/
+cef_fetch_frame_get (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	unsigned char** payload,				/* payload of the chunk 					*/
+	int* payload_len,						/* length of the payload 					*/
+	uint32_t* chunk_num						/* chunk number 							*/
+);
+/*--------------------------------------------------------------------------------------
+	Retransmits the Interests whose timeout expired
+----------------------------------------------------------------------------------------*/
+int											/* -1 if a chunk was retransmitted too many	*/
+											/* times 									*/
+cef_fetch_timer_process (
+	CefT_Fetch* fp							/* fetch engine 							*/
+);
+/*--------------------------------------------------------------------------------------
+	Checks whether all the chunks have been delivered
+----------------------------------------------------------------------------------------*/
+int											/* 1 if completed 							*/
+cef_fetch_completed (
+	CefT_Fetch* fp							/* fetch engine 							*/
+);
+
+#endif // __CEF_FETCH_HEADER__
@@ -41,6 +41,7 @@
 
 #include <cefore/cef_hash.h>
 #include <cefore/cef_define.h>
+#include <cefore/cef_frame.h>
 
 /****************************************************************************************
  Macros
@@ -129,6 +130,16 @@ cef_fib_entry_search (
 	unsigned char* name, 					/* Key of the FIB entry						*/
 	uint16_t name_len						/* Length of Key							*/
 );
+/*--------------------------------------------------------------------------------------
+	Searches FIB entry matching the prefix of the name of the parsed message,
+	using the prefix hashes of its name descriptor
+----------------------------------------------------------------------------------------*/
+CefT_Fib_Entry* 							/* FIB entry 								*/
+cef_fib_entry_search_with_desc (
+	CefT_Hash_Handle fib,					/* FIB										*/
+	CefT_CcnMsg_MsgBdy* pm, 				/* Parsed CEFORE message					*/
+	uint16_t name_len						/* Length of the prefix of pm->name			*/
+);
 /*--------------------------------------------------------------------------------------
 	Obtains Face-ID(s) to forward the Interest matching the specified FIB entry
 ----------------------------------------------------------------------------------------*/
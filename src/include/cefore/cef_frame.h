@@ -557,7 +557,8 @@ typedef struct _CefT_MsgOrg_Params_t {
 
 	uint8_t					version_f;
 	uint16_t				version_len;
-	unsigned char			version_val[CefC_Max_Length];
+	unsigned char*			version_val;			/* Points to the parsed message or 	*/
+													/* the buffer of the caller 		*/
 
 	/***** T_PUTVERIFY TLV					*****/
 	uint8_t					putverify_f;			/* If it is not 0, T_PUTVERIFY is set	*/
@@ -611,8 +612,26 @@ typedef struct _CefT_CcnMsg_OptHdr_t {
 } CefT_CcnMsg_OptHdr;
 #define CeforeLifetime(op,n) {(op)->lifetime_f=1; (op)->lifetime=(n);}
 
+/*--------------------------------------------------------------*/
+/* Name descriptor												*/
+/* End offsets of the name components and the hash values of 	*/
+/* the prefixes ending there, calculated once per message with	*/
+/* CefC_Hash_Seed_Default. len is 0 if the name is not 			*/
+/* described (too many components or a broken TLV).			*/
+/*--------------------------------------------------------------*/
+#define CefC_Name_Desc_Comp_Max		32
+typedef struct {
+	uint16_t		len;						/* Length of the described name 		*/
+	uint16_t		comp_num;					/* Number of components					*/
+	uint16_t		offs[CefC_Name_Desc_Comp_Max];	/* End offset of each component		*/
+	uint32_t		hashv[CefC_Name_Desc_Comp_Max];	/* Hash value of each prefix		*/
+} CefT_Name_Desc;
+
 /*--------------------------------------------------------------*/
 /* Parameters to CEFORE message									*/
+/* payload, discreply_val, org_val and org.version_val point to	*/
+/* the buffer of the message. After cef_frame_message_parse,	*/
+/* they are valid only while the parsed message is.				*/
 /*--------------------------------------------------------------*/
 #define	CefC_HashVal_Len	32
 typedef struct _CefT_CcnMsg_MsgBdy_t {
@@ -627,7 +646,6 @@ typedef struct _CefT_CcnMsg_MsgBdy_t {
 	/***** NAME TLV			*****/
 	uint16_t		name_f;						/* Offset of Name 						*/
 	uint16_t		name_len;					/* Length of Name 						*/
-	uchar_t 		name[CefC_Max_Length];		/* Name 								*/
 	uint16_t		chunk_num_f;				/* Offset of Chunk Number 				*/
 	uint16_t		chunk_len;					/* Length of Chunk Number 				*/
 	uint32_t		chunk_num;					/* Chunk Number 						*/
@@ -642,12 +660,12 @@ typedef struct _CefT_CcnMsg_MsgBdy_t {
 	/***** PAYLOAD TLV 		*****/
 	uint16_t		payload_f;					/* Offset of Payload					*/
 	uint16_t		payload_len;				/* Length of Payload 					*/
-	uchar_t 		payload[CefC_Max_Length]; 	/* Payload 								*/
+	uchar_t* 		payload; 					/* Payload 								*/
 
 	/***** DISC_REPLY TLV		*****/
 	uint16_t		discreply_f;				/* Offset of Disc Reply					*/
 	uint16_t		discreply_len;				/* Length of Disc Reply 				*/
-	uchar_t 		discreply_val[CefC_Max_Length]; /* Disc Reply 						*/
+	uchar_t* 		discreply_val; 				/* Disc Reply 							*/
 
 	/***** Metadata TLV		*****/
 	int				expiry_f;					/* *0.8.3c */
@@ -659,7 +677,7 @@ typedef struct _CefT_CcnMsg_MsgBdy_t {
 
 	/***** Organization-Specific Parameters	*****/
 	uint16_t 	org_len;						/* Length of Vendor Specific Information */
-	uchar_t 	org_val[CefC_Max_Length];		/* Vendor Specific binary data value	*/
+	uchar_t* 	org_val;						/* Vendor Specific binary data value	*/
 	CefT_MsgOrg_Params 		org;				/* Vendor Specific parameters			*/
 
 	/***** Validation Algorithm TLV 	*****/
@@ -676,6 +694,17 @@ typedef struct _CefT_CcnMsg_MsgBdy_t {
 	uint16_t		ObjHash_len;				/* Length of ObjHash					*/
 	uchar_t		 	ObjHash_val[CefC_HashVal_Len];	/* ObjHash							*/
 
+	/***** Name Descriptor	*****/
+	/* Valid while name_len is equal to name_desc.len. The code that rewrites 	*/
+	/* the name falls back to hashing the name.									*/
+	CefT_Name_Desc	name_desc;
+
+	/***** Name 			*****/
+	/* The Chunk Number is re-encoded at the end of the name, so the name is 	*/
+	/* copied. It is placed last since cef_frame_message_parse clears only the 	*/
+	/* fields before it.														*/
+	uchar_t 		name[CefC_Max_Length];		/* Name 								*/
+
 } CefT_CcnMsg_MsgBdy;
 #define Cef_Int_Regular(msg)     {(msg).org.symbolic_f=0; (msg).org.longlife_f=0;}
 #define Cef_Int_ReguLong(msg)    {(msg).org.symbolic_f=0; (msg).org.longlife_f=1;}
@@ -781,6 +810,25 @@ cef_frame_conversion_uri_to_name (
 	const char* inuri, 						/* URI										*/
 	unsigned char* name						/* buffer to set Name 						*/
 );
+/*--------------------------------------------------------------------------------------
+	Creates the descriptor of the name
+----------------------------------------------------------------------------------------*/
+void
+cef_frame_name_desc_create (
+	const unsigned char* name,				/* Name (Value of T_NAME)					*/
+	uint16_t name_len,						/* Length of Name 							*/
+	CefT_Name_Desc* nd						/* set the descriptor						*/
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the hash value of the prefix of the name from the descriptor
+----------------------------------------------------------------------------------------*/
+int 										/* 1 if the prefix is described, 0 if not	*/
+cef_frame_name_desc_hashv_get (
+	const CefT_CcnMsg_MsgBdy* pm,			/* Parsed CEFORE message					*/
+	const unsigned char* name,				/* pm->name, or another name				*/
+	uint16_t len,							/* Length of the prefix						*/
+	uint32_t* hashv							/* set the hash value						*/
+);
 /*--------------------------------------------------------------------------------------
 	Creates a Link Request message
 ----------------------------------------------------------------------------------------*/
@@ -863,7 +911,8 @@ cef_frame_opheader_cachetime_update (
 	uint64_t		cachetime
 );
 /*--------------------------------------------------------------------------------------
-	Parses a message
+	Parses a message. The parsed Payload, Disc Reply, Org and Version point to msg,
+	so the caller copies them out if it keeps them after msg is released.
 ----------------------------------------------------------------------------------------*/
 int 										/* Returns a negative value if it fails 	*/
 cef_frame_message_parse (
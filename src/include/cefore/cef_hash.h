@@ -64,6 +64,18 @@
 #if 1
 #define CefC_Max_KLen 				1024
 #endif
+#define CefC_Hash_Key_Align			16			/* Unit of the key buffer size of a slot	*/
+#define CefC_Hash_Load_Max			75			/* Load (%) that starts the rehash of a		*/
+												/* table that allows resizing				*/
+#define CefC_Hash_Rehash_Step		64			/* Slots moved per update while rehashing	*/
+#define CefC_Hash_Probe_Max			64			/* Longest probe distance of an entry. A	*/
+												/* table that allows resizing is rehashed	*/
+												/* when it is reached, the others fail the	*/
+												/* insert									*/
+
+/* Seed of the hash tables that must give the same hash value to the same key 		*/
+/* (lhash tables, csmgr stat, memory caches)										*/
+#define CefC_Hash_Seed_Default		0x2d358dcc
 
 /* [Coefficients for expanding hash tables]                                         */
 /* Hash tables other than the following do not use coefficients.                    */
@@ -79,10 +91,11 @@ typedef size_t CefT_Hash_Handle;
 
 #if 1
 typedef struct CefT_Hash_Table {
-	uint32_t 		hash;
-	unsigned char 	key[CefC_Max_KLen + 1];
+	uint32_t 		hash;				/* Hash value (compared before the key)		*/
+	uint32_t 		klen;				/* 0: empty, -1: removed					*/
+	unsigned char* 	key;				/* Key buffer allocated out of the slot 	*/
 	void* 			elem;
-	uint32_t 		klen;
+	uint16_t 		kcap;				/* Size of the key buffer 					*/
 	uint8_t			opt_f;
 } CefT_Hash_Table;
 
@@ -92,6 +105,15 @@ typedef struct CefT_Hash {
 	uint32_t 			elem_max;			/* Prime numbers larger than the user defined maximum size */
 	uint32_t 			elem_num;
 	uint32_t 			def_elem_max;		/* User defined maximum size	*/
+	uint32_t 			tomb_num;			/* Number of removed slots		*/
+	uint32_t 			probe_max;			/* Longest probe distance of the entries	*/
+												/* (up to CefC_Hash_Probe_Max)				*/
+	uint8_t 			resize_f;			/* Entries may move to a larger table		*/
+	CefT_Hash_Table*	old_tbl;			/* Table being rehashed into tbl			*/
+	uint32_t 			old_max;
+	uint32_t 			old_probe_max;
+	uint32_t 			old_idx;			/* Next slot of old_tbl to move 			*/
+	CefT_Hash_Table*	retired_tbl;		/* Table moved by the previous rehash		*/
 } CefT_Hash;
 #endif
 /****************************************************************************************
@@ -103,6 +125,27 @@ typedef struct CefT_Hash {
 /****************************************************************************************
  Function Declarations
  ****************************************************************************************/
+/*--------------------------------------------------------------------------------------
+	Calculates the seeded hash value of the specified key
+----------------------------------------------------------------------------------------*/
+uint32_t
+cef_hash_number_calc (
+	uint32_t seed,
+	const unsigned char* key,
+	uint32_t klen
+);
+/*--------------------------------------------------------------------------------------
+	Calculates the seeded hash values of the prefixes of the key in one pass.
+	hashv[i] is equal to cef_hash_number_calc (seed, key, offs[i]).
+----------------------------------------------------------------------------------------*/
+void
+cef_hash_number_prefix_calc (
+	uint32_t seed,
+	const unsigned char* key,
+	const uint16_t offs[],					/* Lengths of the prefixes in ascending order	*/
+	int num,
+	uint32_t hashv[]
+);
 
 CefT_Hash_Handle
 cef_hash_tbl_create (
@@ -119,6 +162,19 @@ void
 cef_hash_tbl_destroy (
 	CefT_Hash_Handle handle
 );
+void
+cef_hash_tbl_resize_enable (
+	CefT_Hash_Handle handle
+);
+/*--------------------------------------------------------------------------------------
+	Sets the seed of the empty table. A table whose seed is CefC_Hash_Seed_Default
+	may be searched with the hash values calculated out of the table.
+----------------------------------------------------------------------------------------*/
+int
+cef_hash_tbl_seed_set (
+	CefT_Hash_Handle handle,
+	uint32_t seed
+);
 int
 cef_hash_tbl_item_set (
 	CefT_Hash_Handle handle,
@@ -149,6 +205,13 @@ cef_hash_tbl_item_get (
 	uint32_t klen
 );
 void*
+cef_hash_tbl_item_get_hashv (
+	CefT_Hash_Handle handle,
+	const unsigned char* key,
+	uint32_t klen,
+	uint32_t hash						/* Hash value of the key with the table seed	*/
+);
+void*
 cef_hash_tbl_item_get_for_app (
 	CefT_Hash_Handle handle,
 	const unsigned char* key,
@@ -225,6 +288,13 @@ cef_hash_tbl_item_get_prg (
 	const unsigned char* key,
 	uint32_t klen
 );
+void*
+cef_hash_tbl_item_get_prg_hashv (
+	CefT_Hash_Handle handle,
+	const unsigned char* key,
+	uint32_t klen,
+	uint32_t hash						/* Hash value of the key with the table seed	*/
+);
 
 CefT_Hash_Handle
 cef_lhash_tbl_create (
@@ -259,6 +329,14 @@ cef_lhash_tbl_item_set (
 	uint32_t klen,
 	void* elem
 );
+int
+cef_lhash_tbl_item_set_hashv (
+	CefT_Hash_Handle handle,
+	const unsigned char* key,
+	uint32_t klen,
+	uint32_t hash,						/* Hash value of the key with the default seed	*/
+	void* elem
+);
 void*
 cef_lhash_tbl_item_get (
 	CefT_Hash_Handle handle,
@@ -266,6 +344,13 @@ cef_lhash_tbl_item_get (
 	uint32_t klen
 );
 void*
+cef_lhash_tbl_item_get_hashv (
+	CefT_Hash_Handle handle,
+	const unsigned char* key,
+	uint32_t klen,
+	uint32_t hash						/* Hash value of the key with the default seed	*/
+);
+void*
 cef_lhash_tbl_item_remove (
 	CefT_Hash_Handle handle,
 	const unsigned char* key,
@@ -140,7 +140,8 @@ typedef struct {
 ----------------------------------------------------------------------------------------*/
 int
 cef_mem_cache_init(
-		uint32_t		capacity
+		uint32_t		capacity,					/* Max number of Cobs				*/
+		uint64_t		mem_size					/* Max bytes used by the Cobs		*/
 );
 /*--------------------------------------------------------------------------------------
 	A thread that puts a content object in the local cache
@@ -171,12 +172,30 @@ cef_mem_cache_item_set (
 	CefMemCacheT_Content_Entry* entry
 );
 /*--------------------------------------------------------------------------------------
-	Function to read a ContentObject from Local Cache
+	Function to read a ContentObject from Local Cache. The Cob is copied to buff.
 ----------------------------------------------------------------------------------------*/
-CefMemCacheT_Content_Mem_Entry*
+int									/* Length of the Cob, or -1 if it is not cached		*/
 cef_mem_cache_item_get (
 	unsigned char* trg_key,						/* content name							*/
-	uint16_t trg_key_len						/* content name Length					*/
+	uint16_t trg_key_len,						/* content name Length					*/
+	int ver_f,									/* 1 to match the version				*/
+	unsigned char* ver,							/* version								*/
+	uint16_t ver_len,							/* version length						*/
+	unsigned char* buff							/* buffer to copy the Cob, or NULL		*/
+);
+/*--------------------------------------------------------------------------------------
+	Same as cef_mem_cache_item_get, with the hash value of the content name
+	calculated with CefC_Hash_Seed_Default
+----------------------------------------------------------------------------------------*/
+int									/* Length of the Cob, or -1 if it is not cached		*/
+cef_mem_cache_item_get_hashv (
+	unsigned char* trg_key,						/* content name							*/
+	uint16_t trg_key_len,						/* content name Length					*/
+	uint32_t hash,								/* hash value of the content name		*/
+	int ver_f,									/* 1 to match the version				*/
+	unsigned char* ver,							/* version								*/
+	uint16_t ver_len,							/* version length						*/
+	unsigned char* buff							/* buffer to copy the Cob, or NULL		*/
 );
 /*--------------------------------------------------------------------------------------
 	Destroy local cache resources
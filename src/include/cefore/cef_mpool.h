@@ -40,6 +40,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <time.h>
 
 #include <cefore/cef_define.h>
@@ -54,13 +55,23 @@
 /****************************************************************************************
  Macros
  ****************************************************************************************/
-
+#define CefC_Mp_Pool_Max			64		/* Max number of pools with the thread cache */
+#define CefC_Mp_Stat_Key_Len		32		/* Max length of the key in the statistics 	*/
 
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
 typedef size_t CefT_Mp_Handle;
 
+/***** Statistics of a memory pool 	*****/
+typedef struct {
+	char 		key[CefC_Mp_Stat_Key_Len];	/* Key of the memory pool 					*/
+	size_t 		size;						/* Size of 1 block 							*/
+	size_t 		block_num;					/* Number of the allocated blocks 			*/
+	size_t 		used_num;					/* Number of the blocks in use 				*/
+	size_t 		peak_num;					/* High-water mark of used_num 				*/
+} CefT_Mp_Stat;
+
 /****************************************************************************************
  Function declaration
  ****************************************************************************************/
@@ -86,4 +97,10 @@ cef_mpool_free (
 	CefT_Mp_Handle ph,
 	void* ptr
 );
+
+int 										/* Number of the memory pools 				*/
+cef_mpool_stat_get (
+	CefT_Mp_Stat* stats,					/* buffer to set the statistics 			*/
+	int max									/* size of the buffer 						*/
+);
 #endif // __CEF_MPOOL_HEADER__
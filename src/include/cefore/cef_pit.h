@@ -56,6 +56,9 @@
 											/* registered in 1 Down Face Entry (other than AnyVer) */
 
 #define	CefC_Pit_CleaningTime		1000000U
+#define	CefC_Pit_Wheel_Tick			10000U	/* Granularity of the expiry wheel (us) 	*/
+#define	CefC_Pit_Wheel_Slot_Num		1024	/* Number of slots of the expiry wheel 		*/
+#define	CefC_Pit_Wheel_Max			32		/* Max number of PITs having the wheel 		*/
 #define	CefC_Pit_WithoutLOCK	0
 #define	CefC_Pit_WithLOCK		(~CefC_Pit_WithoutLOCK)
 
@@ -116,7 +119,7 @@ typedef struct CefT_Up_Faces {
 /* PIT entry														*/
 /*------------------------------------------------------------------*/
 
-typedef struct {
+typedef struct CefT_Pit_Entry {
 
 	unsigned char 		resv4malloc[16];	/* reserved area for malloc					*/
 
@@ -143,6 +146,14 @@ typedef struct {
 	unsigned int 		COBHR_len;			/* COBHR_selector Len 						*/
 	unsigned char* 		COBHR_selector;		/* ContentObjectHashRestriction selector 	*/
 
+	/*--------------------------------------------
+		Variables related to the expiry wheel
+	----------------------------------------------*/
+	struct CefT_Pit_Wheel* wheel;			/* expiry wheel of the PIT, or NULL 		*/
+	uint64_t			expire_us;			/* time to visit this entry 				*/
+	struct CefT_Pit_Entry* tw_next;			/* next entry in the same slot 				*/
+	struct CefT_Pit_Entry** tw_pprev;		/* link pointing to this entry, or NULL 	*/
+
 #ifdef	CefC_PitEntryMutex
 	pthread_mutex_t 	pe_mutex_pt;		/* mutex for thread safe for Pthread 		*/
 #endif	// CefC_PitEntryMutex
@@ -279,6 +290,46 @@ cef_pit_clean (
 	CefT_Hash_Handle pit,					/* PIT										*/
 	CefT_Pit_Entry* entry 					/* PIT entry 								*/
 );
+/*--------------------------------------------------------------------------------------
+	Creates the expiry wheel of the specified PIT. The entries of the PIT are
+	visited by cef_pit_expired_entry_get when they may expire, instead of
+	walking the whole PIT.
+----------------------------------------------------------------------------------------*/
+int 										/* Returns a negative value if it fails 	*/
+cef_pit_wheel_create (
+	CefT_Hash_Handle pit					/* PIT										*/
+);
+/*--------------------------------------------------------------------------------------
+	Destroys the expiry wheel of the specified PIT
+----------------------------------------------------------------------------------------*/
+void
+cef_pit_wheel_destroy (
+	CefT_Hash_Handle pit					/* PIT										*/
+);
+/*--------------------------------------------------------------------------------------
+	Takes out a PIT entry whose expiry time has passed. The caller cleans the
+	entry, then frees it or puts it back with cef_pit_entry_expiry_update.
+----------------------------------------------------------------------------------------*/
+CefT_Pit_Entry* 							/* a PIT entry, or NULL if none				*/
+cef_pit_expired_entry_get (
+	CefT_Hash_Handle pit,					/* PIT										*/
+	uint64_t now							/* current time (usec) 						*/
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the time when cef_pit_expired_entry_get has to be called next
+----------------------------------------------------------------------------------------*/
+uint64_t									/* time (usec), or UINT64_MAX if the wheel 	*/
+											/* has no entries 							*/
+cef_pit_wheel_next_get (
+	CefT_Hash_Handle pit					/* PIT										*/
+);
+/*--------------------------------------------------------------------------------------
+	Recalculates the expiry time of the PIT entry and puts it into the wheel
+----------------------------------------------------------------------------------------*/
+void
+cef_pit_entry_expiry_update (
+	CefT_Pit_Entry* entry 					/* PIT entry 								*/
+);
 /*--------------------------------------------------------------------------------------
 	Removes the specified FaceID from the specified PIT entry
 ----------------------------------------------------------------------------------------*/
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cef_publish.h
+ */
+
+#ifndef __CEF_PUBLISH_HEADER__
+#define __CEF_PUBLISH_HEADER__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include <cefore/cef_frame.h>
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+/***** Framing workers 					*****/
+#define CefC_Publish_Worker_Def		1		/* Default number of the workers 			*/
+#define CefC_Publish_Worker_Max		32		/* Max number of the workers 				*/
+#define CefC_Publish_Que_Per_Worker	4		/* Slots per worker 						*/
+#define CefC_Publish_Que_Min		8		/* Min number of the slots 					*/
+
+/****************************************************************************************
+ Structure Declarations
+ ****************************************************************************************/
+
+/***** Slot of the framing queue 		*****/
+typedef struct {
+
+	unsigned char* 	payload;				/* payload of the chunk 					*/
+	uint16_t 		payload_len;			/* length of the payload 					*/
+	uint32_t 		chunk_num;				/* chunk number 							*/
+	int 			end_f;					/* 1 if the chunk is the last chunk 		*/
+	unsigned char* 	cob;					/* created Content Object 					*/
+	int 			cob_len;				/* result of cef_frame_object_create 		*/
+	int 			done_f;					/* 1 if the Content Object is created 		*/
+
+} CefT_Publish_Slot;
+
+/***** Publishing pipeline 				*****/
+/* The caller puts the chunks in order and the workers frame and sign them in 		*/
+/* parallel. The Content Objects are taken out in the same order as the chunks were	*/
+/* put. The chunks in [get_seq, work_seq) are being framed and the chunks in 		*/
+/* [work_seq, put_seq) are waiting for a worker. 									*/
+typedef struct {
+
+	CefT_CcnMsg_OptHdr 	opt;				/* Option Header of the Content Objects 	*/
+	CefT_CcnMsg_MsgBdy* params;				/* parameters of each worker 				*/
+	uint8_t 			end_chunk_num_f;	/* end chunk number of the parameters 		*/
+	uint32_t 			end_chunk_num;
+	int 				worker_num;			/* number of the workers 					*/
+	pthread_t* 			workers;
+
+	/* framing queue 		*/
+	uint32_t 			que_size;			/* number of the slots 						*/
+	CefT_Publish_Slot* 	slots;
+	uint64_t 			put_seq;			/* next slot to put 						*/
+	uint64_t 			work_seq;			/* next slot to frame 						*/
+	uint64_t 			get_seq;			/* next slot to take out 					*/
+
+	pthread_mutex_t 	mutex;
+	pthread_cond_t 		work_cond;			/* signaled when a chunk is put 			*/
+	pthread_cond_t 		done_cond;			/* signaled when a Content Object is created*/
+	int 				running_f;
+	int 				worker_idx;			/* index of the next worker to start 		*/
+
+} CefT_Publish;
+
+/****************************************************************************************
+ Global Variables
+ ****************************************************************************************/
+
+
+
+/****************************************************************************************
+ Function Declarations
+ ****************************************************************************************/
+
+/*--------------------------------------------------------------------------------------
+	Creates the publishing pipeline. The Content Objects are created from opt and
+	params with the payload, chunk number and end chunk number of each chunk. If
+	worker_num is 1 or less, the chunks are framed in the caller's thread.
+----------------------------------------------------------------------------------------*/
+CefT_Publish* 								/* Created pipeline 						*/
+cef_publish_create (
+	CefT_CcnMsg_OptHdr* opt,				/* parameters to Option Header(s)			*/
+	CefT_CcnMsg_MsgBdy* params,				/* parameters to create the Content Objects	*/
+	int worker_num,							/* number of the workers 					*/
+	uint32_t que_size						/* number of the slots (0: default) 		*/
+);
+/*--------------------------------------------------------------------------------------
+	Stops the workers and destroys the pipeline
+----------------------------------------------------------------------------------------*/
+void
+cef_publish_destroy (
+	CefT_Publish* pp						/* pipeline 								*/
+);
+/*--------------------------------------------------------------------------------------
+	Returns the number of the chunks which can be put without waiting
+----------------------------------------------------------------------------------------*/
+uint32_t
+cef_publish_space_get (
+	CefT_Publish* pp						/* pipeline 								*/
+);
+/*--------------------------------------------------------------------------------------
+	Puts the chunk to the pipeline. The end chunk number of the parameters is used
+	unless end_f is set.
+----------------------------------------------------------------------------------------*/
+int											/* -1 if all the slots are in use 			*/
+cef_publish_block_put (
+	CefT_Publish* pp,						/* pipeline 								*/
+	const unsigned char* payload,			/* payload of the chunk 					*/
+	uint16_t payload_len,					/* length of the payload 					*/
+	uint32_t chunk_num,						/* chunk number 							*/
+	int end_f								/* 1 if the chunk is the last chunk 		*/
+);
+/*--------------------------------------------------------------------------------------
+	Returns the next Content Object in order. Waits until it is created. The
+	Content Object stays in the pipeline until cef_publish_cob_release is called.
+----------------------------------------------------------------------------------------*/
+int											/* length of the Content Object, 0 if no 	*/
+											/* chunk is in the pipeline, or the negative*/
+											/* value of cef_frame_object_create 		*/
+cef_publish_cob_get (
+	CefT_Publish* pp,						/* pipeline 								*/
+	unsigned char** cob,					/* Content Object 							*/
+	uint16_t* payload_len,					/* length of the payload 					*/
+	uint32_t* chunk_num						/* chunk number 							*/
+);
+/*--------------------------------------------------------------------------------------
+	Releases the Content Object returned by cef_publish_cob_get
+----------------------------------------------------------------------------------------*/
+void
+cef_publish_cob_release (
+	CefT_Publish* pp						/* pipeline 								*/
+);
+
+#endif // __CEF_PUBLISH_HEADER__
@@ -38,12 +38,20 @@
  ****************************************************************************************/
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include <pthread.h>
 
 /****************************************************************************************
  Macros
  ****************************************************************************************/
 
+#define CefC_Rngque_Capacity_Min	32			/* Min capacity of the ring queue 		*/
+#define CefC_Rngque_Capacity_Max	16777216	/* Max capacity of the ring queue 		*/
+#define CefC_Rngque_Cache_Line		64			/* Size of the cache line 				*/
+
+#define CefC_Rngque_Type_Mpsc		0			/* Multiple producers, single consumer 	*/
+#define CefC_Rngque_Type_Spsc		1			/* Single producer, single consumer 	*/
 
 /****************************************************************************************
  Structure Declarations
@@ -51,19 +59,30 @@
 
 typedef struct {
 
+	_Atomic uint32_t	seq;		/* position + 1 when the body is filled (MPSC) 		*/
 	void* 	body;
 
 } CefT_Rngque_Elem;
 
 /********** Tx queue (ring buffer) 	**********/
+/* The queue has one consumer. The positions are free-running counters and are		*/
+/* masked when the slot is accessed. The producer and consumer sides are kept in 	*/
+/* separate cache lines.															*/
 typedef struct {
 
-	int top;						/* top of the ring buffer 							*/
-	int bottom;						/* bottom of the ring buffer 						*/
-	int mask;						/* capacity of the ring buffer 						*/
+	/* written by the producer(s) 		*/
+	_Atomic uint32_t bottom;		/* next position to push 							*/
+	char 	pad1[CefC_Rngque_Cache_Line - sizeof (uint32_t)];
+
+	/* written by the consumer 			*/
+	_Atomic uint32_t top;			/* next position to pop 							*/
+	char 	pad2[CefC_Rngque_Cache_Line - sizeof (uint32_t)];
+
+	/* read only 						*/
+	uint32_t mask;					/* capacity of the ring buffer - 1 					*/
+	int 	type;					/* CefC_Rngque_Type_Xxx 							*/
 	CefT_Rngque_Elem* que;			/* line buffer 										*/
-	pthread_mutex_t mutex;			/* mutex for thread safe 							*/
-	
+
 } CefT_Rngque;
 
 /****************************************************************************************
@@ -76,16 +95,26 @@ typedef struct {
  Function Declarations
  ****************************************************************************************/
 
+/*--------------------------------------------------------------------------------------
+	Creates the ring queue which several threads can push to
+----------------------------------------------------------------------------------------*/
 CefT_Rngque* 								/* Created Ring Queue Information 			*/
 cef_rngque_create (
 	int capacity							/* Capacity of Ring queue 					*/
 );
+/*--------------------------------------------------------------------------------------
+	Creates the ring queue which only one thread pushes to
+----------------------------------------------------------------------------------------*/
+CefT_Rngque* 								/* Created Ring Queue Information 			*/
+cef_rngque_create_spsc (
+	int capacity							/* Capacity of Ring queue 					*/
+);
 void
 cef_rngque_destroy (
 	CefT_Rngque* qp							/* Ring Queue Information 					*/
 );
 
-int
+int											/* 1 if the item was pushed, 0 if full 		*/
 cef_rngque_push (
 	CefT_Rngque* qp, 						/* Ring Queue Information 					*/
 	void* item
@@ -95,6 +124,25 @@ void*										/* item which is removed from queue 		*/
 cef_rngque_pop (
 	CefT_Rngque* qp							/* Ring Queue Information 					*/
 );
+/*--------------------------------------------------------------------------------------
+	Inserts the items to the bottom of Ring Queue. The items are pushed in order,
+	and only the first ones that fit are pushed.
+----------------------------------------------------------------------------------------*/
+int											/* Number of the pushed items 				*/
+cef_rngque_push_bulk (
+	CefT_Rngque* qp, 						/* Ring Queue Information 					*/
+	void** items,							/* items to push 							*/
+	int num									/* number of the items 						*/
+);
+/*--------------------------------------------------------------------------------------
+	Removes up to num items from the top of Ring Queue
+----------------------------------------------------------------------------------------*/
+int											/* Number of the removed items 				*/
+cef_rngque_pop_bulk (
+	CefT_Rngque* qp, 						/* Ring Queue Information 					*/
+	void** items,							/* buffer to set the items 					*/
+	int num									/* size of the buffer 						*/
+);
 /*--------------------------------------------------------------------------------------
 	Read the value (int) from the top of Ring Queue
 ----------------------------------------------------------------------------------------*/
@@ -80,6 +80,20 @@ cef_valid_crc32_calc (
 	const unsigned char* buf,
 	size_t len
 );
+/*--------------------------------------------------------------------------------------
+	Builds the CRC32 tables. cef_valid_init calls this.
+----------------------------------------------------------------------------------------*/
+void
+cef_valid_crc_init (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Enables or disables the carry-less multiply path of cef_valid_crc32_calc
+----------------------------------------------------------------------------------------*/
+int											/* 1 if the path is used, 0 otherwise		*/
+cef_valid_crc_clmul_set (
+	int use_f
+);
 int
 cef_valid_get_pubkey (
 	const unsigned char* msg,
@@ -107,6 +121,12 @@ cef_valid_msg_verify (
 	const unsigned char* msg,
 	int msg_len
 );
+int 								/* type of the validation algorithm, or 			*/
+									/* CefC_T_ALG_INVALID 								*/
+cef_valid_msg_alg_get (
+	const unsigned char* msg,
+	int msg_len
+);
 
 int
 cef_valid_keyid_create_forccninfo (
@@ -925,7 +925,7 @@ cef_client_payload_get_with_info (
 	struct fixed_hdr* fix_hdr;
 	uint16_t 	pkt_len;
 	uint8_t 	hdr_len;
-	CefT_CcnMsg_MsgBdy 	pm = { 0 };
+	CefT_CcnMsg_MsgBdy 	pm;
 	CefT_CcnMsg_OptHdr 	poh = { 0 };
 	int						res;
 	int new_len = 0;
@@ -1044,7 +1044,7 @@ cef_client_request_get_with_info (
 	struct fixed_hdr* fix_hdr;
 	uint16_t 	pkt_len;
 	uint8_t 	hdr_len;
-	CefT_CcnMsg_MsgBdy 	pm = { 0 };
+	CefT_CcnMsg_MsgBdy 	pm;
 	CefT_CcnMsg_OptHdr 	poh = { 0 };
 	int						res;
 	int new_len = 0;
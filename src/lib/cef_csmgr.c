@@ -62,13 +62,20 @@ uint32_t bchunk = 0xFFFF;
 #define	BUFF_SIZE	0
 #endif
 
-#define	DEMO_RETRY_NUM	10
-
-
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
 
+/***** Interests for the chunks of a content that are looked up in one message 	*****/
+typedef struct {
+	unsigned char 	name[CefC_Max_Length];		/* Name without the chunk number 		*/
+	uint16_t 		name_len;
+	unsigned char 	ver[CefC_Max_Length];		/* Version 								*/
+	uint16_t 		ver_len;
+	uint32_t 		first_chunk;				/* Chunk number of bit 0 of chunk_map 	*/
+	uint64_t 		chunk_map;					/* Chunks being looked up 				*/
+} CefT_Csmgr_Bulk_Interest;
+
 
 /****************************************************************************************
  State Variables
@@ -77,6 +84,8 @@ uint32_t bchunk = 0xFFFF;
 static unsigned char* 	cefnetd_msg_buff 		= NULL;
 static int 				cefnetd_msg_buff_index 	= 0;
 static unsigned char* 	work_msg_buff 			= NULL;
+static CefT_Csmgr_Bulk_Interest bulk_interest;
+static int 				lookup_queued_f 		= 0;
 
 /****************************************************************************************
  Static Function Declaration
@@ -102,6 +111,30 @@ cef_csmgr_interest_msg_create (
 	CefT_CcnMsg_OptHdr* poh,				/* Parsed Option Header						*/
 	CefT_CcnMsg_MsgBdy* pm					/* Parsed CEFORE message					*/
 );
+/*--------------------------------------------------------------------------------------
+	Create Bulk Interest message for csmgr from the pending lookups
+----------------------------------------------------------------------------------------*/
+static void
+cef_csmgr_bulk_interest_msg_create (
+	unsigned char buff[],					/* Interest message							*/
+	uint16_t* index							/* Length of message						*/
+);
+/*--------------------------------------------------------------------------------------
+	Adds the message to the buffer which is sent to csmgr by one write
+----------------------------------------------------------------------------------------*/
+static void
+cef_csmgr_excache_msg_queue (
+	CefT_Cs_Stat* cs_stat,					/* Content Store status						*/
+	unsigned char* msg,						/* message									*/
+	uint16_t msg_len						/* message length							*/
+);
+/*--------------------------------------------------------------------------------------
+	Moves the pending lookups to the buffer which is sent to csmgr
+----------------------------------------------------------------------------------------*/
+static void
+cef_csmgr_bulk_interest_queue (
+	CefT_Cs_Stat* cs_stat					/* Content Store status						*/
+);
 /*--------------------------------------------------------------------------------------
 	Connect csmgr local socket
 ----------------------------------------------------------------------------------------*/
@@ -324,6 +357,8 @@ cef_csmgr_stat_create (
 					cef_csmgr_stat_destroy (&cs_stat);
 					return (NULL);
 				}
+				/* Searched with the prefix hashes of the name descriptors 	*/
+				cef_hash_tbl_seed_set (cs_stat->cob_table, CefC_Hash_Seed_Default);
 			}
 #ifdef	CefC_CefnetdCache
 		} else
@@ -331,7 +366,8 @@ cef_csmgr_stat_create (
 			pthread_t cef_mem_cache_put_th;
 			pthread_t cef_mem_cache_clear_th;
 			int rtc;
-			rtc = cef_mem_cache_init (cs_stat->cache_cap);
+			rtc = cef_mem_cache_init (cs_stat->cache_cap,
+					(uint64_t) cs_stat->local_cache_memory * 1024 * 1024);
 			if(rtc != 0){
 				cef_csmgr_stat_destroy (&cs_stat);
 				cef_log_write (CefC_Log_Error
@@ -455,6 +491,7 @@ cef_csmgr_config_read (
 	strcpy (cs_stat->peer_id_str, CefC_Default_Node_Path);
 #ifdef CefC_CefnetdCache
 	cs_stat->local_cache_capacity = 65535;
+	cs_stat->local_cache_memory = CefC_Default_Local_Cache_Memory;
 	cs_stat->local_cache_interval = 60;
 #endif //CefC_CefnetdCache
 
@@ -529,6 +566,15 @@ cef_csmgr_config_read (
 			}
 			cs_stat->local_cache_capacity = res;
 		}
+		else if (strcmp (option, "LOCAL_CACHE_MEMORY") == 0) {
+			res = cef_csmgr_config_get_value (option, value);
+			if ((res < 1) || (res > 1048576)) {
+				cef_log_write (CefC_Log_Error,
+					"LOCAL_CACHE_MEMORY must be higher than 0 and lower than or equal to 1,048,576.\n");
+				return (-1);
+			}
+			cs_stat->local_cache_memory = res;
+		}
 		else if (strcmp (option, "LOCAL_CACHE_INTERVAL") == 0) {
 			res = cef_csmgr_config_get_value (option, value);
 			if ((res <= 1) || (res >= 86400)) {
@@ -890,6 +936,7 @@ cef_csmgr_stat_destroy (
 		cefnetd_msg_buff = NULL;
 	}
 	cefnetd_msg_buff_index = 0;
+	bulk_interest.chunk_map = 0;
 
 
 	return;
@@ -910,6 +957,7 @@ cef_csmgr_cache_lookup (
 	CefT_Cob_Entry* cob_entry = NULL;
 	uint64_t nowt;
 	int rc;
+	uint32_t hashv;
 
 	*cob = NULL;
 	/* If the Interest is longlife or bulk, process is left to csmrd 	*/
@@ -924,8 +972,13 @@ cef_csmgr_cache_lookup (
 #endif //__WORKBUFF_VERSION__
 		/* Searches content entry 	*/
 		if (cs_stat->cob_table) {
-			cob_entry = (CefT_Cob_Entry*)
-				cef_hash_tbl_item_get_prg (cs_stat->cob_table, pm->name, pm->name_len);
+			if (cef_frame_name_desc_hashv_get (pm, pm->name, pm->name_len, &hashv)) {
+				cob_entry = (CefT_Cob_Entry*) cef_hash_tbl_item_get_prg_hashv (
+									cs_stat->cob_table, pm->name, pm->name_len, hashv);
+			} else {
+				cob_entry = (CefT_Cob_Entry*)
+					cef_hash_tbl_item_get_prg (cs_stat->cob_table, pm->name, pm->name_len);
+			}
 		}
 		if (cob_entry) {
 			nowt = cef_client_present_timeus_get ();
@@ -970,23 +1023,20 @@ cef_csmgr_cache_lookup (
 	}
 #ifdef CefC_CefnetdCache
 	else if (cs_stat->cache_type == CefC_Cache_Type_Localcache){
-		CefMemCacheT_Content_Mem_Entry* entry;
-		entry = cef_mem_cache_item_get (pm->name, pm->name_len);
-		if (entry) {
-			nowt = cef_client_present_timeus_get ();
+		/* The Cob is copied out of the local cache, since the entry may be removed	*/
+		/* by the other threads. The buffer is used until the next lookup.		*/
+		static __thread unsigned char cob_buff[CefC_Max_Msg_Size];
 
-			if ((nowt < entry->cache_time) && (nowt < entry->expiry)) {
-				if (pm->org.version_f) {
-					if (entry->ver_len == pm->org.version_len &&
-						memcmp (entry->version, pm->org.version_val, entry->ver_len) == 0) {
-						*cob = entry->msg;
-						return (1);
-					}
-				} else {
-					*cob = entry->msg;
-					return (1);
-				}
-			}
+		if (cef_frame_name_desc_hashv_get (pm, pm->name, pm->name_len, &hashv)) {
+			rc = cef_mem_cache_item_get_hashv (pm->name, pm->name_len, hashv,
+					pm->org.version_f, pm->org.version_val, pm->org.version_len, cob_buff);
+		} else {
+			rc = cef_mem_cache_item_get (pm->name, pm->name_len, pm->org.version_f,
+					pm->org.version_val, pm->org.version_len, cob_buff);
+		}
+		if (rc > 0) {
+			*cob = cob_buff;
+			return (1);
 		}
 	}
 #endif //CefC_CefnetdCache
@@ -1083,7 +1133,7 @@ cef_csmgr_cache_insert (
 					sprintf(cstr, "None");cstr[4] = 0x00;
 				}
 				if (pm->org.version_len) {
-					sprintf(rstr, "%s", pm->org.version_val);rstr[pm->org.version_len] = 0x00;
+					sprintf(rstr, "%.*s", (int) pm->org.version_len, pm->org.version_val);
 				} else {
 					sprintf(rstr, "None");rstr[4] = 0x00;
 				}
@@ -1345,13 +1395,7 @@ cef_csmgr_excache_item_put (
 		index += 3;
 
 		/* send message */
-	    if(cefnetd_msg_buff_index > BUFF_SIZE){
-			cef_csmgr_send_msg_to_csmgr (
-					cs_stat, cefnetd_msg_buff, cefnetd_msg_buff_index);
-			cefnetd_msg_buff_index = 0;
-		}
-		memcpy (&cefnetd_msg_buff[cefnetd_msg_buff_index], buff, index);
-		cefnetd_msg_buff_index += index;
+		cef_csmgr_excache_msg_queue (cs_stat, buff, index);
 	}
 
 	return;
@@ -1363,6 +1407,9 @@ void
 cef_csmgr_excache_item_push (
 	CefT_Cs_Stat* cs_stat					/* Content Store status						*/
 ) {
+	/* The pending lookups are sent with the Cobs by one write 	*/
+	cef_csmgr_bulk_interest_queue (cs_stat);
+	lookup_queued_f = 0;
 
 	if (cefnetd_msg_buff_index > 0) {
 		cef_csmgr_send_msg_to_csmgr (cs_stat, cefnetd_msg_buff, cefnetd_msg_buff_index);
@@ -1386,7 +1433,8 @@ cef_csmgr_excache_lookup (
 ) {
 	unsigned char buff[CefC_Max_Length];
 	uint16_t index = 0;
-	int res;
+	uint16_t name_len;
+	int chunk_field_len = CefC_S_Type + CefC_S_Length + CefC_S_ChunkNum;
 
 	if (pm->org.longlife_f) {
 		return;
@@ -1397,14 +1445,92 @@ cef_csmgr_excache_lookup (
 	}
 #endif	//CefC_CefnetdCache
 
-	/* Create Interest message 		*/
-	cef_csmgr_interest_msg_create (buff, &index, poh, pm);
+	if (pm->chunk_num_f == 0) {
+		/* Create Interest message 		*/
+		cef_csmgr_interest_msg_create (buff, &index, poh, pm);
+		cef_csmgr_bulk_interest_queue (cs_stat);
+		cef_csmgr_excache_msg_queue (cs_stat, buff, index);
+		lookup_queued_f = 1;
+		return;
+	}
 
-	/* Send messages 				*/
-	res = cef_csmgr_send_msg_to_csmgr (cs_stat, buff, index);
-	if (res < 0) {
-		cef_log_write (CefC_Log_Warn, "%s (%s)\n", __func__, strerror (errno));
+	/* Interests for the chunks of the same content are looked up by one 	*/
+	/* Bulk Interest message which is sent by cef_csmgr_excache_lookup_push 	*/
+	name_len = pm->name_len - chunk_field_len;
+	if ((bulk_interest.chunk_map) &&
+		(pm->chunk_num >= bulk_interest.first_chunk) &&
+		(pm->chunk_num - bulk_interest.first_chunk < CefC_Csmgr_Bulk_Interest_Map_Bits) &&
+		(name_len == bulk_interest.name_len) &&
+		(pm->org.version_len == bulk_interest.ver_len) &&
+		(memcmp (pm->name, bulk_interest.name, name_len) == 0) &&
+		((pm->org.version_len == 0) ||
+		 (memcmp (pm->org.version_val, bulk_interest.ver, pm->org.version_len) == 0))) {
+		bulk_interest.chunk_map |= 1ULL << (pm->chunk_num - bulk_interest.first_chunk);
+		return;
+	}
+	cef_csmgr_bulk_interest_queue (cs_stat);
+
+	memcpy (bulk_interest.name, pm->name, name_len);
+	bulk_interest.name_len = name_len;
+	if (pm->org.version_len) {
+		memcpy (bulk_interest.ver, pm->org.version_val, pm->org.version_len);
+	}
+	bulk_interest.ver_len 		= pm->org.version_len;
+	bulk_interest.first_chunk 	= pm->chunk_num;
+	bulk_interest.chunk_map 	= 1;
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Sends the lookups queued by cef_csmgr_excache_lookup to csmgr
+----------------------------------------------------------------------------------------*/
+void
+cef_csmgr_excache_lookup_push (
+	CefT_Cs_Stat* cs_stat					/* Content Store status						*/
+) {
+	if ((bulk_interest.chunk_map == 0) && (lookup_queued_f == 0)) {
+		return;
+	}
+	cef_csmgr_excache_item_push (cs_stat);
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Adds the message to the buffer which is sent to csmgr by one write
+----------------------------------------------------------------------------------------*/
+static void
+cef_csmgr_excache_msg_queue (
+	CefT_Cs_Stat* cs_stat,					/* Content Store status						*/
+	unsigned char* msg,						/* message									*/
+	uint16_t msg_len						/* message length							*/
+) {
+	if (cefnetd_msg_buff_index > BUFF_SIZE) {
+		cef_csmgr_send_msg_to_csmgr (
+				cs_stat, cefnetd_msg_buff, cefnetd_msg_buff_index);
+		cefnetd_msg_buff_index = 0;
 	}
+	memcpy (&cefnetd_msg_buff[cefnetd_msg_buff_index], msg, msg_len);
+	cefnetd_msg_buff_index += msg_len;
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Moves the pending lookups to the buffer which is sent to csmgr
+----------------------------------------------------------------------------------------*/
+static void
+cef_csmgr_bulk_interest_queue (
+	CefT_Cs_Stat* cs_stat					/* Content Store status						*/
+) {
+	unsigned char buff[CefC_Max_Length];
+	uint16_t index = 0;
+
+	if (bulk_interest.chunk_map == 0) {
+		return;
+	}
+	cef_csmgr_bulk_interest_msg_create (buff, &index);
+	bulk_interest.chunk_map = 0;
+
+	cef_csmgr_excache_msg_queue (cs_stat, buff, index);
 
 	return;
 }
@@ -1819,27 +1945,21 @@ cef_csmgr_locache_info_get (
 		//rep_blk.last_seq 	= htonl ((uint32_t) 0);
 	} else {
 		/* include chunk number */
-		CefMemCacheT_Content_Mem_Entry* entry;
-		uint64_t nowt;
-		entry = cef_mem_cache_item_get (name, name_len);
-		if (entry) {
-			nowt = cef_client_present_timeus_get ();
-			if ((nowt < entry->cache_time) && (nowt < entry->expiry)) {
-				res = cef_mem_cache_mstat_get (name, tmp_klen, &info_p);
-				if (res < 0) {
-					return (-1);
-				}
+		if (cef_mem_cache_item_get (name, name_len, 0, NULL, 0, NULL) > 0) {
+			res = cef_mem_cache_mstat_get (name, tmp_klen, &info_p);
+			if (res < 0) {
+				return (-1);
+			}
 
-				if (info_p.con_size / 1024 > UINT32_MAX) {
-					rep_blk.cont_size 	= htonl (UINT32_MAX);
-				} else {
-					rep_blk.cont_size 	= htonl ((uint32_t)info_p.con_size / 1024);
-				}
-				rep_blk.cont_cnt 	= htonl ((uint32_t) 1);
-				rep_blk.rcv_int 	= htonl ((uint32_t) 0);
-				rep_blk.first_seq 	= htonl ((uint32_t) seqno);
-				rep_blk.last_seq 	= htonl ((uint32_t) seqno);
+			if (info_p.con_size / 1024 > UINT32_MAX) {
+				rep_blk.cont_size 	= htonl (UINT32_MAX);
+			} else {
+				rep_blk.cont_size 	= htonl ((uint32_t)info_p.con_size / 1024);
 			}
+			rep_blk.cont_cnt 	= htonl ((uint32_t) 1);
+			rep_blk.rcv_int 	= htonl ((uint32_t) 0);
+			rep_blk.first_seq 	= htonl ((uint32_t) seqno);
+			rep_blk.last_seq 	= htonl ((uint32_t) seqno);
 		} else {
 			return (-1);
 		}
@@ -2590,6 +2710,56 @@ cef_csmgr_interest_msg_create (
 
 	return;
 }
+/*--------------------------------------------------------------------------------------
+	Create Bulk Interest message for csmgr from the pending lookups
+----------------------------------------------------------------------------------------*/
+static void
+cef_csmgr_bulk_interest_msg_create (
+	unsigned char buff[],					/* Interest message							*/
+	uint16_t* index							/* Length of message						*/
+) {
+	uint16_t value16_nw;
+	uint32_t value32_nw;
+	uint64_t value64_nw;
+
+	/* set header */
+	buff[CefC_O_Fix_Ver]  = CefC_Version;
+	buff[CefC_O_Fix_Type] = CefC_Csmgr_Msg_Type_Bulk_Interest;
+	*index += CefC_Csmgr_Msg_HeaderLen;
+
+	/* Sets Interest Type 		*/
+	buff[*index] = CefC_Csmgr_Interest_Type_Normal;
+	*index += sizeof (uint8_t);
+
+	/* Sets Name 				*/
+	value16_nw = htons (bulk_interest.name_len);
+	memcpy (buff + *index, &value16_nw, sizeof (uint16_t));
+	memcpy (buff + *index + CefC_S_Length, bulk_interest.name, bulk_interest.name_len);
+	*index += CefC_S_Length + bulk_interest.name_len;
+
+	/* Sets the first chunk number and the bitmap of the chunks 	*/
+	value32_nw = htonl (bulk_interest.first_chunk);
+	memcpy (buff + *index, &value32_nw, CefC_S_ChunkNum);
+	*index += CefC_S_ChunkNum;
+	value64_nw = cef_client_htonb (bulk_interest.chunk_map);
+	memcpy (buff + *index, &value64_nw, sizeof (uint64_t));
+	*index += sizeof (uint64_t);
+
+	/* Sets Version 			*/
+	value16_nw = htons (bulk_interest.ver_len);
+	memcpy (buff + *index, &value16_nw, sizeof (uint16_t));
+	*index += CefC_S_Length;
+	if (bulk_interest.ver_len) {
+		memcpy (buff + *index, bulk_interest.ver, bulk_interest.ver_len);
+		*index += bulk_interest.ver_len;
+	}
+
+	/* set Length */
+	value16_nw = htons (*index);
+	memcpy (buff + CefC_O_Length, &value16_nw, CefC_S_Length);
+
+	return;
+}
 /*--------------------------------------------------------------------------------------
 	Connect csmgr with TCP socket
 ----------------------------------------------------------------------------------------*/
@@ -2693,8 +2863,13 @@ cef_csmgr_send_to_csmgrd_thread (
 	CefT_Cs_Stat*				cs_stat;
 	int 						read_fd = -1;
 	struct pollfd 				poll_fds[1];
+	struct pollfd 				send_fds[1];
 	unsigned char				msg[CefC_Max_Length*2];
-	int							msg_len;
+	unsigned char*				mp = msg;
+	int							len = 0;			/* bytes not sent yet 			*/
+	int							sock;
+	int							res;
+	char						port_str[NI_MAXSERV];
 
 	cs_stat = (CefT_Cs_Stat*)p;
 
@@ -2706,159 +2881,64 @@ cef_csmgr_send_to_csmgrd_thread (
 	memset(&poll_fds, 0, sizeof(poll_fds));
 	poll_fds[0].fd = read_fd;
 	poll_fds[0].events = POLLIN | POLLERR;
+	memset(&send_fds, 0, sizeof(send_fds));
 
 	while (1){
-	    poll(poll_fds, 1, 1);
-	    if (poll_fds[0].revents & POLLIN) {
-			if((msg_len = read(read_fd, msg, sizeof(msg))) < 1){
+		/* The rest of a message which csmgrd could not take is held and retried	*/
+		/* before the next message is read from the pipe. While it is held, the 	*/
+		/* pipe fills and cef_csmgr_send_msg_to_csmgr drops whole messages, so 		*/
+		/* the stream to csmgrd is never cut in the middle of a message.			*/
+		if (len == 0) {
+		    poll(poll_fds, 1, 1);
+		    if (!(poll_fds[0].revents & POLLIN)) {
 				continue;
 			}
-			/*###########*/
-			int res;
-			char port_str[NI_MAXSERV];
-
-			if (cs_stat->local_sock != -1) {
-				int	send_count = 0;
-				res = 0;
-    			unsigned char* mp = msg;
-    			int len = msg_len;
-				fd_set fds, writefds;
-				int n;
-				struct timeval timeout;
-
-		   		res = send( cs_stat->local_sock, mp, len,  MSG_DONTWAIT);
-				if ( res <= 0 ) {
-#ifdef	__DEV_CEF_CSMGR_SEND__
-					fprintf(stderr, "[%s](res <=0): ###########(1) ERROR(%d)=%s send_count:%d\n", __FUNCTION__, errno, strerror (errno), send_count);
-#endif
-					if ( errno == EAGAIN ) {
-						usleep(CEF_CSMGR_SEND_USLEEP);
-					}
-					continue;
-				}
-				len -= res;
-				mp += res;
-				send_count++;
-
-				while( len > 0 ){
-					timeout.tv_sec  = 0;
-					timeout.tv_usec = CEF_CSMGR_SEND_TIMEOUT;
-					FD_ZERO (&writefds);
-					FD_SET (cs_stat->local_sock, &writefds);
-					memcpy (&fds, &writefds, sizeof (fds));
-					n = select(cs_stat->local_sock+1, NULL, &fds, NULL, &timeout);
-					if (n > 0) {
-						if (FD_ISSET (cs_stat->local_sock, &fds)) {
-				    		res = send( cs_stat->local_sock, mp, len,  MSG_DONTWAIT);
-							if(res > 0) {
-								len -= res;
-								mp += res;
-							} else {
-#ifdef	__DEV_CEF_CSMGR_SEND__
-								fprintf(stderr, "[%s](res <=0): ###########(2) ERROR(%d)=%s \n", __FUNCTION__, errno, strerror (errno));
-#endif
-								if ( errno == EAGAIN ) {
-									usleep(CEF_CSMGR_SEND_USLEEP);
-								}
-							}
-							send_count++;
-							if ( send_count > DEMO_RETRY_NUM ) {
-								break;
-							}
-						}
-					} else {
-						if ( send_count == 0 ) {
-							break;
-						} else if ( send_count > DEMO_RETRY_NUM ) {
-#ifdef	__DEV_CEF_CSMGR_SEND__
-							fprintf(stderr, "[%s](%d): ########### n:%d   send_count:%d   len:%d   %s\n",
-										__FUNCTION__, __LINE__, n, send_count, len, strerror (errno));
-#endif
-							break;
-						}
-						send_count++;
-						if ( errno == EAGAIN ) {
-							usleep(CEF_CSMGR_SEND_USLEEP);
-						}
-					}
-				}
+			if((len = read(read_fd, msg, sizeof(msg))) < 1){
+				len = 0;
 				continue;
 			}
+			mp = msg;
+		}
 
+		if (cs_stat->local_sock != -1) {
+			sock = cs_stat->local_sock;
+		} else {
 			if (cs_stat->tcp_sock == -1) {
 				sprintf (port_str, "%d", cs_stat->tcp_port_num);
 				cs_stat->tcp_sock
 						= cef_csmgr_connect_tcp_to_csmgr (cs_stat->peer_id_str, port_str);
 			}
-			if (cs_stat->tcp_sock != -1) {
-				int	send_count = 0;
-				res = 0;
-    			unsigned char* mp = msg;
-    			int len = msg_len;
-				fd_set fds, writefds;
-				int n;
-				struct timeval timeout;
-
-				res = send( cs_stat->tcp_sock, mp, len, MSG_DONTWAIT );
-				if ( res <= 0 ) {
-#ifdef	__DEV_CEF_CSMGR_SEND__
-					fprintf(stderr, "[%s](res <=0): ###########(3) ERROR(%d)=%s send_count:%d\n", __FUNCTION__, errno, strerror (errno), send_count);
-#endif
-					if ( errno == EAGAIN ) {
-						usleep(CEF_CSMGR_SEND_USLEEP);
-					}
-					continue;
-				}
-				len -= res;
-				mp += res;
-				send_count++;
-
-				while( len > 0 ){
-					timeout.tv_sec  = 0;
-					timeout.tv_usec = CEF_CSMGR_SEND_TIMEOUT;
-					FD_ZERO (&writefds);
-					FD_SET (cs_stat->tcp_sock, &writefds);
-					memcpy (&fds, &writefds, sizeof (fds));
-					n = select(cs_stat->tcp_sock+1, NULL, &fds, NULL, &timeout);
-					if (n > 0) {
-						if (FD_ISSET (cs_stat->tcp_sock, &fds)) {
-							res = send( cs_stat->tcp_sock, mp, len, MSG_DONTWAIT );
-								if(res > 0) {
-								len -= res;
-								mp += res;
-							} else {
-#ifdef	__DEV_CEF_CSMGR_SEND__
-								fprintf(stderr, "[%s](res <=0): ###########(4) ERROR(%d)=%s \n", __FUNCTION__, errno, strerror (errno));
-#endif
-								if ( errno == EAGAIN ) {
-									usleep(CEF_CSMGR_SEND_USLEEP);
-								}
-							}
-							send_count++;
-							if ( send_count > DEMO_RETRY_NUM ) {
-								break;
-							}
-						}
-					} else {
-						if ( send_count == 0 ) {
-							break;
-						} else if ( send_count > DEMO_RETRY_NUM ) {
+			sock = cs_stat->tcp_sock;
+		}
+		if (sock == -1) {
+			len = 0;
+			continue;
+		}
+
+		res = send (sock, mp, len, MSG_DONTWAIT);
+		if (res > 0) {
+			len -= res;
+			mp += res;
+			continue;
+		}
+		if ((res < 0) &&
+			((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))) {
+			/* waits until csmgrd reads the socket 		*/
+			send_fds[0].fd = sock;
+			send_fds[0].events = POLLOUT | POLLERR;
+			poll (send_fds, 1, CEF_CSMGR_SEND_TIMEOUT / 1000);
+			continue;
+		}
 #ifdef	__DEV_CEF_CSMGR_SEND__
-							fprintf(stderr, "[%s](%d): ########### n:%d   send_count:%d   len:%d   %s\n",
-												__FUNCTION__, __LINE__, n, send_count, len, strerror (errno));
+		fprintf(stderr, "[%s](res <=0): ########### ERROR(%d)=%s len:%d\n", __FUNCTION__, errno, strerror (errno), len);
 #endif
-							break;
-						}
-						send_count++;
-						if ( errno == EAGAIN ) {
-							usleep(CEF_CSMGR_SEND_USLEEP);
-						}
-					}
-				}
-				continue;
-			}
-			/*###########*/
+		/* The connection is lost. The held message is dropped, and the TCP 		*/
+		/* connection is established again with the next message.					*/
+		if (sock == cs_stat->tcp_sock) {
+			close (cs_stat->tcp_sock);
+			cs_stat->tcp_sock = -1;
 		}
+		len = 0;
 	}
 
 	pthread_exit (NULL);
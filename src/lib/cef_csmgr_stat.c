@@ -44,7 +44,6 @@ static time_t BTIME=0;
  Include Files
  ****************************************************************************************/
 
-#include <openssl/md5.h>
 
 #include <cefore/cef_csmgr_stat.h>
 
@@ -121,6 +120,25 @@ csmgr_stat_hash_number_create (
 	const unsigned char* key, 
 	uint16_t klen
 );
+static uint64_t* 
+csmgr_stat_cob_map_alloc (
+	uint32_t map_max, 
+	uint64_t** sum_map
+);
+static void 
+csmgr_stat_seq_range_update (
+	CsmgrT_Stat* rcd
+);
+static int 
+csmgr_stat_cob_word_next (
+	const CsmgrT_Stat* rcd, 
+	uint32_t x
+);
+static int 
+csmgr_stat_cob_word_prev (
+	const CsmgrT_Stat* rcd, 
+	uint32_t x
+);
 
 /****************************************************************************************
  ****************************************************************************************/
@@ -284,10 +302,6 @@ csmgr_stat_content_info_get (
 ) {
 	CsmgrT_Stat_Table* tbl = (CsmgrT_Stat_Table*) hdl;
 	CsmgrT_Stat* rcd = NULL;
-	uint32_t min_seq = 0;
-	uint32_t max_seq = 0;
-	uint32_t i, n;
-	uint64_t mask;
 	uint64_t nowt;
 	struct timeval tv;
 	
@@ -306,34 +320,7 @@ csmgr_stat_content_info_get (
 			return (NULL);
 		}
 
-		for (i = 0 ; i < rcd->map_max ; i++) {
-			if (rcd->cob_map[i]) {
-				mask = 0x0000000000000001;
-				for (n = 0 ; n < 64 ; n++) {
-					if (rcd->cob_map[i] & mask) {
-						min_seq = i * 64 + n;
-						break;
-					}
-					mask <<= 1;
-				}
-				break;
-			}
-		}
-		for (i = rcd->map_max - 1 ; i >= 0 ; i--) {
-			if (rcd->cob_map[i]) {
-				mask = 0x8000000000000000;
-				for (n = 0 ; n < 64 ; n++) {
-					if (rcd->cob_map[i] & mask) {
-						max_seq = i * 64 + (64 - n) - 1;
-						break;
-					}
-					mask >>= 1;
-				}
-				break;
-			}
-		}
-		rcd->min_seq = min_seq;
-		rcd->max_seq = max_seq;
+		csmgr_stat_seq_range_update (rcd);
 	}
 	
 	pthread_mutex_unlock (&tbl->stat_mutex);
@@ -353,10 +340,6 @@ csmgr_stat_content_info_gets (
 	CsmgrT_Stat_Table* tbl = (CsmgrT_Stat_Table*) hdl;
 	CsmgrT_Stat* rcd = NULL;
 	
-	uint32_t min_seq = 0;
-	uint32_t max_seq = 0 /*@@@= CsmgrT_Stat_Seq_Max @@@*/;
-	uint32_t i, n;
-	uint64_t mask;
 	int index = 0;
 	int num = 0;
 	uint64_t nowt;
@@ -387,34 +370,7 @@ csmgr_stat_content_info_gets (
 			pthread_mutex_unlock (&tbl->stat_mutex);
 			return (0);
 		}
-		for (i = 0 ; i < rcd->map_max ; i++) {
-			if (rcd->cob_map[i]) {
-				mask = 0x0000000000000001;
-				for (n = 0 ; n < 64 ; n++) {
-					if (rcd->cob_map[i] & mask) {
-						min_seq = i * 64 + n;
-						break;
-					}
-					mask <<= 1;
-				}
-				break;
-			}
-		}
-		for (i = rcd->map_max - 1 ; i >= 0 ; i--) {
-			if (rcd->cob_map[i]) {
-				mask = 0x8000000000000000;
-				for (n = 0 ; n < 64 ; n++) {
-					if (rcd->cob_map[i] & mask) {
-						max_seq = i * 64 + (64 - n) - 1;
-						break;
-					}
-					mask >>= 1;
-				}
-				break;
-			}
-		}
-		rcd->min_seq = min_seq;
-		rcd->max_seq = max_seq;
+		csmgr_stat_seq_range_update (rcd);
 		
 		ret[0] = rcd;
 		
@@ -437,34 +393,7 @@ csmgr_stat_content_info_gets (
 			continue;
 		}
 		
-		for (i = 0 ; i < rcd->map_max ; i++) {
-			if (rcd->cob_map[i]) {
-				mask = 0x0000000000000001;
-				for (n = 0 ; n < 64 ; n++) {
-					if (rcd->cob_map[i] & mask) {
-						min_seq = i * 64 + n;
-						break;
-					}
-					mask <<= 1;
-				}
-				break;
-			}
-		}
-		for (i = rcd->map_max - 1 ; i >= 0 ; i--) {
-			if (rcd->cob_map[i]) {
-				mask = 0x8000000000000000;
-				for (n = 0 ; n < 64 ; n++) {
-					if (rcd->cob_map[i] & mask) {
-						max_seq = i * 64 + (64 - n) - 1;
-						break;
-					}
-					mask >>= 1;
-				}
-				break;
-			}
-		}
-		rcd->min_seq = min_seq;
-		rcd->max_seq = max_seq;
+		csmgr_stat_seq_range_update (rcd);
 		
 		ret[num] = rcd;
 		num++;
@@ -591,21 +520,24 @@ csmgr_stat_cob_update (
 	mask <<= (seq % 64);
 
 	if ((rcd->map_max-1) < x) {
-		char *ptr;
+		uint64_t *ptr;
+		uint64_t *sum;
 		uint32_t map_bsize;
 		map_bsize = x / CsmgrT_Add_Maps;
 		if (x % CsmgrT_Add_Maps != 0) {
 			map_bsize ++;
 		}
 		map_bsize = CsmgrT_Add_Maps + map_bsize * CsmgrT_Add_Maps;
-		ptr = calloc (1, sizeof (uint64_t) * map_bsize);
+		ptr = csmgr_stat_cob_map_alloc (map_bsize, &sum);
 		if (ptr == NULL) {
 			pthread_mutex_unlock (&tbl->stat_mutex);
 			return;
 		}
 		memcpy (ptr, rcd->cob_map, sizeof (uint64_t) * rcd->map_max);
+		memcpy (sum, rcd->sum_map, sizeof (uint64_t) * CsmgrT_Sum_Words (rcd->map_max));
 		free (rcd->cob_map);
-		rcd->cob_map = (uint64_t *) ptr;
+		rcd->cob_map = ptr;
+		rcd->sum_map = sum;
 		rcd->map_max = map_bsize;
 	}
 
@@ -653,6 +585,7 @@ csmgr_stat_cob_update (
 		tbl->cached_cob_num++;
 	}
 	rcd->cob_map[x] |= mask;
+	rcd->sum_map[x / 64] |= 1ULL << (x % 64);
 	
 #ifdef _CS_COB_NUM //@@@@@+++++ Show cached_cob_num status +++++
 {
@@ -712,6 +645,9 @@ csmgr_stat_cob_remove (
 		tbl->cached_cob_num--;
 	}
 	rcd->cob_map[x] &= ~mask;
+	if (rcd->cob_map[x] == 0) {
+		rcd->sum_map[x / 64] &= ~(1ULL << (x % 64));
+	}
 	
 	if (rcd->cob_num == 0) {
 		csmgr_stat_content_info_delete (hdl, name, name_len);
@@ -1206,6 +1142,155 @@ csmgr_stat_cob_remove_for_pub (
 	return (-1);
 }
 
+/*--------------------------------------------------------------------------------------
+	Checks whether the specified chunk is cached (1) or not (0)
+----------------------------------------------------------------------------------------*/
+int
+csmgr_stat_cob_is_cached (
+	const CsmgrT_Stat* rcd,
+	uint32_t seq
+) {
+	uint32_t x = seq / 64;
+	
+	if (x >= rcd->map_max) {
+		return (0);
+	}
+	return ((int)((rcd->cob_map[x] >> (seq % 64)) & 1));
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the lowest cached chunk number (-1 if the map is empty)
+----------------------------------------------------------------------------------------*/
+int
+csmgr_stat_cob_min_get (
+	const CsmgrT_Stat* rcd,
+	uint32_t* seq
+) {
+	int x;
+	
+	x = csmgr_stat_cob_word_next (rcd, 0);
+	if (x < 0) {
+		return (-1);
+	}
+	*seq = (uint32_t) x * 64 + __builtin_ctzll (rcd->cob_map[x]);
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the highest cached chunk number (-1 if the map is empty)
+----------------------------------------------------------------------------------------*/
+int
+csmgr_stat_cob_max_get (
+	const CsmgrT_Stat* rcd,
+	uint32_t* seq
+) {
+	int x;
+	
+	x = csmgr_stat_cob_word_prev (rcd, UINT32_MAX);
+	if (x < 0) {
+		return (-1);
+	}
+	*seq = (uint32_t) x * 64 + 63 - __builtin_clzll (rcd->cob_map[x]);
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the first cached chunk number at or after from (-1 if none)
+----------------------------------------------------------------------------------------*/
+int
+csmgr_stat_cob_next_cached_get (
+	const CsmgrT_Stat* rcd,
+	uint32_t from,
+	uint32_t* seq
+) {
+	uint32_t x = from / 64;
+	uint64_t w;
+	int nx;
+	
+	if (x >= rcd->map_max) {
+		return (-1);
+	}
+	w = rcd->cob_map[x] & (~0ULL << (from % 64));
+	if (w == 0) {
+		nx = csmgr_stat_cob_word_next (rcd, x + 1);
+		if (nx < 0) {
+			return (-1);
+		}
+		x = (uint32_t) nx;
+		w = rcd->cob_map[x];
+	}
+	*seq = x * 64 + __builtin_ctzll (w);
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the first missing chunk number at or after from (-1 if none)
+----------------------------------------------------------------------------------------*/
+int
+csmgr_stat_cob_next_missing_get (
+	const CsmgrT_Stat* rcd,
+	uint32_t from,
+	uint32_t* seq
+) {
+	uint64_t x = from / 64;
+	uint64_t w;
+	uint64_t next;
+	
+	if (x >= rcd->map_max) {
+		*seq = from;
+		return (0);
+	}
+	w = ~rcd->cob_map[x] & (~0ULL << (from % 64));
+	while (w == 0) {
+		if (++x >= rcd->map_max) {
+			break;
+		}
+		w = ~rcd->cob_map[x];
+	}
+	next = x * 64 + ((w) ? __builtin_ctzll (w) : 0);
+	if (next > UINT32_MAX) {
+		return (-1);
+	}
+	*seq = (uint32_t) next;
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Counts the cached chunks in [st, ed]
+----------------------------------------------------------------------------------------*/
+uint32_t
+csmgr_stat_cob_range_count (
+	const CsmgrT_Stat* rcd,
+	uint32_t st,
+	uint32_t ed
+) {
+	uint32_t sx, ex, x;
+	uint64_t w;
+	uint32_t cnt = 0;
+	int nx;
+	
+	if ((st > ed) || (st / 64 >= rcd->map_max)) {
+		return (0);
+	}
+	sx = st / 64;
+	ex = ed / 64;
+	if (ex >= rcd->map_max) {
+		ex = rcd->map_max - 1;
+		ed = 63;
+	}
+	for (x = sx ; x <= ex ; x++) {
+		nx = csmgr_stat_cob_word_next (rcd, x);
+		if ((nx < 0) || ((uint32_t) nx > ex)) {
+			break;
+		}
+		x = (uint32_t) nx;
+		w = rcd->cob_map[x];
+		if (x == sx) {
+			w &= ~0ULL << (st % 64);
+		}
+		if ((x == ex) && (ed % 64 != 63)) {
+			w &= (1ULL << (ed % 64 + 1)) - 1;
+		}
+		cnt += __builtin_popcountll (w);
+	}
+	return (cnt);
+}
+
 /****************************************************************************************
  ****************************************************************************************/
 
@@ -1251,7 +1336,7 @@ csmgr_stat_content_lookup (
 		cp->tx_seq = 0;
 		cp->tx_num = -1;
 		cp->tx_time = 0;
-		cp->cob_map = (uint64_t *) calloc (1, sizeof (uint64_t) * CsmgrT_Add_Maps);
+		cp->cob_map = csmgr_stat_cob_map_alloc (CsmgrT_Add_Maps, &cp->sum_map);
 		cp->map_max = CsmgrT_Add_Maps;
 		for (int i=0; i<CsmgrT_Stat_Max; i++) {
 			if (stat_index_mngr[i] == 0) {
@@ -1281,7 +1366,7 @@ csmgr_stat_content_lookup (
 		cp->tx_seq = 0;
 		cp->tx_num = -1;
 		cp->tx_time = 0;
-		cp->cob_map = (uint64_t *) calloc (1, sizeof (uint64_t) * CsmgrT_Add_Maps/*@*/);
+		cp->cob_map = csmgr_stat_cob_map_alloc (CsmgrT_Add_Maps, &cp->sum_map);
 		cp->map_max = CsmgrT_Add_Maps;
 		for (int i=0; i<CsmgrT_Stat_Max; i++) {
 			if (stat_index_mngr[i] == 0) {
@@ -1388,12 +1473,106 @@ csmgr_stat_hash_number_create (
 	const unsigned char* key, 
 	uint16_t klen
 ) {
-	unsigned char out[MD5_DIGEST_LENGTH];
-	uint32_t hash;
+	return (cef_hash_number_calc (CefC_Hash_Seed_Default, key, klen));
+}
+/*--------------------------------------------------------------------------------------
+	Allocates a cob_map of map_max words followed by its summary words
+----------------------------------------------------------------------------------------*/
+static uint64_t* 
+csmgr_stat_cob_map_alloc (
+	uint32_t map_max, 
+	uint64_t** sum_map
+) {
+	uint64_t* map;
 	
-	MD5 (key, klen, out);
-	memcpy (&hash, &out[12], sizeof (uint32_t));
+	map = (uint64_t*) calloc (
+			(size_t) map_max + CsmgrT_Sum_Words (map_max), sizeof (uint64_t));
+	*sum_map = (map) ? map + map_max : NULL;
 	
-	return (hash);
+	return (map);
+}
+/*--------------------------------------------------------------------------------------
+	Updates min_seq and max_seq from the cob_map
+----------------------------------------------------------------------------------------*/
+static void 
+csmgr_stat_seq_range_update (
+	CsmgrT_Stat* rcd
+) {
+	uint32_t seq;
+	
+	rcd->min_seq = (csmgr_stat_cob_min_get (rcd, &seq) < 0) ? 0 : seq;
+	rcd->max_seq = (csmgr_stat_cob_max_get (rcd, &seq) < 0) ? 0 : seq;
+}
+/*--------------------------------------------------------------------------------------
+	Returns the first non-zero cob_map word at or after x (-1 if none)
+----------------------------------------------------------------------------------------*/
+static int 
+csmgr_stat_cob_word_next (
+	const CsmgrT_Stat* rcd, 
+	uint32_t x
+) {
+	uint32_t sx, sum_max;
+	uint64_t w;
+	
+	if (x >= rcd->map_max) {
+		return (-1);
+	}
+	if (rcd->sum_map == NULL) {
+		for (; x < rcd->map_max ; x++) {
+			if (rcd->cob_map[x]) {
+				return ((int) x);
+			}
+		}
+		return (-1);
+	}
+	sum_max = CsmgrT_Sum_Words (rcd->map_max);
+	sx = x / 64;
+	w = rcd->sum_map[sx] & (~0ULL << (x % 64));
+	while (w == 0) {
+		if (++sx >= sum_max) {
+			return (-1);
+		}
+		w = rcd->sum_map[sx];
+	}
+	return ((int)(sx * 64 + __builtin_ctzll (w)));
+}
+/*--------------------------------------------------------------------------------------
+	Returns the last non-zero cob_map word at or before x (-1 if none)
+----------------------------------------------------------------------------------------*/
+static int 
+csmgr_stat_cob_word_prev (
+	const CsmgrT_Stat* rcd, 
+	uint32_t x
+) {
+	uint32_t sx;
+	uint64_t w;
+	
+	if (rcd->map_max == 0) {
+		return (-1);
+	}
+	if (x >= rcd->map_max) {
+		x = rcd->map_max - 1;
+	}
+	if (rcd->sum_map == NULL) {
+		for (;; x--) {
+			if (rcd->cob_map[x]) {
+				return ((int) x);
+			}
+			if (x == 0) {
+				return (-1);
+			}
+		}
+	}
+	sx = x / 64;
+	w = rcd->sum_map[sx];
+	if (x % 64 != 63) {
+		w &= (1ULL << (x % 64 + 1)) - 1;
+	}
+	while (w == 0) {
+		if (sx == 0) {
+			return (-1);
+		}
+		w = rcd->sum_map[--sx];
+	}
+	return ((int)(sx * 64 + 63 - __builtin_clzll (w)));
 }
-
@@ -32,6 +32,8 @@
 
 #define __CEF_FACE_SOURECE__
 
+#define _GNU_SOURCE
+
 #define		CEF_FACE_SEND_USLEEP	100000
 #define		CEF_FACE_SEND_TIMEOUT	10000
 
@@ -46,6 +48,9 @@
 
 #include <sys/ioctl.h>
 #include <arpa/inet.h>
+#ifndef CefC_MACOS
+#include <sys/epoll.h>
+#endif // CefC_MACOS
 
 #include <cefore/cef_hash.h>
 #include <cefore/cef_face.h>
@@ -67,15 +72,30 @@
 
 #define	DEMO_RETRY_NUM	10
 
+#define CefC_Face_Udp_Batch_Max		64		/* Maximum messages of one sendmmsg 		*/
+
+#define CefC_Face_Peer_Key_Max		24		/* family, protocol, port, address, scope	*/
+#define CefC_Face_Peer_Usrid_Max	64
+
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
 
+/****** Entry of Peer Cache (binary peer address to Face-ID) *****/
+typedef struct CefT_Face_Peer {
+	unsigned char 	key[CefC_Face_Peer_Key_Max];
+	uint32_t 		klen;
+	int 			faceid;
+	char 			usr_id[CefC_Face_Peer_Usrid_Max];
+} CefT_Face_Peer;
+
 /****************************************************************************************
  State Variables
  ****************************************************************************************/
 static CefT_Hash_Handle sock_tbl;				/* Socket Table							*/
 static CefT_Face* face_tbl = NULL;				/* Face Table							*/
+static CefT_Hash_Handle peer_tbl;				/* Peer Cache							*/
+static CefT_Face_Peer** face_peer = NULL;		/* Peer Cache entry of each Face		*/
 static uint16_t max_tbl_size = 0;				/* Maximum size of the Tables			*/
 static uint16_t process_port_num = 0;			/* The port number that cefnetd uses	*/
 static uint16_t assigned_faceid = CefC_Face_Reserved;
@@ -88,6 +108,22 @@ static int local_sock_path_len = 0;
 static char babel_sock_path[1024];
 static int babel_sock_path_len = 0;
 
+/* Messages to UDP Faces held by cef_face_frame_send_batch (main thread only) 	*/
+static int udp_batch_num = 1;
+static int udp_batch_cnt = 0;
+static int udp_batch_sock = -1;
+static unsigned char* udp_batch_buff = NULL;
+static uint16_t udp_batch_faceids[CefC_Face_Udp_Batch_Max];
+#ifndef CefC_MACOS
+static struct mmsghdr udp_batch_msgs[CefC_Face_Udp_Batch_Max];
+static struct iovec udp_batch_iovs[CefC_Face_Udp_Batch_Max];
+#endif // CefC_MACOS
+
+/* epoll instance where the sockets of the Faces are registered 	*/
+static int face_epfd = -1;
+static uint32_t face_fd_gen = 1;				/* Incremented when the FD of a Face changes */
+static uint32_t listen_face_gen = 0;			/* face_fd_gen of the last listen face update */
+
 static int my_udp_listen_port_num = 0;
 static int my_tcp_listen_port_num = 0;
 
@@ -95,6 +131,26 @@ static int my_tcp_listen_port_num = 0;
  Static Function Declaration
  ****************************************************************************************/
 
+/*--------------------------------------------------------------------------------------
+	Sends a message via the specified Face without the lock of the Face
+----------------------------------------------------------------------------------------*/
+static void
+cef_face_frame_send_body (
+	uint16_t 		faceid, 				/* Face-ID indicating the destination 		*/
+	unsigned char* 	msg, 					/* a message to send						*/
+	size_t			msg_len					/* length of the message to send 			*/
+);
+/*--------------------------------------------------------------------------------------
+	Sends a Content Object via the specified Face without the lock of the Face
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+cef_face_object_send_body (
+	uint16_t 		faceid, 				/* Face-ID indicating the destination 		*/
+	unsigned char* 	msg, 					/* a message to send						*/
+	size_t			msg_len,				/* length of the message to send 			*/
+	CefT_CcnMsg_MsgBdy* pm 				/* Parsed message 							*/
+);
+
 /*--------------------------------------------------------------------------------------
 	Deallocates the specified addrinfo
 ----------------------------------------------------------------------------------------*/
@@ -130,6 +186,36 @@ cef_face_peer_id_create (
 	char* usr_id,
 	char* port_str
 );
+/*--------------------------------------------------------------------------------------
+	Creates the key of Peer Cache from the peer address
+----------------------------------------------------------------------------------------*/
+static int									/* length of the key, or -1 if unsupported	*/
+cef_face_peer_key_create (
+	const struct sockaddr* sa,
+	int protocol,
+	unsigned char* key
+);
+/*--------------------------------------------------------------------------------------
+	Removes the Peer Cache entry of the specified Face
+----------------------------------------------------------------------------------------*/
+static void
+cef_face_peer_cache_remove (
+	int faceid								/* Face-ID									*/
+);
+/*--------------------------------------------------------------------------------------
+	Registers the socket of the specified Face to the epoll instance
+----------------------------------------------------------------------------------------*/
+static void
+cef_face_fd_watch (
+	int faceid								/* Face-ID									*/
+);
+/*--------------------------------------------------------------------------------------
+	Removes the socket of the specified Face from the epoll instance
+----------------------------------------------------------------------------------------*/
+static void
+cef_face_fd_unwatch (
+	int faceid								/* Face-ID									*/
+);
 /*--------------------------------------------------------------------------------------
 	Looks up Face-ID that is not used
 ----------------------------------------------------------------------------------------*/
@@ -203,8 +289,16 @@ cef_face_init (
 	for (i = 0; i < max_tbl_size; i++) {
 		face_tbl[i].ifindex = -1;
 		face_tbl[i].bw_stat_i = -1;	//0.8.3
+		pthread_mutex_init (&face_tbl[i].tx_mutex, NULL);
 	}
 	sock_tbl = cef_hash_tbl_create ((uint16_t) max_tbl_size);
+	peer_tbl = cef_hash_tbl_create ((uint16_t) max_tbl_size);
+	face_peer = (CefT_Face_Peer**) calloc (max_tbl_size, sizeof (CefT_Face_Peer*));
+	if ((sock_tbl == (CefT_Hash_Handle) NULL) ||
+		(peer_tbl == (CefT_Hash_Handle) NULL) || (face_peer == NULL)) {
+		cef_log_write (CefC_Log_Error, "%s (sock_tbl/peer_tbl)\n", __func__);
+		return (-1);
+	}
 
 	local_sock_path_len = cef_client_local_sock_name_get (local_sock_path);
 	babel_sock_path_len = cef_client_babel_sock_name_get (babel_sock_path);
@@ -299,6 +393,12 @@ cef_face_update_listen_faces (
 	int new_inudpfdc = 2;
 	int new_intcpfdc = 0;
 
+	/* The lists are rebuilt only when the FD of any Face has changed 	*/
+	if (listen_face_gen == face_fd_gen) {
+		return (0);
+	}
+	listen_face_gen = face_fd_gen;
+
 	for (i = CefC_Face_Reserved ; i < assigned_faceid ; i++) {
 
 		if (face_tbl[i].fd > 0) {
@@ -320,6 +420,31 @@ cef_face_update_listen_faces (
 
 	return (1);
 }
+/*--------------------------------------------------------------------------------------
+	Sets the epoll instance where the sockets of the Faces are registered
+----------------------------------------------------------------------------------------*/
+int											/* Returns a negative value if it fails 	*/
+cef_face_event_fd_set (
+	int epfd								/* epoll instance, or -1 to stop 			*/
+) {
+#ifndef CefC_MACOS
+	int i;
+
+	face_epfd = epfd;
+	if ((face_epfd < 0) || (face_tbl == NULL)) {
+		return (0);
+	}
+	/* Registers the Faces created before 		*/
+	for (i = 0 ; i < max_tbl_size ; i++) {
+		if (face_tbl[i].fd > 0) {
+			cef_face_fd_watch (i);
+		}
+	}
+	return (0);
+#else // CefC_MACOS
+	return (-1);
+#endif // CefC_MACOS
+}
 /*--------------------------------------------------------------------------------------
 	Looks up and creates the peer Face
 ----------------------------------------------------------------------------------------*/
@@ -333,10 +458,23 @@ cef_face_lookup_peer_faceid (
 	char 	name[NI_MAXHOST];
 	int 	result;
 	CefT_Sock* entry;
+	CefT_Face_Peer* peer;
 	int 	faceid;
 	char port_str[32];
 	char peer_id[512];
 	char usr_id[512];
+	unsigned char key[CefC_Face_Peer_Key_Max];
+	int 	klen;
+
+	/* Looks up the binary peer address from Peer Cache 	*/
+	klen = cef_face_peer_key_create ((struct sockaddr*) sas, protocol, key);
+	if (klen > 0) {
+		peer = (CefT_Face_Peer*) cef_hash_tbl_item_get (peer_tbl, key, klen);
+		if (peer) {
+			strcpy (user_id, peer->usr_id);
+			return (peer->faceid);
+		}
+	}
 
 	/* Obtains the source node's information 	*/
 	result = getnameinfo ((struct sockaddr*) sas, sas_len,
@@ -358,11 +496,28 @@ cef_face_lookup_peer_faceid (
 		cef_dbg_write (CefC_Dbg_Finest,
 			"[face] Lookup the Face#%d for %s\n", entry->faceid, peer_id);
 #endif // CefC_Debug
-		return (entry->faceid);
+		faceid = entry->faceid;
+	} else {
+		faceid = cef_face_lookup_faceid (protocol, peer_id, usr_id, port_str, NULL);
+	}
+
+	/* Caches the binary peer address so that the next lookup skips the above 	*/
+	if ((faceid >= 0) && (faceid < max_tbl_size) && (klen > 0) &&
+		(face_peer[faceid] == NULL) && (strlen (usr_id) < CefC_Face_Peer_Usrid_Max)) {
+		peer = (CefT_Face_Peer*) malloc (sizeof (CefT_Face_Peer));
+		if (peer) {
+			memcpy (peer->key, key, klen);
+			peer->klen 	 = (uint32_t) klen;
+			peer->faceid = faceid;
+			strcpy (peer->usr_id, usr_id);
+			if (cef_hash_tbl_item_set (peer_tbl, key, klen, peer) < 0) {
+				free (peer);
+			} else {
+				face_peer[faceid] = peer;
+			}
+		}
 	}
 
-	faceid = cef_face_lookup_faceid (protocol, peer_id, usr_id, port_str, NULL);
-
 #ifdef CefC_Debug
 	cef_dbg_write (CefC_Dbg_Finer,
 		"[face] Creation the new Face#%d for %s.\n", faceid, peer_id);
@@ -420,6 +575,7 @@ cef_face_lookup_local_faceid (
 	face_tbl[faceid].index = index;
 	face_tbl[faceid].fd = entry->sock;
 	face_tbl[faceid].local_f = 1;
+	cef_face_fd_watch (faceid);
 
 #ifdef CefC_Debug
 	cef_dbg_write (CefC_Dbg_Finer,
@@ -437,6 +593,8 @@ cef_face_close (
 ) {
 	CefT_Sock* entry;
 
+	cef_face_frame_send_flush ();
+	cef_face_peer_cache_remove (faceid);
 	entry = (CefT_Sock*) cef_hash_tbl_item_remove_from_index (
 										sock_tbl, face_tbl[faceid].index);
 
@@ -445,6 +603,7 @@ cef_face_close (
 		cef_dbg_write (CefC_Dbg_Finer,
 			"[face] Close the Face#%d (FD#%d)\n", faceid, face_tbl[entry->faceid].fd);
 #endif // CefC_Debug
+		cef_face_fd_unwatch (faceid);
 		face_tbl[faceid].index 		= 0;
 		face_tbl[faceid].fd 		= 0;
 		face_tbl[faceid].protocol 	= CefC_Face_Type_Invalid;
@@ -496,6 +655,7 @@ cef_face_down (
 		cef_dbg_write (CefC_Dbg_Finer,
 			"[face] Down the Face#%d (FD#%d)\n", faceid, face_tbl[entry->faceid].fd);
 #endif // CefC_Debug
+		cef_face_fd_unwatch (faceid);
 		face_tbl[faceid].fd = 0;
 		face_tbl[faceid].ifindex 	= -1;	//0.8.3
 		face_tbl[faceid].bw_stat_i 	= -1;	//0.8.3
@@ -633,6 +793,7 @@ cef_face_udp_listen_face_create (
 				face_tbl[CefC_Faceid_ListenUdpv4].index = indexv4;
 				face_tbl[CefC_Faceid_ListenUdpv4].fd = entryv4->sock;
 				face_tbl[CefC_Faceid_ListenUdpv4].protocol = CefC_Face_Type_Udp;
+				cef_face_fd_watch (CefC_Faceid_ListenUdpv4);
 				*res_v4 = CefC_Faceid_ListenUdpv4;
 			}
 		}
@@ -651,6 +812,7 @@ cef_face_udp_listen_face_create (
 				face_tbl[CefC_Faceid_ListenUdpv6].index = indexv6;
 				face_tbl[CefC_Faceid_ListenUdpv6].fd = entryv6->sock;
 				face_tbl[CefC_Faceid_ListenUdpv6].protocol = CefC_Face_Type_Udp;
+				cef_face_fd_watch (CefC_Faceid_ListenUdpv6);
 				*res_v6 = CefC_Faceid_ListenUdpv6;
 			}
 		}
@@ -787,6 +949,7 @@ cef_face_tcp_listen_face_create (
 				face_tbl[CefC_Faceid_ListenTcpv4].index = indexv4;
 				face_tbl[CefC_Faceid_ListenTcpv4].fd = entryv4->sock;
 				face_tbl[CefC_Faceid_ListenTcpv4].protocol = CefC_Face_Type_Tcp;
+				cef_face_fd_watch (CefC_Faceid_ListenTcpv4);
 				*res_v4 = CefC_Faceid_ListenTcpv4;
 			}
 		}
@@ -821,6 +984,7 @@ cef_face_tcp_listen_face_create (
 				face_tbl[CefC_Faceid_ListenTcpv6].index = indexv6;
 				face_tbl[CefC_Faceid_ListenTcpv6].fd = entryv6->sock;
 				face_tbl[CefC_Faceid_ListenTcpv6].protocol = CefC_Face_Type_Tcp;
+				cef_face_fd_watch (CefC_Faceid_ListenTcpv6);
 				*res_v6 = CefC_Faceid_ListenTcpv6;
 			}
 		}
@@ -896,6 +1060,7 @@ cef_face_accept_connect (
 		face_tbl[entry->faceid].index = index;
 		face_tbl[entry->faceid].fd = entry->sock;
 		face_tbl[entry->faceid].protocol = CefC_Face_Type_Tcp;
+		cef_face_fd_watch (entry->faceid);
 		return (entry->faceid);
 	 }
 	else {
@@ -917,6 +1082,7 @@ cef_face_accept_connect (
 				face_tbl[entry->faceid].index = index;
 				face_tbl[entry->faceid].fd = entry->sock;
 				face_tbl[entry->faceid].protocol = CefC_Face_Type_Tcp;
+				cef_face_fd_watch (entry->faceid);
 				return (entry->faceid);
 			}
 		}
@@ -941,6 +1107,7 @@ cef_face_accept_connect (
 	face_tbl[faceid].index = index;
 	face_tbl[faceid].fd = entry->sock;
 	face_tbl[faceid].protocol = CefC_Face_Type_Tcp;
+	cef_face_fd_watch (faceid);
 
 #if 0
 	{
@@ -1042,6 +1209,7 @@ cef_face_local_face_create (
 	face_tbl[CefC_Faceid_Local].index 	= index;
 	face_tbl[CefC_Faceid_Local].fd 		= entry->sock;
 	face_tbl[CefC_Faceid_Local].local_f	= 1;
+	cef_face_fd_watch (CefC_Faceid_Local);
 
 	return (CefC_Faceid_Local);
 }
@@ -1116,6 +1284,7 @@ cef_face_babel_face_create (
 		entry);
 	face_tbl[CefC_Faceid_ListenBabel].index = index;
 	face_tbl[CefC_Faceid_ListenBabel].fd 	= entry->sock;
+	cef_face_fd_watch (CefC_Faceid_ListenBabel);
 
 	return (CefC_Faceid_ListenBabel);
 }
@@ -1146,8 +1315,8 @@ cef_face_get_seqnum_from_faceid (
 	uint16_t 	faceid						/* Face-ID									*/
 ) {
 	assert (faceid >= 0 && faceid <= max_tbl_size);
-	face_tbl[faceid].seqnum++;
-	return (face_tbl[faceid].seqnum);
+	/* The forwarding workers and the main thread send to the same Face 	*/
+	return (__atomic_add_fetch (&face_tbl[faceid].seqnum, 1, __ATOMIC_RELAXED));
 }
 
 /*--------------------------------------------------------------------------------------
@@ -1158,6 +1327,130 @@ cef_face_frame_send_forced (
 	uint16_t 		faceid, 				/* Face-ID indicating the destination 		*/
 	unsigned char* 	msg, 					/* a message to send						*/
 	size_t			msg_len					/* length of the message to send 			*/
+) {
+	/* A message to the stream socket may be sent in pieces, so the senders 	*/
+	/* on the different threads must not be interleaved 						*/
+	if (face_tbl[faceid].local_f ||
+		(face_tbl[faceid].protocol == CefC_Face_Type_Tcp)) {
+		pthread_mutex_lock (&face_tbl[faceid].tx_mutex);
+		cef_face_frame_send_body (faceid, msg, msg_len);
+		pthread_mutex_unlock (&face_tbl[faceid].tx_mutex);
+	} else {
+		cef_face_frame_send_body (faceid, msg, msg_len);
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Sets the maximum number of UDP messages sent with one system call
+----------------------------------------------------------------------------------------*/
+int											/* Returns a negative value if it fails 	*/
+cef_face_udp_batch_init (
+	int 			batch_num				/* 1 sends each message immediately 		*/
+) {
+#ifdef CefC_MACOS
+	batch_num = 1;
+#endif // CefC_MACOS
+	if (batch_num > CefC_Face_Udp_Batch_Max) {
+		batch_num = CefC_Face_Udp_Batch_Max;
+	}
+	cef_face_frame_send_flush ();
+	free (udp_batch_buff);
+	udp_batch_buff = NULL;
+	udp_batch_num  = 1;
+
+	if (batch_num > 1) {
+		udp_batch_buff = (unsigned char*) malloc ((size_t) batch_num * CefC_Max_Length);
+		if (udp_batch_buff == NULL) {
+			return (-1);
+		}
+		udp_batch_num = batch_num;
+	}
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Sends a message via the specified Face. Messages to UDP Faces are held until
+	cef_face_frame_send_flush is called or the batch is full.
+----------------------------------------------------------------------------------------*/
+void
+cef_face_frame_send_batch (
+	uint16_t 		faceid, 				/* Face-ID indicating the destination 		*/
+	unsigned char* 	msg, 					/* a message to send						*/
+	size_t			msg_len					/* length of the message to send 			*/
+) {
+#ifndef CefC_MACOS
+	CefT_Sock* entry;
+	int n;
+
+	if ((udp_batch_num < 2) || (face_tbl[faceid].local_f) ||
+		(face_tbl[faceid].protocol != CefC_Face_Type_Udp) ||
+		(msg_len > CefC_Max_Length)) {
+		cef_face_frame_send_forced (faceid, msg, msg_len);
+		return;
+	}
+	entry = (CefT_Sock*) cef_hash_tbl_item_get_from_index (
+										sock_tbl, face_tbl[faceid].index);
+	if (entry == NULL) {
+		return;
+	}
+	/* One sendmmsg is issued for one socket 	*/
+	if ((udp_batch_cnt > 0) && (udp_batch_sock != entry->sock)) {
+		cef_face_frame_send_flush ();
+	}
+	n = udp_batch_cnt;
+	memcpy (&udp_batch_buff[(size_t) n * CefC_Max_Length], msg, msg_len);
+	udp_batch_iovs[n].iov_base = &udp_batch_buff[(size_t) n * CefC_Max_Length];
+	udp_batch_iovs[n].iov_len  = msg_len;
+	memset (&udp_batch_msgs[n], 0, sizeof (struct mmsghdr));
+	udp_batch_msgs[n].msg_hdr.msg_name 		= entry->ai_addr;
+	udp_batch_msgs[n].msg_hdr.msg_namelen 	= entry->ai_addrlen;
+	udp_batch_msgs[n].msg_hdr.msg_iov 		= &udp_batch_iovs[n];
+	udp_batch_msgs[n].msg_hdr.msg_iovlen 	= 1;
+	udp_batch_faceids[n] = faceid;
+	udp_batch_sock = entry->sock;
+	udp_batch_cnt++;
+
+	if (udp_batch_cnt >= udp_batch_num) {
+		cef_face_frame_send_flush ();
+	}
+#else // CefC_MACOS
+	cef_face_frame_send_forced (faceid, msg, msg_len);
+#endif // CefC_MACOS
+}
+/*--------------------------------------------------------------------------------------
+	Sends the messages held by cef_face_frame_send_batch
+----------------------------------------------------------------------------------------*/
+void
+cef_face_frame_send_flush (
+	void
+) {
+#ifndef CefC_MACOS
+	int sent = 0;
+	int res;
+
+	while (sent < udp_batch_cnt) {
+		res = sendmmsg (udp_batch_sock,
+					&udp_batch_msgs[sent], (unsigned int)(udp_batch_cnt - sent), 0);
+		if (res < 1) {
+			break;
+		}
+		sent += res;
+	}
+	/* The rest is sent one by one, which waits for the socket to be writable 	*/
+	for ( ; sent < udp_batch_cnt ; sent++) {
+		cef_face_frame_send_body (udp_batch_faceids[sent],
+			(unsigned char*) udp_batch_iovs[sent].iov_base, udp_batch_iovs[sent].iov_len);
+	}
+#endif // CefC_MACOS
+	udp_batch_cnt  = 0;
+	udp_batch_sock = -1;
+}
+/*--------------------------------------------------------------------------------------
+	Sends a message via the specified Face without the lock of the Face
+----------------------------------------------------------------------------------------*/
+static void
+cef_face_frame_send_body (
+	uint16_t 		faceid, 				/* Face-ID indicating the destination 		*/
+	unsigned char* 	msg, 					/* a message to send						*/
+	size_t			msg_len					/* length of the message to send 			*/
 ) {
 	CefT_Sock* entry;
 	int res;
@@ -1341,6 +1634,29 @@ cef_face_object_send (
 	unsigned char* 	msg, 					/* a message to send						*/
 	size_t			msg_len,				/* length of the message to send 			*/
 	CefT_CcnMsg_MsgBdy* pm 				/* Parsed message 							*/
+) {
+	int res;
+
+	if (face_tbl[faceid].local_f ||
+		(face_tbl[faceid].protocol == CefC_Face_Type_Tcp)) {
+		pthread_mutex_lock (&face_tbl[faceid].tx_mutex);
+		res = cef_face_object_send_body (faceid, msg, msg_len, pm);
+		pthread_mutex_unlock (&face_tbl[faceid].tx_mutex);
+	} else {
+		res = cef_face_object_send_body (faceid, msg, msg_len, pm);
+	}
+
+	return (res);
+}
+/*--------------------------------------------------------------------------------------
+	Sends a Content Object via the specified Face without the lock of the Face
+----------------------------------------------------------------------------------------*/
+static int									/* Returns a negative value if it fails 	*/
+cef_face_object_send_body (
+	uint16_t 		faceid, 				/* Face-ID indicating the destination 		*/
+	unsigned char* 	msg, 					/* a message to send						*/
+	size_t			msg_len,				/* length of the message to send 			*/
+	CefT_CcnMsg_MsgBdy* pm 				/* Parsed message 							*/
 ) {
 	CefT_Sock* entry;
 	int res;
@@ -1634,6 +1950,14 @@ cef_face_all_face_close (
 
 	free (face_tbl);
 
+	for (i = 0 ; i < max_tbl_size ; i++) {
+		cef_face_peer_cache_remove (i);
+	}
+	free (face_peer);
+	face_peer = NULL;
+	cef_hash_tbl_destroy (peer_tbl);
+	peer_tbl = (CefT_Hash_Handle) NULL;
+
 	max_tbl_size = 0;
 }
 /*--------------------------------------------------------------------------------------
@@ -1966,8 +2290,10 @@ cef_face_lookup_faceid (
 				cef_face_close (entry->faceid);
 			}
 			else {
+				cef_face_peer_cache_remove (entry->faceid);
 				entry = (CefT_Sock*) cef_hash_tbl_item_remove_from_index (
 										sock_tbl, face_tbl[entry->faceid].index);
+				cef_face_fd_unwatch (entry->faceid);
 				face_tbl[entry->faceid].index 		= 0;
 				face_tbl[entry->faceid].fd 		= 0;
 				face_tbl[entry->faceid].protocol 	= CefC_Face_Type_Invalid;
@@ -2060,6 +2386,7 @@ RETRY:;
 		face_tbl[faceid].index = index;
 		face_tbl[faceid].fd = entry->sock;
 		face_tbl[faceid].protocol = (uint8_t) protocol;
+		cef_face_fd_watch (faceid);
 
 		if (create_f) {
 			*create_f = 1;
@@ -2168,6 +2495,107 @@ cef_face_peer_id_create (
 
 	return;
 }
+/*--------------------------------------------------------------------------------------
+	Creates the key of Peer Cache from the peer address
+----------------------------------------------------------------------------------------*/
+static int									/* length of the key, or -1 if unsupported	*/
+cef_face_peer_key_create (
+	const struct sockaddr* sa,
+	int protocol,
+	unsigned char* key
+) {
+	const struct sockaddr_in*  sin;
+	const struct sockaddr_in6* sin6;
+
+	key[0] = (unsigned char) sa->sa_family;
+	key[1] = (unsigned char) protocol;
+
+	switch (sa->sa_family) {
+		case AF_INET: {
+			sin = (const struct sockaddr_in*) sa;
+			memcpy (&key[2], &sin->sin_port, 2);
+			memcpy (&key[4], &sin->sin_addr, 4);
+			return (8);
+		}
+		case AF_INET6: {
+			sin6 = (const struct sockaddr_in6*) sa;
+			memcpy (&key[2], &sin6->sin6_port, 2);
+			memcpy (&key[4], &sin6->sin6_addr, 16);
+			memcpy (&key[20], &sin6->sin6_scope_id, 4);
+			return (24);
+		}
+		default: {
+			break;
+		}
+	}
+	return (-1);
+}
+/*--------------------------------------------------------------------------------------
+	Removes the Peer Cache entry of the specified Face
+----------------------------------------------------------------------------------------*/
+static void
+cef_face_peer_cache_remove (
+	int faceid								/* Face-ID									*/
+) {
+	CefT_Face_Peer* peer;
+
+	if ((face_peer == NULL) || (faceid < 0) || (faceid >= max_tbl_size)) {
+		return;
+	}
+	peer = face_peer[faceid];
+	if (peer == NULL) {
+		return;
+	}
+	cef_hash_tbl_item_remove (peer_tbl, peer->key, peer->klen);
+	face_peer[faceid] = NULL;
+	free (peer);
+}
+/*--------------------------------------------------------------------------------------
+	Registers the socket of the specified Face to the epoll instance
+----------------------------------------------------------------------------------------*/
+static void
+cef_face_fd_watch (
+	int faceid								/* Face-ID									*/
+) {
+#ifndef CefC_MACOS
+	struct epoll_event ev;
+#endif // CefC_MACOS
+
+	face_fd_gen++;
+#ifndef CefC_MACOS
+	if ((face_epfd < 0) || (face_tbl[faceid].fd <= 0)) {
+		return;
+	}
+	memset (&ev, 0, sizeof (ev));
+	ev.events 	= EPOLLIN;
+	ev.data.u64 = CefC_Face_Event_Data (face_tbl[faceid].fd, faceid);
+
+	if (epoll_ctl (face_epfd, EPOLL_CTL_ADD, face_tbl[faceid].fd, &ev) < 0) {
+		/* The socket is shared with the Face registered before 	*/
+		if ((errno != EEXIST) ||
+			(epoll_ctl (face_epfd, EPOLL_CTL_MOD, face_tbl[faceid].fd, &ev) < 0)) {
+			cef_log_write (CefC_Log_Warn,
+				"[face] Failed to watch the Face#%d (%s)\n", faceid, strerror (errno));
+		}
+	}
+#endif // CefC_MACOS
+}
+/*--------------------------------------------------------------------------------------
+	Removes the socket of the specified Face from the epoll instance
+----------------------------------------------------------------------------------------*/
+static void
+cef_face_fd_unwatch (
+	int faceid								/* Face-ID									*/
+) {
+	face_fd_gen++;
+#ifndef CefC_MACOS
+	if ((face_epfd < 0) || (face_tbl[faceid].fd <= 0)) {
+		return;
+	}
+	/* The socket which is half-closed keeps open, so it is removed explicitly 	*/
+	epoll_ctl (face_epfd, EPOLL_CTL_DEL, face_tbl[faceid].fd, NULL);
+#endif // CefC_MACOS
+}
 /*--------------------------------------------------------------------------------------
 	Looks up Face-ID that is not used
 ----------------------------------------------------------------------------------------*/
@@ -0,0 +1,601 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cef_fetch.c
+ */
+
+#define __CEF_FETCH_SOURECE__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <cefore/cef_fetch.h>
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define CefC_Fetch_Cubic_C			0.4		/* scaling constant of CUBIC 				*/
+#define CefC_Fetch_Cubic_Beta		0.7		/* multiplicative decrease of CUBIC 		*/
+#define CefC_Fetch_Aimd_Beta		0.5		/* multiplicative decrease of AIMD 			*/
+
+#define CefC_Fetch_Read_Wait_Max	1000	/* max wait of cef_fetch_read (ms) 			*/
+
+#define Fetch_Bit_Test(map, seq, mask) \
+	((map)[((seq) & (mask)) >> 6] & (1ULL << ((seq) & 63)))
+#define Fetch_Bit_Set(map, seq, mask) \
+	((map)[((seq) & (mask)) >> 6] |= (1ULL << ((seq) & 63)))
+#define Fetch_Bit_Clear(map, seq, mask) \
+	((map)[((seq) & (mask)) >> 6] &= ~(1ULL << ((seq) & 63)))
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+
+/*--------------------------------------------------------------------------------------
+	Sends the Interest of the chunk
+----------------------------------------------------------------------------------------*/
+static void
+cef_fetch_interest_send (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	uint64_t seq,							/* chunk number 							*/
+	uint64_t nowt							/* current time (us) 						*/
+);
+/*--------------------------------------------------------------------------------------
+	Sends the Interests while the window has room
+----------------------------------------------------------------------------------------*/
+static void
+cef_fetch_window_fill (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	uint64_t nowt							/* current time (us) 						*/
+);
+/*--------------------------------------------------------------------------------------
+	Updates the RTT estimation with the sample
+----------------------------------------------------------------------------------------*/
+static void
+cef_fetch_rtt_update (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	uint64_t rtt							/* RTT sample (us) 							*/
+);
+/*--------------------------------------------------------------------------------------
+	Returns the retransmission timeout of the chunk
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cef_fetch_slot_rto (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	CefT_Fetch_Slot* slot					/* slot of the chunk 						*/
+);
+/*--------------------------------------------------------------------------------------
+	Grows the window when a chunk is received
+----------------------------------------------------------------------------------------*/
+static void
+cef_fetch_cc_ack (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	uint64_t nowt							/* current time (us) 						*/
+);
+/*--------------------------------------------------------------------------------------
+	Shrinks the window when a chunk is lost
+----------------------------------------------------------------------------------------*/
+static void
+cef_fetch_cc_loss (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	uint64_t seq							/* lost chunk 								*/
+);
+/*--------------------------------------------------------------------------------------
+	Returns the cube root
+----------------------------------------------------------------------------------------*/
+static double
+cef_fetch_cbrt (
+	double x
+);
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+/*--------------------------------------------------------------------------------------
+	Creates the fetch engine. The chunks from params->chunk_num to last_chunk are
+	requested with the Interests created from opt and params.
+----------------------------------------------------------------------------------------*/
+CefT_Fetch* 								/* Created fetch engine 					*/
+cef_fetch_create (
+	CefT_Client_Handle fhdl,				/* client handle 							*/
+	CefT_CcnMsg_OptHdr* opt,				/* parameters to Option Header(s)			*/
+	CefT_CcnMsg_MsgBdy* params,				/* parameters to create the Interests 		*/
+	int cc_type,							/* CefC_Fetch_Cc_Xxx 						*/
+	uint32_t wnd_max,						/* max window (chunks) 						*/
+	uint32_t last_chunk						/* last chunk number to request 			*/
+) {
+	CefT_Fetch* fp;
+	uint32_t slot_num = 64;
+
+	if (wnd_max < CefC_Fetch_Wnd_Min) {
+		wnd_max = CefC_Fetch_Wnd_Min;
+	}
+	if (wnd_max > CefC_Fetch_Wnd_Max) {
+		wnd_max = CefC_Fetch_Wnd_Max;
+	}
+	while (slot_num < wnd_max) {
+		slot_num <<= 1;
+	}
+
+	fp = (CefT_Fetch*) calloc (1, sizeof (CefT_Fetch));
+	if (fp == NULL) {
+		return (NULL);
+	}
+	fp->slots 	= (CefT_Fetch_Slot*) calloc (slot_num, sizeof (CefT_Fetch_Slot));
+	fp->rcv_map = (uint64_t*) calloc (slot_num / 64, sizeof (uint64_t));
+	fp->req_map = (uint64_t*) calloc (slot_num / 64, sizeof (uint64_t));
+	if ((fp->slots == NULL) || (fp->rcv_map == NULL) || (fp->req_map == NULL)) {
+		cef_fetch_destroy (fp);
+		return (NULL);
+	}
+
+	fp->fhdl 		= fhdl;
+	fp->opt 		= *opt;
+	fp->params 		= *params;
+	fp->cc_type 	= (cc_type == CefC_Fetch_Cc_Aimd) ? CefC_Fetch_Cc_Aimd : CefC_Fetch_Cc_Cubic;
+	fp->wnd_max 	= slot_num;
+	fp->mask 		= slot_num - 1;
+	fp->head 		= params->chunk_num;
+	fp->next_seq 	= params->chunk_num;
+	fp->last_seq 	= last_chunk;
+
+	fp->cwnd_max 	= wnd_max;
+	fp->cwnd 		= (wnd_max < CefC_Fetch_Wnd_Init) ? wnd_max : CefC_Fetch_Wnd_Init;
+	fp->ssthresh 	= wnd_max;
+	fp->w_max 		= wnd_max;
+	fp->recover_seq = params->chunk_num;
+
+	/* The retransmissions of a chunk are aggregated by the PIT entry of the	*/
+	/* first Interest, so the longest timeout outlives the Interest lifetime	*/
+	/* to let the retransmission be looked up in the cache again 			*/
+	fp->rto 		= CefC_Fetch_Rto_Init;
+	fp->rto_max 	= (uint64_t) opt->lifetime * 1000 + CefC_Fetch_Rto_Min;
+	fp->retry_max 	= CefC_Fetch_Retry_Max;
+
+	return (fp);
+}
+/*--------------------------------------------------------------------------------------
+	Destroys the fetch engine
+----------------------------------------------------------------------------------------*/
+void
+cef_fetch_destroy (
+	CefT_Fetch* fp							/* fetch engine 							*/
+) {
+	uint32_t i;
+
+	if (fp == NULL) {
+		return;
+	}
+	if (fp->slots) {
+		for (i = 0 ; i < fp->wnd_max ; i++) {
+			free (fp->slots[i].buff);
+		}
+		free (fp->slots);
+	}
+	free (fp->rcv_map);
+	free (fp->req_map);
+	free (fp);
+}
+/*--------------------------------------------------------------------------------------
+	Returns the congestion control algorithm of the specified name
+----------------------------------------------------------------------------------------*/
+int											/* CefC_Fetch_Cc_Xxx, or -1 if invalid 		*/
+cef_fetch_cc_type_get (
+	const char* name						/* "aimd" or "cubic" 						*/
+) {
+	if (strcmp (name, "aimd") == 0) {
+		return (CefC_Fetch_Cc_Aimd);
+	}
+	if (strcmp (name, "cubic") == 0) {
+		return (CefC_Fetch_Cc_Cubic);
+	}
+	return (-1);
+}
+/*--------------------------------------------------------------------------------------
+	Sends the Interests of the initial window
+----------------------------------------------------------------------------------------*/
+void
+cef_fetch_start (
+	CefT_Fetch* fp							/* fetch engine 							*/
+) {
+	cef_fetch_window_fill (fp, cef_client_present_timeus_calc ());
+}
+/*--------------------------------------------------------------------------------------
+	Reads the message from cefnetd. Waits until the message arrives or the next
+	retransmission timeout.
+----------------------------------------------------------------------------------------*/
+int 										/* length of read buffer 					*/
+cef_fetch_read (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	unsigned char* buff, 					/* buffer to write the message 				*/
+	int len 								/* length of buffer 						*/
+) {
+	CefT_Connect* conn = (CefT_Connect*) fp->fhdl;
+	struct pollfd infds[1];
+	struct sockaddr_storage sas;
+	socklen_t sas_len = (socklen_t) sizeof (struct sockaddr_storage);
+	uint64_t nowt;
+	int wait_ms = CefC_Fetch_Read_Wait_Max;
+	int recv_len = 0;
+
+	if (fp->next_check_t) {
+		nowt = cef_client_present_timeus_calc ();
+		if (fp->next_check_t <= nowt) {
+			wait_ms = 0;
+		} else if (fp->next_check_t - nowt < CefC_Fetch_Read_Wait_Max * 1000) {
+			wait_ms = (int)((fp->next_check_t - nowt + 999) / 1000);
+		}
+	}
+
+	infds[0].fd = conn->sock;
+	infds[0].events = POLLIN | POLLERR;
+	poll (infds, 1, wait_ms);
+
+	if (infds[0].revents & (POLLIN | POLLERR | POLLNVAL | POLLHUP)) {
+		if (conn->ai) {
+			recv_len = recvfrom (
+					conn->sock, buff, len, 0, (struct sockaddr*) &sas, &sas_len);
+		} else {
+			recv_len = recv (conn->sock, buff, len, 0);
+		}
+	}
+
+	return (recv_len);
+}
+/*--------------------------------------------------------------------------------------
+	Stores the received chunk in the reorder buffer
+----------------------------------------------------------------------------------------*/
+int											/* 1 if stored, 0 if not requested or 		*/
+											/* already received 						*/
+cef_fetch_frame_input (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	struct cef_app_frame* app_frame			/* received frame 							*/
+) {
+	CefT_Fetch_Slot* slot;
+	uint64_t seq = app_frame->chunk_num;
+	uint64_t nowt;
+	unsigned char* new_buff;
+
+	/* The chunks after the end chunk are not requested any more 	*/
+	if ((app_frame->end_chunk_num >= 0) &&
+		((uint64_t) app_frame->end_chunk_num < fp->last_seq)) {
+		fp->last_seq = (uint64_t) app_frame->end_chunk_num;
+		while (fp->next_seq > fp->last_seq + 1) {
+			fp->next_seq--;
+			if (Fetch_Bit_Test (fp->req_map, fp->next_seq, fp->mask)) {
+				Fetch_Bit_Clear (fp->req_map, fp->next_seq, fp->mask);
+				fp->inflight--;
+			}
+		}
+	}
+
+	if ((seq < fp->head) || (seq >= fp->next_seq)) {
+		return (0);
+	}
+	if (Fetch_Bit_Test (fp->rcv_map, seq, fp->mask)) {
+		return (0);
+	}
+
+	/* Stores the payload 		*/
+	slot = &fp->slots[seq & fp->mask];
+	if (slot->buff_size < app_frame->payload_len) {
+		new_buff = (unsigned char*) realloc (slot->buff, app_frame->payload_len);
+		if (new_buff == NULL) {
+			return (0);
+		}
+		slot->buff 		= new_buff;
+		slot->buff_size = app_frame->payload_len;
+	}
+	memcpy (slot->buff, app_frame->payload, app_frame->payload_len);
+	slot->frame_size = app_frame->payload_len;
+
+	Fetch_Bit_Set (fp->rcv_map, seq, fp->mask);
+	if (Fetch_Bit_Test (fp->req_map, seq, fp->mask)) {
+		Fetch_Bit_Clear (fp->req_map, seq, fp->mask);
+		fp->inflight--;
+	}
+
+	/* Only the chunks which were not retransmitted give the RTT samples 	*/
+	nowt = cef_client_present_timeus_calc ();
+	if ((slot->retry == 0) && (nowt > slot->send_t)) {
+		cef_fetch_rtt_update (fp, nowt - slot->send_t);
+	}
+	cef_fetch_cc_ack (fp, nowt);
+	cef_fetch_window_fill (fp, nowt);
+
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Removes the next chunk in order from the reorder buffer. The payload is valid
+	until the next call of the fetch APIs.
+----------------------------------------------------------------------------------------*/
+int											/* 1 if the chunk is returned 				*/
+cef_fetch_frame_get (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	unsigned char** payload,				/* payload of the chunk 					*/
+	int* payload_len,						/* length of the payload 					*/
+	uint32_t* chunk_num						/* chunk number 							*/
+) {
+	CefT_Fetch_Slot* slot;
+
+	if ((fp->head >= fp->next_seq) ||
+		(Fetch_Bit_Test (fp->rcv_map, fp->head, fp->mask) == 0)) {
+		/* The delivered slots are reused for the next chunks 	*/
+		cef_fetch_window_fill (fp, cef_client_present_timeus_calc ());
+		return (0);
+	}
+	slot = &fp->slots[fp->head & fp->mask];
+	*payload 		= slot->buff;
+	*payload_len 	= slot->frame_size;
+	*chunk_num 		= (uint32_t) fp->head;
+
+	Fetch_Bit_Clear (fp->rcv_map, fp->head, fp->mask);
+	fp->head++;
+
+	return (1);
+}
+/*--------------------------------------------------------------------------------------
+	Retransmits the Interests whose timeout expired
+----------------------------------------------------------------------------------------*/
+int											/* -1 if a chunk was retransmitted too many	*/
+											/* times 									*/
+cef_fetch_timer_process (
+	CefT_Fetch* fp							/* fetch engine 							*/
+) {
+	CefT_Fetch_Slot* slot;
+	uint64_t nowt = cef_client_present_timeus_calc ();
+	uint64_t next_t = 0;
+	uint64_t seq;
+	uint64_t rto;
+
+	if ((fp->next_check_t == 0) || (nowt < fp->next_check_t)) {
+		return (0);
+	}
+
+	for (seq = fp->head ; seq < fp->next_seq ; seq++) {
+		if (Fetch_Bit_Test (fp->req_map, seq, fp->mask) == 0) {
+			continue;
+		}
+		slot = &fp->slots[seq & fp->mask];
+		rto = cef_fetch_slot_rto (fp, slot);
+
+		if (nowt - slot->send_t >= rto) {
+			if (slot->retry >= fp->retry_max) {
+				return (-1);
+			}
+			cef_fetch_cc_loss (fp, seq);
+			cef_fetch_interest_send (fp, seq, nowt);
+			slot->retry++;
+			rto = cef_fetch_slot_rto (fp, slot);
+		}
+		if ((next_t == 0) || (slot->send_t + rto < next_t)) {
+			next_t = slot->send_t + rto;
+		}
+	}
+	fp->next_check_t = next_t;
+	cef_fetch_window_fill (fp, nowt);
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Checks whether all the chunks have been delivered
+----------------------------------------------------------------------------------------*/
+int											/* 1 if completed 							*/
+cef_fetch_completed (
+	CefT_Fetch* fp							/* fetch engine 							*/
+) {
+	return (fp->head > fp->last_seq);
+}
+/*--------------------------------------------------------------------------------------
+	Sends the Interest of the chunk
+----------------------------------------------------------------------------------------*/
+static void
+cef_fetch_interest_send (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	uint64_t seq,							/* chunk number 							*/
+	uint64_t nowt							/* current time (us) 						*/
+) {
+	fp->params.chunk_num = (uint32_t) seq;
+	cef_client_interest_input (fp->fhdl, &fp->opt, &fp->params);
+
+	fp->slots[seq & fp->mask].send_t = nowt;
+	if ((fp->next_check_t == 0) || (nowt + fp->rto < fp->next_check_t)) {
+		fp->next_check_t = nowt + fp->rto;
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Sends the Interests while the window has room
+----------------------------------------------------------------------------------------*/
+static void
+cef_fetch_window_fill (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	uint64_t nowt							/* current time (us) 						*/
+) {
+	while (((double) fp->inflight < fp->cwnd) &&
+		(fp->next_seq <= fp->last_seq) &&
+		(fp->next_seq - fp->head < fp->wnd_max)) {
+
+		fp->slots[fp->next_seq & fp->mask].retry = 0;
+		Fetch_Bit_Set (fp->req_map, fp->next_seq, fp->mask);
+		fp->inflight++;
+		cef_fetch_interest_send (fp, fp->next_seq, nowt);
+		fp->next_seq++;
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Updates the RTT estimation with the sample
+----------------------------------------------------------------------------------------*/
+static void
+cef_fetch_rtt_update (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	uint64_t rtt							/* RTT sample (us) 							*/
+) {
+	uint64_t diff;
+
+	if (fp->srtt == 0) {
+		fp->srtt 	= rtt;
+		fp->rttvar 	= rtt / 2;
+	} else {
+		diff = (fp->srtt > rtt) ? fp->srtt - rtt : rtt - fp->srtt;
+		fp->rttvar 	= (3 * fp->rttvar + diff) / 4;
+		fp->srtt 	= (7 * fp->srtt + rtt) / 8;
+	}
+	fp->rto = fp->srtt + 4 * fp->rttvar;
+	if (fp->rto < CefC_Fetch_Rto_Min) {
+		fp->rto = CefC_Fetch_Rto_Min;
+	}
+	if (fp->rto > fp->rto_max) {
+		fp->rto = fp->rto_max;
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Returns the retransmission timeout of the chunk. The timeout is backed off per
+	chunk, so that the RTT samples of the other chunks do not shorten it and the
+	last retransmissions outlive the PIT entries of the earlier ones.
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cef_fetch_slot_rto (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	CefT_Fetch_Slot* slot					/* slot of the chunk 						*/
+) {
+	uint64_t rto = fp->rto_max;
+
+	if (slot->retry < 16) {
+		rto = fp->rto << slot->retry;
+	}
+	if (rto > fp->rto_max) {
+		rto = fp->rto_max;
+	}
+	return (rto);
+}
+/*--------------------------------------------------------------------------------------
+	Grows the window when a chunk is received
+----------------------------------------------------------------------------------------*/
+static void
+cef_fetch_cc_ack (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	uint64_t nowt							/* current time (us) 						*/
+) {
+	double t;
+	double target;
+
+	if (fp->cwnd < fp->ssthresh) {
+		/* slow start 		*/
+		fp->cwnd += 1.0;
+	} else if (fp->cc_type == CefC_Fetch_Cc_Aimd) {
+		fp->cwnd += 1.0 / fp->cwnd;
+	} else {
+		if (fp->epoch_t == 0) {
+			fp->epoch_t = nowt;
+			if (fp->cwnd < fp->w_max) {
+				fp->cubic_k = cef_fetch_cbrt ((fp->w_max - fp->cwnd) / CefC_Fetch_Cubic_C);
+			} else {
+				fp->cubic_k = 0.0;
+				fp->w_max 	= fp->cwnd;
+			}
+		}
+		/* W(t) = C (t - K)^3 + W_max, one RTT ahead 	*/
+		t = (double)(nowt + fp->srtt - fp->epoch_t) / 1000000.0 - fp->cubic_k;
+		target = CefC_Fetch_Cubic_C * t * t * t + fp->w_max;
+		if (target > fp->cwnd) {
+			fp->cwnd += (target - fp->cwnd) / fp->cwnd;
+		} else {
+			fp->cwnd += 0.01 / fp->cwnd;
+		}
+	}
+	if (fp->cwnd > fp->cwnd_max) {
+		fp->cwnd = fp->cwnd_max;
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Shrinks the window when a chunk is lost
+----------------------------------------------------------------------------------------*/
+static void
+cef_fetch_cc_loss (
+	CefT_Fetch* fp,							/* fetch engine 							*/
+	uint64_t seq							/* lost chunk 								*/
+) {
+	/* The window is reduced once for the losses in the same window 	*/
+	if (seq < fp->recover_seq) {
+		return;
+	}
+	fp->recover_seq = fp->next_seq;
+
+	if (fp->cc_type == CefC_Fetch_Cc_Aimd) {
+		fp->cwnd *= CefC_Fetch_Aimd_Beta;
+	} else {
+		/* fast convergence 	*/
+		if (fp->cwnd < fp->w_max) {
+			fp->w_max = fp->cwnd * (1.0 + CefC_Fetch_Cubic_Beta) / 2.0;
+		} else {
+			fp->w_max = fp->cwnd;
+		}
+		fp->cwnd *= CefC_Fetch_Cubic_Beta;
+		fp->epoch_t = 0;
+	}
+	if (fp->cwnd < CefC_Fetch_Wnd_Min) {
+		fp->cwnd = CefC_Fetch_Wnd_Min;
+	}
+	fp->ssthresh = fp->cwnd;
+}
+/*--------------------------------------------------------------------------------------
+	Returns the cube root
+----------------------------------------------------------------------------------------*/
+static double
+cef_fetch_cbrt (
+	double x
+) {
+	double y = (x > 1.0) ? x / 3.0 : 1.0;
+	int i;
+
+	if (x <= 0.0) {
+		return (0.0);
+	}
+	/* Newton's method 		*/
+	for (i = 0 ; i < 32 ; i++) {
+		y = y - (y * y * y - x) / (3.0 * y * y);
+	}
+	return (y);
+}
@@ -63,6 +63,10 @@
 #define CefC_Fib_Default_Len	4
 #define CefC_Fib_Addr_Max		32
 
+#define CefC_Fib_Lpm_Comp_Max	63				/* Component counts from this value 	*/
+												/* share the last slot of the index		*/
+#define CefC_Fib_Lpm_Offs_Max	256				/* Max components parsed in one search	*/
+
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
@@ -71,6 +75,11 @@
  State Variables
  ****************************************************************************************/
 static CefT_Fib_Entry* default_entry = NULL;
+
+/* Number of FIB entries per component count and the bitmap of the counts in use.	*/
+/* The search probes only the prefix lengths that some entry actually has.			*/
+static uint32_t fib_lpm_cnt[CefC_Fib_Lpm_Comp_Max + 1] = {0};
+static uint64_t fib_lpm_mask = 0;
 static char prot_str[3][16] = {"invalid", "tcp", "udp"};
 
 #ifdef CefC_Debug
@@ -137,6 +146,32 @@ cef_fib_remove_faceid_from_entry (
 	int faceid,
 	uint8_t type
 );
+/*--------------------------------------------------------------------------------------
+	Obtains the end offsets of the components of the name
+----------------------------------------------------------------------------------------*/
+static int									/* Number of components, or -1 if too many	*/
+cef_fib_name_comp_parse (
+	const unsigned char* name,				/* Name TLV									*/
+	uint16_t name_len,						/* Length of Name							*/
+	uint16_t offs[],						/* set the end offset of each component		*/
+	int offs_max							/* Size of offs								*/
+);
+/*--------------------------------------------------------------------------------------
+	Registers the prefix length of the FIB entry to the LPM index
+----------------------------------------------------------------------------------------*/
+static void
+cef_fib_lpm_insert (
+	const unsigned char* name,				/* Key of the FIB entry						*/
+	uint16_t name_len						/* Length of Key							*/
+);
+/*--------------------------------------------------------------------------------------
+	Removes the prefix length of the FIB entry from the LPM index
+----------------------------------------------------------------------------------------*/
+static void
+cef_fib_lpm_remove (
+	const unsigned char* name,				/* Key of the FIB entry						*/
+	uint16_t name_len						/* Length of Key							*/
+);
 
 /****************************************************************************************
  ****************************************************************************************/
@@ -153,6 +188,11 @@ cef_fib_init (
 	char*			 nodeid16_c[],
 	uint16_t		 port_num
 ){
+	/* The FIB is searched with the prefix hashes of the name descriptors. 	*/
+	/* The keys of the FIB are set by the operator, so the fixed seed does 	*/
+	/* not make the table open to flooding.									*/
+	cef_hash_tbl_seed_set (fib, CefC_Hash_Seed_Default);
+
 	/* Reads the FIB configuration file 	*/
 	cef_fib_config_file_read (fib, nodeid4_num, nodeid16_num, nodeid4_c, nodeid16_c, port_num);
 	cef_fib_faceid_cleanup (fib);
@@ -172,8 +212,25 @@ cef_fib_entry_search (
 	unsigned char* mep;
 	uint16_t len = name_len;
 	uint16_t length;
+	uint16_t offs[CefC_Fib_Lpm_Offs_Max];
+	int comp_num;
+	int k;
 
-	while (len > 0) {
+	/* Parses the components once and probes only the prefix lengths that are 	*/
+	/* registered, from the longest one.										*/
+	comp_num = cef_fib_name_comp_parse (name, name_len, offs, CefC_Fib_Lpm_Offs_Max);
+
+	for (k = comp_num ; k > 0 ; k--) {
+		if ((k < CefC_Fib_Lpm_Comp_Max) &&
+			((fib_lpm_mask & (1ULL << k)) == 0)) {
+			continue;
+		}
+		if ((k >= CefC_Fib_Lpm_Comp_Max) &&
+			((fib_lpm_mask & (1ULL << CefC_Fib_Lpm_Comp_Max)) == 0)) {
+			k = CefC_Fib_Lpm_Comp_Max;
+			continue;
+		}
+		len = offs[k - 1];
 		entry = (CefT_Fib_Entry*) cef_hash_tbl_item_get (fib, name, len);
 
 		if (entry != NULL) {
@@ -191,6 +248,19 @@ cef_fib_entry_search (
 #endif // CefC_Debug
 			return (entry);
 		}
+	}
+	if (comp_num >= 0) {
+		return (default_entry);
+	}
+
+	/* The name has too many components to be parsed at once 	*/
+	len = name_len;
+	while (len > 0) {
+		entry = (CefT_Fib_Entry*) cef_hash_tbl_item_get (fib, name, len);
+
+		if (entry != NULL) {
+			return (entry);
+		}
 
 		msp = name;
 		mep = name + len - 1;
@@ -209,6 +279,45 @@ cef_fib_entry_search (
 
 	return (default_entry);
 }
+/*--------------------------------------------------------------------------------------
+	Searches FIB entry matching the prefix of the name of the parsed message,
+	using the prefix hashes of its name descriptor
+----------------------------------------------------------------------------------------*/
+CefT_Fib_Entry* 							/* FIB entry 								*/
+cef_fib_entry_search_with_desc (
+	CefT_Hash_Handle fib,					/* FIB										*/
+	CefT_CcnMsg_MsgBdy* pm, 				/* Parsed CEFORE message					*/
+	uint16_t name_len						/* Length of the prefix of pm->name			*/
+) {
+	CefT_Name_Desc* nd = &pm->name_desc;
+	CefT_Fib_Entry* entry;
+	int k;
+
+	if ((nd->len == 0) || (nd->len != pm->name_len)) {
+		return (cef_fib_entry_search (fib, pm->name, name_len));
+	}
+	for (k = nd->comp_num ; k > 0 ; k--) {
+		if (nd->offs[k - 1] <= name_len) {
+			break;
+		}
+	}
+	if ((k == 0) || (nd->offs[k - 1] != name_len)) {
+		return (cef_fib_entry_search (fib, pm->name, name_len));
+	}
+
+	for ( ; k > 0 ; k--) {
+		if ((fib_lpm_mask & (1ULL << k)) == 0) {
+			continue;
+		}
+		entry = (CefT_Fib_Entry*) cef_hash_tbl_item_get_hashv (
+							fib, pm->name, nd->offs[k - 1], nd->hashv[k - 1]);
+		if (entry != NULL) {
+			return (entry);
+		}
+	}
+
+	return (default_entry);
+}
 /*--------------------------------------------------------------------------------------
 	Obtains Face-ID(s) to forward the Interest matching the specified FIB entry
 ----------------------------------------------------------------------------------------*/
@@ -325,6 +434,7 @@ cef_fib_faceid_remove (
 	/* check fib entry */
 	if (entry->faces.next == NULL) {
 		entry = (CefT_Fib_Entry*) cef_hash_tbl_item_remove (fib, entry->key, entry->klen);
+		cef_fib_lpm_remove (entry->key, entry->klen);
 		if (entry->klen == CefC_Fib_Default_Len) {
 			default_entry = NULL;
 		}
@@ -400,6 +510,7 @@ cef_fib_entry_lookup (
 		}
 		entry = cef_fib_entry_create (name, name_len);
 		cef_hash_tbl_item_set (fib, name, name_len, entry);
+		cef_fib_lpm_insert (name, name_len);
 
 		if (name_len == CefC_Fib_Default_Len) {
 			default_entry = entry;
@@ -440,6 +551,7 @@ cef_fib_faceid_cleanup (
 
 			if (entry->faces.next == NULL) {
 				work = (CefT_Fib_Entry*) cef_hash_tbl_item_remove_from_index (fib, index);
+				cef_fib_lpm_remove (work->key, work->klen);
 
 				if (work->klen == CefC_Fib_Default_Len) {
 					default_entry = NULL;
@@ -688,6 +800,7 @@ OWN_ID:
 			}
 			entry = cef_fib_entry_create (name, res);
 			cef_hash_tbl_item_set (fib, name, res, entry);
+			cef_fib_lpm_insert (name, res);
 		}
 
 		if (res == CefC_Fib_Default_Len) {
@@ -856,6 +969,7 @@ cef_fib_entry_destroy (
 	if (entry == NULL) {
 		return (0);
 	}
+	cef_fib_lpm_remove (name, name_len);
 
 	face = entry->faces.next;
 
@@ -1266,6 +1380,7 @@ cef_fib_route_add (
 		/* create new entry */
 		entry = cef_fib_entry_create (name, res);
 		cef_hash_tbl_item_set (fib, name, res, entry);
+		cef_fib_lpm_insert (name, res);
 	}
 	cef_log_write (CefC_Log_Info,
 		"Insert the FIB entry: URI=%s, Prot=%s, Next=%s, Face=%d\n",
@@ -1370,6 +1485,7 @@ cef_fib_route_del (
 
 		/* fib entry is empty */
 		fib_entry = (CefT_Fib_Entry*) cef_hash_tbl_item_remove (fib, name, name_len);
+		cef_fib_lpm_remove (name, name_len);
 		free (fib_entry->key);
 		fib_entry->key = NULL;
 		free (fib_entry);
@@ -1462,3 +1578,84 @@ cef_fib_info_get (
 endfunc:;
 	return (strlen (info_buff));
 }
+/*--------------------------------------------------------------------------------------
+	Obtains the end offsets of the components of the name
+----------------------------------------------------------------------------------------*/
+static int									/* Number of components, or -1 if too many	*/
+cef_fib_name_comp_parse (
+	const unsigned char* name,				/* Name TLV									*/
+	uint16_t name_len,						/* Length of Name							*/
+	uint16_t offs[],						/* set the end offset of each component		*/
+	int offs_max							/* Size of offs								*/
+) {
+	uint16_t length;
+	uint32_t x = 0;
+	int num = 0;
+
+	while (x < name_len) {
+		if (num >= offs_max) {
+			return (-1);
+		}
+		if (x + CefC_S_Type + CefC_S_Length > name_len) {
+			/* A broken tail is handled as the last component 	*/
+			offs[num++] = name_len;
+			break;
+		}
+		memcpy (&length, &name[x + CefC_S_Type], CefC_S_Length);
+		x += CefC_S_Type + CefC_S_Length + ntohs (length);
+		offs[num++] = (x < name_len) ? (uint16_t) x : name_len;
+	}
+
+	return (num);
+}
+/*--------------------------------------------------------------------------------------
+	Returns the slot of the LPM index for the FIB entry
+----------------------------------------------------------------------------------------*/
+static int
+cef_fib_lpm_slot_get (
+	const unsigned char* name,				/* Key of the FIB entry						*/
+	uint16_t name_len						/* Length of Key							*/
+) {
+	uint16_t offs[CefC_Fib_Lpm_Comp_Max];
+	int num;
+
+	num = cef_fib_name_comp_parse (name, name_len, offs, CefC_Fib_Lpm_Comp_Max);
+	if ((num < 0) || (num > CefC_Fib_Lpm_Comp_Max)) {
+		num = CefC_Fib_Lpm_Comp_Max;
+	}
+	return (num);
+}
+/*--------------------------------------------------------------------------------------
+	Registers the prefix length of the FIB entry to the LPM index
+----------------------------------------------------------------------------------------*/
+static void
+cef_fib_lpm_insert (
+	const unsigned char* name,				/* Key of the FIB entry						*/
+	uint16_t name_len						/* Length of Key							*/
+) {
+	int slot = cef_fib_lpm_slot_get (name, name_len);
+
+	fib_lpm_cnt[slot]++;
+	fib_lpm_mask |= (1ULL << slot);
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Removes the prefix length of the FIB entry from the LPM index
+----------------------------------------------------------------------------------------*/
+static void
+cef_fib_lpm_remove (
+	const unsigned char* name,				/* Key of the FIB entry						*/
+	uint16_t name_len						/* Length of Key							*/
+) {
+	int slot = cef_fib_lpm_slot_get (name, name_len);
+
+	if (fib_lpm_cnt[slot] > 0) {
+		fib_lpm_cnt[slot]--;
+	}
+	if (fib_lpm_cnt[slot] == 0) {
+		fib_lpm_mask &= ~(1ULL << slot);
+	}
+
+	return;
+}
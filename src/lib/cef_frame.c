@@ -43,6 +43,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stddef.h>
 #include <time.h>
 #include <arpa/inet.h>
 #include <ctype.h>
@@ -62,6 +63,7 @@
 #include <cefore/cef_log.h>
 #include <cefore/cef_plugin.h>
 #include <cefore/cef_valid.h>
+#include <cefore/cef_hash.h>
 
 #ifdef DEB_CCNINFO
 #include <ctype.h>
@@ -736,30 +738,12 @@ cef_frame_message_parse (
 	poh->nodeid_len = 0;
 	poh->org.tp_variant = 0;
 	//pm init
-	pm->name_f = 0;
-	pm->chunk_num_f = 0;
-	pm->end_chunk_num_f = 0;
-	pm->nonce_f = 0;
-	pm->nonce = 0;
-	pm->payload_f = 0;
-	pm->discreply_f = 0;
-	pm->expiry = 0;
-	pm->seqnum = 0;
-	pm->org.symbolic_f = 0;
-	pm->org.longlife_f = 0;
+	/* Clears the fields before the name, so the caller does not need to clear 	*/
+	/* the whole structure which holds the name of CefC_Max_Length 				*/
+	memset (pm, 0, offsetof (CefT_CcnMsg_MsgBdy, name));
 
 	//0.8.3
 	pm->InterestType = CefC_PIT_TYPE_Rgl;
-	pm->KeyIdRester_f = 0;
-	pm->KeyIdRester_len = 0;
-	pm->ObjHash_f = 0;
-	pm->ObjHash_len = 0;
-
-	pm->expiry_f = 0;		//0.8.3c
-	pm->org.version_f = 0;
-	pm->org.version_len = 0;
-	pm->org.last_chunk_f = 0;	//0.8.3c
-	pm->org.putverify_f = 0;
 
 	/*----------------------------------------------------------------------*/
 	/* Parses Option Header				 									*/
@@ -916,6 +900,71 @@ cef_frame_payload_parse (
 
 	return;
 }
+/*--------------------------------------------------------------------------------------
+	Creates the descriptor of the name
+----------------------------------------------------------------------------------------*/
+void
+cef_frame_name_desc_create (
+	const unsigned char* name,				/* Name (Value of T_NAME)					*/
+	uint16_t name_len,						/* Length of Name 							*/
+	CefT_Name_Desc* nd						/* set the descriptor						*/
+) {
+	uint16_t length;
+	uint32_t x = 0;
+	int num = 0;
+
+	nd->len = 0;
+	nd->comp_num = 0;
+
+	while (x < name_len) {
+		if ((num >= CefC_Name_Desc_Comp_Max) ||
+			(x + CefC_S_Type + CefC_S_Length > name_len)) {
+			return;
+		}
+		memcpy (&length, &name[x + CefC_S_Type], CefC_S_Length);
+		x += CefC_S_Type + CefC_S_Length + ntohs (length);
+		if (x > name_len) {
+			return;
+		}
+		nd->offs[num++] = (uint16_t) x;
+	}
+	if (num == 0) {
+		return;
+	}
+	cef_hash_number_prefix_calc (CefC_Hash_Seed_Default, name, nd->offs, num, nd->hashv);
+	nd->comp_num = (uint16_t) num;
+	nd->len = name_len;
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the hash value of the prefix of the name from the descriptor
+----------------------------------------------------------------------------------------*/
+int 										/* 1 if the prefix is described, 0 if not	*/
+cef_frame_name_desc_hashv_get (
+	const CefT_CcnMsg_MsgBdy* pm,			/* Parsed CEFORE message					*/
+	const unsigned char* name,				/* pm->name, or another name				*/
+	uint16_t len,							/* Length of the prefix						*/
+	uint32_t* hashv							/* set the hash value						*/
+) {
+	const CefT_Name_Desc* nd = &pm->name_desc;
+	int k;
+
+	if ((name != pm->name) || (nd->len == 0) || (nd->len != pm->name_len)) {
+		return (0);
+	}
+	/* The full name and the name without the chunk are the usual prefixes 	*/
+	for (k = nd->comp_num - 1 ; k >= 0 ; k--) {
+		if (nd->offs[k] == len) {
+			*hashv = nd->hashv[k];
+			return (1);
+		}
+		if (nd->offs[k] < len) {
+			break;
+		}
+	}
+	return (0);
+}
 /*--------------------------------------------------------------------------------------
 	Converts the URI to Name
 ----------------------------------------------------------------------------------------*/
@@ -2003,11 +2052,18 @@ cef_frame_message_torg_set (
 	pen_nict[1] = (0x00FF00 & CefC_NICT_PEN) >> 8;
 	pen_nict[2] = (0x0000FF & CefC_NICT_PEN);
 */
-	if ( !tlvs->org_len ){
-		tlvs->org_len = cef_frame_build_msgorg_value(tlvs->org_val, &(tlvs->org));
+	uint16_t org_len = tlvs->org_len;
+
+	if ( org_len ){
+		/* Copies the value of the parsed message 	*/
+		memcpy(&buff[CefC_S_TLF + sizeof(pen_nict)], tlvs->org_val, org_len);
+	} else {
+		/* Builds the value in the message 			*/
+		org_len = cef_frame_build_msgorg_value(
+						&buff[CefC_S_TLF + sizeof(pen_nict)], &(tlvs->org));
 	}
 
-	if ( tlvs->org_len ){
+	if ( org_len ){
 		struct tlv_hdr fld_thdr;
 
 		index += CefC_S_TLF;
@@ -2015,13 +2071,11 @@ cef_frame_message_torg_set (
 		/* Sets IANA Private Enterprise Numbers */
 		memcpy(&buff[index], pen_nict, sizeof(pen_nict));
 		index += sizeof(pen_nict);
-
-		memcpy(&buff[index], tlvs->org_val, tlvs->org_len);
-		index += tlvs->org_len;
+		index += org_len;
 
 		/* Sets T_ORG Type,Length */
 		fld_thdr.type = htons (CefC_T_ORG);
-		fld_thdr.length = htons (sizeof(pen_nict)+tlvs->org_len);
+		fld_thdr.length = htons (sizeof(pen_nict)+org_len);
 		memcpy (buff, &fld_thdr, sizeof (struct tlv_hdr));
 	}
 	return index;
@@ -4067,6 +4121,10 @@ cef_frame_message_name_tlv_parse (
 		indx += CefC_S_ChunkNum;
 	}
 
+	/* The prefix hashes are calculated once and used by the FIB, PIT and 	*/
+	/* Content Store lookups												*/
+	cef_frame_name_desc_create (pm->name, pm->name_len, &pm->name_desc);
+
 	return (1);
 }
 /*--------------------------------------------------------------------------------------
@@ -4096,7 +4154,7 @@ cef_frame_message_payload_tlv_parse (
 	uint16_t offset							/* Offset from the top of message 			*/
 ) {
 	pm->payload_f = offset;
-	memcpy (pm->payload, value, length);
+	pm->payload = value;
 	pm->payload_len = length;
 
 	return (1);
@@ -4224,7 +4282,7 @@ cef_frame_message_discreply_tlv_parse (
 	uint16_t offset							/* Offset from the top of message 			*/
 ) {
 	pm->discreply_f = offset;
-	memcpy (pm->discreply_val, value, length);
+	pm->discreply_val = value;
 	pm->discreply_len = length;
 
 	return (1);
@@ -4689,7 +4747,7 @@ cef_frame_message_user_tlv_parse (
 	pm->org_len = (uint16_t)(length - 3);
 
 	/* Get Message header */
-	memcpy(pm->org_val, &value[3], pm->org_len);
+	pm->org_val = &value[3];
 
 	wp = value + 3;
 	ewp = value + 3 + pm->org_len;
@@ -4752,12 +4810,8 @@ cef_frame_message_user_tlv_parse (
 				pm->org.version_f = 1;
 				pm->org.version_len   = ntohs(tlv_hdr->length);
 				wp += CefC_S_TLF;
-				if (pm->org.version_len) {
-					memcpy (pm->org.version_val, wp, pm->org.version_len);
-					wp += pm->org.version_len;
-				} else {
-					pm->org.version_val[0] = 0x00;
-				}
+				pm->org.version_val = wp;
+				wp += pm->org.version_len;
 				break;
 			case CefC_T_PUTVERIFY: {	// without sseq/eseq
 				pm->org.putverify_f = 1;
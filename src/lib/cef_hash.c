@@ -36,7 +36,6 @@
  Include Files
  ****************************************************************************************/
 #include <limits.h>
-#include <openssl/md5.h>
 
 #include <cefore/cef_hash.h>
 
@@ -50,6 +49,10 @@
 #define CefC_Cleanup_Smax	 		4
 #endif
 
+#define CefC_Hash_S0	 			0xa0761d6478bd642fULL	/* Secrets of the hash function	*/
+#define CefC_Hash_S1	 			0xe7037ed1a0b428dbULL
+#define CefC_Hash_S2	 			0x8ebc6af09c88c6e3ULL
+
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
@@ -89,6 +92,67 @@ cef_lhash_number_create (
 	const unsigned char* key,
 	uint32_t klen
 );
+static int
+cef_hash_key_store (
+	CefT_Hash_Table* slot,
+	const unsigned char* key,
+	uint32_t klen
+);
+static void
+cef_hash_key_release (
+	CefT_Hash_Table* slot
+);
+static CefT_Hash_Table*
+cef_hash_slot_at (
+	CefT_Hash* ht,
+	uint32_t index
+);
+static int
+cef_hash_slot_find (
+	CefT_Hash_Table* tbl,
+	uint32_t elem_max,
+	uint32_t probe_max,
+	uint32_t hash,
+	const unsigned char* key,
+	uint32_t klen
+);
+static int
+cef_hash_slot_free_find (
+	CefT_Hash_Table* tbl,
+	uint32_t elem_max,
+	uint32_t hash,
+	uint32_t* dist
+);
+static void*
+cef_hash_slot_remove (
+	CefT_Hash_Table* tbl,
+	uint32_t elem_max,
+	uint32_t index,
+	uint32_t* elem_num,
+	uint32_t* tomb_num
+);
+static int
+cef_hash_item_set (
+	CefT_Hash* ht,
+	const unsigned char* key,
+	uint32_t klen,
+	uint8_t opt,
+	void* elem,
+	int update_f
+);
+static uint32_t
+cef_hash_prime_get (
+	uint64_t n
+);
+static void
+cef_hash_rehash_start (
+	CefT_Hash* ht
+);
+static void
+cef_hash_rehash_step (
+	CefT_Hash* ht,
+	uint32_t step
+);
 
 /****************************************************************************************
  ****************************************************************************************/
@@ -130,12 +194,11 @@ cef_hash_tbl_create (
 	}
 	memset (ht, 0, sizeof (CefT_Hash));
 
-	ht->tbl = (CefT_Hash_Table*) malloc (sizeof (CefT_Hash_Table) * table_size);
+	ht->tbl = (CefT_Hash_Table*) calloc (table_size, sizeof (CefT_Hash_Table));
 	if (ht->tbl == NULL) {
 		free (ht);
 		return ((CefT_Hash_Handle) NULL);
 	}
-	memset (ht->tbl, 0, sizeof (CefT_Hash_Table) * table_size);
 
 	srand ((unsigned) time (NULL));
 	ht->seed = (uint32_t)(rand () + 1);
@@ -188,12 +251,11 @@ cef_hash_tbl_create_ext (
 	}
 	memset (ht, 0, sizeof (CefT_Hash));
 
-	ht->tbl = (CefT_Hash_Table*) malloc (sizeof (CefT_Hash_Table) * table_size);
+	ht->tbl = (CefT_Hash_Table*) calloc (table_size, sizeof (CefT_Hash_Table));
 	if (ht->tbl == NULL) {
 		free (ht);
 		return ((CefT_Hash_Handle) NULL);
 	}
-	memset (ht->tbl, 0, sizeof (CefT_Hash_Table) * table_size);
 
 	srand ((unsigned) time (NULL));
 	ht->seed = (uint32_t)(rand () + 1);
@@ -208,16 +270,64 @@ cef_hash_tbl_destroy (
 	CefT_Hash_Handle handle
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
+	uint32_t i;
 
 	if (ht == NULL) {
 		return;
 	}
+	for (i = 0 ; i < ht->elem_max ; i++) {
+		cef_hash_key_release (&ht->tbl[i]);
+	}
 	free (ht->tbl);
+	if (ht->old_tbl) {
+		for (i = 0 ; i < ht->old_max ; i++) {
+			cef_hash_key_release (&ht->old_tbl[i]);
+		}
+		free (ht->old_tbl);
+	}
+	free (ht->retired_tbl);
 	free (ht);
 
 	return;
 }
 
+/*--------------------------------------------------------------------------------------
+	Allows the table to move its entries into a larger table. The slot indexes
+	returned by cef_hash_tbl_item_set are not stable on such a table.
+----------------------------------------------------------------------------------------*/
+void
+cef_hash_tbl_resize_enable (
+	CefT_Hash_Handle handle
+) {
+	CefT_Hash* ht = (CefT_Hash*) handle;
+
+	if (ht == NULL) {
+		return;
+	}
+	ht->resize_f = 1;
+
+	return;
+}
+
+/*--------------------------------------------------------------------------------------
+	Sets the seed of the empty table. A table whose seed is CefC_Hash_Seed_Default
+	may be searched with the hash values calculated out of the table.
+----------------------------------------------------------------------------------------*/
+int
+cef_hash_tbl_seed_set (
+	CefT_Hash_Handle handle,
+	uint32_t seed
+) {
+	CefT_Hash* ht = (CefT_Hash*) handle;
+
+	if ((ht == NULL) || (ht->elem_num > 0)) {
+		return (CefC_Hash_Faile);
+	}
+	ht->seed = seed;
+
+	return (0);
+}
+
 int
 cef_hash_tbl_item_set (
 	CefT_Hash_Handle handle,
@@ -226,81 +336,11 @@ cef_hash_tbl_item_set (
 	void* elem
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
-	uint32_t hash;
-	uint32_t index;
-	uint32_t i;
-	uint32_t empty_index = 0;
-	uint32_t empty_ff = 0;
 
 	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
 		return (CefC_Hash_Faile);
 	}
-
-	hash = cef_hash_number_create (ht->seed, key, klen);
-	index = hash % ht->elem_max;
-	if (ht->tbl[index].klen == 0) {
-		ht->tbl[index].hash = hash;
-		ht->tbl[index].elem = elem;
-		ht->tbl[index].klen = klen;
-		memcpy (ht->tbl[index].key, key, klen);
-		ht->elem_num++;
-		return (index);
-	}
-
-	for (i = index + 1 ; i < ht->elem_max ; i++) {
-		if (ht->tbl[i].klen == 0) {
-			ht->tbl[i].hash = hash;
-			ht->tbl[i].elem = elem;
-			ht->tbl[i].klen = klen;
-			memcpy (ht->tbl[i].key, key, klen);
-			ht->elem_num++;
-			return (i);
-		}
-		if ((ht->tbl[i].hash == hash) &&
-			(ht->tbl[i].klen == klen) &&
-			(memcmp(ht->tbl[i].key, key, klen) == 0)) {
-			ht->tbl[i].elem = elem;
-			
-			return (i);
-		}
-		if ((ht->tbl[i].klen == -1) && 
-			(empty_ff == 0)){
-			empty_index = i;
-			empty_ff = 1;
-		}
-	}
-
-	for (i = 0 ; i < index ; i++) {
-		if (ht->tbl[i].klen == 0) {
-			ht->tbl[i].hash = hash;
-			ht->tbl[i].elem = elem;
-			ht->tbl[i].klen = klen;
-			memcpy (ht->tbl[i].key, key, klen);
-			ht->elem_num++;
-			return (i);
-		}
-		if ((ht->tbl[i].hash == hash) &&
-			(ht->tbl[i].klen == klen) &&
-			(memcmp(ht->tbl[i].key, key, klen) == 0)) {
-			ht->tbl[i].elem = elem;
-			return (i);
-		}
-		if ((ht->tbl[i].klen == -1) && 
-			(empty_ff == 0)){
-			empty_index = i;
-			empty_ff = 1;
-		}
-	}
-	
-	if (empty_ff) {
-		ht->tbl[empty_index].hash = hash;
-		ht->tbl[empty_index].elem = elem;
-		ht->tbl[empty_index].klen = klen;
-		memcpy (ht->tbl[empty_index].key, key, klen);
-		ht->elem_num++;
-		return (empty_index);
-	}
-	return (CefC_Hash_Faile);
+	return (cef_hash_item_set (ht, key, klen, 0, elem, 1));
 }
 
 int
@@ -312,96 +352,14 @@ cef_hash_tbl_item_set_for_app (
 	void* elem
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
-	uint32_t hash;
-	uint32_t index;
-	uint32_t i;
-	uint32_t empty_index = 0;
-	uint32_t empty_ff = 0;
-	int		 res;
-
-	/*--------------------------*/
-	/* Temporary Implimentation */
-	/*--------------------------*/
 
 	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
 		return (CefC_Hash_Faile);
 	}
-	res = cef_hash_tbl_item_check_exact( handle, key, klen );
-	if ( res > 0 ) {
-		return (CefC_Hash_Faile);
-	}
-
-	hash = cef_hash_number_create (ht->seed, key, klen);
-	index = hash % ht->elem_max;
-
-	if (ht->tbl[index].klen == 0) {
-		ht->tbl[index].hash = hash;
-		ht->tbl[index].elem = elem;
-		ht->tbl[index].klen = klen;
-		ht->tbl[index].opt_f = opt;
-		memcpy (ht->tbl[index].key, key, klen);
-		ht->elem_num++;
-		return (index);
-	}
-
-	for (i = index + 1 ; i < ht->elem_max ; i++) {
-		if (ht->tbl[i].klen == 0) {
-			ht->tbl[i].hash = hash;
-			ht->tbl[i].elem = elem;
-			ht->tbl[i].klen = klen;
-			ht->tbl[i].opt_f = opt;
-			memcpy (ht->tbl[i].key, key, klen);
-			ht->elem_num++;
-			return (i);
-		}
-		if ((ht->tbl[i].hash == hash) &&
-			(ht->tbl[i].klen == klen) &&
-			(memcmp(ht->tbl[i].key, key, klen) == 0)) {
-			return (CefC_Hash_Faile);
-		}
-		if ((ht->tbl[i].klen == -1) && 
-			(empty_ff == 0)){
-			empty_index = i;
-			empty_ff = 1;
-		}
-	}
-
-	for (i = 0 ; i < index ; i++) {
-		if (ht->tbl[i].klen == 0) {
-			ht->tbl[i].hash = hash;
-			ht->tbl[i].elem = elem;
-			ht->tbl[i].klen = klen;
-			ht->tbl[i].opt_f = opt;
-			memcpy (ht->tbl[i].key, key, klen);
-			ht->elem_num++;
-			return (i);
-		}
-		if ((ht->tbl[i].hash == hash) &&
-			(ht->tbl[i].klen == klen) &&
-			(memcmp(ht->tbl[i].key, key, klen) == 0)) {
-			return (CefC_Hash_Faile);
-		}
-		if ((ht->tbl[i].klen == -1) && 
-			(empty_ff == 0)){
-			empty_index = i;
-			empty_ff = 1;
-		}
-	}
-
-	if (empty_ff) {
-		ht->tbl[empty_index].hash = hash;
-		ht->tbl[empty_index].elem = elem;
-		ht->tbl[empty_index].klen = klen;
-		ht->tbl[empty_index].opt_f = opt;
-		memcpy (ht->tbl[empty_index].key, key, klen);
-		ht->elem_num++;
-		return (empty_index);
-	}
-
-	return (CefC_Hash_Faile);
+	return (cef_hash_item_set (ht, key, klen, opt, elem, 0));
 }
 
-void* 
+void*
 cef_hash_tbl_item_set_prg (
 	CefT_Hash_Handle handle,
 	const unsigned char* key,
@@ -412,25 +370,27 @@ cef_hash_tbl_item_set_prg (
 	uint32_t hash;
 	uint32_t index;
 	void* old_elem = (void*) NULL;
-	
+
 	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
 		return ((void*) NULL);
 	}
 	hash = cef_hash_number_create (ht->seed, key, klen);
 	index = hash % ht->elem_max;
-	
+
 	if (ht->tbl[index].klen != 0 && ht->tbl[index].klen != -1) {
 		old_elem = ht->tbl[index].elem;
 	}
+	if (cef_hash_key_store (&ht->tbl[index], key, klen) < 0) {
+		return ((void*) NULL);
+	}
 	ht->tbl[index].hash = hash;
 	ht->tbl[index].elem = elem;
 	ht->tbl[index].klen = klen;
-	memcpy (ht->tbl[index].key, key, klen);
-	
+
 	return (old_elem);
 }
 
-void* 
+void*
 cef_hash_tbl_item_get_prg (
 	CefT_Hash_Handle handle,
 	const unsigned char* key,
@@ -438,22 +398,38 @@ cef_hash_tbl_item_get_prg (
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
 	uint32_t hash;
-	uint32_t index;
-	
+
 	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
 		return ((void*) NULL);
 	}
-	
+
 	hash = cef_hash_number_create (ht->seed, key, klen);
+
+	return (cef_hash_tbl_item_get_prg_hashv (handle, key, klen, hash));
+}
+
+void*
+cef_hash_tbl_item_get_prg_hashv (
+	CefT_Hash_Handle handle,
+	const unsigned char* key,
+	uint32_t klen,
+	uint32_t hash						/* Hash value of the key with the table seed	*/
+) {
+	CefT_Hash* ht = (CefT_Hash*) handle;
+	uint32_t index;
+
+	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
+		return ((void*) NULL);
+	}
 	index = hash % ht->elem_max;
-	
+
 	if (ht->tbl[index].hash == hash) {
-		if ((ht->tbl[index].klen == klen) && 
+		if ((ht->tbl[index].klen == klen) &&
 			(memcmp (key, ht->tbl[index].key, klen) == 0)) {
 			return ((void*) ht->tbl[index].elem);
 		}
 	}
-	
+
 	return ((void*) NULL);
 }
 
@@ -479,41 +455,40 @@ cef_hash_tbl_item_get (
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
 	uint32_t hash;
-	uint32_t index;
-	uint32_t i;
 
 	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
 		return ((void*) NULL);
 	}
 
 	hash = cef_hash_number_create (ht->seed, key, klen);
-	index = hash % ht->elem_max;
 
-	if ((ht->tbl[index].hash == hash) &&
-		(ht->tbl[index].klen == klen) &&
-		(memcmp(ht->tbl[index].key, key, klen) == 0)) {
-		return ((void*) ht->tbl[index].elem);
-	}
+	return (cef_hash_tbl_item_get_hashv (handle, key, klen, hash));
+}
 
-	for (i = index + 1 ; i < ht->elem_max ; i++) {
-		if(ht->tbl[i].klen == 0){
-			return ((void*) NULL);
-		}
-		if ((ht->tbl[i].hash == hash) &&
-			(ht->tbl[i].klen == klen) &&
-			(memcmp(ht->tbl[i].key, key, klen) == 0)) {
-			return ((void*) ht->tbl[i].elem);
-		}
+void*
+cef_hash_tbl_item_get_hashv (
+	CefT_Hash_Handle handle,
+	const unsigned char* key,
+	uint32_t klen,
+	uint32_t hash						/* Hash value of the key with the table seed	*/
+) {
+	CefT_Hash* ht = (CefT_Hash*) handle;
+	int index;
+
+	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
+		return ((void*) NULL);
 	}
 
-	for (i = 0 ; i < index ; i++) {
-		if(ht->tbl[i].klen == 0){
-			return ((void*) NULL);
-		}
-		if ((ht->tbl[i].hash == hash) &&
-			(ht->tbl[i].klen == klen) &&
-			(memcmp(ht->tbl[i].key, key, klen) == 0)) {
-			return ((void*) ht->tbl[i].elem);
+	index = cef_hash_slot_find (
+				ht->tbl, ht->elem_max, ht->probe_max, hash, key, klen);
+	if (index >= 0) {
+		return ((void*) ht->tbl[index].elem);
+	}
+	if (ht->old_tbl) {
+		index = cef_hash_slot_find (
+					ht->old_tbl, ht->old_max, ht->old_probe_max, hash, key, klen);
+		if (index >= 0) {
+			return ((void*) ht->old_tbl[index].elem);
 		}
 	}
 
@@ -527,6 +502,7 @@ cef_hash_tbl_item_get_for_app (
 	uint32_t klen
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
+	CefT_Hash_Table* slot;
 	uint32_t hash;
 	uint32_t i;
 	uint32_t entry_klen = 0;
@@ -534,28 +510,28 @@ cef_hash_tbl_item_get_for_app (
 	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
 		return ((void*) NULL);
 	}
-	
+
 	/* for exact match */
 	hash = cef_hash_number_create (ht->seed, key, klen);
 
-	for (i = 0 ; i < ht->elem_max ; i++) {
-		if (ht->tbl[i].klen == 0 || ht->tbl[i].klen == -1)
+	for (i = 0 ; (slot = cef_hash_slot_at (ht, i)) != NULL ; i++) {
+		if (slot->klen == 0 || slot->klen == -1)
 			continue;
-		
-		if (ht->tbl[i].opt_f) {
+
+		if (slot->opt_f) {
 			/* prefix match */
-			entry_klen = ht->tbl[i].klen;
+			entry_klen = slot->klen;
 			if ((entry_klen <= klen) &&
-				(memcmp (ht->tbl[i].key, key, entry_klen) == 0)) {
+				(memcmp (slot->key, key, entry_klen) == 0)) {
 				if (entry_klen == klen) {
-					return ((void*) ht->tbl[i].elem);
+					return ((void*) slot->elem);
 				} else if (entry_klen + 5 <= klen) {
 					/* eg) ccn:/test, ccn:/test/a */
 					/*                         ^^ */
 					/* separator(4) and prefix(more than 1) */
 					if ((key[entry_klen] == 0x00) &&
 						(key[entry_klen + 1] == 0x01)) {
-						return ((void*) ht->tbl[i].elem);
+						return ((void*) slot->elem);
 					}
 				} else {
 					continue;
@@ -563,10 +539,10 @@ cef_hash_tbl_item_get_for_app (
 			}
 		} else {
 			/* exact match */
-			if ((ht->tbl[i].hash == hash) &&
-				(ht->tbl[i].klen == klen) &&
-				(memcmp (ht->tbl[i].key, key, klen) == 0)) {
-				return ((void*) ht->tbl[i].elem);
+			if ((slot->hash == hash) &&
+				(slot->klen == klen) &&
+				(memcmp (slot->key, key, klen) == 0)) {
+				return ((void*) slot->elem);
 			}
 		}
 	}
@@ -581,12 +557,14 @@ cef_hash_tbl_item_get_from_index (
 	uint32_t index
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
+	CefT_Hash_Table* slot;
 
-	if (index > ht->elem_max) {
+	slot = cef_hash_slot_at (ht, index);
+	if (slot == NULL) {
 		return ((void*) NULL);
 	}
 
-	return ((void*) ht->tbl[index].elem);
+	return ((void*) slot->elem);
 }
 
 void*
@@ -597,105 +575,33 @@ cef_hash_tbl_item_remove (
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
 	uint32_t hash;
-	uint32_t index;
-	uint32_t i;
-	void* rtc = (void*) NULL;
-	int removed_f = 0;
-	int si;
-	uint32_t removed_indx;
+	int index;
 
 	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
-		return (CefC_Hash_False);
-	}
-
-	hash = cef_hash_number_create (ht->seed, key, klen);
-	index = hash % ht->elem_max;
-
-	if ((ht->tbl[index].hash == hash) &&
-		(ht->tbl[index].klen == klen) &&
-		(memcmp(ht->tbl[index].key, key, klen) == 0)) {
-		ht->tbl[index].hash = 0;
-		ht->tbl[index].klen = -1;
-		ht->tbl[index].opt_f = 0;
-		ht->elem_num--;
-		rtc = (void*) ht->tbl[index].elem;
-		ht->tbl[index].elem = NULL;
-		removed_f = 1;
-		removed_indx = index;
-		goto ENDFUNC;
+		return ((void*) NULL);
 	}
 
-	for (i = index + 1 ; i < ht->elem_max ; i++) {
-		if(ht->tbl[i].klen == 0){
-			rtc = (void*) NULL;
-			goto ENDFUNC;
-		}
-		if ((ht->tbl[i].hash == hash) &&
-			(ht->tbl[i].klen == klen) &&
-			(memcmp(ht->tbl[i].key, key, klen) == 0)) {
-			ht->tbl[i].hash = 0;
-			ht->tbl[i].klen = -1;
-			ht->tbl[i].opt_f = 0;
-			ht->elem_num--;
-			rtc = (void*) ht->tbl[i].elem;
-			ht->tbl[i].elem = NULL;
-			removed_f = 1;
-			removed_indx = i;
-			goto ENDFUNC;
-		}
+	if (ht->old_tbl) {
+		cef_hash_rehash_step (ht, CefC_Hash_Rehash_Step);
 	}
+	hash = cef_hash_number_create (ht->seed, key, klen);
 
-	for (i = 0 ; i < index ; i++) {
-		if(ht->tbl[i].klen == 0){
-			return ((void*) NULL);
-		}
-		if ((ht->tbl[i].hash == hash) &&
-			(ht->tbl[i].klen == klen) &&
-			(memcmp(ht->tbl[i].key, key, klen) == 0)) {
-			ht->tbl[i].hash = 0;
-			ht->tbl[i].klen = -1;
-			ht->tbl[i].opt_f = 0;
-			ht->elem_num--;
-			rtc = (void*) ht->tbl[i].elem;
-			ht->tbl[i].elem = NULL;
-			removed_f = 1;
-			removed_indx = i;
-			goto ENDFUNC;
+	index = cef_hash_slot_find (
+				ht->tbl, ht->elem_max, ht->probe_max, hash, key, klen);
+	if (index >= 0) {
+		return (cef_hash_slot_remove (
+					ht->tbl, ht->elem_max, index, &ht->elem_num, &ht->tomb_num));
+	}
+	if (ht->old_tbl) {
+		index = cef_hash_slot_find (
+					ht->old_tbl, ht->old_max, ht->old_probe_max, hash, key, klen);
+		if (index >= 0) {
+			return (cef_hash_slot_remove (
+						ht->old_tbl, ht->old_max, index, &ht->elem_num, NULL));
 		}
 	}
 
-ENDFUNC:
-	if(removed_f == 1){
-		/* compaction */
-		if(removed_indx == (ht->elem_max-1)){
-			if(ht->tbl[0].klen == 0){
-				ht->tbl[removed_indx].klen = 0;
-			}
-		} else {
-			if(ht->tbl[removed_indx+1].klen == 0){
-				ht->tbl[removed_indx].klen = 0;
-			}
-		}
-		if(ht->tbl[removed_indx].klen == 0){
-			for(si = (removed_indx-1); si >= 0; si--){
-				if(ht->tbl[si].klen == -1){
-					ht->tbl[si].klen = 0;
-				} else {
-					break;
-				}
-			}
-			if(ht->tbl[0].klen == 0){
-				for(si = (ht->elem_max-1); si > removed_indx; si--){
-					if(ht->tbl[si].klen == -1){
-						ht->tbl[si].klen = 0;
-					} else {
-						break;
-					}
-				}
-			}
-		}
-	}
-	return (rtc);
+	return ((void*) NULL);
 }
 
 void*
@@ -704,16 +610,13 @@ cef_hash_tbl_item_check_from_index (
 	uint32_t* index
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
+	CefT_Hash_Table* slot;
 	uint32_t i;
 
-	if (*index > ht->elem_max) {
-		return ((void*) NULL);
-	}
-
-	for (i = *index ; i < ht->elem_max ; i++) {
-		if (ht->tbl[i].klen != 0 && ht->tbl[i].klen != -1){
+	for (i = *index ; (slot = cef_hash_slot_at (ht, i)) != NULL ; i++) {
+		if (slot->klen != 0 && slot->klen != -1){
 			*index = i;
-			return ((void*) ht->tbl[i].elem);
+			return ((void*) slot->elem);
 		}
 	}
 	*index = 0;
@@ -726,18 +629,24 @@ cef_hash_tbl_item_remove_from_index (
 	uint32_t index
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
+	CefT_Hash_Table* slot;
 	void* rtc = (void*) NULL;
 
-	if (index > ht->elem_max) {
+	slot = cef_hash_slot_at (ht, index);
+	if (slot == NULL) {
 		return ((void*) NULL);
 	}
 
-	if (ht->tbl[index].klen != 0 && ht->tbl[index].klen != -1) {
-		ht->tbl[index].hash = 0;
-		ht->tbl[index].klen = -1;
+	if (slot->klen != 0 && slot->klen != -1) {
+		slot->hash = 0;
+		slot->klen = -1;
+		cef_hash_key_release (slot);
 		ht->elem_num--;
-		rtc = (void*) ht->tbl[index].elem;
-		ht->tbl[index].elem = NULL;
+		if (index < ht->elem_max) {
+			ht->tomb_num++;
+		}
+		rtc = (void*) slot->elem;
+		slot->elem = NULL;
 		return (rtc);
 	}
 
@@ -763,7 +672,13 @@ int
 cef_hash_tbl_item_max_idx_get (
 	CefT_Hash_Handle handle
 ) {
-	return ((int)(((CefT_Hash*) handle)->elem_max));
+	CefT_Hash* ht = (CefT_Hash*) handle;
+
+	/* The slots of the table being rehashed follow the slots of the table 	*/
+	if (ht->old_tbl) {
+		return ((int)(ht->elem_max + ht->old_max));
+	}
+	return ((int)(ht->elem_max));
 }
 
 void*
@@ -772,27 +687,29 @@ cef_hash_tbl_elem_get (
 	uint32_t* index
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
+	CefT_Hash_Table* slot;
 	uint32_t i;
 
-	if (*index > ht->elem_max) {
+	if (cef_hash_slot_at (ht, *index) == NULL) {
 		return ((void*) NULL);
 	}
 
-	for (i = *index ; i < ht->elem_max ; i++) {
-		if (ht->tbl[i].klen != 0 && ht->tbl[i].klen != -1) {
+	for (i = *index ; (slot = cef_hash_slot_at (ht, i)) != NULL ; i++) {
+		if (slot->klen != 0 && slot->klen != -1) {
 			*index = i;
-			return ((void*) ht->tbl[i].elem);
+			return ((void*) slot->elem);
 		}
 	}
 
 	for (i = 0 ; i < *index ; i++) {
-		if (ht->tbl[i].klen != 0 && ht->tbl[i].klen != -1) {
+		slot = cef_hash_slot_at (ht, i);
+		if (slot->klen != 0 && slot->klen != -1) {
 			*index = i;
-			return ((void*) ht->tbl[i].elem);
+			return ((void*) slot->elem);
 		}
 	}
 	*index = 0;
-	
+
 	return ((void*) NULL);
 }
 
@@ -814,14 +731,14 @@ cef_hash_tbl_no_col_item_get (
 	index = hash % ht->elem_max;
 
 	if ((ht->tbl[index].hash == hash) &&
-		(ht->tbl[index].klen == klen) && 
+		(ht->tbl[index].klen == klen) &&
 		(memcmp(ht->tbl[index].key, key, klen) == 0)) {
 		return ((void*) ht->tbl[index].elem);
 	}
 	return ((void*) NULL);
 }
 
-void* 
+void*
 cef_hash_tbl_item_check (
 	CefT_Hash_Handle handle,
 	const unsigned char* key,
@@ -829,11 +746,11 @@ cef_hash_tbl_item_check (
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
 
-	
+
 	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
 		return ((void*) NULL);
 	}
-	
+
 	return ((void*) cef_hash_tbl_item_get(handle, key, klen));
 }
 int
@@ -844,7 +761,7 @@ cef_hash_tbl_item_check_exact (
 ) {
 	CefT_Hash* ht = (CefT_Hash*) handle;
 
-	
+
 	if ((klen > CefC_Max_KLen) || (ht == NULL)) {
 		return (-1);
 	}
@@ -1088,9 +1005,23 @@ cef_lhash_tbl_item_set (
 	const unsigned char* key,
 	uint32_t klen,
 	void* elem
+) {
+	if (klen > CefC_Max_KLen) {
+		return (CefC_Hash_Faile);
+	}
+	return (cef_lhash_tbl_item_set_hashv (
+				handle, key, klen, cef_lhash_number_create (key, klen), elem));
+}
+
+int
+cef_lhash_tbl_item_set_hashv (
+	CefT_Hash_Handle handle,
+	const unsigned char* key,
+	uint32_t klen,
+	uint32_t hash,						/* Hash value of the key with the default seed	*/
+	void* elem
 ) {
 	CefT_List_Hash* ht = (CefT_List_Hash*) handle;
-	uint32_t hash;
 	uint32_t index;
 	CefT_List_Hash_Cell* cp;
 	CefT_List_Hash_Cell* wcp;
@@ -1100,7 +1031,6 @@ cef_lhash_tbl_item_set (
 		return (CefC_Hash_Faile);
 	}
 	
-	hash = cef_lhash_number_create (key, klen);
 	index = hash % ht->elem_max;
 
 	if(ht->tbl[index] == NULL){
@@ -1146,9 +1076,22 @@ cef_lhash_tbl_item_get (
 	CefT_Hash_Handle handle,
 	const unsigned char* key,
 	uint32_t klen
+) {
+	if (klen > CefC_Max_KLen) {
+		return ((void*) NULL);
+	}
+	return (cef_lhash_tbl_item_get_hashv (
+				handle, key, klen, cef_lhash_number_create (key, klen)));
+}
+
+void*
+cef_lhash_tbl_item_get_hashv (
+	CefT_Hash_Handle handle,
+	const unsigned char* key,
+	uint32_t klen,
+	uint32_t hash						/* Hash value of the key with the default seed	*/
 ) {
 	CefT_List_Hash* ht = (CefT_List_Hash*) handle;
-	uint32_t hash;
 	uint32_t index;
 	CefT_List_Hash_Cell* cp;
 
@@ -1156,7 +1099,6 @@ cef_lhash_tbl_item_get (
 		return ((void*) NULL);
 	}
 
-	hash = cef_lhash_number_create (key, klen);
 	index = hash % ht->elem_max;
 
 	cp = ht->tbl[index];
@@ -1477,42 +1419,519 @@ cef_lhash_tbl_item_check_exact (
 /****************************************************************************************
  ****************************************************************************************/
 
-static uint32_t
-cef_hash_number_create (
+/*--------------------------------------------------------------------------------------
+	Returns the slot of the index. The slots of the table being rehashed follow
+	the slots of the current table.
+----------------------------------------------------------------------------------------*/
+static CefT_Hash_Table*
+cef_hash_slot_at (
+	CefT_Hash* ht,
+	uint32_t index
+) {
+	if (ht == NULL) {
+		return (NULL);
+	}
+	if (index < ht->elem_max) {
+		return (&ht->tbl[index]);
+	}
+	if ((ht->old_tbl) && (index - ht->elem_max < ht->old_max)) {
+		return (&ht->old_tbl[index - ht->elem_max]);
+	}
+	return (NULL);
+}
+
+/*--------------------------------------------------------------------------------------
+	Searches the key. The search stops at an empty slot or after probe_max slots.
+----------------------------------------------------------------------------------------*/
+static int									/* Index of the slot, or -1 if not found	*/
+cef_hash_slot_find (
+	CefT_Hash_Table* tbl,
+	uint32_t elem_max,
+	uint32_t probe_max,
 	uint32_t hash,
 	const unsigned char* key,
 	uint32_t klen
 ) {
-#if 0
-	int i;
-	char* p = (char*) key;
+	uint32_t index = hash % elem_max;
+	uint32_t dist;
 
-	hash += p[0];
-	hash += p[klen - 1];
-	hash += p[(klen - 1) / 2];
+	if (probe_max >= elem_max) {
+		probe_max = elem_max - 1;
+	}
+	for (dist = 0 ; dist <= probe_max ; dist++) {
+		if (tbl[index].klen == 0) {
+			return (-1);
+		}
+		if ((tbl[index].hash == hash) &&
+			(tbl[index].klen == klen) &&
+			(memcmp (tbl[index].key, key, klen) == 0)) {
+			return ((int) index);
+		}
+		index++;
+		if (index == elem_max) {
+			index = 0;
+		}
+	}
+	return (-1);
+}
 
-	for (i = 0 ; i < klen ; i++) {
-		hash = hash * 33 + p[i];
+/*--------------------------------------------------------------------------------------
+	Returns the first empty or removed slot within CefC_Hash_Probe_Max slots
+	from the home slot of the hash
+----------------------------------------------------------------------------------------*/
+static int									/* Index of the slot, or -1 if none			*/
+cef_hash_slot_free_find (
+	CefT_Hash_Table* tbl,
+	uint32_t elem_max,
+	uint32_t hash,
+	uint32_t* dist
+) {
+	uint32_t index = hash % elem_max;
+
+	for (*dist = 0 ; (*dist <= CefC_Hash_Probe_Max) && (*dist < elem_max) ; (*dist)++) {
+		if ((tbl[index].klen == 0) || (tbl[index].klen == -1)) {
+			return ((int) index);
+		}
+		index++;
+		if (index == elem_max) {
+			index = 0;
+		}
+	}
+	return (-1);
+}
+
+/*--------------------------------------------------------------------------------------
+	Removes the entry in the slot and empties the run of removed slots that
+	ends at an empty slot
+----------------------------------------------------------------------------------------*/
+static void*
+cef_hash_slot_remove (
+	CefT_Hash_Table* tbl,
+	uint32_t elem_max,
+	uint32_t index,
+	uint32_t* elem_num,
+	uint32_t* tomb_num
+) {
+	void* rtc = tbl[index].elem;
+	uint32_t next;
+	uint32_t n;
+
+	tbl[index].hash = 0;
+	tbl[index].klen = -1;
+	tbl[index].opt_f = 0;
+	tbl[index].elem = NULL;
+	cef_hash_key_release (&tbl[index]);
+	(*elem_num)--;
+	if (tomb_num) {
+		(*tomb_num)++;
+	}
+
+	/* compaction */
+	next = (index + 1 == elem_max) ? 0 : index + 1;
+	if (tbl[next].klen != 0) {
+		return (rtc);
+	}
+	for (n = 0 ; (n < elem_max) && (tbl[index].klen == -1) ; n++) {
+		tbl[index].klen = 0;
+		if (tomb_num) {
+			(*tomb_num)--;
+		}
+		index = (index == 0) ? elem_max - 1 : index - 1;
+	}
+	return (rtc);
+}
+
+/*--------------------------------------------------------------------------------------
+	Sets the entry. If update_f is 0, an existing key is an error.
+----------------------------------------------------------------------------------------*/
+static int
+cef_hash_item_set (
+	CefT_Hash* ht,
+	const unsigned char* key,
+	uint32_t klen,
+	uint8_t opt,
+	void* elem,
+	int update_f
+) {
+	uint32_t hash;
+	uint32_t dist;
+	int index;
+
+	if (ht->old_tbl) {
+		cef_hash_rehash_step (ht, CefC_Hash_Rehash_Step);
+	}
+	hash = cef_hash_number_create (ht->seed, key, klen);
+
+	index = cef_hash_slot_find (
+				ht->tbl, ht->elem_max, ht->probe_max, hash, key, klen);
+	if (index >= 0) {
+		if (update_f == 0) {
+			return (CefC_Hash_Faile);
+		}
+		ht->tbl[index].elem = elem;
+		return (index);
+	}
+	if (ht->old_tbl) {
+		index = cef_hash_slot_find (
+					ht->old_tbl, ht->old_max, ht->old_probe_max, hash, key, klen);
+		if (index >= 0) {
+			if (update_f == 0) {
+				return (CefC_Hash_Faile);
+			}
+			ht->old_tbl[index].elem = elem;
+			return ((int)(ht->elem_max + index));
+		}
+	}
+
+	if ((ht->resize_f) && (ht->old_tbl == NULL) &&
+		((uint64_t)(ht->elem_num + ht->tomb_num + 1) * 100 >
+			(uint64_t) ht->elem_max * CefC_Hash_Load_Max)) {
+		cef_hash_rehash_start (ht);
+	}
+
+	index = cef_hash_slot_free_find (ht->tbl, ht->elem_max, hash, &dist);
+	if ((index < 0) && (ht->resize_f)) {
+		/* The probe reached CefC_Hash_Probe_Max. The rehash in progress is 	*/
+		/* completed and the entries are moved into a new table.				*/
+		if (ht->old_tbl) {
+			cef_hash_rehash_step (ht, ht->old_max);
+		}
+		if (ht->old_tbl == NULL) {
+			cef_hash_rehash_start (ht);
+			index = cef_hash_slot_free_find (ht->tbl, ht->elem_max, hash, &dist);
+		}
+	}
+	if (index < 0) {
+		/* The slot indexes of a table which does not allow resizing must 	*/
+		/* not change, so the insert fails								 	*/
+		return (CefC_Hash_Faile);
+	}
+	if (cef_hash_key_store (&ht->tbl[index], key, klen) < 0) {
+		return (CefC_Hash_Faile);
+	}
+	if (ht->tbl[index].klen == -1) {
+		ht->tomb_num--;
+	}
+	ht->tbl[index].hash  = hash;
+	ht->tbl[index].elem  = elem;
+	ht->tbl[index].klen  = klen;
+	ht->tbl[index].opt_f = opt;
+	ht->elem_num++;
+	if (dist > ht->probe_max) {
+		ht->probe_max = dist;
 	}
-#endif
-	unsigned char out[MD5_DIGEST_LENGTH];
-	
-	MD5 (key, klen, out);
-	memcpy (&hash, &out[12], sizeof (uint32_t));
 
-	return (hash);
+	return (index);
 }
 
+/*--------------------------------------------------------------------------------------
+	Returns the smallest prime number that is not less than n
+----------------------------------------------------------------------------------------*/
 static uint32_t
-cef_lhash_number_create (
+cef_hash_prime_get (
+	uint64_t n
+) {
+	uint64_t d;
+
+	if (n < 2) {
+		return (2);
+	}
+	for ( ; n < UINT32_MAX ; n++) {
+		for (d = 2 ; d * d <= n ; d++) {
+			if (n % d == 0) {
+				break;
+			}
+		}
+		if (d * d > n) {
+			break;
+		}
+	}
+	return ((uint32_t) n);
+}
+
+/*--------------------------------------------------------------------------------------
+	Starts moving the entries into a new table. The new table is twice as large
+	if the table is more than half full, otherwise it has the same size and only
+	drops the removed slots.
+----------------------------------------------------------------------------------------*/
+static void
+cef_hash_rehash_start (
+	CefT_Hash* ht
+) {
+	CefT_Hash_Table* tbl;
+	uint32_t elem_max = ht->elem_max;
+
+	if ((uint64_t) ht->elem_num * 2 > ht->elem_max) {
+		elem_max = cef_hash_prime_get ((uint64_t) ht->elem_max * 2);
+	}
+	tbl = (CefT_Hash_Table*) calloc (elem_max, sizeof (CefT_Hash_Table));
+	if (tbl == NULL) {
+		return;
+	}
+
+	/* The table moved by the previous rehash is freed here rather than when	*/
+	/* the move completes, so that a reader without the lock does not touch 	*/
+	/* freed memory.															*/
+	free (ht->retired_tbl);
+	ht->retired_tbl = NULL;
+
+	ht->old_tbl 		= ht->tbl;
+	ht->old_max 		= ht->elem_max;
+	ht->old_probe_max 	= ht->probe_max;
+	ht->old_idx 		= 0;
+	ht->tbl 			= tbl;
+	ht->elem_max 		= elem_max;
+	ht->probe_max 		= 0;
+	ht->tomb_num 		= 0;
+
+	return;
+}
+
+/*--------------------------------------------------------------------------------------
+	Moves up to step slots of the table being rehashed into the current table
+----------------------------------------------------------------------------------------*/
+static void
+cef_hash_rehash_step (
+	CefT_Hash* ht,
+	uint32_t step
+) {
+	CefT_Hash_Table* src;
+	CefT_Hash_Table* dst;
+	uint32_t dist;
+	int index;
+
+	while ((step > 0) && (ht->old_idx < ht->old_max)) {
+		src = &ht->old_tbl[ht->old_idx];
+
+		if ((src->klen != 0) && (src->klen != -1)) {
+			index = cef_hash_slot_free_find (ht->tbl, ht->elem_max, src->hash, &dist);
+			if (index < 0) {
+				/* Retries after an entry is removed from the current table 	*/
+				return;
+			}
+		} else {
+			ht->old_idx++;
+			step--;
+			continue;
+		}
+		ht->old_idx++;
+		step--;
+		dst = &ht->tbl[index];
+		if (dst->klen == -1) {
+			ht->tomb_num--;
+		}
+		/* The key buffer is handed over to the new slot 	*/
+		free (dst->key);
+		*dst = *src;
+		if (dist > ht->probe_max) {
+			ht->probe_max = dist;
+		}
+		src->key  = NULL;
+		src->kcap = 0;
+		src->klen = -1;
+	}
+
+	if (ht->old_idx >= ht->old_max) {
+		ht->retired_tbl = ht->old_tbl;
+		ht->old_tbl 	= NULL;
+		ht->old_max 	= 0;
+	}
+
+	return;
+}
+
+/*--------------------------------------------------------------------------------------
+	Copies the key to the buffer of the slot. The buffer is kept out of the slot
+	and is reused while it is large enough.
+----------------------------------------------------------------------------------------*/
+static int
+cef_hash_key_store (
+	CefT_Hash_Table* slot,
 	const unsigned char* key,
 	uint32_t klen
 ) {
-	uint32_t hash;
-	unsigned char out[MD5_DIGEST_LENGTH];
+	unsigned char* buff;
+	uint32_t cap;
+	
+	if ((slot->key == NULL) || (slot->kcap < klen)) {
+		cap = (klen + CefC_Hash_Key_Align - 1) & ~(CefC_Hash_Key_Align - 1);
+		if (cap == 0) {
+			cap = CefC_Hash_Key_Align;
+		}
+		buff = (unsigned char*) malloc (cap);
+		if (buff == NULL) {
+			return (-1);
+		}
+		free (slot->key);
+		slot->key  = buff;
+		slot->kcap = (uint16_t) cap;
+	}
+	memcpy (slot->key, key, klen);
 	
-	MD5 (key, klen, out);
-	memcpy (&hash, &out[12], sizeof (uint32_t));
+	return (0);
+}
+
+/*--------------------------------------------------------------------------------------
+	Frees the key buffer of the slot
+----------------------------------------------------------------------------------------*/
+static void
+cef_hash_key_release (
+	CefT_Hash_Table* slot
+) {
+	free (slot->key);
+	slot->key  = NULL;
+	slot->kcap = 0;
+}
 
-	return (hash);
+/*--------------------------------------------------------------------------------------
+	Multiplies two 64 bit values and folds the 128 bit product
+----------------------------------------------------------------------------------------*/
+static inline uint64_t
+cef_hash_mum (
+	uint64_t a,
+	uint64_t b
+) {
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = (__uint128_t) a * b;
+	
+	return ((uint64_t) r ^ (uint64_t)(r >> 64));
+#else // __SIZEOF_INT128__
+	uint64_t ha = a >> 32, la = (uint32_t) a;
+	uint64_t hb = b >> 32, lb = (uint32_t) b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32);
+	uint64_t c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	
+	c += lo < t;
+	rh += (rm0 >> 32) + (rm1 >> 32) + c;
+	
+	return (lo ^ rh);
+#endif // __SIZEOF_INT128__
+}
+
+static inline uint64_t
+cef_hash_read64 (
+	const unsigned char* p
+) {
+	uint64_t v;
+	memcpy (&v, p, sizeof (uint64_t));
+	return (v);
+}
+
+static inline uint64_t
+cef_hash_read32 (
+	const unsigned char* p
+) {
+	uint32_t v;
+	memcpy (&v, p, sizeof (uint32_t));
+	return (v);
+}
+
+/*--------------------------------------------------------------------------------------
+	Mixes the last 16 bytes or less of the key into the state and returns the
+	hash value of the key
+----------------------------------------------------------------------------------------*/
+static inline uint32_t
+cef_hash_number_final (
+	uint64_t h,
+	const unsigned char* p,
+	uint32_t n,
+	uint32_t klen
+) {
+	const uint64_t s1 = CefC_Hash_S1;
+	const uint64_t s2 = CefC_Hash_S2;
+	uint64_t a, b;
+	
+	if (n >= 8) {
+		a = cef_hash_read64 (p);
+		b = cef_hash_read64 (p + n - 8);
+	} else if (n >= 4) {
+		a = cef_hash_read32 (p);
+		b = cef_hash_read32 (p + n - 4);
+	} else if (n > 0) {
+		a = ((uint64_t) p[0] << 16) | ((uint64_t) p[n >> 1] << 8) | p[n - 1];
+		b = 0;
+	} else {
+		a = 0;
+		b = 0;
+	}
+	h = cef_hash_mum (a ^ s1, b ^ h);
+	h = cef_hash_mum (h ^ s2, (uint64_t) klen ^ s1);
+	
+	return ((uint32_t)(h ^ (h >> 32)));
+}
+
+/*--------------------------------------------------------------------------------------
+	Calculates the seeded hash value of the specified key
+	(multiply-mix hash of the wyhash family, consumes 16 bytes per round)
+----------------------------------------------------------------------------------------*/
+uint32_t
+cef_hash_number_calc (
+	uint32_t seed,
+	const unsigned char* key,
+	uint32_t klen
+) {
+	const unsigned char* p = key;
+	uint32_t n = klen;
+	uint64_t h = (uint64_t) seed ^ CefC_Hash_S0;
+	
+	while (n > 16) {
+		h = cef_hash_mum (cef_hash_read64 (p) ^ CefC_Hash_S1, cef_hash_read64 (p + 8) ^ h);
+		p += 16;
+		n -= 16;
+	}
+	return (cef_hash_number_final (h, p, n, klen));
+}
+
+/*--------------------------------------------------------------------------------------
+	Calculates the seeded hash values of the prefixes of the key in one pass.
+	hashv[i] is equal to cef_hash_number_calc (seed, key, offs[i]).
+----------------------------------------------------------------------------------------*/
+void
+cef_hash_number_prefix_calc (
+	uint32_t seed,
+	const unsigned char* key,
+	const uint16_t offs[],					/* Lengths of the prefixes in ascending order	*/
+	int num,
+	uint32_t hashv[]
+) {
+	uint64_t h = (uint64_t) seed ^ CefC_Hash_S0;
+	uint32_t done = 0;
+	uint32_t klen;
+	int i;
+	
+	/* The 16-byte rounds of a prefix are also the first rounds of the longer	*/
+	/* prefixes, so each byte is consumed once.									*/
+	for (i = 0 ; i < num ; i++) {
+		klen = offs[i];
+		if (klen < done) {
+			hashv[i] = cef_hash_number_calc (seed, key, klen);
+			continue;
+		}
+		while (klen - done > 16) {
+			h = cef_hash_mum (cef_hash_read64 (key + done) ^ CefC_Hash_S1,
+							  cef_hash_read64 (key + done + 8) ^ h);
+			done += 16;
+		}
+		hashv[i] = cef_hash_number_final (h, key + done, klen - done, klen);
+	}
+	return;
+}
+
+static uint32_t
+cef_hash_number_create (
+	uint32_t hash,
+	const unsigned char* key,
+	uint32_t klen
+) {
+	return (cef_hash_number_calc (hash, key, klen));
+}
+
+static uint32_t
+cef_lhash_number_create (
+	const unsigned char* key,
+	uint32_t klen
+) {
+	return (cef_hash_number_calc (CefC_Hash_Seed_Default, key, klen));
 }
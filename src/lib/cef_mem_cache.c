@@ -49,9 +49,9 @@
 #include <sys/wait.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <sched.h>
 #include <semaphore.h>
 
-#include <openssl/md5.h>
 
 #include <cefore/cef_client.h>
 #include <cefore/cef_csmgr.h>
@@ -59,26 +59,33 @@
 #include <cefore/cef_hash.h>
 #include <cefore/cef_mem_cache.h>
 
+#include <cefore/cef_mpool.h>
+
 /****************************************************************************************
  Macros
  ****************************************************************************************/
 #ifndef CefC_MACOS
 #define ANA_DEAD_LOCK //@@@@@@@@@@
 #ifdef ANA_DEAD_LOCK //@@@@@+++++ ANA DEAD LOCK
-static int xpthread_mutex_lock (const char* pname, int pline, pthread_mutex_t *mutex)
+static int xpthread_rwlock_lock (const char* pname, int pline, pthread_rwlock_t *rwlock, int wr_f)
 {
 	struct timespec to;
 	int err;
 	to.tv_sec = time(NULL) + 600;
 	to.tv_nsec = 0;
-	err = pthread_mutex_timedlock(mutex, &to);
+	if (wr_f) {
+		err = pthread_rwlock_timedwrlock(rwlock, &to);
+	} else {
+		err = pthread_rwlock_timedrdlock(rwlock, &to);
+	}
 	if (err != 0) {
     	fprintf(stderr, "[%s(%d)]: ------ DETECT DEAD LOCK: %s -----\n", pname, pline, strerror(err));
 		exit (1);
 	}
 	return (0);
 }
-#define pthread_mutex_lock(a) xpthread_mutex_lock(__FUNCTION__, __LINE__, a)
+#define pthread_rwlock_wrlock(a) xpthread_rwlock_lock(__FUNCTION__, __LINE__, a, 1)
+#define pthread_rwlock_rdlock(a) xpthread_rwlock_lock(__FUNCTION__, __LINE__, a, 0)
 #endif //@@@@@+++++ ANA DEAD LOCK
 #endif //CefC_MACOS
 
@@ -86,40 +93,35 @@ static int xpthread_mutex_lock (const char* pname, int pline, pthread_mutex_t *m
 #define Cef_Mstat_HashTbl_Size				1009
 #define Cef_Mstat_Delete_Cob_AtOnce			1000
 
+#define Cef_Mem_Shard_Num					16		/* Number of the shards of the cache	*/
+#define Cef_Mem_Class_Num					10		/* Number of the size classes			*/
+#define Cef_Mem_Class_Min					256		/* Block size of the smallest class		*/
+#define Cef_Mem_Slab_Size					1048576	/* Bytes allocated for a class at once	*/
+#define Cef_Mem_Wheel_Tick					1000000	/* Granularity of the expiry wheel (us)	*/
+#define Cef_Mem_Wheel_Slot_Num				1024	/* Number of slots of the expiry wheel	*/
+#define Cef_Mem_Reap_Batch					256		/* Entries freed while holding the lock	*/
+
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
 
-/*** listing content entries for FIFO ***/
-typedef struct _FifoT_Entry {
-	unsigned char* 			key;
-	unsigned char* 			ver;
-	int 					key_len;
-	int 					ver_len;
-    int             		valid;
-	struct _FifoT_Entry*	before;
- 	struct _FifoT_Entry*	next;
-} FifoT_Entry;
-
 /*** content entries for memory cache ***/
-typedef struct CefT_Mem_Hash_Cell {
-
-	uint32_t 						hash;
-	unsigned char* 					key;
-	uint32_t 						klen;
-	CefMemCacheT_Content_Mem_Entry*
-								elem;
-	struct CefT_Mem_Hash_Cell		*next;
-} CefT_Mem_Hash_Cell;
-
-/*** management entries for caching hash table ***/
-typedef struct CefT_Mem_Hash {
-	CefT_Mem_Hash_Cell**	tbl;
-	uint32_t 				tabl_max;
-	uint32_t 				elem_max;
-	uint32_t 				elem_num;
-
-} CefT_Mem_Hash;
+/* An entry is kept in one block of the size class, which is followed by the key 	*/
+/* (name with the chunk number), the version and the message of the Cob. 			*/
+typedef struct CefT_Mem_Entry {
+
+	CefMemCacheT_Content_Mem_Entry	cob;		/* msg, name and version point to the	*/
+												/* area following this structure		*/
+	uint32_t 						hash;		/* hash value of the key				*/
+	uint16_t 						klen;		/* length of the key					*/
+	uint8_t 						cls;		/* size class of the block				*/
+	struct CefT_Mem_Entry*			next;		/* next entry in the bucket				*/
+	struct CefT_Mem_Entry*			fifo_prev;	/* older entry in the shard				*/
+	struct CefT_Mem_Entry*			fifo_next;	/* newer entry in the shard				*/
+	uint64_t 						expire_us;	/* earlier of cache_time and expiry		*/
+	struct CefT_Mem_Entry*			tw_next;	/* next entry in the wheel slot			*/
+	struct CefT_Mem_Entry**			tw_pprev;	/* link which points to this entry		*/
+} CefT_Mem_Entry;
 
 typedef struct CefT_Mem_Hash_Stat {
 	unsigned char* 				contents_name;		/* Name of Contents					*/
@@ -135,6 +137,25 @@ typedef struct CefT_Mem_Hash_Stat {
 	struct CefT_Mem_Hash_Stat*	next;
 } CefT_Mem_Hash_Stat;
 
+/*** shard of memory cache ***/
+/* The shard is selected with the hash of the name with the chunk number. The lock	*/
+/* of a shard is always taken before the lock of the stat.							*/
+typedef struct CefT_Mem_Shard {
+	pthread_rwlock_t 		lock;				/* readers share the shard				*/
+	CefT_Mem_Entry**		tbl;				/* hash table							*/
+	uint32_t 				tabl_max;
+	uint32_t 				elem_num;
+	uint32_t 				elem_max;
+	uint64_t 				byte_num;			/* bytes of the blocks in use			*/
+	uint64_t 				byte_max;
+	CefT_Mem_Entry*			fifo_head;			/* oldest entry							*/
+	CefT_Mem_Entry*			fifo_tail;			/* newest entry							*/
+	uint64_t 				cur_tick;			/* tick which the wheel has reached		*/
+	CefT_Mem_Entry*			expired;			/* entries waiting to be freed			*/
+	CefT_Mem_Entry*			wheel[Cef_Mem_Wheel_Slot_Num];
+												/* entries by the tick of the expiry	*/
+} CefT_Mem_Shard;
+
 typedef struct CefT_Mem_Hash_Stat_Del {
 	unsigned char				cname[CefC_Max_Length];
 	uint32_t 					cname_len;
@@ -149,29 +170,15 @@ typedef struct CefT_Mem_Hash_Stat_Del {
  State Variables
  ****************************************************************************************/
 
-static int cache_cap = 0;					/* Maximum number of entries that can be 	*/
-											/* listed (it is the same value as the 		*/
-											/* maximum value of the cache table) 		*/
-
-/* pointers of functions which stores and removes the content entry into/from the cache */
-/* table (implementation of the functions are in a plugin which uses this library) 		*/
-
-static int              fifo_hand;          /* position of hand                         */
-static int              cache_count;        /* number of cache entries                  */
-FifoT_Entry*			cache_entry_head;
-FifoT_Entry*			cache_entry_tail;
-static CefT_Hash_Handle lookup_table;       /* hash-table to look-up cache entries      */
-static int              count;              /* the number of entries in lookup table    */
+static CefT_Mem_Shard*			mem_shards = NULL;		/* shards of the cache			*/
+static CefT_Mp_Handle			mem_slabs[Cef_Mem_Class_Num];
+														/* blocks of each size class	*/
 
-static CefT_Mem_Hash* 			mem_hash_tbl = NULL;	/* caching hash table			*/
-static uint32_t 				mem_tabl_max;			/* max size 					*/
-														/* of caching hash table		*/
-
-static pthread_mutex_t 			cef_mem_cs_mutex = PTHREAD_MUTEX_INITIALIZER;
-
-static int	cache_cs_expire_check_stat = 0;
+static int	cache_reap_req_f = 0;					/* set when an expired Cob is hit	*/
 
 static CefT_Mem_Hash_Stat*		mstat_tbl[Cef_Mstat_HashTbl_Size];
+static pthread_rwlock_t			mstat_lock = PTHREAD_RWLOCK_INITIALIZER;
+
 static int				delete_pipe_fd[2];
 static pthread_t		cef_mem_cache_delete_th;
 
@@ -179,63 +186,21 @@ static pthread_t		cef_mem_cache_delete_th;
  Static Function Declaration
  ****************************************************************************************/
 
-/*--------------------------------------------------------------------------------------
-	FIFO Functions
-----------------------------------------------------------------------------------------*/
-static int
-cef_mem_cache_fifo_init (
-		uint32_t		capacity
-);
-static void
-cef_mem_cache_fifo_destroy (
-	void
-);
-static void
-cef_mem_cache_fifo_insert (
-	CefMemCacheT_Content_Entry* entry
-);
-static void
-cef_mem_cache_fifo_erase (
-	unsigned char* key,
-	int key_len
-);
-static void
-cef_mem_cache_fifo_store_entry(
-	CefMemCacheT_Content_Entry* entry
-);
-static void
-cef_mem_cache_fifo_remove_entry(
-	FifoT_Entry*   entry,
-	int is_removed
-);
-static FifoT_Entry*
-cef_mem_cache_fifo_cache_entry_enqueue(
-	unsigned char* key,
-	int key_len,
-	unsigned char* ver,
-	uint16_t ver_len
-);
-static void
-cef_mem_cache_fifo_cache_entry_dequeue(
-	FifoT_Entry* p
-);
-
-
 /*--------------------------------------------------------------------------------------
 	Memory Cache Functions
 ----------------------------------------------------------------------------------------*/
 static int
 cef_mem_cache_cs_create (
-		uint32_t		capacity
+	uint32_t		capacity,
+	uint64_t		mem_size
 );
 static int
 cef_mem_cache_cs_store (
-	CefMemCacheT_Content_Entry* new_entry
-);
-static void
-cef_mem_cache_cs_remove (
-	unsigned char* key,
-	int key_len
+	CefT_Mem_Shard* sp,
+	CefMemCacheT_Content_Entry* cob,
+	const unsigned char* key,
+	uint16_t klen,
+	uint32_t hash
 );
 static void
 cef_mem_cache_cs_destroy (
@@ -247,48 +212,55 @@ cef_mem_cache_cs_expire_check (
 );
 static int
 cef_mem_cache_cob_write (
-	CefMemCacheT_Content_Entry* cob
+	CefT_Mem_Shard* sp,
+	CefMemCacheT_Content_Entry* cob,
+	unsigned char* trg_key,
+	int trg_key_len,
+	uint32_t hash
 );
 /*--------------------------------------------------------------------------------------
 	Hash Functions
 ----------------------------------------------------------------------------------------*/
-static CefT_Mem_Hash*
-cef_mem_hash_tbl_create (
-	uint32_t capacity
-);
 static uint32_t
 cef_mem_hash_number_create (
 	const unsigned char* key,
 	uint32_t klen
 );
-static int
-cef_mem_cache_hash_tbl_item_set (
+static CefT_Mem_Shard*
+cef_mem_cache_shard_get (
+	uint32_t hash
+);
+static CefT_Mem_Entry*
+cef_mem_cache_entry_lookup (
+	CefT_Mem_Shard* sp,
 	const unsigned char* key,
 	uint32_t klen,
-	CefMemCacheT_Content_Mem_Entry* elem,
-	CefMemCacheT_Content_Mem_Entry** old_elem
+	uint32_t hash
 );
-static CefMemCacheT_Content_Mem_Entry*
-cef_mem_cache_hash_tbl_item_get (
-	const unsigned char* key,
-	uint32_t klen
+static void
+cef_mem_cache_entry_insert (
+	CefT_Mem_Shard* sp,
+	CefT_Mem_Entry* ep
 );
-static CefMemCacheT_Content_Mem_Entry*
-cef_mem_cache_hash_tbl_item_remove (
-	const unsigned char* key,
-	uint32_t klen
+static void
+cef_mem_cache_entry_free (
+	CefT_Mem_Shard* sp,
+	CefT_Mem_Entry* ep,
+	int stat_f
 );
-static CefMemCacheT_Content_Mem_Entry*
-cef_mem_cache_hash_tbl_item_remove_version (
-	const unsigned char* key,
-	uint32_t klen,
-	unsigned char* ver,
-	uint16_t vlen
+static void
+cef_mem_cache_entry_expiry_set (
+	CefT_Mem_Shard* sp,
+	CefT_Mem_Entry* ep
 );
-int
-cef_mem_cache_key_create_by_Mem_Entry (
-	CefMemCacheT_Content_Mem_Entry* entry,
-	unsigned char* key
+static void
+cef_mem_cache_entry_expiry_unlink (
+	CefT_Mem_Entry* ep
+);
+static int
+cef_mem_cache_shard_reap (
+	CefT_Mem_Shard* sp,
+	uint64_t nowt
 );
 static int
 cef_mem_cache_key_create (
@@ -306,15 +278,15 @@ cef_mem_cache_name_chunknum_concatenate (
 	uint32_t chunknum,
 	unsigned char* key
 );
+static uint32_t
+cef_mem_cache_prime_get (
+	uint64_t n
+);
 
 /*--------------------------------------------------------------------------------------
 	Stat Functions
 ----------------------------------------------------------------------------------------*/
 static void
-cef_mem_cache_mstat_init (
-	void
-);
-static void
 cef_mem_cache_mstat_destroy (
 	void
 );
@@ -355,14 +327,6 @@ cef_mem_cache_version_compare (
 	uint16_t vlen2
 );
 
-
-#if 0
-static void
-cef_mem_cache_mstat_print (
-	char* msg
-);
-#endif
-
 /****************************************************************************************
 	Functions
  ****************************************************************************************/
@@ -374,13 +338,17 @@ cef_mem_cache_mstat_print (
 ----------------------------------------------------------------------------------------*/
 int
 cef_mem_cache_init(
-		uint32_t		capacity
+		uint32_t		capacity,
+		uint64_t		mem_size
 ){
 	int rtc;
 	int flags;
 
-	rtc = cef_mem_cache_cs_create (capacity);
-	cef_mem_cache_mstat_init ();
+	rtc = cef_mem_cache_cs_create (capacity, mem_size);
+	if (rtc < 0) {
+		cef_mem_cache_cs_destroy();
+		return (-1);
+	}
 
 	/* Create delete thread */
 	delete_pipe_fd[0] = -1;
@@ -388,7 +356,6 @@ cef_mem_cache_init(
 
 	if (socketpair(AF_UNIX,SOCK_DGRAM, 0, delete_pipe_fd) == -1 ) {
 		cef_mem_cache_cs_destroy();
-		cef_mem_cache_mstat_destroy();
 		cef_log_write (CefC_Log_Error, "%s pair socket creation error (%s)\n"
 						, __func__, strerror(errno));
 		return (-1);
@@ -396,7 +363,6 @@ cef_mem_cache_init(
 	/* Set caller side socket as non-blocking I/O */
 	if ((flags = fcntl(delete_pipe_fd[0], F_GETFL, 0) ) < 0) {
 		cef_mem_cache_cs_destroy();
-		cef_mem_cache_mstat_destroy();
 		cef_log_write (CefC_Log_Error, "%s fcntl error (%s)\n"
 						, __func__, strerror(errno));
 		return (-1);
@@ -404,7 +370,6 @@ cef_mem_cache_init(
 	flags |= O_NONBLOCK;
 	if (fcntl(delete_pipe_fd[0], F_SETFL, flags) < 0) {
 		cef_mem_cache_cs_destroy();
-		cef_mem_cache_mstat_destroy();
 		cef_log_write (CefC_Log_Error, "%s fcntl error (%s)\n"
 						, __func__, strerror(errno));
 		return (-1);
@@ -413,7 +378,6 @@ cef_mem_cache_init(
 	if (pthread_create(&cef_mem_cache_delete_th, NULL
 					, &cef_mem_cache_delete_thread, &(delete_pipe_fd[1])) == -1) {
 		cef_mem_cache_cs_destroy();
-		cef_mem_cache_mstat_destroy();
 		cef_log_write (CefC_Log_Error
 						, "%s Failed to create the new thread(cef_mem_cache_delete_thread)\n"
 						, __func__);
@@ -432,7 +396,6 @@ cef_mem_cache_put_thread (
 	int 						read_fd;
 	CefMemCacheT_Content_Entry*	entry;
 	struct pollfd 				fds[1];
-	unsigned char				msg[CefC_Max_Length];
 	int							msg_len;
 	struct fixed_hdr* 			chp;
 	uint16_t					pkt_len;
@@ -449,6 +412,14 @@ cef_mem_cache_put_thread (
 	pthread_t self_thread = pthread_self();
 	pthread_detach(self_thread);
 
+	/* The entry is reused for all Cobs. The version points to the message. 	*/
+	entry = (CefMemCacheT_Content_Entry*)malloc (sizeof (CefMemCacheT_Content_Entry));
+	if (entry == NULL) {
+		cef_log_write (CefC_Log_Error, "%s (malloc)\n", __func__);
+		pthread_exit (NULL);
+		return 0;
+	}
+
 	memset(&fds, 0, sizeof(fds));
 	fds[0].fd = read_fd;
 	fds[0].events = POLLIN | POLLERR;
@@ -457,29 +428,26 @@ cef_mem_cache_put_thread (
 	    poll(fds, 1, 1);
 	    if (fds[0].revents & POLLIN) {
 
-			if((msg_len = read(read_fd, msg, sizeof(msg))) < 1){
+			if((msg_len = read(read_fd, entry->msg, sizeof(entry->msg))) < 1){
 				continue;
 			}
-			chp = (struct fixed_hdr*) msg;
+			chp = (struct fixed_hdr*) entry->msg;
 			pkt_len = ntohs (chp->pkt_len);
 			hdr_len = chp->hdr_len;
 			payload_len = pkt_len - hdr_len;
 			header_len 	= hdr_len;
 			res = cef_frame_message_parse (
-							msg, payload_len, header_len, &poh, &pm, CefC_PT_OBJECT);
+							entry->msg, payload_len, header_len, &poh, &pm, CefC_PT_OBJECT);
 
 			if (res < 0) {
 				continue;
 			}
 			chunk_field_len = CefC_S_Type + CefC_S_Length + CefC_S_ChunkNum;
-			entry = (CefMemCacheT_Content_Entry*)malloc (sizeof (CefMemCacheT_Content_Entry));
-			memcpy (entry->msg, msg, msg_len);
 			entry->msg_len = msg_len;
 			if (pm.chunk_num_f) {
 				memcpy (entry->name, pm.name, pm.name_len - chunk_field_len);
 				entry->name_len = pm.name_len - chunk_field_len;
 			} else {
-				free (entry);
 				continue;
 			}
 			entry->pay_len = pm.payload_len;
@@ -487,24 +455,17 @@ cef_mem_cache_put_thread (
 			entry->cache_time = poh.cachetime;
 			entry->expiry = pm.expiry;
 			/* entry->node does not care */
-			if (pm.org.version_f) {
+			if ((pm.org.version_f) && (pm.org.version_len)) {
 				entry->ver_len = pm.org.version_len;
-				if (pm.org.version_len) {
-					entry->version = (unsigned char*) malloc (pm.org.version_len);
-					memcpy (entry->version, pm.org.version_val, pm.org.version_len);
-				} else {
-					entry->version = NULL;
-				}
+				entry->version = pm.org.version_val;
 			} else {
 				entry->ver_len = 0;
 				entry->version = NULL;
 			}
 			cef_mem_cache_item_set (entry);
-			if (entry->ver_len > 0)
-				free (entry->version);
-			free (entry);
 	    }
 	}
+	free (entry);
 	pthread_exit (NULL);
 	return 0;
 }
@@ -532,16 +493,14 @@ cef_mem_cache_clear_thread (
 	while (1) {
 		sleep(1);
 		nowt = cef_client_present_timeus_calc ();
-		/* Checks content expire 			*/
-		if ((interval != 0) && (nowt > expire_check_time)) {
+		/* Checks content expire when the interval has passed or an expired 	*/
+		/* Cob has been hit 													*/
+		if (((interval != 0) && (nowt > expire_check_time)) ||
+			(__atomic_exchange_n (&cache_reap_req_f, 0, __ATOMIC_ACQ_REL))) {
 #ifdef CefC_Debug
 			cef_dbg_write (CefC_Dbg_Fine, "Checks for expired contents.\n");
 #endif // CefC_Debug
-			if (cache_cs_expire_check_stat == 0){
-				cache_cs_expire_check_stat = 1;
-				cef_mem_cache_cs_expire_check ();
-				cache_cs_expire_check_stat = 0;
-			}
+			cef_mem_cache_cs_expire_check ();
 			/* set interval */
 			expire_check_time = nowt + interval;
 		}
@@ -566,6 +525,8 @@ cef_mem_cache_delete_thread (
 	int							del_seq;
 	unsigned char 				key[CefMemCacheC_Key_Max];
 	int 						key_len;
+	uint32_t					hash;
+	CefT_Mem_Shard*				sp;
 
 	read_fd = *(int *)p;
 
@@ -604,61 +565,38 @@ cef_mem_cache_delete_thread (
 }
 #endif // CefC_Debug
 
-			pthread_mutex_lock (&cef_mem_cs_mutex);
 			for (; del_seq <= max_seq; del_seq++) {
-				CefMemCacheT_Content_Mem_Entry* entry;
+				CefT_Mem_Entry* entry;
 
 				if (del_count >= Cef_Mstat_Delete_Cob_AtOnce) {
 					del_count = 0;
-					pthread_mutex_unlock (&cef_mem_cs_mutex);
 					usleep (50);
-					pthread_mutex_lock (&cef_mem_cs_mutex);
 				}
 
 				key_len = cef_mem_cache_name_chunknum_concatenate (
 							mstat_p->cname, mstat_p->cname_len, del_seq, key);
+				hash = cef_mem_hash_number_create (key, key_len);
+				sp = cef_mem_cache_shard_get (hash);
+
 				/* Delete from CS */
-				entry = cef_mem_cache_hash_tbl_item_remove_version (
-							key, key_len, mstat_p->cver, mstat_p->cver_len);
-				if (entry != NULL) {
-					free (entry->msg);
-					free (entry->name);
-					if (entry->ver_len)
-						free (entry->version);
-					free (entry);
-					/* Delete from FIFO queue */
-					cef_lhash_tbl_item_remove(lookup_table, key, key_len);
-					count--;
+				pthread_rwlock_wrlock (&sp->lock);
+				entry = cef_mem_cache_entry_lookup (sp, key, key_len, hash);
+				if ((entry != NULL) &&
+					(entry->cob.ver_len == mstat_p->cver_len) &&
+					(memcmp (entry->cob.version, mstat_p->cver, mstat_p->cver_len) == 0)) {
+					/* The stat of the old version has been taken out 	*/
+					cef_mem_cache_entry_free (sp, entry, 0);
 				}
+				pthread_rwlock_unlock (&sp->lock);
 
 				del_count++;
 			}
-			pthread_mutex_unlock (&cef_mem_cs_mutex);
 		}
 	}
 
 	pthread_exit (NULL);
 	return 0;
 }
-/*--------------------------------------------------------------------------------------
-	Thread to clear expirly content object of memory cache by demand
-----------------------------------------------------------------------------------------*/
-void *
-cef_mem_cache_clear_demand_thread (
-	void *p
-){
-	pthread_t self_thread = pthread_self();
-	pthread_detach(self_thread);
-
-	if (cache_cs_expire_check_stat == 0){
-		cache_cs_expire_check_stat = 1;
-		cef_mem_cache_cs_expire_check ();
-		cache_cs_expire_check_stat = 0;
-	}
-
-	pthread_exit (NULL);
-	return 0;
-}
 /*--------------------------------------------------------------------------------------
 	set the cob to memry cache
 ----------------------------------------------------------------------------------------*/
@@ -666,53 +604,98 @@ int									/* The return value is negative if an error occurs	*/
 cef_mem_cache_item_set (
 	CefMemCacheT_Content_Entry* entry
 ) {
-	pthread_mutex_lock (&cef_mem_cs_mutex);
-	cef_mem_cache_cob_write (entry);
-	pthread_mutex_unlock (&cef_mem_cs_mutex);
-	return (0);
+	CefT_Mem_Shard* sp;
+	unsigned char 	trg_key[CefMemCacheC_Key_Max];
+	int 			trg_key_len;
+	uint32_t 		hash;
+	int 			rtc;
+
+	if (entry->name_len + 8 > CefMemCacheC_Key_Max) {
+		return (-1);
+	}
+	trg_key_len = cef_mem_cache_key_create (entry, trg_key);
+	hash = cef_mem_hash_number_create (trg_key, trg_key_len);
+	sp = cef_mem_cache_shard_get (hash);
+
+	pthread_rwlock_wrlock (&sp->lock);
+	rtc = cef_mem_cache_cob_write (sp, entry, trg_key, trg_key_len, hash);
+	pthread_rwlock_unlock (&sp->lock);
+	return (rtc);
 }
 /*--------------------------------------------------------------------------------------
 	Function to read a ContentObject from memory cache
 ----------------------------------------------------------------------------------------*/
-CefMemCacheT_Content_Mem_Entry*
+int									/* Length of the Cob, or -1 if it is not cached		*/
 cef_mem_cache_item_get (
 	unsigned char* trg_key,						/* content name							*/
-	uint16_t trg_key_len						/* content name Length					*/
+	uint16_t trg_key_len,						/* content name Length					*/
+	int ver_f,									/* 1 to match the version				*/
+	unsigned char* ver,							/* version								*/
+	uint16_t ver_len,							/* version length						*/
+	unsigned char* buff							/* buffer to copy the Cob, or NULL		*/
+) {
+	return (cef_mem_cache_item_get_hashv (
+				trg_key, trg_key_len, cef_mem_hash_number_create (trg_key, trg_key_len),
+				ver_f, ver, ver_len, buff));
+}
+/*--------------------------------------------------------------------------------------
+	Same as cef_mem_cache_item_get, with the hash value of the content name
+	calculated with CefC_Hash_Seed_Default
+----------------------------------------------------------------------------------------*/
+int									/* Length of the Cob, or -1 if it is not cached		*/
+cef_mem_cache_item_get_hashv (
+	unsigned char* trg_key,						/* content name							*/
+	uint16_t trg_key_len,						/* content name Length					*/
+	uint32_t hash,								/* hash value of the content name		*/
+	int ver_f,									/* 1 to match the version				*/
+	unsigned char* ver,							/* version								*/
+	uint16_t ver_len,							/* version length						*/
+	unsigned char* buff							/* buffer to copy the Cob, or NULL		*/
 ) {
-	CefMemCacheT_Content_Mem_Entry* entry;
+	CefT_Mem_Shard* sp;
+	CefT_Mem_Entry* entry;
 	uint64_t 		nowt;
 	struct timeval 	tv;
+	int				msg_len = -1;
+
+	if ((trg_key_len > CefMemCacheC_Key_Max) || (mem_shards == NULL)) {
+		return (-1);
+	}
+	sp = cef_mem_cache_shard_get (hash);
 
 	/* Access the specified entry 	*/
-	pthread_mutex_lock (&cef_mem_cs_mutex);
-	entry = cef_mem_cache_hash_tbl_item_get (trg_key, trg_key_len);
+	pthread_rwlock_rdlock (&sp->lock);
+	entry = cef_mem_cache_entry_lookup (sp, trg_key, trg_key_len, hash);
 
 	if (entry) {
 
 		gettimeofday (&tv, NULL);
 		nowt = tv.tv_sec * 1000000llu + tv.tv_usec;
 
-		if (((entry->expiry == 0) || (nowt < entry->expiry)) &&
-			(nowt < entry->cache_time)) {
-			pthread_mutex_unlock (&cef_mem_cs_mutex);
-			cef_mem_cache_mstat_ac_cnt_inc (trg_key, trg_key_len, entry->version, entry->ver_len);
-			return (entry);
- 		}
-		else {
-			pthread_mutex_unlock (&cef_mem_cs_mutex);
-			{
-				pthread_t th;
-				if (pthread_create (&th, NULL, cef_mem_cache_clear_demand_thread, NULL) == -1) {
-					cef_log_write (CefC_Log_Error, "Failed to create the new thread\n");
+		if (((entry->cob.expiry == 0) || (nowt < entry->cob.expiry)) &&
+			(nowt < entry->cob.cache_time)) {
+			if ((ver_f == 0) ||
+				((entry->cob.ver_len == ver_len) &&
+				 (memcmp (entry->cob.version, ver, ver_len) == 0))) {
+				/* The Cob is copied, since the entry may be removed once the 	*/
+				/* lock is released.											*/
+				if (buff) {
+					memcpy (buff, entry->cob.msg, entry->cob.msg_len);
 				}
+				msg_len = entry->cob.msg_len;
+				cef_mem_cache_mstat_ac_cnt_inc (
+					trg_key, trg_key_len, entry->cob.version, entry->cob.ver_len);
 			}
-			return (0);
+ 		}
+		else {
+			/* The entry is freed by the clear thread 	*/
+			__atomic_store_n (&cache_reap_req_f, 1, __ATOMIC_RELEASE);
 		}
 	}
 
-	pthread_mutex_unlock (&cef_mem_cs_mutex);
+	pthread_rwlock_unlock (&sp->lock);
 
-	return (0);
+	return (msg_len);
 }
 /*--------------------------------------------------------------------------------------
 	Destroy memory cache resources
@@ -721,220 +704,65 @@ void
 cef_mem_cache_destroy (
 	void
 ) {
-pthread_mutex_lock (&cef_mem_cs_mutex);
-	cef_mem_cache_fifo_destroy ();
 	cef_mem_cache_cs_destroy ();
-pthread_mutex_unlock (&cef_mem_cs_mutex);
-	pthread_mutex_destroy (&cef_mem_cs_mutex);
-
-	cef_mem_cache_mstat_destroy ();
 }
 
 /****************************************************************************************
-	FIFO Functions
+	Memory Cache Functions
  ****************************************************************************************/
 /*--------------------------------------------------------------------------------------
 	Init API
 ----------------------------------------------------------------------------------------*/
-static int 							/* If the error occurs, this value is a negative value	*/
-cef_mem_cache_fifo_init (
-		uint32_t		capacity
+static int							/* The return value is negative if an error occurs	*/
+cef_mem_cache_cs_create (
+	uint32_t		capacity,
+	uint64_t		mem_size
 ) {
-    fifo_hand = 0;
-    cache_count = 0;
-	/* Records the capacity of cache		*/
-	if (capacity < 1) {
-		fprintf (stderr, "[FIFO] Invalid Cacacity\n");
-		return (-1);
-	}
-	cache_cap = capacity;
+	CefT_Mem_Shard* sp;
+	char 			key[32];
+	size_t 			size;
+	int 			i;
 
-	/* Initialize FIFO list management unit */
-	cache_entry_head = (FifoT_Entry*)NULL;
-	cache_entry_tail = (FifoT_Entry*)NULL;
-
-    /* Creates lookup table */
-    lookup_table = cef_lhash_tbl_create_u32_ext(capacity, CefC_Hash_Coef_Cache);
-	if(lookup_table == (CefT_Hash_Handle)NULL){
+	if ((capacity < 1) || (mem_size < 1)) {
+		cef_log_write (CefC_Log_Error, "Invalid local cache capacity\n");
 		return (-1);
 	}
-    count = 0;
 
-	return (0);
-}
-
-/*--------------------------------------------------------------------------------------
-	Destroy API
-----------------------------------------------------------------------------------------*/
-static void
-cef_mem_cache_fifo_destroy (
-	void
-) {
-    fifo_hand = 0;
-    cache_count = 0;
-	cache_cap 		= 0;
-	{
-		FifoT_Entry* p;
-		FifoT_Entry* np;
-		p = cache_entry_head;
-		while (p != (FifoT_Entry*)NULL){
-			np = p->next;
-			free(p);
-			p = np;
+	/* Creates the blocks of each size class	*/
+	for (i = 0 ; i < Cef_Mem_Class_Num ; i++) {
+		size = (size_t) Cef_Mem_Class_Min << i;
+		sprintf (key, "CefMemCache%d", (int) size);
+		mem_slabs[i] = cef_mpool_init (key, size,
+			(size < Cef_Mem_Slab_Size) ? (int)(Cef_Mem_Slab_Size / size) : 1);
+		if (mem_slabs[i] == 0) {
+			cef_log_write (CefC_Log_Error, "create mem cache blocks\n");
+			return (-1);
 		}
-		cache_entry_head = (FifoT_Entry*)NULL;
-		cache_entry_tail = (FifoT_Entry*)NULL;
-	}
-    cef_lhash_tbl_destroy(lookup_table);
-    count = 0;
-}
-
-/*--------------------------------------------------------------------------------------
-	Insert API
-----------------------------------------------------------------------------------------*/
-static void
-cef_mem_cache_fifo_insert (
-	CefMemCacheT_Content_Entry* entry	/* content entry 							*/
-) {
-    if (cache_count == cache_cap) {
-        /* when cache is full, replace entry */
-    	cef_mem_cache_fifo_remove_entry(cache_entry_head, 0);
-    }
-    cef_mem_cache_fifo_store_entry(entry);
-}
-
-/*--------------------------------------------------------------------------------------
-	Erase API
-----------------------------------------------------------------------------------------*/
-static void
-cef_mem_cache_fifo_erase (
-	unsigned char* key, 					/* key of content entry removed from cache 	*/
-											/* table									*/
-	int key_len								/* length of the key 						*/
-) {
-
-	FifoT_Entry*	del_entry;
-	void* val = cef_lhash_tbl_item_get(lookup_table, key, key_len);
-    if (val == NULL) {
-        fprintf(stderr, "[FIFO] failed to erace\n");
-        return;
-    }
-	del_entry = (FifoT_Entry*) val;
-    cef_mem_cache_fifo_remove_entry(del_entry, 1);
-}
-/*--------------------------------------------------------------------------------------
-	MISC. Functions
-----------------------------------------------------------------------------------------*/
-static void
-cef_mem_cache_fifo_store_entry(
-	CefMemCacheT_Content_Entry* entry
-) {
-    unsigned char 	key[CefMemCacheC_Key_Max];
-    int 			key_len;
-    FifoT_Entry*   	rsentry;
-
-
-    key_len = cef_mem_cache_name_chunknum_concatenate (
-                    entry->name, entry->name_len, entry->chunk_num, key);
-	rsentry = cef_mem_cache_fifo_cache_entry_enqueue(key, key_len, entry->version, entry->ver_len);
-
-	if (rsentry == (FifoT_Entry*) NULL){
-		return;
-	}
-    cef_lhash_tbl_item_set(lookup_table, rsentry->key, rsentry->key_len
-    	, (void*)rsentry);
-    count++;
-    cef_mem_cache_cs_store(entry);
-    cache_count++;
-}
-/*-----*/
-static void
-cef_mem_cache_fifo_remove_entry(
-	FifoT_Entry*   entry,
-    int is_removed
-) {
-    FifoT_Entry* rsentry;
-    rsentry = entry;
-    cef_lhash_tbl_item_remove(lookup_table, rsentry->key, rsentry->key_len);
-    count--;
-
-    if (!is_removed) cef_mem_cache_cs_remove(rsentry->key, rsentry->key_len);
-	cef_mem_cache_fifo_cache_entry_dequeue(rsentry);
-
-	cache_count--;
-
-}
-
-static FifoT_Entry*
-cef_mem_cache_fifo_cache_entry_enqueue(unsigned char* key, int key_len, unsigned char* ver, uint16_t ver_len) {
-
-	FifoT_Entry*	q;
-	q = (FifoT_Entry*) calloc(1, sizeof(FifoT_Entry) + key_len + ver_len);
-	if(q == (FifoT_Entry*) NULL){
-		return ((FifoT_Entry*) NULL);
-	}
-	q->key = ((unsigned char*) q) + sizeof(FifoT_Entry);
-	memcpy (q->key, key, key_len);
-	q->key_len = key_len;
-	q->ver = ((unsigned char*) q) + sizeof(FifoT_Entry) + key_len;
-	memcpy (q->ver, ver, ver_len);
-	q->ver_len = ver_len;
-	if(cache_entry_tail == (FifoT_Entry*)NULL){
-		cache_entry_head = q;
-		cache_entry_tail = q;
-	} else {
-		cache_entry_tail->next = q;
-		q->before = cache_entry_tail;
-		cache_entry_tail = q;
 	}
-  	return(q);
-}
 
-static void
-cef_mem_cache_fifo_cache_entry_dequeue(FifoT_Entry* p){
-
-	 if(p->before == (FifoT_Entry*)NULL && p->next != (FifoT_Entry*)NULL){
-	 	cache_entry_head = p->next;
-	 	p->next->before = (FifoT_Entry*)NULL;
-	 } else
-	 if(p->before == (FifoT_Entry*)NULL && p->next == (FifoT_Entry*)NULL){
-	 	cache_entry_head = (FifoT_Entry*)NULL;
-	 	cache_entry_tail = (FifoT_Entry*)NULL;
-	 } else
-	 if(p->before != (FifoT_Entry*)NULL && p->next != (FifoT_Entry*)NULL){
-	    p->before->next = p->next;
-	    p->next->before = p->before;
-	 } else
-	 if(p->before != (FifoT_Entry*)NULL && p->next == (FifoT_Entry*)NULL){
-	    p->before->next = p->next;
-	 	cache_entry_tail = p->before;
-	 }
-	free (p);
-}
-
-/****************************************************************************************
-	Memory Cache Functions
- ****************************************************************************************/
-/*--------------------------------------------------------------------------------------
-	Init API
-----------------------------------------------------------------------------------------*/
-static int							/* The return value is negative if an error occurs	*/
-cef_mem_cache_cs_create (
-		uint32_t		capacity
-) {
-
-	/* Creates the memory cache 		*/
-	mem_hash_tbl = cef_mem_hash_tbl_create (capacity);
-	if (mem_hash_tbl ==  NULL) {
-		cef_log_write (CefC_Log_Error, "create mem hash table\n");
+	/* Creates the shards 		*/
+	mem_shards = (CefT_Mem_Shard*) calloc (Cef_Mem_Shard_Num, sizeof (CefT_Mem_Shard));
+	if (mem_shards == NULL) {
+		cef_log_write (CefC_Log_Error, "create mem cache shards\n");
 		return (-1);
 	}
-	if (cef_mem_cache_fifo_init (capacity) == -1) {
-		cef_log_write (CefC_Log_Error, "create fifo cache\n");
-		return (-1);
+	for (i = 0 ; i < Cef_Mem_Shard_Num ; i++) {
+		sp = &mem_shards[i];
+		pthread_rwlock_init (&sp->lock, NULL);
+		sp->elem_max = capacity / Cef_Mem_Shard_Num + 1;
+		sp->byte_max = mem_size / Cef_Mem_Shard_Num;
+		sp->tabl_max = cef_mem_cache_prime_get (
+						(uint64_t) sp->elem_max * CefC_Hash_Coef_Cache);
+		sp->tbl = (CefT_Mem_Entry**) calloc (sp->tabl_max, sizeof (CefT_Mem_Entry*));
+		if (sp->tbl == NULL) {
+			cef_log_write (CefC_Log_Error, "create mem hash table\n");
+			return (-1);
+		}
+		sp->cur_tick = cef_client_present_timeus_calc () / Cef_Mem_Wheel_Tick;
 	}
 
-	cef_log_write (CefC_Log_Info, "Local cache capacity : %u\n", capacity);
+	cef_log_write (CefC_Log_Info, "Local cache capacity : %u Cobs, "FMTU64" MB\n"
+		, capacity, mem_size / 1048576);
 
 	return (0);
 }
@@ -943,108 +771,69 @@ cef_mem_cache_cs_create (
 ----------------------------------------------------------------------------------------*/
 static int
 cef_mem_cache_cs_store (
-	CefMemCacheT_Content_Entry* new_entry
+	CefT_Mem_Shard* sp,
+	CefMemCacheT_Content_Entry* cob,
+	const unsigned char* key,
+	uint16_t klen,
+	uint32_t hash
 ) {
-	CefMemCacheT_Content_Mem_Entry* entry;
-	CefMemCacheT_Content_Mem_Entry* old_entry = NULL;
-	int key_len;
-	unsigned char key[65535];
-
-	/* Creates the key 		*/
-	key_len = cef_mem_cache_key_create (new_entry, key);
-
-	/* Creates the entry 		*/
-	entry =
-		(CefMemCacheT_Content_Mem_Entry*) calloc (1, sizeof (CefMemCacheT_Content_Mem_Entry));
-	if (entry == NULL) {
-		return (-1);
+	CefT_Mem_Entry* entry;
+	size_t 			size;
+	int 			cls;
+
+	/* Selects the size class 		*/
+	size = sizeof (CefT_Mem_Entry) + klen + cob->ver_len + cob->msg_len;
+	for (cls = 0 ; cls < Cef_Mem_Class_Num ; cls++) {
+		if (size <= ((size_t) Cef_Mem_Class_Min << cls)) {
+			break;
+		}
 	}
-	entry->msg =
-		(unsigned char*) calloc (1, new_entry->msg_len);
-	if (entry->msg == NULL) {
-		free (entry);
+	if (cls == Cef_Mem_Class_Num) {
 		return (-1);
 	}
-	entry->name =
-		(unsigned char*) calloc (1, new_entry->name_len);
-	if (entry->name == NULL) {
-		free (entry->msg);
-		free (entry);
-		return (-1);
+	size = (size_t) Cef_Mem_Class_Min << cls;
+
+	/* Removes the oldest entries until the new entry fits 	*/
+	while ((sp->fifo_head != NULL) &&
+		((sp->byte_num + size > sp->byte_max) || (sp->elem_num >= sp->elem_max))) {
+		cef_mem_cache_entry_free (sp, sp->fifo_head, 1);
 	}
-	entry->ver_len = new_entry->ver_len;
-	if (new_entry->ver_len) {
-		entry->version =
-			(unsigned char*) calloc (1, new_entry->ver_len);
-		if (entry->version == NULL) {
-			free (entry->msg);
-			free (entry->name);
-			free (entry);
-			return (-1);
-		}
-		memcpy (entry->version, new_entry->version, new_entry->ver_len);
-	} else {
-		entry->version = NULL;
+	if (sp->byte_num + size > sp->byte_max) {
+		return (-1);
 	}
 
-	/* Inserts the cache entry 		*/
-	memcpy (entry->msg, new_entry->msg, new_entry->msg_len);
-	entry->msg_len		 = new_entry->msg_len;
-	memcpy (entry->name, new_entry->name, new_entry->name_len);
-	entry->name_len		 = new_entry->name_len;
-	entry->pay_len		 = new_entry->pay_len;
-	entry->chunk_num		 = new_entry->chunk_num;
-	entry->cache_time	 = new_entry->cache_time;
-	entry->expiry		 = new_entry->expiry;
-	entry->node			 = new_entry->node;
-
-	if (cef_mem_cache_hash_tbl_item_set (
-		key, key_len, entry, &old_entry) < 0) {
-		free (entry->msg);
-		free (entry->name);
-		if (entry->version != NULL) {
-			free (entry->version);
-		}
-		free (entry);
+	/* Creates the entry 		*/
+	entry = (CefT_Mem_Entry*) cef_mpool_alloc (mem_slabs[cls]);
+	if (entry == NULL) {
 		return (-1);
 	}
-
-
-	if (old_entry) {
-		free (old_entry->msg);
-		free (old_entry->name);
-		if (old_entry->version != NULL) {
-			free (old_entry->version);
-		}
-		free (old_entry);
+	memset (entry, 0, sizeof (CefT_Mem_Entry));
+	entry->hash = hash;
+	entry->klen = klen;
+	entry->cls  = (uint8_t) cls;
+
+	/* Copies the key, version and message behind the entry 	*/
+	entry->cob.name = (unsigned char*) entry + sizeof (CefT_Mem_Entry);
+	memcpy (entry->cob.name, key, klen);
+	entry->cob.name_len = cob->name_len;
+	entry->cob.version = entry->cob.name + klen;
+	entry->cob.ver_len = cob->ver_len;
+	if (cob->ver_len) {
+		memcpy (entry->cob.version, cob->version, cob->ver_len);
 	}
+	entry->cob.msg = entry->cob.version + cob->ver_len;
+	memcpy (entry->cob.msg, cob->msg, cob->msg_len);
+	entry->cob.msg_len		= cob->msg_len;
+	entry->cob.pay_len		= cob->pay_len;
+	entry->cob.chunk_num	= cob->chunk_num;
+	entry->cob.cache_time	= cob->cache_time;
+	entry->cob.expiry		= cob->expiry;
+	entry->cob.node			= cob->node;
 
-	return (0);
-}
-
-/*--------------------------------------------------------------------------------------
-	Remove API
-----------------------------------------------------------------------------------------*/
-static void
-cef_mem_cache_cs_remove (
-	unsigned char* key,
-	int key_len
-) {
-	CefMemCacheT_Content_Mem_Entry* entry;
-
-	/* Removes the specified entry 	*/
-	entry = cef_mem_cache_hash_tbl_item_remove (key, key_len);
-
-	if (entry) {
-		cef_mem_cache_mstat_remove (key, key_len, entry->pay_len);
-		free (entry->msg);
-		free (entry->name);
-		if (entry->ver_len)
-			free (entry->version);
-		free (entry);
-	}
+	/* Inserts the cache entry 		*/
+	cef_mem_cache_entry_insert (sp, entry);
 
-	return;
+	return (0);
 }
 
 /*--------------------------------------------------------------------------------------
@@ -1054,74 +843,60 @@ static void
 cef_mem_cache_cs_destroy (
 	void
 ) {
+	CefT_Mem_Shard* sp;
 	int i;
 
-	if (mem_hash_tbl) {
-		for (i = 0 ; i < mem_hash_tbl->tabl_max ; i++) {
-			CefT_Mem_Hash_Cell* cp;
-			CefT_Mem_Hash_Cell* wcp;
-			cp = mem_hash_tbl->tbl[i];
-			while (cp != NULL) {
-				wcp = cp->next;
-				free (cp->elem);
-				free(cp);
-				cp = wcp;
-			}
+	if (mem_shards) {
+		for (i = 0 ; i < Cef_Mem_Shard_Num ; i++) {
+			sp = &mem_shards[i];
+			/* The blocks are released with the size classes 	*/
+			free (sp->tbl);
+			pthread_rwlock_destroy (&sp->lock);
+		}
+		free (mem_shards);
+		mem_shards = NULL;
+	}
+	cef_mem_cache_mstat_destroy ();
+	for (i = 0 ; i < Cef_Mem_Class_Num ; i++) {
+		if (mem_slabs[i]) {
+			cef_mpool_destroy (mem_slabs[i]);
+			mem_slabs[i] = 0;
 		}
-		free (mem_hash_tbl->tbl);
-		free (mem_hash_tbl);
 	}
 
 	return;
 }
 
 /*--------------------------------------------------------------------------------------
-	Check content expire
+	Check content expire. The lock of a shard is released after each batch.
 ----------------------------------------------------------------------------------------*/
 static void
 cef_mem_cache_cs_expire_check (
 	void
 ) {
-	CefMemCacheT_Content_Mem_Entry* entry = NULL;
-	CefMemCacheT_Content_Mem_Entry* entry1 = NULL;
+	CefT_Mem_Shard* sp;
 	uint64_t 	nowt;
 	struct timeval tv;
+	int i;
 	int n;
-	unsigned char trg_key[65535];
-	int trg_key_len;
+
+	if (mem_shards == NULL) {
+		return;
+	}
 
 	gettimeofday (&tv, NULL);
 	nowt = tv.tv_sec * 1000000llu + tv.tv_usec;
 
-	for (n = 0 ; n < mem_hash_tbl->tabl_max ; n++) {
-		pthread_mutex_lock (&cef_mem_cs_mutex);
-		if (mem_hash_tbl->tbl[n] == NULL) {
-			pthread_mutex_unlock (&cef_mem_cs_mutex);
-			continue;
-		}
-		{
-			CefT_Mem_Hash_Cell* cp;
-			CefT_Mem_Hash_Cell* wcp;
-			cp = mem_hash_tbl->tbl[n];
-			for (; cp != NULL; cp = wcp) {
-				entry = cp->elem;
-				wcp = cp->next;
-				if ((entry->cache_time < nowt) ||
-					((entry->expiry != 0) && (entry->expiry < nowt))) {
-					/* Removes the expiry cache entry 		*/
-					trg_key_len = cef_mem_cache_key_create_by_Mem_Entry (entry, trg_key);
-					entry1 = cef_mem_cache_hash_tbl_item_remove (trg_key, trg_key_len);
-					cef_mem_cache_fifo_erase(trg_key, trg_key_len);
-					cef_mem_cache_mstat_remove (trg_key, trg_key_len, entry->pay_len);
-					free (entry1->msg);
-					free (entry1->name);
-					if (entry1->ver_len)
-						free (entry1->version);
-					free (entry1);
-				}
+	for (i = 0 ; i < Cef_Mem_Shard_Num ; i++) {
+		sp = &mem_shards[i];
+		do {
+			pthread_rwlock_wrlock (&sp->lock);
+			n = cef_mem_cache_shard_reap (sp, nowt);
+			pthread_rwlock_unlock (&sp->lock);
+			if (n == Cef_Mem_Reap_Batch) {
+				sched_yield ();
 			}
-		}
-		pthread_mutex_unlock (&cef_mem_cs_mutex);
+		} while (n == Cef_Mem_Reap_Batch);
 	}
 
 	return;
@@ -1131,11 +906,13 @@ cef_mem_cache_cs_expire_check (
 ----------------------------------------------------------------------------------------*/
 static int							/* The return value is negative if an error occurs	*/
 cef_mem_cache_cob_write (
-	CefMemCacheT_Content_Entry* cob
+	CefT_Mem_Shard* sp,
+	CefMemCacheT_Content_Entry* cob,
+	unsigned char* trg_key,
+	int trg_key_len,
+	uint32_t hash
 ) {
-	CefMemCacheT_Content_Mem_Entry* entry = NULL;
-	unsigned char 	trg_key[CefMemCacheC_Key_Max];
-	int 			trg_key_len;
+	CefT_Mem_Entry* entry = NULL;
 	uint64_t nowt;
 	struct timeval tv;
 	uint64_t old_ver_ac_cnt = 0;
@@ -1147,20 +924,15 @@ cef_mem_cache_cob_write (
 		return (0);
 	}
 
-	trg_key_len = cef_mem_cache_key_create (cob, trg_key);
-	entry = cef_mem_cache_hash_tbl_item_get (trg_key, trg_key_len);
-#if 0
-	if (entry == NULL) {
-		cef_mem_cache_fifo_insert(cob);
-		cef_mem_cache_mstat_insert (trg_key, trg_key_len, cob->pay_len);
-	}
-#else
-	/* This code (#else part) enables to overwrite the old cob kept in the Local cache  */
+	entry = cef_mem_cache_entry_lookup (sp, trg_key, trg_key_len, hash);
+
+	/* This code enables to overwrite the old cob kept in the Local cache  				*/
 	/* if the new cob with the same name is received.                                   */
 	/* This is a tentative solution, because this kind of cached content control should */
 	/* be done with the version number of each cob.                                     */
 	if (entry != NULL) {
-		rc = cef_mem_cache_version_compare (entry->version, entry->ver_len, cob->version, cob->ver_len);
+		rc = cef_mem_cache_version_compare (
+				entry->cob.version, entry->cob.ver_len, cob->version, cob->ver_len);
 		if (rc != Cef_InconsistentVersion) {
 			if (rc == Cef_NewestVersion_1stArg) {
 				/* The version of the entry is newer than the version of the receiving cob. */
@@ -1168,28 +940,21 @@ cef_mem_cache_cob_write (
 			} else if (rc == Cef_SameVersion) {
 				/* The version of the entry is the same as the version of the receiving cob. */
 				/* Overwrite the entry */
-				entry->cache_time	 = cob->cache_time;
-				entry->expiry		 = cob->expiry;
-				entry->node			 = cob->node;
+				entry->cob.cache_time	 = cob->cache_time;
+				entry->cob.expiry		 = cob->expiry;
+				entry->cob.node			 = cob->node;
+				cef_mem_cache_entry_expiry_set (sp, entry);
 				return (0);
 			} else {
 				CefT_Mem_Hash_Stat* mstat_p;
 				/* The cache entry version was older. */
 				/* Pass the Stat table entry to the delete thread */
 
-				/* Delete only this Cob entry first */
-				cef_mem_cache_fifo_erase (trg_key, trg_key_len);
-				entry = cef_mem_cache_hash_tbl_item_remove (trg_key, trg_key_len);
-
-				mstat_p = cef_mem_cache_mstat_get_out (trg_key, trg_key_len, entry->version, entry->ver_len);
+				mstat_p = cef_mem_cache_mstat_get_out (
+							trg_key, trg_key_len, entry->cob.version, entry->cob.ver_len);
 
-				if (entry) {
-					free (entry->msg);
-					free (entry->name);
-					if (entry->ver_len)
-						free (entry->version);
-					free (entry);
-				}
+				/* Delete only this Cob entry first */
+				cef_mem_cache_entry_free (sp, entry, (mstat_p == NULL));
 
 				if (mstat_p != NULL) {
 					CefT_Mem_Hash_Stat_Del mstat_del;
@@ -1219,13 +984,15 @@ cef_mem_cache_cob_write (
 			char uri[CefMemCacheC_Key_Max];
 			char cstr[CefMemCacheC_Key_Max];
 			char rstr[CefMemCacheC_Key_Max];
-			if (entry->ver_len) {
-				sprintf(cstr, "%s", entry->version);cstr[entry->ver_len] = 0x00;
+			if (entry->cob.ver_len) {
+				memcpy (cstr, entry->cob.version, entry->cob.ver_len);
+				cstr[entry->cob.ver_len] = 0x00;
 			} else {
 				sprintf(cstr, "None");cstr[4] = 0x00;
 			}
 			if (cob->ver_len) {
-				sprintf(rstr, "%s", cob->version);rstr[cob->ver_len] = 0x00;
+				memcpy (rstr, cob->version, cob->ver_len);
+				rstr[cob->ver_len] = 0x00;
 			} else {
 				sprintf(rstr, "None");rstr[4] = 0x00;
 			}
@@ -1236,9 +1003,11 @@ cef_mem_cache_cob_write (
 			return (0);
 		}
 	}
-	cef_mem_cache_fifo_insert(cob);
-	cef_mem_cache_mstat_insert (trg_key, trg_key_len, cob->pay_len, cob->version, cob->ver_len, old_ver_ac_cnt);
-#endif
+	if (cef_mem_cache_cs_store (sp, cob, trg_key, trg_key_len, hash) < 0) {
+		return (-1);
+	}
+	cef_mem_cache_mstat_insert (
+		trg_key, trg_key_len, cob->pay_len, cob->version, cob->ver_len, old_ver_ac_cnt);
 	return (0);
 }
 
@@ -1246,300 +1015,216 @@ cef_mem_cache_cob_write (
 	Hash functions
  ****************************************************************************************/
 /*--------------------------------------------------------------------------------------
-	Create memory hash table
+	Create hash number
 ----------------------------------------------------------------------------------------*/
-static CefT_Mem_Hash*
-cef_mem_hash_tbl_create (
-	uint32_t capacity
+static uint32_t
+cef_mem_hash_number_create (
+	const unsigned char* key,
+	uint32_t klen
 ) {
-	CefT_Mem_Hash* ht = NULL;
-	uint64_t table_size;
-	int i, n;
-	int flag;
-
-	table_size = capacity * CefC_Hash_Coef_Cache;
-
-	for (i = table_size ; i > 1 ; i++) {
-		flag = 0;
+	return (cef_hash_number_calc (CefC_Hash_Seed_Default, key, klen));
+}
+/*--------------------------------------------------------------------------------------
+	Returns the shard which keeps the entry of the hash value. The chunks of a
+	content are spread over the shards.
+----------------------------------------------------------------------------------------*/
+static CefT_Mem_Shard*
+cef_mem_cache_shard_get (
+	uint32_t hash
+) {
+	return (&mem_shards[(hash >> 16) % Cef_Mem_Shard_Num]);
+}
+/*--------------------------------------------------------------------------------------
+	Searches the entry in the shard. The caller holds the lock of the shard.
+----------------------------------------------------------------------------------------*/
+static CefT_Mem_Entry*
+cef_mem_cache_entry_lookup (
+	CefT_Mem_Shard* sp,
+	const unsigned char* key,
+	uint32_t klen,
+	uint32_t hash
+) {
+	CefT_Mem_Entry* entry;
 
-		for (n = 2 ; n < table_size ; n++) {
-			if (table_size % n == 0) {
-				flag = 1;
-				break;
-			}
-		}
-		if (flag) {
-			table_size++;
-		} else {
-			break;
+	for (entry = sp->tbl[hash % sp->tabl_max] ; entry != NULL ; entry = entry->next) {
+		if ((entry->hash == hash) &&
+			(entry->klen == klen) &&
+			(memcmp (entry->cob.name, key, klen) == 0)) {
+			return (entry);
 		}
 	}
+	return (NULL);
+}
+/*--------------------------------------------------------------------------------------
+	Inserts the entry into the hash table and the tail of the FIFO list
+----------------------------------------------------------------------------------------*/
+static void
+cef_mem_cache_entry_insert (
+	CefT_Mem_Shard* sp,
+	CefT_Mem_Entry* entry
+) {
+	uint32_t y = entry->hash % sp->tabl_max;
 
-	if (table_size > UINT_MAX) {
-		table_size = UINT_MAX;
-	}
+	entry->next = sp->tbl[y];
+	sp->tbl[y] = entry;
 
-	ht = (CefT_Mem_Hash*) malloc (sizeof (CefT_Mem_Hash));
-	if (ht == NULL) {
-		return (NULL);
+	entry->fifo_next = NULL;
+	entry->fifo_prev = sp->fifo_tail;
+	if (sp->fifo_tail) {
+		sp->fifo_tail->fifo_next = entry;
+	} else {
+		sp->fifo_head = entry;
 	}
-	memset (ht, 0, sizeof (CefT_Mem_Hash));
-
-	ht->tbl = (CefT_Mem_Hash_Cell**) malloc (sizeof (CefT_Mem_Hash_Cell*) * table_size);
+	sp->fifo_tail = entry;
 
-	if (ht->tbl  == NULL) {
-		//free (ht->tbl);
-		free (ht);
-		return (NULL);
-	}
-	memset (ht->tbl, 0, sizeof (CefT_Mem_Hash_Cell*) * table_size);
+	sp->elem_num++;
+	sp->byte_num += (uint64_t) Cef_Mem_Class_Min << entry->cls;
 
-	srand ((unsigned) time (NULL));
-	ht->elem_max = capacity;
-	ht->tabl_max = table_size;
-	mem_tabl_max = ht->tabl_max;
+	cef_mem_cache_entry_expiry_set (sp, entry);
 
-	return (ht);
+	return;
 }
 /*--------------------------------------------------------------------------------------
-	Set item to memory hash table
+	Removes the entry from the shard and returns its block. If stat_f is 1, the
+	entry is also removed from the stat.
 ----------------------------------------------------------------------------------------*/
-static int
-cef_mem_cache_hash_tbl_item_set (
-	const unsigned char* key,
-	uint32_t klen,
-	CefMemCacheT_Content_Mem_Entry* elem,
-	CefMemCacheT_Content_Mem_Entry** old_elem
+static void
+cef_mem_cache_entry_free (
+	CefT_Mem_Shard* sp,
+	CefT_Mem_Entry* entry,
+	int stat_f
 ) {
-	CefT_Mem_Hash* ht = (CefT_Mem_Hash*) mem_hash_tbl;
-	uint32_t hash = 0;
-	uint32_t y;
-	CefT_Mem_Hash_Cell* cp;
-	CefT_Mem_Hash_Cell* wcp;
-
-	*old_elem = NULL;
+	CefT_Mem_Entry** epp;
 
-	hash = cef_mem_hash_number_create (key, klen);
-	y = hash % ht->tabl_max;
-
-	if(ht->tbl[y] == NULL){
-		ht->tbl[y] = (CefT_Mem_Hash_Cell* )calloc(1, sizeof(CefT_Mem_Hash_Cell) + klen);
-		if (ht->tbl[y] == NULL) {
-			return (-1);
+	for (epp = &sp->tbl[entry->hash % sp->tabl_max] ; *epp != NULL ; epp = &(*epp)->next) {
+		if (*epp == entry) {
+			*epp = entry->next;
+			break;
 		}
-		ht->tbl[y]->key = ((unsigned char* )ht->tbl[y]) + sizeof(CefT_Mem_Hash_Cell);
-		cp = ht->tbl[y];
-		cp->elem = elem;
-		cp->klen = klen;
-		memcpy (cp->key, key, klen);
-
-		ht->elem_num++;
-		return (1);
+	}
+
+	if (entry->fifo_prev) {
+		entry->fifo_prev->fifo_next = entry->fifo_next;
 	} else {
-		/* exist check & replace */
-		for (cp = ht->tbl[y]; cp != NULL; cp = cp->next) {
-			if((cp->klen == klen) &&
-			   (memcmp (cp->key, key, klen) == 0)){
-				*old_elem = cp->elem;
-				cp->elem = elem;
-				return (1);
-		   }
-		}
-		/* insert */
-		wcp = ht->tbl[y];
-		ht->tbl[y] = (CefT_Mem_Hash_Cell* )calloc(1, sizeof(CefT_Mem_Hash_Cell) + klen);
-		if (ht->tbl[y] == NULL) {
-			return (-1);
-		}
-		ht->tbl[y]->key = ((unsigned char* )ht->tbl[y]) + sizeof(CefT_Mem_Hash_Cell);
-		cp = ht->tbl[y];
-		cp->next = wcp;
-		cp->elem = elem;
-		cp->klen = klen;
-		memcpy (cp->key, key, klen);
+		sp->fifo_head = entry->fifo_next;
+	}
+	if (entry->fifo_next) {
+		entry->fifo_next->fifo_prev = entry->fifo_prev;
+	} else {
+		sp->fifo_tail = entry->fifo_prev;
+	}
+
+	cef_mem_cache_entry_expiry_unlink (entry);
 
-		ht->elem_num++;
-		return (1);
+	sp->elem_num--;
+	sp->byte_num -= (uint64_t) Cef_Mem_Class_Min << entry->cls;
+
+	if (stat_f) {
+		cef_mem_cache_mstat_remove (entry->cob.name, entry->klen, entry->cob.pay_len);
 	}
+	cef_mpool_free (mem_slabs[entry->cls], entry);
+
+	return;
 }
 /*--------------------------------------------------------------------------------------
-	Get item from memory hash table
+	Puts the entry into the slot of the wheel for its expiry time
 ----------------------------------------------------------------------------------------*/
-static CefMemCacheT_Content_Mem_Entry*
-cef_mem_cache_hash_tbl_item_get (
-	const unsigned char* key,
-	uint32_t klen
+static void
+cef_mem_cache_entry_expiry_set (
+	CefT_Mem_Shard* sp,
+	CefT_Mem_Entry* entry
 ) {
-	CefT_Mem_Hash* ht = (CefT_Mem_Hash*) mem_hash_tbl;
-	uint32_t hash = 0;
-	uint32_t y;
-	CefT_Mem_Hash_Cell* cp;
+	CefT_Mem_Entry** slot;
+	uint64_t tick;
+
+	cef_mem_cache_entry_expiry_unlink (entry);
 
-	if ((klen > CefMemCacheC_Key_Max) || (ht == NULL)) {
-		return (NULL);
+	entry->expire_us = entry->cob.cache_time;
+	if ((entry->cob.expiry != 0) && (entry->cob.expiry < entry->expire_us)) {
+		entry->expire_us = entry->cob.expiry;
 	}
-	hash = cef_mem_hash_number_create (key, klen);
-	y = hash % ht->tabl_max;
 
-	cp = ht->tbl[y];
-	if(cp == NULL){
-		return (NULL);
+	/* The slot is visited when the tick has passed the expiry time 	*/
+	tick = entry->expire_us / Cef_Mem_Wheel_Tick + 1;
+	if (tick <= sp->cur_tick) {
+		tick = sp->cur_tick + 1;
 	}
-	for (; cp != NULL; cp = cp->next) {
-		if((cp->klen == klen) &&
-		   (memcmp (cp->key, key, klen) == 0)){
-		   	return (cp->elem);
-		}
+	slot = &(sp->wheel[tick % Cef_Mem_Wheel_Slot_Num]);
+	entry->tw_next = *slot;
+	if (*slot) {
+		(*slot)->tw_pprev = &(entry->tw_next);
 	}
+	entry->tw_pprev = slot;
+	*slot = entry;
 
-	return (NULL);
+	return;
 }
-
 /*--------------------------------------------------------------------------------------
-	Remove item from memory hash table
+	Takes the entry out of the wheel or the expired list
 ----------------------------------------------------------------------------------------*/
-static CefMemCacheT_Content_Mem_Entry*
-cef_mem_cache_hash_tbl_item_remove (
-	const unsigned char* key,
-	uint32_t klen
+static void
+cef_mem_cache_entry_expiry_unlink (
+	CefT_Mem_Entry* entry
 ) {
-	CefT_Mem_Hash* ht = (CefT_Mem_Hash*) mem_hash_tbl;
-	uint32_t hash = 0;
-	uint32_t y;
-	CefMemCacheT_Content_Mem_Entry* ret_elem;
-	CefT_Mem_Hash_Cell* cp;
-	CefT_Mem_Hash_Cell* wcp;
-
-	if ((klen > CefMemCacheC_Key_Max) || (ht == NULL)) {
-		return (NULL);
-	}
-
-	hash = cef_mem_hash_number_create (key, klen);
-	y = hash % ht->tabl_max;
-
-	cp = ht->tbl[y];
-	if(cp == NULL){
-		return (NULL);
+	if (entry->tw_pprev == NULL) {
+		return;
 	}
-	if (cp != NULL) {
-		if((cp->klen == klen) &&
-		   (memcmp (cp->key, key, klen) == 0)){
-		   	ht->tbl[y] = cp->next;
-			ht->elem_num--;
-		   	ret_elem = cp->elem;
-		   	free(cp);
-		   	return (ret_elem);
-		} else {
-			for (; cp->next != NULL; cp = cp->next) {
-				if((cp->next->klen == klen) &&
-				   (memcmp (cp->next->key, key, klen) == 0)){
-				   	wcp = cp->next;
-				   	cp->next = cp->next->next;
-					ht->elem_num--;
-				   	ret_elem = wcp->elem;
-		   			free(wcp);
-		   			return (ret_elem);
-				}
-			}
-		}
+	*(entry->tw_pprev) = entry->tw_next;
+	if (entry->tw_next) {
+		entry->tw_next->tw_pprev = entry->tw_pprev;
 	}
+	entry->tw_next  = NULL;
+	entry->tw_pprev = NULL;
 
-	return (NULL);
+	return;
 }
 /*--------------------------------------------------------------------------------------
-	Remove item from memory hash table(version)
+	Advances the wheel of the shard and frees up to Cef_Mem_Reap_Batch expired
+	entries. The caller holds the write lock of the shard.
 ----------------------------------------------------------------------------------------*/
-static CefMemCacheT_Content_Mem_Entry*
-cef_mem_cache_hash_tbl_item_remove_version (
-	const unsigned char* key,
-	uint32_t klen,
-	unsigned char* ver,
-	uint16_t vlen
+static int									/* Number of the freed entries				*/
+cef_mem_cache_shard_reap (
+	CefT_Mem_Shard* sp,
+	uint64_t nowt
 ) {
-	CefT_Mem_Hash* ht = (CefT_Mem_Hash*) mem_hash_tbl;
-	uint32_t hash = 0;
-	uint32_t y;
-	CefMemCacheT_Content_Mem_Entry* ret_elem;
-	CefT_Mem_Hash_Cell* cp;
-	CefT_Mem_Hash_Cell* wcp;
-
-	if ((klen > CefMemCacheC_Key_Max) || (ht == NULL)) {
-		return (NULL);
-	}
-
-	hash = cef_mem_hash_number_create (key, klen);
-	y = hash % ht->tabl_max;
-
-	cp = ht->tbl[y];
-	if(cp == NULL){
-		return (NULL);
-	}
-	if (cp != NULL) {
-		if ((cp->klen == klen) &&
-			(memcmp (cp->key, key, klen) == 0) &&
-			(cp->elem->ver_len == vlen) &&
-			(memcmp (cp->elem->version, ver, vlen) == 0)) {
-			ht->tbl[y] = cp->next;
-			ht->elem_num--;
-			ret_elem = cp->elem;
-			free(cp);
-			return (ret_elem);
-		} else {
-			for (; cp->next != NULL; cp = cp->next) {
-				if ((cp->next->klen == klen) &&
-					(memcmp (cp->next->key, key, klen) == 0) &&
-					(cp->next->elem->ver_len == vlen) &&
-					(memcmp (cp->next->elem->version, ver, vlen) == 0)){
-					wcp = cp->next;
-					cp->next = cp->next->next;
-					ht->elem_num--;
-					ret_elem = wcp->elem;
-					free(wcp);
-					return (ret_elem);
+	CefT_Mem_Entry* entry;
+	CefT_Mem_Entry* next;
+	uint64_t now_tick = nowt / Cef_Mem_Wheel_Tick;
+	int n = 0;
+
+	while (n < Cef_Mem_Reap_Batch) {
+		if (sp->expired == NULL) {
+			if (sp->cur_tick >= now_tick) {
+				break;
+			}
+			/* After a long stall, each slot is visited only once 	*/
+			if (now_tick - sp->cur_tick > Cef_Mem_Wheel_Slot_Num) {
+				sp->cur_tick = now_tick - Cef_Mem_Wheel_Slot_Num;
+			}
+			sp->cur_tick++;
+
+			/* Entries which expire in a later round stay in the slot 	*/
+			entry = sp->wheel[sp->cur_tick % Cef_Mem_Wheel_Slot_Num];
+			for ( ; entry != NULL ; entry = next) {
+				next = entry->tw_next;
+				if (entry->expire_us / Cef_Mem_Wheel_Tick < sp->cur_tick) {
+					cef_mem_cache_entry_expiry_unlink (entry);
+					entry->tw_next = sp->expired;
+					if (sp->expired) {
+						sp->expired->tw_pprev = &(entry->tw_next);
+					}
+					entry->tw_pprev = &(sp->expired);
+					sp->expired = entry;
 				}
 			}
+			continue;
 		}
+		/* Removes the expiry cache entry 		*/
+		cef_mem_cache_entry_free (sp, sp->expired, 1);
+		n++;
 	}
 
-	return (NULL);
-}
-
-
-/*--------------------------------------------------------------------------------------
-	Create hash number
-----------------------------------------------------------------------------------------*/
-static uint32_t
-cef_mem_hash_number_create (
-	const unsigned char* key,
-	uint32_t klen
-) {
-	uint32_t hash;
-	unsigned char out[MD5_DIGEST_LENGTH];
-
-	MD5 (key, klen, out);
-	memcpy (&hash, &out[12], sizeof (uint32_t));
-
-	return (hash);
-}
-/*--------------------------------------------------------------------------------------
-	Create hash key
-----------------------------------------------------------------------------------------*/
-int												/* length of the created key 			*/
-cef_mem_cache_key_create_by_Mem_Entry (
-	CefMemCacheT_Content_Mem_Entry* entry,
-	unsigned char* key
-) {
-	uint32_t chunk_num;
-
-	memcpy (&key[0], entry->name, entry->name_len);
-	key[entry->name_len] 		= 0x00;
-	key[entry->name_len + 1] 	= 0x10;
-	key[entry->name_len + 2] 	= 0x00;
-	key[entry->name_len + 3] 	= 0x04;
-	chunk_num = htonl (entry->chunk_num);
-	memcpy (&key[entry->name_len + 4], &chunk_num, sizeof (uint32_t));
-
-	return (entry->name_len + 4 + sizeof (uint32_t));
+	return (n);
 }
 
 /****************************************************************************************
@@ -1588,15 +1273,28 @@ cef_mem_cache_key_create (
 	return (entry->name_len + 4 + sizeof (uint32_t));
 }
 /*--------------------------------------------------------------------------------------
-	Initialize stat
+	Returns the smallest prime number that is not less than n
 ----------------------------------------------------------------------------------------*/
-static void
-cef_mem_cache_mstat_init (
-	void
+static uint32_t
+cef_mem_cache_prime_get (
+	uint64_t n
 ) {
-	memset (mstat_tbl, 0, sizeof (CefT_Mem_Hash_Stat*) * Cef_Mstat_HashTbl_Size);
+	uint64_t d;
 
-	return;
+	if (n < 2) {
+		return (2);
+	}
+	for ( ; n < UINT32_MAX ; n++) {
+		for (d = 2 ; d * d <= n ; d++) {
+			if (n % d == 0) {
+				break;
+			}
+		}
+		if (d * d > n) {
+			break;
+		}
+	}
+	return ((uint32_t) n);
 }
 /*--------------------------------------------------------------------------------------
 	Destroy stat
@@ -1620,6 +1318,7 @@ cef_mem_cache_mstat_destroy (
 			mstat_p = mstat_p->next;
 			free (wk_mstat_p);
 		}
+		mstat_tbl[i] = NULL;
 	}
 
 	return;
@@ -1651,6 +1350,7 @@ cef_mem_cache_mstat_insert (
 	hash = cef_mem_hash_number_create (key, tmp_klen);
 	y = hash % Cef_Mstat_HashTbl_Size;
 
+	pthread_rwlock_wrlock (&mstat_lock);
 	if(mstat_tbl[y] == NULL){
 		mstat_tbl[y] = (CefT_Mem_Hash_Stat*)malloc (sizeof (CefT_Mem_Hash_Stat));
 		mstat_p = mstat_tbl[y];
@@ -1665,6 +1365,7 @@ cef_mem_cache_mstat_insert (
 					mstat_p->min_seq = seqno;
 				if (mstat_p->max_seq < seqno)
 					mstat_p->max_seq = seqno;
+				pthread_rwlock_unlock (&mstat_lock);
 				return;
 			}
 			if (mstat_p->next == NULL)
@@ -1691,6 +1392,7 @@ cef_mem_cache_mstat_insert (
 	} else {
 		mstat_p->version = NULL;
 	}
+	pthread_rwlock_unlock (&mstat_lock);
 
 	return;
 }
@@ -1704,6 +1406,7 @@ cef_mem_cache_mstat_remove (
 	uint16_t pay_len							/* Length of ContentObject Payload		*/
 ) {
 	CefT_Mem_Hash_Stat* mstat_p;
+	CefT_Mem_Hash_Stat** mstat_pp;
 	uint16_t tmp_klen;
 	uint32_t seqno;		/* work variable */
 	uint32_t hash = 0;
@@ -1718,31 +1421,26 @@ cef_mem_cache_mstat_remove (
 	hash = cef_mem_hash_number_create (key, tmp_klen);
 	y = hash % Cef_Mstat_HashTbl_Size;
 
-	mstat_p = mstat_tbl[y];
-	while (mstat_p != NULL) {
+	pthread_rwlock_wrlock (&mstat_lock);
+	for (mstat_pp = &mstat_tbl[y]; *mstat_pp != NULL; mstat_pp = &(*mstat_pp)->next) {
+		mstat_p = *mstat_pp;
 		if (mstat_p->cname_len == tmp_klen &&
 			memcmp (mstat_p->contents_name, key, tmp_klen) == 0) {
 			mstat_p->contents_size -= pay_len;
 			mstat_p->cob_num--;
 
 			if (mstat_p->cob_num == 0) {
-				CefT_Mem_Hash_Stat*		wk_mstat_p;
-
+				*mstat_pp = mstat_p->next;
 				if (mstat_p->contents_name != NULL)
 					free (mstat_p->contents_name);
-				if (mstat_p != mstat_tbl[y]) {
-					wk_mstat_p = mstat_p;
-					mstat_p = mstat_p->next;
-					free (wk_mstat_p);
-				} else {
-					free (mstat_p);
-					mstat_tbl[y] = NULL;
-				}
+				if (mstat_p->version != NULL)
+					free (mstat_p->version);
+				free (mstat_p);
 			}
-			return;
+			break;
 		}
-		mstat_p = mstat_p->next;
 	}
+	pthread_rwlock_unlock (&mstat_lock);
 
 	return;
 }
@@ -1760,7 +1458,11 @@ cef_mem_cache_mstat_get (
 	uint32_t seqno;		/* work variable */
 	uint32_t hash = 0;
 	uint32_t y;
+	int rtc = -1;
 
+	if (mem_shards == NULL) {
+		return (-1);
+	}
 	tmp_klen = cef_frame_get_name_without_chunkno (key, klen, &seqno);
 	if (tmp_klen == 0) {
 		/* This name does not include the chunk number */
@@ -1770,6 +1472,7 @@ cef_mem_cache_mstat_get (
 	hash = cef_mem_hash_number_create (key, tmp_klen);
 	y = hash % Cef_Mstat_HashTbl_Size;
 
+	pthread_rwlock_rdlock (&mstat_lock);
 	mstat_p = mstat_tbl[y];
 	while (mstat_p != NULL) {
 		if (mstat_p->cname_len == tmp_klen &&
@@ -1802,12 +1505,14 @@ cef_mem_cache_mstat_get (
 			info_p->max_seq = mstat_p->max_seq;
 #endif //-----@@@@@ CCNINFO
 
-			return (1);
+			rtc = 1;
+			break;
 		}
 		mstat_p = mstat_p->next;
 	}
+	pthread_rwlock_unlock (&mstat_lock);
 
-	return (-1);
+	return (rtc);
 }
 /*--------------------------------------------------------------------------------------
 	Get Out stat
@@ -1820,6 +1525,7 @@ cef_mem_cache_mstat_get_out (
 	uint16_t vlen
 ) {
 	CefT_Mem_Hash_Stat* mstat_p;
+	CefT_Mem_Hash_Stat** mstat_pp;
 	uint16_t tmp_klen;
 	uint32_t seqno;		/* work variable */
 	uint32_t hash = 0;
@@ -1834,29 +1540,25 @@ cef_mem_cache_mstat_get_out (
 	hash = cef_mem_hash_number_create (key, tmp_klen);
 	y = hash % Cef_Mstat_HashTbl_Size;
 
-	mstat_p = mstat_tbl[y];
-	while (mstat_p != NULL) {
+	pthread_rwlock_wrlock (&mstat_lock);
+	for (mstat_pp = &mstat_tbl[y]; *mstat_pp != NULL; mstat_pp = &(*mstat_pp)->next) {
+		mstat_p = *mstat_pp;
 		if (mstat_p->cname_len == tmp_klen &&
 			memcmp (mstat_p->contents_name, key, tmp_klen) == 0 &&
 			mstat_p->ver_len == vlen &&
 			memcmp (mstat_p->version, ver, vlen) == 0) {
-			CefT_Mem_Hash_Stat*		wk_mstat_p;
-			wk_mstat_p = mstat_p;
-			if (mstat_p != mstat_tbl[y]) {
-				mstat_p = mstat_p->next;
-			} else {
-				mstat_tbl[y] = NULL;
-			}
-
-			return (wk_mstat_p);
+			*mstat_pp = mstat_p->next;
+			pthread_rwlock_unlock (&mstat_lock);
+			return (mstat_p);
 		}
-		mstat_p = mstat_p->next;
 	}
+	pthread_rwlock_unlock (&mstat_lock);
 
 	return (NULL);
 }
 /*--------------------------------------------------------------------------------------
-	Increment access count
+	Increment access count. The readers share the lock of the stat, so that the
+	counters are updated atomically.
 ----------------------------------------------------------------------------------------*/
 static void
 cef_mem_cache_mstat_ac_cnt_inc (
@@ -1872,22 +1574,27 @@ cef_mem_cache_mstat_ac_cnt_inc (
 	uint32_t y;
 
 	tmp_klen = cef_frame_get_name_without_chunkno (key, klen, &seqno);
+	if (tmp_klen == 0) {
+		tmp_klen = klen;
+	}
 
 	hash = cef_mem_hash_number_create (key, tmp_klen);
 	y = hash % Cef_Mstat_HashTbl_Size;
 
+	pthread_rwlock_rdlock (&mstat_lock);
 	mstat_p = mstat_tbl[y];
 	while (mstat_p != NULL) {
 		if ((mstat_p->cname_len == tmp_klen &&
 			memcmp (mstat_p->contents_name, key, tmp_klen) == 0) &&
 			(mstat_p->ver_len == ver_len &&
 			memcmp (mstat_p->version, version, ver_len) == 0)) {
-			mstat_p->ver_ac_cnt++;
-			mstat_p->ac_cnt++;
-			return;
+			__atomic_fetch_add (&mstat_p->ver_ac_cnt, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add (&mstat_p->ac_cnt, 1, __ATOMIC_RELAXED);
+			break;
 		}
 		mstat_p = mstat_p->next;
 	}
+	pthread_rwlock_unlock (&mstat_lock);
 
 	return;
 }
@@ -1921,48 +1628,45 @@ cef_mem_cache_version_compare (
 	}
 	return (Cef_NewestVersion_2ndArg);
 }
-#if 0
+#if ((defined CefC_CefnetdCache) && (defined CefC_Develop))
 /*--------------------------------------------------------------------------------------
-	Print stat (for debug)
+	Checks the Cob of the chunk number
 ----------------------------------------------------------------------------------------*/
-static void
-cef_mem_cache_mstat_print (
-	char* msg
+static int										/* 1: cached, 0: expired, -1: not cached	*/
+cef_mem_cache_entry_check (
+	unsigned char* name,
+	uint32_t name_len,
+	uint32_t seq,
+	uint64_t nowt
 ) {
-	CefT_Mem_Hash_Stat* mstat_p;
-	int i = 0;
-	int j, k;
-
-	if (msg != NULL)
-		fprintf(stderr, "%s\n", msg);
-
-	for (k = 0; k < Cef_Mstat_HashTbl_Size; k++) {
-		mstat_p = mstat_tbl[k];
-		while (mstat_p != NULL) {
-			fprintf (stderr, "    [%d](Hash=%d)\n", i, k);
-			fprintf (stderr, "        Name : ");
-			for (j = 0; j < mstat_p->cname_len;j++)
-				fprintf (stderr, "%02X ", mstat_p->contents_name[j]);
-			fprintf (stderr, "(%d)\n", mstat_p->cname_len);
-			if (mstat_p->ver_len)
-				fprintf (stderr, "        Ver  : %s\n", mstat_p->version);
-			else
-				fprintf (stderr, "        Ver  : None\n");
-			fprintf (stderr, "        Size : %lu\n", mstat_p->contents_size);
-			fprintf (stderr, "        Count: %lu\n", mstat_p->cob_num);
-			fprintf (stderr, "        AcCnt: %lu\n", mstat_p->ac_cnt);
-
-			i++;
-			mstat_p = mstat_p->next;
+	CefT_Mem_Shard* sp;
+	CefT_Mem_Entry* ent_p;
+	unsigned char	key[CefMemCacheC_Key_Max];
+	int 			key_len;
+	uint32_t 		hash;
+	int 			rtc = -1;
+
+	key_len = cef_mem_cache_name_chunknum_concatenate (name, name_len, seq, key);
+	hash = cef_mem_hash_number_create (key, key_len);
+	sp = cef_mem_cache_shard_get (hash);
+
+	pthread_rwlock_rdlock (&sp->lock);
+	ent_p = cef_mem_cache_entry_lookup (sp, key, key_len, hash);
+	if (ent_p != NULL) {
+		if ((ent_p->cob.cache_time < nowt) ||
+			((ent_p->cob.expiry != 0) && (ent_p->cob.expiry < nowt))) {
+			rtc = 0;
+		} else {
+			rtc = 1;
 		}
 	}
-	fprintf (stderr, "-------------------------------\n");
-	return;
+	pthread_rwlock_unlock (&sp->lock);
+
+	return (rtc);
 }
-#endif
-#if ((defined CefC_CefnetdCache) && (defined CefC_Develop))
 /*--------------------------------------------------------------------------------------
-	Get mstat info in buffer
+	Get mstat info in buffer. The stats are copied first, since the lock of the stat
+	must not be held while the shards are searched.
 ----------------------------------------------------------------------------------------*/
 int
 cef_mem_cache_mstat_get_buff (
@@ -1970,6 +1674,9 @@ cef_mem_cache_mstat_get_buff (
 	int buff_size
 ) {
 	CefT_Mem_Hash_Stat* mstat_p;
+	CefT_Mem_Hash_Stat* org_p;
+	CefT_Mem_Hash_Stat* head = NULL;
+	CefT_Mem_Hash_Stat* tail = NULL;
 	int k;
 	int index = 0;
 	int uri_len;
@@ -1980,136 +1687,171 @@ cef_mem_cache_mstat_get_buff (
 	char ver_none[] = "None";
 	char* wk = buff;
 	uint32_t entry_num = 0;
+	uint64_t nowt;
+	struct timeval tv;
+
+	if (mem_shards == NULL) {
+		return (0);
+	}
+
+	/* copies the stats */
+	pthread_rwlock_rdlock (&mstat_lock);
+	for (k = 0; k < Cef_Mstat_HashTbl_Size; k++) {
+		for (org_p = mstat_tbl[k]; org_p != NULL; org_p = org_p->next) {
+			mstat_p = (CefT_Mem_Hash_Stat*) malloc (sizeof (CefT_Mem_Hash_Stat));
+			if (mstat_p == NULL) {
+				break;
+			}
+			*mstat_p = *org_p;
+			mstat_p->next = NULL;
+			mstat_p->contents_name = (unsigned char*) malloc (org_p->cname_len);
+			memcpy (mstat_p->contents_name, org_p->contents_name, org_p->cname_len);
+			if (org_p->ver_len > 0) {
+				mstat_p->version = (unsigned char*) malloc (org_p->ver_len);
+				memcpy (mstat_p->version, org_p->version, org_p->ver_len);
+			}
+			if (tail) {
+				tail->next = mstat_p;
+			} else {
+				head = mstat_p;
+			}
+			tail = mstat_p;
+		}
+	}
+	pthread_rwlock_unlock (&mstat_lock);
 
 	/* num of entry */
 	wk += 4;
 	index += 4;
 
-	for (k = 0; k < Cef_Mstat_HashTbl_Size; k++) {
-		mstat_p = mstat_tbl[k];
-		while (mstat_p != NULL) {
-			uint64_t mins = UINT64_MAX;
-			uint64_t maxs = 0;
+	gettimeofday (&tv, NULL);
+	nowt = tv.tv_sec * 1000000llu + tv.tv_usec;
 
-			/* maintenance */
-			for (uint64_t m = mstat_p->min_seq; m <= mstat_p->max_seq; m++) {
-				unsigned char	key[CefMemCacheC_Key_Max];
-				int 			key_len;
-				CefMemCacheT_Content_Mem_Entry* ent_p;
+	for (mstat_p = head; mstat_p != NULL; mstat_p = mstat_p->next) {
+		uint64_t mins = UINT64_MAX;
+		uint64_t maxs = 0;
 
-				key_len = cef_mem_cache_name_chunknum_concatenate (
-							mstat_p->contents_name, mstat_p->cname_len, m, key);
-				ent_p = cef_mem_cache_hash_tbl_item_get (key, key_len);
-				if (ent_p == NULL) {
-					continue;
-				}
-				if (m < mins) {
-					mins = m;
-				}
-				if (m > maxs) {
-					maxs = m;
-				}
+		/* maintenance */
+		for (uint64_t m = mstat_p->min_seq; m <= mstat_p->max_seq; m++) {
+			if (cef_mem_cache_entry_check (
+					mstat_p->contents_name, mstat_p->cname_len, m, nowt) < 0) {
+				continue;
 			}
-			mstat_p->min_seq = mins;
-			mstat_p->max_seq = maxs;
-
-			/* check lifetime */
-			{
-				unsigned char	key[CefMemCacheC_Key_Max];
-				int 			key_len;
-				CefMemCacheT_Content_Mem_Entry* ent_p;
-				uint64_t		nowt;
-				struct timeval	tv;
-
-				gettimeofday (&tv, NULL);
-				nowt = tv.tv_sec * 1000000llu + tv.tv_usec;
-				key_len = cef_mem_cache_name_chunknum_concatenate (
-							mstat_p->contents_name, mstat_p->cname_len, mstat_p->min_seq, key);
-				ent_p = cef_mem_cache_hash_tbl_item_get (key, key_len);
-				if ((ent_p->cache_time < nowt) ||
-					((ent_p->expiry != 0) && (ent_p->expiry < nowt))) {
-					/* exclude */
-					mstat_p = mstat_p->next;
-					continue;
-				}
+			if (m < mins) {
+				mins = m;
 			}
+			if (m > maxs) {
+				maxs = m;
+			}
+		}
+		mstat_p->min_seq = mins;
+		mstat_p->max_seq = maxs;
+
+		pthread_rwlock_wrlock (&mstat_lock);
+		org_p = mstat_tbl[cef_mem_hash_number_create (
+					mstat_p->contents_name, mstat_p->cname_len) % Cef_Mstat_HashTbl_Size];
+		for (; org_p != NULL; org_p = org_p->next) {
+			if ((org_p->cname_len == mstat_p->cname_len) &&
+				(memcmp (org_p->contents_name, mstat_p->contents_name, mstat_p->cname_len) == 0) &&
+				(org_p->ver_len == mstat_p->ver_len) &&
+				(memcmp (org_p->version, mstat_p->version, mstat_p->ver_len) == 0)) {
+				org_p->min_seq = mins;
+				org_p->max_seq = maxs;
+				break;
+			}
+		}
+		pthread_rwlock_unlock (&mstat_lock);
 
-			memset (uri, 0, 65535);
-			uri_len = cef_frame_conversion_name_to_uri (mstat_p->contents_name, mstat_p->cname_len, uri);
-			if (mstat_p->ver_len == 0 && mstat_p->version == NULL)
-				ver_size = 4;
-			else
-				ver_size = mstat_p->ver_len;
+		/* check lifetime */
+		if (cef_mem_cache_entry_check (
+				mstat_p->contents_name, mstat_p->cname_len, mstat_p->min_seq, nowt) < 1) {
+			/* exclude */
+			continue;
+		}
 
-			add_size = uri_len + ver_size + 54;//2+4+(8*6)
+		memset (uri, 0, 65535);
+		uri_len = cef_frame_conversion_name_to_uri (mstat_p->contents_name, mstat_p->cname_len, uri);
+		if (mstat_p->ver_len == 0 && mstat_p->version == NULL)
+			ver_size = 4;
+		else
+			ver_size = mstat_p->ver_len;
 
-			if ((index + add_size) > buff_size) {
-				memcpy (wk, "*", 1);
-				index++;
-				break;
-			}
+		add_size = uri_len + ver_size + 54;//2+4+(8*6)
 
-			/* Name Len */
-			//uint32_t
-			memcpy (wk, &uri_len, 4);
-			wk += 4;
-
-			/* Name */
-			memcpy (wk, uri, uri_len);
-			wk += uri_len;
-
-			/* Version Len */
-			//uint16_t
-			memcpy (wk, &ver_size, 2);
-			wk += 2;
-
-			/* Version */
-			if (mstat_p->ver_len == 0 && mstat_p->version == NULL)
-				memcpy (wk, ver_none, ver_size);
-			else
-				memcpy (wk, mstat_p->version, mstat_p->ver_len);
-			wk += ver_size;
-
-			/* Size(KB) */
-			//uint64_t
-			size_kb = mstat_p->contents_size / 1024;
-			memcpy (wk, &size_kb, 8);
-			wk += 8;
-
-			/* Num */
-			//uint64_t
-			memcpy (wk, &(mstat_p->cob_num), 8);
-			wk += 8;
-
-			/* Min */
-			//uint64_t
-			memcpy (wk, &(mstat_p->min_seq), 8);
-			wk += 8;
-
-			/* Max */
-			//uint64_t
-			memcpy (wk, &(mstat_p->max_seq), 8);
-			wk += 8;
-
-			/* AC */
-			//uint64_t
-			memcpy (wk, &(mstat_p->ac_cnt), 8);
-			wk += 8;
-
-			/* VerAC */
-			//uint64_t
-			memcpy (wk, &(mstat_p->ver_ac_cnt), 8);
-			wk += 8;
-
-			entry_num++;
-			mstat_p = mstat_p->next;
-			index += add_size;
+		if ((index + add_size) > buff_size) {
+			memcpy (wk, "*", 1);
+			index++;
+			break;
 		}
+
+		/* Name Len */
+		//uint32_t
+		memcpy (wk, &uri_len, 4);
+		wk += 4;
+
+		/* Name */
+		memcpy (wk, uri, uri_len);
+		wk += uri_len;
+
+		/* Version Len */
+		//uint16_t
+		memcpy (wk, &ver_size, 2);
+		wk += 2;
+
+		/* Version */
+		if (mstat_p->ver_len == 0 && mstat_p->version == NULL)
+			memcpy (wk, ver_none, ver_size);
+		else
+			memcpy (wk, mstat_p->version, mstat_p->ver_len);
+		wk += ver_size;
+
+		/* Size(KB) */
+		//uint64_t
+		size_kb = mstat_p->contents_size / 1024;
+		memcpy (wk, &size_kb, 8);
+		wk += 8;
+
+		/* Num */
+		//uint64_t
+		memcpy (wk, &(mstat_p->cob_num), 8);
+		wk += 8;
+
+		/* Min */
+		//uint64_t
+		memcpy (wk, &(mstat_p->min_seq), 8);
+		wk += 8;
+
+		/* Max */
+		//uint64_t
+		memcpy (wk, &(mstat_p->max_seq), 8);
+		wk += 8;
+
+		/* AC */
+		//uint64_t
+		memcpy (wk, &(mstat_p->ac_cnt), 8);
+		wk += 8;
+
+		/* VerAC */
+		//uint64_t
+		memcpy (wk, &(mstat_p->ver_ac_cnt), 8);
+		wk += 8;
+
+		entry_num++;
+		index += add_size;
 	}
 
 	/* num of entry */
 	memcpy (buff, &entry_num, 4);
 
+	while (head != NULL) {
+		mstat_p = head;
+		head = head->next;
+		free (mstat_p->contents_name);
+		if (mstat_p->version != NULL)
+			free (mstat_p->version);
+		free (mstat_p);
+	}
+
 	return (index);
 }
 #endif //((defined CefC_CefnetdCache) && (defined CefC_Develop))
@@ -47,15 +47,26 @@
 #define CefC_Mp_Block_UnitBytes		16
 #define CefC_Mp_Max_Elem_Size		819200
 
+/* Size of the header in front of each block, keeping the 16 bytes alignment 	*/
+#define CefC_Mp_Hdr_Size \
+	(((sizeof (CefT_Mp_Block) + CefC_Mp_Block_UnitBytes - 1) \
+		/ CefC_Mp_Block_UnitBytes) * CefC_Mp_Block_UnitBytes)
+
+#define CefC_Mp_Cache_Size			64		/* max blocks each thread keeps per pool 	*/
+#define CefC_Mp_Cache_Move			32		/* blocks moved from/to the shared list 	*/
+
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
 
-typedef struct CefT_Mp_Pool {
-	unsigned char* 			head;
-	unsigned char* 			tail;
-	unsigned char* 			blocks;
-} CefT_Mp_Pool;
+/*
+ * The header in front of each memory block. It tells the pool which the block
+ * belongs to, so that the block is freed without searching the pools.
+ */
+typedef struct CefT_Mp_Block {
+	struct CefT_Mp_Mng* 	mng;			/* memory pool of this block 				*/
+	struct CefT_Mp_Block* 	next;			/* next free block 							*/
+} CefT_Mp_Block;
 
 /*
  * The information to manage a memory pool.
@@ -64,26 +75,45 @@ typedef struct CefT_Mp_Mng {
 	char* 					key;
 	size_t					klen;
 
-	size_t					size;			/* size of one memory block 				*/
+	size_t					size;			/* size of one memory block with header 	*/
 	int						increment;		/* number of blocks to allocate at one time	*/
 
-	CefT_Mp_Pool*			pool;			/* memory pool 		 						*/
-	size_t 					pool_num;
+	unsigned char**			slabs;			/* allocated areas of the blocks 			*/
+	size_t 					slab_num;
 
-	unsigned char**			free;
-	size_t 					head;
-	size_t 					tail;
+	CefT_Mp_Block*			free;			/* free blocks shared by the threads 		*/
+	size_t 					free_num;
 	size_t 					block_num;		/* number of allocated memory blocked 		*/
-	size_t 					mask;
-	
+	size_t 					peak_num;		/* max number of blocks taken at once 		*/
+
+	int 					id;				/* index of the thread cache, or -1 		*/
+	uint64_t 				gen;			/* identifies the pool in the thread cache 	*/
+
 	pthread_mutex_t 		mp_mutex_pt;	/* mutex for thread safe for Pthread 		*/
 
 } CefT_Mp_Mng;
 
+/*
+ * The free blocks which a thread keeps for a memory pool.
+ */
+typedef struct CefT_Mp_Cache {
+	uint64_t 				gen;			/* pool which the blocks belong to 			*/
+	CefT_Mp_Block*			head;
+	int 					num;
+} CefT_Mp_Cache;
+
 /****************************************************************************************
  State Variables
  ****************************************************************************************/
 
+static CefT_Mp_Mng* mp_pools[CefC_Mp_Pool_Max] = { NULL };
+static uint64_t mp_gen = 0;
+static pthread_mutex_t mp_pools_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread CefT_Mp_Cache mp_caches[CefC_Mp_Pool_Max];
+static __thread int mp_caches_reg_f = 0;	/* 1 if the destructor is registered 	*/
+static pthread_key_t mp_caches_key;
+static pthread_once_t mp_caches_once = PTHREAD_ONCE_INIT;
 
 /****************************************************************************************
  Static Function Declaration
@@ -105,6 +135,36 @@ cef_mpool_handle_destroy (
 	CefT_Mp_Mng* mpmng
 );
 
+static int
+cef_mpool_blocks_get (
+	CefT_Mp_Mng* mpmng,
+	CefT_Mp_Block** head,
+	int num
+);
+
+static void
+cef_mpool_blocks_put (
+	CefT_Mp_Mng* mpmng,
+	CefT_Mp_Block* head,
+	CefT_Mp_Block* tail,
+	int num
+);
+
+static void
+cef_mpool_cache_key_create (
+	void
+);
+
+static void
+cef_mpool_cache_register (
+	void
+);
+
+static void
+cef_mpool_cache_flush (
+	void* arg
+);
+
 /****************************************************************************************
  ****************************************************************************************/
 
@@ -139,80 +199,96 @@ cef_mpool_init (
 	return ((CefT_Mp_Handle) mpmng);
 }
 
+/*
+ * Takes a block from the blocks kept by the calling thread. Only when the thread
+ * has none, the blocks are moved from the shared list under the lock.
+ */
 void*
 cef_mpool_alloc (
 	CefT_Mp_Handle mph
 ) {
 	CefT_Mp_Mng* mpmng = (CefT_Mp_Mng*) mph;
-	size_t index;
-	int res;
-
-	while (1) {
-		res = pthread_mutex_trylock (&mpmng->mp_mutex_pt);
-		
-		if (res != 0) {
-			if (res == EBUSY) {
-				continue;
-			}
-			return (NULL);
+	CefT_Mp_Cache* cache;
+	CefT_Mp_Block* bp;
+
+	if (mpmng->id < 0) {
+		if (cef_mpool_blocks_get (mpmng, &bp, 1) < 1) {
+			return ((void*) NULL);
 		}
-		break;
+		return ((void*)((unsigned char*) bp + CefC_Mp_Hdr_Size));
 	}
 
-	
-	if (mpmng->tail != mpmng->head) {
-		index = mpmng->head;
-		mpmng->head = (mpmng->head + 1) & mpmng->mask;
-		pthread_mutex_unlock (&mpmng->mp_mutex_pt);
-		return ((void*) mpmng->free[index]);
+	cache = &mp_caches[mpmng->id];
+	if (cache->gen != mpmng->gen) {
+		/* The blocks were kept for a pool which has been destroyed 	*/
+		cache->gen  = mpmng->gen;
+		cache->head = NULL;
+		cache->num  = 0;
 	}
-
-	res = cef_mpool_handle_update (mpmng);
-
-	if (res > 0) {
-		index = mpmng->head;
-		mpmng->head = (mpmng->head + 1) & mpmng->mask;
-		pthread_mutex_unlock (&mpmng->mp_mutex_pt);
-		return ((void*) mpmng->free[index]);
+	if (cache->head == NULL) {
+		cef_mpool_cache_register ();
+		cache->num = cef_mpool_blocks_get (mpmng, &cache->head, CefC_Mp_Cache_Move);
+		if (cache->num < 1) {
+			cache->num = 0;
+			return ((void*) NULL);
+		}
 	}
+	bp = cache->head;
+	cache->head = bp->next;
+	cache->num--;
 
-	pthread_mutex_unlock (&mpmng->mp_mutex_pt);
-
-	return ((void*) NULL);
+	return ((void*)((unsigned char*) bp + CefC_Mp_Hdr_Size));
 }
 
+/*
+ * Returns the block to the calling thread. Blocks over CefC_Mp_Cache_Size are
+ * moved back to the shared list, so that the other threads can use them.
+ */
 void
 cef_mpool_free (
 	CefT_Mp_Handle mph,
 	void* ptr
 ) {
 	CefT_Mp_Mng* mpmng = (CefT_Mp_Mng*) mph;
-	int i = 0;
-	int res;
-
-	while (1) {
-		res = pthread_mutex_trylock (&mpmng->mp_mutex_pt);
-		
-		if (res != 0) {
-			if (EBUSY == res) {
-				continue;
-			}
-			return;
-		}
-		break;
+	CefT_Mp_Cache* cache;
+	CefT_Mp_Block* bp;
+	CefT_Mp_Block* tail;
+	int i;
+
+	if (ptr == NULL) {
+		return;
 	}
-	
-	while (i < mpmng->pool_num) {
-		if (((unsigned char*) ptr > mpmng->pool[i].head) &&
-			((unsigned char*) ptr < mpmng->pool[i].tail)) {
-			mpmng->tail = (mpmng->tail + 1) & mpmng->mask;
-			mpmng->free[mpmng->tail] = ptr;
-			break;
-		}
-		i++;
+	bp = (CefT_Mp_Block*)((unsigned char*) ptr - CefC_Mp_Hdr_Size);
+	if (bp->mng != mpmng) {
+		return;
 	}
 
-	pthread_mutex_unlock (&mpmng->mp_mutex_pt);
+	if (mpmng->id < 0) {
+		cef_mpool_blocks_put (mpmng, bp, bp, 1);
+		return;
+	}
+
+	cache = &mp_caches[mpmng->id];
+	if (cache->gen != mpmng->gen) {
+		cache->gen  = mpmng->gen;
+		cache->head = NULL;
+		cache->num  = 0;
+	}
+	cef_mpool_cache_register ();
+	bp->next = cache->head;
+	cache->head = bp;
+	cache->num++;
+
+	if (cache->num > CefC_Mp_Cache_Size) {
+		tail = cache->head;
+		for (i = 1 ; i < CefC_Mp_Cache_Move ; i++) {
+			tail = tail->next;
+		}
+		bp = cache->head;
+		cache->head = tail->next;
+		cache->num -= CefC_Mp_Cache_Move;
+		cef_mpool_blocks_put (mpmng, bp, tail, CefC_Mp_Cache_Move);
+	}
 
 	return;
 }
@@ -229,6 +305,42 @@ cef_mpool_destroy (
 	}
 }
 
+/*
+ * Obtains the statistics of the memory pools. The used blocks include the
+ * blocks kept by the threads.
+ */
+int 										/* Number of the memory pools 				*/
+cef_mpool_stat_get (
+	CefT_Mp_Stat* stats,					/* buffer to set the statistics 			*/
+	int max									/* size of the buffer 						*/
+) {
+	CefT_Mp_Mng* mpmng;
+	int num = 0;
+	int i;
+
+	pthread_mutex_lock (&mp_pools_mutex);
+	for (i = 0 ; (i < CefC_Mp_Pool_Max) && (num < max) ; i++) {
+		mpmng = mp_pools[i];
+		if (mpmng == NULL) {
+			continue;
+		}
+		pthread_mutex_lock (&mpmng->mp_mutex_pt);
+		memset (&stats[num], 0, sizeof (CefT_Mp_Stat));
+		if (mpmng->key) {
+			strncpy (stats[num].key, mpmng->key, sizeof (stats[num].key) - 1);
+		}
+		stats[num].size 		= mpmng->size - CefC_Mp_Hdr_Size;
+		stats[num].block_num 	= mpmng->block_num;
+		stats[num].used_num 	= mpmng->block_num - mpmng->free_num;
+		stats[num].peak_num 	= mpmng->peak_num;
+		pthread_mutex_unlock (&mpmng->mp_mutex_pt);
+		num++;
+	}
+	pthread_mutex_unlock (&mp_pools_mutex);
+
+	return (num);
+}
+
 /*=======================================================================================
  =======================================================================================*/
 
@@ -241,17 +353,7 @@ cef_mpool_handle_create (
 											/* one time.								*/
 ) {
 	CefT_Mp_Mng* mpmng;
-	size_t i;
-	unsigned char* bp;
-
-	int p;
-
-	increment--;
-
-	for (p = 0 ; increment != 0 ; increment >>= 1) {
-		p = (p << 1) + 1;
-	}
-	increment = p + 1;
+	int i;
 
 	/* allocation the memory for the new memory pool 	*/
 	mpmng = (CefT_Mp_Mng*) malloc (sizeof (CefT_Mp_Mng));
@@ -259,7 +361,8 @@ cef_mpool_handle_create (
 		return (NULL);
 	}
 	memset (mpmng, 0, sizeof (CefT_Mp_Mng));
-
+	mpmng->id = -1;
+	pthread_mutex_init (&mpmng->mp_mutex_pt, NULL);
 
 	if (key != NULL) {
 		mpmng->klen = (size_t) strlen (key);
@@ -274,7 +377,7 @@ cef_mpool_handle_create (
 	/* set the block size to a multiple of 16 for the alignment 	*/
 	mpmng->size
 		= ((size + CefC_Mp_Block_UnitBytes - 1) / CefC_Mp_Block_UnitBytes)
-			* CefC_Mp_Block_UnitBytes;
+			* CefC_Mp_Block_UnitBytes + CefC_Mp_Hdr_Size;
 
 	/* record the number of blocks to allocate at one time 		*/
 	mpmng->increment = increment;
@@ -283,110 +386,64 @@ cef_mpool_handle_create (
 	}
 
 	/* allocate the memory pool 	*/
-	mpmng->pool_num = 1;
-	mpmng->pool = (CefT_Mp_Pool*) calloc (mpmng->pool_num, sizeof (CefT_Mp_Pool));
-
-	if (mpmng->pool == NULL) {
-		cef_mpool_handle_destroy (mpmng);
-		return (NULL);
-	}
-	memset (mpmng->pool, 0, sizeof (CefT_Mp_Pool) * mpmng->pool_num);
-
-	mpmng->pool[0].blocks
-		= (unsigned char*) calloc (mpmng->increment, mpmng->size);
-	if (mpmng->pool[0].blocks == NULL) {
-		cef_mpool_handle_destroy (mpmng);
-		return (NULL);
-	}
-	memset (mpmng->pool[0].blocks, 0, mpmng->increment * mpmng->size);
-
-	mpmng->pool[0].head = mpmng->pool[0].blocks - 1;
-	mpmng->pool[0].tail
-		= mpmng->pool[0].blocks + mpmng->increment * (mpmng->size - 1) + 1;
-
-	/* prepare management information 	*/
-	mpmng->block_num = mpmng->increment;
-	mpmng->mask = mpmng->block_num - 1;
-	mpmng->free
-		= (unsigned char**) malloc (sizeof (unsigned char*) * mpmng->block_num);
-	if (mpmng->free == NULL) {
+	if (cef_mpool_handle_update (mpmng) < 0) {
 		cef_mpool_handle_destroy (mpmng);
 		return (NULL);
 	}
-	mpmng->head = 0;
-	mpmng->tail = mpmng->block_num - 1;
 
-	bp = mpmng->pool[0].blocks;
-
-	for (i = 0 ; i < mpmng->block_num ; i++) {
-		mpmng->free[i] = bp;
-		bp += mpmng->size;
+	/* registers the pool to use the thread cache and to output the statistics 	*/
+	pthread_mutex_lock (&mp_pools_mutex);
+	mp_gen++;
+	mpmng->gen = mp_gen;
+	for (i = 0 ; i < CefC_Mp_Pool_Max ; i++) {
+		if (mp_pools[i] == NULL) {
+			mp_pools[i] = mpmng;
+			mpmng->id = i;
+			break;
+		}
 	}
-	pthread_mutex_init (&mpmng->mp_mutex_pt, NULL);
+	pthread_mutex_unlock (&mp_pools_mutex);
 
 	return (mpmng);
 }
 
+/*
+ * Adds the blocks of increment to the shared list. The caller holds the lock.
+ */
 static int
 cef_mpool_handle_update (
 	CefT_Mp_Mng* mpmng
 ) {
-	CefT_Mp_Pool* new_pool;
-	unsigned char** new_free;
-	size_t new_block_num;
-	size_t i;
+	unsigned char** new_slabs;
 	unsigned char* bp;
+	CefT_Mp_Block* blk;
+	int i;
 
 	/* allocate the memory pool 	*/
-	new_pool = (CefT_Mp_Pool*) calloc (mpmng->pool_num + 1, sizeof (CefT_Mp_Pool));
-	if (new_pool == NULL) {
+	new_slabs = (unsigned char**)
+		realloc (mpmng->slabs, sizeof (unsigned char*) * (mpmng->slab_num + 1));
+	if (new_slabs == NULL) {
 		return (-1);
 	}
-	memset (new_pool, 0, sizeof (CefT_Mp_Pool) * (mpmng->pool_num + 1));
+	mpmng->slabs = new_slabs;
 
-	for (i = 0 ; i < mpmng->pool_num ; i++) {
-		new_pool[i].blocks 	= mpmng->pool[i].blocks;
-		new_pool[i].head 	= mpmng->pool[i].head;
-		new_pool[i].tail 	= mpmng->pool[i].tail;
-	}
-	new_pool[i].blocks = (unsigned char*) calloc (mpmng->increment, mpmng->size);
-	if (new_pool[i].blocks == NULL) {
-		free (new_pool);
+	bp = (unsigned char*) calloc (mpmng->increment, mpmng->size);
+	if (bp == NULL) {
 		return (-1);
 	}
-	memset (new_pool[i].blocks, 0, mpmng->increment * mpmng->size);
-
-	new_pool[i].head = new_pool[i].blocks - 1;
-	new_pool[i].tail = new_pool[i].blocks + mpmng->increment * (mpmng->size - 1) + 1;
-
-
-	free (mpmng->pool);
-	mpmng->pool = new_pool;
-	mpmng->pool_num++;
+	mpmng->slabs[mpmng->slab_num] = bp;
+	mpmng->slab_num++;
 
 	/* prepare management information 	*/
-	new_block_num = mpmng->block_num + mpmng->increment;
-	new_free = (unsigned char**) malloc (sizeof (unsigned char*) * new_block_num);
-	if (new_free == NULL) {
-		mpmng->pool_num--;
-		return (-1);
-	}
-
-	bp = mpmng->pool[i].blocks;
-	for (i = mpmng->block_num ; i < new_block_num ; i++) {
-		new_free[i] = bp;
+	for (i = 0 ; i < mpmng->increment ; i++) {
+		blk = (CefT_Mp_Block*) bp;
+		blk->mng  = mpmng;
+		blk->next = mpmng->free;
+		mpmng->free = blk;
 		bp += mpmng->size;
 	}
-	for (i = 0 ; i < mpmng->block_num ; i++) {
-		new_free[i] = mpmng->free[i];
-	}
-	free (mpmng->free);
-	mpmng->free = new_free;
-
-	mpmng->head = mpmng->block_num;
-	mpmng->block_num = new_block_num;
-	mpmng->mask = mpmng->block_num - 1;
-	mpmng->tail = mpmng->block_num - 1;
+	mpmng->free_num  += mpmng->increment;
+	mpmng->block_num += mpmng->increment;
 
 	return (1);
 }
@@ -395,28 +452,146 @@ static void
 cef_mpool_handle_destroy (
 	CefT_Mp_Mng* mpmng
 ) {
-	int i;
+	size_t i;
 
 	if (mpmng == NULL) {
 		return;
 	}
 
-	if (mpmng->pool) {
-		for (i = 0 ; i < mpmng->pool_num ; i++) {
-			free (mpmng->pool[i].blocks);
+	if (mpmng->id >= 0) {
+		pthread_mutex_lock (&mp_pools_mutex);
+		mp_pools[mpmng->id] = NULL;
+		pthread_mutex_unlock (&mp_pools_mutex);
+	}
+
+	if (mpmng->slabs) {
+		for (i = 0 ; i < mpmng->slab_num ; i++) {
+			free (mpmng->slabs[i]);
 		}
-		free (mpmng->pool);
+		free (mpmng->slabs);
 	}
 
 	if (mpmng->key) {
 		free (mpmng->key);
 	}
 
-	if (mpmng->free) {
-		free (mpmng->free);
+	free (mpmng);
+
+	return;
+}
+
+/*
+ * Takes up to num blocks from the shared list, adding blocks if it is empty
+ */
+static int									/* Number of the blocks taken 				*/
+cef_mpool_blocks_get (
+	CefT_Mp_Mng* mpmng,
+	CefT_Mp_Block** head,
+	int num
+) {
+	CefT_Mp_Block* bp;
+	int n;
+
+	pthread_mutex_lock (&mpmng->mp_mutex_pt);
+
+	if ((mpmng->free == NULL) && (cef_mpool_handle_update (mpmng) < 0)) {
+		pthread_mutex_unlock (&mpmng->mp_mutex_pt);
+		*head = NULL;
+		return (0);
 	}
 
-	free (mpmng);
+	*head = mpmng->free;
+	bp = mpmng->free;
+	for (n = 1 ; (n < num) && (bp->next) ; n++) {
+		bp = bp->next;
+	}
+	mpmng->free = bp->next;
+	bp->next = NULL;
+	mpmng->free_num -= n;
+
+	if (mpmng->block_num - mpmng->free_num > mpmng->peak_num) {
+		mpmng->peak_num = mpmng->block_num - mpmng->free_num;
+	}
+	pthread_mutex_unlock (&mpmng->mp_mutex_pt);
+
+	return (n);
+}
+
+/*
+ * Returns the list of num blocks from head to tail to the shared list
+ */
+static void
+cef_mpool_blocks_put (
+	CefT_Mp_Mng* mpmng,
+	CefT_Mp_Block* head,
+	CefT_Mp_Block* tail,
+	int num
+) {
+	pthread_mutex_lock (&mpmng->mp_mutex_pt);
+	tail->next = mpmng->free;
+	mpmng->free = head;
+	mpmng->free_num += num;
+	pthread_mutex_unlock (&mpmng->mp_mutex_pt);
+
+	return;
+}
+
+/*
+ * Creates the key whose destructor returns the blocks kept by an exiting thread
+ */
+static void
+cef_mpool_cache_key_create (
+	void
+) {
+	if (pthread_key_create (&mp_caches_key, cef_mpool_cache_flush) != 0) {
+		fprintf (stderr, "[error] cef_mpool - pthread_key_create\n");
+	}
+}
+
+/*
+ * Registers the thread cache of the calling thread to be flushed when it exits
+ */
+static void
+cef_mpool_cache_register (
+	void
+) {
+	if (mp_caches_reg_f) {
+		return;
+	}
+	mp_caches_reg_f = 1;
+	pthread_once (&mp_caches_once, cef_mpool_cache_key_create);
+	pthread_setspecific (mp_caches_key, mp_caches);
+}
+
+/*
+ * Returns the blocks kept by the exiting thread to the shared lists. The pools
+ * are looked up under mp_pools_mutex, so that a destroyed pool is not touched.
+ */
+static void
+cef_mpool_cache_flush (
+	void* arg
+) {
+	CefT_Mp_Cache* caches = (CefT_Mp_Cache*) arg;
+	CefT_Mp_Mng* mpmng;
+	CefT_Mp_Block* tail;
+	int i;
+
+	pthread_mutex_lock (&mp_pools_mutex);
+	for (i = 0 ; i < CefC_Mp_Pool_Max ; i++) {
+		mpmng = mp_pools[i];
+		if ((caches[i].head == NULL) ||
+			(mpmng == NULL) || (mpmng->gen != caches[i].gen)) {
+			continue;
+		}
+		tail = caches[i].head;
+		while (tail->next) {
+			tail = tail->next;
+		}
+		cef_mpool_blocks_put (mpmng, caches[i].head, tail, caches[i].num);
+		caches[i].head = NULL;
+		caches[i].num  = 0;
+	}
+	pthread_mutex_unlock (&mp_pools_mutex);
 
 	return;
 }
@@ -68,6 +68,14 @@
  Structures Declaration
  ****************************************************************************************/
 
+/***** Expiry wheel of a PIT 	*****/
+typedef struct CefT_Pit_Wheel {
+	CefT_Hash_Handle	pit;				/* PIT which the wheel belongs to 			*/
+	uint64_t			cur_tick;			/* tick which the wheel has reached			*/
+	CefT_Pit_Entry*		expired;			/* entries taken out of the slots 			*/
+	uint32_t			entry_num;			/* entries in the slots and expired 		*/
+	CefT_Pit_Entry*		slots[CefC_Pit_Wheel_Slot_Num];
+} CefT_Pit_Wheel;
 
 /****************************************************************************************
  State Variables
@@ -84,6 +92,8 @@ static uint32_t ccninfo_reply_timeout = CefC_Default_CcninfoReplyTimeout;
 static uint32_t symbolic_max_lifetime;
 static uint32_t regular_max_lifetime;
 
+static CefT_Pit_Wheel* pit_wheels[CefC_Pit_Wheel_Max] = { NULL };
+
 #define	CefC_IR_SUPPORT_NUM			3
 uint8_t	IR_PRIORITY_TBL[CefC_IR_SUPPORT_NUM] = {
 	CefC_IR_HOPLIMIT_EXCEEDED,
@@ -131,6 +141,48 @@ cef_pit_cleanup (
 	CefT_Hash_Handle pit,					/* PIT										*/
 	CefT_Pit_Entry* entry 					/* PIT entry 								*/
 );
+/*--------------------------------------------------------------------------------------
+	Obtains the expiry wheel of the specified PIT
+----------------------------------------------------------------------------------------*/
+static CefT_Pit_Wheel*
+cef_pit_wheel_get (
+	CefT_Hash_Handle pit					/* PIT										*/
+);
+/*--------------------------------------------------------------------------------------
+	Puts the PIT entry into the slot of the expiry time
+----------------------------------------------------------------------------------------*/
+static void
+cef_pit_entry_expiry_set (
+	CefT_Pit_Entry* entry, 					/* PIT entry 								*/
+	uint64_t expire_us						/* time to visit the entry (usec)			*/
+);
+/*--------------------------------------------------------------------------------------
+	Takes the PIT entry out of the expiry wheel
+----------------------------------------------------------------------------------------*/
+static void
+cef_pit_entry_expiry_unlink (
+	CefT_Pit_Entry* entry 					/* PIT entry 								*/
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the hash value of the name in the PIT
+----------------------------------------------------------------------------------------*/
+static uint32_t
+cef_pit_name_hashv_get (
+	CefT_Hash_Handle pit,					/* PIT										*/
+	CefT_CcnMsg_MsgBdy* pm, 				/* Parsed CEFORE message					*/
+	const unsigned char* name,				/* Name										*/
+	uint16_t name_len						/* Length of Name							*/
+);
+/*--------------------------------------------------------------------------------------
+	Searches the PIT entry of the name
+----------------------------------------------------------------------------------------*/
+static CefT_Pit_Entry*
+cef_pit_item_get (
+	CefT_Hash_Handle pit,					/* PIT										*/
+	CefT_CcnMsg_MsgBdy* pm, 				/* Parsed CEFORE message					*/
+	const unsigned char* name,				/* Name										*/
+	uint16_t name_len						/* Length of Name							*/
+);
 /****************************************************************************************
  ****************************************************************************************/
 
@@ -164,6 +216,7 @@ cef_pit_entry_lookup_with_lock (
 ) {
 	CefT_Pit_Entry* entry;
 	int		f_new_entry = 0;
+	uint32_t hashv;
 
 #ifdef	__PIT_DEBUG__
 	fprintf (stderr, "[%s] IN\n",
@@ -171,7 +224,8 @@ cef_pit_entry_lookup_with_lock (
 #endif
 
 	/* Searches a PIT entry 	*/
-	entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_get (pit, name, name_len);
+	hashv = cef_pit_name_hashv_get (pit, pm, name, name_len);
+	entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_get_hashv (pit, name, name_len, hashv);
 #ifdef	__PIT_DEBUG__
 	if (entry)
 		fprintf (stderr, "\t entry=%p\n", (void*)entry);
@@ -223,15 +277,17 @@ cef_dbg_write(CefC_Dbg_Fine, "free(CefT_Pit_Entry=%p)\n", entry);
 
 	/* Creates a new PIT entry, if it dose not match 	*/
 	if (f_new_entry) {
-		int res = cef_lhash_tbl_item_set (pit, name, name_len, entry);
+		int res = cef_lhash_tbl_item_set_hashv (pit, name, name_len, hashv, entry);
 		if (res) {
 			cef_log_write (CefC_Log_Warn, "%s(%u) cef_lhash_tbl_item_set=%d\n", __func__, __LINE__, res);
 		}
 
 		entry->klen = name_len;
 		memcpy (entry->key, name, name_len);
-		entry->hashv = cef_lhash_tbl_hashv_get (pit, entry->key, entry->klen);
+		entry->hashv = hashv;
 		entry->clean_us = cef_client_present_timeus_get () + CefC_Pit_CleaningTime;
+		entry->wheel = cef_pit_wheel_get (pit);
+		cef_pit_entry_expiry_set (entry, entry->clean_us);
 		entry->tp_variant = poh->org.tp_variant;
 		entry->nonce = 0;
 		entry->adv_lifetime_us = 0;
@@ -353,7 +409,7 @@ cef_pit_entry_search (
 #endif // CefC_Debug
 
 	/* Searches a PIT entry 	*/
-	entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_get (pit, tmp_name, tmp_name_len);
+	entry = cef_pit_item_get (pit, pm, tmp_name, tmp_name_len);
 	now = cef_client_present_timeus_get ();
 
 	if (entry != NULL) {
@@ -396,7 +452,7 @@ cef_pit_entry_search (
 	if (pm->chunk_num_f) {
 		uint16_t name_len_wo_chunk;
 		name_len_wo_chunk = tmp_name_len - (CefC_S_Type + CefC_S_Length + CefC_S_ChunkNum);
-		entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_get (pit, tmp_name, name_len_wo_chunk);
+		entry = cef_pit_item_get (pit, pm, tmp_name, name_len_wo_chunk);
 
 		if (entry != NULL) {
 			if (entry->longlife_f) {
@@ -470,7 +526,7 @@ cef_pit_entry_search_specified_name (
 #endif // CefC_Debug
 
 	/* Searches a PIT entry 	*/
-	entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_get (pit, sp_name, name_len);
+	entry = cef_pit_item_get (pit, pm, sp_name, name_len);
 
 	if (entry != NULL) {
 		if (match_type) {
@@ -510,7 +566,7 @@ cef_pit_entry_search_specified_name (
 	if (pm->chunk_num_f) {
 		uint16_t name_len_wo_chunk;
 		name_len_wo_chunk = name_len - (CefC_S_Type + CefC_S_Length + CefC_S_ChunkNum);
-		entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_get (pit, pm->name, name_len_wo_chunk);
+		entry = cef_pit_item_get (pit, pm, pm->name, name_len_wo_chunk);
 
 		if (entry != NULL) {
 			if (entry->longlife_f) {
@@ -581,7 +637,7 @@ cef_pit_entry_search_specified_name_for_app (
 
 	/* Searches a PIT entry 	*/
 	while (name_len > 0) {
-		entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_get (pit, sp_name, name_len);
+		entry = cef_pit_item_get (pit, pm, sp_name, name_len);
 		if (entry != NULL) {
 #ifdef CefC_Debug
 			cef_dbg_write (CefC_Dbg_Finest, "[pit] Matched to the entry\n");
@@ -781,6 +837,26 @@ cef_pit_entry_down_face_update (
 	prev_lifetime_us  = face->lifetime_us;
 	face->lifetime_us = nowt_us + extent_us;
 
+	/* The entry is visited when this Down Face expires. A later visit is 	*/
+	/* left to cef_pit_entry_expiry_update.									*/
+	{
+		uint64_t expire_us = face->lifetime_us;
+		uint64_t adv_us = entry->adv_lifetime_us;
+
+		if (adv_us < face->lifetime_us) {
+			adv_us = face->lifetime_us;
+		}
+		if (expire_us < entry->clean_us) {
+			expire_us = entry->clean_us;
+		}
+		if (expire_us > adv_us) {
+			expire_us = adv_us;
+		}
+		if (expire_us + 1 < entry->expire_us) {
+			cef_pit_entry_expiry_set (entry, expire_us + 1);
+		}
+	}
+
 #ifdef	__PIT_DEBUG__
 	fprintf (stderr, "\t Before\n" );
 	fprintf (stderr, "\t extent_us= "FMTU64"\n", extent_us / 1000 );
@@ -995,6 +1071,7 @@ cef_pit_entry_free (
 	fprintf( stderr, "[%s] IN entry->dnfacenum:%d\n", __func__, entry->dnfacenum );
 #endif
 
+	cef_pit_entry_expiry_unlink (entry);
 	rm_entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_remove (pit, entry->key, entry->klen);
 	if ( rm_entry != entry ){
 		cef_log_write (CefC_Log_Warn, "%s(%u) cef_lhash_tbl_item_remove() failed, entry=%p, rm_entry=%p.\n",
@@ -1159,6 +1236,179 @@ cef_dbg_write (CefC_Dbg_Fine, "dnface_prv=%p, next=%p\n", dnface_prv, dnface_prv
 	return;
 }
 
+/*--------------------------------------------------------------------------------------
+	Creates the expiry wheel of the specified PIT
+----------------------------------------------------------------------------------------*/
+int 										/* Returns a negative value if it fails 	*/
+cef_pit_wheel_create (
+	CefT_Hash_Handle pit					/* PIT										*/
+) {
+	CefT_Pit_Wheel* wheel;
+	int i;
+
+	if (cef_pit_wheel_get (pit)) {
+		return (0);
+	}
+	for (i = 0 ; i < CefC_Pit_Wheel_Max ; i++) {
+		if (pit_wheels[i] == NULL) {
+			break;
+		}
+	}
+	if (i == CefC_Pit_Wheel_Max) {
+		return (-1);
+	}
+	wheel = (CefT_Pit_Wheel*) calloc (1, sizeof (CefT_Pit_Wheel));
+	if (wheel == NULL) {
+		cef_log_write (CefC_Log_Error, "%s(%u) calloc(%ld) failed, %s\n", __func__, __LINE__,
+			sizeof (CefT_Pit_Wheel), strerror(errno));
+		return (-1);
+	}
+	wheel->pit = pit;
+	wheel->cur_tick = cef_client_present_timeus_get () / CefC_Pit_Wheel_Tick;
+	pit_wheels[i] = wheel;
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Destroys the expiry wheel of the specified PIT
+----------------------------------------------------------------------------------------*/
+void
+cef_pit_wheel_destroy (
+	CefT_Hash_Handle pit					/* PIT										*/
+) {
+	CefT_Pit_Wheel* wheel;
+	int i;
+
+	for (i = 0 ; i < CefC_Pit_Wheel_Max ; i++) {
+		if ((pit_wheels[i]) && (pit_wheels[i]->pit == pit)) {
+			break;
+		}
+	}
+	if (i == CefC_Pit_Wheel_Max) {
+		return;
+	}
+	wheel = pit_wheels[i];
+	pit_wheels[i] = NULL;
+
+	while (wheel->expired) {
+		cef_pit_entry_expiry_unlink (wheel->expired);
+	}
+	for (i = 0 ; i < CefC_Pit_Wheel_Slot_Num ; i++) {
+		while (wheel->slots[i]) {
+			wheel->slots[i]->wheel = NULL;
+			cef_pit_entry_expiry_unlink (wheel->slots[i]);
+		}
+	}
+	free (wheel);
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Takes out a PIT entry whose expiry time has passed
+----------------------------------------------------------------------------------------*/
+CefT_Pit_Entry* 							/* a PIT entry, or NULL if none				*/
+cef_pit_expired_entry_get (
+	CefT_Hash_Handle pit,					/* PIT										*/
+	uint64_t now							/* current time (usec) 						*/
+) {
+	CefT_Pit_Wheel* wheel;
+	CefT_Pit_Entry* entry;
+	CefT_Pit_Entry* next;
+	uint64_t now_tick;
+
+	wheel = cef_pit_wheel_get (pit);
+	if (wheel == NULL) {
+		return (NULL);
+	}
+	now_tick = now / CefC_Pit_Wheel_Tick;
+
+	while (wheel->expired == NULL) {
+		if (wheel->cur_tick >= now_tick) {
+			return (NULL);
+		}
+		/* After a long stall, each slot is visited only once 	*/
+		if (now_tick - wheel->cur_tick > CefC_Pit_Wheel_Slot_Num) {
+			wheel->cur_tick = now_tick - CefC_Pit_Wheel_Slot_Num;
+		}
+		wheel->cur_tick++;
+
+		/* Entries which expire in a later round stay in the slot 	*/
+		entry = wheel->slots[wheel->cur_tick % CefC_Pit_Wheel_Slot_Num];
+		while (entry) {
+			next = entry->tw_next;
+			if ((entry->expire_us + CefC_Pit_Wheel_Tick - 1) / CefC_Pit_Wheel_Tick
+					<= wheel->cur_tick) {
+				cef_pit_entry_expiry_unlink (entry);
+				entry->tw_next = wheel->expired;
+				if (wheel->expired) {
+					wheel->expired->tw_pprev = &(entry->tw_next);
+				}
+				entry->tw_pprev = &(wheel->expired);
+				wheel->expired = entry;
+				wheel->entry_num++;
+			}
+			entry = next;
+		}
+	}
+	entry = wheel->expired;
+	cef_pit_entry_expiry_unlink (entry);
+
+	return (entry);
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the time when cef_pit_expired_entry_get has to be called next
+----------------------------------------------------------------------------------------*/
+uint64_t									/* time (usec), or UINT64_MAX if the wheel 	*/
+											/* has no entries 							*/
+cef_pit_wheel_next_get (
+	CefT_Hash_Handle pit					/* PIT										*/
+) {
+	CefT_Pit_Wheel* wheel;
+
+	wheel = cef_pit_wheel_get (pit);
+	if ((wheel == NULL) || (wheel->entry_num == 0)) {
+		return (UINT64_MAX);
+	}
+	if (wheel->expired) {
+		return (0);
+	}
+	/* The next slot is visited when the time reaches its tick 	*/
+	return ((wheel->cur_tick + 1) * CefC_Pit_Wheel_Tick);
+}
+/*--------------------------------------------------------------------------------------
+	Recalculates the expiry time of the PIT entry and puts it into the wheel
+----------------------------------------------------------------------------------------*/
+void
+cef_pit_entry_expiry_update (
+	CefT_Pit_Entry* entry 					/* PIT entry 								*/
+) {
+	CefT_Down_Faces* dnface;
+	uint64_t expire_us;
+
+	/* The same conditions as cef_pit_clean and the caller which frees 		*/
+	/* the entry after drp_lifetime_us 										*/
+	if (entry->dnfaces.next) {
+		expire_us = UINT64_MAX;
+		dnface = entry->dnfaces.next;
+		while (dnface) {
+			if (dnface->lifetime_us < expire_us) {
+				expire_us = dnface->lifetime_us;
+			}
+			dnface = dnface->next;
+		}
+		if (expire_us < entry->clean_us) {
+			expire_us = entry->clean_us;
+		}
+		if (expire_us > entry->adv_lifetime_us) {
+			expire_us = entry->adv_lifetime_us;
+		}
+	} else {
+		expire_us = entry->drp_lifetime_us;
+	}
+	cef_pit_entry_expiry_set (entry, expire_us + 1);
+
+	return;
+}
 /*--------------------------------------------------------------------------------------
 	Looks up and creates the specified Down Face entry
 ----------------------------------------------------------------------------------------*/
@@ -1523,7 +1773,7 @@ cef_pit_symbolic_pit_check (
 	fprintf (stderr, "%s IN\n", __func__ );
 #endif
 	/* Searches a PIT entry 	*/
-	entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_get (pit, pm->name, pm->name_len);
+	entry = cef_pit_item_get (pit, pm, pm->name, pm->name_len);
 
 	if ( entry == NULL ) {
 #ifdef	__INTEREST__
@@ -1571,7 +1821,7 @@ cef_pit_entry_search_with_chunk (
 #endif // CefC_Debug
 
 	/* Searches a PIT entry 	*/
-	entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_get (pit, pm->name, pm->name_len);
+	entry = cef_pit_item_get (pit, pm, pm->name, pm->name_len);
 	now = cef_client_present_timeus_get ();
 
 	if (entry != NULL) {
@@ -1646,7 +1896,7 @@ cef_pit_entry_search_without_chunk (
 	if (pm->chunk_num_f) {
 		uint16_t name_len_wo_chunk;
 		name_len_wo_chunk = tmp_name_len - (CefC_S_Type + CefC_S_Length + CefC_S_ChunkNum);
-		entry = (CefT_Pit_Entry*) cef_lhash_tbl_item_get (pit, pm->name, name_len_wo_chunk);
+		entry = cef_pit_item_get (pit, pm, pm->name, name_len_wo_chunk);
 
 		if (entry != NULL) {
 			if (entry->longlife_f) {
@@ -1771,4 +2021,107 @@ cef_pit_entry_unlock (
 #endif	// CefC_PitEntryMutex
 	return;
 }
+/*--------------------------------------------------------------------------------------
+	Obtains the expiry wheel of the specified PIT
+----------------------------------------------------------------------------------------*/
+static CefT_Pit_Wheel*
+cef_pit_wheel_get (
+	CefT_Hash_Handle pit					/* PIT										*/
+) {
+	int i;
 
+	for (i = 0 ; i < CefC_Pit_Wheel_Max ; i++) {
+		if ((pit_wheels[i]) && (pit_wheels[i]->pit == pit)) {
+			return (pit_wheels[i]);
+		}
+	}
+	return (NULL);
+}
+/*--------------------------------------------------------------------------------------
+	Puts the PIT entry into the slot of the expiry time
+----------------------------------------------------------------------------------------*/
+static void
+cef_pit_entry_expiry_set (
+	CefT_Pit_Entry* entry, 					/* PIT entry 								*/
+	uint64_t expire_us						/* time to visit the entry (usec)			*/
+) {
+	CefT_Pit_Wheel* wheel = entry->wheel;
+	CefT_Pit_Entry** slot;
+	uint64_t tick;
+
+	if (wheel == NULL) {
+		return;
+	}
+	cef_pit_entry_expiry_unlink (entry);
+
+	/* The slot is visited when the tick has passed the expiry time 	*/
+	tick = (expire_us + CefC_Pit_Wheel_Tick - 1) / CefC_Pit_Wheel_Tick;
+	if (tick <= wheel->cur_tick) {
+		tick = wheel->cur_tick + 1;
+	}
+	entry->expire_us = expire_us;
+
+	slot = &(wheel->slots[tick % CefC_Pit_Wheel_Slot_Num]);
+	entry->tw_next = *slot;
+	if (*slot) {
+		(*slot)->tw_pprev = &(entry->tw_next);
+	}
+	entry->tw_pprev = slot;
+	*slot = entry;
+	wheel->entry_num++;
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Takes the PIT entry out of the expiry wheel
+----------------------------------------------------------------------------------------*/
+static void
+cef_pit_entry_expiry_unlink (
+	CefT_Pit_Entry* entry 					/* PIT entry 								*/
+) {
+	if (entry->tw_pprev == NULL) {
+		return;
+	}
+	if (entry->wheel) {
+		entry->wheel->entry_num--;
+	}
+	*(entry->tw_pprev) = entry->tw_next;
+	if (entry->tw_next) {
+		entry->tw_next->tw_pprev = entry->tw_pprev;
+	}
+	entry->tw_next  = NULL;
+	entry->tw_pprev = NULL;
+
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the hash value of the name in the PIT
+----------------------------------------------------------------------------------------*/
+static uint32_t
+cef_pit_name_hashv_get (
+	CefT_Hash_Handle pit,					/* PIT										*/
+	CefT_CcnMsg_MsgBdy* pm, 				/* Parsed CEFORE message					*/
+	const unsigned char* name,				/* Name										*/
+	uint16_t name_len						/* Length of Name							*/
+) {
+	uint32_t hashv;
+
+	/* The prefixes of the name of the message are hashed once in the parse 	*/
+	if (cef_frame_name_desc_hashv_get (pm, name, name_len, &hashv)) {
+		return (hashv);
+	}
+	return (cef_lhash_tbl_hashv_get (pit, name, name_len));
+}
+/*--------------------------------------------------------------------------------------
+	Searches the PIT entry of the name
+----------------------------------------------------------------------------------------*/
+static CefT_Pit_Entry*
+cef_pit_item_get (
+	CefT_Hash_Handle pit,					/* PIT										*/
+	CefT_CcnMsg_MsgBdy* pm, 				/* Parsed CEFORE message					*/
+	const unsigned char* name,				/* Name										*/
+	uint16_t name_len						/* Length of Name							*/
+) {
+	return ((CefT_Pit_Entry*) cef_lhash_tbl_item_get_hashv (
+				pit, name, name_len, cef_pit_name_hashv_get (pit, pm, name, name_len)));
+}
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cef_publish.c
+ */
+
+#define __CEF_PUBLISH_SOURECE__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include <cefore/cef_publish.h>
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define CefC_Publish_Cob_Buff_Size	(CefC_Max_Length * 2)
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+
+/*--------------------------------------------------------------------------------------
+	Creates the Content Object of the slot
+----------------------------------------------------------------------------------------*/
+static void
+cef_publish_slot_frame (
+	CefT_Publish* pp,						/* pipeline 								*/
+	CefT_CcnMsg_MsgBdy* params,				/* parameters of the worker 				*/
+	CefT_Publish_Slot* slot					/* slot of the chunk 						*/
+);
+/*--------------------------------------------------------------------------------------
+	Thread to frame and sign the chunks
+----------------------------------------------------------------------------------------*/
+static void*
+cef_publish_worker_thread (
+	void* arg								/* pipeline 								*/
+);
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+/*--------------------------------------------------------------------------------------
+	Creates the publishing pipeline. The Content Objects are created from opt and
+	params with the payload, chunk number and end chunk number of each chunk. If
+	worker_num is 1 or less, the chunks are framed in the caller's thread.
+----------------------------------------------------------------------------------------*/
+CefT_Publish* 								/* Created pipeline 						*/
+cef_publish_create (
+	CefT_CcnMsg_OptHdr* opt,				/* parameters to Option Header(s)			*/
+	CefT_CcnMsg_MsgBdy* params,				/* parameters to create the Content Objects	*/
+	int worker_num,							/* number of the workers 					*/
+	uint32_t que_size						/* number of the slots (0: default) 		*/
+) {
+	CefT_Publish* pp;
+	unsigned char* area;
+	uint32_t i;
+
+	if (worker_num < 1) {
+		worker_num = 1;
+	}
+	if (worker_num > CefC_Publish_Worker_Max) {
+		worker_num = CefC_Publish_Worker_Max;
+	}
+	if (que_size == 0) {
+		que_size = worker_num * CefC_Publish_Que_Per_Worker;
+	}
+	if (que_size < CefC_Publish_Que_Min) {
+		que_size = CefC_Publish_Que_Min;
+	}
+
+	pp = (CefT_Publish*) calloc (1, sizeof (CefT_Publish));
+	if (pp == NULL) {
+		return (NULL);
+	}
+	pp->opt 		= *opt;
+	pp->worker_num 	= worker_num;
+	pp->que_size 	= que_size;
+	pp->end_chunk_num_f = params->end_chunk_num_f;
+	pp->end_chunk_num 	= params->end_chunk_num;
+
+	/* Each worker frames the chunks with its own copy of the parameters 	*/
+	pp->params = (CefT_CcnMsg_MsgBdy*) malloc (sizeof (CefT_CcnMsg_MsgBdy) * worker_num);
+	pp->slots  = (CefT_Publish_Slot*) calloc (que_size, sizeof (CefT_Publish_Slot));
+	area = (unsigned char*) malloc (
+				(size_t) que_size * (CefC_Max_Length + CefC_Publish_Cob_Buff_Size));
+	if ((pp->params == NULL) || (pp->slots == NULL) || (area == NULL)) {
+		free (area);
+		cef_publish_destroy (pp);
+		return (NULL);
+	}
+	for (i = 0 ; i < worker_num ; i++) {
+		memcpy (&pp->params[i], params, sizeof (CefT_CcnMsg_MsgBdy));
+	}
+	for (i = 0 ; i < que_size ; i++) {
+		pp->slots[i].payload = area;
+		area += CefC_Max_Length;
+		pp->slots[i].cob = area;
+		area += CefC_Publish_Cob_Buff_Size;
+	}
+	if (worker_num == 1) {
+		return (pp);
+	}
+
+	pp->workers = (pthread_t*) calloc (worker_num, sizeof (pthread_t));
+	if (pp->workers == NULL) {
+		cef_publish_destroy (pp);
+		return (NULL);
+	}
+	pthread_mutex_init (&pp->mutex, NULL);
+	pthread_cond_init (&pp->work_cond, NULL);
+	pthread_cond_init (&pp->done_cond, NULL);
+	pp->running_f = 1;
+
+	for (i = 0 ; i < worker_num ; i++) {
+		if (pthread_create (&pp->workers[i], NULL, cef_publish_worker_thread, pp) != 0) {
+			/* Only the started workers are joined 		*/
+			pp->worker_num = i;
+			cef_publish_destroy (pp);
+			return (NULL);
+		}
+	}
+
+	return (pp);
+}
+/*--------------------------------------------------------------------------------------
+	Stops the workers and destroys the pipeline
+----------------------------------------------------------------------------------------*/
+void
+cef_publish_destroy (
+	CefT_Publish* pp						/* pipeline 								*/
+) {
+	int i;
+
+	if (pp == NULL) {
+		return;
+	}
+	if (pp->running_f) {
+		pthread_mutex_lock (&pp->mutex);
+		pp->running_f = 0;
+		pthread_cond_broadcast (&pp->work_cond);
+		pthread_mutex_unlock (&pp->mutex);
+
+		for (i = 0 ; i < pp->worker_num ; i++) {
+			pthread_join (pp->workers[i], NULL);
+		}
+		pthread_cond_destroy (&pp->work_cond);
+		pthread_cond_destroy (&pp->done_cond);
+		pthread_mutex_destroy (&pp->mutex);
+	}
+	if (pp->slots) {
+		free (pp->slots[0].payload);
+		free (pp->slots);
+	}
+	free (pp->workers);
+	free (pp->params);
+	free (pp);
+}
+/*--------------------------------------------------------------------------------------
+	Returns the number of the chunks which can be put without waiting
+----------------------------------------------------------------------------------------*/
+uint32_t
+cef_publish_space_get (
+	CefT_Publish* pp						/* pipeline 								*/
+) {
+	/* put_seq and get_seq are updated only by the caller 	*/
+	return (pp->que_size - (uint32_t)(pp->put_seq - pp->get_seq));
+}
+/*--------------------------------------------------------------------------------------
+	Puts the chunk to the pipeline. The end chunk number of the parameters is used
+	unless end_f is set.
+----------------------------------------------------------------------------------------*/
+int											/* -1 if all the slots are in use 			*/
+cef_publish_block_put (
+	CefT_Publish* pp,						/* pipeline 								*/
+	const unsigned char* payload,			/* payload of the chunk 					*/
+	uint16_t payload_len,					/* length of the payload 					*/
+	uint32_t chunk_num,						/* chunk number 							*/
+	int end_f								/* 1 if the chunk is the last chunk 		*/
+) {
+	CefT_Publish_Slot* slot;
+
+	if (pp->put_seq - pp->get_seq >= pp->que_size) {
+		return (-1);
+	}
+
+	/* The slot is not visible to the workers until put_seq is updated 	*/
+	slot = &pp->slots[pp->put_seq % pp->que_size];
+	memcpy (slot->payload, payload, payload_len);
+	slot->payload_len 	= payload_len;
+	slot->chunk_num 	= chunk_num;
+	slot->end_f 		= end_f;
+	slot->done_f 		= 0;
+
+	if (pp->workers == NULL) {
+		cef_publish_slot_frame (pp, &pp->params[0], slot);
+		slot->done_f = 1;
+		pp->put_seq++;
+		return (0);
+	}
+
+	pthread_mutex_lock (&pp->mutex);
+	pp->put_seq++;
+	pthread_cond_signal (&pp->work_cond);
+	pthread_mutex_unlock (&pp->mutex);
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Returns the next Content Object in order. Waits until it is created. The
+	Content Object stays in the pipeline until cef_publish_cob_release is called.
+----------------------------------------------------------------------------------------*/
+int											/* length of the Content Object, 0 if no 	*/
+											/* chunk is in the pipeline, or the negative*/
+											/* value of cef_frame_object_create 		*/
+cef_publish_cob_get (
+	CefT_Publish* pp,						/* pipeline 								*/
+	unsigned char** cob,					/* Content Object 							*/
+	uint16_t* payload_len,					/* length of the payload 					*/
+	uint32_t* chunk_num						/* chunk number 							*/
+) {
+	CefT_Publish_Slot* slot;
+
+	if (pp->get_seq == pp->put_seq) {
+		return (0);
+	}
+	slot = &pp->slots[pp->get_seq % pp->que_size];
+
+	if (pp->workers) {
+		pthread_mutex_lock (&pp->mutex);
+		while (slot->done_f == 0) {
+			pthread_cond_wait (&pp->done_cond, &pp->mutex);
+		}
+		pthread_mutex_unlock (&pp->mutex);
+	}
+
+	*cob 		 = slot->cob;
+	*payload_len = slot->payload_len;
+	*chunk_num 	 = slot->chunk_num;
+
+	return (slot->cob_len);
+}
+/*--------------------------------------------------------------------------------------
+	Releases the Content Object returned by cef_publish_cob_get
+----------------------------------------------------------------------------------------*/
+void
+cef_publish_cob_release (
+	CefT_Publish* pp						/* pipeline 								*/
+) {
+	if (pp->get_seq != pp->put_seq) {
+		pp->get_seq++;
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Creates the Content Object of the slot
+----------------------------------------------------------------------------------------*/
+static void
+cef_publish_slot_frame (
+	CefT_Publish* pp,						/* pipeline 								*/
+	CefT_CcnMsg_MsgBdy* params,				/* parameters of the worker 				*/
+	CefT_Publish_Slot* slot					/* slot of the chunk 						*/
+) {
+	params->payload 	= slot->payload;
+	params->payload_len = slot->payload_len;
+	params->chunk_num 	= slot->chunk_num;
+
+	if (slot->end_f) {
+		params->end_chunk_num_f = 1;
+		params->end_chunk_num 	= slot->chunk_num;
+	} else {
+		params->end_chunk_num_f = pp->end_chunk_num_f;
+		params->end_chunk_num 	= pp->end_chunk_num;
+	}
+	slot->cob_len = cef_frame_object_create (slot->cob, &pp->opt, params);
+}
+/*--------------------------------------------------------------------------------------
+	Thread to frame and sign the chunks
+----------------------------------------------------------------------------------------*/
+static void*
+cef_publish_worker_thread (
+	void* arg								/* pipeline 								*/
+) {
+	CefT_Publish* pp = (CefT_Publish*) arg;
+	CefT_CcnMsg_MsgBdy* params;
+	CefT_Publish_Slot* slot;
+
+	pthread_mutex_lock (&pp->mutex);
+	params = &pp->params[pp->worker_idx];
+	pp->worker_idx++;
+
+	while (1) {
+		while (pp->running_f && (pp->work_seq == pp->put_seq)) {
+			pthread_cond_wait (&pp->work_cond, &pp->mutex);
+		}
+		if (pp->running_f == 0) {
+			break;
+		}
+		slot = &pp->slots[pp->work_seq % pp->que_size];
+		pp->work_seq++;
+		pthread_mutex_unlock (&pp->mutex);
+
+		/* Frames and signs the chunk without the lock 	*/
+		cef_publish_slot_frame (pp, params, slot);
+
+		pthread_mutex_lock (&pp->mutex);
+		slot->done_f = 1;
+		pthread_cond_signal (&pp->done_cond);
+	}
+	pthread_mutex_unlock (&pp->mutex);
+
+	return (NULL);
+}
@@ -42,8 +42,6 @@
  Macros
  ****************************************************************************************/
 
-#define cef_mpool_mutex_lock		pthread_mutex_lock
-#define cef_mpool_mutex_unlock		pthread_mutex_unlock
 
 /****************************************************************************************
  Structures Declaration
@@ -59,6 +57,15 @@
  Static Function Declaration
  ****************************************************************************************/
 
+/*--------------------------------------------------------------------------------------
+	Allocates Ring Queue
+----------------------------------------------------------------------------------------*/
+static CefT_Rngque* 						/* Created Ring Queue Information 			*/
+cef_rngque_alloc (
+	int capacity,							/* Capacity of Ring queue 					*/
+	int type								/* CefC_Rngque_Type_Xxx 					*/
+);
+
 /****************************************************************************************
  ****************************************************************************************/
 
@@ -69,33 +76,17 @@ CefT_Rngque* 								/* Created Ring Queue Information 			*/
 cef_rngque_create (
 	int capacity							/* Capacity of Ring queue 					*/
 ) {
-	int p;
-	CefT_Rngque* qp;
-
-	/* Obtains the capacity of index queue 		*/
-	if (capacity < 32) {
-		capacity = 32;
-	}
-	if (capacity > 65536) {
-		capacity = 65536;
-	}
-	capacity--;
-
-	for (p = 0 ; capacity != 0 ; capacity >>= 1) {
-		p = (p << 1) + 1;
-	}
-	capacity = p + 1;
-
-	/* Allocates the index queue 			*/
-	qp = (CefT_Rngque*) malloc (sizeof (CefT_Rngque));
-	qp->top = 0;
-	qp->bottom = 0;
-	qp->mask = capacity - 1;
-	qp->que = (CefT_Rngque_Elem*) malloc (sizeof (CefT_Rngque_Elem) * capacity);
-	
-	pthread_mutex_init (&qp->mutex, NULL);
+	return (cef_rngque_alloc (capacity, CefC_Rngque_Type_Mpsc));
+}
 
-	return (qp);
+/*--------------------------------------------------------------------------------------
+	Creates the ring queue which only one thread pushes to
+----------------------------------------------------------------------------------------*/
+CefT_Rngque* 								/* Created Ring Queue Information 			*/
+cef_rngque_create_spsc (
+	int capacity							/* Capacity of Ring queue 					*/
+) {
+	return (cef_rngque_alloc (capacity, CefC_Rngque_Type_Spsc));
 }
 
 /*--------------------------------------------------------------------------------------
@@ -105,7 +96,6 @@ void
 cef_rngque_destroy (
 	CefT_Rngque* qp							/* Ring Queue Information 					*/
 ) {
-	pthread_mutex_destroy (&qp->mutex);
 	free (qp->que);
 	free (qp);
 }
@@ -117,14 +107,10 @@ void*										/* item which is removed from queue 		*/
 cef_rngque_pop (
 	CefT_Rngque* qp							/* Ring Queue Information 					*/
 ) {
-	int value;
-
-	if (qp->bottom != qp->top) {
-		cef_mpool_mutex_lock (&qp->mutex);
-		value = qp->top;
-		qp->top = (qp->top + 1) & qp->mask;
-		cef_mpool_mutex_unlock (&qp->mutex);
-		return (qp->que[value].body);
+	void* item;
+
+	if (cef_rngque_pop_bulk (qp, &item, 1) == 1) {
+		return (item);
 	}
 
 	return (NULL);
@@ -133,21 +119,106 @@ cef_rngque_pop (
 /*--------------------------------------------------------------------------------------
 	Inserts the value (int) to the bottom of Ring Queue
 ----------------------------------------------------------------------------------------*/
-int
+int											/* 1 if the item was pushed, 0 if full 		*/
 cef_rngque_push (
 	CefT_Rngque* qp, 						/* Ring Queue Information 					*/
 	void* item
 ) {
+	return (cef_rngque_push_bulk (qp, &item, 1));
+}
+
+/*--------------------------------------------------------------------------------------
+	Inserts the items to the bottom of Ring Queue
+----------------------------------------------------------------------------------------*/
+int											/* Number of the pushed items 				*/
+cef_rngque_push_bulk (
+	CefT_Rngque* qp, 						/* Ring Queue Information 					*/
+	void** items,							/* items to push 							*/
+	int num									/* number of the items 						*/
+) {
+	uint32_t pos;
+	uint32_t top;
+	uint32_t room;
+	int i;
+
+	if (num < 1) {
+		return (0);
+	}
+	pos = atomic_load_explicit (&qp->bottom, memory_order_relaxed);
 
-	if (((qp->bottom + 1) & qp->mask) != qp->top) {
-		cef_mpool_mutex_lock (&qp->mutex);
-		qp->que[qp->bottom].body = item;
-		qp->bottom = (qp->bottom + 1) & qp->mask;
-		cef_mpool_mutex_unlock (&qp->mutex);
-		return (1);
+	do {
+		/* The consumer moves top after it has taken the item, so the slots 	*/
+		/* before top are free 													*/
+		top  = atomic_load_explicit (&qp->top, memory_order_acquire);
+		room = (qp->mask + 1) - (pos - top);
+		if (room == 0) {
+			return (0);
+		}
+		if ((uint32_t) num > room) {
+			num = (int) room;
+		}
+		if (qp->type == CefC_Rngque_Type_Spsc) {
+			break;
+		}
+		/* Reserves the slots against the other producers 	*/
+	} while (!atomic_compare_exchange_weak_explicit (
+				&qp->bottom, &pos, pos + num,
+				memory_order_relaxed, memory_order_relaxed));
+
+	for (i = 0 ; i < num ; i++) {
+		qp->que[(pos + i) & qp->mask].body = items[i];
+	}
+
+	if (qp->type == CefC_Rngque_Type_Spsc) {
+		atomic_store_explicit (&qp->bottom, pos + num, memory_order_release);
+	} else {
+		/* Each slot is published to the consumer by its own sequence, since 	*/
+		/* the producers fill their slots in any order 							*/
+		for (i = 0 ; i < num ; i++) {
+			atomic_store_explicit (&qp->que[(pos + i) & qp->mask].seq,
+				pos + i + 1, memory_order_release);
+		}
 	}
 
-	return (0);
+	return (num);
+}
+
+/*--------------------------------------------------------------------------------------
+	Removes up to num items from the top of Ring Queue
+----------------------------------------------------------------------------------------*/
+int											/* Number of the removed items 				*/
+cef_rngque_pop_bulk (
+	CefT_Rngque* qp, 						/* Ring Queue Information 					*/
+	void** items,							/* buffer to set the items 					*/
+	int num									/* size of the buffer 						*/
+) {
+	uint32_t pos;
+	uint32_t bottom;
+	int n = 0;
+
+	pos = atomic_load_explicit (&qp->top, memory_order_relaxed);
+
+	if (qp->type == CefC_Rngque_Type_Spsc) {
+		bottom = atomic_load_explicit (&qp->bottom, memory_order_acquire);
+		while ((n < num) && (pos + n != bottom)) {
+			items[n] = qp->que[(pos + n) & qp->mask].body;
+			n++;
+		}
+	} else {
+		while ((n < num) &&
+			(atomic_load_explicit (&qp->que[(pos + n) & qp->mask].seq,
+				memory_order_acquire) == pos + n + 1)) {
+			items[n] = qp->que[(pos + n) & qp->mask].body;
+			n++;
+		}
+	}
+
+	if (n > 0) {
+		/* The slots can be reused by the producers as soon as top moves 	*/
+		atomic_store_explicit (&qp->top, pos + n, memory_order_release);
+	}
+
+	return (n);
 }
 
 /*--------------------------------------------------------------------------------------
@@ -157,14 +228,65 @@ void*										/* item which is removed from queue 		*/
 cef_rngque_read (
 	CefT_Rngque* qp							/* Ring Queue Information 					*/
 ) {
-	int value;
+	uint32_t pos;
+
+	pos = atomic_load_explicit (&qp->top, memory_order_relaxed);
 
-	if (qp->bottom != qp->top) {
-		cef_mpool_mutex_lock (&qp->mutex);
-		value = qp->top;
-		cef_mpool_mutex_unlock (&qp->mutex);
-		return (qp->que[value].body);
+	if (qp->type == CefC_Rngque_Type_Spsc) {
+		if (atomic_load_explicit (&qp->bottom, memory_order_acquire) == pos) {
+			return (NULL);
+		}
+	} else {
+		if (atomic_load_explicit (&qp->que[pos & qp->mask].seq,
+				memory_order_acquire) != pos + 1) {
+			return (NULL);
+		}
 	}
 
-	return (NULL);
+	return (qp->que[pos & qp->mask].body);
+}
+
+/*--------------------------------------------------------------------------------------
+	Allocates Ring Queue
+----------------------------------------------------------------------------------------*/
+static CefT_Rngque* 						/* Created Ring Queue Information 			*/
+cef_rngque_alloc (
+	int capacity,							/* Capacity of Ring queue 					*/
+	int type								/* CefC_Rngque_Type_Xxx 					*/
+) {
+	CefT_Rngque* qp;
+	uint32_t size;
+	uint32_t i;
+
+	/* Obtains the capacity of index queue 		*/
+	if (capacity < CefC_Rngque_Capacity_Min) {
+		capacity = CefC_Rngque_Capacity_Min;
+	}
+	if (capacity > CefC_Rngque_Capacity_Max) {
+		capacity = CefC_Rngque_Capacity_Max;
+	}
+	for (size = 1 ; size < (uint32_t) capacity ; size <<= 1) {
+		;
+	}
+
+	/* Allocates the index queue 			*/
+	qp = (CefT_Rngque*) malloc (sizeof (CefT_Rngque));
+	if (qp == NULL) {
+		return (NULL);
+	}
+	qp->que = (CefT_Rngque_Elem*) malloc (sizeof (CefT_Rngque_Elem) * size);
+	if (qp->que == NULL) {
+		free (qp);
+		return (NULL);
+	}
+	for (i = 0 ; i < size ; i++) {
+		atomic_init (&qp->que[i].seq, 0);
+		qp->que[i].body = NULL;
+	}
+	atomic_init (&qp->top, 0);
+	atomic_init (&qp->bottom, 0);
+	qp->mask = size - 1;
+	qp->type = type;
+
+	return (qp);
 }
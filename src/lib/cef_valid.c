@@ -52,10 +52,18 @@
 #include <cefore/cef_valid.h>
 #include <cefore/cef_hash.h>
 
+#if (defined(__x86_64__) && defined(__GNUC__))
+#define CefC_Crc32_Clmul
+#include <immintrin.h>
+#endif // __x86_64__ && __GNUC__
+
 /****************************************************************************************
  Macros
  ****************************************************************************************/
 
+#define CefC_Crc32_Clmul_Min		64		/* Min length to use the carry-less multiply	*/
+#define CefC_Valid_Cache_Size		4096	/* Entries of the cache of the verdicts 		*/
+
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
@@ -75,11 +83,24 @@ typedef struct {
 
 } CefT_Keys;
 
+/* Verdict of RSA-SHA256 validation. The key is the SHA256 of the signed part of 	*/
+/* the message (which includes the public key) and the signature.					*/
+typedef struct {
+
+	unsigned char 	key[SHA256_DIGEST_LENGTH];
+	int 			res;
+	uint8_t 		used_f;
+	uint8_t 		lock;					/* spin lock, the entry is touched briefly	*/
+
+} CefT_Valid_Cache;
+
 /****************************************************************************************
  State Variables
  ****************************************************************************************/
 
-static uint32_t 			crc_table[256];
+static uint32_t 			crc_table[8][256];	/* tables for slicing-by-8				*/
+static uint32_t (*crc_fold_calc)(const unsigned char*, size_t, uint32_t) = NULL;
+												/* folds 16 byte blocks, or NULL		*/
 static CefT_Hash_Handle		key_table;
 static CefT_Keys* 			default_key_entry = NULL;
 static char					ccninfo_sha256_prvkey_path[PATH_MAX*2];
@@ -88,15 +109,26 @@ unsigned char* 				ccninfo_sha256_pub_key_bi;
 int 						ccninfo_sha256_pub_key_bi_len;
 RSA*  						ccninfo_sha256_pub_key;
 RSA*  						ccninfo_sha256_prv_key;
+static CefT_Valid_Cache		valid_cache[CefC_Valid_Cache_Size];
 
 /****************************************************************************************
  Static Function Declaration
  ****************************************************************************************/
 
-static void
-cef_valid_crc_init (
-	void
+static uint32_t
+cef_valid_crc32_slice8 (
+	const unsigned char* buf,
+	size_t len,
+	uint32_t c
+);
+#ifdef CefC_Crc32_Clmul
+static uint32_t
+cef_valid_crc32_clmul (
+	const unsigned char* buf,
+	size_t len,
+	uint32_t c
 );
+#endif // CefC_Crc32_Clmul
 static int
 cef_valid_conf_value_get (
 	const char* p,
@@ -191,6 +223,25 @@ cef_valid_rsa_sha256_hby_verify (
 	uint16_t alg_offset, 			/* offset of T_VALIDATION_ALG 						*/
 	uint16_t pld_offset		 		/* offset of T_VALIDATION_PAYLOAD 					*/
 );
+static int 							/* 1: found, 0: no validation, -1: invalid 			*/
+cef_valid_msg_tlvs_get (
+	const unsigned char* msg,
+	int msg_len,
+	uint16_t* pkt_len, 				/* PacketLength 									*/
+	uint16_t* hdr_len, 				/* HeaderLength (offset of CCN Message)				*/
+	uint16_t* alg_type, 			/* type of the validation algorithm 				*/
+	uint16_t* alg_offset, 			/* offset of T_VALIDATION_ALG 						*/
+	uint16_t* pld_offset		 	/* offset of T_VALIDATION_PAYLOAD 					*/
+);
+static int 							/* verdict, or -1 if it is not cached 				*/
+cef_valid_cache_get (
+	const unsigned char* key
+);
+static void
+cef_valid_cache_set (
+	const unsigned char* key,
+	int res
+);
 
 /****************************************************************************************
  ****************************************************************************************/
@@ -270,11 +321,15 @@ cef_valid_crc32_calc (
 	size_t len
 ) {
 	uint32_t c = 0xFFFFFFFF;
-	size_t i;
+	size_t n;
 
-	for (i = 0 ; i < len ; i++) {
-		c = crc_table[(c ^ buf[i]) & 0xFF] ^ (c >> 8);
+	if ((crc_fold_calc) && (len >= CefC_Crc32_Clmul_Min)) {
+		n = len & ~((size_t) 15);
+		c = (*crc_fold_calc)(buf, n, c);
+		buf += n;
+		len -= n;
 	}
+	c = cef_valid_crc32_slice8 (buf, len, c);
 
 	return (c ^ 0xFFFFFFFF);
 }
@@ -416,64 +471,18 @@ cef_valid_msg_verify (
 	int msg_len
 ) {
 	int res = -1;
-	struct fixed_hdr* 	fixed_hp;
-	struct tlv_hdr* 	tlv_ptr;
-
-	uint16_t 	index;
 	uint16_t 	pkt_len;
 	uint16_t 	hdr_len;
-	uint16_t 	val_len;
-	uint16_t 	type, alg_type;
+	uint16_t 	alg_type;
 	uint16_t 	alg_offset = 0;
 	uint16_t 	pld_offset = 0;
 
-	/* Obtains header length and packet length 		*/
-	fixed_hp = (struct fixed_hdr*) msg;
-	pkt_len  = ntohs (fixed_hp->pkt_len);
-	if (pkt_len != msg_len) {
-		return (-1);
-	}
-	hdr_len = fixed_hp->hdr_len;
-
-	/* Obtains CCN message size 		*/
-	tlv_ptr = (struct tlv_hdr*) &msg[hdr_len];
-	val_len = ntohs (tlv_ptr->length);
-	if (hdr_len + CefC_S_TLF + val_len == pkt_len) {
-		return (0);
-	}
-	index = hdr_len + CefC_S_TLF + val_len;
-
-	/* Checks Validation Algorithm TLVs 	*/
-	alg_offset = index;
-	tlv_ptr = (struct tlv_hdr*) &msg[alg_offset];
-	type = ntohs (tlv_ptr->type);
-	if (type != CefC_T_VALIDATION_ALG) {
-		return (-1);
-	}
-
-	val_len = ntohs (tlv_ptr->length);
-	if (index + CefC_S_TLF + val_len >= pkt_len) {
-		return (-1);
-	}
-	index += CefC_S_TLF;
-
-	/* Checks Algorithm Type 		*/
-	tlv_ptr = (struct tlv_hdr*) &msg[index];
-	alg_type = ntohs (tlv_ptr->type);
-	index += val_len;
-
-	/* Checks Validation Payload TLVs 	*/
-	pld_offset = index;
-	tlv_ptr = (struct tlv_hdr*) &msg[pld_offset];
-	type = ntohs (tlv_ptr->type);
-	if (type != CefC_T_VALIDATION_PAYLOAD) {
-		return (-1);
-	}
-
-	val_len = ntohs (tlv_ptr->length);
-	if (index + CefC_S_TLF + val_len > pkt_len) {
-		return (-1);
+	res = cef_valid_msg_tlvs_get (
+			msg, msg_len, &pkt_len, &hdr_len, &alg_type, &alg_offset, &pld_offset);
+	if (res < 1) {
+		return (res);
 	}
+	res = -1;
 
 	switch (alg_type) {
 		case CefC_T_CRC32C: {
@@ -494,6 +503,25 @@ cef_valid_msg_verify (
 	return (res);
 }
 
+int 								/* type of the validation algorithm, or 			*/
+									/* CefC_T_ALG_INVALID 								*/
+cef_valid_msg_alg_get (
+	const unsigned char* msg,
+	int msg_len
+) {
+	uint16_t 	pkt_len;
+	uint16_t 	hdr_len;
+	uint16_t 	alg_type;
+	uint16_t 	alg_offset;
+	uint16_t 	pld_offset;
+
+	if (cef_valid_msg_tlvs_get (
+			msg, msg_len, &pkt_len, &hdr_len, &alg_type, &alg_offset, &pld_offset) < 1) {
+		return (CefC_T_ALG_INVALID);
+	}
+	return (alg_type);
+}
+
 int
 cef_valid_keyid_create_forccninfo (
 	unsigned char* pubkey,
@@ -849,16 +877,32 @@ cef_valid_rsa_sha256_std_verify (
 	uint16_t 			index;
 	uint16_t 			length;
 	unsigned char 		hash[SHA256_DIGEST_LENGTH];
+	unsigned char 		cache_key[SHA256_DIGEST_LENGTH];
+	SHA256_CTX 			ctx;
+	SHA256_CTX 			sig_ctx;
 	int 				res;
 	unsigned char* 		pub_key_bi;
 	int 				pub_key_bi_len;
 	RSA*  				pub_key;
 
-	/* Obtains the Name 		*/
-	index = hdr_len + CefC_S_TLF;
-	tlv_ptr = (struct tlv_hdr*) &msg[index];
+	/* Obtains the Validation Payload 		*/
+	tlv_ptr = (struct tlv_hdr*) &msg[pld_offset];
 	length = ntohs (tlv_ptr->length);
-	index += CefC_S_TLF;
+	index = pld_offset + CefC_S_TLF;
+
+	/* Hashes the signed part, and then the signature for the cache 	*/
+	SHA256_Init (&ctx);
+	SHA256_Update (&ctx, &msg[hdr_len], pld_offset - hdr_len);
+	sig_ctx = ctx;
+	SHA256_Final (hash, &ctx);
+	SHA256_Update (&sig_ctx, &msg[index], length);
+	SHA256_Final (cache_key, &sig_ctx);
+
+	/* Retransmitted or cached messages have been verified 	*/
+	res = cef_valid_cache_get (cache_key);
+	if (res >= 0) {
+		return (res);
+	}
 
 	/* Obtains the Public Key		 		*/
 	{
@@ -891,14 +935,10 @@ cef_valid_rsa_sha256_std_verify (
 			return (1);
 		}
 	}
-	/* Obtains the Validation Payload 		*/
-	tlv_ptr = (struct tlv_hdr*) &msg[pld_offset];
-	length = ntohs (tlv_ptr->length);
-	index = pld_offset + CefC_S_TLF;
 
 	/* Verification the sign 				*/
-	SHA256 (&msg[hdr_len], pld_offset - hdr_len, hash);
-
+	tlv_ptr = (struct tlv_hdr*) &msg[pld_offset];
+	length = ntohs (tlv_ptr->length);
 	res = RSA_verify (
 		NID_sha256, hash, SHA256_DIGEST_LENGTH, &msg[index], length, pub_key);
 	RSA_free (pub_key);
@@ -908,7 +948,10 @@ cef_valid_rsa_sha256_std_verify (
 		"[SHA256] validation is %s\n", (res == 1) ? "OK" : "NG");
 #endif // CefC_Debug
 
-	return ((res == 1) ? 0 : 1);
+	res = (res == 1) ? 0 : 1;
+	cef_valid_cache_set (cache_key, res);
+
+	return (res);
 }
 static int 							/* If the return value is 0 the code is equal, 		*/
 									/* otherwise the code is different. 				*/
@@ -924,6 +967,116 @@ cef_valid_rsa_sha256_hby_verify (
 	return (0);
 }
 
+static int 							/* 1: found, 0: no validation, -1: invalid 			*/
+cef_valid_msg_tlvs_get (
+	const unsigned char* msg,
+	int msg_len,
+	uint16_t* pkt_len, 				/* PacketLength 									*/
+	uint16_t* hdr_len, 				/* HeaderLength (offset of CCN Message)				*/
+	uint16_t* alg_type, 			/* type of the validation algorithm 				*/
+	uint16_t* alg_offset, 			/* offset of T_VALIDATION_ALG 						*/
+	uint16_t* pld_offset		 	/* offset of T_VALIDATION_PAYLOAD 					*/
+) {
+	struct fixed_hdr* 	fixed_hp;
+	struct tlv_hdr* 	tlv_ptr;
+	uint16_t 	index;
+	uint16_t 	val_len;
+	uint16_t 	type;
+
+	/* Obtains header length and packet length 		*/
+	fixed_hp = (struct fixed_hdr*) msg;
+	*pkt_len = ntohs (fixed_hp->pkt_len);
+	if (*pkt_len != msg_len) {
+		return (-1);
+	}
+	*hdr_len = fixed_hp->hdr_len;
+
+	/* Obtains CCN message size 		*/
+	tlv_ptr = (struct tlv_hdr*) &msg[*hdr_len];
+	val_len = ntohs (tlv_ptr->length);
+	if (*hdr_len + CefC_S_TLF + val_len == *pkt_len) {
+		return (0);
+	}
+	index = *hdr_len + CefC_S_TLF + val_len;
+
+	/* Checks Validation Algorithm TLVs 	*/
+	*alg_offset = index;
+	tlv_ptr = (struct tlv_hdr*) &msg[*alg_offset];
+	type = ntohs (tlv_ptr->type);
+	if (type != CefC_T_VALIDATION_ALG) {
+		return (-1);
+	}
+
+	val_len = ntohs (tlv_ptr->length);
+	if (index + CefC_S_TLF + val_len >= *pkt_len) {
+		return (-1);
+	}
+	index += CefC_S_TLF;
+
+	/* Checks Algorithm Type 		*/
+	tlv_ptr = (struct tlv_hdr*) &msg[index];
+	*alg_type = ntohs (tlv_ptr->type);
+	index += val_len;
+
+	/* Checks Validation Payload TLVs 	*/
+	*pld_offset = index;
+	tlv_ptr = (struct tlv_hdr*) &msg[*pld_offset];
+	type = ntohs (tlv_ptr->type);
+	if (type != CefC_T_VALIDATION_PAYLOAD) {
+		return (-1);
+	}
+
+	val_len = ntohs (tlv_ptr->length);
+	if (index + CefC_S_TLF + val_len > *pkt_len) {
+		return (-1);
+	}
+
+	return (1);
+}
+
+static int 							/* verdict, or -1 if it is not cached 				*/
+cef_valid_cache_get (
+	const unsigned char* key
+) {
+	CefT_Valid_Cache* ent;
+	uint32_t index;
+	int res = -1;
+
+	memcpy (&index, key, sizeof (index));
+	ent = &valid_cache[index % CefC_Valid_Cache_Size];
+
+	while (__atomic_test_and_set (&ent->lock, __ATOMIC_ACQUIRE)) {
+		/* NOP */;
+	}
+	if ((ent->used_f) && (memcmp (ent->key, key, SHA256_DIGEST_LENGTH) == 0)) {
+		res = ent->res;
+	}
+	__atomic_clear (&ent->lock, __ATOMIC_RELEASE);
+
+	return (res);
+}
+
+static void
+cef_valid_cache_set (
+	const unsigned char* key,
+	int res
+) {
+	CefT_Valid_Cache* ent;
+	uint32_t index;
+
+	memcpy (&index, key, sizeof (index));
+	ent = &valid_cache[index % CefC_Valid_Cache_Size];
+
+	/* The entry which has the same index is replaced 	*/
+	while (__atomic_test_and_set (&ent->lock, __ATOMIC_ACQUIRE)) {
+		/* NOP */;
+	}
+	memcpy (ent->key, key, SHA256_DIGEST_LENGTH);
+	ent->res = res;
+	ent->used_f = 1;
+	__atomic_clear (&ent->lock, __ATOMIC_RELEASE);
+}
+
 static CefT_Keys*
 cef_valid_key_entry_search (
 	const unsigned char* name,
@@ -1361,7 +1514,11 @@ cef_valid_sha256_keypass_ccninfoRT(
 	return (0);
 }
 
-static void
+/*--------------------------------------------------------------------------------------
+	Builds the CRC32 tables and selects the carry-less multiply path if the CPU
+	has it
+----------------------------------------------------------------------------------------*/
+void
 cef_valid_crc_init (
 	void
 ) {
@@ -1373,9 +1530,165 @@ cef_valid_crc_init (
 		for (j = 0 ; j < 8 ; j++) {
 			c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
 		}
-		crc_table[i] = c;
+		crc_table[0][i] = c;
+	}
+	/* crc_table[j][i] is the CRC of the byte i followed by j zero bytes 	*/
+	for (i = 0 ; i < 256 ; i++) {
+		c = crc_table[0][i];
+		for (j = 1 ; j < 8 ; j++) {
+			c = crc_table[0][c & 0xFF] ^ (c >> 8);
+			crc_table[j][i] = c;
+		}
 	}
+
+#ifdef CefC_Crc32_Clmul
+	__builtin_cpu_init ();
+#endif // CefC_Crc32_Clmul
+	cef_valid_crc_clmul_set (1);
+}
+/*--------------------------------------------------------------------------------------
+	Enables or disables the carry-less multiply path of cef_valid_crc32_calc
+----------------------------------------------------------------------------------------*/
+int											/* 1 if the path is used, 0 otherwise		*/
+cef_valid_crc_clmul_set (
+	int use_f
+) {
+	crc_fold_calc = NULL;
+#ifdef CefC_Crc32_Clmul
+	if ((use_f) &&
+		(__builtin_cpu_supports ("pclmul")) && (__builtin_cpu_supports ("sse4.1"))) {
+		crc_fold_calc = cef_valid_crc32_clmul;
+	}
+#endif // CefC_Crc32_Clmul
+	return ((crc_fold_calc != NULL) ? 1 : 0);
+}
+/*--------------------------------------------------------------------------------------
+	Calculates the CRC32 eight bytes at a time with the slicing-by-8 tables
+----------------------------------------------------------------------------------------*/
+static uint32_t
+cef_valid_crc32_slice8 (
+	const unsigned char* buf,
+	size_t len,
+	uint32_t c									/* CRC register (not inverted)			*/
+) {
+	uint32_t hi;
+
+	while (len >= 8) {
+		c ^= (uint32_t) buf[0] | ((uint32_t) buf[1] << 8) |
+			 ((uint32_t) buf[2] << 16) | ((uint32_t) buf[3] << 24);
+		hi = (uint32_t) buf[4] | ((uint32_t) buf[5] << 8) |
+			 ((uint32_t) buf[6] << 16) | ((uint32_t) buf[7] << 24);
+		c =	crc_table[7][c & 0xFF] ^ crc_table[6][(c >> 8) & 0xFF] ^
+			crc_table[5][(c >> 16) & 0xFF] ^ crc_table[4][c >> 24] ^
+			crc_table[3][hi & 0xFF] ^ crc_table[2][(hi >> 8) & 0xFF] ^
+			crc_table[1][(hi >> 16) & 0xFF] ^ crc_table[0][hi >> 24];
+		buf += 8;
+		len -= 8;
+	}
+	while (len > 0) {
+		c = crc_table[0][(c ^ *buf) & 0xFF] ^ (c >> 8);
+		buf++;
+		len--;
+	}
+
+	return (c);
+}
+#ifdef CefC_Crc32_Clmul
+/*--------------------------------------------------------------------------------------
+	Calculates the CRC32 by folding 64 bytes at a time with the carry-less multiply,
+	and then reduces it with Barrett reduction. The constants are those of the
+	bit-reflected CRC32 polynomial in "Fast CRC Computation for Generic Polynomials
+	Using PCLMULQDQ Instruction" (Intel). len must be a multiple of 16 and at least
+	CefC_Crc32_Clmul_Min.
+----------------------------------------------------------------------------------------*/
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t
+cef_valid_crc32_clmul (
+	const unsigned char* buf,
+	size_t len,
+	uint32_t c									/* CRC register (not inverted)			*/
+) {
+	static const uint64_t k1k2[] __attribute__((aligned(16))) = { 0x0154442bd4, 0x01c6e41596 };
+	static const uint64_t k3k4[] __attribute__((aligned(16))) = { 0x01751997d0, 0x00ccaa009e };
+	static const uint64_t k5k0[] __attribute__((aligned(16))) = { 0x0163cd6124, 0x0000000000 };
+	static const uint64_t poly[] __attribute__((aligned(16))) = { 0x01db710641, 0x01f7011641 };
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+	x1 = _mm_loadu_si128 ((const __m128i*)(buf + 0x00));
+	x2 = _mm_loadu_si128 ((const __m128i*)(buf + 0x10));
+	x3 = _mm_loadu_si128 ((const __m128i*)(buf + 0x20));
+	x4 = _mm_loadu_si128 ((const __m128i*)(buf + 0x30));
+	x1 = _mm_xor_si128 (x1, _mm_cvtsi32_si128 ((int) c));
+	x0 = _mm_load_si128 ((const __m128i*) k1k2);
+	buf += 64;
+	len -= 64;
+
+	/* Folds 4 blocks of 16 bytes in parallel 	*/
+	while (len >= 64) {
+		x5 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128 (x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128 (x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128 (x4, x0, 0x00);
+		x1 = _mm_clmulepi64_si128 (x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128 (x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128 (x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128 (x4, x0, 0x11);
+		y5 = _mm_loadu_si128 ((const __m128i*)(buf + 0x00));
+		y6 = _mm_loadu_si128 ((const __m128i*)(buf + 0x10));
+		y7 = _mm_loadu_si128 ((const __m128i*)(buf + 0x20));
+		y8 = _mm_loadu_si128 ((const __m128i*)(buf + 0x30));
+		x1 = _mm_xor_si128 (_mm_xor_si128 (x1, x5), y5);
+		x2 = _mm_xor_si128 (_mm_xor_si128 (x2, x6), y6);
+		x3 = _mm_xor_si128 (_mm_xor_si128 (x3, x7), y7);
+		x4 = _mm_xor_si128 (_mm_xor_si128 (x4, x8), y8);
+		buf += 64;
+		len -= 64;
+	}
+
+	/* Folds the 4 blocks into one 	*/
+	x0 = _mm_load_si128 ((const __m128i*) k3k4);
+	x5 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128 (x1, x0, 0x11);
+	x1 = _mm_xor_si128 (_mm_xor_si128 (x1, x2), x5);
+	x5 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128 (x1, x0, 0x11);
+	x1 = _mm_xor_si128 (_mm_xor_si128 (x1, x3), x5);
+	x5 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128 (x1, x0, 0x11);
+	x1 = _mm_xor_si128 (_mm_xor_si128 (x1, x4), x5);
+
+	/* Folds the remaining blocks of 16 bytes 	*/
+	while (len >= 16) {
+		x2 = _mm_loadu_si128 ((const __m128i*) buf);
+		x5 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128 (x1, x0, 0x11);
+		x1 = _mm_xor_si128 (_mm_xor_si128 (x1, x2), x5);
+		buf += 16;
+		len -= 16;
+	}
+
+	/* Folds 128 bits into 64 bits 	*/
+	x2 = _mm_clmulepi64_si128 (x1, x0, 0x10);
+	x3 = _mm_setr_epi32 (~0, 0, ~0, 0);
+	x1 = _mm_srli_si128 (x1, 8);
+	x1 = _mm_xor_si128 (x1, x2);
+	x0 = _mm_loadl_epi64 ((const __m128i*) k5k0);
+	x2 = _mm_srli_si128 (x1, 4);
+	x1 = _mm_and_si128 (x1, x3);
+	x1 = _mm_clmulepi64_si128 (x1, x0, 0x00);
+	x1 = _mm_xor_si128 (x1, x2);
+
+	/* Barrett reduction to 32 bits 	*/
+	x0 = _mm_load_si128 ((const __m128i*) poly);
+	x2 = _mm_and_si128 (x1, x3);
+	x2 = _mm_clmulepi64_si128 (x2, x0, 0x10);
+	x2 = _mm_and_si128 (x2, x3);
+	x2 = _mm_clmulepi64_si128 (x2, x0, 0x00);
+	x1 = _mm_xor_si128 (x1, x2);
+
+	return ((uint32_t) _mm_extract_epi32 (x1, 1));
 }
+#endif // CefC_Crc32_Clmul
 
 static int
 cef_valid_conf_value_get (
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cefbench_crc.c
+ */
+
+/*
+	cefbench_crc checks that cef_valid_crc32_calc gives the same CRC32 as the
+	byte-wise table, which Cefore used before, for every length from 0 to
+	3000 bytes at eight offsets and for larger messages, with and without the
+	carry-less multiply path. It then measures the throughput of the three
+	calculations for the payload sizes. It returns 1 if a result differs.
+*/
+
+#define __CEFBENCH_CRC_SOURCE__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <cefore/cef_define.h>
+#include <cefore/cef_valid.h>
+
+
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define CefbC_Default_Sizes			"1024,2048,4096,8192"
+#define CefbC_Default_Bytes			(1ULL << 30)	/* bytes per measurement 		*/
+#define CefbC_Check_Len_Max			3000
+#define CefbC_Check_Offsets			8
+#define CefbC_Max_Size				(1 << 20)
+#define CefbC_Max_Sizes				16
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+static uint32_t ref_table[256];				/* table of the byte-wise calculation 	*/
+static volatile uint32_t sink = 0;			/* keeps the results alive 				*/
+
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+);
+/*--------------------------------------------------------------------------------------
+	Calculates the CRC32 a byte at a time
+----------------------------------------------------------------------------------------*/
+static uint32_t
+cefb_crc32_ref (
+	const unsigned char* buf,
+	size_t len
+);
+/*--------------------------------------------------------------------------------------
+	Compares cef_valid_crc32_calc with the byte-wise calculation
+----------------------------------------------------------------------------------------*/
+static int									/* 0: all results matched, -1: differed 	*/
+cefb_crc_check (
+	const unsigned char* buf,
+	const char* path
+);
+/*--------------------------------------------------------------------------------------
+	Measures the throughput (GB/s) of a calculation for the size
+----------------------------------------------------------------------------------------*/
+static double
+cefb_crc_measure (
+	const unsigned char* buf,
+	size_t size,
+	uint64_t bytes,
+	int ref_f
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+);
+
+
+/****************************************************************************************
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+) {
+	char sizes_str[256] = CefbC_Default_Sizes;
+	int sizes[CefbC_Max_Sizes];
+	int size_num = 0;
+	uint64_t bytes = CefbC_Default_Bytes;
+	unsigned char* buf;
+	double ref_gbps, slice_gbps, clmul_gbps;
+	int clmul_f;
+	char* tok;
+	char* save = NULL;
+	uint32_t i, c;
+	int opt;
+	int res = 0;
+	int n;
+
+	while ((opt = getopt (argc, argv, "s:n:")) != -1) {
+		switch (opt) {
+			case 's': {
+				snprintf (sizes_str, sizeof (sizes_str), "%s", optarg);
+				break;
+			}
+			case 'n': {
+				bytes = strtoull (optarg, NULL, 10) << 20;
+				break;
+			}
+			default: {
+				print_usage ();
+				return (1);
+			}
+		}
+	}
+	for (tok = strtok_r (sizes_str, ",", &save) ; tok && size_num < CefbC_Max_Sizes
+			; tok = strtok_r (NULL, ",", &save)) {
+		sizes[size_num] = atoi (tok);
+		if ((sizes[size_num] < 1) || (sizes[size_num] > CefbC_Max_Size)) {
+			print_usage ();
+			return (1);
+		}
+		size_num++;
+	}
+	if ((size_num == 0) || (bytes == 0)) {
+		print_usage ();
+		return (1);
+	}
+
+	for (i = 0 ; i < 256 ; i++) {
+		c = i;
+		for (n = 0 ; n < 8 ; n++) {
+			c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+		}
+		ref_table[i] = c;
+	}
+	buf = (unsigned char*) malloc (CefbC_Max_Size + CefbC_Check_Offsets);
+	if (buf == NULL) {
+		fprintf (stderr, "cefbench_crc: no memory\n");
+		return (1);
+	}
+	srand (1);
+	for (i = 0 ; i < CefbC_Max_Size + CefbC_Check_Offsets ; i++) {
+		buf[i] = (unsigned char) rand ();
+	}
+	cef_valid_crc_init ();
+
+	/* Identity with the byte-wise calculation 	*/
+	cef_valid_crc_clmul_set (0);
+	res |= cefb_crc_check (buf, "slicing-by-8");
+	clmul_f = cef_valid_crc_clmul_set (1);
+	if (clmul_f) {
+		res |= cefb_crc_check (buf, "carry-less multiply");
+	} else {
+		fprintf (stdout, "carry-less multiply : not supported by the CPU\n");
+	}
+
+	/* Throughput 		*/
+	fprintf (stdout, "%8s %12s %14s %12s\n", "Size(B)", "table(GB/s)", "slice8(GB/s)",
+		"clmul(GB/s)");
+	for (n = 0 ; n < size_num ; n++) {
+		ref_gbps = cefb_crc_measure (buf, sizes[n], bytes / 8, 1);
+		cef_valid_crc_clmul_set (0);
+		slice_gbps = cefb_crc_measure (buf, sizes[n], bytes, 0);
+		clmul_gbps = 0.0;
+		if (clmul_f) {
+			cef_valid_crc_clmul_set (1);
+			clmul_gbps = cefb_crc_measure (buf, sizes[n], bytes, 0);
+		}
+		fprintf (stdout, "%8d %12.2f %14.2f %12.2f\n",
+			sizes[n], ref_gbps, slice_gbps, clmul_gbps);
+	}
+	cef_valid_crc_clmul_set (1);
+
+	free (buf);
+	return ((res < 0) ? 1 : 0);
+}
+/*--------------------------------------------------------------------------------------
+	Calculates the CRC32 a byte at a time
+----------------------------------------------------------------------------------------*/
+static uint32_t
+cefb_crc32_ref (
+	const unsigned char* buf,
+	size_t len
+) {
+	uint32_t c = 0xFFFFFFFF;
+	size_t i;
+
+	for (i = 0 ; i < len ; i++) {
+		c = ref_table[(c ^ buf[i]) & 0xFF] ^ (c >> 8);
+	}
+	return (c ^ 0xFFFFFFFF);
+}
+/*--------------------------------------------------------------------------------------
+	Compares cef_valid_crc32_calc with the byte-wise calculation
+----------------------------------------------------------------------------------------*/
+static int									/* 0: all results matched, -1: differed 	*/
+cefb_crc_check (
+	const unsigned char* buf,
+	const char* path
+) {
+	static const size_t large[] = {4096, 8192, 9000, 65536, 65551, CefbC_Max_Size};
+	uint64_t checked = 0;
+	size_t len;
+	int offs;
+	int i;
+
+	for (offs = 0 ; offs < CefbC_Check_Offsets ; offs++) {
+		for (len = 0 ; len <= CefbC_Check_Len_Max ; len++) {
+			if (cef_valid_crc32_calc (&buf[offs], len) != cefb_crc32_ref (&buf[offs], len)) {
+				fprintf (stderr, "cefbench_crc: %s differs at offset %d, length %zu\n",
+					path, offs, len);
+				return (-1);
+			}
+			checked++;
+		}
+		for (i = 0 ; i < (int)(sizeof (large) / sizeof (large[0])) ; i++) {
+			if (cef_valid_crc32_calc (&buf[offs], large[i]) !=
+					cefb_crc32_ref (&buf[offs], large[i])) {
+				fprintf (stderr, "cefbench_crc: %s differs at offset %d, length %zu\n",
+					path, offs, large[i]);
+				return (-1);
+			}
+			checked++;
+		}
+	}
+	/* The check value of CRC32 		*/
+	if (cef_valid_crc32_calc ((const unsigned char*) "123456789", 9) != 0xCBF43926) {
+		fprintf (stderr, "cefbench_crc: %s gives a wrong check value\n", path);
+		return (-1);
+	}
+	fprintf (stdout, "%s : %llu lengths and offsets matched\n",
+		path, (unsigned long long) checked);
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Measures the throughput (GB/s) of a calculation for the size
+----------------------------------------------------------------------------------------*/
+static double
+cefb_crc_measure (
+	const unsigned char* buf,
+	size_t size,
+	uint64_t bytes,
+	int ref_f
+) {
+	uint64_t loops = bytes / size + 1;
+	uint64_t start, spent;
+	uint64_t i;
+	uint32_t acc = 0;
+
+	start = cefb_now_ns ();
+	for (i = 0 ; i < loops ; i++) {
+		if (ref_f) {
+			acc ^= cefb_crc32_ref (buf, size);
+		} else {
+			acc ^= cef_valid_crc32_calc (buf, size);
+		}
+	}
+	spent = cefb_now_ns () - start;
+	sink = acc;
+
+	return ((double)(loops * size) / (double)(spent + 1));
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+) {
+	struct timespec ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+) {
+	fprintf (stderr,
+		"\nUsage: cefbench_crc\n\n"
+		"  cefbench_crc [-s size[,size...]] [-n MB]\n\n"
+		"  -s  Comma-separated payload sizes (Bytes) to measure.\n"
+		"      The default value is 1024,2048,4096,8192.\n"
+		"  -n  Megabytes calculated per measurement. The default value is 1024.\n\n"
+	);
+	return;
+}
@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cefbench_fib.c
+ */
+
+/*
+	cefbench_fib fills a FIB with many routes of several prefix lengths and
+	measures the longest prefix match of names with more components. It
+	measures cef_fib_entry_search, cef_fib_entry_search_with_desc with the
+	name descriptor created as cef_frame_message_parse does, and the walk
+	that the FIB used before (probe the name, drop the last component, probe
+	again). A part of the names matches no route, which is the worst case.
+	The routes found are compared with the routes the names were made from.
+*/
+
+#define __CEFBENCH_FIB_SOURCE__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <arpa/inet.h>
+
+#include <cefore/cef_define.h>
+#include <cefore/cef_frame.h>
+#include <cefore/cef_hash.h>
+#include <cefore/cef_fib.h>
+
+
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define CefbC_Default_Routes		1000000
+#define CefbC_Default_Comps			8
+#define CefbC_Default_Prefixes		"2,3,4,5,6"
+#define CefbC_Default_Names			262144
+#define CefbC_Default_Count			4000000
+#define CefbC_Default_Miss			10			/* names matching no route (%) 			*/
+#define CefbC_Max_Prefixes			16
+#define CefbC_Max_Comps				32
+#define CefbC_Name_Max				512
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+typedef struct {
+	unsigned char 		name[CefbC_Name_Max];
+	uint16_t 			name_len;
+	uint16_t 			match_len;			/* length of the route, 0 if none 		*/
+} CefbT_Name;
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+static int plens[CefbC_Max_Prefixes];		/* components of the routes 			*/
+static int plen_num = 0;
+
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+);
+/*--------------------------------------------------------------------------------------
+	Creates the name of the route with comps components
+----------------------------------------------------------------------------------------*/
+static int									/* length of the name, or -1 				*/
+cefb_name_create (
+	uint32_t route,
+	int comps,
+	int plen,
+	int miss_f,
+	unsigned char* name,
+	uint16_t* match_len
+);
+/*--------------------------------------------------------------------------------------
+	Searches the FIB the way cef_fib_entry_search did before the prefix lengths
+	were indexed
+----------------------------------------------------------------------------------------*/
+static CefT_Fib_Entry*
+cefb_fib_walk_search (
+	CefT_Hash_Handle fib,
+	unsigned char* name,
+	uint16_t name_len
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+);
+
+
+/****************************************************************************************
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+) {
+	char plens_str[256] = CefbC_Default_Prefixes;
+	uint32_t routes = CefbC_Default_Routes;
+	int comps = CefbC_Default_Comps;
+	int name_num = CefbC_Default_Names;
+	uint64_t count = CefbC_Default_Count;
+	int miss = CefbC_Default_Miss;
+	CefT_Hash_Handle fib;
+	CefT_CcnMsg_MsgBdy* pm;
+	CefbT_Name* names;
+	CefT_Fib_Entry* entry;
+	unsigned char name[CefbC_Name_Max];
+	uint16_t match_len;
+	uint64_t start, spent[3];
+	uint64_t c;
+	uint32_t r;
+	char* tok;
+	char* save = NULL;
+	int len;
+	int opt;
+	int idx;
+	int err = 0;
+	int m, i;
+
+	while ((opt = getopt (argc, argv, "r:c:p:k:n:m:")) != -1) {
+		switch (opt) {
+			case 'r': {
+				routes = (uint32_t) strtoul (optarg, NULL, 10);
+				break;
+			}
+			case 'c': {
+				comps = atoi (optarg);
+				break;
+			}
+			case 'p': {
+				snprintf (plens_str, sizeof (plens_str), "%s", optarg);
+				break;
+			}
+			case 'k': {
+				name_num = atoi (optarg);
+				break;
+			}
+			case 'n': {
+				count = strtoull (optarg, NULL, 10);
+				break;
+			}
+			case 'm': {
+				miss = atoi (optarg);
+				break;
+			}
+			default: {
+				print_usage ();
+				return (1);
+			}
+		}
+	}
+	if ((comps < 2) || (comps > CefbC_Max_Comps)) {
+		print_usage ();
+		return (1);
+	}
+	for (tok = strtok_r (plens_str, ",", &save) ; tok && plen_num < CefbC_Max_Prefixes
+			; tok = strtok_r (NULL, ",", &save)) {
+		plens[plen_num] = atoi (tok);
+		if ((plens[plen_num] < 2) || (plens[plen_num] > comps)) {
+			print_usage ();
+			return (1);
+		}
+		plen_num++;
+	}
+	if ((routes < 1) || (plen_num == 0) || (name_num < 1) || (count < 1) ||
+		(miss < 0) || (miss > 100)) {
+		print_usage ();
+		return (1);
+	}
+
+	/* Creates the FIB as cefnetd does 	*/
+	fib = cef_hash_tbl_create_ext (routes, CefC_Hash_Coef_FIB);
+	pm = (CefT_CcnMsg_MsgBdy*) calloc (1, sizeof (CefT_CcnMsg_MsgBdy));
+	names = (CefbT_Name*) malloc (sizeof (CefbT_Name) * name_num);
+	if ((fib == (CefT_Hash_Handle) NULL) || (pm == NULL) || (names == NULL)) {
+		fprintf (stderr, "cefbench_fib: no memory\n");
+		return (1);
+	}
+	cef_hash_tbl_resize_enable (fib);
+	cef_hash_tbl_seed_set (fib, CefC_Hash_Seed_Default);
+
+	start = cefb_now_ns ();
+	for (r = 0 ; r < routes ; r++) {
+		len = cefb_name_create (r, plens[r % plen_num], plens[r % plen_num], 0,
+				name, &match_len);
+		if ((len < 0) || (cef_fib_entry_lookup (fib, name, (uint16_t) len) == NULL)) {
+			fprintf (stderr, "cefbench_fib: route %u cannot be added\n", r);
+			return (1);
+		}
+	}
+	fprintf (stdout, "Routes : %u (%d entries), added in %.2f sec\n", routes,
+		cef_hash_tbl_item_num_get (fib), (double)(cefb_now_ns () - start) / 1e9);
+
+	/* Names of comps components under random routes 	*/
+	srand (1);
+	for (i = 0 ; i < name_num ; i++) {
+		r = (uint32_t)(((uint64_t) rand () << 16 ^ rand ()) % routes);
+		len = cefb_name_create (r, comps, plens[r % plen_num],
+				(rand () % 100) < miss, names[i].name, &names[i].match_len);
+		if (len < 0) {
+			fprintf (stderr, "cefbench_fib: the name is too long\n");
+			return (1);
+		}
+		names[i].name_len = (uint16_t) len;
+	}
+	fprintf (stdout, "Names : %d of %d components, %d%% match no route, %llu lookups\n",
+		name_num, comps, miss, (unsigned long long) count);
+
+	for (m = 0 ; m < 3 ; m++) {
+		idx = 0;
+		start = cefb_now_ns ();
+		for (c = 0 ; c < count ; c++) {
+			switch (m) {
+				case 0: {
+					entry = cef_fib_entry_search (
+								fib, names[idx].name, names[idx].name_len);
+					break;
+				}
+				case 1: {
+					/* The descriptor is created while the message is parsed 	*/
+					memcpy (pm->name, names[idx].name, names[idx].name_len);
+					pm->name_len = names[idx].name_len;
+					cef_frame_name_desc_create (pm->name, pm->name_len, &pm->name_desc);
+					entry = cef_fib_entry_search_with_desc (fib, pm, pm->name_len);
+					break;
+				}
+				default: {
+					entry = cefb_fib_walk_search (
+								fib, names[idx].name, names[idx].name_len);
+					break;
+				}
+			}
+			if (((entry == NULL) && (names[idx].match_len != 0)) ||
+				((entry != NULL) && (entry->klen != names[idx].match_len))) {
+				err++;
+			}
+			if (++idx == name_num) {
+				idx = 0;
+			}
+		}
+		spent[m] = cefb_now_ns () - start;
+	}
+
+	fprintf (stdout, "%28s %10s\n", "", "ns/lookup");
+	fprintf (stdout, "%28s %10.1f\n", "cef_fib_entry_search", (double) spent[0] / count);
+	fprintf (stdout, "%28s %10.1f\n", "with name descriptor", (double) spent[1] / count);
+	fprintf (stdout, "%28s %10.1f\n", "component walk (before)", (double) spent[2] / count);
+	if (err) {
+		fprintf (stderr, "cefbench_fib: %d lookups found a wrong route\n", err);
+		return (1);
+	}
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Creates the name of the route with comps components
+----------------------------------------------------------------------------------------*/
+static int									/* length of the name, or -1 				*/
+cefb_name_create (
+	uint32_t route,
+	int comps,
+	int plen,
+	int miss_f,
+	unsigned char* name,
+	uint16_t* match_len
+) {
+	char comp[64];
+	uint16_t tlv;
+	int len = 0;
+	int clen;
+	int i;
+
+	*match_len = 0;
+	for (i = 0 ; i < comps ; i++) {
+		if (i == 0) {
+			/* The names of a miss start with a component no route has 	*/
+			clen = snprintf (comp, sizeof (comp), miss_f ? "none" : "site%u", route % 1000);
+		} else if (i == plen - 1) {
+			clen = snprintf (comp, sizeof (comp), "route%u", route);
+		} else if (i < plen) {
+			clen = snprintf (comp, sizeof (comp), "dir%d-%u", i, (route / 1000) % 100);
+		} else {
+			clen = snprintf (comp, sizeof (comp), "obj%d", i);
+		}
+		if (len + CefC_S_TLF + clen > CefbC_Name_Max) {
+			return (-1);
+		}
+		tlv = htons (CefC_T_NAMESEGMENT);
+		memcpy (&name[len], &tlv, CefC_S_Type);
+		tlv = htons ((uint16_t) clen);
+		memcpy (&name[len + CefC_S_Type], &tlv, CefC_S_Length);
+		memcpy (&name[len + CefC_S_TLF], comp, clen);
+		len += CefC_S_TLF + clen;
+		if ((i == plen - 1) && (miss_f == 0)) {
+			*match_len = (uint16_t) len;
+		}
+	}
+	return (len);
+}
+/*--------------------------------------------------------------------------------------
+	Searches the FIB the way cef_fib_entry_search did before the prefix lengths
+	were indexed
+----------------------------------------------------------------------------------------*/
+static CefT_Fib_Entry*
+cefb_fib_walk_search (
+	CefT_Hash_Handle fib,
+	unsigned char* name,
+	uint16_t name_len
+) {
+	CefT_Fib_Entry* entry;
+	unsigned char* msp;
+	unsigned char* mep;
+	uint16_t len = name_len;
+	uint16_t length;
+
+	while (len > 0) {
+		entry = (CefT_Fib_Entry*) cef_hash_tbl_item_get (fib, name, len);
+		if (entry != NULL) {
+			return (entry);
+		}
+		msp = name;
+		mep = name + len - 1;
+		while (msp < mep) {
+			memcpy (&length, &msp[CefC_S_Length], CefC_S_Length);
+			length = ntohs (length);
+
+			if (msp + CefC_S_Type + CefC_S_Length + length < mep) {
+				msp += CefC_S_Type + CefC_S_Length + length;
+			} else {
+				break;
+			}
+		}
+		len = msp - name;
+	}
+	return (NULL);
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+) {
+	struct timespec ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+) {
+	fprintf (stderr,
+		"\nUsage: cefbench_fib\n\n"
+		"  cefbench_fib [-r routes] [-c comps] [-p comps[,comps...]] [-k names]\n"
+		"               [-n count] [-m miss]\n\n"
+		"  -r  Number of routes. The default value is 1000000.\n"
+		"  -c  Number of components of the names looked up (2 to 32).\n"
+		"      The default value is 8.\n"
+		"  -p  Comma-separated numbers of components of the routes (2 to comps).\n"
+		"      The default value is 2,3,4,5,6.\n"
+		"  -k  Number of distinct names looked up. The default value is 262144.\n"
+		"  -n  Number of lookups per search. The default value is 4000000.\n"
+		"  -m  Names matching no route (%%). The default value is 10.\n\n"
+	);
+	return;
+}
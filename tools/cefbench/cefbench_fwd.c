@@ -0,0 +1,500 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cefbench_fwd.c
+ */
+
+/*
+	cefbench_fwd replays Interest/ContentObject exchanges through a running
+	cefnetd over UDP. It plays both ends: the consumer sends Interests for
+	distinct names to cefnetd, and the producer, which cefnetd reaches
+	through a FIB entry, answers each Interest with a ContentObject. The
+	names are spread over many contents so that the forwarding workers
+	(FWD_WORKER_NUM) share the load. cefbench_fwd.sh sweeps the number of
+	workers.
+*/
+
+#define __CEFBENCH_FWD_SOURCE__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <cefore/cef_define.h>
+#include <cefore/cef_frame.h>
+
+
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define CefbC_Default_Port			9896		/* port of cefnetd 						*/
+#define CefbC_Default_Prod_Port		9900		/* port of the producer 				*/
+#define CefbC_Default_Count			1000000
+#define CefbC_Default_Window		256
+#define CefbC_Default_Contents		1024
+#define CefbC_Default_Payload		1024
+#define CefbC_Default_Uri			"ccnx:/bench"
+#define CefbC_Idle_Timeout			1000		/* stops when no Object comes (ms) 		*/
+#define CefbC_Report_Interval		1000000		/* interval of the progress (us) 		*/
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+static unsigned char prefix[CefC_Max_Length];	/* Name of the URI prefix 				*/
+static int prefix_len = 0;
+static unsigned char payload[CefC_Max_Length];
+
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+);
+/*--------------------------------------------------------------------------------------
+	Creates the non-blocking UDP socket
+----------------------------------------------------------------------------------------*/
+static int
+cefb_socket_create (
+	uint16_t port								/* port to bind (0: any)				*/
+);
+/*--------------------------------------------------------------------------------------
+	Sends the Interest of the specified sequence number
+----------------------------------------------------------------------------------------*/
+static int
+cefb_interest_send (
+	int sock,
+	struct sockaddr_in* dst,
+	uint64_t seq,
+	int contents
+);
+/*--------------------------------------------------------------------------------------
+	Answers the Interests received by the producer
+----------------------------------------------------------------------------------------*/
+static int
+cefb_producer_input (
+	int sock,
+	int payload_len
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in microseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_us (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+);
+
+
+/****************************************************************************************
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+) {
+	char host[64] = "127.0.0.1";
+	char uri[1024] = CefbC_Default_Uri;
+	int port = CefbC_Default_Port;
+	int prod_port = CefbC_Default_Prod_Port;
+	uint64_t count = CefbC_Default_Count;
+	int window = CefbC_Default_Window;
+	int contents = CefbC_Default_Contents;
+	int payload_len = CefbC_Default_Payload;
+	int opt;
+	int cons_sock;
+	int prod_sock;
+	struct sockaddr_in dst;
+	struct pollfd fds[2];
+	unsigned char buff[CefC_Max_Msg_Size];
+	uint64_t sent = 0;
+	uint64_t rcvd = 0;
+	uint64_t answered = 0;
+	uint64_t last_rcvd = 0;
+	uint64_t start_us;
+	uint64_t end_us;
+	uint64_t last_rx_us;
+	uint64_t report_us;
+	uint64_t now_us;
+	ssize_t len;
+	int res;
+
+	while ((opt = getopt (argc, argv, "h:p:l:n:w:c:s:u:")) != -1) {
+		switch (opt) {
+			case 'h': {
+				snprintf (host, sizeof (host), "%s", optarg);
+				break;
+			}
+			case 'p': {
+				port = atoi (optarg);
+				break;
+			}
+			case 'l': {
+				prod_port = atoi (optarg);
+				break;
+			}
+			case 'n': {
+				count = strtoull (optarg, NULL, 10);
+				break;
+			}
+			case 'w': {
+				window = atoi (optarg);
+				break;
+			}
+			case 'c': {
+				contents = atoi (optarg);
+				break;
+			}
+			case 's': {
+				payload_len = atoi (optarg);
+				break;
+			}
+			case 'u': {
+				snprintf (uri, sizeof (uri), "%s", optarg);
+				break;
+			}
+			default: {
+				print_usage ();
+				return (-1);
+			}
+		}
+	}
+	if ((port < 1) || (port > 65535) || (prod_port < 1) || (prod_port > 65535) ||
+		(count < 1) || (window < 1) || (contents < 1) ||
+		(payload_len < 1) || (payload_len > CefC_Max_Length / 2)) {
+		fprintf (stderr, "cefbench_fwd: [ERROR] invalid parameter.\n");
+		print_usage ();
+		return (-1);
+	}
+
+	cef_frame_init ();
+	prefix_len = cef_frame_conversion_uri_to_name (uri, prefix);
+	if (prefix_len < 0) {
+		fprintf (stderr, "cefbench_fwd: [ERROR] invalid URI (%s).\n", uri);
+		return (-1);
+	}
+	memset (payload, 'b', sizeof (payload));
+
+	memset (&dst, 0, sizeof (dst));
+	dst.sin_family = AF_INET;
+	dst.sin_port = htons ((uint16_t) port);
+	if (inet_pton (AF_INET, host, &dst.sin_addr) != 1) {
+		fprintf (stderr, "cefbench_fwd: [ERROR] invalid host (%s).\n", host);
+		return (-1);
+	}
+	cons_sock = cefb_socket_create (0);
+	prod_sock = cefb_socket_create ((uint16_t) prod_port);
+	if ((cons_sock < 0) || (prod_sock < 0)) {
+		fprintf (stderr, "cefbench_fwd: [ERROR] cannot create the sockets.\n");
+		return (-1);
+	}
+	fds[0].fd = cons_sock;
+	fds[0].events = POLLIN;
+	fds[1].fd = prod_sock;
+	fds[1].events = POLLIN;
+
+	fprintf (stderr, "cefbench_fwd: %s:%d, producer port %d, %llu Interests, "
+		"window %d, %d contents, payload %d bytes\n",
+		host, port, prod_port, (unsigned long long) count,
+		window, contents, payload_len);
+
+	start_us = cefb_now_us ();
+	last_rx_us = start_us;
+	report_us = start_us + CefbC_Report_Interval;
+
+	while (1) {
+		/* Keeps the window of outstanding Interests filled 	*/
+		while ((sent < count) && (sent - rcvd < (uint64_t) window)) {
+			if (cefb_interest_send (cons_sock, &dst, sent, contents) < 0) {
+				break;
+			}
+			sent++;
+		}
+
+		res = poll (fds, 2, 100);
+		if (res < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		if (fds[1].revents & POLLIN) {
+			answered += cefb_producer_input (prod_sock, payload_len);
+		}
+		if (fds[0].revents & POLLIN) {
+			while ((len = recv (cons_sock, buff, sizeof (buff), 0)) > 0) {
+				if (buff[CefC_O_Fix_Type] == CefC_PT_OBJECT) {
+					rcvd++;
+				}
+			}
+		}
+
+		now_us = cefb_now_us ();
+		if (rcvd != last_rcvd) {
+			last_rcvd = rcvd;
+			last_rx_us = now_us;
+		}
+		if (rcvd >= count) {
+			break;
+		}
+		if (now_us - last_rx_us > CefbC_Idle_Timeout * 1000) {
+			if (sent >= count) {
+				break;
+			}
+			/* The outstanding Interests are regarded as lost 	*/
+			fprintf (stderr, "cefbench_fwd: %llu Interests lost\n",
+				(unsigned long long)(sent - rcvd));
+			count -= sent - rcvd;
+			sent = rcvd;
+			last_rx_us = now_us;
+		}
+		if (now_us > report_us) {
+			fprintf (stderr, "cefbench_fwd: %llu Objects\n", (unsigned long long) rcvd);
+			report_us = now_us + CefbC_Report_Interval;
+		}
+	}
+	end_us = (rcvd >= count) ? cefb_now_us () : last_rx_us;
+
+	fprintf (stdout, "Interests sent     : %llu\n", (unsigned long long) sent);
+	fprintf (stdout, "Interests answered : %llu\n", (unsigned long long) answered);
+	fprintf (stdout, "Objects received   : %llu\n", (unsigned long long) rcvd);
+	fprintf (stdout, "Duration           : %.3f sec\n", (end_us - start_us) / 1000000.0);
+	fprintf (stdout, "Exchanges/sec      : %.0f\n",
+		(end_us > start_us) ? rcvd * 1000000.0 / (end_us - start_us) : 0.0);
+
+	close (cons_sock);
+	close (prod_sock);
+
+	return ((rcvd > 0) ? 0 : 1);
+}
+/*--------------------------------------------------------------------------------------
+	Creates the non-blocking UDP socket
+----------------------------------------------------------------------------------------*/
+static int
+cefb_socket_create (
+	uint16_t port								/* port to bind (0: any)				*/
+) {
+	struct sockaddr_in addr;
+	int sock;
+	int size = 4 * 1024 * 1024;
+
+	sock = socket (AF_INET, SOCK_DGRAM, 0);
+	if (sock < 0) {
+		return (-1);
+	}
+	setsockopt (sock, SOL_SOCKET, SO_RCVBUF, &size, sizeof (size));
+	setsockopt (sock, SOL_SOCKET, SO_SNDBUF, &size, sizeof (size));
+	memset (&addr, 0, sizeof (addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons (port);
+	addr.sin_addr.s_addr = htonl (INADDR_ANY);
+	if (bind (sock, (struct sockaddr*) &addr, sizeof (addr)) < 0) {
+		close (sock);
+		return (-1);
+	}
+	fcntl (sock, F_SETFL, fcntl (sock, F_GETFL, 0) | O_NONBLOCK);
+
+	return (sock);
+}
+/*--------------------------------------------------------------------------------------
+	Sends the Interest of the specified sequence number
+----------------------------------------------------------------------------------------*/
+static int
+cefb_interest_send (
+	int sock,
+	struct sockaddr_in* dst,
+	uint64_t seq,
+	int contents
+) {
+	CefT_CcnMsg_OptHdr opt;
+	CefT_CcnMsg_MsgBdy tlvs;
+	unsigned char buff[CefC_Max_Length];
+	char seg[32];
+	int seg_len;
+	int len;
+
+	memset (&opt, 0, sizeof (CefT_CcnMsg_OptHdr));
+	memset (&tlvs, 0, sizeof (CefT_CcnMsg_MsgBdy));
+
+	/* Name is prefix/c<content> and chunk is the sequence in the content 	*/
+	memcpy (tlvs.name, prefix, prefix_len);
+	seg_len = snprintf (seg, sizeof (seg), "c%d", (int)(seq % contents));
+	tlvs.name[prefix_len] 		= (CefC_T_NAMESEGMENT >> 8) & 0xFF;
+	tlvs.name[prefix_len + 1] 	= CefC_T_NAMESEGMENT & 0xFF;
+	tlvs.name[prefix_len + 2] 	= (seg_len >> 8) & 0xFF;
+	tlvs.name[prefix_len + 3] 	= seg_len & 0xFF;
+	memcpy (&tlvs.name[prefix_len + 4], seg, seg_len);
+	tlvs.name_len 		= prefix_len + 4 + seg_len;
+	tlvs.chunk_num_f 	= 1;
+	tlvs.chunk_num 		= (uint32_t)(seq / contents);
+	tlvs.hoplimit 		= 32;
+	opt.lifetime_f 		= 1;
+	opt.lifetime 		= 4000;
+
+	len = cef_frame_interest_create (buff, &opt, &tlvs);
+	if (len <= 0) {
+		return (-1);
+	}
+	if (sendto (sock, buff, len, 0, (struct sockaddr*) dst, sizeof (*dst)) < 0) {
+		return (-1);
+	}
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Answers the Interests received by the producer
+----------------------------------------------------------------------------------------*/
+static int
+cefb_producer_input (
+	int sock,
+	int payload_len
+) {
+	unsigned char buff[CefC_Max_Msg_Size];
+	unsigned char cob[CefC_Max_Msg_Size];
+	struct sockaddr_storage peer;
+	socklen_t peer_len;
+	CefT_CcnMsg_OptHdr poh;
+	CefT_CcnMsg_MsgBdy pm;
+	CefT_CcnMsg_OptHdr opt;
+	CefT_CcnMsg_MsgBdy tlvs;
+	uint16_t pkt_len;
+	uint16_t header_len;
+	ssize_t len;
+	int cob_len;
+	int num = 0;
+
+	while (1) {
+		peer_len = sizeof (peer);
+		len = recvfrom (sock, buff, sizeof (buff), 0,
+				(struct sockaddr*) &peer, &peer_len);
+		if (len <= 0) {
+			break;
+		}
+		if ((len < CefC_S_Fix_Header) || (buff[CefC_O_Fix_Type] != CefC_PT_INTEREST)) {
+			continue;
+		}
+		pkt_len 	= (buff[CefC_O_Fix_PacketLength] << 8) | buff[CefC_O_Fix_PacketLength + 1];
+		header_len 	= buff[CefC_O_Fix_HeaderLength];
+		if ((pkt_len > len) || (header_len > pkt_len)) {
+			continue;
+		}
+		memset (&poh, 0, sizeof (CefT_CcnMsg_OptHdr));
+		memset (&pm, 0, sizeof (CefT_CcnMsg_MsgBdy));
+		if (cef_frame_message_parse (buff, pkt_len - header_len, header_len,
+				&poh, &pm, CefC_PT_INTEREST) < 0) {
+			continue;
+		}
+		if (pm.chunk_num_f == 0) {
+			continue;
+		}
+
+		/* Answers with the Object which has the same Name 	*/
+		memset (&opt, 0, sizeof (CefT_CcnMsg_OptHdr));
+		memset (&tlvs, 0, sizeof (CefT_CcnMsg_MsgBdy));
+		tlvs.name_len = pm.name_len - (CefC_S_Type + CefC_S_Length + CefC_S_ChunkNum);
+		memcpy (tlvs.name, pm.name, tlvs.name_len);
+		tlvs.chunk_num_f 	= 1;
+		tlvs.chunk_num 		= pm.chunk_num;
+		tlvs.payload 		= payload;
+		tlvs.payload_len 	= (uint16_t) payload_len;
+		tlvs.expiry 		= 0;
+		opt.cachetime_f 	= 0;
+
+		cob_len = cef_frame_object_create (cob, &opt, &tlvs);
+		if (cob_len > 0) {
+			sendto (sock, cob, cob_len, 0, (struct sockaddr*) &peer, peer_len);
+			num++;
+		}
+	}
+	return (num);
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in microseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_us (
+	void
+) {
+	struct timespec ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+) {
+	fprintf (stderr,
+		"\nUsage: cefbench_fwd\n\n"
+		"  cefbench_fwd [-h host] [-p port] [-l port] [-n count] [-w window]\n"
+		"               [-c contents] [-s size] [-u uri]\n\n"
+		"  -h  Address of cefnetd. The default value is 127.0.0.1.\n"
+		"  -p  Port number of cefnetd. The default value is 9896.\n"
+		"  -l  Port number of the producer which the FIB entry of uri points to.\n"
+		"      The default value is 9900.\n"
+		"  -n  Number of Interests. The default value is 1000000.\n"
+		"  -w  Number of outstanding Interests. The default value is 256.\n"
+		"  -c  Number of contents the Interests are spread over. The default\n"
+		"      value is 1024.\n"
+		"  -s  Payload size of the ContentObject. The default value is 1024.\n"
+		"  -u  URI prefix. The default value is ccnx:/bench.\n\n"
+	);
+	return;
+}
@@ -0,0 +1,101 @@
+#!/bin/bash
+#
+# Copyright (c) 2016-2023, National Institute of Information and Communications
+# Technology (NICT). All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+# 1. Redistributions of source code must retain the above copyright notice,
+#    this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+# 3. Neither the name of the NICT nor the names of its contributors may be
+#    used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+# OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+# OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+# SUCH DAMAGE.
+#
+# cefbench_fwd.sh
+#
+# Runs cefbench_fwd against cefnetd started with FWD_WORKER_NUM=1, 2, 4 and 8
+# and prints the number of Interest/ContentObject exchanges per second.
+#
+#   cefbench_fwd.sh -d config_dir [-b cefnetd] [-c cefctrl] [-w "1 2 4 8"]
+#                   [-- cefbench_fwd options]
+#
+#   config_dir  Directory which has the configuration of cefnetd (e.g.,
+#               /usr/local/cefore). It is copied and is not modified.
+#   cefnetd     Path of cefnetd. The default is cefnetd in PATH.
+#   cefctrl     Path of cefctrl which stops cefnetd. The default is cefctrl
+#               in the directory of cefnetd or in PATH.
+#
+
+conf_dir=""
+cefnetd=$(command -v cefnetd)
+cefctrl=""
+workers="1 2 4 8"
+port=9896
+prod_port=9900
+bench=$(dirname "$0")/cefbench_fwd
+
+while getopts "d:b:c:w:" opt; do
+	case $opt in
+		d) conf_dir=$OPTARG ;;
+		b) cefnetd=$OPTARG ;;
+		c) cefctrl=$OPTARG ;;
+		w) workers=$OPTARG ;;
+		*) exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+# cefctrl next to cefnetd stops it
+if [ -z "$cefctrl" ]; then
+	cefctrl=$(dirname "$cefnetd")/cefctrl
+	[ -x "$cefctrl" ] || cefctrl=$(command -v cefctrl)
+fi
+
+if [ -z "$conf_dir" ] || [ ! -f "$conf_dir/cefnetd.conf" ] || [ -z "$cefnetd" ] ||
+   [ -z "$cefctrl" ]; then
+	echo "Usage: $0 -d config_dir [-b cefnetd] [-c cefctrl] [-w \"1 2 4 8\"]" \
+		"[-- cefbench_fwd options]" >&2
+	exit 1
+fi
+
+work_dir=$(mktemp -d /tmp/cefbench_fwd.XXXXXX)
+trap 'rm -rf "$work_dir"' EXIT
+
+for n in $workers; do
+	rm -rf "$work_dir/conf"
+	cp -a "$conf_dir" "$work_dir/conf"
+	grep -v -E "^(PORT_NUM|LOCAL_SOCK_ID|FWD_WORKER_NUM|CS_MODE)=" \
+		"$conf_dir/cefnetd.conf" > "$work_dir/conf/cefnetd.conf"
+	cat >> "$work_dir/conf/cefnetd.conf" <<EOT
+PORT_NUM=$port
+LOCAL_SOCK_ID=bench
+FWD_WORKER_NUM=$n
+CS_MODE=0
+EOT
+	echo "ccnx:/bench udp 127.0.0.1:$prod_port" > "$work_dir/conf/cefnetd.fib"
+
+	"$cefnetd" -d "$work_dir/conf" > "$work_dir/cefnetd.log" 2>&1 &
+	pid=$!
+	sleep 2
+	result=$("$bench" -p $port -l $prod_port "$@" 2> "$work_dir/bench.log")
+	"$cefctrl" kill -d "$work_dir/conf" > /dev/null 2>&1
+	wait $pid 2> /dev/null
+	rate=$(echo "$result" | sed -n 's/^Exchanges\/sec *: //p')
+	echo "FWD_WORKER_NUM=$n : ${rate:-failed} exchanges/sec"
+done
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cefbench_hash.c
+ */
+
+/*
+	cefbench_hash measures the time per key of cef_hash_number_calc, which
+	the FIB, PIT and content store tables use, and of MD5, which they used
+	before. It also measures cef_hash_tbl_item_get on a table holding the
+	keys and shows how evenly the hash values fall into the slots. The keys
+	look like the names of the chunks of contents: they share the prefix
+	and differ in a few bytes.
+*/
+
+#define __CEFBENCH_HASH_SOURCE__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <openssl/md5.h>
+
+#include <cefore/cef_define.h>
+#include <cefore/cef_hash.h>
+
+
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define CefbC_Default_Keys			65536
+#define CefbC_Default_Count			10000000
+#define CefbC_Default_Lens			"16,32,48,64,128,256"
+#define CefbC_Max_Lens				16
+#define CefbC_Max_Key_Len			1024
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+static volatile uint32_t sink = 0;				/* keeps the results alive 				*/
+
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+);
+/*--------------------------------------------------------------------------------------
+	Creates the keys of the specified length
+----------------------------------------------------------------------------------------*/
+static unsigned char*
+cefb_keys_create (
+	int key_num,
+	int klen
+);
+/*--------------------------------------------------------------------------------------
+	Measures cef_hash_number_calc and MD5 and outputs the results
+----------------------------------------------------------------------------------------*/
+static int
+cefb_hash_measure (
+	int key_num,
+	int klen,
+	uint64_t count
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+);
+
+
+/****************************************************************************************
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+) {
+	char lens[256] = CefbC_Default_Lens;
+	int key_num = CefbC_Default_Keys;
+	uint64_t count = CefbC_Default_Count;
+	int klens[CefbC_Max_Lens];
+	int len_num = 0;
+	char* tok;
+	char* save = NULL;
+	int opt;
+	int i;
+
+	while ((opt = getopt (argc, argv, "k:n:l:")) != -1) {
+		switch (opt) {
+			case 'k': {
+				key_num = atoi (optarg);
+				break;
+			}
+			case 'n': {
+				count = strtoull (optarg, NULL, 10);
+				break;
+			}
+			case 'l': {
+				snprintf (lens, sizeof (lens), "%s", optarg);
+				break;
+			}
+			default: {
+				print_usage ();
+				return (1);
+			}
+		}
+	}
+	for (tok = strtok_r (lens, ",", &save) ; tok && len_num < CefbC_Max_Lens
+			; tok = strtok_r (NULL, ",", &save)) {
+		klens[len_num] = atoi (tok);
+		if ((klens[len_num] < 8) || (klens[len_num] > CefbC_Max_Key_Len)) {
+			fprintf (stderr, "cefbench_hash: key length must be 8 to %d\n",
+				CefbC_Max_Key_Len);
+			return (1);
+		}
+		len_num++;
+	}
+	if ((key_num < 1) || (count < 1) || (len_num == 0)) {
+		print_usage ();
+		return (1);
+	}
+
+	fprintf (stdout, "Keys : %d, Lookups : %llu\n", key_num, (unsigned long long) count);
+	fprintf (stdout, "%8s %12s %12s %12s %10s\n",
+		"Key(B)", "hash(ns)", "MD5(ns)", "lookup(ns)", "max/avg");
+	for (i = 0 ; i < len_num ; i++) {
+		if (cefb_hash_measure (key_num, klens[i], count) < 0) {
+			fprintf (stderr, "cefbench_hash: no memory\n");
+			return (1);
+		}
+	}
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Creates the keys of the specified length
+----------------------------------------------------------------------------------------*/
+static unsigned char*
+cefb_keys_create (
+	int key_num,
+	int klen
+) {
+	unsigned char* keys;
+	unsigned char* key;
+	int i, n;
+
+	keys = (unsigned char*) malloc ((size_t) key_num * klen);
+	if (keys == NULL) {
+		return (NULL);
+	}
+	for (i = 0 ; i < key_num ; i++) {
+		key = &keys[(size_t) i * klen];
+		/* Name segment TLVs with the common prefix filled with letters 	*/
+		key[0] = 0x00;
+		key[1] = 0x01;
+		key[2] = 0x00;
+		key[3] = (unsigned char)(klen - 4 > 255 ? 255 : klen - 4);
+		for (n = 4 ; n < klen ; n++) {
+			key[n] = (unsigned char)('a' + n % 26);
+		}
+		/* The content number and the chunk number at the end 				*/
+		key[klen - 4] = (unsigned char)(i >> 24);
+		key[klen - 3] = (unsigned char)(i >> 16);
+		key[klen - 2] = (unsigned char)(i >> 8);
+		key[klen - 1] = (unsigned char)(i);
+	}
+	return (keys);
+}
+/*--------------------------------------------------------------------------------------
+	Measures cef_hash_number_calc and MD5 and outputs the results
+----------------------------------------------------------------------------------------*/
+static int
+cefb_hash_measure (
+	int key_num,
+	int klen,
+	uint64_t count
+) {
+	unsigned char* keys;
+	unsigned char out[MD5_DIGEST_LENGTH];
+	uint32_t* bins;
+	CefT_Hash_Handle tbl;
+	uint64_t hash_ns, md5_ns, lookup_ns;
+	uint64_t md5_count;
+	uint64_t start;
+	uint64_t c;
+	uint32_t acc = 0;
+	uint32_t max = 0;
+	uint32_t hashv;
+	int idx;
+	int i;
+
+	keys = cefb_keys_create (key_num, klen);
+	bins = (uint32_t*) calloc (key_num, sizeof (uint32_t));
+	tbl = cef_hash_tbl_create ((uint32_t) key_num * 2);
+	if ((keys == NULL) || (bins == NULL) || (tbl == (CefT_Hash_Handle) NULL)) {
+		free (keys);
+		free (bins);
+		return (-1);
+	}
+
+	/* cef_hash_number_calc 		*/
+	idx = 0;
+	start = cefb_now_ns ();
+	for (c = 0 ; c < count ; c++) {
+		acc += cef_hash_number_calc (CefC_Hash_Seed_Default,
+					&keys[(size_t) idx * klen], (uint32_t) klen);
+		if (++idx == key_num) {
+			idx = 0;
+		}
+	}
+	hash_ns = cefb_now_ns () - start;
+
+	/* MD5 takes longer, so fewer keys are hashed 	*/
+	md5_count = count / 10 + 1;
+	idx = 0;
+	start = cefb_now_ns ();
+	for (c = 0 ; c < md5_count ; c++) {
+		MD5 (&keys[(size_t) idx * klen], klen, out);
+		acc += out[0];
+		if (++idx == key_num) {
+			idx = 0;
+		}
+	}
+	md5_ns = cefb_now_ns () - start;
+
+	/* Lookups of the keys in a half-full table 	*/
+	for (i = 0 ; i < key_num ; i++) {
+		cef_hash_tbl_item_set (tbl, &keys[(size_t) i * klen], (uint32_t) klen,
+			&keys[(size_t) i * klen]);
+	}
+	idx = 0;
+	start = cefb_now_ns ();
+	for (c = 0 ; c < count ; c++) {
+		if (cef_hash_tbl_item_get (tbl, &keys[(size_t) idx * klen],
+				(uint32_t) klen) != NULL) {
+			acc++;
+		}
+		if (++idx == key_num) {
+			idx = 0;
+		}
+	}
+	lookup_ns = cefb_now_ns () - start;
+	sink = acc;
+
+	/* The fullest of key_num bins relative to the average (1 per bin) 	*/
+	for (i = 0 ; i < key_num ; i++) {
+		hashv = cef_hash_number_calc (CefC_Hash_Seed_Default,
+					&keys[(size_t) i * klen], (uint32_t) klen);
+		bins[hashv % key_num]++;
+		if (bins[hashv % key_num] > max) {
+			max = bins[hashv % key_num];
+		}
+	}
+
+	fprintf (stdout, "%8d %12.2f %12.2f %12.2f %10u\n", klen,
+		(double) hash_ns / count, (double) md5_ns / md5_count,
+		(double) lookup_ns / count, max);
+
+	cef_hash_tbl_destroy (tbl);
+	free (bins);
+	free (keys);
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+) {
+	struct timespec ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+) {
+	fprintf (stderr,
+		"\nUsage: cefbench_hash\n\n"
+		"  cefbench_hash [-k keys] [-n count] [-l len[,len...]]\n\n"
+		"  -k  Number of distinct keys. The default value is 65536.\n"
+		"  -n  Number of hash calculations and lookups per key length.\n"
+		"      The default value is 10000000.\n"
+		"  -l  Comma-separated key lengths (Bytes). The default value is\n"
+		"      16,32,48,64,128,256.\n\n"
+	);
+	return;
+}
@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cefbench_hash_churn.c
+ */
+
+/*
+	cefbench_hash_churn keeps a CefT_Hash table at a high load while it
+	removes and adds keys, and checks after every round that every key is
+	found, that no removed key is found and that the index based accessors
+	visit every entry once. It outputs the longest probe distance of the
+	table (the bound of a miss) and the time per operation, with and
+	without cef_hash_tbl_resize_enable. The table without resizing rejects
+	the inserts that would exceed CefC_Hash_Probe_Max, and they are counted.
+	It returns 1 if a check fails, if the probe distance exceeds
+	CefC_Hash_Probe_Max or if the table with resizing rejects an insert.
+*/
+
+#define __CEFBENCH_HASH_CHURN_SOURCE__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <cefore/cef_define.h>
+#include <cefore/cef_hash.h>
+
+
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define CefbC_Default_Slots			10000
+#define CefbC_Default_Load			95			/* entries per slot (%) 				*/
+#define CefbC_Default_Ops			400000
+#define CefbC_Round_Ops				10000		/* operations between the checks 		*/
+#define CefbC_Key_Len				32
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+typedef struct {
+	uint32_t 		slots;
+	uint32_t 		load;
+	uint64_t 		ops;
+	uint32_t 		seed;
+} CefbT_Churn_Param;
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+);
+/*--------------------------------------------------------------------------------------
+	Runs the churn on a table and outputs the results
+----------------------------------------------------------------------------------------*/
+static int									/* 0: all checks passed, -1: failed 		*/
+cefb_churn_run (
+	const CefbT_Churn_Param* param,
+	int resize_f
+);
+/*--------------------------------------------------------------------------------------
+	Checks the lookups and the index based accessors of the table
+----------------------------------------------------------------------------------------*/
+static int
+cefb_churn_check (
+	CefT_Hash_Handle tbl,
+	const uint8_t* present,
+	uint32_t key_num,
+	uint8_t* seen
+);
+/*--------------------------------------------------------------------------------------
+	Creates the key of the specified id
+----------------------------------------------------------------------------------------*/
+static int
+cefb_key_create (
+	uint32_t id,
+	unsigned char* key
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+);
+
+
+/****************************************************************************************
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+) {
+	CefbT_Churn_Param param;
+	int opt;
+	int res;
+
+	param.slots = CefbC_Default_Slots;
+	param.load 	= CefbC_Default_Load;
+	param.ops 	= CefbC_Default_Ops;
+	param.seed 	= (uint32_t) time (NULL);
+
+	while ((opt = getopt (argc, argv, "s:l:n:r:")) != -1) {
+		switch (opt) {
+			case 's': {
+				param.slots = (uint32_t) atoi (optarg);
+				break;
+			}
+			case 'l': {
+				param.load = (uint32_t) atoi (optarg);
+				break;
+			}
+			case 'n': {
+				param.ops = strtoull (optarg, NULL, 10);
+				break;
+			}
+			case 'r': {
+				param.seed = (uint32_t) strtoul (optarg, NULL, 10);
+				break;
+			}
+			default: {
+				print_usage ();
+				return (1);
+			}
+		}
+	}
+	if ((param.slots < 16) || (param.load < 1) || (param.load > 99)) {
+		print_usage ();
+		return (1);
+	}
+
+	fprintf (stdout, "Slots : %u, Load : %u%%, Operations : %llu, Seed : %u\n",
+		param.slots, param.load, (unsigned long long) param.ops, param.seed);
+	fprintf (stdout, "%8s %10s %10s %10s %10s %10s %8s\n",
+		"resize", "entries", "table", "probe_max", "rejected", "ns/op", "result");
+
+	res  = cefb_churn_run (&param, 0);
+	res |= cefb_churn_run (&param, 1);
+
+	return ((res < 0) ? 1 : 0);
+}
+/*--------------------------------------------------------------------------------------
+	Runs the churn on a table and outputs the results
+----------------------------------------------------------------------------------------*/
+static int									/* 0: all checks passed, -1: failed 		*/
+cefb_churn_run (
+	const CefbT_Churn_Param* param,
+	int resize_f
+) {
+	CefT_Hash_Handle tbl;
+	CefT_Hash* ht;
+	unsigned char key[CefbC_Key_Len];
+	uint8_t* present;
+	uint8_t* seen;
+	uint32_t key_num;
+	uint32_t target;
+	uint32_t count = 0;
+	uint32_t probe_max = 0;
+	uint64_t rejected = 0;
+	uint32_t id;
+	uint64_t op;
+	uint64_t spent_ns = 0;
+	uint64_t start;
+	void* elem;
+	int klen;
+	int res = 0;
+
+	/* The keys are drawn from twice as many ids as the entries 		*/
+	target 	= (uint32_t)((uint64_t) param->slots * param->load / 100);
+	key_num = target * 2;
+	present = (uint8_t*) calloc (key_num, 1);
+	seen 	= (uint8_t*) calloc (key_num, 1);
+	tbl 	= cef_hash_tbl_create (param->slots);
+	if ((present == NULL) || (seen == NULL) || (tbl == (CefT_Hash_Handle) NULL)) {
+		fprintf (stderr, "cefbench_hash_churn: no memory\n");
+		free (present);
+		free (seen);
+		return (-1);
+	}
+	ht = (CefT_Hash*) tbl;
+	if (resize_f) {
+		cef_hash_tbl_resize_enable (tbl);
+	}
+	srand (param->seed);
+
+	/* Fills the table up to the load 		*/
+	for (id = 0 ; id < target ; id++) {
+		klen = cefb_key_create (id, key);
+		if (cef_hash_tbl_item_set (tbl, key, klen, (void*)(uintptr_t)(id + 1)) < 0) {
+			if (resize_f) {
+				res = -1;
+				break;
+			}
+			rejected++;
+			continue;
+		}
+		present[id] = 1;
+		count++;
+	}
+
+	/* Removes a key and adds another one in each operation 	*/
+	for (op = 0 ; (op < param->ops) && (res == 0) ; op++) {
+		start = cefb_now_ns ();
+		do {
+			id = (uint32_t) rand () % key_num;
+		} while (present[id] == 0);
+		klen = cefb_key_create (id, key);
+		elem = cef_hash_tbl_item_remove (tbl, key, klen);
+		if (elem != (void*)(uintptr_t)(id + 1)) {
+			fprintf (stderr, "cefbench_hash_churn: remove of key %u failed\n", id);
+			res = -1;
+			break;
+		}
+		present[id] = 0;
+		count--;
+
+		do {
+			id = (uint32_t) rand () % key_num;
+		} while (present[id] != 0);
+		klen = cefb_key_create (id, key);
+		if (cef_hash_tbl_item_set (tbl, key, klen, (void*)(uintptr_t)(id + 1)) < 0) {
+			/* Only the table which cannot grow may reject the insert 	*/
+			if (resize_f) {
+				fprintf (stderr, "cefbench_hash_churn: set of key %u failed\n", id);
+				res = -1;
+				break;
+			}
+			rejected++;
+		} else {
+			present[id] = 1;
+			count++;
+		}
+		spent_ns += cefb_now_ns () - start;
+
+		if (ht->probe_max > probe_max) {
+			probe_max = ht->probe_max;
+		}
+		if (probe_max > CefC_Hash_Probe_Max) {
+			fprintf (stderr, "cefbench_hash_churn: probe distance %u exceeds %d\n",
+				probe_max, CefC_Hash_Probe_Max);
+			res = -1;
+			break;
+		}
+		if ((op + 1) % CefbC_Round_Ops == 0) {
+			res = cefb_churn_check (tbl, present, key_num, seen);
+		}
+	}
+	if (res == 0) {
+		res = cefb_churn_check (tbl, present, key_num, seen);
+	}
+	if ((res == 0) && ((uint32_t) cef_hash_tbl_item_num_get (tbl) != count)) {
+		fprintf (stderr, "cefbench_hash_churn: %d entries, expected %u\n",
+			cef_hash_tbl_item_num_get (tbl), count);
+		res = -1;
+	}
+
+	fprintf (stdout, "%8s %10u %10u %10u %10llu %10.1f %8s\n",
+		resize_f ? "on" : "off", count, ht->elem_max, probe_max,
+		(unsigned long long) rejected,
+		(double) spent_ns / (param->ops ? param->ops * 2 : 1),
+		(res == 0) ? "OK" : "NG");
+
+	cef_hash_tbl_destroy (tbl);
+	free (present);
+	free (seen);
+	return (res);
+}
+/*--------------------------------------------------------------------------------------
+	Checks the lookups and the index based accessors of the table
+----------------------------------------------------------------------------------------*/
+static int
+cefb_churn_check (
+	CefT_Hash_Handle tbl,
+	const uint8_t* present,
+	uint32_t key_num,
+	uint8_t* seen
+) {
+	unsigned char key[CefbC_Key_Len];
+	uint32_t index = 0;
+	uint32_t id;
+	void* elem;
+	int klen;
+
+	for (id = 0 ; id < key_num ; id++) {
+		klen = cefb_key_create (id, key);
+		elem = cef_hash_tbl_item_get (tbl, key, klen);
+		if ((present[id]) && (elem != (void*)(uintptr_t)(id + 1))) {
+			fprintf (stderr, "cefbench_hash_churn: key %u is not found\n", id);
+			return (-1);
+		}
+		if ((present[id] == 0) && (elem != NULL)) {
+			fprintf (stderr, "cefbench_hash_churn: removed key %u is found\n", id);
+			return (-1);
+		}
+	}
+
+	memset (seen, 0, key_num);
+	while ((elem = cef_hash_tbl_item_check_from_index (tbl, &index)) != NULL) {
+		id = (uint32_t)((uintptr_t) elem - 1);
+		if ((id >= key_num) || (present[id] == 0) || (seen[id])) {
+			fprintf (stderr, "cefbench_hash_churn: slot %u holds a wrong entry\n", index);
+			return (-1);
+		}
+		seen[id] = 1;
+		index++;
+	}
+	for (id = 0 ; id < key_num ; id++) {
+		if (present[id] != seen[id]) {
+			fprintf (stderr, "cefbench_hash_churn: key %u is not in any slot\n", id);
+			return (-1);
+		}
+	}
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Creates the key of the specified id
+----------------------------------------------------------------------------------------*/
+static int
+cefb_key_create (
+	uint32_t id,
+	unsigned char* key
+) {
+	return (snprintf ((char*) key, CefbC_Key_Len, "ccnx:/churn/key%u", id));
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+) {
+	struct timespec ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+) {
+	fprintf (stderr,
+		"\nUsage: cefbench_hash_churn\n\n"
+		"  cefbench_hash_churn [-s slots] [-l load] [-n count] [-r seed]\n\n"
+		"  -s  Size of the table. The default value is 10000.\n"
+		"  -l  Entries per slot (%%) kept during the churn. The value must be\n"
+		"      1 to 99. The default value is 95.\n"
+		"  -n  Number of operations, each of which removes a key and adds\n"
+		"      another one. The default value is 400000.\n"
+		"  -r  Seed of the random numbers. The default value is the time.\n\n"
+	);
+	return;
+}
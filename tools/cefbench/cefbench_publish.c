@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cefbench_publish.c
+ */
+
+/*
+	cefbench_publish measures how fast the publishing pipeline (cef_publish)
+	frames and signs the chunks of a content for each number of workers, as
+	cefputfile -w and PUBLISH_WORKERS of conpubd use it. The chunks are made
+	in memory and the Content Objects are not sent, so the result is the
+	rate that the publisher can feed to cefnetd. The Content Objects of each
+	run are compared with those of the first run.
+*/
+
+#define __CEFBENCH_PUBLISH_SOURCE__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <limits.h>
+#include <time.h>
+
+#include <cefore/cef_define.h>
+#include <cefore/cef_frame.h>
+#include <cefore/cef_hash.h>
+#include <cefore/cef_log.h>
+#include <cefore/cef_valid.h>
+#include <cefore/cef_publish.h>
+
+
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define CefbC_Default_Workers		"1,2,4,8"
+#define CefbC_Default_Size			256			/* MB published per run 				*/
+#define CefbC_Default_Block			1024
+#define CefbC_Default_Uri			"ccnx:/bench/publish"
+#define CefbC_Max_List				16
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+);
+/*--------------------------------------------------------------------------------------
+	Publishes the chunks with the workers and returns the elapsed time (ns)
+----------------------------------------------------------------------------------------*/
+static uint64_t								/* elapsed time, or 0 if it failed 			*/
+cefb_publish_run (
+	CefT_CcnMsg_OptHdr* opt,
+	CefT_CcnMsg_MsgBdy* params,
+	int workers,
+	uint32_t chunks,
+	int block_size,
+	uint32_t* digest						/* set the hash of the Content Objects 		*/
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+);
+
+
+/****************************************************************************************
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+) {
+	char workers_str[256] = CefbC_Default_Workers;
+	char conf_path[PATH_MAX] = {0};
+	char valid_type[64] = {0};
+	char uri[1024] = CefbC_Default_Uri;
+	int workers[CefbC_Max_List];
+	int worker_num = 0;
+	uint64_t size = CefbC_Default_Size;
+	int block_size = CefbC_Default_Block;
+	CefT_CcnMsg_OptHdr opt;
+	CefT_CcnMsg_MsgBdy* params;
+	uint32_t chunks;
+	uint32_t digest;
+	uint32_t first_digest = 0;
+	uint64_t spent;
+	double base_mbps = 0.0;
+	double mbps;
+	char* tok;
+	char* save = NULL;
+	int opt_c;
+	int res;
+	int err = 0;
+	int i;
+
+	while ((opt_c = getopt (argc, argv, "d:v:w:s:b:u:")) != -1) {
+		switch (opt_c) {
+			case 'd': {
+				snprintf (conf_path, sizeof (conf_path), "%s", optarg);
+				break;
+			}
+			case 'v': {
+				snprintf (valid_type, sizeof (valid_type), "%s", optarg);
+				break;
+			}
+			case 'w': {
+				snprintf (workers_str, sizeof (workers_str), "%s", optarg);
+				break;
+			}
+			case 's': {
+				size = strtoull (optarg, NULL, 10);
+				break;
+			}
+			case 'b': {
+				block_size = atoi (optarg);
+				break;
+			}
+			case 'u': {
+				snprintf (uri, sizeof (uri), "%s", optarg);
+				break;
+			}
+			default: {
+				print_usage ();
+				return (1);
+			}
+		}
+	}
+	for (tok = strtok_r (workers_str, ",", &save) ; tok && worker_num < CefbC_Max_List
+			; tok = strtok_r (NULL, ",", &save)) {
+		workers[worker_num] = atoi (tok);
+		if ((workers[worker_num] < 1) || (workers[worker_num] > CefC_Publish_Worker_Max)) {
+			print_usage ();
+			return (1);
+		}
+		worker_num++;
+	}
+	if ((worker_num == 0) || (size < 1) ||
+		(block_size < 60) || (block_size > CefC_Max_Block)) {
+		print_usage ();
+		return (1);
+	}
+	chunks = (uint32_t)((size << 20) / block_size);
+
+	cef_log_init2 (conf_path, 1);
+	cef_frame_init ();
+	memset (&opt, 0, sizeof (CefT_CcnMsg_OptHdr));
+	params = (CefT_CcnMsg_MsgBdy*) calloc (1, sizeof (CefT_CcnMsg_MsgBdy));
+	if (params == NULL) {
+		fprintf (stderr, "cefbench_publish: no memory\n");
+		return (1);
+	}
+	res = cef_frame_conversion_uri_to_name (uri, params->name);
+	if (res < 0) {
+		fprintf (stderr, "cefbench_publish: invalid URI %s\n", uri);
+		return (1);
+	}
+	params->name_len 	= (uint16_t) res;
+	params->chunk_num_f = 1;
+	params->end_chunk_num_f = 1;
+	params->end_chunk_num 	= chunks - 1;
+	/* Fixed times, so that every run creates the same Content Objects 	*/
+	params->expiry 	= 4102444800000ULL;
+	opt.cachetime_f = 1;
+	opt.cachetime 	= 4102444800000ULL;
+
+	if (valid_type[0]) {
+		cef_valid_init (conf_path);
+		params->alg.valid_type = (uint16_t) cef_valid_type_get (valid_type);
+		if (params->alg.valid_type == CefC_T_ALG_INVALID) {
+			fprintf (stderr, "cefbench_publish: invalid validation %s\n", valid_type);
+			return (1);
+		}
+	}
+
+	fprintf (stdout, "Chunks : %u x %d Bytes, Validation : %s\n",
+		chunks, block_size, valid_type[0] ? valid_type : "none");
+	fprintf (stdout, "%8s %10s %10s %8s\n", "workers", "MB/s", "speedup", "result");
+	for (i = 0 ; i < worker_num ; i++) {
+		spent = cefb_publish_run (&opt, params, workers[i], chunks, block_size, &digest);
+		if (spent == 0) {
+			fprintf (stderr, "cefbench_publish: publishing with %d workers failed\n",
+				workers[i]);
+			return (1);
+		}
+		if (i == 0) {
+			first_digest = digest;
+		}
+		mbps = (double) chunks * block_size / (1 << 20) / ((double) spent / 1e9);
+		if (i == 0) {
+			base_mbps = mbps;
+		}
+		fprintf (stdout, "%8d %10.1f %10.2f %8s\n", workers[i], mbps, mbps / base_mbps,
+			(digest == first_digest) ? "OK" : "NG");
+		if (digest != first_digest) {
+			err++;
+		}
+	}
+	free (params);
+	return ((err) ? 1 : 0);
+}
+/*--------------------------------------------------------------------------------------
+	Publishes the chunks with the workers and returns the elapsed time (ns)
+----------------------------------------------------------------------------------------*/
+static uint64_t								/* elapsed time, or 0 if it failed 			*/
+cefb_publish_run (
+	CefT_CcnMsg_OptHdr* opt,
+	CefT_CcnMsg_MsgBdy* params,
+	int workers,
+	uint32_t chunks,
+	int block_size,
+	uint32_t* digest						/* set the hash of the Content Objects 		*/
+) {
+	CefT_Publish* pp;
+	unsigned char payload[CefC_Max_Block];
+	unsigned char* cob;
+	uint16_t payload_len;
+	uint32_t chunk_num;
+	uint32_t put_num = 0;
+	uint32_t get_num = 0;
+	uint64_t start, end;
+	int cob_len;
+	int i;
+
+	pp = cef_publish_create (opt, params, workers, 0);
+	if (pp == NULL) {
+		return (0);
+	}
+	*digest = 0;
+
+	start = cefb_now_ns ();
+	while (get_num < chunks) {
+		/* Fills the pipeline as cefputfile reads ahead 	*/
+		while ((put_num < chunks) && (cef_publish_space_get (pp) > 0)) {
+			for (i = 0 ; i < block_size ; i += 4) {
+				memcpy (&payload[i], &put_num, (block_size - i < 4) ? block_size - i : 4);
+			}
+			cef_publish_block_put (pp, payload, (uint16_t) block_size, put_num,
+				(put_num == chunks - 1) ? 1 : 0);
+			put_num++;
+		}
+		cob_len = cef_publish_cob_get (pp, &cob, &payload_len, &chunk_num);
+		if ((cob_len <= 0) || (chunk_num != get_num)) {
+			cef_publish_destroy (pp);
+			return (0);
+		}
+		*digest = cef_hash_number_calc (*digest, cob, (uint32_t) cob_len);
+		cef_publish_cob_release (pp);
+		get_num++;
+	}
+	end = cefb_now_ns ();
+
+	cef_publish_destroy (pp);
+	return (end - start + 1);
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+) {
+	struct timespec ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+) {
+	fprintf (stderr,
+		"\nUsage: cefbench_publish\n\n"
+		"  cefbench_publish [-d config_file_dir] [-v valid_algo] [-w num[,num...]]\n"
+		"                   [-s MB] [-b block_size] [-u uri]\n\n"
+		"  -d  Directory of cefnetd.conf and the keys used for sha256.\n"
+		"  -v  Validation algorithm (crc32 or sha256). The default is none.\n"
+		"  -w  Comma-separated numbers of workers (1 to 32).\n"
+		"      The default value is 1,2,4,8.\n"
+		"  -s  Size of the content (MB). The default value is 256.\n"
+		"  -b  Payload size of a chunk (60 to 57344). The default value is 1024.\n"
+		"  -u  URI of the content. The default value is ccnx:/bench/publish.\n\n"
+	);
+	return;
+}
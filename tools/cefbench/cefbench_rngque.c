@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * cefbench_rngque.c
+ */
+
+/*
+	cefbench_rngque measures the throughput of CefT_Rngque with producer
+	threads pushing to one consumer, which is how cefnetd and csmgrd use the
+	queues. The MPSC queue is run with each number of producers, the SPSC
+	queue with one producer, and a queue guarded by a mutex, as the ring
+	queue was before, is run for comparison. The consumer checks that the
+	items of each producer come in order and that none is lost.
+*/
+
+#define __CEFBENCH_RNGQUE_SOURCE__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include <cefore/cef_define.h>
+#include <cefore/cef_rngque.h>
+
+
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#define CefbC_Default_Producers		"1,2,4,8"
+#define CefbC_Default_Batches		"1,32"
+#define CefbC_Default_Count			4000000
+#define CefbC_Default_Capacity		4096
+#define CefbC_Max_Producers			64
+#define CefbC_Max_Batch				256
+#define CefbC_Max_List				16
+
+#define CefbC_Que_Mpsc				0
+#define CefbC_Que_Spsc				1
+#define CefbC_Que_Mutex				2
+
+/* An item carries the producer in the upper bits and the sequence number + 1 		*/
+#define CefbC_Item_Seq_Bits			40
+#define CefbC_Item_Seq_Mask			((1ULL << CefbC_Item_Seq_Bits) - 1)
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+/* Ring queue guarded by a mutex 	*/
+typedef struct {
+	pthread_mutex_t 	mutex;
+	uint32_t 			top;
+	uint32_t 			bottom;
+	uint32_t 			mask;
+	void** 				que;
+} CefbT_Mutex_Que;
+
+typedef struct {
+	int 				type;				/* CefbC_Que_Xxx 						*/
+	CefT_Rngque* 		qp;
+	CefbT_Mutex_Que* 	mq;
+	int 				id;
+	uint64_t 			items;				/* items to push 						*/
+	int 				batch;
+	pthread_t 			th;
+} CefbT_Producer;
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+static volatile int start_f = 0;			/* producers wait until this is set 	*/
+static volatile int stop_f = 0;				/* producers give up when this is set 	*/
+
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+);
+/*--------------------------------------------------------------------------------------
+	Runs producers and the consumer and outputs the results
+----------------------------------------------------------------------------------------*/
+static int									/* 0: all items came in order, -1: failed 	*/
+cefb_rngque_run (
+	int type,
+	int prod_num,
+	int batch,
+	uint64_t count,
+	int capacity
+);
+/*--------------------------------------------------------------------------------------
+	Thread pushing the items of a producer
+----------------------------------------------------------------------------------------*/
+static void*
+cefb_producer_thread (
+	void* arg
+);
+/*--------------------------------------------------------------------------------------
+	Pushes the items to the queue and returns the number of the pushed items
+----------------------------------------------------------------------------------------*/
+static int
+cefb_que_push (
+	CefbT_Producer* prod,
+	void** items,
+	int num
+);
+/*--------------------------------------------------------------------------------------
+	Pops up to num items from the queue
+----------------------------------------------------------------------------------------*/
+static int
+cefb_que_pop (
+	int type,
+	CefT_Rngque* qp,
+	CefbT_Mutex_Que* mq,
+	void** items,
+	int num
+);
+/*--------------------------------------------------------------------------------------
+	Creates the queue guarded by a mutex
+----------------------------------------------------------------------------------------*/
+static CefbT_Mutex_Que*
+cefb_mutex_que_create (
+	int capacity
+);
+/*--------------------------------------------------------------------------------------
+	Destroys the queue guarded by a mutex
+----------------------------------------------------------------------------------------*/
+static void
+cefb_mutex_que_destroy (
+	CefbT_Mutex_Que* mq
+);
+/*--------------------------------------------------------------------------------------
+	Parses the comma-separated numbers
+----------------------------------------------------------------------------------------*/
+static int
+cefb_list_parse (
+	char* str,
+	int* list,
+	int min,
+	int max
+);
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+);
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+);
+
+
+/****************************************************************************************
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+) {
+	char prods_str[256] = CefbC_Default_Producers;
+	char batches_str[256] = CefbC_Default_Batches;
+	int prods[CefbC_Max_List];
+	int batches[CefbC_Max_List];
+	int prod_num, batch_num;
+	uint64_t count = CefbC_Default_Count;
+	int capacity = CefbC_Default_Capacity;
+	int opt;
+	int res = 0;
+	int i, n;
+
+	while ((opt = getopt (argc, argv, "p:b:n:c:")) != -1) {
+		switch (opt) {
+			case 'p': {
+				snprintf (prods_str, sizeof (prods_str), "%s", optarg);
+				break;
+			}
+			case 'b': {
+				snprintf (batches_str, sizeof (batches_str), "%s", optarg);
+				break;
+			}
+			case 'n': {
+				count = strtoull (optarg, NULL, 10);
+				break;
+			}
+			case 'c': {
+				capacity = atoi (optarg);
+				break;
+			}
+			default: {
+				print_usage ();
+				return (1);
+			}
+		}
+	}
+	prod_num  = cefb_list_parse (prods_str, prods, 1, CefbC_Max_Producers);
+	batch_num = cefb_list_parse (batches_str, batches, 1, CefbC_Max_Batch);
+	if ((prod_num <= 0) || (batch_num <= 0) || (count < 1) ||
+		(capacity < CefC_Rngque_Capacity_Min) || (capacity > CefC_Rngque_Capacity_Max)) {
+		print_usage ();
+		return (1);
+	}
+
+	fprintf (stdout, "Items : %llu, Capacity : %d\n", (unsigned long long) count, capacity);
+	fprintf (stdout, "%8s %10s %8s %12s %8s\n",
+		"queue", "producers", "batch", "Mitems/sec", "result");
+	for (n = 0 ; n < batch_num ; n++) {
+		for (i = 0 ; i < prod_num ; i++) {
+			if (prods[i] == 1) {
+				res |= cefb_rngque_run (CefbC_Que_Spsc, 1, batches[n], count, capacity);
+			}
+			res |= cefb_rngque_run (CefbC_Que_Mpsc, prods[i], batches[n], count, capacity);
+			if (batches[n] == 1) {
+				res |= cefb_rngque_run (
+							CefbC_Que_Mutex, prods[i], batches[n], count, capacity);
+			}
+		}
+	}
+	return ((res < 0) ? 1 : 0);
+}
+/*--------------------------------------------------------------------------------------
+	Runs producers and the consumer and outputs the results
+----------------------------------------------------------------------------------------*/
+static int									/* 0: all items came in order, -1: failed 	*/
+cefb_rngque_run (
+	int type,
+	int prod_num,
+	int batch,
+	uint64_t count,
+	int capacity
+) {
+	static const char* names[] = {"mpsc", "spsc", "mutex"};
+	CefbT_Producer prods[CefbC_Max_Producers];
+	uint64_t last_seq[CefbC_Max_Producers];
+	void* items[CefbC_Max_Batch];
+	CefT_Rngque* qp = NULL;
+	CefbT_Mutex_Que* mq = NULL;
+	uint64_t rcvd = 0;
+	uint64_t total = 0;
+	uint64_t start, end;
+	uint64_t seq;
+	uintptr_t val;
+	int started = 0;
+	int res = 0;
+	int num;
+	int id;
+	int i;
+
+	switch (type) {
+		case CefbC_Que_Mpsc: {
+			qp = cef_rngque_create (capacity);
+			break;
+		}
+		case CefbC_Que_Spsc: {
+			qp = cef_rngque_create_spsc (capacity);
+			break;
+		}
+		default: {
+			mq = cefb_mutex_que_create (capacity);
+			break;
+		}
+	}
+	if ((qp == NULL) && (mq == NULL)) {
+		fprintf (stderr, "cefbench_rngque: no memory\n");
+		return (-1);
+	}
+
+	start_f = 0;
+	stop_f = 0;
+	for (i = 0 ; i < prod_num ; i++) {
+		prods[i].type 	= type;
+		prods[i].qp 	= qp;
+		prods[i].mq 	= mq;
+		prods[i].id 	= i;
+		prods[i].items 	= count / prod_num + ((uint64_t) i < count % prod_num ? 1 : 0);
+		prods[i].batch 	= batch;
+		last_seq[i] 	= 0;
+		total += prods[i].items;
+		if (pthread_create (&prods[i].th, NULL, cefb_producer_thread, &prods[i]) != 0) {
+			fprintf (stderr, "cefbench_rngque: pthread_create failed\n");
+			res = -1;
+			break;
+		}
+		started++;
+	}
+
+	start = cefb_now_ns ();
+	__atomic_store_n (&start_f, 1, __ATOMIC_RELEASE);
+	while ((res == 0) && (rcvd < total)) {
+		num = cefb_que_pop (type, qp, mq, items, batch);
+		if (num == 0) {
+			sched_yield ();
+			continue;
+		}
+		for (i = 0 ; i < num ; i++) {
+			val = (uintptr_t) items[i];
+			id 	= (int)(val >> CefbC_Item_Seq_Bits);
+			seq = val & CefbC_Item_Seq_Mask;
+			if ((id >= prod_num) || (seq != last_seq[id] + 1)) {
+				fprintf (stderr, "cefbench_rngque: item %llu of producer %d is out of order\n",
+					(unsigned long long) seq, id);
+				res = -1;
+				break;
+			}
+			last_seq[id] = seq;
+		}
+		rcvd += num;
+	}
+	end = cefb_now_ns ();
+	__atomic_store_n (&start_f, 1, __ATOMIC_RELEASE);
+	__atomic_store_n (&stop_f, 1, __ATOMIC_RELEASE);
+
+	for (i = 0 ; i < started ; i++) {
+		pthread_join (prods[i].th, NULL);
+	}
+
+	fprintf (stdout, "%8s %10d %8d %12.2f %8s\n", names[type], prod_num, batch,
+		(double) rcvd * 1000.0 / (double)(end - start + 1), (res == 0) ? "OK" : "NG");
+
+	if (qp) {
+		cef_rngque_destroy (qp);
+	}
+	cefb_mutex_que_destroy (mq);
+	return (res);
+}
+/*--------------------------------------------------------------------------------------
+	Thread pushing the items of a producer
+----------------------------------------------------------------------------------------*/
+static void*
+cefb_producer_thread (
+	void* arg
+) {
+	CefbT_Producer* prod = (CefbT_Producer*) arg;
+	void* items[CefbC_Max_Batch];
+	uint64_t next = 1;
+	int num;
+	int pushed;
+	int i;
+
+	while (__atomic_load_n (&start_f, __ATOMIC_ACQUIRE) == 0) {
+		sched_yield ();
+	}
+	while ((next <= prod->items) && (__atomic_load_n (&stop_f, __ATOMIC_ACQUIRE) == 0)) {
+		num = prod->batch;
+		if ((uint64_t) num > prod->items - next + 1) {
+			num = (int)(prod->items - next + 1);
+		}
+		for (i = 0 ; i < num ; i++) {
+			items[i] = (void*)(((uintptr_t) prod->id << CefbC_Item_Seq_Bits) | (next + i));
+		}
+		/* Waits for the consumer while the queue is full 	*/
+		pushed = 0;
+		while (pushed < num) {
+			i = cefb_que_push (prod, &items[pushed], num - pushed);
+			if (i == 0) {
+				if (__atomic_load_n (&stop_f, __ATOMIC_ACQUIRE)) {
+					return (NULL);
+				}
+				sched_yield ();
+			}
+			pushed += i;
+		}
+		next += num;
+	}
+	return (NULL);
+}
+/*--------------------------------------------------------------------------------------
+	Pushes the items to the queue and returns the number of the pushed items
+----------------------------------------------------------------------------------------*/
+static int
+cefb_que_push (
+	CefbT_Producer* prod,
+	void** items,
+	int num
+) {
+	CefbT_Mutex_Que* mq = prod->mq;
+	int res = 0;
+
+	if (prod->type != CefbC_Que_Mutex) {
+		if (num == 1) {
+			return (cef_rngque_push (prod->qp, items[0]));
+		}
+		return (cef_rngque_push_bulk (prod->qp, items, num));
+	}
+
+	pthread_mutex_lock (&mq->mutex);
+	if (((mq->bottom + 1) & mq->mask) != mq->top) {
+		mq->que[mq->bottom] = items[0];
+		mq->bottom = (mq->bottom + 1) & mq->mask;
+		res = 1;
+	}
+	pthread_mutex_unlock (&mq->mutex);
+	return (res);
+}
+/*--------------------------------------------------------------------------------------
+	Pops up to num items from the queue
+----------------------------------------------------------------------------------------*/
+static int
+cefb_que_pop (
+	int type,
+	CefT_Rngque* qp,
+	CefbT_Mutex_Que* mq,
+	void** items,
+	int num
+) {
+	int res = 0;
+
+	if (type != CefbC_Que_Mutex) {
+		if (num == 1) {
+			items[0] = cef_rngque_pop (qp);
+			return ((items[0] != NULL) ? 1 : 0);
+		}
+		return (cef_rngque_pop_bulk (qp, items, num));
+	}
+
+	pthread_mutex_lock (&mq->mutex);
+	if (mq->bottom != mq->top) {
+		items[0] = mq->que[mq->top];
+		mq->top = (mq->top + 1) & mq->mask;
+		res = 1;
+	}
+	pthread_mutex_unlock (&mq->mutex);
+	return (res);
+}
+/*--------------------------------------------------------------------------------------
+	Creates the queue guarded by a mutex
+----------------------------------------------------------------------------------------*/
+static CefbT_Mutex_Que*
+cefb_mutex_que_create (
+	int capacity
+) {
+	CefbT_Mutex_Que* mq;
+	uint32_t size = 1;
+
+	while (size < (uint32_t) capacity) {
+		size <<= 1;
+	}
+	mq = (CefbT_Mutex_Que*) calloc (1, sizeof (CefbT_Mutex_Que));
+	if (mq == NULL) {
+		return (NULL);
+	}
+	mq->que = (void**) calloc (size, sizeof (void*));
+	if (mq->que == NULL) {
+		free (mq);
+		return (NULL);
+	}
+	mq->mask = size - 1;
+	pthread_mutex_init (&mq->mutex, NULL);
+	return (mq);
+}
+/*--------------------------------------------------------------------------------------
+	Destroys the queue guarded by a mutex
+----------------------------------------------------------------------------------------*/
+static void
+cefb_mutex_que_destroy (
+	CefbT_Mutex_Que* mq
+) {
+	if (mq == NULL) {
+		return;
+	}
+	pthread_mutex_destroy (&mq->mutex);
+	free (mq->que);
+	free (mq);
+	return;
+}
+/*--------------------------------------------------------------------------------------
+	Parses the comma-separated numbers
+----------------------------------------------------------------------------------------*/
+static int
+cefb_list_parse (
+	char* str,
+	int* list,
+	int min,
+	int max
+) {
+	char* tok;
+	char* save = NULL;
+	int num = 0;
+
+	for (tok = strtok_r (str, ",", &save) ; tok && num < CefbC_Max_List
+			; tok = strtok_r (NULL, ",", &save)) {
+		list[num] = atoi (tok);
+		if ((list[num] < min) || (list[num] > max)) {
+			return (-1);
+		}
+		num++;
+	}
+	return (num);
+}
+/*--------------------------------------------------------------------------------------
+	Obtains the current time in nanoseconds
+----------------------------------------------------------------------------------------*/
+static uint64_t
+cefb_now_ns (
+	void
+) {
+	struct timespec ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+) {
+	fprintf (stderr,
+		"\nUsage: cefbench_rngque\n\n"
+		"  cefbench_rngque [-p num[,num...]] [-b num[,num...]] [-n count] [-c capacity]\n\n"
+		"  -p  Comma-separated numbers of producer threads (1 to 64).\n"
+		"      The default value is 1,2,4,8.\n"
+		"  -b  Comma-separated numbers of items per push and pop (1 to 256).\n"
+		"      1 uses cef_rngque_push/pop, and larger values use the bulk calls.\n"
+		"      The default value is 1,32.\n"
+		"  -n  Number of items per run. The default value is 4000000.\n"
+		"  -c  Capacity of the queue. The default value is 4096.\n\n"
+	);
+	return;
+}
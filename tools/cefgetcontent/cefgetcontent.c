@@ -51,31 +51,19 @@
 #include <cefore/cef_client.h>
 #include <cefore/cef_valid.h>
 #include <cefore/cef_log.h>
+#include <cefore/cef_fetch.h>
 
 /****************************************************************************************
  Macros
  ****************************************************************************************/
 
-#define CefC_Max_PipeLine 		1024	/* MAX Pipeline */
-#define CefC_Def_PipeLine 		8		/* Default Pipeline */
-
-#define CefC_Resend_Interval	10000		/* 10 ms 		*/
-#define CefC_Max_Retry 			5
+#define CefC_Max_PipeLine 		CefC_Fetch_Wnd_Max	/* MAX Pipeline */
+#define CefC_Def_PipeLine 		CefC_Fetch_Wnd_Def	/* Default Pipeline */
 
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
 
-typedef struct _Ceft_RxWnd {
-	
-	uint64_t 				seq;
-	uint8_t 				flag;
-	unsigned char 			buff[CefC_Max_Length];
-	int 					frame_size;
-	struct _Ceft_RxWnd* 	next;
-	
-} Ceft_RxWnd;
-
 struct sign_tlv {
 	
 	uint16_t 		type;
@@ -145,8 +133,6 @@ int main (
 	uint64_t now_time;
 	uint64_t end_time;
 	uint64_t val;
-	uint32_t diff_seq;
-	int send_cnt = 0;
 	int i;
 	char*	work_arg;
 	uint16_t valid_alg = 0;
@@ -155,18 +141,16 @@ int main (
 	int 	port_num = CefC_Unset_Port;
 	
 	char valid_type[1024];
+	int cc_type = CefC_Fetch_Cc_Cubic;
 	
-	Ceft_RxWnd* 	rxwnd;
-	Ceft_RxWnd* 	rxwnd_prev;
-	Ceft_RxWnd* 	rxwnd_head;
-	Ceft_RxWnd* 	rxwnd_tail;
+	CefT_Fetch* 	fetch = NULL;
+	unsigned char* 	payload;
+	int 			payload_len;
+	uint32_t 		chunk_num;
 	
 	struct cef_app_frame app_frame;
 	unsigned char* buff;
 	
-	int retry_cnt = 0;
-	uint64_t retry_int = CefC_Resend_Interval;
-	
 	/***** flags 		*****/
 	int pipeline_f 		= 0;
 	int uri_f 			= 0;
@@ -176,6 +160,7 @@ int main (
 	int port_num_f 		= 0;
 	int valid_f 		= 0;
 	int get_ver_f 		= 0;
+	int cc_f 			= 0;
 	
 	/***** state variavles 	*****/
 	uint32_t 	sv_max_seq 		= UINT32_MAX - 1;
@@ -247,6 +232,26 @@ int main (
 			}
 			pipeline_f++;
 			i++;
+		} else if (strcmp (work_arg, "-c") == 0) {
+			if (cc_f) {
+				fprintf (stderr, "[cefgetcontent] ERROR: [-c] is duplicated.\n");
+				print_usage ();
+				return (-1);
+			}
+			if (i + 1 == argc) {
+				fprintf (stderr, "[cefgetcontent] ERROR: [-c] has no parameter.\n");
+				print_usage ();
+				return (-1);
+			}
+			work_arg = argv[i + 1];
+			cc_type = cef_fetch_cc_type_get (work_arg);
+			if (cc_type < 0) {
+				fprintf (stderr, "[cefgetcontent] ERROR: [-c] has the invalid parameter.\n");
+				print_usage ();
+				return (-1);
+			}
+			cc_f++;
+			i++;
 		} else if (strcmp (work_arg, "-h") == 0) {
 			print_usage ();
 			exit (1);
@@ -534,21 +539,19 @@ GETCONTENT:;
 	if (req_ver_len) {
 		/* Versioned Contents */
 		params.org.version_f = 1;
-		memcpy (&params.org.version_val, req_version, params.org.version_len);
+		params.org.version_val = req_version;
 	} else {
 		/* Unversioned Contents */
 		params.org.version_f = 0;
-		params.org.version_val[0] = 0x00;
 	}
 #ifdef CefC_Develop
 	} else {
 		if (vlen == 4 && strncmp (version, "None", vlen) == 0) {
 			params.org.version_f = 0;
-			params.org.version_val[0] = 0x00;
 		} else {
 			params.org.version_f = 1;
 			params.org.version_len = vlen;
-			memcpy (&params.org.version_val, version, params.org.version_len);
+			params.org.version_val = (unsigned char*) version;
 			req_ver_len = vlen;
 			memcpy (req_version, version, req_ver_len);
 		}
@@ -575,32 +578,13 @@ GETCONTENT:;
 	fprintf (stderr, "[cefgetcontent] Start\n");
 	fprintf (stderr, "[cefgetcontent] Running ...\n");
 		
-	/* Sends Initerest(s) 		*/
-	for (i = 0 ; i < pipeline ; i++) {
-		cef_client_interest_input (fhdl, &opt, &params);
-		params.chunk_num++;
-			
-		usleep (100000);
-	}
-	
-	/* Creates the rx window 	*/
-	rxwnd = (Ceft_RxWnd*) malloc (sizeof (Ceft_RxWnd));
-	memset (rxwnd, 0, sizeof (Ceft_RxWnd));
-	rxwnd->next = rxwnd;
-	rxwnd->seq 	= 0;
-	rxwnd_prev = rxwnd;
-	rxwnd_head = rxwnd;
-	rxwnd_tail = rxwnd;
-	
-	for (i = 1 ; i < pipeline ; i++) {
-		rxwnd = (Ceft_RxWnd*) malloc (sizeof (Ceft_RxWnd));
-		memset (rxwnd, 0, sizeof (Ceft_RxWnd));
-		rxwnd->seq = (uint32_t) i;
-		rxwnd_prev->next = rxwnd;
-		rxwnd_tail = rxwnd;
-		rxwnd_prev = rxwnd;
+	/* The window grows from a few Interests up to the pipeline 	*/
+	fetch = cef_fetch_create (fhdl, &opt, &params, cc_type, pipeline, sv_max_seq);
+	if (fetch == NULL) {
+		fprintf (stderr, "[cefgetcontent] ERROR: Failed to create the fetch engine.\n");
+		exit (1);
 	}
-	end_t.tv_sec = t.tv_sec;
+	cef_fetch_start (fetch);
 	memset (&app_frame, 0, sizeof (struct cef_app_frame));
 	buff = (unsigned char*) malloc (sizeof (unsigned char) * CefC_AppBuff_Size);
 	
@@ -621,7 +605,7 @@ GETCONTENT:;
 		now_time = cef_client_covert_timeval_to_us (t);
 		
 		/* Reads the message from cefnetd			*/
-		res = cef_client_read (fhdl, &buff[index], CefC_AppBuff_Size - index);
+		res = cef_fetch_read (fetch, &buff[index], CefC_AppBuff_Size - index);
 		
 		if (res > 0) {
 			res += index;
@@ -710,72 +694,20 @@ GETCONTENT:;
 										 + app_frame.payload_len;		//20230523
 					
 					/* Inserts the received frame to the buffer 	*/
-					if ((app_frame.chunk_num < rxwnd_head->seq) || 
-						(app_frame.chunk_num > rxwnd_tail->seq)) {
-						continue;
-					}
+					cef_fetch_frame_input (fetch, &app_frame);
 					
-					diff_seq = app_frame.chunk_num - rxwnd_head->seq;
-					rxwnd = rxwnd_head;
-					
-					for (i = 0 ; i < diff_seq ; i++) {
-						rxwnd = rxwnd->next;
-					}
-					
-					if (rxwnd->flag != 1) {
-						memcpy (rxwnd->buff, app_frame.payload, app_frame.payload_len);
-						rxwnd->frame_size = app_frame.payload_len;
-						rxwnd->flag = 1;
+					while (cef_fetch_frame_get (
+							fetch, &payload, &payload_len, &chunk_num) > 0) {
+						stat_recv_frames++;
+						stat_recv_bytes += payload_len;
 						
-						retry_cnt = 0;
-						end_time = now_time;
-						retry_int = CefC_Resend_Interval;
+						fwrite (payload, sizeof (unsigned char), payload_len, fp);
 					}
 					
-					rxwnd = rxwnd_head;
-					
-					for (i = 0 ; i < pipeline; i++) {
-						
-						if (rxwnd->flag == 0) {
-							break;
-						}
-						stat_recv_frames++;
-						stat_recv_bytes += app_frame.payload_len;
-						
-						fwrite (rxwnd->buff, 
-							sizeof (unsigned char), rxwnd->frame_size, fp);
-						
-						if ( stat_recv_frames == end_chunk_num ) {
-							fprintf (stdout, "[cefgetcontent] Completed to get all the chunks.\n");
-							app_running_f = 0;
-							goto IR_RCV2;
-						}
-						
-						if (rxwnd->seq == UINT32_MAX /*sv_max_seq*/) {
-							fprintf (stdout, 
-								"[cefgetcontent] "
-								"Received the specified number of chunk\n");
-							app_running_f = 0;
-						}
-						
-						/* Updates head and tail pointers		*/
-						rxwnd_head->seq 			= rxwnd_tail->seq + 1;
-						rxwnd_head->flag 			= 0;
-						rxwnd_head->frame_size 		= 0;
-						
-						rxwnd_tail->next = rxwnd_head;
-						rxwnd_tail = rxwnd_head;
-						
-						rxwnd_head = rxwnd_tail->next;
-						rxwnd_tail->next 	= NULL;
-						
-						rxwnd = rxwnd_head;
-						
-						/* Sends an interest with the next chunk number 	*/
-						params.chunk_num = rxwnd_tail->seq;
-						if (params.chunk_num <=  UINT32_MAX/* sv_max_seq+1 */) {
-							cef_client_interest_input (fhdl, &opt, &params);
-						}
+					if (cef_fetch_completed (fetch)) {
+						fprintf (stdout, "[cefgetcontent] Completed to get all the chunks.\n");
+						app_running_f = 0;
+						goto IR_RCV2;
 					}
 				} else {
 					break;
@@ -789,38 +721,11 @@ GETCONTENT:;
 			}
 		}
 		
-		/* Sends Interest with Symbolic flag to CEFORE 		*/
-		if (now_time - end_time > retry_int) {
-			
-			if (retry_cnt == CefC_Max_Retry) {
-				rxwnd = rxwnd_head;
-				for (i = 0 ; i < pipeline ; i++) {
-					if (rxwnd->flag != 0) {
-						break;
-					}
-				}
-				fprintf (stdout, "[cefgetcontent] Suspended to retrieve the content because the number of Interest retransmission has reached its limit, 5.\n");
-				rcv_ng_f = 1;
-				break;
-			}
-	
-			rxwnd = rxwnd_head;
-			send_cnt = 0;
-			
-			for (i = 0 ; i < pipeline ; i++) {
-				if ((rxwnd->seq <= sv_max_seq) && 
-					(rxwnd->flag == 0)) {
-					params.chunk_num = rxwnd->seq;
-					cef_client_interest_input (fhdl, &opt, &params);
-					send_cnt++;
-				}
-				rxwnd = rxwnd->next;
-			}
-			if (send_cnt > 0) {
-				retry_int += CefC_Resend_Interval;
-				retry_cnt++;
-			}
-			end_time = now_time;
+		/* Retransmits the Interests which timed out 	*/
+		if (cef_fetch_timer_process (fetch) < 0) {
+			fprintf (stdout, "[cefgetcontent] Suspended to retrieve the content because the number of Interest retransmission has reached its limit, %d.\n", CefC_Fetch_Retry_Max);
+			rcv_ng_f = 1;
+			break;
 		}
 IR_RCV2:;	
 	}
@@ -831,6 +736,7 @@ CONTENTGET_POST:;
 		remove(fpath);
 	}
 	post_process ();
+	cef_fetch_destroy (fetch);
 	
 	exit (0);
 }
@@ -841,10 +747,11 @@ print_usage (
 ) {
 	
 	fprintf (stderr, "\nUsage: cefgetcontent\n");
-	fprintf (stderr, "  cefgetcontent uri -f file [-s pipeline] [-d config_file_dir] [-p port_num] [-v valid_alg] [-gv]\n\n");
+	fprintf (stderr, "  cefgetcontent uri -f file [-s pipeline] [-c cc_algo] [-d config_file_dir] [-p port_num] [-v valid_alg] [-gv]\n\n");
 	fprintf (stderr, "  uri              URI of the content that you want to get\n");
 	fprintf (stderr, "  file             File name that you save\n");
-	fprintf (stderr, "  pipeline         Number of pipeline\n");
+	fprintf (stderr, "  pipeline         Max number of pipeline (the window adapts up to this)\n");
+	fprintf (stderr, "  cc_algo          Congestion control (aimd or cubic)\n");
 	fprintf (stderr, "  config_file_dir  Configure file directory\n");
 	fprintf (stderr, "  port_num         Port Number\n");
 	fprintf (stderr, "  valid_alg        Validation Algorithm\n");
@@ -47,30 +47,19 @@
 #include <cefore/cef_client.h>
 #include <cefore/cef_valid.h>
 #include <cefore/cef_log.h>
+#include <cefore/cef_fetch.h>
 
 /****************************************************************************************
  Macros
  ****************************************************************************************/
 
-#define CefC_Max_PipeLine 		1024	/* MAX Pipeline */
-#define CefC_Def_PipeLine 		8		/* Default Pipeline */
-
-#define CefC_Resend_Interval	10000		/* 10 ms 		*/
-#define CefC_Max_Retry 			5
+#define CefC_Max_PipeLine 		CefC_Fetch_Wnd_Max	/* MAX Pipeline */
+#define CefC_Def_PipeLine 		CefC_Fetch_Wnd_Def	/* Default Pipeline */
 
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
 
-typedef struct _Ceft_RxWnd {
-	
-	uint64_t 				seq;
-	uint8_t 				flag;
-	unsigned char 			buff[CefC_Max_Length];
-	int 					frame_size;
-	struct _Ceft_RxWnd* 	next;
-	
-} Ceft_RxWnd;
 
 /****************************************************************************************
  State Variables
@@ -130,9 +119,6 @@ int main (
 	uint64_t now_time;
 	uint64_t end_time;
 	uint64_t val;
-	uint32_t chunk_num = 0;
-	uint64_t diff_seq;
-	int send_cnt = 0;
 	int i;
 	int j;
 	char*	work_arg;
@@ -141,19 +127,16 @@ int main (
 	int 	port_num = CefC_Unset_Port;
 	
 	char valid_type[1024];
+	int cc_type = CefC_Fetch_Cc_Cubic;
 	
-	Ceft_RxWnd* 	rxwnd;
-	Ceft_RxWnd* 	rxwnd_prev;
-	Ceft_RxWnd* 	rxwnd_head = NULL;
-	Ceft_RxWnd* 	rxwnd_tail;
-	Ceft_RxWnd*		next;
+	CefT_Fetch* 	fetch = NULL;
+	unsigned char* 	payload;
+	int 			payload_len;
+	uint32_t 		chunk_num;
 	
 	struct cef_app_frame app_frame;
 	unsigned char* buff = NULL;
 	
-	int retry_cnt = 0;
-	uint64_t retry_int = CefC_Resend_Interval;
-	
 	/***** flags 		*****/
 	int pipeline_f 		= 0;
 	int max_seq_f 		= 0;
@@ -164,6 +147,7 @@ int main (
 	int dir_path_f 		= 0;
 	int port_num_f 		= 0;
 	int valid_f 		= 0;
+	int cc_f 			= 0;
 	
 	/***** state variavles 	*****/
 	uint32_t 	sv_max_seq 		= UINT32_MAX - 1;
@@ -328,6 +312,26 @@ int main (
 			strcpy (valid_type, work_arg);
 			valid_f++;
 			i++;
+		} else if (strcmp (work_arg, "-c") == 0) {
+			if (cc_f) {
+				fprintf (stdout, "ERROR: [-c] is duplicated.\n");
+				print_usage ();
+				return (-1);
+			}
+			if (i + 1 == argc) {
+				fprintf (stdout, "ERROR: [-c] has no parameter.\n");
+				print_usage ();
+				return (-1);
+			}
+			work_arg = argv[i + 1];
+			cc_type = cef_fetch_cc_type_get (work_arg);
+			if (cc_type < 0) {
+				fprintf (stdout, "ERROR: [-c] has the invalid parameter.\n");
+				print_usage ();
+				return (-1);
+			}
+			cc_f++;
+			i++;
 		} else if (strcmp (work_arg, "-h") == 0) {
 			print_usage ();
 			exit (1);
@@ -492,32 +496,13 @@ int main (
 	} else {
 		fprintf (stdout, "[cefgetfile] Start sending Interests\n");
 		
-		/* Sends Initerest(s) 		*/
-		for (i = 0 ; i < pipeline ; i++) {
-			cef_client_interest_input (fhdl, &opt, &params);
-			params.chunk_num++;
-			
-			usleep (100000);
-		}
-		
-		/* Creates the rx window 	*/
-		rxwnd = (Ceft_RxWnd*) malloc (sizeof (Ceft_RxWnd));
-		memset (rxwnd, 0, sizeof (Ceft_RxWnd));
-		rxwnd->next = rxwnd;
-		rxwnd->seq 	= 0;
-		rxwnd_prev = rxwnd;
-		rxwnd_head = rxwnd;
-		rxwnd_tail = rxwnd;
-		
-		for (i = 1 ; i < pipeline ; i++) {
-			rxwnd = (Ceft_RxWnd*) malloc (sizeof (Ceft_RxWnd));
-			memset (rxwnd, 0, sizeof (Ceft_RxWnd));
-			rxwnd->seq = (uint32_t) i;
-			rxwnd_prev->next = rxwnd;
-			rxwnd_tail = rxwnd;
-			rxwnd_prev = rxwnd;
+		/* The window grows from a few Interests up to the pipeline 	*/
+		fetch = cef_fetch_create (fhdl, &opt, &params, cc_type, pipeline, sv_max_seq);
+		if (fetch == NULL) {
+			fprintf (stdout, "ERROR: Failed to create the fetch engine.\n");
+			exit (1);
 		}
-		end_t.tv_sec = t.tv_sec;
+		cef_fetch_start (fetch);
 	}
 	memset (&app_frame, 0, sizeof (struct cef_app_frame));
 	buff = (unsigned char*) malloc (sizeof (unsigned char) * CefC_AppBuff_Size);
@@ -529,8 +514,8 @@ int main (
 		nxt_time = 0;
 		end_time = now_time + 10000000;
 	} else {
-		dif_time = (uint64_t)((double) opt.lifetime * 0.3) * 1000;
-		nxt_time = now_time + dif_time;
+		dif_time = 0;
+		nxt_time = 0;
 		end_time = now_time;
 	}
 	
@@ -553,7 +538,11 @@ int main (
 		}
 		
 		/* Reads the message from cefnetd			*/
-		res = cef_client_read (fhdl, &buff[index], CefC_AppBuff_Size - index);
+		if (nsg_flag) {
+			res = cef_client_read (fhdl, &buff[index], CefC_AppBuff_Size - index);
+		} else {
+			res = cef_fetch_read (fetch, &buff[index], CefC_AppBuff_Size - index);
+		}
 		
 		if (res > 0) {
 			
@@ -624,81 +613,35 @@ int main (
 						}
 					} else {
 						/* Inserts the received frame to the buffer 	*/
-						if ((app_frame.chunk_num < rxwnd_head->seq) || 
-							(app_frame.chunk_num > rxwnd_tail->seq)) {
-							continue;
-						}
-						
-						diff_seq = app_frame.chunk_num - rxwnd_head->seq;
-						rxwnd = rxwnd_head;
-						
-						for (i = 0 ; i < diff_seq ; i++) {
-							rxwnd = rxwnd->next;
-						}
-						
-						if (rxwnd->flag != 1) {
-							memcpy (rxwnd->buff, 
-								app_frame.payload, app_frame.payload_len);
-							rxwnd->frame_size = app_frame.payload_len;
-							rxwnd->flag = 1;
-							
-							retry_cnt = 0;
-							end_time = now_time;
-							retry_int = CefC_Resend_Interval;
-						}
+						cef_fetch_frame_input (fetch, &app_frame);
 						
-						rxwnd = rxwnd_head;
-						
-						for (i = 0 ; i < pipeline; i++) {
-							
-							if (rxwnd->flag == 0) {
-								break;
-							}
+						while (cef_fetch_frame_get (
+								fetch, &payload, &payload_len, &chunk_num) > 0) {
 							stat_recv_frames++;
-							stat_recv_bytes += app_frame.payload_len;
+							stat_recv_bytes += payload_len;
 							
 							if (dummy_f == 0) {
-								fwrite (rxwnd->buff, 
-									sizeof (unsigned char), rxwnd->frame_size, fp);
+								fwrite (payload, 
+									sizeof (unsigned char), payload_len, fp);
 							} else {
-								for (j=0; j<rxwnd->frame_size; j++) {
+								for (j=0; j<payload_len; j++) {
 									unsigned char v;
-									v = rxwnd->buff[j];
+									v = payload[j];
 									dummy_sum = dummy_sum + (uint32_t)v;
 								}
 							}
-							
-							if ( stat_recv_frames == end_chunk_num ) {
+						}
+						
+						if (cef_fetch_completed (fetch)) {
+							if (end_chunk_num >= 0) {
 								fprintf (stdout, "[cefgetfile] Completed to get all the chunks.\n");
-								app_running_f = 0;
-								goto IR_RCV;
-							}
-							
-							if (rxwnd->seq == UINT32_MAX /*sv_max_seq*/) {
+							} else {
 								fprintf (stdout, 
 									"[cefgetfile] "
 									"Received the specified number of chunk\n");
-								app_running_f = 0;
-							}
-							
-							/* Updates head and tail pointers		*/
-							rxwnd_head->seq 		= rxwnd_tail->seq + 1;
-							rxwnd_head->flag 		= 0;
-							rxwnd_head->frame_size 	= 0;
-							
-							rxwnd_tail->next = rxwnd_head;
-							rxwnd_tail = rxwnd_head;
-							
-							rxwnd_head = rxwnd_tail->next;
-							rxwnd_tail->next 	= NULL;
-							
-							rxwnd = rxwnd_head;
-							
-							/* Sends an interest with the next chunk number 	*/
-							params.chunk_num = rxwnd_tail->seq;
-							if (params.chunk_num <=  UINT32_MAX /* sv_max_seq+1 */) {
-								cef_client_interest_input (fhdl, &opt, &params);
 							}
+							app_running_f = 0;
+							goto IR_RCV;
 						}
 					}
 				} else {
@@ -721,37 +664,11 @@ int main (
 				nxt_time = now_time + dif_time;
 			}
 		} else {
-			if (now_time - end_time > retry_int) {
-				
-				if (retry_cnt == CefC_Max_Retry) {
-					rxwnd = rxwnd_head;
-					for (i = 0 ; i < pipeline ; i++) {
-						if (rxwnd->flag != 0) {
-							break;
-						}
-					}
-					fprintf (stdout, "[cefgetfile] Suspended to retrieve the content because the number of Interest retransmission has reached its limit, 5.\n");
-							rcv_ng_f = 1;
-					break;
-				}
-				
-				rxwnd = rxwnd_head;
-				send_cnt = 0;
-				
-				for (i = 0 ; i < pipeline ; i++) {
-					if ((rxwnd->seq <= sv_max_seq) && 
-						(rxwnd->flag == 0)) {
-						params.chunk_num = rxwnd->seq;
-						cef_client_interest_input (fhdl, &opt, &params);
-						send_cnt++;
-					}
-					rxwnd = rxwnd->next;
-				}
-				if (send_cnt > 0) {
-					retry_int += CefC_Resend_Interval;
-					retry_cnt++;
-				}
-				end_time = now_time;
+			/* Retransmits the Interests which timed out 	*/
+			if (cef_fetch_timer_process (fetch) < 0) {
+				fprintf (stdout, "[cefgetfile] Suspended to retrieve the content because the number of Interest retransmission has reached its limit, %d.\n", CefC_Fetch_Retry_Max);
+				rcv_ng_f = 1;
+				break;
 			}
 		}
 IR_RCV:;	
@@ -781,14 +698,7 @@ IR_RCV:;
 	}
 	post_process ();
 	
-	if (rxwnd_head != NULL) {
-		rxwnd = rxwnd_head;
-		for (i = 0 ; i < pipeline; i++) {
-			next = rxwnd->next;
-			free (rxwnd);
-			rxwnd = next;
-		}
-	}
+	cef_fetch_destroy (fetch);
 
 	free (buff);
 	exit (rcv_ng_f);
@@ -800,13 +710,14 @@ print_usage (
 ) {
 	
 	fprintf (stdout, "\nUsage: cefgetfile\n\n");
-	fprintf (stdout, "  cefgetfile uri -f file [-o] [-m chunk] [-s pipeline] [-v valid_algo] [-d config_file_dir] [-p port_num] [-z sg]\n\n");
+	fprintf (stdout, "  cefgetfile uri -f file [-o] [-m chunk] [-s pipeline] [-c cc_algo] [-v valid_algo] [-d config_file_dir] [-p port_num] [-z sg]\n\n");
 	fprintf (stdout, "  uri              Specify the URI.\n");
 	fprintf (stdout, "  file             Specify the file name of output. \n");
 	fprintf (stdout, "  -o               Specify this option, if you require the content\n"
 	                 "                   that the owner is caching\n");
 	fprintf (stdout, "  chunk            Specify the number of chunk that you want to obtain\n");
-	fprintf (stdout, "  pipeline         Number of pipeline\n");
+	fprintf (stdout, "  pipeline         Max number of pipeline (the window adapts up to this)\n");
+	fprintf (stdout, "  cc_algo          Specify the congestion control (aimd or cubic)\n");
 	fprintf (stdout, "  valid_algo       Specify the validation algorithm (crc32 or sha256)\n");
 	fprintf (stderr, "  config_file_dir  Configure file directory\n");
 	fprintf (stderr, "  port_num         Port Number\n");
@@ -47,28 +47,19 @@
 #include <cefore/cef_client.h>
 #include <cefore/cef_valid.h>
 #include <cefore/cef_log.h>
+#include <cefore/cef_fetch.h>
 
 /****************************************************************************************
  Macros
  ****************************************************************************************/
 
-#define CefC_Max_PipeLine 		1024	/* MAX Pipeline */
-#define CefC_Def_PipeLine 		8		/* Default Pipeline */
+#define CefC_Max_PipeLine 		CefC_Fetch_Wnd_Max	/* MAX Pipeline */
+#define CefC_Def_PipeLine 		CefC_Fetch_Wnd_Def	/* Default Pipeline */
 
 /****************************************************************************************
  Structures Declaration
  ****************************************************************************************/
 
-typedef struct _Ceft_RxWnd {
-	
-	uint64_t 				seq;
-	uint8_t 				flag;
-	unsigned char 			buff[CefC_Max_Length];
-	int 					frame_size;
-	struct _Ceft_RxWnd* 	next;
-	
-} Ceft_RxWnd;
-
 /****************************************************************************************
  State Variables
  ****************************************************************************************/
@@ -119,8 +110,6 @@ int main (
 	uint64_t now_time;
 	uint64_t end_time;
 	uint64_t val;
-	uint64_t diff_seq;
-	int send_cnt = 0;
 	int i;
 	char*	work_arg;
 	
@@ -128,14 +117,15 @@ int main (
 	int 	port_num = CefC_Unset_Port;
 	
 	char valid_type[1024];
+	int cc_type = CefC_Fetch_Cc_Cubic;
 	
 	struct cef_app_frame app_frame;
 	unsigned char* buff;
 	
-	Ceft_RxWnd* 	rxwnd;
-	Ceft_RxWnd* 	rxwnd_prev;
-	Ceft_RxWnd* 	rxwnd_head;
-	Ceft_RxWnd* 	rxwnd_tail;
+	CefT_Fetch* 	fetch = NULL;
+	unsigned char* 	payload;
+	int 			payload_len;
+	uint32_t 		chunk_num;
 	
 	int backup_fd;
 	
@@ -148,6 +138,7 @@ int main (
 	int dir_path_f 		= 0;
 	int port_num_f 		= 0;
 	int valid_f 		= 0;
+	int cc_f 			= 0;
 	//0.8.3
 	int blk_mode_f		= 0;
 	int blk_mode_val	= 0;	//BLOCK
@@ -323,6 +314,26 @@ int main (
 			strcpy (valid_type, work_arg);
 			valid_f++;
 			i++;
+		} else if (strcmp (work_arg, "-c") == 0) {
+			if (cc_f) {
+				fprintf (stderr, "ERROR: [-c] is duplicated.\n");
+				print_usage ();
+				return (-1);
+			}
+			if (i + 1 == argc) {
+				fprintf (stderr, "ERROR: [-c] has no parameter.\n");
+				print_usage ();
+				return (-1);
+			}
+			work_arg = argv[i + 1];
+			cc_type = cef_fetch_cc_type_get (work_arg);
+			if (cc_type < 0) {
+				fprintf (stderr, "ERROR: [-c] has the invalid parameter.\n");
+				print_usage ();
+				return (-1);
+			}
+			cc_f++;
+			i++;
 		} else if (strcmp (work_arg, "-h") == 0) {
 			print_usage ();
 			exit (1);
@@ -461,31 +472,13 @@ int main (
 	} else {
 		fprintf (stderr, "[cefgetstream] Start sending Interests\n");
 		
-		/* Sends Initerest(s) 		*/
-		for (i = 0 ; i < pipeline ; i++) {
-			cef_client_interest_input (fhdl, &opt, &params);
-			params.chunk_num++;
-			
-			usleep (100000);
-		}
-		
-		/* Creates the rx window 	*/
-		rxwnd = (Ceft_RxWnd*) malloc (sizeof (Ceft_RxWnd));
-		memset (rxwnd, 0, sizeof (Ceft_RxWnd));
-		rxwnd->next = rxwnd;
-		rxwnd->seq 	= 0;
-		rxwnd_prev = rxwnd;
-		rxwnd_head = rxwnd;
-		rxwnd_tail = rxwnd;
-		
-		for (i = 1 ; i < pipeline ; i++) {
-			rxwnd = (Ceft_RxWnd*) malloc (sizeof (Ceft_RxWnd));
-			memset (rxwnd, 0, sizeof (Ceft_RxWnd));
-			rxwnd->seq 	= (uint32_t) i;
-			rxwnd_prev->next = rxwnd;
-			rxwnd_tail = rxwnd;
-			rxwnd_prev = rxwnd;
+		/* The window grows from a few Interests up to the pipeline 	*/
+		fetch = cef_fetch_create (fhdl, &opt, &params, cc_type, pipeline, sv_max_seq);
+		if (fetch == NULL) {
+			fprintf (stderr, "ERROR: Failed to create the fetch engine.\n");
+			exit (1);
 		}
+		cef_fetch_start (fetch);
 		end_t.tv_sec = t.tv_sec;
 	}
 	
@@ -509,7 +502,11 @@ int main (
 		}
 		
 		/* Reads the message from cefnetd			*/
-		res = cef_client_read (fhdl, &buff[index], CefC_AppBuff_Size - index);
+		if (nsg_flag) {
+			res = cef_client_read (fhdl, &buff[index], CefC_AppBuff_Size - index);
+		} else {
+			res = cef_fetch_read (fetch, &buff[index], CefC_AppBuff_Size - index);
+		}
 		
 		if (res > 0) {
 
@@ -579,65 +576,22 @@ int main (
 					} else {
 						
 						/* Inserts the received frame to the buffer 	*/
-						if ((app_frame.chunk_num < rxwnd_head->seq) || 
-							(app_frame.chunk_num > rxwnd_tail->seq)) {
-							continue;
-						}
-						
-						diff_seq = app_frame.chunk_num - rxwnd_head->seq;
-						rxwnd = rxwnd_head;
-						
-						for (i = 0 ; i < diff_seq ; i++) {
-							rxwnd = rxwnd->next;
-						}
-						
-						if (rxwnd->flag != 1) {
-							memcpy (
-								rxwnd->buff, app_frame.payload, app_frame.payload_len);
-							rxwnd->frame_size = app_frame.payload_len;
-							rxwnd->flag = 1;
-						}
+						cef_fetch_frame_input (fetch, &app_frame);
 						
-						rxwnd = rxwnd_head;
-						
-						for (i = 0 ; i < pipeline; i++) {
-							
-							if (rxwnd->flag == 0) {
-								params.chunk_num = rxwnd->seq;
-								cef_client_interest_input (fhdl, &opt, &params);
-								break;
-							}
+						while (cef_fetch_frame_get (
+								fetch, &payload, &payload_len, &chunk_num) > 0) {
 							stat_recv_frames++;
-							stat_recv_bytes += app_frame.payload_len;
-							
-							fwrite (rxwnd->buff, 
-								sizeof (unsigned char), rxwnd->frame_size, stdout);
-							
-							if (rxwnd->seq == UINT32_MAX) {
-								fprintf (stderr, 
-									"[cefgetstream] "
-									"Received the specified number of chunk\n");
-								app_running_f = 0;
-							}
-							
-							/* Updates head and tail pointers		*/
-							rxwnd_head->seq 			= rxwnd_tail->seq + 1;
-							rxwnd_head->flag 			= 0;
-							rxwnd_head->frame_size 		= 0;
-							
-							rxwnd_tail->next = rxwnd_head;
-							rxwnd_tail = rxwnd_head;
+							stat_recv_bytes += payload_len;
 							
-							rxwnd_head = rxwnd_tail->next;
-							rxwnd_tail->next 	= NULL;
-							
-							rxwnd = rxwnd_head;
-							
-							/* Sends an interest with the next chunk number 	*/
-							params.chunk_num = rxwnd_tail->seq;
-							if (params.chunk_num <= UINT32_MAX) {
-								cef_client_interest_input (fhdl, &opt, &params);
-							}
+							fwrite (payload, 
+								sizeof (unsigned char), payload_len, stdout);
+						}
+						
+						if (cef_fetch_completed (fetch)) {
+							fprintf (stderr, 
+								"[cefgetstream] "
+								"Received the specified number of chunk\n");
+							app_running_f = 0;
 						}
 					}
 				} else {
@@ -663,6 +617,10 @@ int main (
 			if (t.tv_sec - end_t.tv_sec > 2) {
 				break;
 			}
+			/* Retransmits the Interests which timed out 	*/
+			if (cef_fetch_timer_process (fetch) < 0) {
+				break;
+			}
 		}
 IR_RCV:;
 	}
@@ -676,6 +634,7 @@ IR_RCV:;
 	}
 	
 	post_process ();
+	cef_fetch_destroy (fetch);
 	
 	exit (0);
 }
@@ -686,12 +645,13 @@ print_usage (
 ) {
 	
 	fprintf (stderr, "\nUsage: cefgetstream\n\n");
-	fprintf (stderr, "  cefgetstream uri [-o] [-m chunks] [-s pipeline] [-v valid_algo] [-d config_file_dir] [-p port_num] [-z Lifetime] [-l block_mode]\n\n");
+	fprintf (stderr, "  cefgetstream uri [-o] [-m chunks] [-s pipeline] [-c cc_algo] [-v valid_algo] [-d config_file_dir] [-p port_num] [-z Lifetime] [-l block_mode]\n\n");
 	fprintf (stderr, "  uri              Specify the URI.\n");
 	fprintf (stderr, "  -o               Specify this option, if you require the content\n"
 	                 "                   that the owner is caching\n");
 	fprintf (stderr, "  chunks           Specify the number of chunk that you want to obtain\n");
-	fprintf (stdout, "  pipeline         Number of pipeline\n");
+	fprintf (stdout, "  pipeline         Max number of pipeline (the window adapts up to this)\n");
+	fprintf (stderr, "  cc_algo          Specify the congestion control (aimd or cubic)\n");
 	fprintf (stderr, "  valid_algo       Specify the validation algorithm (crc32 or sha256)\n");
 	fprintf (stderr, "  config_file_dir  Configure file directory\n");
 	fprintf (stderr, "  port_num         Port Number\n");
@@ -727,7 +727,7 @@ VO_CONN:
 				}
 #endif // CefC_Develop
 				
-				memcpy (params.payload, buff, res);
+				params.payload = buff;
 				params.payload_len = (uint16_t) res;
 				params.chunk_num = (uint32_t)seqnum;
 				
@@ -1530,7 +1530,7 @@ cefputv_put_chunk (
 			cob_len = 0;
 			
 			if (res > 0) {
-				memcpy (params.payload, buff, res);
+				params.payload = buff;
 				params.payload_len = (uint16_t) res;
 				params.chunk_num = (uint32_t)seqnum;
 				
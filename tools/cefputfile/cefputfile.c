@@ -50,6 +50,7 @@
 #include <cefore/cef_client.h>
 #include <cefore/cef_valid.h>
 #include <cefore/cef_log.h>
+#include <cefore/cef_publish.h>
 
 /****************************************************************************************
  Macros
@@ -93,11 +94,20 @@ static void
 print_usage (
 	void
 );
+static int
+block_read (
+	unsigned char* buff,
+	int block_size,
+	FILE* fp,
+	uint64_t seqnum
+);
 
 int bnum = 0;
 #if 1 //+++++@@@@@ DUMMY FILE
 	int dummy_f 		= 0;
 	uint32_t dummy_sum	= 0;
+	uint64_t dummy_size;
+	uint64_t dummy_sent_size	= 0;
 #endif //-----@@@@@ DUMMY FILE
 /****************************************************************************************
  ****************************************************************************************/
@@ -132,8 +142,18 @@ int main (
 	unsigned char* 	work_buff = NULL;
 	uint32_t 		work_buff_idx = 0;
 	int 			cob_len;
+	unsigned char* 	cob = NULL;
+#ifndef TO_CSMGRD
+	CefT_Publish* 	pp;
+	uint64_t 		read_seqnum = 0;
+	uint64_t 		read_bytes = 0;
+	int 			read_end_f = 0;
+	uint16_t 		payload_len;
+	uint32_t 		chunk_num;
+#else
 	unsigned char 	cob_buff[CefC_Max_Length*2];
 	unsigned char   wbuff[CefC_Max_Length*2];
+#endif
 	
 	long int int_rate;
 	long sending_time_us;
@@ -149,16 +169,16 @@ int main (
 	int dir_path_f 	= 0;
 	int port_num_f 	= 0;
 	int valid_f 	= 0;
+	int workers_f 	= 0;
 	
 	/***** parameters 	*****/
 	uint64_t cache_time 	= 300;
 	uint64_t expiry 		= 3600;
 	double rate 			= 5.0;
 	int block_size 			= 1024;
+	int workers 			= CefC_Publish_Worker_Def;
 #if 1 //+++++@@@@@ DUMMY FILE
 	uint64_t dummy_para;			/* dummy file size (KByte) */
-	uint64_t dummy_size;
-	uint64_t dummy_sent_size	= 0;
 #endif //-----@@@@@ DUMMY FILE
 	
 	/*------------------------------------------
@@ -384,6 +404,27 @@ int main (
 			strcpy (valid_type, work_arg);
 			valid_f++;
 			i++;
+		} else if (strcmp (work_arg, "-w") == 0) {
+			if (workers_f) {
+				fprintf (stdout, "ERROR: [-w] is duplicated.\n");
+				print_usage ();
+				return (-1);
+			}
+			if (i + 1 == argc) {
+				fprintf (stdout, "ERROR: [-w] has no parameter.\n");
+				print_usage ();
+				return (-1);
+			}
+			work_arg = argv[i + 1];
+			workers = atoi (work_arg);
+			
+			if ((workers < 1) || (workers > CefC_Publish_Worker_Max)) {
+				fprintf (stdout, "ERROR: [-w] must be 1 to %d.\n", CefC_Publish_Worker_Max);
+				print_usage ();
+				return (-1);
+			}
+			workers_f++;
+			i++;
 		} else {
 			
 			work_arg = argv[i];
@@ -573,6 +614,7 @@ int main (
 	fprintf (stdout, "[cefputfile] Block Size  = %d Bytes\n", block_size);
 	fprintf (stdout, "[cefputfile] Cache Time  = "FMTU64" sec\n", cache_time);
 	fprintf (stdout, "[cefputfile] Expiration  = "FMTU64" sec\n", expiry);
+	fprintf (stdout, "[cefputfile] Workers     = %d\n", workers);
 	
 	/*------------------------------------------
 		Calculates the interval
@@ -587,6 +629,14 @@ int main (
 	gettimeofday (&start_t, NULL);
 	next_tus = start_t.tv_sec * 1000000llu + start_t.tv_usec + interval_us;
 	work_buff = (unsigned char*) malloc (sizeof (unsigned char) * CefC_Putfile_Max);
+#ifndef TO_CSMGRD
+	/* Reads ahead the blocks while the workers frame and sign them 	*/
+	pp = cef_publish_create (&opt, &params, workers, 0);
+	if ((work_buff == NULL) || (pp == NULL)) {
+		fprintf (stdout, "ERROR: Failed to allocate the publishing pipeline.\n");
+		exit (1);
+	}
+#endif
 	
 	fprintf (stdout, "[cefputfile] Start creating Content Objects\n");
 	
@@ -597,36 +647,28 @@ int main (
 		cob_len = 0;
 		
 		while (work_buff_idx < 1) {
-			if(dummy_f == 0){
-				res = fread (buff, sizeof (unsigned char), block_size, fp);
-				if(seqnum > UINT32_MAX){
-					res = 0;
-				}
-		
-			} else {
-
-				if ((dummy_size - dummy_sent_size) >= block_size){
-			        res = block_size; 
-				} else if ((dummy_size - dummy_sent_size) < block_size) {
-		    	    res = dummy_size - dummy_sent_size;
-				} else {
-			        res = 0; 
-				}
-				if(seqnum > UINT32_MAX){
-					res = 0;
+#ifndef TO_CSMGRD
+			while ((read_end_f == 0) && (cef_publish_space_get (pp) > 0)) {
+				res = block_read (buff, block_size, fp, read_seqnum);
+				if (res <= 0) {
+					read_end_f = 1;
+					break;
 				}
-				dummy_sent_size += res;
-				unsigned char rv;
-				for(int i=0; i<res; i++){
-					rv = (unsigned char)rand() % 255;
-					buff[i] = rv;
-					dummy_sum += (unsigned char)rv;
-				}	
+				read_bytes += res;
+				cef_publish_block_put (pp, buff, (uint16_t) res, (uint32_t) read_seqnum,
+					(read_bytes == statBuf.st_size) ? 1 : 0);
+				read_seqnum++;
 			}
+			cob_len = cef_publish_cob_get (pp, &cob, &payload_len, &chunk_num);
+			res = (cob_len != 0) ? payload_len : 0;
+#else
+			res = block_read (buff, block_size, fp, seqnum);
 			cob_len = 0;
+#endif
 			
 			if (res > 0) {
-				memcpy (params.payload, buff, res);
+#ifdef TO_CSMGRD
+				params.payload = buff;
 				params.payload_len = (uint16_t) res;
 				params.chunk_num = (uint32_t)seqnum;
 				
@@ -634,9 +676,6 @@ int main (
 					params.end_chunk_num_f = 1;
 					params.end_chunk_num = seqnum;
 				}
-#ifndef TO_CSMGRD
-				cob_len = cef_frame_object_create (cob_buff, &opt, &params);
-#else
 				cob_len = cef_frame_object_create_for_csmgrd (wbuff, &params);
 {
 	uint16_t	payload_len;
@@ -733,6 +772,7 @@ int main (
 	cob_len = index;
 
 }
+				cob = cob_buff;
 #endif
 				//0.8.3
 				if ( cob_len < 0 ) {
@@ -742,9 +782,12 @@ int main (
 				}
 				
 				if (work_buff_idx + cob_len <= CefC_Putfile_Max) {
-					memcpy (&work_buff[work_buff_idx], cob_buff, cob_len);
+					memcpy (&work_buff[work_buff_idx], cob, cob_len);
 					work_buff_idx += cob_len;
 					cob_len = 0;
+#ifndef TO_CSMGRD
+					cef_publish_cob_release (pp);
+#endif
 					
 					stat_send_frames++;
 					stat_send_bytes += res;
@@ -781,8 +824,11 @@ int main (
 		}
 		
 		if (cob_len > 0) {
-			memcpy (&work_buff[work_buff_idx], cob_buff, cob_len);
+			memcpy (&work_buff[work_buff_idx], cob, cob_len);
 			work_buff_idx += cob_len;
+#ifndef TO_CSMGRD
+			cef_publish_cob_release (pp);
+#endif
 			
 			stat_send_frames++;
 			stat_send_bytes += res;
@@ -791,6 +837,9 @@ int main (
 		}
 	}
 	gettimeofday (&end_t, NULL);
+#ifndef TO_CSMGRD
+	cef_publish_destroy (pp);
+#endif
 	if (dummy_f == 0) {
 		fclose (fp);
 	}
@@ -809,7 +858,7 @@ print_usage (
 	
 	fprintf (stdout, "\nUsage: cefputfile\n");
 	fprintf (stdout, "  cefputfile uri -f path [-r rate] [-b block_size] [-e expiry] "
-					 "[-t cache_time] [-v valid_algo] [-d config_file_dir] [-p port_num] \n\n");
+					 "[-t cache_time] [-v valid_algo] [-w workers] [-d config_file_dir] [-p port_num] \n\n");
 	fprintf (stderr, "  uri              Specify the URI.\n");
 	fprintf (stdout, "  path             Specify the file path of output. \n");
 	fprintf (stdout, "  rate             Transfer rate to cefnetd (Mbps)\n");
@@ -817,10 +866,48 @@ print_usage (
 	fprintf (stdout, "  expiry           Specifies the lifetime (seconds) of the Content Object.\n");
 	fprintf (stdout, "  cache_time       Specifies the period (seconds) after which Content Objects are cached before they are deleted.\n");
 	fprintf (stdout, "  valid_algo       Specify the validation algorithm (crc32 or sha256)\n");
+	fprintf (stdout, "  workers          Number of the threads to create and sign Content Objects\n");
 	fprintf (stderr, "  config_file_dir  Configure file directory\n");
 	fprintf (stderr, "  port_num         Port Number\n\n");
 }
 
+static int
+block_read (
+	unsigned char* buff,
+	int block_size,
+	FILE* fp,
+	uint64_t seqnum
+) {
+	int res;
+	
+	if(dummy_f == 0){
+		res = fread (buff, sizeof (unsigned char), block_size, fp);
+		if(seqnum > UINT32_MAX){
+			res = 0;
+		}
+		return (res);
+	}
+	
+	if ((dummy_size - dummy_sent_size) >= block_size){
+		res = block_size; 
+	} else if ((dummy_size - dummy_sent_size) < block_size) {
+		res = dummy_size - dummy_sent_size;
+	} else {
+		res = 0; 
+	}
+	if(seqnum > UINT32_MAX){
+		res = 0;
+	}
+	dummy_sent_size += res;
+	unsigned char rv;
+	for(int i=0; i<res; i++){
+		rv = (unsigned char)rand() % 255;
+		buff[i] = rv;
+		dummy_sum += (unsigned char)rv;
+	}
+	return (res);
+}
+
 static void
 post_process (
 	void
@@ -574,7 +574,7 @@ int main (
 printf ( "CKP-000 work_buff_idx:%d  res:%d\n", work_buff_idx, res );
 #endif
 			if (res > 0) {
-				memcpy (params.payload, buff, res);
+				params.payload = buff;
 				params.payload_len = (uint16_t) res;
 				params.chunk_num = seqnum;
 				
@@ -636,7 +636,7 @@ printf ( "CKP-031 man_buff_idx:%d   man_rec_num:%d\n", man_buff_idx, man_rec_num
 					//Manifest created 1 record or EndChunk=1 push to work_buff
 					if ( (man_rec_num == CefC_MANIFEST_REC_MAX) || (man_params.end_chunk_num_f == 1) ) {
 						memcpy( man_buff, &man_rec_num, 4 );
-						memcpy( man_params.payload, man_buff, man_buff_idx );
+						man_params.payload = man_buff;
 						man_params.payload_len = (uint16_t)man_buff_idx;
 						man_params.chunk_num = man_seqnum;
 						if ( man_params.end_chunk_num_f == 1 ) {
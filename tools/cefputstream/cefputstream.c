@@ -460,7 +460,7 @@ int main (
 			}
 			
 			if (res > 0) {
-				memcpy (params.payload, buff, res);
+				params.payload = buff;
 				params.payload_len = (uint16_t) res;
 				params.chunk_num = seqnum;
 				//0.8.3
@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2016-2023, National Institute of Information and Communications
+ * Technology (NICT). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the NICT nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE NICT AND CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE NICT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * csmgrsim.c
+ */
+
+/*
+	csmgrsim replays a trace of Interests (name and chunk number) against the
+	cache algorithm libraries of csmgrd and reports the hit ratio of each one.
+	The libraries are driven in the same way as the cache plugins do: a hit
+	calls the hit API, and a miss calls the miss API and then inserts the
+	content entry.
+*/
+
+#define __CSMGR_SIM_SOURCE__
+
+/****************************************************************************************
+ Include Files
+ ****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <cefore/cef_define.h>
+#include <cefore/cef_frame.h>
+#include <cefore/cef_hash.h>
+#include <csmgrd/csmgrd_plugin.h>
+
+
+
+/****************************************************************************************
+ Macros
+ ****************************************************************************************/
+
+#ifdef __APPLE__
+#define CsmgrsimC_Library_Name		".dylib"
+#else // __APPLE__
+#define CsmgrsimC_Library_Name		".so"
+#endif // __APPLE__
+
+#define CsmgrsimC_Default_Capacity	1000
+#define CsmgrsimC_Default_Algos		\
+	"libcsmgrd_fifo,libcsmgrd_lru,libcsmgrd_lfu,libcsmgrd_wtinylfu,libcsmgrd_arc"
+#define CsmgrsimC_Algo_Max			16
+#define CsmgrsimC_Line_Max			2048
+
+
+/****************************************************************************************
+ Structures Declaration
+ ****************************************************************************************/
+
+typedef struct {
+	char		name[256];					/* library name without the suffix 		*/
+	uint64_t	requests;
+	uint64_t	hits;
+	int			cached_max;					/* largest number of cached entries 	*/
+} CsmgrsimT_Result;
+
+
+/****************************************************************************************
+ State Variables
+ ****************************************************************************************/
+
+/* Entries which the algorithm under test keeps in the simulated cache 	*/
+static CefT_Hash_Handle sim_cache = (CefT_Hash_Handle) NULL;
+static int sim_cached_num = 0;
+
+
+/****************************************************************************************
+ Static Function Declaration
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+);
+/*--------------------------------------------------------------------------------------
+	Replays the trace against the specified algorithm
+----------------------------------------------------------------------------------------*/
+static int
+sim_replay (
+	FILE* fp,
+	int capacity,
+	CsmgrsimT_Result* result
+);
+/*--------------------------------------------------------------------------------------
+	Store API given to the library
+----------------------------------------------------------------------------------------*/
+static int
+sim_cache_store (
+	CsmgrdT_Content_Entry* entry
+);
+/*--------------------------------------------------------------------------------------
+	Remove API given to the library
+----------------------------------------------------------------------------------------*/
+static void
+sim_cache_remove (
+	unsigned char* key,
+	int key_len
+);
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+);
+
+
+/****************************************************************************************
+ ****************************************************************************************/
+int
+main (
+	int argc,
+	char** argv
+) {
+	int i;
+	char* work_arg;
+	char* algo;
+	char* save_p;
+	FILE* fp;
+	char trace[1024] = {0};
+	char algos[1024] = {0};
+	int capacity = CsmgrsimC_Default_Capacity;
+	CsmgrsimT_Result results[CsmgrsimC_Algo_Max];
+	int algo_num = 0;
+
+	/***** flags 		*****/
+	int trace_f 		= 0;
+	int cap_f 			= 0;
+	int algo_f 			= 0;
+
+	/* Obtains options 		*/
+	for (i = 1 ; i < argc ; i++) {
+
+		work_arg = argv[i];
+		if (work_arg == NULL || work_arg[0] == 0) {
+			break;
+		}
+
+		if (strcmp (work_arg, "-f") == 0) {
+			if (trace_f) {
+				fprintf (stderr, "csmgrsim: [ERROR] trace file is duplicated.\n");
+				print_usage ();
+				return (-1);
+			}
+			if ((i + 1 == argc) || (strlen (argv[i + 1]) >= sizeof (trace))) {
+				fprintf (stderr, "csmgrsim: [ERROR] trace file is not specified.\n");
+				print_usage ();
+				return (-1);
+			}
+			strcpy (trace, argv[i + 1]);
+			trace_f++;
+			i++;
+		} else if (strcmp (work_arg, "-c") == 0) {
+			if (cap_f) {
+				fprintf (stderr, "csmgrsim: [ERROR] capacity is duplicated.\n");
+				print_usage ();
+				return (-1);
+			}
+			if (i + 1 == argc) {
+				fprintf (stderr, "csmgrsim: [ERROR] capacity is not specified.\n");
+				print_usage ();
+				return (-1);
+			}
+			capacity = atoi (argv[i + 1]);
+			if (capacity < 1) {
+				fprintf (stderr, "csmgrsim: [ERROR] capacity must be 1 or more.\n");
+				print_usage ();
+				return (-1);
+			}
+			cap_f++;
+			i++;
+		} else if (strcmp (work_arg, "-a") == 0) {
+			if (algo_f) {
+				fprintf (stderr, "csmgrsim: [ERROR] algorithm is duplicated.\n");
+				print_usage ();
+				return (-1);
+			}
+			if ((i + 1 == argc) || (strlen (argv[i + 1]) >= sizeof (algos))) {
+				fprintf (stderr, "csmgrsim: [ERROR] algorithm is not specified.\n");
+				print_usage ();
+				return (-1);
+			}
+			strcpy (algos, argv[i + 1]);
+			algo_f++;
+			i++;
+		} else {
+			fprintf (stderr, "csmgrsim: [ERROR] unknown option (%s).\n", work_arg);
+			print_usage ();
+			return (-1);
+		}
+	}
+	if (trace_f == 0) {
+		fprintf (stderr, "csmgrsim: [ERROR] trace file is not specified.\n");
+		print_usage ();
+		return (-1);
+	}
+	if (algo_f == 0) {
+		strcpy (algos, CsmgrsimC_Default_Algos);
+	}
+
+	fp = fopen (trace, "r");
+	if (fp == NULL) {
+		fprintf (stderr, "csmgrsim: [ERROR] cannot open %s.\n", trace);
+		return (-1);
+	}
+	cef_frame_init ();
+
+	/* Replays the trace against each algorithm 		*/
+	for (algo = strtok_r (algos, ",", &save_p) ; algo != NULL ;
+			algo = strtok_r (NULL, ",", &save_p)) {
+		if (algo_num == CsmgrsimC_Algo_Max) {
+			fprintf (stderr, "csmgrsim: [ERROR] too many algorithms.\n");
+			break;
+		}
+		memset (&results[algo_num], 0, sizeof (CsmgrsimT_Result));
+		snprintf (results[algo_num].name, sizeof (results[algo_num].name), "%s", algo);
+		rewind (fp);
+		if (sim_replay (fp, capacity, &results[algo_num]) < 0) {
+			continue;
+		}
+		algo_num++;
+	}
+	fclose (fp);
+
+	/* Outputs the results 		*/
+	fprintf (stdout, "Capacity : %d\n", capacity);
+	fprintf (stdout, "%-24s %12s %12s %10s\n", "Algorithm", "Requests", "Hits", "Hit Ratio");
+	for (i = 0 ; i < algo_num ; i++) {
+		fprintf (stdout, "%-24s %12llu %12llu %9.2f%%\n",
+			results[i].name,
+			(unsigned long long) results[i].requests,
+			(unsigned long long) results[i].hits,
+			results[i].requests ?
+				(double) results[i].hits * 100.0 / (double) results[i].requests : 0.0);
+		if (results[i].cached_max > capacity) {
+			fprintf (stdout, "  (cached %d entries, over the capacity)\n",
+				results[i].cached_max);
+		}
+	}
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Replays the trace against the specified algorithm
+----------------------------------------------------------------------------------------*/
+static int
+sim_replay (
+	FILE* fp,
+	int capacity,
+	CsmgrsimT_Result* result
+) {
+	char lib_name[512];
+	void* algo_lib = NULL;
+	CsmgrdT_Lib_Interface algo_apis;
+	CsmgrdT_Content_Entry entry;
+	char line[CsmgrsimC_Line_Max];
+	char last_uri[CsmgrsimC_Line_Max] = {0};
+	char* uri;
+	char* chunk;
+	char* save_p;
+	unsigned char name[CefC_Max_Length];
+	int name_len = 0;
+	unsigned char key[CsmgrdC_Key_Max];
+	int key_len;
+
+	/* Loads the library 		*/
+	memset (&algo_apis, 0, sizeof (CsmgrdT_Lib_Interface));
+	snprintf (lib_name, sizeof (lib_name), "%s%s", result->name, CsmgrsimC_Library_Name);
+	if ((csmgrd_lib_api_get (lib_name, &algo_lib, &algo_apis) < 0) ||
+		(algo_apis.init == NULL) || (algo_apis.insert == NULL)) {
+		fprintf (stderr, "csmgrsim: [ERROR] cannot load %s.\n", lib_name);
+		if (algo_lib) {
+			dlclose (algo_lib);
+		}
+		return (-1);
+	}
+
+	sim_cache = cef_lhash_tbl_create ((uint32_t) capacity);
+	sim_cached_num = 0;
+	if ((sim_cache == (CefT_Hash_Handle) NULL) ||
+		((*(algo_apis.init))(capacity, sim_cache_store, sim_cache_remove) < 0)) {
+		fprintf (stderr, "csmgrsim: [ERROR] cannot init %s.\n", lib_name);
+		if (sim_cache) {
+			cef_lhash_tbl_destroy (sim_cache);
+			sim_cache = (CefT_Hash_Handle) NULL;
+		}
+		dlclose (algo_lib);
+		return (-1);
+	}
+
+	memset (&entry, 0, sizeof (CsmgrdT_Content_Entry));
+	while (fgets (line, sizeof (line), fp) != NULL) {
+		uri = strtok_r (line, " \t\r\n", &save_p);
+		if ((uri == NULL) || (uri[0] == '#')) {
+			continue;
+		}
+		chunk = strtok_r (NULL, " \t\r\n", &save_p);
+
+		/* Consecutive requests usually have the same name 	*/
+		if (strcmp (uri, last_uri)) {
+			name_len = cef_frame_conversion_uri_to_name (uri, name);
+			if (name_len <= 0) {
+				last_uri[0] = 0x00;
+				continue;
+			}
+			strcpy (last_uri, uri);
+		}
+		entry.name 		= name;
+		entry.name_len 	= (uint16_t) name_len;
+		entry.chunk_num = chunk ? (uint32_t) strtoul (chunk, NULL, 10) : 0;
+		key_len = csmgrd_name_chunknum_concatenate (
+						entry.name, entry.name_len, entry.chunk_num, key);
+
+		result->requests++;
+		if (cef_lhash_tbl_item_get (sim_cache, key, key_len)) {
+			result->hits++;
+			if (algo_apis.hit) {
+				(*(algo_apis.hit))(key, key_len);
+			}
+		} else {
+			if (algo_apis.miss) {
+				(*(algo_apis.miss))(key, key_len);
+			}
+			(*(algo_apis.insert))(&entry);
+			if (sim_cached_num > result->cached_max) {
+				result->cached_max = sim_cached_num;
+			}
+		}
+	}
+
+	if (algo_apis.destroy) {
+		(*(algo_apis.destroy))();
+	}
+	cef_lhash_tbl_destroy (sim_cache);
+	sim_cache = (CefT_Hash_Handle) NULL;
+	dlclose (algo_lib);
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Store API given to the library
+----------------------------------------------------------------------------------------*/
+static int
+sim_cache_store (
+	CsmgrdT_Content_Entry* entry
+) {
+	unsigned char key[CsmgrdC_Key_Max];
+	int key_len;
+
+	key_len = csmgrd_name_chunknum_concatenate (
+					entry->name, entry->name_len, entry->chunk_num, key);
+	if (cef_lhash_tbl_item_get (sim_cache, key, key_len)) {
+		return (0);
+	}
+	if (cef_lhash_tbl_item_set (sim_cache, key, key_len, (void*) sim_cache) < 0) {
+		return (-1);
+	}
+	sim_cached_num++;
+
+	return (0);
+}
+/*--------------------------------------------------------------------------------------
+	Remove API given to the library
+----------------------------------------------------------------------------------------*/
+static void
+sim_cache_remove (
+	unsigned char* key,
+	int key_len
+) {
+	if (cef_lhash_tbl_item_remove (sim_cache, key, key_len)) {
+		sim_cached_num--;
+	}
+}
+/*--------------------------------------------------------------------------------------
+	Output Usage
+----------------------------------------------------------------------------------------*/
+static void
+print_usage (
+	void
+) {
+	fprintf (stderr,
+		"\nUsage: csmgrsim\n\n"
+		"  csmgrsim -f trace [-c capacity] [-a algorithm[,algorithm...]]\n\n"
+		"  trace      Trace file. Each line is \"uri chunk_number\".\n"
+		"             Lines starting with '#' are ignored.\n"
+		"  capacity   Number of cached entries. The default value is 1000.\n"
+		"  algorithm  Cache algorithm libraries to compare. The default value is\n"
+		"             " CsmgrsimC_Default_Algos ".\n\n"
+	);
+	return;
+}